@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   benchmark.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  End-to-end CausalLM inference benchmark on synthetic weights
+ *
+ * @note   The model graph is built from a HuggingFace style config and its
+ * weights are filled with random values in their configured data types, so
+ * neither the weight file nor the tokenizer is needed. Prompt length,
+ * generation length, batch size and thread count are swept and the results
+ * are reported as JSON.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+#include <factory.h>
+#include <thread_runtime.h>
+#include <tool_util.h>
+
+#include "causal_lm.h"
+
+#include <sys/resource.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using json = nlohmann::json;
+using causallm::Clock;
+using causallm::elapsedMs;
+
+namespace {
+
+/**
+ * @brief print usage of the benchmark
+ */
+void printUsage(const char *prog) {
+  std::cerr
+    << "usage: " << prog << " <benchmark config> [result file]\n"
+    << "  <benchmark config> : json with \"config\", \"nntr_config\" and the\n"
+    << "                       sweep, see res/benchmark/*.json\n"
+    << "  [result file]      : write the json result here instead of stdout\n";
+}
+
+/**
+ * @brief get a section of the benchmark config, given inline or as the path
+ * of a json file
+ */
+json loadSection(const json &bench, const std::string &key,
+                 const json &fallback = nullptr) {
+  if (!bench.contains(key)) {
+    if (fallback.is_null())
+      throw std::invalid_argument("benchmark config needs \"" + key + "\"");
+    return fallback;
+  }
+
+  const json &section = bench[key];
+  return section.is_string()
+           ? causallm::LoadJsonFile(section.get<std::string>())
+           : section;
+}
+
+/**
+ * @brief get the values of a sweep, given as a number or a list of numbers
+ */
+std::vector<unsigned int> sweepValues(const json &bench, const std::string &key,
+                                      unsigned int fallback) {
+  if (!bench.contains(key))
+    return {fallback};
+  if (bench[key].is_array())
+    return bench[key].get<std::vector<unsigned int>>();
+  return {bench[key].get<unsigned int>()};
+}
+
+/**
+ * @brief reset the peak resident set size of the process
+ * @return false if the kernel does not allow it, the peak is then the one of
+ * the whole process
+ */
+bool resetPeakRss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5" << std::flush;
+  return clear_refs.good();
+}
+
+/**
+ * @brief peak resident set size in KB since the last resetPeakRss()
+ */
+size_t readPeakRssKb() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0)
+      return std::stoul(line.substr(6));
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+/**
+ * @brief set the threads of the thread runtime and of OpenMP regions
+ * @return resolved number of threads
+ * @note kernels built with a fixed omp-num-threads keep their own count
+ */
+unsigned int setNumThreads(unsigned int num_threads) {
+  auto &runtime = nntrainer::ThreadRuntime::Global();
+  nntrainer::ThreadRuntimeConfig config = runtime.getConfig();
+  config.num_threads = num_threads;
+  runtime.configure(config);
+#ifdef _OPENMP
+  omp_set_num_threads(runtime.getNumThreads());
+#endif
+  return runtime.getNumThreads();
+}
+
+/**
+ * @brief mean and nearest rank percentiles of the samples in ms
+ */
+json summarize(std::vector<double> samples) {
+  if (samples.empty())
+    return nullptr;
+
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&samples](double p) {
+    size_t rank = static_cast<size_t>(p / 100.0 * samples.size() + 0.5);
+    return samples[std::min(std::max<size_t>(rank, 1), samples.size()) - 1];
+  };
+
+  double sum = 0;
+  for (double s : samples)
+    sum += s;
+
+  return {{"mean", sum / samples.size()},
+          {"p50", percentile(50)},
+          {"p90", percentile(90)},
+          {"p99", percentile(99)},
+          {"max", samples.back()}};
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  causallm::registerInMemoryModels();
+
+  try {
+    json bench = causallm::LoadJsonFile(argv[1]);
+    json cfg = loadSection(bench, "config");
+    json generation_cfg = loadSection(
+      bench, "generation_config", {{"eos_token_id", {0}}, {"bos_token_id", 0}});
+    json nntr_cfg = loadSection(bench, "nntr_config");
+
+    const std::string architecture =
+      cfg["architectures"].get<std::vector<std::string>>()[0];
+    const std::vector<unsigned int> prompt_lens =
+      sweepValues(bench, "prompt_len", 128);
+    const std::vector<unsigned int> gen_lens =
+      sweepValues(bench, "gen_len", 64);
+    const std::vector<unsigned int> batch_sizes =
+      sweepValues(bench, "batch_size", 1);
+    const std::vector<unsigned int> thread_counts =
+      sweepValues(bench, "num_threads", 0);
+    const unsigned int warmup = bench.value("warmup", 1u);
+    const unsigned int repeat = std::max(bench.value("repeat", 3u), 1u);
+    const unsigned int seed = bench.value("seed", 0u);
+    const unsigned int max_gen_len =
+      *std::max_element(gen_lens.begin(), gen_lens.end());
+    if (std::count(gen_lens.begin(), gen_lens.end(), 0u))
+      throw std::invalid_argument("gen_len must be at least 1");
+
+    /// weights live in memory and token ids are fed directly
+    nntr_cfg.erase("tokenizer_file");
+    nntr_cfg.erase("system_prompt");
+    nntr_cfg["fsu"] = false;
+    if (!nntr_cfg.contains("bad_word_ids"))
+      nntr_cfg["bad_word_ids"] = json::array();
+
+    json results = json::array();
+    for (unsigned int batch_size : batch_sizes) {
+      for (unsigned int prompt_len : prompt_lens) {
+        nntr_cfg["batch_size"] = batch_size;
+        nntr_cfg["init_seq_len"] = prompt_len;
+        nntr_cfg["max_seq_len"] = prompt_len + max_gen_len;
+        nntr_cfg["num_to_generate"] = max_gen_len;
+
+        const bool peak_reset = resetPeakRss();
+        auto start_init = Clock::now();
+        auto model = causallm::Factory::Instance().create(
+          architecture, cfg, generation_cfg, nntr_cfg);
+        if (!model)
+          throw std::invalid_argument("unsupported architecture " +
+                                      architecture);
+        model->initialize();
+        auto start_fill = Clock::now();
+        model->fill_random_weight(seed);
+        auto finish_fill = Clock::now();
+
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<unsigned int> token(
+          0, cfg["vocab_size"].get<unsigned int>() - 1);
+        std::vector<unsigned int> prompt(prompt_len);
+        std::generate(prompt.begin(), prompt.end(),
+                      [&]() { return token(rng); });
+
+        for (unsigned int num_threads : thread_counts) {
+          const unsigned int threads = setNumThreads(num_threads);
+
+          for (unsigned int gen_len : gen_lens) {
+            for (unsigned int i = 0; i < warmup; ++i)
+              model->run_tokens(prompt, gen_len);
+
+            std::vector<double> ttft, token_latency;
+            double prefill_ms = 0, decode_ms = 0;
+            for (unsigned int i = 0; i < repeat; ++i) {
+              std::vector<Clock::time_point> stamps;
+              stamps.reserve(gen_len);
+              auto start = Clock::now();
+              model->run_tokens(prompt, gen_len, [&stamps](unsigned int) {
+                stamps.push_back(Clock::now());
+              });
+
+              ttft.push_back(elapsedMs(start, stamps.front()));
+              prefill_ms += ttft.back();
+              for (size_t t = 1; t < stamps.size(); ++t)
+                token_latency.push_back(elapsedMs(stamps[t - 1], stamps[t]));
+              decode_ms += elapsedMs(stamps.front(), stamps.back());
+            }
+
+            const double prompt_tokens =
+              static_cast<double>(batch_size) * prompt_len * repeat;
+            const double decode_tokens =
+              static_cast<double>(batch_size) * (gen_len - 1) * repeat;
+
+            results.push_back({
+              {"batch_size", batch_size},
+              {"prompt_len", prompt_len},
+              {"gen_len", gen_len},
+              {"num_threads", threads},
+              {"init_ms", elapsedMs(start_init, start_fill)},
+              {"weight_fill_ms", elapsedMs(start_fill, finish_fill)},
+              {"ttft_ms", summarize(ttft)},
+              {"token_latency_ms", summarize(token_latency)},
+              {"prefill_tokens_per_sec", prompt_tokens / prefill_ms * 1000},
+              {"decode_tokens_per_sec",
+               decode_ms > 0 ? decode_tokens / decode_ms * 1000 : 0.0},
+              {"peak_rss_kb", readPeakRssKb()},
+              {"peak_rss_scope", peak_reset ? "model" : "process"},
+            });
+            std::cerr << results.back().dump() << std::endl;
+          }
+        }
+      }
+    }
+
+    json report = {
+      {"architecture", architecture},
+      {"model_tensor_type", nntr_cfg["model_tensor_type"]},
+      {"fc_layer_dtype", nntr_cfg["fc_layer_dtype"]},
+      {"embedding_dtype", nntr_cfg["embedding_dtype"]},
+      {"kv_cache_type", nntr_cfg.value("kv_cache_type", "fp16")},
+      {"warmup", warmup},
+      {"repeat", repeat},
+      {"results", results},
+    };
+
+    if (argc > 2) {
+      std::ofstream out(argv[2]);
+      out << report.dump(2) << std::endl;
+    } else {
+      std::cout << report.dump(2) << std::endl;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "\n[!] FATAL ERROR: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -20,14 +20,29 @@
  *          - Llama
  */
 
+#include <algorithm>
+#include <fcntl.h>
 #include <fstream>
+#include <sys/stat.h>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <mman_windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include <app_context.h>
 #include <engine.h>
 #include <model.h>
 
 #include <causal_lm.h>
+#include <cpu_backend.h>
+#include <layer_context.h>
 #include <llm_util.hpp>
+#include <thread_runtime.h>
 #include <tokenizers_cpp.h>
 
 #include <embedding_layer.h>
@@ -54,9 +69,10 @@ CausalLM::CausalLM(json &cfg, json &generation_cfg, json &nntr_cfg) {
   ids_history = (unsigned int *)malloc(static_cast<size_t>(BATCH_SIZE) *
                                        MAX_SEQ_LEN * sizeof(unsigned int));
 
-  // prep tokenizer
-  tokenizer = tokenizers::Tokenizer::FromBlobJSON(
-    LoadBytesFromFile(nntr_cfg["tokenizer_file"]));
+  // prep tokenizer, run_tokens() works without it
+  if (nntr_cfg.contains("tokenizer_file"))
+    tokenizer = tokenizers::Tokenizer::FromBlobJSON(
+      LoadBytesFromFile(nntr_cfg["tokenizer_file"]));
 };
 
 void CausalLM::setupParameters(json &cfg, json &generation_cfg,
@@ -66,6 +82,11 @@ void CausalLM::setupParameters(json &cfg, json &generation_cfg,
   BATCH_SIZE = nntr_cfg["batch_size"].get<unsigned int>();
   MODEL_TENSOR_TYPE = nntr_cfg["model_tensor_type"].get<std::string>();
   INIT_SEQ_LEN = nntr_cfg["init_seq_len"];
+  PREFILL_CHUNK_SIZE =
+    nntr_cfg.contains("prefill_chunk_size")
+      ? std::min(nntr_cfg["prefill_chunk_size"].get<unsigned int>(),
+                 INIT_SEQ_LEN)
+      : 0;
   MAX_SEQ_LEN = nntr_cfg["max_seq_len"];
   NUM_TO_GENERATE = nntr_cfg["num_to_generate"];
   MODEL_TENSOR_TYPE = nntr_cfg["model_tensor_type"];
@@ -80,6 +101,24 @@ void CausalLM::setupParameters(json &cfg, json &generation_cfg,
                    ? nntr_cfg["lmhead_dtype"]
                    : nntr_cfg["embedding_dtype"];
   FC_LAYER_DTYPE = nntr_cfg["fc_layer_dtype"];
+  KV_CACHE_TYPE = nntr_cfg.contains("kv_cache_type")
+                    ? nntr_cfg["kv_cache_type"].get<std::string>()
+                    : "fp16";
+  USE_VOCAB_SELECTION = nntr_cfg.contains("use_vocab_selection")
+                          ? nntr_cfg["use_vocab_selection"].get<bool>()
+                          : false;
+  VOCAB_SELECTION_CLUSTERS =
+    nntr_cfg.contains("vocab_selection_clusters")
+      ? nntr_cfg["vocab_selection_clusters"].get<unsigned int>()
+      : 256;
+  VOCAB_SELECTION_PROBES =
+    nntr_cfg.contains("vocab_selection_probes")
+      ? nntr_cfg["vocab_selection_probes"].get<unsigned int>()
+      : 16;
+  VOCAB_SELECTION_MARGIN =
+    nntr_cfg.contains("vocab_selection_margin")
+      ? nntr_cfg["vocab_selection_margin"].get<float>()
+      : 1.0f;
 
   USE_KVCACHE = false;
   PRE_COMPUTED_CACHE_PATH = "";
@@ -179,10 +218,14 @@ void CausalLM::constructModel() {
   // create model
   model = ml::train::createModel(ml::train::ModelType::NEURAL_NET);
 
-  // create input layer
+  // create input layer, activations are sized for a prefill chunk and the
+  // token ids are fed as they are
+  const unsigned int input_len =
+    PREFILL_CHUNK_SIZE ? PREFILL_CHUNK_SIZE : INIT_SEQ_LEN;
   layers.push_back(createLayer(
     "input", {withKey("name", "input0"),
-              withKey("input_shape", "1:1:" + std::to_string(INIT_SEQ_LEN))}));
+              withKey("input_shape", "1:1:" + std::to_string(input_len)),
+              withKey("tensor_dtype", "uint32")}));
 
   // create embedding layer
   const std::string embedding_type =
@@ -224,6 +267,17 @@ void CausalLM::constructModel() {
   };
   if (TIE_WORD_EMBEDDINGS)
     lmhead_prop.emplace_back(withKey("shared_from", "embedding0"));
+  else
+    lmhead_prop.emplace_back(withKey("last_step_only", "true"));
+  /// vocabulary shortlisting is implemented by the tied lm head only
+  if (TIE_WORD_EMBEDDINGS && USE_VOCAB_SELECTION) {
+    lmhead_prop.emplace_back(
+      withKey("vocab_selection_clusters", VOCAB_SELECTION_CLUSTERS));
+    lmhead_prop.emplace_back(
+      withKey("vocab_selection_probes", VOCAB_SELECTION_PROBES));
+    lmhead_prop.emplace_back(
+      withKey("vocab_selection_margin", VOCAB_SELECTION_MARGIN));
+  }
   layers.push_back(createLayer(lmhead_type, lmhead_prop));
 
   // add created layers into the model
@@ -232,6 +286,35 @@ void CausalLM::constructModel() {
   }
 };
 
+void CausalLM::prefill(const unsigned int *input_sample, unsigned int len,
+                       unsigned int from, const std::vector<float *> &output) {
+  std::vector<float *> label;
+
+  if (!PREFILL_CHUNK_SIZE) {
+    std::vector<float *> input = {
+      reinterpret_cast<float *>(const_cast<unsigned int *>(input_sample))};
+    model->incremental_inference(BATCH_SIZE, input, label, output, len, from,
+                                 from + len);
+    return;
+  }
+
+  /// each chunk is a separate step over the kv caches, so the activations
+  /// only hold PREFILL_CHUNK_SIZE tokens however long the prompt is
+  std::vector<unsigned int> chunk(static_cast<size_t>(BATCH_SIZE) *
+                                  PREFILL_CHUNK_SIZE);
+  std::vector<float *> input = {reinterpret_cast<float *>(chunk.data())};
+
+  for (unsigned int pos = 0; pos < len; pos += PREFILL_CHUNK_SIZE) {
+    unsigned int n = std::min(PREFILL_CHUNK_SIZE, len - pos);
+    for (unsigned int b = 0; b < BATCH_SIZE; ++b)
+      std::copy_n(input_sample + static_cast<size_t>(b) * MAX_SEQ_LEN + pos, n,
+                  chunk.data() + static_cast<size_t>(b) * PREFILL_CHUNK_SIZE);
+    model->incremental_inference(BATCH_SIZE, input, label, output,
+                                 PREFILL_CHUNK_SIZE, from + pos,
+                                 from + pos + n);
+  }
+}
+
 void CausalLM::load_weight(const std::string &weight_path) {
 
   if (!is_initialized) {
@@ -245,9 +328,24 @@ void CausalLM::load_weight(const std::string &weight_path) {
     throw std::runtime_error("Failed to load model weights: " +
                              std::string(e.what()));
   }
+
+  buildVocabSelection();
 };
 
-void CausalLM::save_weight(const std::string &weight_path) {
+void CausalLM::buildVocabSelection() {
+  if (!TIE_WORD_EMBEDDINGS || !USE_VOCAB_SELECTION)
+    return;
+
+  /// only the lm head of the tied pair holds the index tensors
+  model->forEachLayer([](ml::train::Layer &layer,
+                         nntrainer::RunLayerContext &context, void *) {
+    if (layer.getType() == TieWordEmbedding::type && context.getNumTensors())
+      TieWordEmbedding::buildVocabSelection(context);
+  });
+}
+
+void CausalLM::save_weight(const std::string &weight_path,
+                           ml::train::ModelFormat format) {
 
   if (!is_initialized) {
     throw std::runtime_error("CausalLM model is not initialized. Please call "
@@ -255,7 +353,7 @@ void CausalLM::save_weight(const std::string &weight_path) {
   }
 
   try {
-    model->save(weight_path, ml::train::ModelFormat::MODEL_FORMAT_BIN);
+    model->save(weight_path, format);
   } catch (const std::exception &e) {
     throw std::runtime_error("Failed to save model weights: " +
                              std::string(e.what()));
@@ -270,6 +368,11 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
                              "initialize() before run().");
   }
 
+  if (!tokenizer) {
+    throw std::runtime_error("run() needs the tokenizer_file of nntr_config, "
+                             "use run_tokens() to feed token ids.");
+  }
+
   output_list.clear();
   for (unsigned int b = 0; b < BATCH_SIZE; ++b) {
     output_list.push_back("");
@@ -280,6 +383,11 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
       "MAX_SEQ_LEN must be greater than or equal to INIT_SEQ_LEN");
   }
 
+  /// the shortlisted logits are exact for the argmax of the raw logits only
+  if (TIE_WORD_EMBEDDINGS && USE_VOCAB_SELECTION && (do_sample || NUM_BADWORDS))
+    throw std::invalid_argument(
+      "use_vocab_selection supports greedy decoding without bad_word_ids only");
+
   /**
    * Variables for Log
    */
@@ -349,8 +457,8 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
   _input.clear();
 
   unsigned int init_len = init_input.size();
-  float *input_sample =
-    (float *)malloc(sizeof(float) * BATCH_SIZE * MAX_SEQ_LEN);
+  unsigned int *input_sample = (unsigned int *)malloc(
+    sizeof(unsigned int) * BATCH_SIZE * MAX_SEQ_LEN);
   std::vector<bool> eos_list(BATCH_SIZE, false);
 
   unsigned int input_len = init_len;
@@ -358,8 +466,7 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
 
   for (unsigned int b = 0; b < BATCH_SIZE; ++b) {
     for (unsigned int i = 0; i < input_len; ++i) {
-      input_sample[static_cast<size_t>(b) * MAX_SEQ_LEN + i] =
-        static_cast<float>(init_input[i]);
+      input_sample[static_cast<size_t>(b) * MAX_SEQ_LEN + i] = init_input[i];
       ids_history[static_cast<size_t>(b) * MAX_SEQ_LEN + i] = init_input[i];
     }
   }
@@ -368,7 +475,7 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
    * PREFILL
    */
   std::vector<int64_t> token_ids;
-  input.push_back(input_sample);
+  input.push_back(reinterpret_cast<float *>(input_sample));
 
   ///@note contains possible bug
   // std::vector<ml::train::TensorDim> input_dims;
@@ -378,7 +485,8 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
 
   auto start_prefill = std::chrono::high_resolution_clock::now();
 
-  std::vector<float *> output;
+  logits.resize(static_cast<size_t>(BATCH_SIZE) * NUM_VOCAB);
+  std::vector<float *> output = {logits.data()};
 
   if (SAVE_KVCACHE) {
     //@note This is for the save the kv cache. precomputed kv cache should be
@@ -393,9 +501,7 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
     //
 
     std::cout << "\n==============[KV CACHE SAVE MODE]================\n";
-    output = model->incremental_inference(BATCH_SIZE, input, label, input_len,
-                                          0 + global_token_len,
-                                          input_len + global_token_len, false);
+    prefill(input_sample, input_len, global_token_len, output);
 
     SYS_PROMP_LEN = input_len;
     save_kvcache(PRE_COMPUTED_CACHE_PATH, SYS_PROMP_LEN);
@@ -414,9 +520,7 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
   } else {
     SYS_PROMP_LEN = 0;
   }
-  output = model->incremental_inference(BATCH_SIZE, input, label, init_len,
-                                        SYS_PROMP_LEN,
-                                        SYS_PROMP_LEN + input_len, false);
+  prefill(input_sample, input_len, SYS_PROMP_LEN, output);
 
   // post process of model output
   std::vector<unsigned int> id_list(generate_multi_tokens(
@@ -437,8 +541,7 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
 
   // Update generated token by prefill as an input
   for (unsigned int b = 0; b < BATCH_SIZE; ++b)
-    input_sample[static_cast<size_t>(b) * MAX_SEQ_LEN] =
-      static_cast<float>(id_list[b]);
+    input_sample[static_cast<size_t>(b) * MAX_SEQ_LEN] = id_list[b];
 
   auto start_generation = std::chrono::high_resolution_clock::now();
 
@@ -446,21 +549,19 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
        token_generation_idx < input_len + 1 + NUM_TO_GENERATE;
        ++token_generation_idx) {
 
-    auto output_interval =
-      model->incremental_inference(BATCH_SIZE, input, label, input_len,
-                                   token_generation_idx - 1 + global_token_len,
-                                   token_generation_idx + global_token_len);
-    std::vector<unsigned int> ids_list(generate(output_interval[0], do_sample));
+    model->incremental_inference(BATCH_SIZE, input, label, output, input_len,
+                                 token_generation_idx - 1 + global_token_len,
+                                 token_generation_idx + global_token_len);
+    std::vector<unsigned int> ids_list(generate(output[0], do_sample));
     if (token_generation_idx < input_len) {
       for (unsigned int b = 0; b < BATCH_SIZE; ++b) {
         input_sample[static_cast<size_t>(b) * MAX_SEQ_LEN] =
-          static_cast<float>(init_input[token_generation_idx - SYS_PROMP_LEN]);
+          init_input[token_generation_idx - SYS_PROMP_LEN];
       }
       registerOutputs(tokenizer, ids_list, token_generation_idx, eos_list);
     } else {
       for (unsigned int b = 0; b < BATCH_SIZE; ++b) {
-        input_sample[static_cast<size_t>(b) * MAX_SEQ_LEN] =
-          static_cast<float>(ids_list[b]);
+        input_sample[static_cast<size_t>(b) * MAX_SEQ_LEN] = ids_list[b];
       }
       registerOutputs(tokenizer, ids_list, token_generation_idx, eos_list);
     }
@@ -507,6 +608,335 @@ void CausalLM::run(const WSTR prompt, bool do_sample, const WSTR system_prompt,
   std::cout << "==========================================================\n";
 };
 
+/**
+ * @brief fill a weight with uniform random values in its own data type
+ * @note Q4_0 and Q4_K weights are quantized by rows of width() and repacked
+ * by 8 rows as the fully connected kernels expect. Q6_K blocks do not depend
+ * on the row length, so they are quantized 256 values at a time.
+ */
+static void fillRandomWeight(nntrainer::Tensor &weight, std::mt19937 &rng) {
+  using Tdatatype = nntrainer::TensorDim::DataType;
+  static constexpr unsigned int CHUNK_ROWS = 64;
+  static constexpr unsigned int Q6_K_BLOCK = 256;
+
+  std::uniform_real_distribution<float> dist(-0.05f, 0.05f);
+  auto random = [&dist, &rng]() { return dist(rng); };
+  const size_t len = weight.getDim().getDataLen();
+  char *dst = weight.getData<char>();
+
+  switch (weight.getDataType()) {
+  case Tdatatype::FP32:
+    std::generate_n(weight.getData<float>(), len, random);
+    break;
+#ifdef ENABLE_FP16
+  case Tdatatype::FP16:
+    std::generate_n(weight.getData<_FP16>(), len,
+                    [&random]() { return static_cast<_FP16>(random()); });
+    break;
+#endif
+  case Tdatatype::Q4_0:
+  case Tdatatype::Q4_K: {
+    const bool q4_0 = weight.getDataType() == Tdatatype::Q4_0;
+    const unsigned int N = weight.width();
+    const unsigned int K = len / N;
+    if (N % 8 || K % (q4_0 ? 32 : 256))
+      throw std::invalid_argument("cannot repack a random weight of " +
+                                  std::to_string(N) + " rows of " +
+                                  std::to_string(K));
+
+    const size_t row_bytes = weight.getMemoryBytes() / N;
+    std::vector<float> src(static_cast<size_t>(CHUNK_ROWS) * K);
+    std::vector<char> quantized(CHUNK_ROWS * row_bytes);
+    for (unsigned int row = 0; row < N; row += CHUNK_ROWS) {
+      const unsigned int rows = std::min(CHUNK_ROWS, N - row);
+      std::generate_n(src.data(), static_cast<size_t>(rows) * K, random);
+      size_t bytes =
+        q4_0 ? nntrainer::quantize_q4_0(src.data(), quantized.data(), rows, K,
+                                        nullptr)
+             : nntrainer::quantize_q4_K(src.data(), quantized.data(), rows, K,
+                                        nullptr);
+      if (q4_0)
+        nntrainer::repack_q4_0(dst, quantized.data(), bytes, rows, K);
+      else
+        nntrainer::repack_q4_K(dst, quantized.data(), bytes, rows, K);
+      dst += bytes;
+    }
+    break;
+  }
+  case Tdatatype::Q6_K: {
+    std::vector<float> src(static_cast<size_t>(CHUNK_ROWS) * Q6_K_BLOCK);
+    for (size_t i = 0; i < len; i += src.size()) {
+      const size_t n = std::min(src.size(), len - i);
+      std::generate_n(src.data(), n, random);
+      dst += nntrainer::quantize_q6_K(src.data(), dst, n / Q6_K_BLOCK,
+                                      Q6_K_BLOCK, nullptr);
+    }
+    break;
+  }
+  default:
+    throw std::invalid_argument(
+      "random weights are not supported for the data type of " +
+      weight.getName());
+  }
+}
+
+void CausalLM::fill_random_weight(unsigned int seed) {
+
+  if (!is_initialized) {
+    throw std::runtime_error("CausalLM model is not initialized. Please call "
+                             "initialize() before fill_random_weight().");
+  }
+
+  if (MEMORY_SWAP) {
+    throw std::invalid_argument(
+      "random weights cannot be used with fsu, the weights are read from the "
+      "weight file on demand");
+  }
+
+  std::mt19937 weight_rng(seed);
+  model->forEachLayer(
+    [&weight_rng](ml::train::Layer &, nntrainer::RunLayerContext &context,
+                  void *) {
+      /// shared weights are filled at the first access like they are read
+      for (unsigned int i = 0; i < context.getNumWeights(); ++i) {
+        if (context.isGradientFirstAccess(i))
+          fillRandomWeight(context.getWeight(i), weight_rng);
+      }
+    });
+  nntrainer::Weight::markUpdated();
+
+  buildVocabSelection();
+}
+
+/**
+ * @brief convert FP32 values into a weight in its own data type
+ * @param weight weight to fill
+ * @param src FP32 values of the weight as they are stored in the file
+ * @param row_major true if rows of width() are quantized as they are, like
+ * embeddings. Otherwise src is height() rows of width() outputs and the
+ * width() columns are quantized, then Q4_0 and Q4_K are repacked by 8 rows
+ * as the fully connected kernels expect.
+ */
+static void convertFp32Weight(nntrainer::Tensor &weight, const float *src,
+                              bool row_major) {
+  using Tdatatype = nntrainer::TensorDim::DataType;
+  static constexpr unsigned int CHUNK_ROWS = 64;
+
+  auto &runtime = nntrainer::ThreadRuntime::Global();
+  const size_t len = weight.getDim().getDataLen();
+  const Tdatatype type = weight.getDataType();
+  char *dst = weight.getData<char>();
+
+  switch (type) {
+  case Tdatatype::FP32:
+    std::copy(src, src + len, weight.getData<float>());
+    return;
+#ifdef ENABLE_FP16
+  case Tdatatype::FP16: {
+    static constexpr unsigned int FP16_CHUNK = 1 << 16;
+    _FP16 *out = weight.getData<_FP16>();
+    runtime.parallel_for(0, (len + FP16_CHUNK - 1) / FP16_CHUNK,
+                         [&](unsigned int c) {
+                           const size_t from = static_cast<size_t>(c) *
+                                               FP16_CHUNK;
+                           const size_t to = std::min(from + FP16_CHUNK, len);
+                           for (size_t i = from; i < to; ++i)
+                             out[i] = static_cast<_FP16>(src[i]);
+                         },
+                         1);
+    return;
+  }
+#endif
+  case Tdatatype::Q4_0:
+  case Tdatatype::Q4_K:
+  case Tdatatype::Q6_K:
+    break;
+  default:
+    throw std::invalid_argument("cannot convert FP32 values into the data "
+                                "type of " +
+                                weight.getName());
+  }
+
+  const unsigned int width = weight.width();
+  const unsigned int rows = row_major ? len / width : width;
+  const unsigned int K = len / rows;
+  const unsigned int block = type == Tdatatype::Q4_0 ? 32 : 256;
+  const bool repack = !row_major && type != Tdatatype::Q6_K;
+  if (K % block || (repack && rows % 8))
+    throw std::invalid_argument("cannot quantize " + weight.getName() +
+                                " of " + std::to_string(rows) + " rows of " +
+                                std::to_string(K));
+
+  const size_t row_bytes = weight.getMemoryBytes() / rows;
+  runtime.parallel_for(
+    0, (rows + CHUNK_ROWS - 1) / CHUNK_ROWS,
+    [&](unsigned int c) {
+      const unsigned int row = c * CHUNK_ROWS;
+      const unsigned int n = std::min(CHUNK_ROWS, rows - row);
+      const float *rows_src = src + static_cast<size_t>(row) * K;
+
+      std::vector<float> transposed;
+      if (!row_major) {
+        transposed.resize(static_cast<size_t>(n) * K);
+        for (unsigned int k = 0; k < K; ++k) {
+          const float *col = src + static_cast<size_t>(k) * width + row;
+          for (unsigned int r = 0; r < n; ++r)
+            transposed[static_cast<size_t>(r) * K + k] = col[r];
+        }
+        rows_src = transposed.data();
+      }
+
+      char *out = dst + row * row_bytes;
+      std::vector<char> quantized(repack ? n * row_bytes : 0);
+      char *qdst = repack ? quantized.data() : out;
+      size_t bytes = 0;
+      if (type == Tdatatype::Q4_0)
+        bytes = nntrainer::quantize_q4_0(rows_src, qdst, n, K, nullptr);
+      else if (type == Tdatatype::Q4_K)
+        bytes = nntrainer::quantize_q4_K(rows_src, qdst, n, K, nullptr);
+      else
+        bytes = nntrainer::quantize_q6_K(rows_src, qdst, n, K, nullptr);
+
+      if (repack && type == Tdatatype::Q4_0)
+        nntrainer::repack_q4_0(out, qdst, bytes, n, K);
+      else if (repack)
+        nntrainer::repack_q4_K(out, qdst, bytes, n, K);
+    },
+    1);
+}
+
+void CausalLM::convert_fp32_weight(const std::string &fp32_weight_path) {
+
+  if (!is_initialized) {
+    throw std::runtime_error("CausalLM model is not initialized. Please call "
+                             "initialize() before convert_fp32_weight().");
+  }
+
+  if (MEMORY_SWAP) {
+    throw std::invalid_argument(
+      "weights cannot be converted with fsu, the weights are read from the "
+      "weight file on demand");
+  }
+
+  /// offsets follow NeuralNetwork::load, a shared weight is read where its
+  /// last user would be
+  std::unordered_map<const char *, size_t> offsets;
+  size_t file_bytes = 0;
+  model->forEachLayer([&offsets, &file_bytes](ml::train::Layer &,
+                                              nntrainer::RunLayerContext
+                                                &context,
+                                              void *) {
+    for (unsigned int i = 0; i < context.getNumWeights(); ++i) {
+      nntrainer::Tensor &weight = context.getWeight(i);
+      offsets[weight.getData<char>()] = file_bytes;
+      file_bytes += weight.getDim().getDataLen() * sizeof(float);
+    }
+  });
+
+  int fd = open(fp32_weight_path.c_str(), O_RDONLY);
+  if (fd == -1)
+    throw std::invalid_argument("cannot open " + fp32_weight_path);
+
+  struct stat st {};
+  if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) != file_bytes) {
+    close(fd);
+    throw std::invalid_argument(
+      fp32_weight_path + " is not a FP32 weight file of this model, expected " +
+      std::to_string(file_bytes) + " bytes");
+  }
+
+  void *mapped = mmap(nullptr, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+    throw std::runtime_error("mmap failed: " + fp32_weight_path);
+  const char *base = static_cast<const char *>(mapped);
+
+  try {
+    model->forEachLayer([&offsets, base](ml::train::Layer &layer,
+                                         nntrainer::RunLayerContext &context,
+                                         void *) {
+      const std::string type = layer.getType();
+      const bool row_major = type == causallm::EmbeddingLayer::type ||
+                             type == causallm::TieWordEmbedding::type ||
+                             type == "embedding";
+      for (unsigned int i = 0; i < context.getNumWeights(); ++i) {
+        if (!context.isGradientFirstAccess(i))
+          continue;
+
+        nntrainer::Tensor &weight = context.getWeight(i);
+        const size_t offset = offsets[weight.getData<char>()];
+        convertFp32Weight(
+          weight, reinterpret_cast<const float *>(base + offset), row_major);
+#if !defined(_WIN32)
+        /// FP32 pages are not read again
+        static const size_t page_size = sysconf(_SC_PAGE_SIZE);
+        const size_t begin = offset / page_size * page_size;
+        const size_t end =
+          offset + weight.getDim().getDataLen() * sizeof(float);
+        madvise(const_cast<char *>(base) + begin, end - begin, MADV_DONTNEED);
+#endif
+      }
+    });
+  } catch (...) {
+    munmap(mapped, file_bytes);
+    throw;
+  }
+
+  munmap(mapped, file_bytes);
+  nntrainer::Weight::markUpdated();
+
+  buildVocabSelection();
+}
+
+void CausalLM::run_tokens(
+  const std::vector<unsigned int> &input_ids, unsigned int num_to_generate,
+  const std::function<void(unsigned int)> &on_token) {
+
+  if (!is_initialized) {
+    throw std::runtime_error("CausalLM model is not initialized. Please call "
+                             "initialize() before run_tokens().");
+  }
+
+  const unsigned int input_len = input_ids.size();
+  if (input_len == 0 || input_len > INIT_SEQ_LEN ||
+      input_len + num_to_generate > MAX_SEQ_LEN) {
+    throw std::invalid_argument(
+      "run_tokens needs 1 to INIT_SEQ_LEN input ids and room for the "
+      "generated tokens in MAX_SEQ_LEN");
+  }
+
+  std::vector<unsigned int> input_sample(static_cast<size_t>(BATCH_SIZE) *
+                                         MAX_SEQ_LEN);
+  for (unsigned int b = 0; b < BATCH_SIZE; ++b) {
+    std::copy(input_ids.begin(), input_ids.end(),
+              input_sample.begin() + static_cast<size_t>(b) * MAX_SEQ_LEN);
+    std::copy(input_ids.begin(), input_ids.end(),
+              ids_history + static_cast<size_t>(b) * MAX_SEQ_LEN);
+  }
+
+  logits.resize(static_cast<size_t>(BATCH_SIZE) * NUM_VOCAB);
+  std::vector<float *> output = {logits.data()};
+  std::vector<float *> input = {reinterpret_cast<float *>(input_sample.data())};
+  std::vector<float *> label;
+
+  prefill(input_sample.data(), input_len, 0, output);
+  std::vector<unsigned int> ids_list(generate(output[0], false));
+  if (on_token)
+    on_token(1);
+
+  for (unsigned int n = 1; n < num_to_generate; ++n) {
+    for (unsigned int b = 0; b < BATCH_SIZE; ++b)
+      input_sample[static_cast<size_t>(b) * MAX_SEQ_LEN] = ids_list[b];
+
+    const unsigned int pos = input_len + n - 1;
+    model->incremental_inference(BATCH_SIZE, input, label, output, input_len,
+                                 pos, pos + 1);
+    ids_list = generate(output[0], false);
+    if (on_token)
+      on_token(n + 1);
+  }
+}
+
 std::vector<unsigned int> CausalLM::generate(float *logits, bool do_sample,
                                              float repetition_penalty,
                                              unsigned int *input_ids,
@@ -656,6 +1086,7 @@ CausalLM::createAttention(const int layer_id, int seq_len, int n_heads,
                                 : UINT_MAX),
     withKey("rope_theta", ROPE_THETA),
     withKey("max_new_tokens", std::to_string(NUM_TO_GENERATE)),
+    withKey("kv_cache_type", KV_CACHE_TYPE),
     withKey("input_layers", {Q, K, V})};
   layers.push_back(createLayer("mha_core", a_params));
 
@@ -770,18 +1201,15 @@ void CausalLM::save_kvcache(std::string path, int to_) {
               void *idx) {
       if (l.getType() == causallm::MHACoreLayer::type) {
         int to = static_cast<int>(reinterpret_cast<intptr_t>(idx));
-        auto k_cache = context.getTensor(0);
-        auto v_cache = context.getTensor(1);
-        ml::train::TensorDim k_dim = k_cache.getDim();
-        ml::train::TensorDim v_dim = v_cache.getDim();
-        k_dim.height(to);
-        v_dim.height(to);
-        nntrainer::Tensor k_cache_prompt =
-          k_cache.getSharedDataTensor(k_dim, 0, true);
-        nntrainer::Tensor v_cache_prompt =
-          v_cache.getSharedDataTensor(v_dim, 0, true);
-        k_cache_prompt.save(f);
-        v_cache_prompt.save(f);
+        for (unsigned int i : MHACoreLayer::getCacheTensorIdx(context)) {
+          auto cache = context.getTensor(i);
+          ml::train::TensorDim dim = cache.getDim();
+          /// sliding window layers keep at most their window
+          dim.height(std::min<unsigned int>(to, dim.height()));
+          nntrainer::Tensor cache_prompt =
+            cache.getSharedDataTensor(dim, 0, true);
+          cache_prompt.save(f);
+        }
       }
     };
   void *arg = reinterpret_cast<void *>(static_cast<intptr_t>(to_));
@@ -800,18 +1228,15 @@ void CausalLM::load_kvcache(std::string path, int to_) {
               void *idx) {
       if (l.getType() == causallm::MHACoreLayer::type) {
         int to = static_cast<int>(reinterpret_cast<intptr_t>(idx));
-        auto k_cache = context.getTensor(0);
-        auto v_cache = context.getTensor(1);
-        ml::train::TensorDim k_dim = k_cache.getDim();
-        ml::train::TensorDim v_dim = v_cache.getDim();
-        k_dim.height(to);
-        v_dim.height(to);
-        nntrainer::Tensor k_cache_prompt =
-          k_cache.getSharedDataTensor(k_dim, 0, true);
-        nntrainer::Tensor v_cache_prompt =
-          v_cache.getSharedDataTensor(v_dim, 0, true);
-        k_cache_prompt.read(f);
-        v_cache_prompt.read(f);
+        for (unsigned int i : MHACoreLayer::getCacheTensorIdx(context)) {
+          auto cache = context.getTensor(i);
+          ml::train::TensorDim dim = cache.getDim();
+          /// sliding window layers keep at most their window
+          dim.height(std::min<unsigned int>(to, dim.height()));
+          nntrainer::Tensor cache_prompt =
+            cache.getSharedDataTensor(dim, 0, true);
+          cache_prompt.read(f);
+        }
       }
     };
   void *arg = reinterpret_cast<void *>(static_cast<intptr_t>(to_));
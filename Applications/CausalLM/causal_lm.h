@@ -45,6 +45,7 @@
 #define WCHAR_P std::string &
 #endif
 
+#include <functional>
 #include <layer.h>
 #include <model.h>
 #include <random>
@@ -96,8 +97,12 @@ public:
 
   /**
    * @brief Save the weight to a file
+   * @param format MODEL_FORMAT_WEIGHT_CONTAINER to save an indexed container
+   * whose weights are used in place from the mapped file when loaded
    */
-  void save_weight(const std::string &weight_path);
+  void save_weight(const std::string &weight_path,
+                   ml::train::ModelFormat format =
+                     ml::train::ModelFormat::MODEL_FORMAT_BIN);
 
   /**
    * @brief run the CausalLM model
@@ -105,6 +110,36 @@ public:
   void run(const WSTR prompt, bool do_sample = false,
            const WSTR system_prompt = "", const WSTR tail_prompt = "");
 
+  /**
+   * @brief fill the weights with random values instead of loading them
+   * @param seed seed of the random values
+   * @note quantized weights hold random values quantized in the layout the
+   * kernels expect, so the model runs the same code as with real weights
+   */
+  void fill_random_weight(unsigned int seed = 0);
+
+  /**
+   * @brief load a weight file saved in FP32 converting every weight into the
+   * data type of the graph
+   * @param fp32_weight_path weight file of this model with FP32 weights
+   * @note the file is mapped and read where load_weight() would read it.
+   * Fully connected weights are transposed into rows of the input size
+   * before they are quantized and repacked, embedding rows are quantized as
+   * they are. Every weight is converted by all threads of the ThreadRuntime.
+   */
+  void convert_fp32_weight(const std::string &fp32_weight_path);
+
+  /**
+   * @brief run prefill and greedy decoding on token ids without the tokenizer
+   * @param input_ids prompt token ids fed to every batch
+   * @param num_to_generate number of tokens to generate, EOS does not stop it
+   * @param on_token called with the number of generated tokens after the
+   * prefill and after each decoding step
+   */
+  void run_tokens(const std::vector<unsigned int> &input_ids,
+                  unsigned int num_to_generate,
+                  const std::function<void(unsigned int)> &on_token = nullptr);
+
 protected:
   /**
    * @brief Setup the parameters for the CausalLM model
@@ -160,6 +195,23 @@ protected:
    */
   WIN_EXPORT virtual void load_kvcache(std::string path, int to);
 
+  /**
+   * @brief build the vocabulary selection index of the tied lm head from the
+   * weights, called whenever the weights are loaded
+   */
+  void buildVocabSelection();
+
+  /**
+   * @brief prefill the kv caches with the tokens in [from, from + len)
+   * @param input_sample token ids of each batch, MAX_SEQ_LEN apart
+   * @param len number of tokens to prefill
+   * @param from position of the first token
+   * @param output lm head output of the last token
+   * @note the tokens are fed PREFILL_CHUNK_SIZE at a time when it is set
+   */
+  void prefill(const unsigned int *input_sample, unsigned int len,
+               unsigned int from, const std::vector<float *> &output);
+
   /**
    * @brief generate
    */
@@ -175,6 +227,7 @@ protected:
   std::vector<std::string>
     output_list;             /**< List of output names for the model */
   unsigned int *ids_history; /**< History of input IDs for the model */
+  std::vector<float> logits; /**< LM head output reused across the steps */
 
   /** tokenizer */
   std::unique_ptr<tokenizers::Tokenizer> tokenizer;
@@ -185,7 +238,10 @@ protected:
   int HEAD_DIM;
   int INTERMEDIATE_SIZE;
   int NUM_LAYERS;
-  bool USE_VOCAB_SELECTION;
+  bool USE_VOCAB_SELECTION;             /**< shortlist the lm head rows */
+  unsigned int VOCAB_SELECTION_CLUSTERS; /**< clusters of the lm head rows */
+  unsigned int VOCAB_SELECTION_PROBES;   /**< clusters scored per step */
+  float VOCAB_SELECTION_MARGIN;          /**< 1.0 keeps the argmax exact */
   bool TIE_WORD_EMBEDDINGS;
   unsigned int MAX_SEQ_LEN;
   int NUM_HEADS;
@@ -195,6 +251,7 @@ protected:
   std::string EMBEDDING_DTYPE; /** embedding dtype */
   std::string LMHEAD_DTYPE;    /** embedding dtype */
   std::string FC_LAYER_DTYPE;  /** custom_fc_lora */
+  std::string KV_CACHE_TYPE;   /** fp16, int8 or int4 */
   std::vector<unsigned int> EOS_TOKEN_ID;
   unsigned int BOS_TOKEN_ID;
   float TEMPERATURE;
@@ -210,6 +267,7 @@ protected:
   unsigned int NUM_BADWORDS;              /**< Number of bad words */
   unsigned int BATCH_SIZE;                /**< Batch size for the model */
   unsigned int INIT_SEQ_LEN;              /**< Initial sequence length */
+  unsigned int PREFILL_CHUNK_SIZE;        /**< prefill tokens per step */
   unsigned int MAX_POSITION_EMBEDDINGS;   /**< max position embeddings */
   bool MEMORY_SWAP;                       /**< Memory swap option */
   unsigned int FSU_LOOKAHEAD;
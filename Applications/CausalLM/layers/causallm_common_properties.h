@@ -95,6 +95,42 @@ public:
   using prop_tag = nntrainer::enum_class_prop_tag;
   static constexpr const char *key = "gamma_initializer";
 };
+
+/**
+ * @brief VocabSelectionClusters, number of clusters the lm head rows are
+ * grouped into for vocabulary shortlisting (0 disables the shortlisting)
+ */
+class VocabSelectionClusters : public nntrainer::Property<unsigned int> {
+public:
+  VocabSelectionClusters(unsigned int value = 0) { set(value); };
+  static constexpr const char *key =
+    "vocab_selection_clusters";              /**< unique key to access */
+  using prop_tag = nntrainer::uint_prop_tag; /**< property type */
+};
+
+/**
+ * @brief VocabSelectionProbes, number of clusters scored per decoding step
+ */
+class VocabSelectionProbes : public nntrainer::PositiveIntegerProperty {
+public:
+  VocabSelectionProbes(unsigned int value = 16) { set(value); };
+  static constexpr const char *key =
+    "vocab_selection_probes";                /**< unique key to access */
+  using prop_tag = nntrainer::uint_prop_tag; /**< property type */
+};
+
+/**
+ * @brief VocabSelectionMargin, scale of the cluster radius used to bound the
+ * logits of the unscored clusters. 1.0 keeps the argmax exact, smaller values
+ * fall back to the full lm head less often at the cost of exactness
+ */
+class VocabSelectionMargin : public nntrainer::Property<float> {
+public:
+  VocabSelectionMargin(float value = 1.0f) { set(value); };
+  static constexpr const char *key =
+    "vocab_selection_margin";                 /**< unique key to access */
+  using prop_tag = nntrainer::float_prop_tag; /**< property type */
+};
 }; // namespace props
 
 WIN_EXPORT enum RMSParams { gamma };
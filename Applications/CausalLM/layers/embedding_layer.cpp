@@ -38,9 +38,11 @@ void EmbeddingLayer::finalize(nntrainer::InitLayerContext &context) {
   NNTR_THROW_IF(input_dim.channel() != 1, std::invalid_argument)
     << "Embedding layer takes only one for channel size";
 
-  NNTR_THROW_IF(input_dim.getDataType() != nntrainer::TensorDim::DataType::FP32,
-                std::invalid_argument)
-    << "Embedding layer takes only FP32 input data";
+  NNTR_THROW_IF(
+    input_dim.getDataType() != nntrainer::TensorDim::DataType::FP32 &&
+      input_dim.getDataType() != nntrainer::TensorDim::DataType::UINT32,
+    std::invalid_argument)
+    << "Embedding layer takes only FP32 or UINT32 input data";
 
   auto &weight_regularizer =
     std::get<nntrainer::props::WeightRegularizer>(*layer_impl_props);
@@ -104,16 +106,18 @@ void EmbeddingLayer::incremental_forwarding(nntrainer::RunLayerContext &context,
 
   unsigned int b_size = input_.batch();
 
+  const bool uint_input =
+    input_.getDataType() == nntrainer::TensorDim::DataType::UINT32;
   for (unsigned int b = 0; b < b_size; ++b) {
-    float *in_data =
-      input_.getAddress<float>(b * input_.getDim().getFeatureLen());
+    const void *in_data =
+      input_.getAddress<void>(b * input_.getDim().getFeatureLen());
     nntrainer::Tensor batchsliced_hidden = hidden_.getBatchSlice(b, 1);
 
     int iter = to - from;
 
 #pragma omp parallel for
     for (int i = 0; i < iter; ++i) {
-      size_t embed_idx = static_cast<size_t>(in_data[i]);
+      size_t embed_idx = nntrainer::wordIndex(in_data, uint_input, i);
       if (embed_idx >= in_dim) {
         throw std::invalid_argument("input word index is greater than in_dim");
       }
@@ -13,6 +13,7 @@
  */
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <thread>
 #include <vector>
 
@@ -21,6 +22,7 @@
 #include <mha_core.h>
 #include <nntrainer_error.h>
 #include <node_exporter.h>
+#include <scratch_arena.h>
 
 #include <cstdint>
 
@@ -44,7 +46,8 @@ MHACoreLayer::MHACoreLayer() :
     nntrainer::props::AverageAttentionWeight(), nntrainer::props::MaxTimestep(),
     props::SlidingWindow(), props::MaxNewTokens(), props::RopeTheta(),
     props::MaxPositionEmbeddings(), props::UseSink(), props::RopeScalingType(),
-    props::RopeScalingFactor(), props::RopeScalingMaxPositionEmbeddings()),
+    props::RopeScalingFactor(), props::RopeScalingMaxPositionEmbeddings(),
+    props::KVCacheType()),
   sm(nntrainer::ActivationType::ACT_SOFTMAX),
   epsilon(1e-3),
   cache_index(0),
@@ -85,6 +88,10 @@ void MHACoreLayer::finalize(nntrainer::InitLayerContext &context) {
   /** local window size */
   local_window_size = std::get<props::SlidingWindow>(mha_core_props).get();
 
+  /** sliding window layers keep only the last window in a ring buffer */
+  const unsigned int cache_len =
+    std::min<size_t>(max_timestep, local_window_size);
+
   /** attention scaling computation */
   rope_scaling_type = std::get<props::RopeScalingType>(mha_core_props).get();
   scale = std::get<props::RopeScalingFactor>(mha_core_props).get();
@@ -135,29 +142,112 @@ void MHACoreLayer::finalize(nntrainer::InitLayerContext &context) {
                                      0.0f, "sink");
   }
 
-  /** Tensor for KV-Cache */
+  /** quantized KV-Cache */
+  const std::string kv_cache_type =
+    std::get<props::KVCacheType>(mha_core_props).get();
+  if (kv_cache_type == "int8")
+    kv_cache_bits = 8;
+  else if (kv_cache_type == "int4")
+    kv_cache_bits = 4;
+  else
+    NNTR_THROW_IF(kv_cache_type != "fp16", std::invalid_argument)
+      << "Unsupported kv_cache_type: " << kv_cache_type;
+
+  if (kv_cache_bits) {
+    NNTR_THROW_IF(context.getActivationDataType() !=
+                    ml::train::TensorDim::DataType::FP32,
+                  std::invalid_argument)
+      << "quantized kv cache supports FP32 activation only";
+    NNTR_THROW_IF(head_dim % 32, std::invalid_argument)
+      << "quantized kv cache needs head_dim to be a multiple of 32";
+
+    ml::train::TensorDim cache_dim(
+      {batch_size, 1, cache_len,
+       static_cast<unsigned int>(num_heads_KV * head_dim * kv_cache_bits / 8)},
+      {context.getFormat(), ml::train::TensorDim::DataType::UINT8});
+    ml::train::TensorDim cache_scale_dim(
+      {batch_size, 1, cache_len,
+       static_cast<unsigned int>(num_heads_KV * head_dim / 32)},
+      {context.getFormat(), ml::train::TensorDim::DataType::UINT16});
+
+    tensor_idx[AttentionParams::cache_key] = context.requestTensor(
+      cache_dim, "cache_key", nntrainer::Initializer::NONE, false,
+      nntrainer::TensorLifespan::MAX_LIFESPAN);
+    tensor_idx[AttentionParams::cache_value] = context.requestTensor(
+      cache_dim, "cache_value", nntrainer::Initializer::NONE, false,
+      nntrainer::TensorLifespan::MAX_LIFESPAN);
+    tensor_idx[AttentionParams::cache_key_scale] = context.requestTensor(
+      cache_scale_dim, "cache_key_scale", nntrainer::Initializer::NONE, false,
+      nntrainer::TensorLifespan::MAX_LIFESPAN);
+    tensor_idx[AttentionParams::cache_value_scale] = context.requestTensor(
+      cache_scale_dim, "cache_value_scale", nntrainer::Initializer::NONE,
+      false, nntrainer::TensorLifespan::MAX_LIFESPAN);
+  } else {
+    /** Tensor for KV-Cache */
 #ifdef ENABLE_FP16
-  ml::train::TensorDim cache_key_dim(
-    {batch_size, 1, max_timestep, num_heads_KV * head_dim},
-    {context.getFormat(), ml::train::TensorDim::DataType::FP16});
-  ml::train::TensorDim cache_value_dim(
-    {batch_size, 1, max_timestep, num_heads_KV * head_dim},
-    {context.getFormat(), ml::train::TensorDim::DataType::FP16});
+    ml::train::TensorDim cache_key_dim(
+      {batch_size, 1, cache_len, num_heads_KV * head_dim},
+      {context.getFormat(), ml::train::TensorDim::DataType::FP16});
+    ml::train::TensorDim cache_value_dim(
+      {batch_size, 1, cache_len, num_heads_KV * head_dim},
+      {context.getFormat(), ml::train::TensorDim::DataType::FP16});
 #else
-  ml::train::TensorDim cache_key_dim(
-    {batch_size, 1, max_timestep, num_heads_KV * head_dim},
-    {context.getFormat(), ml::train::TensorDim::DataType::UINT16});
-  ml::train::TensorDim cache_value_dim(
-    {batch_size, 1, max_timestep, num_heads_KV * head_dim},
-    {context.getFormat(), ml::train::TensorDim::DataType::UINT16});
+    ml::train::TensorDim cache_key_dim(
+      {batch_size, 1, cache_len, num_heads_KV * head_dim},
+      {context.getFormat(), ml::train::TensorDim::DataType::UINT16});
+    ml::train::TensorDim cache_value_dim(
+      {batch_size, 1, cache_len, num_heads_KV * head_dim},
+      {context.getFormat(), ml::train::TensorDim::DataType::UINT16});
 #endif
 
-  tensor_idx[AttentionParams::cache_key] = context.requestTensor(
-    cache_key_dim, "cache_key", nntrainer::Initializer::NONE, false,
-    nntrainer::TensorLifespan::MAX_LIFESPAN);
-  tensor_idx[AttentionParams::cache_value] = context.requestTensor(
-    cache_value_dim, "cache_value", nntrainer::Initializer::NONE, false,
-    nntrainer::TensorLifespan::MAX_LIFESPAN);
+    tensor_idx[AttentionParams::cache_key] = context.requestTensor(
+      cache_key_dim, "cache_key", nntrainer::Initializer::NONE, false,
+      nntrainer::TensorLifespan::MAX_LIFESPAN);
+    tensor_idx[AttentionParams::cache_value] = context.requestTensor(
+      cache_value_dim, "cache_value", nntrainer::Initializer::NONE, false,
+      nntrainer::TensorLifespan::MAX_LIFESPAN);
+  }
+
+  /**
+   * FP32 activations decode on (batch, kv head) tiles. The tiles read the FP16
+   * cache as its raw halves, which covers the FP16 cache of Android as well.
+   */
+  tiled_decoding =
+    context.getActivationDataType() == ml::train::TensorDim::DataType::FP32;
+
+  /** scratch tensors of the steps, planned with the other forward tensors */
+#if ENABLE_FP16 && defined(__ANDROID__)
+  /** prefill of FP32 activations runs the FP16 kernels over FP16 copies */
+  if (!kv_cache_bits && context.getActivationDataType() ==
+                          ml::train::TensorDim::DataType::FP32) {
+    ml::train::TensorDim query_step_dim(
+      {1, 1, query_dim.height(), query_width},
+      {context.getFormat(), ml::train::TensorDim::DataType::FP16});
+    ml::train::TensorDim kv_step_dim(
+      {1, 1, query_dim.height(), key_width},
+      {context.getFormat(), ml::train::TensorDim::DataType::FP16});
+    tensor_idx[AttentionParams::fp16_query_step] = context.requestTensor(
+      query_step_dim, "fp16_query_step", nntrainer::Initializer::NONE, false,
+      nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+    tensor_idx[AttentionParams::fp16_key_step] = context.requestTensor(
+      kv_step_dim, "fp16_key_step", nntrainer::Initializer::NONE, false,
+      nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+    tensor_idx[AttentionParams::fp16_value_step] = context.requestTensor(
+      kv_step_dim, "fp16_value_step", nntrainer::Initializer::NONE, false,
+      nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+    tensor_idx[AttentionParams::fp16_output_step] = context.requestTensor(
+      query_step_dim, "fp16_output_step", nntrainer::Initializer::NONE, false,
+      nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+  }
+#endif
+  if (tiled_decoding) {
+    ml::train::TensorDim score_dim(
+      {batch_size, 1, cache_len, static_cast<unsigned int>(num_heads_Q)},
+      {context.getFormat(), ml::train::TensorDim::DataType::FP32});
+    tensor_idx[AttentionParams::attention_score] = context.requestTensor(
+      score_dim, "attention_score", nntrainer::Initializer::NONE, false,
+      nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+  }
 
   theta = (float)std::get<props::RopeTheta>(mha_core_props).get();
 
@@ -196,10 +286,17 @@ void MHACoreLayer::incremental_forwarding(nntrainer::RunLayerContext &context,
   unsigned int max_timestep =
     std::get<nntrainer::props::MaxTimestep>(mha_core_props).get();
 
+  /**
+   * Sliding window layers keep their keys and values in a ring buffer of
+   * local_window_size rows : the position p is stored at p % window.
+   * Keys are rotated before caching, so the rows carry their own position.
+   */
+  const bool ring_cache = local_window_size < max_timestep;
+
   unsigned int from = _from;
   unsigned int to = _to;
 
-  if (to >= max_timestep) {
+  if (!ring_cache && to >= max_timestep) {
     // initial forwarding
     if (!_from) {
       throw std::invalid_argument(
@@ -214,13 +311,32 @@ void MHACoreLayer::incremental_forwarding(nntrainer::RunLayerContext &context,
   }
 
   // util fn to compute tensor dimension for one step.
-  auto get_step_dim = [to, from](const ml::train::TensorDim &dim) {
+  auto get_step_dim = [](const ml::train::TensorDim &dim,
+                         unsigned int height) {
     auto step_dim = dim;
     step_dim.batch(1);
-    step_dim.height(to - from); // One is expected.
+    step_dim.height(height); // One is expected.
     return step_dim;
   };
 
+  // util fn to copy one cache row between (batch, row) locations. The bytes
+  // are copied as they are, copyData() of the UINT caches would also copy the
+  // quantization parameters it expects past the row into the next rows.
+  auto copy_row = [&](nntrainer::Tensor &src, unsigned int src_batch,
+                      unsigned int src_row, nntrainer::Tensor &dst,
+                      unsigned int dst_batch, unsigned int dst_row) {
+    const ml::train::TensorDim src_dim = src.getDim();
+    const ml::train::TensorDim dst_dim = dst.getDim();
+    const size_t elem_size = src_dim.getDataTypeSize();
+    const size_t src_offset =
+      src_batch * src_dim.getFeatureLen() + src_row * src_dim.width();
+    const size_t dst_offset =
+      dst_batch * dst_dim.getFeatureLen() + dst_row * dst_dim.width();
+    std::memcpy(dst.getData<char>() + dst_offset * elem_size,
+                src.getData<char>() + src_offset * elem_size,
+                src_dim.width() * elem_size);
+  };
+
   /** incremental forwarding for each batch */
   nntrainer::Tensor &query =
     context.getInput(INOUT_INDEX::QUERY); // projected query
@@ -235,14 +351,19 @@ void MHACoreLayer::incremental_forwarding(nntrainer::RunLayerContext &context,
   nntrainer::Tensor &cache_value =
     context.getTensor(tensor_idx[AttentionParams::cache_value]);
 
+  nntrainer::Tensor cache_key_scale, cache_value_scale;
+  if (kv_cache_bits) {
+    cache_key_scale =
+      context.getTensor(tensor_idx[AttentionParams::cache_key_scale]);
+    cache_value_scale =
+      context.getTensor(tensor_idx[AttentionParams::cache_value_scale]);
+  }
+
   nntrainer::Tensor sink;
   if (use_sink) {
     sink = context.getWeight(sink_idx);
   }
 
-  const unsigned int num_heads_Q =
-    std::get<nntrainer::props::NumHeads>(mha_core_props).get();
-
   ml::train::TensorDim query_dim =
     query.getDim(); // (B, 1, seq_len, n_heads_Q * head_dim)
   ml::train::TensorDim key_dim =
@@ -251,24 +372,108 @@ void MHACoreLayer::incremental_forwarding(nntrainer::RunLayerContext &context,
     value.getDim(); // (B, 1, seq_len, n_heads_KV * head_dim)
   ml::train::TensorDim output_dim =
     output.getDim(); // (B, 1, seq_len, n_heads_Q * head_dim)
-  ml::train::TensorDim cache_key_dim =
-    cache_key.getDim(); // (B, 1, max_seq_len, n_heads_KV * head_dim)
-  ml::train::TensorDim cache_value_dim =
-    cache_value.getDim(); // (B, 1, max_seq_len, n_heads_KV * head_dim)
 
   ml::train::TensorDim query_step_dim =
-    get_step_dim(query_dim); // (B, 1, from-to, n_heads_Q * head_dim)
-  ml::train::TensorDim key_step_dim = get_step_dim(key_dim);
-  ml::train::TensorDim value_step_dim = get_step_dim(value_dim);
+    get_step_dim(query_dim, to - from); // (1, 1, to-from, n_heads_Q * head_dim)
+  ml::train::TensorDim key_step_dim = get_step_dim(key_dim, to - from);
+  ml::train::TensorDim value_step_dim = get_step_dim(value_dim, to - from);
   ml::train::TensorDim output_step_dim =
-    get_step_dim(output_dim); // (B, 1, from-to, n_heads_Q * head_dim)
-  ml::train::TensorDim cache_key_step_dim =
-    get_step_dim(cache_key_dim); // (B, 1, from-to, n_heads_KV * head_dim)
+    get_step_dim(output_dim, to - from); // (1, 1, to-from, n_heads_Q * hd)
 
-  ml::train::TensorDim cache_value_step_dim =
-    get_step_dim(cache_value_dim); // (B, 1, from-to, n_heads_KV * head_dim)
+  /**
+   * attend the query rows at from..to over the cache rows up to `to`, where
+   * the keys and values of the step are stored from the row cache_from.
+   */
+  auto forward_one_batch =
+    [&](unsigned int batch, unsigned int cache_from, unsigned int from,
+        unsigned int to, nntrainer::Tensor &query_step,
+        nntrainer::Tensor &key_step, nntrainer::Tensor &value_step,
+        nntrainer::Tensor &output_step, nntrainer::Tensor &cache_key,
+        nntrainer::Tensor &cache_value, nntrainer::Tensor &cache_key_scale,
+        nntrainer::Tensor &cache_value_scale) {
+      if (kv_cache_bits) {
+        one_batch_quantized_incremental_forwarding(
+          batch, _from, cache_from, from, to, query_step, key_step, value_step,
+          output_step, cache_key, cache_value, cache_key_scale,
+          cache_value_scale, use_sink ? &sink : nullptr);
+        return;
+      }
+
+      ml::train::TensorDim cache_key_dim =
+        cache_key.getDim(); // (B, 1, max_seq_len, n_heads_KV * head_dim)
+      ml::train::TensorDim cache_value_dim =
+        cache_value.getDim(); // (B, 1, max_seq_len, n_heads_KV * head_dim)
+      ml::train::TensorDim cache_key_step_dim = get_step_dim(
+        cache_key_dim, to - from); // (1, 1, to-from, n_heads_KV * head_dim)
+      ml::train::TensorDim cache_value_step_dim = get_step_dim(
+        cache_value_dim, to - from); // (1, 1, to-from, n_heads_KV * head_dim)
+
+      if (query_step.getDataType() == ml::train::TensorDim::DataType::FP32) {
+#if ENABLE_FP16 && defined(__ANDROID__)
+        /** FP16 copies of the step live in the scratch tensors of the layer */
+        auto fp16_step = [&](AttentionParams idx,
+                             const nntrainer::Tensor &step) {
+          nntrainer::TensorDim step_dim = step.getDim();
+          step_dim.setDataType(ml::train::TensorDim::DataType::FP16);
+          return context.getTensor(tensor_idx[idx]).getSharedDataTensor(
+            step_dim, 0, true);
+        };
+
+        nntrainer::Tensor Q_step =
+          fp16_step(AttentionParams::fp16_query_step, query_step);
+        nntrainer::Tensor K_step =
+          fp16_step(AttentionParams::fp16_key_step, key_step);
+        nntrainer::Tensor V_step =
+          fp16_step(AttentionParams::fp16_value_step, value_step);
+        nntrainer::Tensor O_step =
+          fp16_step(AttentionParams::fp16_output_step, output_step);
+
+        Q_step.copyData(query_step);
+        K_step.copyData(key_step);
+        V_step.copyData(value_step);
+        if (use_sink) {
+          one_batch_incremental_forwarding(
+            batch, _from, cache_from, from, to, Q_step, K_step, V_step, O_step,
+            cache_key, cache_value, cache_key_dim, cache_key_step_dim,
+            cache_value_dim, cache_value_step_dim, sink);
+        } else {
+          one_batch_incremental_forwarding(
+            batch, _from, cache_from, from, to, Q_step, K_step, V_step, O_step,
+            cache_key, cache_value, cache_key_dim, cache_key_step_dim,
+            cache_value_dim, cache_value_step_dim);
+        }
+        output_step.copyData(O_step);
+#else
+        if (use_sink) {
+          one_batch_incremental_forwarding(
+            batch, _from, cache_from, from, to, query_step, key_step,
+            value_step, output_step, cache_key, cache_value, cache_key_dim,
+            cache_key_step_dim, cache_value_dim, cache_value_step_dim, sink);
+        } else {
+          one_batch_incremental_forwarding(
+            batch, _from, cache_from, from, to, query_step, key_step,
+            value_step, output_step, cache_key, cache_value, cache_key_dim,
+            cache_key_step_dim, cache_value_dim, cache_value_step_dim);
+        }
+#endif
+      } else {
+        one_batch_incremental_forwarding(
+          batch, _from, cache_from, from, to, query_step, key_step, value_step,
+          output_step, cache_key, cache_value, cache_key_dim,
+          cache_key_step_dim, cache_value_dim, cache_value_step_dim);
+      }
+    };
+
+  if (_from && to - from == 1 && tiled_decoding) {
+    if (!ring_cache || to <= local_window_size)
+      tiled_decoding_forwarding(context, _from, from, from, to);
+    else
+      tiled_decoding_forwarding(context, _from, from % local_window_size,
+                                local_window_size - 1, local_window_size);
+    return;
+  }
 
-  unsigned int batch_size = (_from) ? 1 : query_dim.batch();
+  unsigned int batch_size = query_dim.batch();
   // do the incremental forwarding
   for (unsigned int batch = 0; batch < batch_size; ++batch) {
 
@@ -282,86 +487,221 @@ void MHACoreLayer::incremental_forwarding(nntrainer::RunLayerContext &context,
     nntrainer::Tensor output_step = output.getSharedDataTensor(
       output_step_dim, batch * output_dim.getFeatureLen(), true);
 
-    if (query_step.getDataType() == ml::train::TensorDim::DataType::FP32) {
-#if ENABLE_FP16 && defined(__ANDROID__)
-      nntrainer::TensorDim Q_step_dim = query_step_dim;
-      nntrainer::TensorDim K_step_dim = key_step_dim;
-      nntrainer::TensorDim V_step_dim = value_step_dim;
-      nntrainer::TensorDim O_step_dim = output_step_dim;
-      Q_step_dim.setDataType(ml::train::TensorDim::DataType::FP16);
-      K_step_dim.setDataType(ml::train::TensorDim::DataType::FP16);
-      V_step_dim.setDataType(ml::train::TensorDim::DataType::FP16);
-      O_step_dim.setDataType(ml::train::TensorDim::DataType::FP16);
-
-      nntrainer::Tensor Q_step = nntrainer::Tensor(Q_step_dim, true);
-      nntrainer::Tensor K_step = nntrainer::Tensor(K_step_dim, true);
-      nntrainer::Tensor V_step = nntrainer::Tensor(V_step_dim, true);
-      nntrainer::Tensor O_step = nntrainer::Tensor(O_step_dim, true);
-
-      Q_step.copyData(query_step);
-      K_step.copyData(key_step);
-      V_step.copyData(value_step);
-      if (use_sink) {
-        one_batch_incremental_forwarding(
-          batch, _from, from, to, Q_step, K_step, V_step, O_step, cache_key,
-          cache_value, cache_key_dim, cache_key_step_dim, cache_value_dim,
-          cache_value_step_dim, sink);
-      } else {
-        one_batch_incremental_forwarding(batch, _from, from, to, Q_step, K_step,
-                                         V_step, O_step, cache_key, cache_value,
-                                         cache_key_dim, cache_key_step_dim,
-                                         cache_value_dim, cache_value_step_dim);
+    if (!ring_cache || to <= local_window_size) {
+      forward_one_batch(batch, from, from, to, query_step, key_step,
+                        value_step, output_step, cache_key, cache_value,
+                        cache_key_scale, cache_value_scale);
+    } else if (to - from == 1) {
+      /** the ring is full; attention does not depend on the row order */
+      const unsigned int window = local_window_size;
+      forward_one_batch(batch, from % window, window - 1, window, query_step,
+                        key_step, value_step, output_step, cache_key,
+                        cache_value, cache_key_scale, cache_value_scale);
+    } else {
+      /**
+       * the step wraps around the ring. Attend over a linear copy of the
+       * positions begin..to, then store the last window back to the ring.
+       */
+      const unsigned int window = local_window_size;
+      const unsigned int begin = from < window ? 0 : from - window + 1;
+      auto linear_cache = [&](nntrainer::Tensor &cache) {
+        nntrainer::Tensor linear(get_step_dim(cache.getDim(), to - begin),
+                                 true);
+        for (unsigned int pos = begin; pos < from; ++pos)
+          copy_row(cache, batch, pos % window, linear, 0, pos - begin);
+        return linear;
+      };
+
+      nntrainer::Tensor linear_key = linear_cache(cache_key);
+      nntrainer::Tensor linear_value = linear_cache(cache_value);
+      nntrainer::Tensor linear_key_scale, linear_value_scale;
+      if (kv_cache_bits) {
+        linear_key_scale = linear_cache(cache_key_scale);
+        linear_value_scale = linear_cache(cache_value_scale);
       }
-      output_step.copyData(O_step);
-#else
-      if (use_sink) {
-        one_batch_incremental_forwarding(
-          batch, _from, from, to, query_step, key_step, value_step, output_step,
-          cache_key, cache_value, cache_key_dim, cache_key_step_dim,
-          cache_value_dim, cache_value_step_dim, sink);
-      } else {
-        one_batch_incremental_forwarding(
-          batch, _from, from, to, query_step, key_step, value_step, output_step,
-          cache_key, cache_value, cache_key_dim, cache_key_step_dim,
-          cache_value_dim, cache_value_step_dim);
+
+      forward_one_batch(0, from - begin, from - begin, to - begin, query_step,
+                        key_step, value_step, output_step, linear_key,
+                        linear_value, linear_key_scale, linear_value_scale);
+
+      for (unsigned int pos = std::max(from, to - window); pos < to; ++pos) {
+        copy_row(linear_key, 0, pos - begin, cache_key, batch, pos % window);
+        copy_row(linear_value, 0, pos - begin, cache_value, batch,
+                 pos % window);
+        if (kv_cache_bits) {
+          copy_row(linear_key_scale, 0, pos - begin, cache_key_scale, batch,
+                   pos % window);
+          copy_row(linear_value_scale, 0, pos - begin, cache_value_scale,
+                   batch, pos % window);
+        }
       }
-#endif
-    } else {
-      one_batch_incremental_forwarding(
-        batch, _from, from, to, query_step, key_step, value_step, output_step,
-        cache_key, cache_value, cache_key_dim, cache_key_step_dim,
-        cache_value_dim, cache_value_step_dim);
     }
   }
 
   if (!_from) {
-    batch_size = query_dim.batch();
-    nntrainer::Tensor cache_key_0_step =
-      cache_key.getSharedDataTensor(cache_key_step_dim, 0, true);
-    nntrainer::Tensor cache_value_0_step =
-      cache_value.getSharedDataTensor(cache_value_step_dim, 0, true);
-
-    for (unsigned int batch = 1; batch < batch_size; ++batch) {
-      nntrainer::Tensor cache_key_nth_step = cache_key.getSharedDataTensor(
-        cache_key_step_dim,
-        batch * cache_key_dim.getFeatureLen() + from * cache_key_dim.width(),
-        true);
-      nntrainer::Tensor cache_value_nth_step =
-        cache_key.getSharedDataTensor(cache_value_step_dim,
-                                      batch * cache_value_dim.getFeatureLen() +
-                                        from * cache_value_dim.width(),
-                                      true);
-
-      cache_key_nth_step.copyData(cache_key_0_step);
-      cache_key_nth_step.copyData(cache_value_0_step);
+    /** copy the cached rows of the first batch to the other batches, byte by
+     * byte like copy_row */
+    auto copy_first_batch = [&](nntrainer::Tensor &cache) {
+      const ml::train::TensorDim dim = cache.getDim();
+      const size_t batch_bytes = dim.getFeatureLen() * dim.getDataTypeSize();
+      const size_t rows_bytes = std::min<size_t>(to, dim.height()) *
+                                dim.width() * dim.getDataTypeSize();
+      char *data = cache.getData<char>();
+      for (unsigned int batch = 1; batch < batch_size; ++batch)
+        std::memcpy(data + batch * batch_bytes, data, rows_bytes);
+    };
+
+    copy_first_batch(cache_key);
+    copy_first_batch(cache_value);
+    if (kv_cache_bits) {
+      copy_first_batch(cache_key_scale);
+      copy_first_batch(cache_value_scale);
     }
   }
 }
 
+void MHACoreLayer::tiled_decoding_forwarding(
+  nntrainer::RunLayerContext &context, const unsigned int _from,
+  const unsigned int cache_from, const unsigned int from,
+  const unsigned int to) {
+  auto &pool = nntrainer::ThreadRuntime::Global();
+
+  nntrainer::Tensor &query = context.getInput(INOUT_INDEX::QUERY);
+  nntrainer::Tensor &key = context.getInput(INOUT_INDEX::KEY);
+  nntrainer::Tensor &value = context.getInput(INOUT_INDEX::VALUE);
+  nntrainer::Tensor &output = context.getOutput(INOUT_INDEX::OUTPUT);
+  nntrainer::Tensor &cache_key =
+    context.getTensor(tensor_idx[AttentionParams::cache_key]);
+  nntrainer::Tensor &cache_value =
+    context.getTensor(tensor_idx[AttentionParams::cache_value]);
+  nntrainer::Tensor &score =
+    context.getTensor(tensor_idx[AttentionParams::attention_score]);
+
+  const unsigned int batch_size = query.batch();
+  const unsigned int num_tiles = batch_size * num_heads_KV;
+  const int gqa_size = num_heads_Q / num_heads_KV;
+  const unsigned int kv_width = num_heads_KV * head_dim;
+  const size_t query_len = query.getDim().getFeatureLen();
+  const size_t key_len = key.getDim().getFeatureLen();
+  const size_t value_len = value.getDim().getFeatureLen();
+  const size_t output_len = output.getDim().getFeatureLen();
+  const size_t cache_len = cache_key.getDim().getFeatureLen();
+  const size_t cache_width = cache_key.width();
+  const size_t score_len = score.getDim().getFeatureLen();
+
+  uint16_t *cache_key_scale = nullptr, *cache_value_scale = nullptr;
+  size_t scale_len = 0, scale_width = 0;
+  if (kv_cache_bits) {
+    nntrainer::Tensor &key_scale =
+      context.getTensor(tensor_idx[AttentionParams::cache_key_scale]);
+    cache_key_scale = key_scale.getData<uint16_t>();
+    cache_value_scale =
+      context.getTensor(tensor_idx[AttentionParams::cache_value_scale])
+        .getData<uint16_t>();
+    scale_len = key_scale.getDim().getFeatureLen();
+    scale_width = key_scale.width();
+  }
+
+  /** 1. rotate the query and store the key and value of the step */
+  ml::train::TensorDim query_row_dim = query.getDim();
+  ml::train::TensorDim kv_row_dim = key.getDim();
+  ml::train::TensorDim cache_row_dim = cache_key.getDim();
+  query_row_dim.batch(1);
+  query_row_dim.height(1);
+  kv_row_dim.batch(1);
+  kv_row_dim.height(1);
+  cache_row_dim.batch(1);
+  cache_row_dim.height(1);
+
+  pool.parallel_for(0, batch_size, [&](unsigned int b) {
+    nntrainer::Tensor query_step =
+      query.getSharedDataTensor(query_row_dim, b * query_len, true);
+    nntrainer::Tensor key_step =
+      key.getSharedDataTensor(kv_row_dim, b * key_len, true);
+    nntrainer::Tensor value_step =
+      value.getSharedDataTensor(kv_row_dim, b * value_len, true);
+    const size_t cache_row = b * cache_len + cache_from * cache_width;
+
+    apply_rotary_emb_tensor_v2(query_step, query_step, head_dim, _from, false);
+    if (kv_cache_bits) {
+      const size_t scale_row = b * scale_len + cache_from * scale_width;
+      /** rotate a scratch copy of the key, the layer input stays intact */
+      nntrainer::ScratchArena::Scope scope;
+      nntrainer::Tensor rotated_key =
+        nntrainer::ScratchArena::threadLocal().getTensor(kv_row_dim);
+      rotated_key.copyData(key_step);
+      apply_rotary_emb_tensor_v2(rotated_key, rotated_key, head_dim, _from,
+                                 false);
+      nntrainer::quantize_kv_cache(
+        kv_width, rotated_key.getData<float>(),
+        cache_key.getData<uint8_t>() + cache_row, cache_key_scale + scale_row,
+        kv_cache_bits);
+      nntrainer::quantize_kv_cache(
+        kv_width, value_step.getData<float>(),
+        cache_value.getData<uint8_t>() + cache_row,
+        cache_value_scale + scale_row, kv_cache_bits);
+    } else {
+      nntrainer::Tensor cache_key_step =
+        cache_key.getSharedDataTensor(cache_row_dim, cache_row, true);
+      nntrainer::Tensor cache_value_step =
+        cache_value.getSharedDataTensor(cache_row_dim, cache_row, true);
+      apply_rotary_emb_tensor_v2(key_step, cache_key_step, head_dim, _from,
+                                 false);
+      apply_rotary_emb_tensor_v2(value_step, cache_value_step, head_dim, _from,
+                                 true);
+    }
+  });
+
+  /** 2. scores of the query heads of each (batch, kv head) tile */
+  pool.parallel_for(0, num_tiles, [&](unsigned int tile) {
+    const unsigned int b = tile / num_heads_KV;
+    const int n = tile % num_heads_KV;
+    const float *in = query.getData<float>() + b * query_len;
+    float *out = score.getData<float>() + b * score_len;
+    if (kv_cache_bits)
+      nntrainer::compute_kcaches_quantized(
+        in, cache_key.getData<uint8_t>() + b * cache_len,
+        cache_key_scale + b * scale_len, out, to, num_heads_KV, head_dim,
+        gqa_size, kv_cache_bits, local_window_size, n, n + 1);
+    else
+      nntrainer::compute_kcaches<uint16_t>(
+        in, cache_key.getData<uint16_t>() + b * cache_len, out, to,
+        num_heads_KV, head_dim, gqa_size, 8, local_window_size, n, n + 1);
+  });
+
+  /** 3. softmax over the cached rows of each batch */
+  const size_t end_row =
+    from < local_window_size ? from + 1 : local_window_size;
+  float *sink =
+    use_sink ? context.getWeight(sink_idx).getData<float>() : nullptr;
+  pool.parallel_for(0, batch_size, [&](unsigned int b) {
+    nntrainer::softmax_row_inplace(score.getData<float>() + b * score_len,
+                                   0, end_row, num_heads_Q, sink);
+  });
+
+  /** 4. weighted sum of the values of each (batch, kv head) tile */
+  pool.parallel_for(0, num_tiles, [&](unsigned int tile) {
+    const unsigned int b = tile / num_heads_KV;
+    const int n = tile % num_heads_KV;
+    const float *in = score.getData<float>() + b * score_len;
+    float *out = output.getData<float>() + b * output_len;
+    if (kv_cache_bits)
+      nntrainer::compute_vcache_quantized_transposed(
+        to - 1, in, cache_value.getData<uint8_t>() + b * cache_len,
+        cache_value_scale + b * scale_len, out, num_heads_KV, gqa_size,
+        head_dim, kv_cache_bits, local_window_size, n, n + 1);
+    else
+      nntrainer::compute_fp16vcache_fp32_transposed(
+        to - 1, in, cache_value.getData<uint16_t>() + b * cache_len, out,
+        num_heads_KV, gqa_size, head_dim, local_window_size, n, n + 1);
+  });
+}
+
 void MHACoreLayer::compute_kcaches(
   nntrainer::Tensor &in, nntrainer::Tensor &cache, nntrainer::Tensor &out,
   unsigned int from, size_t sequence_len, unsigned int num_head,
-  unsigned int group_size, unsigned int head_dim, BS::thread_pool<> &pool) {
+  unsigned int group_size, unsigned int head_dim,
+  nntrainer::ThreadRuntime &pool) {
 
   int tile_size = 8;
 
@@ -373,10 +713,8 @@ void MHACoreLayer::compute_kcaches(
         local_window_size);
     } else {
       std::vector<std::future<void>> futures;
-      int seq =
-        sequence_len < local_window_size ? sequence_len : local_window_size;
 
-      for (int i = 0; i < seq; ++i) {
+      for (int i = 0; i < sequence_len; ++i) {
         float *input_addr = in.getData<float>() + num_head * head_dim * i;
         uint16_t *cache_addr = cache.getData<uint16_t>();
         int row_to_compute = from + i + 1;
@@ -384,7 +722,7 @@ void MHACoreLayer::compute_kcaches(
           calc_attn_index(from + i) - calc_attn_index(from);
         float *output_addr = out.getData<float>() + out_start_row * num_head;
 
-        futures.emplace_back(pool.submit_task([=]() {
+        futures.emplace_back(pool.submit([=]() {
           nntrainer::compute_kcaches<uint16_t>(
             input_addr, cache_addr, output_addr, row_to_compute,
             num_head / group_size, head_dim, group_size, tile_size,
@@ -408,7 +746,7 @@ void MHACoreLayer::compute_kcaches(
         const __fp16 *cache_ptr = cache.getData<_FP16>() + n * head_dim;
         __fp16 *out_ptr = out.getData<_FP16>() + n * group_size;
         for (int tile_off = 0; tile_off < tile_count; ++tile_off) {
-          futures.emplace_back(pool.submit_task([=]() {
+          futures.emplace_back(pool.submit([=]() {
             nntrainer::compute_kcaches(in_ptr, cache_ptr, out_ptr, num_rows,
                                        num_cache_head, head_dim, group_size,
                                        tile_off, tile_size, local_window_size);
@@ -419,9 +757,7 @@ void MHACoreLayer::compute_kcaches(
         fut.get();
     } else {
       std::vector<std::future<void>> futures;
-      unsigned int seq_start =
-        sequence_len < local_window_size ? 0 : sequence_len - local_window_size;
-      for (unsigned int i = seq_start; i < sequence_len; ++i) {
+      for (unsigned int i = 0; i < sequence_len; ++i) {
         _FP16 *input_addr = in.getData<_FP16>() + num_head * head_dim * i;
         _FP16 *cache_addr = cache.getData<_FP16>();
         int row_to_compute = from + i + 1;
@@ -430,7 +766,7 @@ void MHACoreLayer::compute_kcaches(
 
         _FP16 *output_addr = out.getData<_FP16>() + out_start_row * num_head;
 
-        futures.emplace_back(pool.submit_task([=]() {
+        futures.emplace_back(pool.submit([=]() {
           int num_rows = row_to_compute;
           int row_cnt =
             num_rows < local_window_size ? num_rows : local_window_size;
@@ -457,8 +793,9 @@ void MHACoreLayer::compute_kcaches(
 }
 
 void MHACoreLayer::one_batch_incremental_forwarding(
-  const unsigned int batch, const unsigned int _from, const unsigned int from,
-  const unsigned int to, nntrainer::Tensor &query_step,
+  const unsigned int batch, const unsigned int _from,
+  const unsigned int cache_from, const unsigned int from, const unsigned int to,
+  nntrainer::Tensor &query_step,
   nntrainer::Tensor &key_step, nntrainer::Tensor &value_step,
   nntrainer::Tensor &attention_output_step, nntrainer::Tensor &cache_key,
   nntrainer::Tensor &cache_value, ml::train::TensorDim &cache_key_dim,
@@ -480,14 +817,16 @@ void MHACoreLayer::one_batch_incremental_forwarding(
 
   /** 1. Load Input Tensors of this batch : b_ denotes a Tensor for this batch
    * **/
-  auto &pool = nntrainer::ThreadPoolManager::Global().getThreadPool();
+  auto &pool = nntrainer::ThreadRuntime::Global();
 
   nntrainer::Tensor b_cache_key_step = cache_key.getSharedDataTensor(
     cache_key_step_dim,
-    batch * cache_key_dim.getFeatureLen() + from * cache_key_dim.width(), true);
+    batch * cache_key_dim.getFeatureLen() + cache_from * cache_key_dim.width(),
+    true);
   nntrainer::Tensor b_cache_value_step = cache_value.getSharedDataTensor(
     cache_value_step_dim,
-    batch * cache_value_dim.getFeatureLen() + from * cache_value_dim.width(),
+    batch * cache_value_dim.getFeatureLen() +
+      cache_from * cache_value_dim.width(),
     true);
 
   apply_rotary_emb_tensor_v2(query_step, query_step, head_dim, _from, false);
@@ -522,7 +861,7 @@ void MHACoreLayer::one_batch_incremental_forwarding(
 
   unsigned int gqa_size = num_heads_Q / num_heads_KV;
 
-  compute_kcaches(query_step, b_cached_key, out_, _from, to - from, num_heads_Q,
+  compute_kcaches(query_step, b_cached_key, out_, from, to - from, num_heads_Q,
                   gqa_size, head_dim, pool);
 
   softmax_triangle(out_, to - from, num_heads_Q, from, pool);
@@ -533,8 +872,9 @@ void MHACoreLayer::one_batch_incremental_forwarding(
 }
 
 void MHACoreLayer::one_batch_incremental_forwarding(
-  const unsigned int batch, const unsigned int _from, const unsigned int from,
-  const unsigned int to, nntrainer::Tensor &query_step,
+  const unsigned int batch, const unsigned int _from,
+  const unsigned int cache_from, const unsigned int from, const unsigned int to,
+  nntrainer::Tensor &query_step,
   nntrainer::Tensor &key_step, nntrainer::Tensor &value_step,
   nntrainer::Tensor &attention_output_step, nntrainer::Tensor &cache_key,
   nntrainer::Tensor &cache_value, ml::train::TensorDim &cache_key_dim,
@@ -556,14 +896,16 @@ void MHACoreLayer::one_batch_incremental_forwarding(
 
   /** 1. Load Input Tensors of this batch : b_ denotes a Tensor for this batch
    * **/
-  auto &pool = nntrainer::ThreadPoolManager::Global().getThreadPool();
+  auto &pool = nntrainer::ThreadRuntime::Global();
 
   nntrainer::Tensor b_cache_key_step = cache_key.getSharedDataTensor(
     cache_key_step_dim,
-    batch * cache_key_dim.getFeatureLen() + from * cache_key_dim.width(), true);
+    batch * cache_key_dim.getFeatureLen() + cache_from * cache_key_dim.width(),
+    true);
   nntrainer::Tensor b_cache_value_step = cache_value.getSharedDataTensor(
     cache_value_step_dim,
-    batch * cache_value_dim.getFeatureLen() + from * cache_value_dim.width(),
+    batch * cache_value_dim.getFeatureLen() +
+      cache_from * cache_value_dim.width(),
     true);
 
   apply_rotary_emb_tensor_v2(query_step, query_step, head_dim, _from, false);
@@ -598,7 +940,7 @@ void MHACoreLayer::one_batch_incremental_forwarding(
 
   unsigned int gqa_size = num_heads_Q / num_heads_KV;
 
-  compute_kcaches(query_step, b_cached_key, out_, _from, to - from, num_heads_Q,
+  compute_kcaches(query_step, b_cached_key, out_, from, to - from, num_heads_Q,
                   gqa_size, head_dim, pool);
 
   softmax_triangle(out_, to - from, num_heads_Q, from, pool, sink_step);
@@ -608,6 +950,112 @@ void MHACoreLayer::one_batch_incremental_forwarding(
                                 pool);
 }
 
+void MHACoreLayer::one_batch_quantized_incremental_forwarding(
+  const unsigned int batch, const unsigned int _from,
+  const unsigned int cache_from, const unsigned int from, const unsigned int to,
+  nntrainer::Tensor &query_step, nntrainer::Tensor &key_step,
+  nntrainer::Tensor &value_step, nntrainer::Tensor &attention_output_step,
+  nntrainer::Tensor &cache_key, nntrainer::Tensor &cache_value,
+  nntrainer::Tensor &cache_key_scale, nntrainer::Tensor &cache_value_scale,
+  nntrainer::Tensor *sink_step) {
+  auto &pool = nntrainer::ThreadRuntime::Global();
+
+  const unsigned int seq_len = to - from;
+  const unsigned int kv_width = num_heads_KV * head_dim;
+  const size_t row_bytes = kv_width * kv_cache_bits / 8;
+  const size_t row_scales = kv_width / 32;
+
+  uint8_t *b_cache_key =
+    cache_key.getData<uint8_t>() + batch * cache_key.getDim().getFeatureLen();
+  uint8_t *b_cache_value = cache_value.getData<uint8_t>() +
+                           batch * cache_value.getDim().getFeatureLen();
+  uint16_t *b_cache_key_scale =
+    cache_key_scale.getData<uint16_t>() +
+    batch * cache_key_scale.getDim().getFeatureLen();
+  uint16_t *b_cache_value_scale =
+    cache_value_scale.getData<uint16_t>() +
+    batch * cache_value_scale.getDim().getFeatureLen();
+
+  /**
+   * 1. rotate query and key, then quantize key and value into the cache. The
+   * key is rotated on a scratch copy, the layer input stays intact.
+   */
+  apply_rotary_emb_tensor_v2(query_step, query_step, head_dim, _from, false);
+  nntrainer::ScratchArena::Scope scope;
+  nntrainer::Tensor rotated_key =
+    nntrainer::ScratchArena::threadLocal().getTensor(key_step.getDim());
+  rotated_key.copyData(key_step);
+  apply_rotary_emb_tensor_v2(rotated_key, rotated_key, head_dim, _from, false);
+
+  for (unsigned int i = 0; i < seq_len; ++i) {
+    const size_t row = cache_from + i;
+    nntrainer::quantize_kv_cache(
+      kv_width, rotated_key.getData<float>() + i * kv_width,
+      b_cache_key + row * row_bytes, b_cache_key_scale + row * row_scales,
+      kv_cache_bits);
+    nntrainer::quantize_kv_cache(
+      kv_width, value_step.getData<float>() + i * kv_width,
+      b_cache_value + row * row_bytes, b_cache_value_scale + row * row_scales,
+      kv_cache_bits);
+  }
+
+  nntrainer::Tensor out_(
+    1, 1, (seq_len == 1) ? to : calc_attn_index(to) - calc_attn_index(from),
+    num_heads_Q, query_step.getTensorType());
+
+  const unsigned int gqa_size = num_heads_Q / num_heads_KV;
+  const float *query = query_step.getData<float>();
+  float *qk = out_.getData<float>();
+
+  /** 2. attention scores against the dequantized keys */
+  if (seq_len == 1) {
+    nntrainer::compute_kcaches_quantized(
+      query, b_cache_key, b_cache_key_scale, qk, from + 1, num_heads_KV,
+      head_dim, gqa_size, kv_cache_bits, local_window_size);
+  } else {
+    std::vector<std::future<void>> futures;
+    for (unsigned int i = 0; i < seq_len; ++i) {
+      const float *input = query + num_heads_Q * head_dim * i;
+      float *output =
+        qk + (calc_attn_index(from + i) - calc_attn_index(from)) * num_heads_Q;
+      futures.push_back(pool.submit([=]() {
+        nntrainer::compute_kcaches_quantized(
+          input, b_cache_key, b_cache_key_scale, output, from + i + 1,
+          num_heads_KV, head_dim, gqa_size, kv_cache_bits, local_window_size);
+      }));
+    }
+    for (auto &fut : futures)
+      fut.get();
+  }
+
+  if (sink_step)
+    softmax_triangle(out_, seq_len, num_heads_Q, from, pool, *sink_step);
+  else
+    softmax_triangle(out_, seq_len, num_heads_Q, from, pool);
+
+  /** 3. weighted sum of the dequantized values */
+  float *output = attention_output_step.getData<float>();
+  if (seq_len == 1) {
+    nntrainer::compute_vcache_quantized_transposed(
+      to - 1, qk, b_cache_value, b_cache_value_scale, output, num_heads_KV,
+      gqa_size, head_dim, kv_cache_bits, local_window_size);
+  } else {
+    std::vector<std::future<void>> futures;
+    for (unsigned int i = 0; i < seq_len; ++i) {
+      const float *input =
+        qk + (calc_attn_index(from + i) - calc_attn_index(from)) * num_heads_Q;
+      float *out = output + i * num_heads_Q * head_dim;
+      futures.push_back(pool.submit([=]() {
+        nntrainer::compute_vcache_quantized_transposed(
+          from + i, input, b_cache_value, b_cache_value_scale, out,
+          num_heads_KV, gqa_size, head_dim, kv_cache_bits, local_window_size);
+      }));
+    }
+    for (auto &fut : futures)
+      fut.get();
+  }
+}
+
 /************************************************************** */
 
 /**
@@ -787,8 +1235,6 @@ void MHACoreLayer::apply_rotary_emb_tensor_v2(nntrainer::Tensor &in,
                                               unsigned int from,
                                               bool convert_only) {
   unsigned int half_ = dim / 2;
-  unsigned int max_timestep =
-    std::get<nntrainer::props::MaxTimestep>(mha_core_props).get();
 
   if (in.getDataType() == ml::train::TensorDim::DataType::FP32) {
     std::vector<float> *cos_ = nullptr;
@@ -797,7 +1243,7 @@ void MHACoreLayer::apply_rotary_emb_tensor_v2(nntrainer::Tensor &in,
     for (unsigned int b = 0; b < in.batch(); b++) {
       for (unsigned int c = 0; c < in.channel(); c++) {
         for (unsigned int h = 0; h < in.height(); h++) {
-          if (from < max_timestep) {
+          if (from + h < freqs_cos->size()) {
             cos_ = &(*freqs_cos)[from + h];
             sin_ = &(*freqs_sin)[from + h];
           }
@@ -834,7 +1280,7 @@ void MHACoreLayer::apply_rotary_emb_tensor_v2(nntrainer::Tensor &in,
     for (unsigned int b = 0; b < in.batch(); b++) {
       for (unsigned int c = 0; c < in.channel(); c++) {
         for (unsigned int h = 0; h < in.height(); h++) {
-          if (from < max_timestep) {
+          if (from + h < freqs_cos_fp16->size()) {
             cos_ = &(*freqs_cos_fp16)[from + h];
             sin_ = &(*freqs_sin_fp16)[from + h];
           }
@@ -859,7 +1305,7 @@ void MHACoreLayer::apply_rotary_emb_tensor_v2(nntrainer::Tensor &in,
 
 void MHACoreLayer::softmax_triangle(nntrainer::Tensor &qk_out, size_t row,
                                     size_t num_head, unsigned int from,
-                                    BS::thread_pool<> &pool) {
+                                    nntrainer::ThreadRuntime &pool) {
   if (qk_out.getDataType() == ml::train::TensorDim::DataType::FP32) {
     float *qk_out_ = qk_out.getData<float>();
 
@@ -869,12 +1315,11 @@ void MHACoreLayer::softmax_triangle(nntrainer::Tensor &qk_out, size_t row,
       nntrainer::softmax_row_inplace(qk_out_, start_row, end_row, num_head);
     } else {
       std::vector<std::future<void>> futures;
-      int seq = row < local_window_size ? row : local_window_size;
-
-      for (int i = 0; i < seq; ++i) {
+      for (int i = 0; i < row; ++i) {
         size_t start_row = calc_attn_index(from + i) - calc_attn_index(from);
-        size_t end_row = calc_attn_index(from + i + 1) - calc_attn_index(from);
-        futures.push_back(pool.submit_task([=]() {
+        size_t end_row =
+          start_row + std::min<size_t>(from + i + 1, local_window_size);
+        futures.push_back(pool.submit([=]() {
           nntrainer::softmax_row(qk_out_, start_row, end_row, num_head);
         }));
       }
@@ -892,11 +1337,11 @@ void MHACoreLayer::softmax_triangle(nntrainer::Tensor &qk_out, size_t row,
       nntrainer::softmax_row_inplace(qk_out_, start_row, end_row, num_head);
     } else {
       std::vector<std::future<void>> futures;
-      int seq = row < local_window_size ? row : local_window_size;
-      for (int i = 0; i < seq; ++i) {
+      for (int i = 0; i < row; ++i) {
         size_t start_row = calc_attn_index(from + i) - calc_attn_index(from);
-        size_t end_row = calc_attn_index(from + i + 1) - calc_attn_index(from);
-        futures.push_back(pool.submit_task([=]() {
+        size_t end_row =
+          start_row + std::min<size_t>(from + i + 1, local_window_size);
+        futures.push_back(pool.submit([=]() {
           nntrainer::softmax_row_inplace(qk_out_, start_row, end_row, num_head);
         }));
       }
@@ -912,7 +1357,7 @@ void MHACoreLayer::softmax_triangle(nntrainer::Tensor &qk_out, size_t row,
 
 void MHACoreLayer::softmax_triangle(nntrainer::Tensor &qk_out, size_t row,
                                     size_t num_head, unsigned int from,
-                                    BS::thread_pool<> &pool,
+                                    nntrainer::ThreadRuntime &pool,
                                     nntrainer::Tensor &sink_step) {
   if (qk_out.getDataType() == ml::train::TensorDim::DataType::FP32) {
     float *qk_out_ = qk_out.getData<float>();
@@ -924,12 +1369,11 @@ void MHACoreLayer::softmax_triangle(nntrainer::Tensor &qk_out, size_t row,
                                      sink_step.getData());
     } else {
       std::vector<std::future<void>> futures;
-      int min_row = row < local_window_size ? 0 : row - local_window_size;
-      // for (int i = row - 1; i >= min_row; --i) {
       for (int i = 0; i < row; ++i) {
         size_t start_row = calc_attn_index(i + from) - calc_attn_index(from);
-        size_t end_row = calc_attn_index(from + i + 1) - calc_attn_index(from);
-        futures.push_back(pool.submit_task([=]() {
+        size_t end_row =
+          start_row + std::min<size_t>(from + i + 1, local_window_size);
+        futures.push_back(pool.submit([=]() {
           nntrainer::softmax_row(qk_out_, start_row, end_row, num_head,
                                  sink_step.getData());
         }));
@@ -950,12 +1394,11 @@ void MHACoreLayer::softmax_triangle(nntrainer::Tensor &qk_out, size_t row,
                                      sink_step_);
     } else {
       std::vector<std::future<void>> futures;
-      int min_row = row < local_window_size ? 0 : row - local_window_size;
-      // for (int i = row - 1; i >= min_row; --i) {
       for (int i = 0; i < row; ++i) {
         size_t start_row = calc_attn_index(i + from) - calc_attn_index(from);
-        size_t end_row = calc_attn_index(from + i + 1) - calc_attn_index(from);
-        futures.push_back(pool.submit_task([=]() {
+        size_t end_row =
+          start_row + std::min<size_t>(from + i + 1, local_window_size);
+        futures.push_back(pool.submit([=]() {
           nntrainer::softmax_row_inplace(qk_out_, start_row, end_row, num_head,
                                          sink_step_);
         }));
@@ -973,25 +1416,24 @@ void MHACoreLayer::softmax_triangle(nntrainer::Tensor &qk_out, size_t row,
 void MHACoreLayer::compute_fp16vcache_transposed(
   nntrainer::Tensor &in, nntrainer::Tensor &vcache, nntrainer::Tensor &output,
   int from, int num_cache_head, int gqa_size, int head_dim, int to,
-  BS::thread_pool<> &pool) {
+  nntrainer::ThreadRuntime &pool) {
 
   if (in.getDataType() == ml::train::TensorDim::DataType::FP32) {
     if ((to - from) != 1) {
       std::vector<std::future<void>> futures;
 
-      int seq = (to - from) < local_window_size ? to - from : local_window_size;
+      int seq = to - from;
       futures.reserve(seq);
 
       for (int i = 0; i < seq; ++i) {
-        futures.push_back(pool.submit_task([=]() {
-          size_t start_idx =
-            calc_attn_index(to - seq + i) - calc_attn_index(to - seq);
+        futures.push_back(pool.submit([=]() {
+          size_t start_idx = calc_attn_index(from + i) - calc_attn_index(from);
           const float *input =
             in.getData<float>() + start_idx * num_cache_head * gqa_size;
           float *out = output.getData<float>() +
                        i * (num_cache_head * gqa_size * head_dim);
           nntrainer::compute_fp16vcache_fp32_transposed(
-            to - seq + i, input, vcache.getData<uint16_t>(), out,
+            from + i, input, vcache.getData<uint16_t>(), out,
             num_cache_head, gqa_size, head_dim, local_window_size);
         }));
       }
@@ -1007,13 +1449,12 @@ void MHACoreLayer::compute_fp16vcache_transposed(
 #ifdef ENABLE_FP16
     if ((to - from) != 1) {
       std::vector<std::future<void>> futures;
-      int seq = (to - from) < local_window_size ? to - from : local_window_size;
+      int seq = to - from;
       futures.reserve(seq);
 
       for (int i = 0; i < seq; ++i) {
-        futures.push_back(pool.submit_task([=]() {
-          size_t start_idx =
-            calc_attn_index(to - seq + i) - calc_attn_index(to - seq);
+        futures.push_back(pool.submit([=]() {
+          size_t start_idx = calc_attn_index(from + i) - calc_attn_index(from);
           const _FP16 *input =
             in.getData<_FP16>() + start_idx * num_cache_head * gqa_size;
           _FP16 *out = output.getData<_FP16>() +
@@ -1024,7 +1465,7 @@ void MHACoreLayer::compute_fp16vcache_transposed(
             const _FP16 *vcache_ptr = vcache.getData<_FP16>() + n * head_dim;
             _FP16 *out_ptr = out + n * gqa_size * head_dim;
             nntrainer::compute_fp16vcache_transposed(
-              to - seq + i, in_ptr, vcache_ptr, out_ptr, num_cache_head,
+              from + i, in_ptr, vcache_ptr, out_ptr, num_cache_head,
               gqa_size, head_dim, chunk_size, local_window_size);
           }
         }));
@@ -1041,7 +1482,7 @@ void MHACoreLayer::compute_fp16vcache_transposed(
             vcache.getData<_FP16>() + n * head_dim + chunk_off;
           _FP16 *out_ptr =
             output.getData<_FP16>() + n * gqa_size * head_dim + chunk_off;
-          futures.emplace_back(pool.submit_task([=]() {
+          futures.emplace_back(pool.submit([=]() {
             int chunk_size = std::min(CHUNK_SIZE, head_dim - chunk_off);
             nntrainer::compute_fp16vcache_transposed(
               to - 1, in_ptr, vcache_ptr, out_ptr, num_cache_head, gqa_size,
@@ -1065,6 +1506,12 @@ void MHACoreLayer::setBatch(nntrainer::RunLayerContext &context,
     std::get<nntrainer::props::DropOutRate>(mha_core_props).get();
   context.updateTensor(tensor_idx[AttentionParams::cache_key], batch);
   context.updateTensor(tensor_idx[AttentionParams::cache_value], batch);
+  if (kv_cache_bits) {
+    context.updateTensor(tensor_idx[AttentionParams::cache_key_scale], batch);
+    context.updateTensor(tensor_idx[AttentionParams::cache_value_scale], batch);
+  }
+  if (tiled_decoding)
+    context.updateTensor(tensor_idx[AttentionParams::attention_score], batch);
   // context.updateTensor(tensor_idx[AttentionParams::attention_weight], batch);
   if (dropout_rate > epsilon) {
     context.updateTensor(tensor_idx[AttentionParams::dropout_mask], batch);
@@ -1082,17 +1529,28 @@ void MHACoreLayer::updateTensorsByInputDimensions(
   unsigned int &max_position_embeddings =
     std::get<props::MaxPositionEmbeddings>(mha_core_props).get();
   max_timestep = height + max_new_tokens;
+  const unsigned int cache_len =
+    std::min<size_t>(max_timestep, local_window_size);
 
   ml::train::TensorDim kv_dim = input_dimensions[0];
   kv_dim.width(kv_dim.width() / (num_heads_Q / num_heads_KV));
 
   ml::train::TensorDim kv_cache_dim = kv_dim;
+  ml::train::TensorDim kv_cache_scale_dim = kv_dim;
+  if (kv_cache_bits) {
+    kv_cache_dim.setDataType(ml::train::TensorDim::DataType::UINT8);
+    kv_cache_dim.width(kv_dim.width() * kv_cache_bits / 8);
+    kv_cache_scale_dim.setDataType(ml::train::TensorDim::DataType::UINT16);
+    kv_cache_scale_dim.width(kv_dim.width() / 32);
+    kv_cache_scale_dim.height(cache_len);
+  } else {
 #ifdef ENABLE_FP16
-  kv_cache_dim.setDataType(ml::train::TensorDim::DataType::FP16);
+    kv_cache_dim.setDataType(ml::train::TensorDim::DataType::FP16);
 #else
-  kv_cache_dim.setDataType(ml::train::TensorDim::DataType::UINT16);
+    kv_cache_dim.setDataType(ml::train::TensorDim::DataType::UINT16);
 #endif
-  kv_cache_dim.height(max_timestep);
+  }
+  kv_cache_dim.height(cache_len);
 
   precompute_freqs(head_dim, max_position_embeddings, theta);
 
@@ -1103,6 +1561,40 @@ void MHACoreLayer::updateTensorsByInputDimensions(
 
   context.updateTensor(tensor_idx[AttentionParams::cache_key], kv_cache_dim);
   context.updateTensor(tensor_idx[AttentionParams::cache_value], kv_cache_dim);
+  if (kv_cache_bits) {
+    context.updateTensor(tensor_idx[AttentionParams::cache_key_scale],
+                         kv_cache_scale_dim);
+    context.updateTensor(tensor_idx[AttentionParams::cache_value_scale],
+                         kv_cache_scale_dim);
+  }
+
+  if (tiled_decoding) {
+    ml::train::TensorDim score_dim(
+      {input_dimensions[0].batch(), 1, cache_len,
+       static_cast<unsigned int>(num_heads_Q)},
+      {input_dimensions[0].getFormat(), ml::train::TensorDim::DataType::FP32});
+    context.updateTensor(tensor_idx[AttentionParams::attention_score],
+                         score_dim);
+  }
+#if ENABLE_FP16 && defined(__ANDROID__)
+  if (tensor_idx[AttentionParams::fp16_query_step] !=
+      std::numeric_limits<unsigned>::max()) {
+    ml::train::TensorDim query_step_dim = input_dimensions[0];
+    query_step_dim.batch(1);
+    query_step_dim.setDataType(ml::train::TensorDim::DataType::FP16);
+    ml::train::TensorDim kv_step_dim = kv_dim;
+    kv_step_dim.batch(1);
+    kv_step_dim.setDataType(ml::train::TensorDim::DataType::FP16);
+    context.updateTensor(tensor_idx[AttentionParams::fp16_query_step],
+                         query_step_dim);
+    context.updateTensor(tensor_idx[AttentionParams::fp16_key_step],
+                         kv_step_dim);
+    context.updateTensor(tensor_idx[AttentionParams::fp16_value_step],
+                         kv_step_dim);
+    context.updateTensor(tensor_idx[AttentionParams::fp16_output_step],
+                         query_step_dim);
+  }
+#endif
 }
 
 void MHACoreLayer::calcDerivative(nntrainer::RunLayerContext &context) {}
@@ -1120,6 +1612,23 @@ void MHACoreLayer::setProperty(const std::vector<std::string> &values) {
   LayerImpl::setProperty(remain_props);
 }
 
+std::vector<unsigned int>
+MHACoreLayer::getCacheTensorIdx(const nntrainer::RunLayerContext &context) {
+  const std::array<std::string, 4> cache_names = {
+    ":cache_key", ":cache_value", ":cache_key_scale", ":cache_value_scale"};
+  std::vector<unsigned int> idx;
+  for (const std::string &cache_name : cache_names) {
+    for (unsigned int i = 0; i < context.getNumTensors(); ++i) {
+      const std::string &name = context.getTensorName(i);
+      if (name.size() >= cache_name.size() &&
+          name.compare(name.size() - cache_name.size(), cache_name.size(),
+                       cache_name) == 0)
+        idx.push_back(i);
+    }
+  }
+  return idx;
+}
+
 size_t MHACoreLayer::calc_attn_index(size_t i) { return (i * (i + 1)) / 2; };
 
 #ifdef PLUGGABLE
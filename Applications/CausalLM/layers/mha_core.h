@@ -34,11 +34,11 @@
 #include <complex>
 
 #include <acti_func.h>
-#include <bs_thread_pool_manager.hpp>
 #include <common_properties.h>
 #include <cpu_backend.h>
 #include <layer_impl.h>
 #include <limits.h>
+#include <thread_runtime.h>
 #include <util_simd.h>
 
 #include <utility>
@@ -150,6 +150,20 @@ public:
   using prop_tag = nntrainer::uint_prop_tag; /**< property type */
 };
 
+/**
+ * @brief KVCacheType
+ * - fp16 : keys and values are cached in fp16
+ * - int8 : int8 with one fp16 scale per block of 32 values
+ * - int4 : int4 with one fp16 scale per block of 32 values
+ */
+class KVCacheType : public nntrainer::Property<std::string> {
+public:
+  KVCacheType(std::string value = "fp16") { set(value); };
+  static constexpr const char *key =
+    "kv_cache_type";                        /**< unique key to access */
+  using prop_tag = nntrainer::str_prop_tag; /**< property type */
+};
+
 }; // namespace props
 
 /**
@@ -204,7 +218,8 @@ public:
                              bool training) override;
 
   void one_batch_incremental_forwarding(
-    const unsigned int batch, const unsigned int _from, const unsigned int from,
+    const unsigned int batch, const unsigned int _from,
+    const unsigned int cache_from, const unsigned int from,
     const unsigned int to, nntrainer::Tensor &query_step,
     nntrainer::Tensor &key_step, nntrainer::Tensor &value_step,
     nntrainer::Tensor &attention_output_step, nntrainer::Tensor &cache_key,
@@ -214,7 +229,8 @@ public:
     ml::train::TensorDim &cache_value_step_dim);
 
   void one_batch_incremental_forwarding(
-    const unsigned int batch, const unsigned int _from, const unsigned int from,
+    const unsigned int batch, const unsigned int _from,
+    const unsigned int cache_from, const unsigned int from,
     const unsigned int to, nntrainer::Tensor &query_step,
     nntrainer::Tensor &key_step, nntrainer::Tensor &value_step,
     nntrainer::Tensor &attention_output_step, nntrainer::Tensor &cache_key,
@@ -222,6 +238,38 @@ public:
     ml::train::TensorDim &cache_key_step_dim,
     ml::train::TensorDim &cache_value_dim,
     ml::train::TensorDim &cache_value_step_dim, nntrainer::Tensor &sink_step);
+
+  /**
+   * @brief incremental forwarding of one batch with the int8 / int4 KV cache.
+   * Keys and values of the step are quantized into the cache and the
+   * attention dequantizes the cache inside the kernels.
+   * @param cache_from cache row where the keys and values of the step go
+   * @param sink_step sink weight, nullptr if not used
+   */
+  void one_batch_quantized_incremental_forwarding(
+    const unsigned int batch, const unsigned int _from,
+    const unsigned int cache_from, const unsigned int from,
+    const unsigned int to, nntrainer::Tensor &query_step,
+    nntrainer::Tensor &key_step, nntrainer::Tensor &value_step,
+    nntrainer::Tensor &attention_output_step, nntrainer::Tensor &cache_key,
+    nntrainer::Tensor &cache_value, nntrainer::Tensor &cache_key_scale,
+    nntrainer::Tensor &cache_value_scale, nntrainer::Tensor *sink_step);
+
+  /**
+   * @brief one decoding step of every batch with FP32 activations. After the
+   * keys and values of the step are stored, the attention is split into
+   * (batch, kv head) tiles on the thread pool, writing the scores into the
+   * attention_score scratch tensor of the layer.
+   * @param cache_from cache row where the keys and values of the step go
+   * @param from the row of the step among the cached rows
+   * @param to number of cached rows including the step
+   */
+  void tiled_decoding_forwarding(nntrainer::RunLayerContext &context,
+                                 const unsigned int _from,
+                                 const unsigned int cache_from,
+                                 const unsigned int from,
+                                 const unsigned int to);
+
   /**
    * @copydoc Layer::calcDerivative(RunLayerContext &context)
    */
@@ -275,6 +323,15 @@ public:
     nntrainer::RunLayerContext &context,
     std::vector<nntrainer::TensorDim> input_dimensions) override;
 
+  /**
+   * @brief indices of the key and value caches, followed by their scales when
+   * the cache is quantized
+   * @note the other tensors of the layer are scratch of the steps
+   * @param context run context of a mha_core layer
+   */
+  WIN_EXPORT static std::vector<unsigned int>
+  getCacheTensorIdx(const nntrainer::RunLayerContext &context);
+
   inline static const std::string type = "mha_core";
 
 private:
@@ -286,7 +343,8 @@ private:
     nntrainer::props::AverageAttentionWeight, nntrainer::props::MaxTimestep,
     props::SlidingWindow, props::MaxNewTokens, props::RopeTheta,
     props::MaxPositionEmbeddings, props::UseSink, props::RopeScalingType,
-    props::RopeScalingFactor, props::RopeScalingMaxPositionEmbeddings>
+    props::RopeScalingFactor, props::RopeScalingMaxPositionEmbeddings,
+    props::KVCacheType>
     mha_core_props; /**< mha_core layer properties */
 
   /** softmax activation operation */
@@ -303,6 +361,8 @@ private:
   float theta;
   size_t local_window_size;
   bool use_sink = false;
+  unsigned int kv_cache_bits = 0; /** 8 or 4 for quantized KV cache */
+  bool tiled_decoding = false;    /** decode on (batch, kv head) tiles */
 
   enum INOUT_INDEX {
     /** input index */
@@ -327,8 +387,15 @@ private:
     attention_weight,
     dropout_mask,
     attention_output,
+    cache_key_scale,
+    cache_value_scale,
+    attention_score,
+    fp16_query_step,
+    fp16_key_step,
+    fp16_value_step,
+    fp16_output_step,
   };
-  std::array<unsigned int, 7> tensor_idx;
+  std::array<unsigned int, 14> tensor_idx;
   unsigned int sink_idx;
 
   /** attention parameters */
@@ -393,13 +460,13 @@ private:
                        nntrainer::Tensor &out, unsigned int from,
                        size_t sequence_len, unsigned int num_heads,
                        unsigned int group_size, unsigned int head_dim,
-                       BS::thread_pool<> &pool);
+                       nntrainer::ThreadRuntime &pool);
 
   void softmax_triangle(nntrainer::Tensor &qk_out, size_t row, size_t num_heads,
-                        unsigned int from, BS::thread_pool<> &pool);
+                        unsigned int from, nntrainer::ThreadRuntime &pool);
 
   void softmax_triangle(nntrainer::Tensor &qk_out, size_t row, size_t num_heads,
-                        unsigned int from, BS::thread_pool<> &pool,
+                        unsigned int from, nntrainer::ThreadRuntime &pool,
                         nntrainer::Tensor &sink_step);
 
   void compute_vcaches(nntrainer::Tensor &in, nntrainer::Tensor &vcache,
@@ -412,7 +479,7 @@ private:
                                      nntrainer::Tensor &output, int from,
                                      int num_cache_head, int gqa_size,
                                      int head_dim, int to,
-                                     BS::thread_pool<> &pool);
+                                     nntrainer::ThreadRuntime &pool);
 
   /************** END OF  ROTARY EMBEDDING *************/
 
@@ -23,7 +23,6 @@
 
 #include <qkv_layer.h>
 
-#include <bs_thread_pool_manager.hpp>
 #include <layer_context.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
@@ -146,8 +145,6 @@ void QKVLayer::incremental_forwarding(nntrainer::RunLayerContext &context,
   input_step_dim.batch(1);
   input_step_dim.height(to - from);
 
-  auto &pool = nntrainer::ThreadPoolManager::Global().getThreadPool();
-
   nntrainer::Tensor input_step =
     input_.getSharedDataTensor(input_step_dim, 0, true);
 
@@ -47,10 +47,8 @@ void SwiGLULayer::incremental_forwarding(nntrainer::RunLayerContext &context,
   unsigned int _from = from;
 
   if (from) {
-    NNTR_THROW_IF(to - from != 1, std::invalid_argument)
-      << "incremental step size is not 1";
+    to = to - from;
     from = 0;
-    to = 1;
   }
 
   if (in1.getDataType() == ml::train::TensorDim::DataType::FP32) {
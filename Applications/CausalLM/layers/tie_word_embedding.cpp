@@ -11,6 +11,8 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
 #include <cpu_backend.h>
 #include <layer_context.h>
 #include <nntrainer_error.h>
@@ -25,6 +27,16 @@ namespace causallm {
 
 static constexpr size_t SINGLE_INOUT_IDX = 0;
 
+/** bytes of a Q6_K block holding 256 values */
+static constexpr size_t Q6_K_BLOCK_SIZE = 210;
+/** bytes of a Q8_K block holding 256 values (d, qs[256], bsums[16]) */
+static constexpr size_t Q8_K_BLOCK_SIZE =
+  sizeof(float) + 256 + 16 * sizeof(int16_t);
+/** k-means refinements of the vocabulary selection index */
+static constexpr unsigned int VOCAB_SELECTION_ITERATIONS = 2;
+/** lm head rows dequantized at once while building the index */
+static constexpr unsigned int VOCAB_SELECTION_CHUNK = 1024;
+
 enum TieWordEmbeddingParams {
   weight,
   bias,
@@ -32,10 +44,25 @@ enum TieWordEmbeddingParams {
   candidate_hidden_step
 };
 
+/**
+ * @brief tensors of the vocabulary selection index. Only a lm head with
+ * vocab_selection_clusters requests tensors, in this order, so these are also
+ * their indices in the run context.
+ */
+enum VocabSelectionParams {
+  vocab_centroids, /**< clusters x dim centroids */
+  vocab_radius,    /**< max distance of a row to its centroid */
+  vocab_offsets,   /**< start of each cluster in vocab_ids */
+  vocab_ids        /**< vocab ids grouped by cluster */
+};
+
 TieWordEmbedding::TieWordEmbedding() :
   LayerImpl(),
   tieword_embedding_props(nntrainer::props::InDim(), nntrainer::props::OutDim(),
-                          nntrainer::props::Unit()) {
+                          nntrainer::props::Unit(),
+                          props::VocabSelectionClusters(),
+                          props::VocabSelectionProbes(),
+                          props::VocabSelectionMargin()) {
   weight_idx.fill(std::numeric_limits<unsigned>::max());
 }
 
@@ -60,9 +87,11 @@ void TieWordEmbedding::finalize_embedding(
   NNTR_THROW_IF(input_dim.channel() != 1, std::invalid_argument)
     << "Embedding layer takes only one for channel size";
 
-  NNTR_THROW_IF(input_dim.getDataType() != nntrainer::TensorDim::DataType::FP32,
-                std::invalid_argument)
-    << "Embedding layer takes only FP32 input data";
+  NNTR_THROW_IF(
+    input_dim.getDataType() != nntrainer::TensorDim::DataType::FP32 &&
+      input_dim.getDataType() != nntrainer::TensorDim::DataType::UINT32,
+    std::invalid_argument)
+    << "Embedding layer takes only FP32 or UINT32 input data";
 
   auto &weight_regularizer =
     std::get<nntrainer::props::WeightRegularizer>(*layer_impl_props);
@@ -118,6 +147,15 @@ void TieWordEmbedding::finalize_lmhead(nntrainer::InitLayerContext &context) {
   NNTR_THROW_IF(context.getNumInputs() != 1, std::invalid_argument)
     << "lm head layer takes only one input";
 
+  NNTR_THROW_IF(
+    std::get<props::VocabSelectionClusters>(tieword_embedding_props).get() &&
+      ((context.getWeightDataType() != nntrainer::TensorDim::DataType::FP32 &&
+        context.getWeightDataType() != nntrainer::TensorDim::DataType::Q6_K) ||
+       context.getActivationDataType() != nntrainer::TensorDim::DataType::FP32),
+    std::invalid_argument)
+    << "vocabulary selection supports only FP32 activations with FP32 or Q6_K "
+       "lm head weight";
+
   std::vector<ml::train::TensorDim> output_dims(1);
 
   /// @todo fc actaully supports multidimensions.
@@ -157,11 +195,36 @@ void TieWordEmbedding::finalize_lmhead(nntrainer::InitLayerContext &context) {
     weight_dim, weight_initializer, weight_regularizer,
     weight_regularizer_constant, weight_decay, "Embedding", true);
 
+  const unsigned int clusters = std::min(
+    std::get<props::VocabSelectionClusters>(tieword_embedding_props).get(),
+    static_cast<unsigned int>(unit));
+
   if (disable_bias.empty() || disable_bias.get() == false) {
+    NNTR_THROW_IF(clusters, std::invalid_argument)
+      << "vocabulary selection does not support the lm head bias";
     weight_idx[TieWordEmbeddingParams::bias] = context.requestWeight(
       bias_dim, bias_initializer, nntrainer::WeightRegularizer::NONE, 1.0f,
       bias_decay, "bias", true);
   }
+
+  if (clusters) {
+    /// the index is built by buildVocabSelection() once the weight is loaded
+    auto request = [&context](unsigned int width, unsigned int height,
+                              nntrainer::TensorDim::DataType type,
+                              const std::string &name) {
+      return context.requestTensor(
+        nntrainer::TensorDim({1, 1, height, width},
+                             {context.getFormat(), type}),
+        name, nntrainer::Initializer::ZEROS, false,
+        nntrainer::TensorLifespan::MAX_LIFESPAN);
+    };
+    request(in_dim.width(), clusters, nntrainer::TensorDim::DataType::FP32,
+            "vocab_centroids");
+    request(clusters, 1, nntrainer::TensorDim::DataType::FP32, "vocab_radius");
+    request(clusters + 1, 1, nntrainer::TensorDim::DataType::UINT32,
+            "vocab_offsets");
+    request(unit, 1, nntrainer::TensorDim::DataType::UINT32, "vocab_ids");
+  }
 }
 
 void TieWordEmbedding::setProperty(const std::vector<std::string> &values) {
@@ -210,15 +273,18 @@ void TieWordEmbedding::incremental_forwarding_embedding(
 
   size_t b_size = input_.batch();
 
+  const bool uint_input =
+    input_.getDataType() == nntrainer::TensorDim::DataType::UINT32;
   for (size_t b = 0; b < b_size; ++b) {
-    float *in_data =
-      input_.getAddress<float>(b * input_.getDim().getFeatureLen());
+    const void *in_data =
+      input_.getAddress<void>(b * input_.getDim().getFeatureLen());
 
     nntrainer::Tensor batchsliced_hidden = hidden_.getBatchSlice(b, 1);
 
 #pragma omp parallel for
     for (int i = from; i < to; ++i) {
-      unsigned int embed_idx = static_cast<unsigned int>(in_data[i - from]);
+      unsigned int embed_idx =
+        nntrainer::wordIndex(in_data, uint_input, i - from);
       if (embed_idx >= in_dim) {
         throw std::invalid_argument("input word index is greater than in_dim");
       }
@@ -266,10 +332,8 @@ void TieWordEmbedding::incremental_forwarding_lmhead(
   unsigned int _from = from;
 
   if (from) {
-    NNTR_THROW_IF(to - from != 1, std::invalid_argument)
-      << "incremental step size is not 1";
+    to = to - from;
     from = 0;
-    to = 1;
   }
 
   input_step_dim.batch(1);
@@ -279,16 +343,16 @@ void TieWordEmbedding::incremental_forwarding_lmhead(
 
   unsigned int b_size = input_dim.batch();
 
+  const bool vocab_selection = context.getNumTensors() > 0;
+
   for (unsigned int b = 0; b < b_size; ++b) {
     nntrainer::Tensor input_step = input_.getSharedDataTensor(
       input_step_dim,
-      b * input_dim.getFeatureLen() +
-        (to - from == 1 ? 0 : (to - 1) * input_.width()),
+      b * input_dim.getFeatureLen() + (to - 1) * input_.width(),
       true);
     nntrainer::Tensor hidden_step = hidden_.getSharedDataTensor(
       hidden_step_dim,
-      b * hidden_dim.getFeatureLen() +
-        (to - from == 1 ? 0 : (to - 1) * hidden_.width()),
+      b * hidden_dim.getFeatureLen() + (to - 1) * hidden_.width(),
       true);
 
     ///@note Since tieword embedding shares the weight with embedding,
@@ -298,6 +362,10 @@ void TieWordEmbedding::incremental_forwarding_lmhead(
                   std::invalid_argument)
       << "weight type is not supported for custom tie word embedding layer";
 
+    if (vocab_selection &&
+        selectVocab(context, input_step.getData(), hidden_step.getData()))
+      continue;
+
     input_step.dot(weight, hidden_step, false, true);
 
     if (auto &disable_bias =
@@ -310,6 +378,198 @@ void TieWordEmbedding::incremental_forwarding_lmhead(
   }
 }
 
+/**
+ * @brief copy lm head rows [row, row + rows) into @a out as fp32
+ */
+static void get_weight_rows(const nntrainer::Tensor &weight, unsigned int row,
+                            unsigned int rows, float *out) {
+  const size_t dim = weight.width();
+  if (weight.getDataType() == nntrainer::TensorDim::DataType::Q6_K) {
+    const size_t row_bytes = Q6_K_BLOCK_SIZE * ((dim + 256 - 1) / 256);
+    const char *data = (const char *)weight.getData<uint8_t>();
+    for (unsigned int r = 0; r < rows; ++r)
+      nntrainer::dequantize_row_q6_K(data + row_bytes * (row + r),
+                                     out + r * dim, dim);
+  } else {
+    std::copy_n(weight.getData<float>() + row * dim, rows * dim, out);
+  }
+}
+
+void TieWordEmbedding::buildVocabSelection(
+  nntrainer::RunLayerContext &context) {
+  NNTR_THROW_IF(context.getNumTensors() == 0, std::invalid_argument)
+    << context.getName() << " is not a lm head with vocab_selection_clusters";
+
+  const nntrainer::Tensor &weight =
+    context.getWeight(TieWordEmbeddingParams::weight);
+  const unsigned int vocab = weight.height();
+  const unsigned int dim = weight.width();
+  float *centroids = context.getTensor(vocab_centroids).getData<float>();
+  float *radius = context.getTensor(vocab_radius).getData<float>();
+  uint32_t *offsets = context.getTensor(vocab_offsets).getData<uint32_t>();
+  uint32_t *ids = context.getTensor(vocab_ids).getData<uint32_t>();
+  const unsigned int clusters = context.getTensor(vocab_radius).width();
+
+  /// seed the centroids with rows spread over the vocabulary
+  for (unsigned int c = 0; c < clusters; ++c)
+    get_weight_rows(weight, (size_t)c * vocab / clusters, 1,
+                    centroids + (size_t)c * dim);
+
+  std::vector<float> rows((size_t)VOCAB_SELECTION_CHUNK * dim);
+  std::vector<float> scores((size_t)VOCAB_SELECTION_CHUNK * clusters);
+  std::vector<float> half_norm(clusters);
+  std::vector<float> sums((size_t)clusters * dim);
+  std::vector<unsigned int> counts(clusters);
+  std::vector<unsigned int> assign(vocab);
+  std::vector<float> dist(vocab);
+
+  for (unsigned int it = 0; it <= VOCAB_SELECTION_ITERATIONS; ++it) {
+    const bool last = it == VOCAB_SELECTION_ITERATIONS;
+    for (unsigned int c = 0; c < clusters; ++c) {
+      const float *mu = centroids + (size_t)c * dim;
+      half_norm[c] = 0.5f * nntrainer::sdot(dim, mu, 1, mu, 1);
+    }
+    std::fill(sums.begin(), sums.end(), 0.0f);
+    std::fill(counts.begin(), counts.end(), 0);
+
+    for (unsigned int r = 0; r < vocab; r += VOCAB_SELECTION_CHUNK) {
+      const unsigned int n = std::min(VOCAB_SELECTION_CHUNK, vocab - r);
+      get_weight_rows(weight, r, n, rows.data());
+      nntrainer::sgemm(0, false, true, n, clusters, dim, 1.0f, rows.data(),
+                       dim, centroids, dim, 0.0f, scores.data(),
+                       clusters);
+
+      /// the nearest centroid maximizes w.mu - |mu|^2 / 2
+#pragma omp parallel for
+      for (int i = 0; i < (int)n; ++i) {
+        const float *score = scores.data() + (size_t)i * clusters;
+        unsigned int best = 0;
+        for (unsigned int c = 1; c < clusters; ++c)
+          if (score[c] - half_norm[c] > score[best] - half_norm[best])
+            best = c;
+        assign[r + i] = best;
+        if (last) {
+          const float *w = rows.data() + (size_t)i * dim;
+          const float d2 = nntrainer::sdot(dim, w, 1, w, 1) -
+                           2.0f * (score[best] - half_norm[best]);
+          dist[r + i] = std::sqrt(std::max(d2, 0.0f));
+        }
+      }
+
+      if (last)
+        continue;
+      for (unsigned int i = 0; i < n; ++i) {
+        counts[assign[r + i]]++;
+        nntrainer::saxpy(dim, 1.0f, rows.data() + (size_t)i * dim, 1,
+                         sums.data() + (size_t)assign[r + i] * dim, 1);
+      }
+    }
+
+    if (last)
+      break;
+    /// empty clusters keep their previous centroid
+    for (unsigned int c = 0; c < clusters; ++c) {
+      if (counts[c] == 0)
+        continue;
+      float *mu = centroids + (size_t)c * dim;
+      const float *sum = sums.data() + (size_t)c * dim;
+      for (unsigned int d = 0; d < dim; ++d)
+        mu[d] = sum[d] / counts[c];
+    }
+  }
+
+  std::fill_n(offsets, clusters + 1, 0);
+  std::fill_n(radius, clusters, 0.0f);
+  for (unsigned int v = 0; v < vocab; ++v) {
+    offsets[assign[v] + 1]++;
+    radius[assign[v]] = std::max(radius[assign[v]], dist[v]);
+  }
+  for (unsigned int c = 0; c < clusters; ++c)
+    offsets[c + 1] += offsets[c];
+
+  std::vector<unsigned int> fill(offsets, offsets + clusters);
+  for (unsigned int v = 0; v < vocab; ++v)
+    ids[fill[assign[v]]++] = v;
+
+  ml_logi("%s: vocabulary selection index built, %u rows in %u clusters",
+          context.getName().c_str(), vocab, clusters);
+}
+
+bool TieWordEmbedding::selectVocab(nntrainer::RunLayerContext &context,
+                                   const float *hidden, float *logits) {
+  const nntrainer::Tensor &weight =
+    context.getWeight(weight_idx[TieWordEmbeddingParams::weight]);
+  const unsigned int vocab = weight.height();
+  const unsigned int dim = weight.width();
+  const float *centroids = context.getTensor(vocab_centroids).getData<float>();
+  const float *radius = context.getTensor(vocab_radius).getData<float>();
+  const uint32_t *offsets =
+    context.getTensor(vocab_offsets).getData<uint32_t>();
+  const uint32_t *ids = context.getTensor(vocab_ids).getData<uint32_t>();
+  const unsigned int clusters = context.getTensor(vocab_radius).width();
+  NNTR_THROW_IF(offsets[clusters] != vocab, std::runtime_error)
+    << context.getName()
+    << ": the vocabulary selection index is not built, call "
+       "TieWordEmbedding::buildVocabSelection() after loading the weights";
+  const unsigned int probes = std::min(
+    std::get<props::VocabSelectionProbes>(tieword_embedding_props).get(),
+    clusters);
+  const float margin =
+    std::get<props::VocabSelectionMargin>(tieword_embedding_props).get();
+
+  /// h.w = h.mu + h.(w - mu) <= h.mu + |h| * radius for every row w of a
+  /// cluster, so the clusters are ranked by this upper bound
+  const float norm = std::sqrt(nntrainer::sdot(dim, hidden, 1, hidden, 1));
+  bounds.resize(clusters);
+  order.resize(clusters);
+  nntrainer::sgemv(0, false, clusters, dim, 1.0f, centroids, dim, hidden, 1,
+                   0.0f, bounds.data(), 1);
+  for (unsigned int c = 0; c < clusters; ++c)
+    bounds[c] += margin * norm * radius[c];
+
+  for (unsigned int c = 0; c < clusters; ++c)
+    order[c] = c;
+  const unsigned int ranked = std::min(probes + 1, clusters);
+  std::partial_sort(
+    order.begin(), order.begin() + ranked, order.end(),
+    [this](unsigned int a, unsigned int b) { return bounds[a] > bounds[b]; });
+
+  std::vector<unsigned int> candidates;
+  for (unsigned int p = 0; p < probes; ++p)
+    candidates.insert(candidates.end(), ids + offsets[order[p]],
+                      ids + offsets[order[p] + 1]);
+
+  std::fill_n(logits, vocab, std::numeric_limits<float>::lowest());
+
+  if (weight.getDataType() == nntrainer::TensorDim::DataType::Q6_K) {
+    /// the activation is quantized once as the full lm head does
+    const size_t blocks = (dim + 256 - 1) / 256;
+    std::vector<char> hidden_q8(Q8_K_BLOCK_SIZE * blocks);
+    nntrainer::quantize_row_q8_K(hidden, hidden_q8.data(), dim);
+    const char *data = (const char *)weight.getData<uint8_t>();
+#pragma omp parallel for
+    for (int i = 0; i < (int)candidates.size(); ++i)
+      logits[candidates[i]] = nntrainer::dot_q6_K_q8_K(
+        dim, data + Q6_K_BLOCK_SIZE * blocks * candidates[i], hidden_q8.data());
+  } else {
+    const float *data = weight.getData<float>();
+#pragma omp parallel for
+    for (int i = 0; i < (int)candidates.size(); ++i)
+      logits[candidates[i]] = nntrainer::sdot(
+        dim, data + (size_t)candidates[i] * dim, 1, hidden, 1);
+  }
+
+  if (probes == clusters)
+    return true;
+
+  float best = std::numeric_limits<float>::lowest();
+  for (auto id : candidates)
+    best = std::max(best, logits[id]);
+
+  /// an unscored cluster may still hold a larger logit
+  return best >= bounds[order[probes]];
+}
+
 void TieWordEmbedding::calcDerivative(nntrainer::RunLayerContext &context) {
   throw nntrainer::exception::not_supported(
     "calcDerivative for Embedding layer is not supported");
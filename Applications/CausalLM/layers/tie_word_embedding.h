@@ -22,6 +22,7 @@
 #define WIN_EXPORT
 #endif
 
+#include <causallm_common_properties.h>
 #include <common_properties.h>
 #include <layer_devel.h>
 #include <layer_impl.h>
@@ -137,18 +138,46 @@ public:
    */
   WIN_EXPORT void setProperty(const std::vector<std::string> &values) override;
 
+  /**
+   * @brief build the cluster index of the vocabulary shortlisting from the
+   * loaded lm head weight
+   * @param context run context of a lm head with vocab_selection_clusters set
+   * @note The index is kept in the tensors of the lm head, so it has to be
+   * built again whenever the weights are loaded. The shortlisted logits keep
+   * the argmax only, so the lm head supports greedy decoding only.
+   */
+  WIN_EXPORT static void
+  buildVocabSelection(nntrainer::RunLayerContext &context);
+
   inline static const std::string type = "tie_word_embeddings";
 
 private:
   std::tuple<nntrainer::props::InDim, nntrainer::props::OutDim,
-             nntrainer::props::Unit>
+             nntrainer::props::Unit, props::VocabSelectionClusters,
+             props::VocabSelectionProbes, props::VocabSelectionMargin>
     tieword_embedding_props;
   enum mode { embedding, lm_head };
   enum mode mode_;
   std::array<unsigned int, 4> weight_idx; /**< indices of the weights */
 
+  /** per-step scratch of the vocabulary shortlisting */
+  std::vector<float> bounds;       /**< upper bound of the clusters */
+  std::vector<unsigned int> order; /**< clusters sorted by bound */
+
   WIN_EXPORT void finalize_embedding(nntrainer::InitLayerContext &context);
   WIN_EXPORT void finalize_lmhead(nntrainer::InitLayerContext &context);
+
+  /**
+   * @brief compute the logits of the most promising clusters only
+   * @param context run context of the lm head
+   * @param hidden hidden state of the step
+   * @param logits output logits, the unscored ones are set to the lowest float
+   * @return false if an unscored cluster may hold the best logit; the caller
+   * then has to compute the full lm head
+   */
+  bool selectVocab(nntrainer::RunLayerContext &context, const float *hidden,
+                   float *logits);
+
   WIN_EXPORT void
   incremental_forwarding_embedding(nntrainer::RunLayerContext &context,
                                    unsigned int from, unsigned int to,
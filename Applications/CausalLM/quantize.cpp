@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   quantize.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Convert a FP32 CausalLM weight file into quantized weights
+ *
+ * @note   The graph is built in the target data types, the FP32 weight file
+ * is streamed weight by weight and every weight is quantized and repacked in
+ * parallel into the layout the kernels expect. The result is saved as a
+ * weight container by default, or as a plain weight file.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <string>
+
+#include "json.hpp"
+#include <factory.h>
+#include <thread_runtime.h>
+#include <tool_util.h>
+
+#include "causal_lm.h"
+
+using json = nlohmann::json;
+using causallm::Clock;
+using causallm::elapsedMs;
+
+namespace {
+
+/**
+ * @brief print usage of the converter
+ */
+void printUsage(const char *prog) {
+  std::cerr
+    << "usage: " << prog << " <model_path> <output> [options]\n"
+    << "  <model_path> : model directory with config.json,\n"
+    << "                 generation_config.json and nntr_config.json of\n"
+    << "                 the FP32 weight file\n"
+    << "  <output>     : converted weight file\n"
+    << "options:\n"
+    << "  --fc_dtype <type>        : fully connected weights (Q4_0)\n"
+    << "  --embedding_dtype <type> : embedding weights (Q6_K)\n"
+    << "  --lmhead_dtype <type>    : lm head weights (Q6_K)\n"
+    << "  --format <container|bin> : output format (container)\n"
+    << "  --threads <n>            : converting threads, 0 for all (0)\n"
+    << "types are FP32, FP16, Q4_0, Q4_K and Q6_K. The nntr_config.json of\n"
+    << "the converted file is printed to stdout.\n";
+}
+
+/**
+ * @brief check that the nntr_config describes a FP32 weight file
+ */
+void checkFp32Source(const json &nntr_cfg) {
+  const std::string tensor_type = nntr_cfg["model_tensor_type"];
+  const bool fp32 =
+    tensor_type.rfind("FP32-", 0) == 0 &&
+    nntr_cfg.value("fc_layer_dtype", "FP32") == "FP32" &&
+    nntr_cfg.value("embedding_dtype", "FP32") == "FP32" &&
+    nntr_cfg.value("lmhead_dtype", "FP32") == "FP32";
+  if (!fp32)
+    throw std::invalid_argument(
+      "the weight file of nntr_config.json must be FP32, model_tensor_type: " +
+      tensor_type);
+}
+
+/**
+ * @brief get the model tensor type of the converted graph. Data types the
+ * model tensor type does not name, like Q6_K, are kept by the layers only.
+ */
+std::string targetTensorType(const std::string &fc_dtype,
+                             const std::string &activation_type) {
+  static const std::set<std::string> model_tensor_types = {
+    "Q4_K-FP32", "Q4_0-FP32", "Q4_0-FP16", "FP16-FP16",
+    "FP16-FP32", "FP32-FP16", "FP32-FP32"};
+  const std::string tensor_type = fc_dtype + "-" + activation_type;
+  return model_tensor_types.count(tensor_type) ? tensor_type
+                                               : "FP32-" + activation_type;
+}
+
+/**
+ * @brief get the file name of a path
+ */
+std::string baseName(const std::string &path) {
+  size_t pos = path.find_last_of("/\\");
+  return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  causallm::registerInMemoryModels();
+
+  const std::string model_path = argv[1];
+  const std::string output = argv[2];
+  std::string fc_dtype = "Q4_0";
+  std::string embedding_dtype = "Q6_K";
+  std::string lmhead_dtype = "Q6_K";
+  std::string format = "container";
+  unsigned int num_threads = 0;
+
+  for (int i = 3; i < argc; i += 2) {
+    const std::string option = argv[i];
+    if (i + 1 >= argc) {
+      printUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    const std::string value = argv[i + 1];
+    if (option == "--fc_dtype") {
+      fc_dtype = value;
+    } else if (option == "--embedding_dtype") {
+      embedding_dtype = value;
+    } else if (option == "--lmhead_dtype") {
+      lmhead_dtype = value;
+    } else if (option == "--format" &&
+               (value == "container" || value == "bin")) {
+      format = value;
+    } else if (option == "--threads") {
+      num_threads = std::stoul(value);
+    } else {
+      printUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  try {
+    json cfg = causallm::LoadJsonFile(model_path + "/config.json");
+    json generation_cfg =
+      causallm::LoadJsonFile(model_path + "/generation_config.json");
+    json nntr_cfg = causallm::LoadJsonFile(model_path + "/nntr_config.json");
+    checkFp32Source(nntr_cfg);
+
+    const std::string source =
+      model_path + "/" + nntr_cfg["model_file_name"].get<std::string>();
+    const std::string tensor_type = nntr_cfg["model_tensor_type"];
+    const std::string activation_type =
+      tensor_type.substr(tensor_type.find('-') + 1);
+
+    /// the graph holds the target data types, activations are kept small
+    json target_cfg = nntr_cfg;
+    target_cfg["model_tensor_type"] =
+      targetTensorType(fc_dtype, activation_type);
+    target_cfg["fc_layer_dtype"] = fc_dtype;
+    target_cfg["embedding_dtype"] = embedding_dtype;
+    target_cfg["lmhead_dtype"] = lmhead_dtype;
+    target_cfg["model_file_name"] = baseName(output);
+
+    json build_cfg = target_cfg;
+    build_cfg.erase("tokenizer_file");
+    build_cfg.erase("system_prompt");
+    build_cfg.erase("prefill_chunk_size");
+    build_cfg["fsu"] = false;
+    build_cfg["batch_size"] = 1;
+    build_cfg["init_seq_len"] = 16;
+    build_cfg["max_seq_len"] = 32;
+    build_cfg["num_to_generate"] = 16;
+
+    auto &runtime = nntrainer::ThreadRuntime::Global();
+    nntrainer::ThreadRuntimeConfig runtime_config = runtime.getConfig();
+    runtime_config.num_threads = num_threads;
+    runtime.configure(runtime_config);
+
+    const std::string architecture =
+      cfg["architectures"].get<std::vector<std::string>>()[0];
+    auto model = causallm::Factory::Instance().create(
+      architecture, cfg, generation_cfg, build_cfg);
+    if (!model)
+      throw std::invalid_argument("unsupported architecture " + architecture);
+
+    auto start = Clock::now();
+    model->initialize();
+    auto start_convert = Clock::now();
+    model->convert_fp32_weight(source);
+    auto start_save = Clock::now();
+    model->save_weight(
+      output, format == "bin"
+                ? ml::train::ModelFormat::MODEL_FORMAT_BIN
+                : ml::train::ModelFormat::MODEL_FORMAT_WEIGHT_CONTAINER);
+    auto finish = Clock::now();
+
+    std::cerr << "converted " << source << " to " << output << " with "
+              << runtime.getNumThreads() << " threads, init "
+              << elapsedMs(start, start_convert) << " ms, convert "
+              << elapsedMs(start_convert, start_save) << " ms, save "
+              << elapsedMs(start_save, finish) << " ms" << std::endl;
+    std::cout << target_cfg.dump(4) << std::endl;
+  } catch (const std::exception &e) {
+    std::cerr << "\n[!] FATAL ERROR: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -91,6 +91,7 @@ Qwen3CausalLM::createAttention(const int layer_id, int seq_len, int n_heads,
     withKey("rope_theta", ROPE_THETA),
     withKey("max_position_embeddings", MAX_POSITION_EMBEDDINGS),
     withKey("max_new_tokens", std::to_string(NUM_TO_GENERATE)),
+    withKey("kv_cache_type", KV_CACHE_TYPE),
     withKey("input_layers", {Q_norm, K_norm, V})};
   layers.push_back(createLayer("mha_core", a_params));
 
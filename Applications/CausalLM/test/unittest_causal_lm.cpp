@@ -0,0 +1,224 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   unittest_causal_lm.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Chunked prefill and FP32 weight conversion tests of the CausalLM
+ * model
+ */
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <causal_lm.h>
+
+namespace {
+
+using causallm::json;
+
+constexpr unsigned int VOCAB = 96;
+constexpr unsigned int PROMPT_LEN = 11;
+
+/**
+ * @brief CausalLM exposing the logits of a prefill
+ */
+class PrefillCausalLM : public causallm::CausalLM {
+public:
+  /**
+   * @brief Construct a new PrefillCausalLM object
+   */
+  PrefillCausalLM(json &cfg, json &generation_cfg, json &nntr_cfg) :
+    CausalLM(cfg, generation_cfg, nntr_cfg) {}
+
+  /**
+   * @brief prefill the prompt from position zero
+   * @return lm head output of the last prompt token
+   */
+  std::vector<float> prefillLogits(const std::vector<unsigned int> &ids) {
+    std::vector<unsigned int> input_sample(MAX_SEQ_LEN);
+    std::copy(ids.begin(), ids.end(), input_sample.begin());
+
+    logits.assign(NUM_VOCAB, 0.0f);
+    prefill(input_sample.data(), ids.size(), 0, {logits.data()});
+    return logits;
+  }
+};
+
+/**
+ * @brief configurations of a two layer model
+ */
+struct ModelConfig {
+  json cfg;
+  json generation_cfg;
+  json nntr_cfg;
+
+  /**
+   * @brief FP32 model with hidden size and intermediate size the quantized
+   * blocks of 256 values divide
+   */
+  explicit ModelConfig(bool tie_word_embeddings = false) :
+    cfg({{"vocab_size", VOCAB},
+         {"hidden_size", 256},
+         {"intermediate_size", 512},
+         {"num_hidden_layers", 2},
+         {"num_attention_heads", 8},
+         {"num_key_value_heads", 2},
+         {"head_dim", 32},
+         {"max_position_embeddings", 64},
+         {"rope_theta", 10000},
+         {"tie_word_embeddings", tie_word_embeddings},
+         {"rms_norm_eps", 1e-6}}),
+    generation_cfg({{"eos_token_id", std::vector<unsigned int>{0}},
+                    {"bos_token_id", 1}}),
+    nntr_cfg({{"batch_size", 1},
+              {"model_tensor_type", "FP32-FP32"},
+              {"init_seq_len", 16},
+              {"max_seq_len", 32},
+              {"num_to_generate", 1},
+              {"bad_word_ids", std::vector<unsigned int>()},
+              {"embedding_dtype", "FP32"},
+              {"fc_layer_dtype", "FP32"},
+              {"kv_cache_type", "fp16"}}) {}
+};
+
+/**
+ * @brief token ids of the prompt
+ */
+std::vector<unsigned int> promptIds() {
+  std::vector<unsigned int> ids(PROMPT_LEN);
+  for (unsigned int i = 0; i < PROMPT_LEN; ++i)
+    ids[i] = (i * 29 + 5) % VOCAB;
+  return ids;
+}
+
+/**
+ * @brief prefill the prompt with random weights
+ */
+std::vector<float> runPrefill(bool tie_word_embeddings,
+                              unsigned int prefill_chunk_size) {
+  ModelConfig config(tie_word_embeddings);
+  if (prefill_chunk_size)
+    config.nntr_cfg["prefill_chunk_size"] = prefill_chunk_size;
+
+  PrefillCausalLM model(config.cfg, config.generation_cfg, config.nntr_cfg);
+  model.initialize();
+  model.fill_random_weight(3);
+  return model.prefillLogits(promptIds());
+}
+
+/**
+ * @brief convert the weights of a FP32 model with random values into the
+ * given data types and compare the logits of the prompt
+ * @return L2 norm of the logit difference relative to the FP32 logits
+ */
+float convertedLogitError(const std::string &model_tensor_type,
+                          const std::string &embedding_dtype) {
+  const std::string fp32_weight_path = "unittest_causal_lm_fp32.bin";
+
+  ModelConfig fp32_config;
+  PrefillCausalLM fp32_model(fp32_config.cfg, fp32_config.generation_cfg,
+                             fp32_config.nntr_cfg);
+  fp32_model.initialize();
+  fp32_model.fill_random_weight(5);
+  fp32_model.save_weight(fp32_weight_path);
+  const std::vector<float> expected = fp32_model.prefillLogits(promptIds());
+
+  ModelConfig config;
+  config.nntr_cfg["model_tensor_type"] = model_tensor_type;
+  config.nntr_cfg["embedding_dtype"] = embedding_dtype;
+  config.nntr_cfg["lmhead_dtype"] = "FP32";
+  PrefillCausalLM model(config.cfg, config.generation_cfg, config.nntr_cfg);
+  model.initialize();
+  model.convert_fp32_weight(fp32_weight_path);
+  const std::vector<float> result = model.prefillLogits(promptIds());
+  std::remove(fp32_weight_path.c_str());
+
+  float diff = 0.0f, norm = 0.0f;
+  for (unsigned int v = 0; v < VOCAB; ++v) {
+    diff += (result[v] - expected[v]) * (result[v] - expected[v]);
+    norm += expected[v] * expected[v];
+  }
+  return std::sqrt(diff / norm);
+}
+
+/**
+ * @brief compare the chunked prefills with the single step prefill
+ */
+void expectSameLogits(bool tie_word_embeddings) {
+  const std::vector<float> expected = runPrefill(tie_word_embeddings, 0);
+  /// chunks dividing the prompt, leaving a partial last chunk and covering it
+  for (unsigned int chunk : {1u, 4u, 11u, 16u}) {
+    const std::vector<float> result = runPrefill(tie_word_embeddings, chunk);
+    ASSERT_EQ(result.size(), expected.size());
+    for (unsigned int v = 0; v < VOCAB; ++v)
+      EXPECT_NEAR(result[v], expected[v], 1e-4f)
+        << "chunk " << chunk << ", token " << v;
+  }
+}
+
+} // namespace
+
+/**
+ * @brief chunked prefill of the fully connected lm head gives the logits of
+ * the unchunked prefill
+ */
+TEST(CausalLMPrefill, chunked_matches_unchunked_p) { expectSameLogits(false); }
+
+/**
+ * @brief chunked prefill of the tied lm head gives the logits of the unchunked
+ * prefill
+ */
+TEST(CausalLMPrefill, chunked_matches_unchunked_tied_p) {
+  expectSameLogits(true);
+}
+
+/**
+ * @brief fully connected weights converted into Q4_0 keep the FP32 logits
+ */
+TEST(CausalLMConvertFp32Weight, q4_0_p) {
+  EXPECT_LT(convertedLogitError("Q4_0-FP32", "FP32"), 0.05f);
+}
+
+/**
+ * @brief fully connected weights converted into Q4_K keep the FP32 logits
+ */
+TEST(CausalLMConvertFp32Weight, q4_K_p) {
+  EXPECT_LT(convertedLogitError("Q4_K-FP32", "FP32"), 0.05f);
+}
+
+/**
+ * @brief embedding weights converted into Q6_K keep the FP32 logits
+ */
+TEST(CausalLMConvertFp32Weight, q6_K_p) {
+  EXPECT_LT(convertedLogitError("FP32-FP32", "Q6_K"), 0.05f);
+}
+
+/**
+ * @brief Main gtest
+ */
+int main(int argc, char **argv) {
+  int result = -1;
+
+  try {
+    testing::InitGoogleTest(&argc, argv);
+  } catch (...) {
+    std::cerr << "Error during InitGoogleTest" << std::endl;
+    return 0;
+  }
+
+  try {
+    result = RUN_ALL_TESTS();
+  } catch (...) {
+    std::cerr << "Error during RUN_ALL_TESTS()" << std::endl;
+  }
+
+  return result;
+}
@@ -0,0 +1,231 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   unittest_mha_core.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Sliding window KV cache tests of the CausalLM mha_core layer
+ */
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <layer_context.h>
+#include <mha_core.h>
+#include <var_grad.h>
+#include <weight.h>
+
+namespace {
+
+constexpr unsigned int NUM_HEADS_Q = 2;
+constexpr unsigned int NUM_HEADS_KV = 1;
+constexpr unsigned int HEAD_DIM = 32;
+constexpr unsigned int WINDOW = 4;
+constexpr unsigned int MAX_TIMESTEP = 16;
+constexpr float ROPE_THETA = 10000.0f;
+
+/**
+ * @brief deterministic projection of the position pos, index i
+ */
+float projected(unsigned int seed, unsigned int pos, unsigned int i) {
+  return std::sin(0.37f * seed + 0.11f * pos * (i % 7 + 1) + 0.05f * i);
+}
+
+/**
+ * @brief rotate every head of the row x to the position pos
+ */
+void rotate(std::vector<float> &x, unsigned int pos) {
+  const unsigned int half = HEAD_DIM / 2;
+  for (unsigned int h = 0; h < x.size(); h += HEAD_DIM) {
+    for (unsigned int k = 0; k < half; ++k) {
+      const float angle =
+        pos / std::pow(ROPE_THETA, (2 * k) / static_cast<float>(HEAD_DIM));
+      const float c = std::cos(angle), s = std::sin(angle);
+      const float a = x[h + k], b = x[h + k + half];
+      x[h + k] = a * c - b * s;
+      x[h + k + half] = a * s + b * c;
+    }
+  }
+}
+
+/**
+ * @brief attention of the query at pos over all the keys and values up to
+ * pos, masked to the last WINDOW positions
+ */
+std::vector<float> fullCacheAttention(unsigned int pos) {
+  const unsigned int q_width = NUM_HEADS_Q * HEAD_DIM;
+  const unsigned int kv_width = NUM_HEADS_KV * HEAD_DIM;
+  const unsigned int gqa_size = NUM_HEADS_Q / NUM_HEADS_KV;
+  const unsigned int begin = pos < WINDOW ? 0 : pos - WINDOW + 1;
+
+  std::vector<float> q(q_width);
+  for (unsigned int i = 0; i < q_width; ++i)
+    q[i] = projected(0, pos, i);
+  rotate(q, pos);
+
+  std::vector<std::vector<float>> keys, values;
+  for (unsigned int p = begin; p <= pos; ++p) {
+    std::vector<float> k(kv_width), v(kv_width);
+    for (unsigned int i = 0; i < kv_width; ++i) {
+      k[i] = projected(1, p, i);
+      v[i] = projected(2, p, i);
+    }
+    rotate(k, p);
+    keys.push_back(k);
+    values.push_back(v);
+  }
+
+  std::vector<float> out(q_width, 0.0f);
+  for (unsigned int h = 0; h < NUM_HEADS_Q; ++h) {
+    const unsigned int kv_off = (h / gqa_size) * HEAD_DIM;
+    std::vector<float> score(keys.size());
+    for (unsigned int r = 0; r < keys.size(); ++r) {
+      float dot = 0.0f;
+      for (unsigned int i = 0; i < HEAD_DIM; ++i)
+        dot += q[h * HEAD_DIM + i] * keys[r][kv_off + i];
+      score[r] = dot / std::sqrt(static_cast<float>(HEAD_DIM));
+    }
+    const float max = *std::max_element(score.begin(), score.end());
+    float sum = 0.0f;
+    for (auto &s : score)
+      sum += (s = std::exp(s - max));
+    for (unsigned int r = 0; r < keys.size(); ++r)
+      for (unsigned int i = 0; i < HEAD_DIM; ++i)
+        out[h * HEAD_DIM + i] += score[r] / sum * values[r][kv_off + i];
+  }
+  return out;
+}
+
+/**
+ * @brief run the steps [bounds[i], bounds[i + 1]) through a ring buffer
+ * mha_core layer and compare every output row with the full cache attention
+ *
+ * @return number of compared rows past the window
+ */
+unsigned int runRingCache(const std::string &kv_cache_type,
+                          const std::vector<unsigned int> &bounds,
+                          float tolerance) {
+  unsigned int max_step = 0;
+  for (unsigned int i = 0; i + 1 < bounds.size(); ++i)
+    max_step = std::max(max_step, bounds[i + 1] - bounds[i]);
+
+  causallm::MHACoreLayer layer;
+  layer.setProperty({"num_heads=" + std::to_string(NUM_HEADS_Q),
+                     "num_heads_KV=" + std::to_string(NUM_HEADS_KV),
+                     "sliding_window=" + std::to_string(WINDOW),
+                     "max_timestep=" + std::to_string(MAX_TIMESTEP),
+                     "max_position_embeddings=" + std::to_string(MAX_TIMESTEP),
+                     "rope_theta=" + std::to_string((int)ROPE_THETA),
+                     "kv_cache_type=" + kv_cache_type});
+
+  const nntrainer::TensorDim q_dim(1, 1, max_step, NUM_HEADS_Q * HEAD_DIM);
+  const nntrainer::TensorDim kv_dim(1, 1, max_step, NUM_HEADS_KV * HEAD_DIM);
+  nntrainer::InitLayerContext ic({q_dim, kv_dim, kv_dim}, {true}, false,
+                                 "mha");
+  layer.finalize(ic);
+
+  std::vector<nntrainer::Var_Grad> ins, outs, tensors;
+  for (auto &dim : ic.getInputDimensions())
+    ins.emplace_back(dim, nntrainer::Initializer::NONE, false, true, "in");
+  outs.emplace_back(ic.getOutSpecs()[0].variable_spec.dim,
+                    nntrainer::Initializer::NONE, false, true, "out");
+  tensors.reserve(ic.getTensorsSpec().size());
+  for (auto &spec : ic.getTensorsSpec())
+    tensors.emplace_back(spec, true);
+
+  std::vector<nntrainer::Var_Grad *> tensor_ptrs;
+  for (auto &t : tensors)
+    tensor_ptrs.push_back(&t);
+  nntrainer::RunLayerContext rc("mha", false, 0.0f, false, 1.0f, nullptr,
+                                false, {}, {&ins[0], &ins[1], &ins[2]},
+                                {&outs[0]}, tensor_ptrs);
+
+  /// the saved caches leave out the scratch tensors of the steps
+  const std::vector<unsigned int> cache_idx =
+    causallm::MHACoreLayer::getCacheTensorIdx(rc);
+  EXPECT_EQ(cache_idx.size(), kv_cache_type == "int8" ? 4u : 2u);
+  EXPECT_LT(cache_idx.size(), rc.getNumTensors());
+  for (unsigned int idx : cache_idx)
+    EXPECT_NE(rc.getTensorName(idx).find(":cache_"), std::string::npos);
+
+  unsigned int compared = 0;
+  for (unsigned int i = 0; i + 1 < bounds.size(); ++i) {
+    const unsigned int from = bounds[i], to = bounds[i + 1];
+    for (unsigned int r = 0; r < to - from; ++r) {
+      for (unsigned int j = 0; j < NUM_HEADS_Q * HEAD_DIM; ++j)
+        rc.getInput(0).setValue(0, 0, r, j, projected(0, from + r, j));
+      for (unsigned int j = 0; j < NUM_HEADS_KV * HEAD_DIM; ++j) {
+        rc.getInput(1).setValue(0, 0, r, j, projected(1, from + r, j));
+        rc.getInput(2).setValue(0, 0, r, j, projected(2, from + r, j));
+      }
+    }
+
+    layer.incremental_forwarding(rc, from, to, false);
+
+    for (unsigned int r = 0; r < to - from; ++r) {
+      const std::vector<float> expected = fullCacheAttention(from + r);
+      for (unsigned int j = 0; j < expected.size(); ++j)
+        EXPECT_NEAR(rc.getOutput(0).getValue(0, 0, r, j), expected[j],
+                    tolerance)
+          << "position " << from + r << ", index " << j;
+      compared += from + r >= WINDOW;
+    }
+  }
+  return compared;
+}
+
+} // namespace
+
+/**
+ * @brief single token decoding keeps attending the last window once the ring
+ * buffer wraps
+ */
+TEST(MHACoreRingCache, decode_past_window_p) {
+  EXPECT_EQ(runRingCache("fp16", {0, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}, 1e-2f),
+            8u);
+}
+
+/**
+ * @brief multi token steps crossing the wrap, starting at zero and past the
+ * window, match the full cache attention
+ */
+TEST(MHACoreRingCache, prefill_across_wrap_p) {
+  EXPECT_EQ(runRingCache("fp16", {0, 6, 7, 13, 14}, 1e-2f), 10u);
+  EXPECT_EQ(runRingCache("fp16", {0, 3, 9, 11, 12, 13}, 1e-2f), 9u);
+}
+
+/**
+ * @brief the quantized caches carry their scales through the ring buffer
+ */
+TEST(MHACoreRingCache, quantized_across_wrap_p) {
+  EXPECT_EQ(runRingCache("int8", {0, 3, 9, 10, 11, 12}, 5e-2f), 8u);
+}
+
+/**
+ * @brief Main gtest
+ */
+int main(int argc, char **argv) {
+  int result = -1;
+
+  try {
+    testing::InitGoogleTest(&argc, argv);
+  } catch (...) {
+    std::cerr << "Error during InitGoogleTest" << std::endl;
+    return 0;
+  }
+
+  try {
+    result = RUN_ALL_TESTS();
+  } catch (...) {
+    std::cerr << "Error during RUN_ALL_TESTS()" << std::endl;
+  }
+
+  return result;
+}
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   unittest_tie_word_embedding.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Vocabulary shortlisting tests of the CausalLM tied lm head
+ */
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <layer_context.h>
+#include <tie_word_embedding.h>
+#include <var_grad.h>
+#include <weight.h>
+
+namespace {
+
+constexpr unsigned int VOCAB = 600;
+constexpr unsigned int DIM = 64;
+constexpr unsigned int TOPICS = 24;
+
+/**
+ * @brief a tied lm head with its run context
+ */
+struct LmHead {
+  causallm::TieWordEmbedding layer;
+  std::vector<nntrainer::Weight> weights;
+  std::vector<nntrainer::Var_Grad> ins, outs, tensors;
+  nntrainer::RunLayerContext rc;
+
+  /**
+   * @brief finalize the lm head and allocate its tensors
+   */
+  explicit LmHead(const std::vector<std::string> &properties) {
+    layer.setProperty(properties);
+    nntrainer::InitLayerContext ic({nntrainer::TensorDim(1, 1, 1, DIM)},
+                                   {true}, false, "lm_head");
+    layer.finalize(ic);
+
+    /// the lm head weight is shared from the embedding, which initializes it
+    weights.reserve(ic.getWeightsSpec().size());
+    for (auto spec : ic.getWeightsSpec()) {
+      std::get<nntrainer::Initializer>(spec) = nntrainer::Initializer::ZEROS;
+      weights.emplace_back(spec, true);
+    }
+    ins.emplace_back(ic.getInputDimensions()[0], nntrainer::Initializer::NONE,
+                     false, true, "in");
+    outs.emplace_back(ic.getOutSpecs()[0].variable_spec.dim,
+                      nntrainer::Initializer::NONE, false, true, "out");
+    tensors.reserve(ic.getTensorsSpec().size());
+    for (auto &spec : ic.getTensorsSpec())
+      tensors.emplace_back(spec, true);
+
+    std::vector<nntrainer::Weight *> weight_ptrs;
+    for (auto &w : weights)
+      weight_ptrs.push_back(&w);
+    std::vector<nntrainer::Var_Grad *> tensor_ptrs;
+    for (auto &t : tensors)
+      tensor_ptrs.push_back(&t);
+    rc = nntrainer::RunLayerContext("lm_head", false, 0.0f, false, 1.0f,
+                                    nullptr, false, weight_ptrs, {&ins[0]},
+                                    {&outs[0]}, tensor_ptrs);
+  }
+};
+
+/**
+ * @brief rows of the lm head gather around a few topics like word embeddings
+ */
+void fillTopicRows(nntrainer::Tensor &weight, std::mt19937 &rng) {
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+  std::vector<float> topics(TOPICS * DIM);
+  for (auto &t : topics)
+    t = normal(rng);
+  for (unsigned int v = 0; v < VOCAB; ++v)
+    for (unsigned int d = 0; d < DIM; ++d)
+      weight.setValue(0, 0, v, d,
+                      topics[(v % TOPICS) * DIM + d] + 0.1f * normal(rng));
+}
+
+} // namespace
+
+/**
+ * @brief the shortlisted logits keep the argmax of the full lm head, and most
+ * steps are served by the shortlist
+ */
+TEST(TieWordEmbeddingVocabSelection, argmax_matches_full_vocab_p) {
+  LmHead head({"unit=" + std::to_string(VOCAB), "disable_bias=true",
+               "vocab_selection_clusters=32", "vocab_selection_probes=4",
+               "vocab_selection_margin=1.0"});
+  std::mt19937 rng(7);
+  nntrainer::Tensor &weight = head.rc.getWeight(0);
+  fillTopicRows(weight, rng);
+
+  causallm::TieWordEmbedding::buildVocabSelection(head.rc);
+
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+  nntrainer::Tensor &hidden = head.rc.getInput(0);
+  nntrainer::Tensor &logits = head.rc.getOutput(0);
+  unsigned int shortlisted = 0;
+  for (unsigned int step = 0; step < 64; ++step) {
+    /// a hidden state close to one of the rows
+    const unsigned int target = (step * 37) % VOCAB;
+    for (unsigned int d = 0; d < DIM; ++d)
+      hidden.setValue(0, 0, 0, d,
+                      weight.getValue(0, 0, target, d) + 0.3f * normal(rng));
+
+    head.layer.incremental_forwarding(head.rc, 0, 1, false);
+
+    long expected = 0;
+    float best = std::numeric_limits<float>::lowest();
+    for (unsigned int v = 0; v < VOCAB; ++v) {
+      float dot = 0.0f;
+      for (unsigned int d = 0; d < DIM; ++d)
+        dot += hidden.getValue(0, 0, 0, d) * weight.getValue(0, 0, v, d);
+      if (dot > best) {
+        best = dot;
+        expected = v;
+      }
+    }
+
+    const float *out = logits.getData<float>();
+    EXPECT_EQ(std::max_element(out, out + VOCAB) - out, expected)
+      << "step " << step;
+    shortlisted +=
+      std::count(out, out + VOCAB, std::numeric_limits<float>::lowest()) > 0;
+  }
+  EXPECT_GT(shortlisted, 32u);
+}
+
+/**
+ * @brief a shortlisting lm head refuses to run before its index is built
+ */
+TEST(TieWordEmbeddingVocabSelection, index_not_built_n) {
+  LmHead head({"unit=" + std::to_string(VOCAB), "disable_bias=true",
+               "vocab_selection_clusters=32"});
+  EXPECT_THROW(head.layer.incremental_forwarding(head.rc, 0, 1, false),
+               std::runtime_error);
+}
+
+/**
+ * @brief the shortlisting is rejected with a lm head bias
+ */
+TEST(TieWordEmbeddingVocabSelection, bias_n) {
+  EXPECT_THROW(LmHead({"unit=" + std::to_string(VOCAB),
+                       "vocab_selection_clusters=32"}),
+               std::invalid_argument);
+}
+
+/**
+ * @brief Main gtest
+ */
+int main(int argc, char **argv) {
+  int result = -1;
+
+  try {
+    testing::InitGoogleTest(&argc, argv);
+  } catch (...) {
+    std::cerr << "Error during InitGoogleTest" << std::endl;
+    return 0;
+  }
+
+  try {
+    result = RUN_ALL_TESTS();
+  } catch (...) {
+    std::cerr << "Error during RUN_ALL_TESTS()" << std::endl;
+  }
+
+  return result;
+}
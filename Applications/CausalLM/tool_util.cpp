@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   tool_util.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Helpers shared by the CausalLM benchmark and quantize tools
+ */
+
+#include <tool_util.h>
+
+#include "json.hpp"
+#include <factory.h>
+
+#include "causal_lm.h"
+#include "gptoss_causallm.h"
+#include "qwen3_causallm.h"
+#include "qwen3_moe_causallm.h"
+
+namespace causallm {
+
+void registerInMemoryModels() {
+  auto &factory = Factory::Instance();
+  factory.registerModel(
+    "LlamaForCausalLM", [](json cfg, json generation_cfg, json nntr_cfg) {
+      return std::make_unique<CausalLM>(cfg, generation_cfg, nntr_cfg);
+    });
+  factory.registerModel(
+    "Qwen3ForCausalLM", [](json cfg, json generation_cfg, json nntr_cfg) {
+      return std::make_unique<Qwen3CausalLM>(cfg, generation_cfg, nntr_cfg);
+    });
+  factory.registerModel(
+    "Qwen3MoeForCausalLM", [](json cfg, json generation_cfg, json nntr_cfg) {
+      return std::make_unique<Qwen3MoECausalLM>(cfg, generation_cfg, nntr_cfg);
+    });
+  factory.registerModel(
+    "GptOssForCausalLM", [](json cfg, json generation_cfg, json nntr_cfg) {
+      return std::make_unique<GptOssForCausalLM>(cfg, generation_cfg,
+                                                 nntr_cfg);
+    });
+}
+
+double elapsedMs(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace causallm
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   tool_util.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Helpers shared by the CausalLM benchmark and quantize tools
+ */
+
+#ifndef __CAUSALLM_TOOL_UTIL_H__
+#define __CAUSALLM_TOOL_UTIL_H__
+
+#include <chrono>
+
+namespace causallm {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief register the architectures that keep every weight in memory. The
+ * slim and cached MoE variants read their experts from the weight file on
+ * demand and share the weight file of their base model, so they are left out.
+ */
+void registerInMemoryModels();
+
+/**
+ * @brief milliseconds between two time points
+ */
+double elapsedMs(Clock::time_point from, Clock::time_point to);
+
+} // namespace causallm
+
+#endif /* __CAUSALLM_TOOL_UTIL_H__ */
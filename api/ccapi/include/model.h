@@ -93,7 +93,10 @@ for inference and training without any configurations*/
     ML_TRAIN_MODEL_FORMAT_FLATBUFFER,             /**< flatbuffer file */
   MODEL_FORMAT_ONNX = ML_TRAIN_MODEL_FORMAT_ONNX, /**< ONNX file */
 
-  MODEL_FORMAT_QNN = ML_TRAIN_MODEL_FORMAT_QNN /**< qnn binary file */
+  MODEL_FORMAT_QNN = ML_TRAIN_MODEL_FORMAT_QNN, /**< qnn binary file */
+  MODEL_FORMAT_WEIGHT_CONTAINER =
+    ML_TRAIN_MODEL_FORMAT_WEIGHT_CONTAINER /**< indexed weight file with
+                                              aligned payloads */
 };
 
 /**
@@ -170,6 +173,7 @@ public:
    * @param file_path file_path to save the model, if full path is not
    * given, it should be saved inside working directory
    * @param format format to save parameters
+   * @note MODEL_FORMAT_BIN also loads a weight container file
    */
   virtual void load(const std::string &file_path,
                     ModelFormat format = ModelFormat::MODEL_FORMAT_BIN) = 0;
@@ -294,7 +298,8 @@ public:
   /**
    * @brief     Run the inference of the model
    * @param[in] batch batch size of current input
-   * @param[in] input inputs as a list of each input data
+   * @param[in] input inputs as a list of each input data, the buffer of a
+   * UINT32 input (tensor_dtype=uint32 input layer) holds unsigned int data
    * @param[in] label labels as a list of each label data
    * @retval list of output as float *
    * @note The output memory must not be freed by the caller
@@ -306,7 +311,8 @@ public:
   /**
    * @brief     Run the incremental inference of the model
    * @param[in] batch batch size of current input
-   * @param[in] input inputs as a list of each input data
+   * @param[in] input inputs as a list of each input data, the buffer of a
+   * UINT32 input (tensor_dtype=uint32 input layer) holds unsigned int data
    * @param[in] label labels as a list of each label data
    * @param[in] init_seq_len initial sequence length
    * @param[in] from current working step index
@@ -322,6 +328,27 @@ public:
                         unsigned int init_seq_len, unsigned int from,
                         unsigned int to, bool output_hidden_state = false) = 0;
 
+  /**
+   * @brief     Run the incremental inference of the model into caller buffers
+   * @param[in] batch batch size of current input
+   * @param[in] input inputs as a list of each input data, the buffer of a
+   * UINT32 input (tensor_dtype=uint32 input layer) holds unsigned int data
+   * @param[in] label labels as a list of each label data
+   * @param[out] output a buffer of batch * width floats for each output, which
+   * gets the output of the last step
+   * @param[in] init_seq_len initial sequence length
+   * @param[in] from current working step index
+   * @param[in] to next working step index
+   * @note No memory is allocated for the outputs, so the buffers can be reused
+   * for every step
+   */
+  virtual void incremental_inference(unsigned int batch,
+                                     const std::vector<float *> &input,
+                                     const std::vector<float *> &label,
+                                     const std::vector<float *> &output,
+                                     unsigned int init_seq_len,
+                                     unsigned int from, unsigned int to) = 0;
+
   /**
    * @brief     reset input dimensions of a model
    * @param[in] dims input dimensions
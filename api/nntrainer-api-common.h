@@ -277,7 +277,10 @@ typedef enum {
   ML_TRAIN_MODEL_FORMAT_ONNX =
     4, /**< QNNX binary format file saves model configurations and weights. */
   ML_TRAIN_MODEL_FORMAT_QNN =
-    5 /**< QNN binary format file saves model configurations and weights. */
+    5, /**< QNN binary format file saves model configurations and weights. */
+  ML_TRAIN_MODEL_FORMAT_WEIGHT_CONTAINER =
+    6 /**< Weight file with a tensor index and aligned payloads, which can be
+         used in place from the mapped file for inference. */
 } ml_train_model_format_e;
 
 /**
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   memory_planner_benchmark.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Replays recorded memory requests through every memory planner and
+ * reports the planned pool size against the theoretical lower bound
+ *
+ * @note   Request files are written by MemoryPool::planLayout() of any
+ * nntrainer application run with NNTR_MEMORY_REQUEST_DUMP=<dir>, or by the
+ * --record mode of this tool for ini models.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <basic_planner.h>
+#include <memory_pool.h>
+#include <model.h>
+#include <optimal_fit_planner.h>
+#include <optimized_v1_planner.h>
+#include <optimized_v2_planner.h>
+#include <optimized_v3_planner.h>
+
+namespace {
+
+/**
+ * @brief print usage of the tool
+ */
+void printUsage(const char *prog) {
+  std::cerr << "usage: " << prog << " <request file>...\n"
+            << "       " << prog << " --record <model.ini> <output dir>\n";
+}
+
+/**
+ * @brief build an ini model so that every memory pool writes its requests to
+ * dir
+ */
+int record(const std::string &ini, const std::string &dir) {
+#if defined(_WIN32)
+  _putenv_s("NNTR_MEMORY_REQUEST_DUMP", dir.c_str());
+#else
+  setenv("NNTR_MEMORY_REQUEST_DUMP", dir.c_str(), 1);
+#endif
+
+  try {
+    auto model = ml::train::createModel(ml::train::ModelType::NEURAL_NET);
+    model->load(ini, ml::train::ModelFormat::MODEL_FORMAT_INI);
+    model->compile();
+    model->initialize();
+    model->allocate();
+  } catch (std::exception &e) {
+    std::cerr << "failed to build " << ini << ": " << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "requests of " << ini << " are written to " << dir << '\n';
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief plan the requests of a file with every planner and print one row
+ * per planner
+ */
+bool replay(const std::string &path) {
+  const std::vector<std::shared_ptr<nntrainer::MemoryPlanner>> planners = {
+    std::make_shared<nntrainer::BasicPlanner>(),
+    std::make_shared<nntrainer::OptimizedV1Planner>(),
+    std::make_shared<nntrainer::OptimizedV2Planner>(),
+    std::make_shared<nntrainer::OptimizedV3Planner>(),
+    std::make_shared<nntrainer::OptimalFitPlanner>(),
+  };
+
+  bool ok = true;
+  for (auto &planner : planners) {
+    nntrainer::MemoryPool pool;
+    std::cout << std::left << std::setw(40) << path << std::setw(24)
+              << planner->getType();
+    try {
+      pool.loadRequests(path);
+      const auto begin = std::chrono::steady_clock::now();
+      const double efficiency = pool.planLayout(*planner);
+      const auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count();
+
+      std::cout << std::right << std::setw(14) << pool.size() << std::setw(14)
+                << pool.minMemoryRequirement() << std::setw(10) << std::fixed
+                << std::setprecision(3) << 1.0 / efficiency << std::setw(12)
+                << us << '\n';
+    } catch (std::exception &e) {
+      std::cout << "failed: " << e.what() << '\n';
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+} // namespace
+
+/**
+ * @brief main of the memory planner benchmark
+ */
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (std::string(argv[1]) == "--record") {
+    if (argc != 4) {
+      printUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    return record(argv[2], argv[3]);
+  }
+
+  std::cout << std::left << std::setw(40) << "requests" << std::setw(24)
+            << "planner" << std::right << std::setw(14) << "peak bytes"
+            << std::setw(14) << "lower bound" << std::setw(10) << "ratio"
+            << std::setw(12) << "plan us" << '\n';
+
+  bool ok = true;
+  for (int i = 1; i < argc; ++i)
+    ok = replay(argv[i]) && ok;
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
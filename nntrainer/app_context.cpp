@@ -57,6 +57,7 @@
 #include <identity_layer.h>
 #include <input_layer.h>
 #include <layer_normalization_layer.h>
+#include <linear_cross_entropy_loss_layer.h>
 #include <lr_scheduler_constant.h>
 #include <lr_scheduler_cosine.h>
 #include <lr_scheduler_exponential.h>
@@ -409,6 +410,9 @@ void AppContext::add_default_object() {
   registerFactory(nntrainer::createLayer<ConstantDerivativeLossLayer>,
                   ConstantDerivativeLossLayer::type,
                   LayerType::LAYER_LOSS_CONSTANT_DERIVATIVE);
+  /// the fused loss is created by its type string only
+  registerFactory(nntrainer::createLayer<LinearCrossEntropyLossLayer>,
+                  LinearCrossEntropyLossLayer::type);
 
   registerFactory(nntrainer::createLayer<TimeDistLayer>, TimeDistLayer::type,
                   LayerType::LAYER_TIME_DIST);
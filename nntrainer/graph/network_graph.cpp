@@ -20,13 +20,16 @@
 #include <cross_entropy_loss_layer.h>
 #include <cross_entropy_sigmoid_loss_layer.h>
 #include <cross_entropy_softmax_loss_layer.h>
+#include <dropout.h>
 #include <engine.h>
 #include <flatten_layer.h>
+#include <gru.h>
 #include <grucell.h>
 #include <identity_layer.h>
 #include <input_layer.h>
 #include <layer_node.h>
 #include <layer_normalization_layer.h>
+#include <lstm.h>
 #include <lstmcell.h>
 #include <multiout_layer.h>
 #include <network_graph.h>
@@ -41,9 +44,12 @@
 #include <tracer.h>
 #include <util_func.h>
 #include <weight_layer.h>
+#include <zoneout_lstmcell.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 #include <string>
 
@@ -395,11 +401,26 @@ sharedConstTensors NetworkGraph::forwarding(
   bool training,
   std::function<void(std::shared_ptr<LayerNode>, bool)> forwarding_op,
   std::function<bool(void *userdata)> stop_cb, void *userdata) {
+  /**
+   * recomputed and offloaded activations are written to their forward memory
+   * first
+   */
+  if (!recompute_segments.empty() || num_offloaded > 0)
+    tensor_manager->bindForwardMemory();
+
+  const bool offload = training && num_offloaded > 0;
   for (auto iter = cbegin(); iter != cend() && !stop_cb(userdata); iter++) {
     auto &ln = *iter;
+    const unsigned int order = std::get<0>(ln->getExecutionOrder());
+    if (offload)
+      tensor_manager->offloadBefore(order);
+
     PROFILE_TIME_START(profile_keys.at(ln->getType()));
     forwarding_op(*iter, training);
     PROFILE_TIME_END(profile_keys.at(ln->getType()));
+
+    if (offload)
+      tensor_manager->offloadAfter(order);
   }
 
   sharedConstTensors out;
@@ -466,6 +487,23 @@ bool NetworkGraph::backwarding(
 
   for (iter_ = iter_begin; iter_ != iter_end && !stop_cb(userdata); iter_++) {
     auto &ln = *iter_;
+    if (auto seg = recompute_segments.find(ln.get());
+        seg != recompute_segments.end()) {
+      tensor_manager->bindRecomputeMemory(seg->second.order);
+      for (auto &node : seg->second.nodes) {
+        PROFILE_TIME_START(profile_keys.at(node->getType()));
+        forwarding_op(node, true);
+        PROFILE_TIME_END(profile_keys.at(node->getType()));
+      }
+    }
+
+    if (num_offloaded > 0) {
+      auto const &order = ln->getExecutionOrder();
+      tensor_manager->offloadBefore(std::get<1>(order));
+      tensor_manager->offloadBefore(std::get<2>(order));
+      tensor_manager->offloadBefore(std::get<3>(order));
+    }
+
     PROFILE_TIME_START(profile_keys.at(ln->getType()));
     is_valid = backwarding_op(ln, iteration);
     PROFILE_TIME_END(profile_keys.at(ln->getType()));
@@ -1385,9 +1423,232 @@ int NetworkGraph::initialize(ExecutionMode mode,
       break;
     }
   }
+
+  planRecompute();
+  planOffload();
   return ML_ERROR_NONE;
 }
 
+void NetworkGraph::planRecompute() {
+  recompute_segments.clear();
+  if (exec_mode != ExecutionMode::TRAIN || backward_iter_end == nullptr)
+    return;
+
+  /** forwarding of these layers is random or updates running statistics */
+  static const std::vector<std::string> stateful_types = {
+    BatchNormalizationLayer::type, DropOutLayer::type,
+    LSTMLayer::type,               GRULayer::type,
+    RNNLayer::type,                LSTMCellLayer::type,
+    GRUCellLayer::type,            RNNCellLayer::type,
+    ZoneoutLSTMCellLayer::type};
+
+  const unsigned int backward_begin =
+    graph.getSortedNodeIdx(backward_iter_end->getName());
+  auto is_eligible = [&](const LayerNode *node) {
+    return !node->getInputConnections().empty() && !node->requireLabel() &&
+           node->getInPlaceType() == InPlaceType::NONE &&
+           std::find(stateful_types.begin(), stateful_types.end(),
+                     node->getType()) == stateful_types.end();
+  };
+
+  /** 1. form segments of consecutive layers */
+  std::vector<std::vector<std::shared_ptr<LayerNode>>> segments(1);
+  unsigned int eligible = 0;
+  for (unsigned int idx = backward_begin; idx < graph.size(); ++idx) {
+    if (is_eligible(getSortedLayerNode(idx).get()))
+      eligible++;
+  }
+  const unsigned int segment_size =
+    std::max(1u, static_cast<unsigned int>(std::ceil(std::sqrt(eligible))));
+
+  for (unsigned int idx = backward_begin; idx < graph.size(); ++idx) {
+    auto node = getSortedLayerNode(idx);
+    bool recompute = auto_recompute || node->getRecompute();
+    if (recompute && !is_eligible(node.get())) {
+      if (node->getRecompute())
+        ml_logw("activations of %s (%s) cannot be recomputed, kept instead",
+                node->getName().c_str(), node->getType().c_str());
+      recompute = false;
+    }
+
+    const bool segment_full =
+      auto_recompute && segments.back().size() == segment_size;
+    if ((!recompute || segment_full) && !segments.back().empty())
+      segments.emplace_back();
+    if (recompute)
+      segments.back().push_back(node);
+  }
+  if (segments.back().empty())
+    segments.pop_back();
+
+  if (segments.empty())
+    return;
+
+  if (isMixedPrecision() || tensor_manager->isFsuEnabled()) {
+    ml_logw("activation recompute is not supported with mixed precision or "
+            "fsu, activations are kept");
+    return;
+  }
+
+  /** 2. drop the activations used only by the segment in forwarding */
+  const unsigned int backward_start = graph.size();
+  for (auto &segment : segments) {
+    const unsigned int forward_begin =
+      std::get<0>(segment.front()->getExecutionOrder());
+    const unsigned int forward_end =
+      std::get<0>(segment.back()->getExecutionOrder());
+
+    std::vector<std::string> written, read;
+    for (auto &node : segment) {
+      auto &rc = node->getRunContext();
+      for (unsigned int i = 0; i < rc.getNumOutputs(); ++i)
+        written.push_back(rc.getOutput(i).getName());
+      for (unsigned int i = 0; i < rc.getNumTensors(); ++i)
+        written.push_back(rc.getTensor(i).getName());
+      for (unsigned int i = 0; i < rc.getNumInputs(); ++i)
+        read.push_back(rc.getInput(i).getName());
+    }
+
+    unsigned int order = std::numeric_limits<unsigned int>::max();
+    std::vector<bool> split(written.size(), false);
+    for (unsigned int i = 0; i < written.size(); ++i) {
+      auto exec_order =
+        tensor_manager->getTensorExecutionOrders(written[i], false);
+      bool forward_use = false;
+      bool outside = false;
+      unsigned int first_backward = std::numeric_limits<unsigned int>::max();
+      for (auto o : exec_order) {
+        if (o >= backward_start)
+          first_backward = std::min(first_backward, o);
+        else if (o < forward_begin || o > forward_end)
+          outside = true;
+        else
+          forward_use = true;
+      }
+      split[i] = forward_use && !outside;
+      if (split[i])
+        order = std::min(order, first_backward);
+    }
+
+    if (order == std::numeric_limits<unsigned int>::max()) {
+      ml_logd("segment from %s keeps no activation, not recomputed",
+              segment.front()->getName().c_str());
+      continue;
+    }
+
+    /** recompute right before the backwarding which needs it first */
+    LayerNode *recompute_at = nullptr;
+    for (auto &node : segment) {
+      auto const &exec_order = node->getExecutionOrder();
+      if (std::get<1>(exec_order) <= order &&
+          order <= std::get<3>(exec_order)) {
+        recompute_at = node.get();
+        order = std::get<1>(exec_order);
+        break;
+      }
+    }
+    NNTR_THROW_IF(recompute_at == nullptr, std::runtime_error)
+      << "activation recompute: no backwarding of the segment from "
+      << segment.front()->getName() << " uses its activations";
+
+    for (unsigned int i = 0; i < written.size(); ++i) {
+      if (!tensor_manager->getTensorExecutionOrders(written[i], false).empty())
+        tensor_manager->requestRecompute(written[i], order, split[i]);
+    }
+    for (auto &name : read) {
+      if (!tensor_manager->getTensorExecutionOrders(name, false).empty())
+        tensor_manager->requestRecompute(name, order, false);
+    }
+
+    ml_logi("activations of %zu layers from %s are recomputed before "
+            "backwarding %s",
+            segment.size(), segment.front()->getName().c_str(),
+            recompute_at->getName().c_str());
+    recompute_segments[recompute_at] = {order, segment};
+  }
+}
+
+void NetworkGraph::planOffload() {
+  num_offloaded = 0;
+  if (!activation_offload || exec_mode != ExecutionMode::TRAIN ||
+      backward_iter_end == nullptr)
+    return;
+
+  if (isMixedPrecision() || tensor_manager->isFsuEnabled()) {
+    ml_logw("activation offload is not supported with mixed precision or "
+            "fsu, activations are kept");
+    return;
+  }
+
+  /** layers in the order of backwarding */
+  std::vector<const LayerNode *> backward_nodes;
+  for (auto iter = getBackwardingBeginIter(); iter != getBackwardingEndIter();
+       ++iter)
+    backward_nodes.push_back((*iter).get());
+
+  const unsigned int backward_begin =
+    graph.getSortedNodeIdx(backward_iter_end->getName());
+  const unsigned int backward_start = graph.size();
+  for (unsigned int idx = backward_begin; idx < graph.size(); ++idx) {
+    auto node = getSortedLayerNode(idx);
+    if (node->getInputConnections().empty() || node->requireLabel())
+      continue;
+
+    auto &rc = node->getRunContext();
+    std::vector<const Tensor *> written;
+    for (unsigned int i = 0; i < rc.getNumOutputs(); ++i)
+      written.push_back(&rc.getOutput(i));
+    for (unsigned int i = 0; i < rc.getNumTensors(); ++i)
+      written.push_back(&rc.getTensor(i));
+
+    for (auto tensor : written) {
+      if (tensor->bytes() < offload_min_size)
+        continue;
+
+      auto exec_order =
+        tensor_manager->getTensorExecutionOrders(tensor->getName(), false);
+      unsigned int last_forward = 0;
+      unsigned int first_backward = std::numeric_limits<unsigned int>::max();
+      bool forward_use = false;
+      for (auto o : exec_order) {
+        if (o < backward_start) {
+          last_forward = std::max(last_forward, o);
+          forward_use = true;
+        } else {
+          first_backward = std::min(first_backward, o);
+        }
+      }
+      if (!forward_use ||
+          first_backward == std::numeric_limits<unsigned int>::max())
+        continue;
+
+      /** read back offload_lookahead layers before the first backwarding */
+      auto user = std::find_if(
+        backward_nodes.begin(), backward_nodes.end(), [&](const LayerNode *n) {
+          auto const &order = n->getExecutionOrder();
+          return std::get<1>(order) <= first_backward &&
+                 first_backward <= std::get<3>(order);
+        });
+      if (user == backward_nodes.end())
+        continue;
+
+      auto load_at =
+        user - std::min<ptrdiff_t>(std::max(1u, offload_lookahead),
+                                   user - backward_nodes.begin());
+      const unsigned int load_order =
+        std::get<1>((*load_at)->getExecutionOrder());
+      if (load_order < last_forward + 2)
+        continue;
+
+      if (tensor_manager->requestOffload(tensor->getName(), load_order))
+        num_offloaded++;
+    }
+  }
+
+  if (num_offloaded > 0)
+    ml_logi("%u activations are offloaded in training", num_offloaded);
+}
+
 int NetworkGraph::reinitialize(
   const std::vector<Connection> &model_input_names,
   const std::vector<Connection> &model_label_names) {
@@ -1573,6 +1834,8 @@ int NetworkGraph::reinitialize(
   identify_external_tensors(model_label_names, is_label_node,
                             identify_as_model_label);
 
+  planRecompute();
+  planOffload();
   return ML_ERROR_NONE;
 }
 
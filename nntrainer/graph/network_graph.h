@@ -19,6 +19,7 @@
 #include <map>
 #include <memory>
 #include <stack>
+#include <unordered_map>
 #include <vector>
 
 #include <graph_core.h>
@@ -47,6 +48,11 @@ public:
     backward_iter_end(nullptr),
     forward_iter_end(nullptr),
     optimize_memory(true),
+    auto_recompute(false),
+    activation_offload(false),
+    offload_min_size(0),
+    offload_lookahead(0),
+    num_offloaded(0),
     exec_mode(ExecutionMode::TRAIN),
     tensor_format("NCHW"),
     tensor_dtype(split("FP32-FP32", getRegex("\\-"))),
@@ -78,6 +84,11 @@ public:
     backward_iter_end(nullptr),
     forward_iter_end(nullptr),
     optimize_memory(true),
+    auto_recompute(false),
+    activation_offload(false),
+    offload_min_size(0),
+    offload_lookahead(0),
+    num_offloaded(0),
     exec_mode(mode),
     tensor_format(tensor_format_),
     tensor_dtype(split(tensor_dtype_, getRegex("\\-"))),
@@ -410,6 +421,30 @@ public:
     optimize_memory = val;
   }
 
+  /**
+   * @brief     Recompute activations of every eligible layer in backwarding,
+   * in segments of sqrt(number of layers) layers
+   *
+   * @param val true to enable, else false
+   */
+  void setAutoRecompute(bool val) { auto_recompute = val; }
+
+  /**
+   * @brief     Offload large activations to the swap device between their
+   * forwarding and backwarding uses in training
+   *
+   * @param val true to enable, else false
+   * @param min_size smallest activation in bytes to offload
+   * @param lookahead number of layers, at least one, the read back is started
+   * before the backwarding which needs the activation
+   */
+  void setActivationOffload(bool val, unsigned int min_size,
+                            unsigned int lookahead) {
+    activation_offload = val;
+    offload_min_size = min_size;
+    offload_lookahead = lookahead;
+  }
+
   /**
    * @brief     Create optimizer variable for every weights
    *
@@ -542,6 +577,17 @@ public:
     tensor_manager->setWeightOffset(offsets);
   }
 
+  /**
+   * @brief bind a weight and its views to an external buffer
+   *
+   * @param name weight name
+   * @param mem buffer holding the weight
+   */
+  void bindWeightMemory(const std::string &name,
+                        std::shared_ptr<MemoryData> mem) {
+    tensor_manager->bindWeightMemory(name, mem);
+  }
+
 private:
   std::map<std::string, std::string> sub_in_out; /** This is map to identify
                  input and output layer name of subgraph */
@@ -568,6 +614,11 @@ private:
   std::vector<TensorDim> input_dims_;   /**< graph input dimensions */
 
   bool optimize_memory;    /**< optimize memory */
+  bool auto_recompute;     /**< recompute activations of sqrt(N) segments */
+  bool activation_offload; /**< offload activations to the swap device */
+  unsigned int offload_min_size;  /**< smallest offloaded activation */
+  unsigned int offload_lookahead; /**< layers a read back starts early */
+  unsigned int num_offloaded;     /**< number of offloaded activations */
   ExecutionMode exec_mode; /**< execution mode with which the graph has been
                             currently set or previously set */
 
@@ -584,6 +635,39 @@ private:
   float loss_scale;
   unsigned int nan_count;
 
+  /**
+   * @brief layers forwarded again before the backwarding of a node
+   */
+  struct RecomputeSegment {
+    unsigned int order; /**< execution order the segment is recomputed at */
+    std::vector<std::shared_ptr<LayerNode>> nodes; /**< layers in the sorted
+                                                      order */
+  };
+  std::unordered_map<const LayerNode *, RecomputeSegment>
+    recompute_segments; /**< segments keyed by the node they are recomputed
+                           before */
+
+  /**
+   * @brief     plan the recomputation of activations in backwarding
+   * @details   consecutive layers marked with recompute, or every sqrt(N)
+   * eligible layers with auto_recompute, form a segment. Activations used only
+   * by the segment in forwarding are dropped after forwarding; the segment is
+   * forwarded again right before the first backwarding which needs one of
+   * them. The execution orders of the tensors are updated so that the memory
+   * planner sees the shortened lifespans.
+   */
+  void planRecompute();
+
+  /**
+   * @brief     plan the offload of activations in training
+   * @details   an output or tensor of a layer which is used in forwarding and
+   * again in backwarding is written to the swap device after its last forward
+   * use and read back offload_lookahead layers before the backwarding which
+   * needs it first, if it is at least offload_min_size bytes. Its memory is
+   * free in between.
+   */
+  void planOffload();
+
   /**
    * @brief     topological sort
    * @param[in] ith index of LayerNode
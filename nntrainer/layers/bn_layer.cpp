@@ -21,9 +21,12 @@
  *
  */
 
+#include <array>
+#include <vector>
+
 #include <bn_layer.h>
+#include <cpu_backend.h>
 #include <layer_context.h>
-#include <lazy_tensor.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
@@ -33,23 +36,108 @@ namespace nntrainer {
 
 static constexpr size_t SINGLE_INOUT_IDX = 0;
 
-enum BNParams {
-  mu,
-  var,
-  gamma,
-  beta,
-  mu_b,
-  var_b,
-  deviation,
-  invstd,
-  cvar,
-  t_reduced,
-  t_full
-};
+enum BNParams { mu, var, gamma, beta, mu_b, var_b, x_hat, invstd };
+
+namespace {
+
+/**
+ * @brief view a row major tensor as (outer, len, inner) in memory order where
+ * len is the size of the normalized axis
+ */
+void getChannelView(const TensorDim &dim, unsigned int axis,
+                    unsigned int &outer, unsigned int &inner) {
+  const std::array<unsigned int, 4> order =
+    dim.getFormat() == TensorDim::Format::NHWC
+      ? std::array<unsigned int, 4>{0, 2, 3, 1}
+      : std::array<unsigned int, 4>{0, 1, 2, 3};
+  outer = 1;
+  inner = 1;
+  bool after_axis = false;
+  for (unsigned int d : order) {
+    if (d == axis)
+      after_axis = true;
+    else if (after_axis)
+      inner *= dim.getTensorDim(d);
+    else
+      outer *= dim.getTensorDim(d);
+  }
+}
+
+/**
+ * @brief mean and population variance of every channel of a (outer, len,
+ * inner) view in one pass over the data. reduce_mean_var runs Welford over
+ * the rows of the channels, or over blocks of outer slices when the rows are
+ * short, and the partial states are merged per channel.
+ */
+void channelMeanVar(RunLayerContext &context, unsigned int outer,
+                    unsigned int len, unsigned int inner, const float *x,
+                    float *mean, float *var) {
+  static constexpr unsigned int min_row = 8;
+  static constexpr unsigned int block_rows = 64;
+
+  const bool by_row = inner >= min_row;
+  const unsigned int blocks = outer / block_rows;
+  const unsigned int rest = outer % block_rows;
+  const unsigned int groups = by_row ? outer : blocks + (rest ? 1 : 0);
+  const unsigned int cols = by_row ? 1 : inner;
+  const size_t block_out = (size_t)len * inner;
+
+  TensorDim dim(1, 1, 1, (size_t)groups * len * cols);
+  Tensor partial_mean = context.getScratchTensor(dim);
+  Tensor partial_var = context.getScratchTensor(dim);
+  float *pm = partial_mean.getData<float>();
+  float *pv = partial_var.getData<float>();
+
+  if (by_row) {
+    reduce_mean_var(outer * len, inner, 1, x, pm, pv);
+  } else {
+    if (blocks)
+      reduce_mean_var(blocks, block_rows, block_out, x, pm, pv);
+    if (rest)
+      reduce_mean_var(1, rest, block_out,
+                      x + (size_t)blocks * block_rows * block_out,
+                      pm + blocks * block_out, pv + blocks * block_out);
+  }
+
+  /// merge the partial states (n_g, mean_g, var_g) of every channel
+  for (unsigned int l = 0; l < len; ++l) {
+    float n = 0.0f, m = 0.0f, m2 = 0.0f;
+    for (unsigned int g = 0; g < groups; ++g) {
+      const float n_g = by_row ? inner : (g < blocks ? block_rows : rest);
+      for (unsigned int i = 0; i < cols; ++i) {
+        const size_t idx = ((size_t)g * len + l) * cols + i;
+        const float total = n + n_g;
+        const float delta = pm[idx] - m;
+        m += delta * n_g / total;
+        m2 += n_g * pv[idx] + delta * delta * n * n_g / total;
+        n = total;
+      }
+    }
+    mean[l] = m;
+    var[l] = m2 / n;
+  }
+}
+
+/**
+ * @brief full precision tensor of the given tensor, other data types are
+ * copied to a scratch tensor
+ */
+Tensor getFP32(RunLayerContext &context, const Tensor &t) {
+  if (t.getDataType() == TensorDim::DataType::FP32)
+    return t;
+
+  TensorDim dim = t.getDim();
+  dim.setDataType(TensorDim::DataType::FP32);
+  Tensor t32 = context.getScratchTensor(dim);
+  t32.copyData(t);
+  return t32;
+}
+
+} // namespace
 
 BatchNormalizationLayer::BatchNormalizationLayer() :
   Layer(),
-  divider(0),
+  axis(1),
   bn_props(props::Epsilon(), props::MuInitializer(), props::VarInitializer(),
            props::BetaInitializer(), props::GammaInitializer(),
            props::Momentum(), props::Axis(), props::WeightDecay(),
@@ -75,35 +163,25 @@ void BatchNormalizationLayer::finalize(InitLayerContext &context) {
 
   TensorDim dim(context.getFormat(), context.getWeightDataType());
 
-  if (context.getExecutionMode() == ml::train::ExecutionMode::TRAIN) {
+  const bool train =
+    context.getExecutionMode() == ml::train::ExecutionMode::TRAIN;
+  if (train) {
     dim.setDataType(TensorDim::DataType::FP32);
   }
 
   /// @note this logic cannot tell channel is actually 1 or it is just not used.
   auto &axis_prop = std::get<props::Axis>(bn_props);
-  unsigned int axis;
   if (axis_prop.empty())
     axis = in_dim.channel() > 1 ? 1 : 3;
   else
     axis = axis_prop.get();
 
   /**
-   * @todo This can be speedup by employing transpose for convolution. With
-   * transpose, the channel dimension can be made last, and the remaining
-   * dimensions can be squeezed. This would allow the sum and average to be
-   * faster, and no temporary allocations inside them.
+   * The data is viewed as (outer, channel, inner) in memory order, so the
+   * statistics of NCHW and NHWC tensors are reduced without a transpose.
    */
-
   dim.setTensorDim(axis, in_dim.getTensorDim(axis));
 
-  divider = 1;
-  for (unsigned int i = 0; i < 4; ++i) {
-    if (axis != i) {
-      axes_to_reduce.push_back(i);
-      divider *= in_dim.getTensorDim(i);
-    }
-  }
-
   wt_idx[BNParams::mu] =
     context.requestWeight(dim, dim, bnparams_mu, WeightRegularizer::NONE, 1.0f,
                           0.0f, "moving_mean", false);
@@ -117,6 +195,10 @@ void BatchNormalizationLayer::finalize(InitLayerContext &context) {
     context.requestWeight(dim, dim, bnparams_beta, WeightRegularizer::NONE,
                           1.0f, bias_decay, "beta", true);
 
+  /** inference only needs the folded scale and shift of the weights */
+  if (!train)
+    return;
+
   wt_idx[BNParams::mu_b] =
     context.requestTensor(dim, "moviing_mean_backup", Initializer::NONE, false,
                           TensorLifespan::ITERATION_LIFESPAN);
@@ -126,43 +208,19 @@ void BatchNormalizationLayer::finalize(InitLayerContext &context) {
                           false, TensorLifespan::ITERATION_LIFESPAN);
 
   /**
-   * caches the deviation -> input - avg(input)
-   * @todo check if avoiding this storage and adding dependency on input (no
-   * more in-place calculation) can save memory during memory optimization.
+   * caches the normalized input -> (input - avg(input)) * invstd, which lets
+   * the layer run in-place as the input is not kept for the backwarding.
    */
   TensorDim in_dim_ = in_dim;
+  in_dim_.setDataType(TensorDim::DataType::FP32);
 
-  if (context.getExecutionMode() == ml::train::ExecutionMode::TRAIN) {
-    in_dim_.setDataType(TensorDim::DataType::FP32);
-  }
-
-  wt_idx[BNParams::deviation] =
-    context.requestTensor(in_dim_, "deviation", Initializer::NONE, false,
+  wt_idx[BNParams::x_hat] =
+    context.requestTensor(in_dim_, "normalized", Initializer::NONE, false,
                           TensorLifespan::ITERATION_LIFESPAN);
   /** caches the inverse standard deviation */
   wt_idx[BNParams::invstd] =
     context.requestTensor(dim, "invstd", Initializer::NONE, false,
                           TensorLifespan::ITERATION_LIFESPAN);
-  /**
-   * Temporary tensor to store the full sized tensors in order to allow batch
-   * norm to execute in-place. Running in-place leads to same memory footprint
-   * for this layer in its backwarding, but reduces the peak memory requirement
-   * as the output of this layer need not be stored all the time.
-   */
-  wt_idx[BNParams::t_full] =
-    context.requestTensor(in_dim_, "tensor_full", Initializer::NONE, false,
-                          TensorLifespan::CALC_DERIV_LIFESPAN);
-  /**
-   * caches variance + epsilon as well.
-   */
-  wt_idx[BNParams::cvar] = context.requestTensor(
-    dim, "cvar", Initializer::NONE, false, TensorLifespan::ITERATION_LIFESPAN);
-  /**
-   * Temporary tensor to store the reduced tensors along the axes_to_reduce.
-   */
-  wt_idx[BNParams::t_reduced] =
-    context.requestTensor(dim, "tensor_reduced", Initializer::NONE, false,
-                          TensorLifespan::FORWARD_DERIV_LIFESPAN);
 }
 
 void BatchNormalizationLayer::setProperty(
@@ -183,174 +241,143 @@ void BatchNormalizationLayer::forwarding(RunLayerContext &context,
   Tensor &gamma = context.getWeight(wt_idx[BNParams::gamma]);
   Tensor &beta = context.getWeight(wt_idx[BNParams::beta]);
 
-  Tensor em_input, em_hidden;
-
-  Tensor &input_ = em_input;
-  Tensor &hidden_ = em_hidden;
-
-  if (training) {
-    if (context.getInput(SINGLE_INOUT_IDX).getDataType() !=
-        TensorDim::DataType::FP32) {
-      input_ =
-        context.getInput(SINGLE_INOUT_IDX).clone(TensorDim::DataType::FP32);
-    } else {
-      input_ = context.getInput(SINGLE_INOUT_IDX);
-    }
-
-    if (context.getOutput(SINGLE_INOUT_IDX).getDataType() !=
-        TensorDim::DataType::FP32) {
-      hidden_ =
-        context.getOutput(SINGLE_INOUT_IDX).clone(TensorDim::DataType::FP32);
-    } else {
-      hidden_ = context.getOutput(SINGLE_INOUT_IDX);
-    }
-  } else {
-    input_ = context.getInput(SINGLE_INOUT_IDX);
-    hidden_ = context.getOutput(SINGLE_INOUT_IDX);
+  Tensor &input = context.getInput(SINGLE_INOUT_IDX);
+  Tensor &output = context.getOutput(SINGLE_INOUT_IDX);
+
+  if (gamma.getDataType() != TensorDim::DataType::FP32) {
+    NNTR_THROW_IF(training, std::invalid_argument)
+      << "[BNLayer] training requires full precision weights";
+
+    /** output = input * scale + shift with the weights folded per channel */
+    Tensor scale = context.getScratchTensor(gamma.getDim());
+    Tensor shift = context.getScratchTensor(gamma.getDim());
+    var.add(epsilon, scale);
+    scale.pow_i(-0.5f);
+    scale.multiply_i(gamma);
+    mu.multiply(scale, shift);
+    shift.multiply_i(-1.0f);
+    shift.add_i(beta);
+
+    input.multiply(scale, output);
+    output.add_i(shift);
+    return;
   }
 
-  Tensor &deviation = context.getTensor(wt_idx[BNParams::deviation]);
-  Tensor &invstd = context.getTensor(wt_idx[BNParams::invstd]);
+  Tensor input_ = getFP32(context, input);
+  Tensor hidden_ = output.getDataType() == TensorDim::DataType::FP32
+                     ? output
+                     : context.getScratchTensor(input_.getDim());
 
-  /** @todo these are not needed for inference, support optimizing these */
-  Tensor &t_reduced = context.getTensor(wt_idx[BNParams::t_reduced]);
-  /** use hidden_ as temporary tensor before setting the result in hidden */
-  Tensor t_full = hidden_;
-  Tensor &cvar = context.getTensor(wt_idx[BNParams::cvar]);
+  unsigned int outer, inner;
+  getChannelView(input_.getDim(), axis, outer, inner);
+  const unsigned int len = input_.getDim().getTensorDim(axis);
 
   if (training) {
-
     Tensor &mu_b = context.getTensor(wt_idx[BNParams::mu_b]);
     Tensor &var_b = context.getTensor(wt_idx[BNParams::var_b]);
 
     if (context.reStoreData()) {
       mu.copyData(mu_b);
       var.copyData(var_b);
-      deviation.setZero();
-      invstd.setZero();
-      t_reduced.setZero();
-      cvar.setZero();
     } else {
       mu_b.copyData(mu);
       var_b.copyData(var);
     }
 
-    input_.average(axes_to_reduce, t_reduced);
-    input_.subtract(t_reduced, deviation);
+    Tensor &x_hat = context.getTensor(wt_idx[BNParams::x_hat]);
+    Tensor &invstd = context.getTensor(wt_idx[BNParams::invstd]);
+    Tensor mean = context.getScratchTensor(mu.getDim());
+    Tensor cvar = context.getScratchTensor(var.getDim());
 
-    mu.multiply_i(momentum);
-    mu.add_i(t_reduced, 1 - momentum);
+    channelMeanVar(context, outer, len, inner, input_.getData<float>(),
+                   mean.getData<float>(), cvar.getData<float>());
 
-    deviation.pow(2.0f, t_full);
-    t_full.average(axes_to_reduce, cvar);
+    mu.multiply_i(momentum);
+    mu.add_i(mean, 1 - momentum);
 
     var.multiply_i(momentum);
     var.add_i(cvar, 1 - momentum);
 
     cvar.add_i(epsilon);
     cvar.pow(-0.5f, invstd);
+
+    batch_norm_forward(outer, len, inner, input_.getData<float>(),
+                       mean.getData<float>(), invstd.getData<float>(),
+                       gamma.getData<float>(), beta.getData<float>(),
+                       hidden_.getData<float>(), x_hat.getData<float>());
   } else {
-    input_.subtract(mu, deviation);
-    /** @todo do below 2 lines only for first iteration */
+    Tensor invstd = context.getScratchTensor(var.getDim());
     var.add(epsilon, invstd);
     invstd.pow_i(-0.5f);
-  }
 
-  deviation.multiply(invstd, hidden_);
-  hidden_.multiply_i(gamma);
-  hidden_.add_i(beta);
+    batch_norm_forward(outer, len, inner, input_.getData<float>(),
+                       mu.getData<float>(), invstd.getData<float>(),
+                       gamma.getData<float>(), beta.getData<float>(),
+                       hidden_.getData<float>());
+  }
 
-  if (training && hidden_.getDataType() !=
-                    context.getOutput(SINGLE_INOUT_IDX).getDataType())
-    context.getOutput(SINGLE_INOUT_IDX).copyData(hidden_);
+  if (hidden_.getDataType() != output.getDataType())
+    output.copyData(hidden_);
 }
 
 void BatchNormalizationLayer::calcDerivative(RunLayerContext &context) {
-
   Tensor &gamma = context.getWeight(wt_idx[BNParams::gamma]);
-
-  Tensor em_dx, deriv32;
-  bool deriv_copyed = false;
-
-  const Tensor deriv = context.getIncomingDerivative(SINGLE_INOUT_IDX);
-
-  if (deriv.getDataType() != TensorDim::DataType::FP32) {
-    deriv_copyed = true;
-    TensorDim dim = deriv.getDim();
-    dim.setDataType(TensorDim::DataType::FP32);
-    deriv32 = Tensor(dim, true);
-    deriv32.copyData(deriv);
-  }
-
-  Tensor &dx = context.getOutgoingDerivative(SINGLE_INOUT_IDX).getDataType() ==
-                   TensorDim::DataType::FP32
-                 ? context.getOutgoingDerivative(SINGLE_INOUT_IDX)
-                 : em_dx;
-
-  if (dx.empty())
-    dx = context.getOutgoingDerivative(SINGLE_INOUT_IDX)
-           .clone(TensorDim::DataType::FP32);
-
-  Tensor &deviation = context.getTensor(wt_idx[BNParams::deviation]);
+  Tensor &x_hat = context.getTensor(wt_idx[BNParams::x_hat]);
   Tensor &invstd = context.getTensor(wt_idx[BNParams::invstd]);
-  Tensor &cvar = context.getTensor(wt_idx[BNParams::cvar]);
 
-  Tensor &t_reduced = context.getTensor(wt_idx[BNParams::t_reduced]);
-  Tensor &t_full = context.getTensor(wt_idx[BNParams::t_full]);
+  const Tensor deriv =
+    getFP32(context, context.getIncomingDerivative(SINGLE_INOUT_IDX));
+  Tensor &outgoing = context.getOutgoingDerivative(SINGLE_INOUT_IDX);
+  Tensor dx = outgoing.getDataType() == TensorDim::DataType::FP32
+                ? outgoing
+                : context.getScratchTensor(deriv.getDim());
 
-  t_full.setZero();
-
-  deviation.multiply((deriv_copyed ? deriv32 : deriv), t_full);
-  t_full.average(axes_to_reduce, t_reduced);
-  t_reduced.divide_i(cvar);
-  deviation.multiply_i(t_reduced);
+  unsigned int outer, inner;
+  getChannelView(deriv.getDim(), axis, outer, inner);
+  const unsigned int len = deriv.getDim().getTensorDim(axis);
 
+  Tensor sum_dy, sum_dy_xhat;
   if (context.getTrainable()) {
-    /**
-     * This calculates dgamma tensor.
-     */
-    Tensor &dgamma = context.getWeightGrad(wt_idx[BNParams::gamma]);
-    t_full.multiply_i(invstd);
-    t_full.sum(axes_to_reduce, dgamma);
-
-    /**
-     * This implementation depends on the pre-calculated dbeta calculated.
-     */
-    Tensor &dbeta = context.getWeightGrad(wt_idx[BNParams::beta]);
-    dbeta.divide(divider, t_reduced);
+    /** This implementation depends on the sums calculated in calcGradient */
+    sum_dy = context.getWeightGrad(wt_idx[BNParams::beta]);
+    sum_dy_xhat = context.getWeightGrad(wt_idx[BNParams::gamma]);
   } else {
-    (deriv_copyed ? deriv32 : deriv).average(axes_to_reduce, t_reduced);
+    sum_dy = context.getScratchTensor(gamma.getDim());
+    sum_dy_xhat = context.getScratchTensor(gamma.getDim());
+    batch_norm_backward_reduce(outer, len, inner, deriv.getData<float>(),
+                               x_hat.getData<float>(), sum_dy.getData<float>(),
+                               sum_dy_xhat.getData<float>());
   }
 
-  (deriv_copyed ? deriv32 : deriv).subtract(t_reduced, dx);
-  dx.subtract_i(deviation);
+  const float inv_n = 1.0f / ((float)outer * inner);
+  Tensor mean_dy = context.getScratchTensor(gamma.getDim());
+  Tensor mean_dy_xhat = context.getScratchTensor(gamma.getDim());
+  sum_dy.multiply(inv_n, mean_dy);
+  sum_dy_xhat.multiply(inv_n, mean_dy_xhat);
 
-  invstd.multiply_i(gamma);
-  dx.multiply_i(invstd);
+  batch_norm_backward(outer, len, inner, deriv.getData<float>(),
+                      x_hat.getData<float>(), invstd.getData<float>(),
+                      gamma.getData<float>(), mean_dy.getData<float>(),
+                      mean_dy_xhat.getData<float>(), dx.getData<float>());
 
-  if (dx.getDataType() !=
-      context.getOutgoingDerivative(SINGLE_INOUT_IDX).getDataType())
-    context.getOutgoingDerivative(SINGLE_INOUT_IDX).copyData(dx);
+  if (dx.getDataType() != outgoing.getDataType())
+    outgoing.copyData(dx);
 }
 
 void BatchNormalizationLayer::calcGradient(RunLayerContext &context) {
-  /** dgamma is calculated in calcDerivative. dbeta is calculated here */
+  /** dgamma and dbeta are the channel sums of deriv * x_hat and deriv */
+  Tensor &dgamma = context.getWeightGrad(wt_idx[BNParams::gamma]);
   Tensor &dbeta = context.getWeightGrad(wt_idx[BNParams::beta]);
-  dbeta.setZero();
-
-  Tensor deriv32;
-  bool deriv_copyed = false;
+  Tensor &x_hat = context.getTensor(wt_idx[BNParams::x_hat]);
 
-  const Tensor deriv = context.getIncomingDerivative(SINGLE_INOUT_IDX);
-  if (deriv.getDataType() != TensorDim::DataType::FP32) {
-    deriv_copyed = true;
-    TensorDim dim = deriv.getDim();
-    dim.setDataType(TensorDim::DataType::FP32);
-    deriv32 = Tensor(dim, true);
-    deriv32.copyData(deriv);
-  }
+  const Tensor deriv =
+    getFP32(context, context.getIncomingDerivative(SINGLE_INOUT_IDX));
 
-  (deriv_copyed ? deriv32 : deriv).sum(axes_to_reduce, dbeta);
+  unsigned int outer, inner;
+  getChannelView(deriv.getDim(), axis, outer, inner);
+  batch_norm_backward_reduce(outer, deriv.getDim().getTensorDim(axis), inner,
+                             deriv.getData<float>(), x_hat.getData<float>(),
+                             dbeta.getData<float>(), dgamma.getData<float>());
 }
 
 void BatchNormalizationLayer::exportTo(
@@ -360,20 +387,8 @@ void BatchNormalizationLayer::exportTo(
 
 void BatchNormalizationLayer::setBatch(RunLayerContext &context,
                                        unsigned int batch) {
-  context.updateTensor(wt_idx[BNParams::deviation], batch);
-  context.updateTensor(wt_idx[BNParams::t_full], batch);
-
-  /// reset divider
-  divider = 1;
-  auto input_dim = context.getInput(0).getDim();
-  for (auto axis : axes_to_reduce) {
-    if (axis == 0) {
-      /// @note input dim batch is not updated, it will be more sensible we
-      /// update batch before any node comes to this spot
-      divider *= batch;
-    }
-    divider *= input_dim.getTensorDim(axis);
-  }
+  if (wt_idx[BNParams::x_hat] != std::numeric_limits<unsigned>::max())
+    context.updateTensor(wt_idx[BNParams::x_hat], batch);
 }
 
 void BatchNormalizationLayer::save(
@@ -158,10 +158,9 @@ public:
             size_t start_offset = 0, bool read_from_offset = false) override;
 
 private:
-  float divider; /**< size of the axes of the reduced */
+  unsigned int axis; /**< axis holding the normalized channels */
 
-  std::vector<unsigned int> axes_to_reduce; /**< target axes to reduce */
-  std::array<unsigned int, 11>
+  std::array<unsigned int, 8>
     wt_idx; /**< indices of the weights and tensors */
   std::tuple<props::Epsilon, props::MuInitializer, props::VarInitializer,
              props::BetaInitializer, props::GammaInitializer, props::Momentum,
@@ -361,6 +361,12 @@ ReturnAttentionWeight::ReturnAttentionWeight(
   set(value);
 }
 
+DynamicQuantization::DynamicQuantization(DynamicQuantizationInfo::Enum value) {
+  set(value);
+}
+
+VocabChunk::VocabChunk(unsigned int value) { set(value); }
+
 } // namespace props
 
 template <>
@@ -164,6 +164,22 @@ public:
   using prop_tag = bool_prop_tag;
 };
 
+/**
+ * @brief recompute property, if true, activations of the layer are dropped
+ * after forwarding and recomputed in backwarding to save memory
+ *
+ */
+class Recompute : public nntrainer::Property<bool> {
+public:
+  /**
+   * @brief Construct a new Recompute object
+   *
+   */
+  Recompute(bool val = false) : nntrainer::Property<bool>(val) {}
+  static constexpr const char *key = "recompute";
+  using prop_tag = bool_prop_tag;
+};
+
 /**
  * @brief DisableBias to disable the bias
  *
@@ -1482,6 +1498,71 @@ public:
   using prop_tag = uint_prop_tag;                  /**< property type */
 };
 
+/**
+ * @brief Enumeration of dynamic quantization mode
+ */
+struct DynamicQuantizationInfo {
+  enum class Enum { none, int8, int4 };
+  static constexpr std::initializer_list<Enum> EnumList = {
+    Enum::none, Enum::int8, Enum::int4};
+
+  static constexpr const char *EnumStr[] = {"none", "int8", "int4"};
+};
+
+/**
+ * @brief DynamicQuantization property, runs inference of a fully connected
+ * layer on int8 activations quantized per row at runtime and weights quantized
+ * per output channel.
+ * @details "none" keeps the float path. "int8"/"int4" select the weight
+ * precision. Training always uses the float weight.
+ */
+class DynamicQuantization : public EnumProperty<DynamicQuantizationInfo> {
+public:
+  static constexpr const char *key =
+    "dynamic_quantization";             /**< unique key to access */
+  using prop_tag = enum_class_prop_tag; /**< property type */
+
+  /**
+   * @brief Construct a new DynamicQuantization object
+   *
+   */
+  DynamicQuantization(
+    DynamicQuantizationInfo::Enum value = DynamicQuantizationInfo::Enum::none);
+};
+
+/**
+ * @brief LastStepOnly property, computes only the last step of a multi-step
+ * incremental forwarding, e.g. the logits of the last position of a prompt.
+ * The other rows of the output are left untouched.
+ */
+class LastStepOnly : public Property<bool> {
+public:
+  static constexpr const char *key = "last_step_only"; /**< unique key */
+  using prop_tag = bool_prop_tag;                      /**< property type */
+
+  /**
+   * @brief Construct a new LastStepOnly object
+   *
+   */
+  LastStepOnly(bool value = false) { set(value); }
+};
+
+/**
+ * @brief VocabChunk property, number of classes the linear cross entropy loss
+ * layer computes at once. Larger chunks run larger GEMMs, smaller chunks keep
+ * less of the logits in memory.
+ */
+class VocabChunk : public PositiveIntegerProperty {
+public:
+  /**
+   * @brief Construct a new VocabChunk object with default value 4096
+   *
+   */
+  VocabChunk(unsigned int value = 4096);
+  static constexpr const char *key = "vocab_chunk"; /**< unique key to access */
+  using prop_tag = uint_prop_tag;                   /**< property type */
+};
+
 /**
  * @brief properties for getting the clipping value to clip the gradient by norm
  *
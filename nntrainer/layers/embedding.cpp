@@ -40,9 +40,10 @@ void EmbeddingLayer::finalize(InitLayerContext &context) {
   NNTR_THROW_IF(input_dim.channel() != 1, std::invalid_argument)
     << "Embedding layer takes only one for channel size";
 
-  NNTR_THROW_IF(input_dim.getDataType() != TensorDim::DataType::FP32,
+  NNTR_THROW_IF(input_dim.getDataType() != TensorDim::DataType::FP32 &&
+                  input_dim.getDataType() != TensorDim::DataType::UINT32,
                 std::invalid_argument)
-    << "Embedding layer takes only FP32 input data";
+    << "Embedding layer takes only FP32 or UINT32 input data";
 
   auto &weight_regularizer =
     std::get<props::WeightRegularizer>(*layer_impl_props);
@@ -92,13 +93,14 @@ void EmbeddingLayer::forwarding(RunLayerContext &context, bool training) {
   TensorDim out_tensor_dim =
     TensorDim({1, 1, 1, out_dim}, hidden_.getTensorType());
 
+  const bool uint_input = input_.getDataType() == TensorDim::DataType::UINT32;
   for (unsigned int b = 0; b < input_.batch(); ++b) {
-    float *in_data =
-      input_.getAddress<float>(b * input_.getDim().getFeatureLen());
+    const void *in_data =
+      input_.getAddress<void>(b * input_.getDim().getFeatureLen());
 
     Tensor batchsliced_hidden = hidden_.getBatchSlice(b, 1);
     for (unsigned int i = 0; i < input_.width(); ++i) {
-      unsigned int embed_idx = static_cast<unsigned int>(in_data[i]);
+      unsigned int embed_idx = wordIndex(in_data, uint_input, i);
       if (embed_idx >= in_dim) {
         throw std::invalid_argument("input word index is greater than in_dim");
       }
@@ -134,13 +136,14 @@ void EmbeddingLayer::incremental_forwarding(RunLayerContext &context,
   TensorDim out_tensor_dim =
     TensorDim({1, 1, 1, out_dim}, hidden_.getTensorType());
 
+  const bool uint_input = input_.getDataType() == TensorDim::DataType::UINT32;
   for (unsigned int b = 0; b < input_.batch(); ++b) {
-    float *in_data =
-      input_.getAddress<float>(b * input_.getDim().getFeatureLen());
+    const void *in_data =
+      input_.getAddress<void>(b * input_.getDim().getFeatureLen());
 
     Tensor batchsliced_hidden = hidden_.getBatchSlice(b, 1);
     for (unsigned int i = from; i < to; ++i) {
-      unsigned int embed_idx = static_cast<unsigned int>(in_data[i]);
+      unsigned int embed_idx = wordIndex(in_data, uint_input, i);
       if (embed_idx >= in_dim) {
         throw std::invalid_argument("input word index is greater than in_dim");
       }
@@ -181,13 +184,14 @@ void EmbeddingLayer::calcGradient(RunLayerContext &context) {
   // indices before accessing to the Tensor, we can optimize it by deleting the
   // sparse-value indices. Also left as an Issue as well.
 
+  const bool uint_input = input_.getDataType() == TensorDim::DataType::UINT32;
   for (unsigned int b = 0; b < input_.batch(); ++b) {
-    float *in_data =
-      input_.getAddress<float>(b * input_.getDim().getFeatureLen());
+    const void *in_data =
+      input_.getAddress<void>(b * input_.getDim().getFeatureLen());
 
     if (djdw.getDataType() == TensorDim::DataType::FP32) {
       for (unsigned int i = 0; i < input_.width(); ++i) {
-        unsigned int embed_idx = ((float *)(in_data))[i];
+        unsigned int embed_idx = wordIndex(in_data, uint_input, i);
         // Assume padding is 0 and index always start from 1.
         // If in_data[i] - 1 < 0, then it skips.
         // if (embed_idx == 0)
@@ -203,7 +207,7 @@ void EmbeddingLayer::calcGradient(RunLayerContext &context) {
     } else if (djdw.getDataType() == TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
       for (unsigned int i = 0; i < input_.width(); ++i) {
-        unsigned int embed_idx = ((float *)(in_data))[i];
+        unsigned int embed_idx = wordIndex(in_data, uint_input, i);
         // Assume padding is 0 and index always start from 1.
         // If in_data[i] - 1 < 0, then it skips.
         // if (embed_idx == 0)
@@ -22,6 +22,7 @@
  */
 
 #include <common_properties.h>
+#include <cpu_backend.h>
 #include <fc_layer.h>
 #include <layer_context.h>
 #include <lazy_tensor.h>
@@ -42,8 +43,11 @@ enum LORAParams { loraA, loraB, loraTmp, loraOut };
 FullyConnectedLayer::FullyConnectedLayer() :
   LayerImpl(),
   lora_scaling(1.0f),
-  fc_props(props::Unit(), props::LoraRank(), props::LoraAlpha()),
-  quantizer(nullptr) {
+  fc_props(props::Unit(), props::LoraRank(), props::LoraAlpha(),
+           props::DynamicQuantization(), props::LastStepOnly()),
+  quantizer(nullptr),
+  dq_source(nullptr),
+  dq_epoch(0) {
   weight_idx.fill(std::numeric_limits<unsigned>::max());
   lora_idx.fill(std::numeric_limits<unsigned>::max());
 }
@@ -170,6 +174,25 @@ void FullyConnectedLayer::finalize(InitLayerContext &context) {
                             TensorLifespan::FORWARD_FUNC_LIFESPAN);
   }
 
+  if (auto dq = std::get<props::DynamicQuantization>(fc_props).get();
+      dq != props::DynamicQuantizationInfo::Enum::none) {
+    NNTR_THROW_IF(!is_nchw, std::invalid_argument)
+      << "dynamic_quantization supports NCHW format only";
+    NNTR_THROW_IF(context.getWeightDataType() != TensorDim::DataType::FP32 ||
+                    context.getActivationDataType() !=
+                      TensorDim::DataType::FP32,
+                  std::invalid_argument)
+      << "dynamic_quantization requires FP32 weight and activation";
+    NNTR_THROW_IF(dq == props::DynamicQuantizationInfo::Enum::int4 &&
+                    in_dim.width() % 32 != 0,
+                  std::invalid_argument)
+      << "dynamic_quantization=int4 requires input width multiple of 32, got "
+      << in_dim.width();
+  }
+  dq_weight.clear();
+  dq_scales.clear();
+  dq_source = nullptr;
+
   ///@todo this quantizaer should be moved to tensor, not layer!
   switch (context.getWeightDataType()) {
   case ml::train::TensorDim::DataType::QINT4:
@@ -213,6 +236,8 @@ void FullyConnectedLayer::forwarding(RunLayerContext &context, bool training) {
   if (quantizer != nullptr) {
     Tensor weight_ = quantizer->dequantize(weight, input_.getDataType());
     input_.dot(weight_, hidden_, false, false);
+  } else if (useDynamicQuantization(training)) {
+    dynamicQuantizedDot(weight, input_, hidden_);
   } else {
     input_.dot(weight, hidden_, false, false);
   }
@@ -255,6 +280,13 @@ void FullyConnectedLayer::incremental_forwarding(RunLayerContext &context,
   TensorDim input_dim = input_.getDim();
   TensorDim hidden_dim = hidden_.getDim();
 
+  /** with last_step_only, only the last row of the step is computed */
+  unsigned int first_row = 0;
+  if (std::get<props::LastStepOnly>(fc_props).get() && to - from > 1) {
+    first_row = to - from - 1;
+    from = to - 1;
+  }
+
   TensorDim input_step_dim = input_dim;
   TensorDim hidden_step_dim = hidden_dim;
 
@@ -266,11 +298,16 @@ void FullyConnectedLayer::incremental_forwarding(RunLayerContext &context,
   // @todo make it parallelized with batch axis
   for (unsigned int b = 0; b < hidden_.batch(); ++b) {
     Tensor input_step = input_.getSharedDataTensor(
-      input_step_dim, b * hidden_dim.getFeatureLen(), true);
+      input_step_dim,
+      b * input_dim.getFeatureLen() + first_row * input_dim.width(), true);
     Tensor hidden_step = hidden_.getSharedDataTensor(
-      hidden_step_dim, b * hidden_dim.getFeatureLen(), true);
+      hidden_step_dim,
+      b * hidden_dim.getFeatureLen() + first_row * hidden_dim.width(), true);
 
-    input_step.dot(weight, hidden_step, false, false);
+    if (useDynamicQuantization(training))
+      dynamicQuantizedDot(weight, input_step, hidden_step);
+    else
+      input_step.dot(weight, hidden_step, false, false);
 
     if (!std::get<props::LoraRank>(fc_props).empty()) {
       nntrainer::TensorDim hidden_tmp_lora_step_dim = hidden_tmp_lora.getDim();
@@ -303,6 +340,46 @@ void FullyConnectedLayer::incremental_forwarding(RunLayerContext &context,
   }
 }
 
+bool FullyConnectedLayer::useDynamicQuantization(bool training) const {
+  return !training && std::get<props::DynamicQuantization>(fc_props).get() !=
+                        props::DynamicQuantizationInfo::Enum::none;
+}
+
+void FullyConnectedLayer::dynamicQuantizedDot(const Tensor &weight,
+                                              const Tensor &input,
+                                              Tensor &output) {
+  const unsigned int K = weight.height();
+  const unsigned int N = weight.width();
+  const unsigned int M = input.size() / K;
+  const bool is_int4 = std::get<props::DynamicQuantization>(fc_props).get() ==
+                       props::DynamicQuantizationInfo::Enum::int4;
+
+  const float *w = weight.getData<float>();
+  const uint64_t epoch = Weight::getUpdateEpoch();
+  if (dq_source != w || dq_epoch != epoch) {
+    dq_scales.resize(N);
+    if (is_int4) {
+      dq_weight.resize((size_t)N * K / 2);
+      quantize_qsi4cx(N, K, w, false, dq_weight.data(), dq_scales.data());
+    } else {
+      dq_weight.resize((size_t)N * K);
+      quantize_qsi8cx(N, K, w, false,
+                      reinterpret_cast<int8_t *>(dq_weight.data()),
+                      dq_scales.data());
+    }
+    dq_source = w;
+    dq_epoch = epoch;
+  }
+
+  if (is_int4)
+    gemm_qai8_qsi4cx(M, N, K, input.getData<float>(), K, dq_weight.data(),
+                     dq_scales.data(), output.getData<float>(), N);
+  else
+    gemm_qai8_qsi8cx(M, N, K, input.getData<float>(), K,
+                     reinterpret_cast<const int8_t *>(dq_weight.data()),
+                     dq_scales.data(), output.getData<float>(), N);
+}
+
 void FullyConnectedLayer::calcDerivative(RunLayerContext &context) {
   Tensor &weight = context.getWeight(weight_idx[FCParams::weight]);
 
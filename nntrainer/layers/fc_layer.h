@@ -113,15 +113,40 @@ public:
 
 private:
   float lora_scaling;
-  std::tuple<props::Unit, props::LoraRank, props::LoraAlpha>
+  std::tuple<props::Unit, props::LoraRank, props::LoraAlpha,
+             props::DynamicQuantization, props::LastStepOnly>
     fc_props;                             /**< fc layer properties :
                                                 unit - number of output neurons,
                                                 lora_rank - rank of lora (optional)
                                                 lora_scaling - scaling factor of LoRA apply, i.e.,
-                                             lora_scaling = alpha / lora_rank */
+                                             lora_scaling = alpha / lora_rank
+                                                dynamic_quantization - int8 GEMM
+                                             for inference (optional)
+                                                last_step_only - incremental
+                                             forwarding computes the last step
+                                             only (optional) */
   std::array<unsigned int, 2> weight_idx; /**< indices of the weights */
   std::array<unsigned int, 4> lora_idx;   /**< indices of the lora weights */
   std::unique_ptr<nntrainer::Quantizer> quantizer;
+
+  std::vector<uint8_t> dq_weight; /**< per channel quantized weight */
+  std::vector<float> dq_scales;   /**< scales of dq_weight */
+  const float *dq_source;         /**< weight data dq_weight is made from */
+  uint64_t dq_epoch; /**< Weight::getUpdateEpoch() dq_weight is made at */
+
+  /**
+   * @brief check if this forwarding runs on the dynamically quantized weight
+   */
+  bool useDynamicQuantization(bool training) const;
+
+  /**
+   * @brief output = input * weight on int8 activations quantized per row and
+   * the cached quantized weight. The cache is built from weight on first use
+   * and rebuilt when the weight memory moves or any weight is written in
+   * place, see Weight::markUpdated().
+   */
+  void dynamicQuantizedDot(const Tensor &weight, const Tensor &input,
+                           Tensor &output);
 };
 } // namespace nntrainer
 
@@ -33,7 +33,9 @@ namespace nntrainer {
 static constexpr size_t SINGLE_INOUT_IDX = 0;
 
 InputLayer::InputLayer() :
-  Layer(), input_props(props::Normalization(), props::Standardization()) {}
+  Layer(),
+  input_props(props::Normalization(), props::Standardization(),
+              props::TensorDataType()) {}
 
 void InputLayer::setProperty(const std::vector<std::string> &values) {
   auto remain_props = loadProperties(values, input_props);
@@ -71,6 +73,23 @@ void InputLayer::exportTo(Exporter &exporter,
 }
 
 void InputLayer::finalize(InitLayerContext &context) {
+  auto input_type = std::get<props::TensorDataType>(input_props).get();
+  NNTR_THROW_IF(input_type != TensorDim::DataType::FP32 &&
+                  input_type != TensorDim::DataType::UINT32,
+                std::invalid_argument)
+    << "[InputLayer] tensor_dtype must be FP32 or UINT32";
+
+  if (input_type == TensorDim::DataType::UINT32) {
+    /// integer inputs (e.g. token ids) are handed over as they are
+    NNTR_THROW_IF(std::get<props::Normalization>(input_props) ||
+                    std::get<props::Standardization>(input_props),
+                  std::invalid_argument)
+      << "[InputLayer] UINT32 input cannot be normalized or standardized";
+    context.setInputDataType(input_type);
+    context.setOutputDimensions(context.getInputDimensions());
+    is_inplace = true;
+    return;
+  }
 
   std::vector<TensorDim> output_dims = context.getInputDimensions();
   for (auto &d : output_dims) {
@@ -86,8 +105,12 @@ void InputLayer::finalize(InitLayerContext &context) {
 void InputLayer::updateTensorsByInputDimensions(
   nntrainer::RunLayerContext &context,
   std::vector<nntrainer::TensorDim> input_dimensions) {
-  context.updateInput(SINGLE_INOUT_IDX, input_dimensions[0]);
-  context.updateOutput(SINGLE_INOUT_IDX, input_dimensions[0]);
+  TensorDim dim = input_dimensions[0];
+  if (std::get<props::TensorDataType>(input_props).get() ==
+      TensorDim::DataType::UINT32)
+    dim.setDataType(TensorDim::DataType::UINT32);
+  context.updateInput(SINGLE_INOUT_IDX, dim);
+  context.updateOutput(SINGLE_INOUT_IDX, dim);
 }
 
 } /* namespace nntrainer */
@@ -34,6 +34,8 @@ namespace nntrainer {
  * @note    input layers requires to be only single input, consider making the
  * class deal with multiple inputs
  * @brief   Just Handle the Input of Network
+ * @note    tensor_dtype=UINT32 feeds unsigned integer data (e.g. token ids)
+ * as they are, otherwise the input is FP32
  */
 class InputLayer : public Layer {
 public:
@@ -112,7 +114,9 @@ public:
   static constexpr const char *type = "input";
 
 private:
-  std::tuple<props::Normalization, props::Standardization> input_props;
+  std::tuple<props::Normalization, props::Standardization,
+             props::TensorDataType>
+    input_props;
 };
 } // namespace nntrainer
 
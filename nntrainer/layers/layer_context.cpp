@@ -21,6 +21,7 @@
 #include <iterator>
 #include <layer_context.h>
 #include <nntrainer_log.h>
+#include <scratch_arena.h>
 #include <stdexcept>
 #include <var_grad.h>
 
@@ -402,6 +403,10 @@ bool RunLayerContext::tensorHasGradient(unsigned int idx) const {
   return tensors[idx]->hasGradient();
 }
 
+Tensor RunLayerContext::getScratchTensor(const TensorDim &dim) {
+  return ScratchArena::threadLocal().getTensor(dim);
+}
+
 bool RunLayerContext::isWeightDependent(unsigned int idx) const {
   return weights[idx]->isDependent();
 }
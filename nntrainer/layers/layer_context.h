@@ -724,6 +724,16 @@ public:
    */
   bool tensorHasGradient(unsigned int idx) const;
 
+  /**
+   * @brief Get an uninitialized scratch tensor from the arena of the calling
+   * thread. It is released when the current layer call returns, so it must
+   * not be kept across calls.
+   *
+   * @param dim dimension of the tensor
+   * @return Tensor scratch tensor
+   */
+  Tensor getScratchTensor(const TensorDim &dim);
+
   /**
    * @brief check if the weight is burrowed from others so it is dependent
    *
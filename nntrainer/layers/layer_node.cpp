@@ -30,6 +30,7 @@
 #include <nntrainer_log.h>
 #include <node_exporter.h>
 #include <profiler.h>
+#include <scratch_arena.h>
 #include <time_dist.h>
 #include <tracer.h>
 #include <util_func.h>
@@ -202,7 +203,8 @@ LayerNode::LayerNode(std::unique_ptr<nntrainer::Layer> &&l) :
   layer_node_props(new PropsType(
     props::Name(), props::Distribute(), props::Trainable(), {}, {},
     props::SharedFrom(), props::ClipGradByGlobalNorm(), props::Packed(),
-    props::WeightDtype(), props::LossScaleForMixed(), props::ComputeEngine())),
+    props::WeightDtype(), props::LossScaleForMixed(), props::ComputeEngine(),
+    props::Recompute())),
   layer_node_props_realization(
     new RealizationPropsType(props::Flatten(), props::Activation())),
   loss(new props::Loss()),
@@ -258,6 +260,7 @@ void LayerNode::setWeights(const std::vector<float *> weights) {
     Tensor &w = getWeight(idx);
     std::copy(weights[idx], weights[idx] + w.size(), w.getData());
   }
+  Weight::markUpdated();
 }
 
 const unsigned LayerNode::getInputConnectionIndex(unsigned nth) const {
@@ -410,6 +413,10 @@ bool LayerNode::getTrainable() const {
     return std::get<props::Trainable>(*layer_node_props);
 }
 
+bool LayerNode::getRecompute() const {
+  return std::get<props::Recompute>(*layer_node_props);
+}
+
 bool LayerNode::getFlatten() const {
   auto &flatten = std::get<props::Flatten>(*layer_node_props_realization);
   if (flatten.empty()) {
@@ -501,6 +508,7 @@ void LayerNode::read(std::ifstream &file, bool opt_var,
                      size_t start_offset, bool read_from_offset, int file_fd) {
   NNTR_THROW_IF(!run_context, std::runtime_error)
     << __func__ << " layer needs to be finalized first!";
+  Weight::markUpdated();
   getLayer()->read(file, *run_context, opt_var, mode,
                    (getTrainable() && mode == ml::train::ExecutionMode::TRAIN),
                    getWeightDataType(), fsu, start_offset, read_from_offset,
@@ -512,6 +520,7 @@ void LayerNode::read(ReadSource src, bool opt_var,
                      size_t start_offset, bool read_from_offset) {
   NNTR_THROW_IF(!run_context, std::runtime_error)
     << __func__ << " layer needs to be finalized first!";
+  Weight::markUpdated();
   getLayer()->read(src, *run_context, opt_var, mode,
                    (getTrainable() && mode == ml::train::ExecutionMode::TRAIN),
                    getWeightDataType(), fsu, start_offset, read_from_offset);
@@ -795,7 +804,10 @@ void LayerNode::forwarding(bool training) {
     }
   }
 
-  layer->forwarding(*run_context, training);
+  {
+    ScratchArena::Scope scratch;
+    layer->forwarding(*run_context, training);
+  }
   reStoreData(false);
   PROFILE_TIME_END(forward_event_key);
   TRACE_MEMORY() << getName() + ": F";
@@ -820,7 +832,10 @@ void LayerNode::incremental_forwarding(unsigned int from, unsigned int to,
   loss->set(run_context->getRegularizationLoss());
   PROFILE_TIME_START(forward_event_key);
   // std::cerr << getType() << "\n";
-  layer->incremental_forwarding(*run_context, from, to, training);
+  {
+    ScratchArena::Scope scratch;
+    layer->incremental_forwarding(*run_context, from, to, training);
+  }
   PROFILE_TIME_END(forward_event_key);
   TRACE_MEMORY() << getName() + ": F";
   TRACE_TIME() << getName() + ": F";
@@ -842,7 +857,10 @@ void LayerNode::incremental_forwarding(unsigned int from, unsigned int to,
 void LayerNode::calcDerivative() {
   PROFILE_TIME_START(calc_deriv_event_key);
   PROFILE_MEM_ANNOTATE("CalcDerivative: " + getName());
-  layer->calcDerivative(*run_context);
+  {
+    ScratchArena::Scope scratch;
+    layer->calcDerivative(*run_context);
+  }
   PROFILE_TIME_END(calc_deriv_event_key);
   TRACE_MEMORY() << getName() + ": CD";
   TRACE_TIME() << getName() + ": CD";
@@ -861,6 +879,7 @@ void LayerNode::calcGradient() {
   PROFILE_TIME_START(calc_grad_event_key);
   if (needs_calc_gradient) {
     PROFILE_MEM_ANNOTATE("CalcGradient: " + getName());
+    ScratchArena::Scope scratch;
     layer->calcGradient(*run_context);
     TRACE_MEMORY() << getName() + ": CG";
     TRACE_TIME() << getName() + ": CG";
@@ -55,6 +55,7 @@ class ClipGradByGlobalNorm;
 class Packed;
 class LossScaleForMixed;
 class ComputeEngine;
+class Recompute;
 } // namespace props
 
 /**
@@ -432,6 +433,14 @@ public:
    */
   bool getTrainable() const override;
 
+  /**
+   * @brief     get if the activations of this layer are recomputed in
+   * backwarding instead of being kept from forwarding
+   *
+   * @return boolean true if recomputed, else false
+   */
+  bool getRecompute() const;
+
   /**
    * @brief     get if the output of this layer must be flatten
    * @retval    flatten value
@@ -1048,7 +1057,8 @@ properties in the context/graph unless intended. */
                std::vector<props::InputConnection>,
                std::vector<props::InputShape>, props::SharedFrom,
                props::ClipGradByGlobalNorm, props::Packed, props::WeightDtype,
-               props::LossScaleForMixed, props::ComputeEngine>;
+               props::LossScaleForMixed, props::ComputeEngine,
+               props::Recompute>;
 
   using RealizationPropsType = std::tuple<props::Flatten, props::Activation>;
   /** these realization properties results in addition of new layers, hence
@@ -0,0 +1,315 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   linear_cross_entropy_loss_layer.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Fused linear and softmax cross entropy loss layer which never
+ * materializes the logits
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <cpu_backend.h>
+#include <layer_context.h>
+#include <linear_cross_entropy_loss_layer.h>
+#include <nntrainer_error.h>
+#include <node_exporter.h>
+
+namespace nntrainer {
+
+static constexpr size_t SINGLE_INOUT_IDX = 0;
+
+enum LCEParams { weight, bias };
+
+namespace {
+
+/**
+ * @brief logits of the classes [from, from + len) of every row,
+ * Z = X * W[:, from:from + len] + b[from:from + len]
+ */
+void chunkLogits(const float *X, const float *W, const float *b,
+                 unsigned int rows, unsigned int hidden, unsigned int classes,
+                 unsigned int from, unsigned int len, float *Z) {
+  sgemm(0, false, false, rows, len, hidden, 1.0f, X, hidden, W + from, classes,
+        0.0f, Z, len);
+  if (b == nullptr)
+    return;
+
+  for (unsigned int r = 0; r < rows; ++r) {
+    float *z = Z + (size_t)r * len;
+    for (unsigned int j = 0; j < len; ++j)
+      z[j] += b[from + j];
+  }
+}
+
+/**
+ * @brief class index of a label, -1 if the token is dropped from the loss
+ */
+int labelIndex(float label, unsigned int classes) {
+  return (label >= 0.0f && label < (float)classes) ? (int)label : -1;
+}
+
+} // namespace
+
+LinearCrossEntropyLossLayer::LinearCrossEntropyLossLayer() :
+  LayerImpl(),
+  lce_props(props::Unit(), props::VocabChunk()),
+  lse_idx(std::numeric_limits<unsigned>::max()),
+  derivative_ready(false) {
+  weight_idx.fill(std::numeric_limits<unsigned>::max());
+}
+
+void LinearCrossEntropyLossLayer::finalize(InitLayerContext &context) {
+  auto &weight_regularizer =
+    std::get<props::WeightRegularizer>(*layer_impl_props);
+  auto &weight_regularizer_constant =
+    std::get<props::WeightRegularizerConstant>(*layer_impl_props);
+  auto &weight_initializer =
+    std::get<props::WeightInitializer>(*layer_impl_props);
+  auto &weight_decay = std::get<props::WeightDecay>(*layer_impl_props);
+  auto &bias_decay = std::get<props::BiasDecay>(*layer_impl_props);
+  auto &bias_initializer = std::get<props::BiasInitializer>(*layer_impl_props);
+  auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
+
+  NNTR_THROW_IF(std::get<props::Unit>(lce_props).empty(),
+                std::invalid_argument)
+    << "unit property missing for linear cross entropy layer";
+  const unsigned int unit = std::get<props::Unit>(lce_props).get();
+
+  NNTR_THROW_IF(context.getNumInputs() != 1, std::invalid_argument)
+    << "Linear cross entropy layer takes only one input";
+  NNTR_THROW_IF(context.getFormat() != Tformat::NCHW, std::invalid_argument)
+    << "Linear cross entropy layer supports NCHW format only";
+  NNTR_THROW_IF(context.getWeightDataType() != TensorDim::DataType::FP32 ||
+                  context.getActivationDataType() != TensorDim::DataType::FP32,
+                std::invalid_argument)
+    << "Linear cross entropy layer supports FP32 weight and activation only";
+
+  auto const &in_dim = context.getInputDimensions()[0];
+  NNTR_THROW_IF(in_dim.channel() != 1, std::invalid_argument)
+    << "Linear cross entropy layer takes (batch, 1, tokens, hidden) input";
+
+  /** one loss value per token, the label has the same shape */
+  TensorDim out_dim = in_dim;
+  out_dim.width(1);
+  context.setOutputDimensions({out_dim});
+
+  /** Weight Dimension : (1, 1, in_dim.width(), unit) */
+  TensorDim weight_dim(
+    1, 1, in_dim.width(), unit,
+    TensorDim::TensorType(context.getFormat(), context.getWeightDataType()),
+    0b0011);
+  weight_idx[LCEParams::weight] = context.requestWeight(
+    weight_dim, weight_initializer, weight_regularizer,
+    weight_regularizer_constant, weight_decay, "weight", true);
+
+  if (disable_bias.empty() || disable_bias.get() == false) {
+    /** Bias Dimension : (1, 1, 1, unit) */
+    TensorDim bias_dim(
+      1, 1, 1, unit,
+      TensorDim::TensorType(context.getFormat(), context.getWeightDataType()),
+      0b0001);
+    weight_idx[LCEParams::bias] =
+      context.requestWeight(bias_dim, bias_initializer, WeightRegularizer::NONE,
+                            1.0f, bias_decay, "bias", true);
+  }
+
+  /** log-sum-exp of every token, kept from forwarding to backwarding */
+  lse_idx =
+    context.requestTensor(out_dim, "log_sum_exp", Initializer::NONE, false,
+                          TensorLifespan::ITERATION_LIFESPAN);
+}
+
+void LinearCrossEntropyLossLayer::exportTo(
+  Exporter &exporter, const ml::train::ExportMethods &method) const {
+  LayerImpl::exportTo(exporter, method);
+  exporter.saveResult(lce_props, method, this);
+}
+
+void LinearCrossEntropyLossLayer::setProperty(
+  const std::vector<std::string> &values) {
+  auto remain_props = loadProperties(values, lce_props);
+  LayerImpl::setProperty(remain_props);
+}
+
+void LinearCrossEntropyLossLayer::setBatch(RunLayerContext &context,
+                                           unsigned int batch) {
+  context.updateTensor(lse_idx, batch);
+}
+
+void LinearCrossEntropyLossLayer::forwarding(RunLayerContext &context,
+                                             bool training) {
+  derivative_ready = false;
+
+  Tensor &loss = context.getOutput(SINGLE_INOUT_IDX);
+  if (!context.isLabelAvailable(SINGLE_INOUT_IDX)) {
+    loss.setZero();
+    return;
+  }
+
+  const Tensor &input_ = context.getInput(SINGLE_INOUT_IDX);
+  const Tensor &label = context.getLabel(SINGLE_INOUT_IDX);
+  const Tensor &weight = context.getWeight(weight_idx[LCEParams::weight]);
+  Tensor &lse = context.getTensor(lse_idx);
+
+  const unsigned int classes = weight.width();
+  const unsigned int hidden = input_.width();
+  const unsigned int rows = input_.size() / hidden;
+  const unsigned int chunk =
+    std::min(std::get<props::VocabChunk>(lce_props).get(), classes);
+
+  const float *bias = nullptr;
+  if (auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
+      disable_bias.empty() || disable_bias.get() == false)
+    bias = context.getWeight(weight_idx[LCEParams::bias]).getData<float>();
+
+  Tensor logits = context.getScratchTensor(TensorDim(1, 1, rows, chunk));
+  Tensor chunk_max = context.getScratchTensor(TensorDim(1, 1, 1, rows));
+  Tensor exp_sum = context.getScratchTensor(TensorDim(1, 1, 1, rows));
+
+  const float *X = input_.getData<float>();
+  const float *W = weight.getData<float>();
+  const float *y = label.getData<float>();
+  float *Z = logits.getData<float>();
+  float *c_max = chunk_max.getData<float>();
+  float *m = lse.getData<float>();
+  float *s = exp_sum.getData<float>();
+  /// the output holds the logit of the label until the loss is known
+  float *l = loss.getData<float>();
+
+  std::fill(m, m + rows, -std::numeric_limits<float>::infinity());
+  std::fill(s, s + rows, 0.0f);
+  std::fill(l, l + rows, 0.0f);
+
+  for (unsigned int from = 0; from < classes; from += chunk) {
+    const unsigned int len = std::min(chunk, classes - from);
+    chunkLogits(X, W, bias, rows, hidden, classes, from, len, Z);
+    reduce_max(rows, len, 1, Z, c_max);
+
+    for (unsigned int r = 0; r < rows; ++r) {
+      const float *z = Z + (size_t)r * len;
+      const float new_max = std::max(m[r], c_max[r]);
+      float sum = 0.0f;
+      for (unsigned int j = 0; j < len; ++j)
+        sum += std::exp(z[j] - new_max);
+      s[r] = s[r] * std::exp(m[r] - new_max) + sum;
+      m[r] = new_max;
+
+      int t = labelIndex(y[r], classes);
+      if (t >= (int)from && t < (int)(from + len))
+        l[r] = z[t - from];
+    }
+  }
+
+  float loss_sum = 0.0f;
+  for (unsigned int r = 0; r < rows; ++r) {
+    m[r] += std::log(s[r]);
+    l[r] = labelIndex(y[r], classes) < 0 ? 0.0f : m[r] - l[r];
+    loss_sum += l[r];
+  }
+
+  /// same reduction as the cross entropy loss, sum of a sample averaged
+  context.setLoss(loss_sum / (float)input_.batch());
+}
+
+void LinearCrossEntropyLossLayer::calcDerivative(RunLayerContext &context) {
+  if (derivative_ready) {
+    derivative_ready = false;
+    return;
+  }
+
+  backwarding(context, false, true);
+}
+
+void LinearCrossEntropyLossLayer::calcGradient(RunLayerContext &context) {
+  const bool calc_deriv = context.inputHasGradient(SINGLE_INOUT_IDX);
+  backwarding(context, true, calc_deriv);
+  derivative_ready = calc_deriv;
+}
+
+void LinearCrossEntropyLossLayer::backwarding(RunLayerContext &context,
+                                              bool calc_grad,
+                                              bool calc_deriv) {
+  const Tensor &input_ = context.getInput(SINGLE_INOUT_IDX);
+  const Tensor &label = context.getIncomingDerivative(SINGLE_INOUT_IDX);
+  const Tensor &weight = context.getWeight(weight_idx[LCEParams::weight]);
+  const Tensor &lse = context.getTensor(lse_idx);
+
+  const unsigned int classes = weight.width();
+  const unsigned int hidden = input_.width();
+  const unsigned int rows = input_.size() / hidden;
+  const unsigned int chunk =
+    std::min(std::get<props::VocabChunk>(lce_props).get(), classes);
+  const float scale = context.getLossScale() / (float)input_.batch();
+
+  const bool has_bias =
+    std::get<props::DisableBias>(*layer_impl_props).empty() ||
+    std::get<props::DisableBias>(*layer_impl_props).get() == false;
+  const float *bias =
+    has_bias ? context.getWeight(weight_idx[LCEParams::bias]).getData<float>()
+             : nullptr;
+
+  float *dX = nullptr;
+  if (calc_deriv)
+    dX = context.getOutgoingDerivative(SINGLE_INOUT_IDX).getData<float>();
+
+  float *dW = nullptr, *db = nullptr;
+  float w_beta = 0.0f, b_beta = 0.0f;
+  if (calc_grad) {
+    dW = context.getWeightGrad(weight_idx[LCEParams::weight]).getData<float>();
+    if (!context.isGradientFirstAccess(weight_idx[LCEParams::weight]))
+      w_beta = 1.0f;
+    if (has_bias) {
+      db = context.getWeightGrad(weight_idx[LCEParams::bias]).getData<float>();
+      if (!context.isGradientFirstAccess(weight_idx[LCEParams::bias]))
+        b_beta = 1.0f;
+    }
+  }
+
+  Tensor logits = context.getScratchTensor(TensorDim(1, 1, rows, chunk));
+
+  const float *X = input_.getData<float>();
+  const float *W = weight.getData<float>();
+  const float *y = label.getData<float>();
+  const float *m = lse.getData<float>();
+  float *dZ = logits.getData<float>();
+
+  for (unsigned int from = 0; from < classes; from += chunk) {
+    const unsigned int len = std::min(chunk, classes - from);
+    chunkLogits(X, W, bias, rows, hidden, classes, from, len, dZ);
+
+    /** dZ = (softmax(Z) - onehot(y)) * scale, zero for dropped tokens */
+    for (unsigned int r = 0; r < rows; ++r) {
+      float *dz = dZ + (size_t)r * len;
+      int t = labelIndex(y[r], classes);
+      if (t < 0) {
+        std::fill(dz, dz + len, 0.0f);
+        continue;
+      }
+      for (unsigned int j = 0; j < len; ++j)
+        dz[j] = std::exp(dz[j] - m[r]) * scale;
+      if (t >= (int)from && t < (int)(from + len))
+        dz[t - from] -= scale;
+    }
+
+    if (calc_deriv)
+      sgemm(0, false, true, rows, hidden, len, 1.0f, dZ, len, W + from,
+            classes, from == 0 ? 0.0f : 1.0f, dX, hidden);
+
+    if (calc_grad) {
+      sgemm(0, true, false, hidden, len, rows, 1.0f, X, hidden, dZ, len,
+            w_beta, dW + from, classes);
+      if (db != nullptr)
+        reduce_sum(1, rows, len, dZ, db + from, 1.0f, b_beta);
+    }
+  }
+}
+
+} // namespace nntrainer
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   linear_cross_entropy_loss_layer.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Fused linear and softmax cross entropy loss layer which never
+ * materializes the logits
+ *
+ */
+
+#ifndef __LINEAR_CROSS_ENTROPY_LOSS_LAYER_H__
+#define __LINEAR_CROSS_ENTROPY_LOSS_LAYER_H__
+#ifdef __cplusplus
+
+#include <common_properties.h>
+#include <layer_impl.h>
+
+namespace nntrainer {
+
+/**
+ * @class   LinearCrossEntropyLossLayer
+ * @brief   Fully connected layer followed by softmax cross entropy loss
+ * @details The layer takes hidden states (B, 1, T, H) and a label (B, 1, T, 1)
+ * holding the class index of every token, an index outside of [0, unit) drops
+ * the token from the loss. The weight has the fully connected layout
+ * (1, 1, H, unit). Logits are computed vocab_chunk classes at a time with an
+ * online log-sum-exp, and the backward pass recomputes every chunk to write
+ * the gradients directly, so memory grows with T * vocab_chunk instead of
+ * T * unit. The output is the loss of each token. Only FP32 in NCHW is
+ * supported.
+ * @note    The logits are never an output. Without a label, as in inference,
+ * the output is zeros, so a model that needs the logits at inference ends in
+ * a fully connected layer sharing the weight instead.
+ */
+class LinearCrossEntropyLossLayer : public LayerImpl {
+public:
+  /**
+   * @brief     Constructor of Linear Cross Entropy Loss Layer
+   */
+  LinearCrossEntropyLossLayer();
+
+  /**
+   * @brief     Destructor of Linear Cross Entropy Loss Layer
+   */
+  ~LinearCrossEntropyLossLayer() = default;
+
+  /**
+   * @copydoc Layer::finalize(InitLayerContext &context)
+   */
+  void finalize(InitLayerContext &context) override;
+
+  /**
+   * @copydoc Layer::forwarding(RunLayerContext &context, bool training)
+   */
+  void forwarding(RunLayerContext &context, bool training) override;
+
+  /**
+   * @copydoc Layer::calcDerivative(RunLayerContext &context)
+   * @note the derivative is already written if calcGradient() ran after the
+   * last forwarding
+   */
+  void calcDerivative(RunLayerContext &context) override;
+
+  /**
+   * @copydoc Layer::calcGradient(RunLayerContext &context)
+   * @note the derivative of the input is computed in the same pass
+   */
+  void calcGradient(RunLayerContext &context) override;
+
+  /**
+   * @copydoc Layer::exportTo(Exporter &exporter, ml::train::ExportMethods
+   * method)
+   */
+  void exportTo(Exporter &exporter,
+                const ml::train::ExportMethods &method) const override;
+
+  /**
+   * @copydoc Layer::setProperty(const std::vector<std::string> &values)
+   */
+  void setProperty(const std::vector<std::string> &values) override;
+
+  /**
+   * @copydoc Layer::setBatch(RunLayerContext &context, unsigned int batch)
+   */
+  void setBatch(RunLayerContext &context, unsigned int batch) override;
+
+  /**
+   * @copydoc Layer::getType()
+   */
+  const std::string getType() const override {
+    return LinearCrossEntropyLossLayer::type;
+  };
+
+  /**
+   * @copydoc Layer::supportBackwarding()
+   */
+  bool supportBackwarding() const override { return true; }
+
+  /**
+   * @copydoc Layer::requireLabel()
+   */
+  bool requireLabel() const override { return true; }
+
+  static constexpr const char *type = "linear_cross_entropy";
+
+private:
+  std::tuple<props::Unit, props::VocabChunk>
+    lce_props; /**< unit - number of classes, vocab_chunk - classes computed
+                  at once */
+  std::array<unsigned int, 2> weight_idx; /**< indices of the weights */
+  unsigned int lse_idx; /**< index of the log-sum-exp of every token */
+  bool derivative_ready; /**< calcGradient() wrote the derivative of the
+                            last forwarding */
+
+  /**
+   * @brief recompute the logits chunk by chunk and backpropagate the loss
+   *
+   * @param context run context
+   * @param calc_grad accumulate the gradients of the weights
+   * @param calc_deriv write the derivative of the input
+   */
+  void backwarding(RunLayerContext &context, bool calc_grad, bool calc_deriv);
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __LINEAR_CROSS_ENTROPY_LOSS_LAYER_H__ */
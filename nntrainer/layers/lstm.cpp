@@ -17,6 +17,7 @@
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
+#include <scratch_arena.h>
 
 namespace nntrainer {
 
@@ -43,10 +44,10 @@ enum LSTMParams {
 };
 
 void LSTMLayer::forwardingBatchFirstLSTM(
-  unsigned int NUM_GATE, const unsigned int batch_size,
-  const unsigned int feature_size, const bool disable_bias,
-  const unsigned int unit, const bool integrate_bias, ActiFunc &acti_func,
-  ActiFunc &recurrent_acti_func, const bool enable_dropout,
+  RunLayerContext &context, unsigned int NUM_GATE,
+  const unsigned int batch_size, const unsigned int feature_size,
+  const bool disable_bias, const unsigned int unit, const bool integrate_bias,
+  ActiFunc &acti_func, ActiFunc &recurrent_acti_func, const bool enable_dropout,
   const float dropout_rate, const unsigned int max_timestep, const bool reverse,
   const Tensor &input_, const Tensor &weight_ih, const Tensor &weight_hh,
   const Tensor &bias_h, const Tensor &bias_ih, const Tensor &bias_hh,
@@ -59,6 +60,10 @@ void LSTMLayer::forwardingBatchFirstLSTM(
   TensorDim unit_tensor_dim({unit}, tensor_type);
   TensorDim num_gate_unit_tensor_dim({NUM_GATE * unit}, tensor_type);
 
+  /// hidden and cell state before the first timestep
+  Tensor initial_state = context.getScratchTensor(unit_tensor_dim);
+  initial_state.setZero();
+
   for (unsigned int batch = 0; batch < batch_size; ++batch) {
     const Tensor input_sample = input_.getBatchSlice(batch, 1);
     Tensor hidden_state_sample = hidden_state_.getBatchSlice(batch, 1);
@@ -69,26 +74,18 @@ void LSTMLayer::forwardingBatchFirstLSTM(
       Tensor input = input_sample.getSharedDataTensor(
         input_tensor_dim, (reverse ? max_timestep - 1 - t : t) * feature_size);
 
-      Tensor prev_hidden_state = Tensor(
-        "prev_hidden_state", weight_ih.getFormat(), weight_ih.getDataType());
-
-      if (!t) {
-        prev_hidden_state = Tensor(unit, tensor_type);
-        prev_hidden_state.setZero();
-      } else {
-        prev_hidden_state = hidden_state_sample.getSharedDataTensor(
-          unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-      }
+      const Tensor prev_hidden_state =
+        !t ? initial_state
+           : hidden_state_sample.getSharedDataTensor(
+               unit_tensor_dim,
+               (reverse ? (max_timestep - t) : (t - 1)) * unit);
       Tensor hidden_state = hidden_state_sample.getSharedDataTensor(
         unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
-      Tensor prev_cell_state;
-      if (!t) {
-        prev_cell_state = Tensor(unit, tensor_type);
-        prev_cell_state.setZero();
-      } else {
-        prev_cell_state = cell_state_sample.getSharedDataTensor(
-          unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-      }
+      const Tensor prev_cell_state =
+        !t ? initial_state
+           : cell_state_sample.getSharedDataTensor(
+               unit_tensor_dim,
+               (reverse ? (max_timestep - t) : (t - 1)) * unit);
       Tensor cell_state = cell_state_sample.getSharedDataTensor(
         unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
       Tensor ifgo = ifgo_sample.getSharedDataTensor(
@@ -112,11 +109,12 @@ void LSTMLayer::forwardingBatchFirstLSTM(
 }
 
 void LSTMLayer::calcGradientBatchFirstLSTM(
-  unsigned int NUM_GATE, const unsigned int batch_size,
-  const unsigned int feature_size, const bool disable_bias,
-  const unsigned int unit, const bool integrate_bias, ActiFunc &acti_func,
-  ActiFunc &recurrent_acti_func, const bool return_sequences,
-  const bool bidirectional, const bool enable_dropout, const float dropout_rate,
+  RunLayerContext &context, unsigned int NUM_GATE,
+  const unsigned int batch_size, const unsigned int feature_size,
+  const bool disable_bias, const unsigned int unit, const bool integrate_bias,
+  ActiFunc &acti_func, ActiFunc &recurrent_acti_func,
+  const bool return_sequences, const bool bidirectional,
+  const bool enable_dropout, const float dropout_rate,
   const unsigned int max_timestep, const bool reverse, const Tensor &input_,
   const Tensor &incoming_derivative, Tensor &d_weight_ih,
   const Tensor &weight_hh, Tensor &d_weight_hh, Tensor &d_bias_h,
@@ -214,6 +212,19 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
 
     auto batch_job = [&](unsigned int s, unsigned int e, unsigned int pid,
                          void *user_data) {
+      /// workers run on their own threads and arenas
+      ScratchArena::Scope scratch;
+      /// hidden and cell state before the first timestep and the sinks of
+      /// their derivatives
+      Tensor initial_state = context.getScratchTensor(unit_tensor_dim);
+      initial_state.setZero();
+      Tensor d_initial_hidden_state = context.getScratchTensor(unit_tensor_dim);
+      Tensor d_initial_cell_state = context.getScratchTensor(unit_tensor_dim);
+      // Temporary variable for d_prev_hidden_state. d_prev_hidden_state
+      // already have precalculated values from incomming derivatives
+      Tensor d_prev_hidden_state_temp =
+        context.getScratchTensor(unit_tensor_dim);
+
       for (unsigned int batch = s; batch < e; ++batch) {
         const Tensor input_sample = input_.getBatchSlice(batch, 1);
 
@@ -247,9 +258,8 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
             (reverse ? max_timestep - 1 - t : t) * feature_size);
 
           if (!t) {
-            prev_hidden_state = Tensor(unit, tensor_type);
-            prev_hidden_state.setZero();
-            d_prev_hidden_state = Tensor(unit, tensor_type);
+            prev_hidden_state = initial_state;
+            d_prev_hidden_state = d_initial_hidden_state;
             d_prev_hidden_state.setZero();
           } else {
             prev_hidden_state = hidden_state_sample.getSharedDataTensor(
@@ -261,9 +271,8 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
             unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
 
           if (!t) {
-            prev_cell_state = Tensor(unit, tensor_type);
-            prev_cell_state.setZero();
-            d_prev_cell_state = Tensor(unit, tensor_type);
+            prev_cell_state = initial_state;
+            d_prev_cell_state = d_initial_cell_state;
             d_prev_cell_state.setZero();
           } else {
             prev_cell_state = cell_state_sample.getSharedDataTensor(
@@ -283,12 +292,6 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
             num_gate_tensor_dim,
             (reverse ? max_timestep - 1 - t : t) * NUM_GATE * unit);
 
-          // Temporary variable for d_prev_hidden_state. d_prev_hidden_state
-          // already have precalculated values from incomming derivatives
-          Tensor d_prev_hidden_state_temp =
-            Tensor("d_prev_hidden_state_temp", tensor_type.format,
-                   tensor_type.data_type);
-
           calcGradientLSTM(
             1, unit, disable_bias, integrate_bias, acti_func,
             recurrent_acti_func, input, prev_hidden_state,
@@ -326,6 +329,17 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
     }
 
   } else {
+    /// hidden and cell state before the first timestep and the sinks of
+    /// their derivatives
+    Tensor initial_state = context.getScratchTensor(unit_tensor_dim);
+    initial_state.setZero();
+    Tensor d_initial_hidden_state = context.getScratchTensor(unit_tensor_dim);
+    Tensor d_initial_cell_state = context.getScratchTensor(unit_tensor_dim);
+    // Temporary variable for d_prev_hidden_state. d_prev_hidden_state
+    // already have precalculated values from incomming derivatives
+    Tensor d_prev_hidden_state_temp =
+      context.getScratchTensor(unit_tensor_dim);
+
     for (unsigned int batch = 0; batch < batch_size; ++batch) {
       const Tensor input_sample = input_.getBatchSlice(batch, 1);
 
@@ -352,9 +366,8 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
           (reverse ? max_timestep - 1 - t : t) * feature_size);
 
         if (!t) {
-          prev_hidden_state = Tensor(unit, tensor_type);
-          prev_hidden_state.setZero();
-          d_prev_hidden_state = Tensor(unit, tensor_type);
+          prev_hidden_state = initial_state;
+          d_prev_hidden_state = d_initial_hidden_state;
           d_prev_hidden_state.setZero();
         } else {
           prev_hidden_state = hidden_state_sample.getSharedDataTensor(
@@ -366,9 +379,8 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
           unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
 
         if (!t) {
-          prev_cell_state = Tensor(unit, tensor_type);
-          prev_cell_state.setZero();
-          d_prev_cell_state = Tensor(unit, tensor_type);
+          prev_cell_state = initial_state;
+          d_prev_cell_state = d_initial_cell_state;
           d_prev_cell_state.setZero();
         } else {
           prev_cell_state = cell_state_sample.getSharedDataTensor(
@@ -388,12 +400,6 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
           num_gate_tensor_dim,
           (reverse ? max_timestep - 1 - t : t) * NUM_GATE * unit);
 
-        // Temporary variable for d_prev_hidden_state. d_prev_hidden_state
-        // already have precalculated values from incomming derivatives
-        Tensor d_prev_hidden_state_temp =
-          Tensor("d_prev_hidden_state_temp", tensor_type.format,
-                 tensor_type.data_type);
-
         calcGradientLSTM(1, unit, disable_bias, integrate_bias, acti_func,
                          recurrent_acti_func, input, prev_hidden_state,
                          d_prev_hidden_state_temp, prev_cell_state,
@@ -686,11 +692,12 @@ void LSTMLayer::forwarding(RunLayerContext &context, bool training) {
   Tensor &mask = enable_dropout
                    ? context.getTensor(wt_idx[LSTMParams::dropout_mask])
                    : empty;
-  forwardingBatchFirstLSTM(NUM_GATE, batch_size, feature_size, disable_bias,
-                           unit, integrate_bias, acti_func, recurrent_acti_func,
-                           enable_dropout, dropout_rate, max_timestep, false,
-                           input, weight_ih, weight_hh, bias_h, bias_ih,
-                           bias_hh, hidden_state, cell_state, ifgo, mask);
+  forwardingBatchFirstLSTM(context, NUM_GATE, batch_size, feature_size,
+                           disable_bias, unit, integrate_bias, acti_func,
+                           recurrent_acti_func, enable_dropout, dropout_rate,
+                           max_timestep, false, input, weight_ih, weight_hh,
+                           bias_h, bias_ih, bias_hh, hidden_state, cell_state,
+                           ifgo, mask);
   if (bidirectional) {
     const Tensor &reverse_weight_ih =
       context.getWeight(wt_idx[LSTMParams::reverse_weight_ih]);
@@ -716,11 +723,11 @@ void LSTMLayer::forwarding(RunLayerContext &context, bool training) {
     Tensor &reverse_ifgo = context.getTensor(wt_idx[LSTMParams::reverse_ifgo]);
 
     forwardingBatchFirstLSTM(
-      NUM_GATE, batch_size, feature_size, disable_bias, unit, integrate_bias,
-      acti_func, recurrent_acti_func, enable_dropout, dropout_rate,
-      max_timestep, true, input, reverse_weight_ih, reverse_weight_hh,
-      reverse_bias_h, reverse_bias_ih, reverse_bias_hh, reverse_hidden_state,
-      reverse_cell_state, reverse_ifgo, mask);
+      context, NUM_GATE, batch_size, feature_size, disable_bias, unit,
+      integrate_bias, acti_func, recurrent_acti_func, enable_dropout,
+      dropout_rate, max_timestep, true, input, reverse_weight_ih,
+      reverse_weight_hh, reverse_bias_h, reverse_bias_ih, reverse_bias_hh,
+      reverse_hidden_state, reverse_cell_state, reverse_ifgo, mask);
   }
 
   if (return_sequences && !bidirectional) {
@@ -875,9 +882,9 @@ void LSTMLayer::calcGradient(RunLayerContext &context) {
                          : empty;
 
   calcGradientBatchFirstLSTM(
-    NUM_GATE, batch_size, feature_size, disable_bias, unit, integrate_bias,
-    acti_func, recurrent_acti_func, return_sequences, bidirectional,
-    enable_dropout, dropout_rate, max_timestep, false, input,
+    context, NUM_GATE, batch_size, feature_size, disable_bias, unit,
+    integrate_bias, acti_func, recurrent_acti_func, return_sequences,
+    bidirectional, enable_dropout, dropout_rate, max_timestep, false, input,
     incoming_derivative, d_weight_ih, weight_hh, d_weight_hh, d_bias_h,
     d_bias_ih, d_bias_hh, hidden_state, d_hidden_state, cell_state,
     d_cell_state, ifgo, d_ifgo, mask);
@@ -917,9 +924,9 @@ void LSTMLayer::calcGradient(RunLayerContext &context) {
       context.getTensorGrad(wt_idx[LSTMParams::reverse_ifgo]);
 
     calcGradientBatchFirstLSTM(
-      NUM_GATE, batch_size, feature_size, disable_bias, unit, integrate_bias,
-      acti_func, recurrent_acti_func, return_sequences, bidirectional,
-      enable_dropout, dropout_rate, max_timestep, true, input,
+      context, NUM_GATE, batch_size, feature_size, disable_bias, unit,
+      integrate_bias, acti_func, recurrent_acti_func, return_sequences,
+      bidirectional, enable_dropout, dropout_rate, max_timestep, true, input,
       incoming_derivative, reverse_d_weight_ih, reverse_weight_hh,
       reverse_d_weight_hh, reverse_d_bias_h, reverse_d_bias_ih,
       reverse_d_bias_hh, reverse_hidden_state, reverse_d_hidden_state,
@@ -120,6 +120,7 @@ private:
   /**
    * @brief run lstm fowarding for batch_first input
    *
+   * @param context run layer context for scratch tensors
    * @param NUM_GATE Number of gate which is 4 for lstm
    * @param batch_size batch size
    * @param feature_size feature size
@@ -146,19 +147,20 @@ private:
    * @param mask_ dropout mask
    */
   void forwardingBatchFirstLSTM(
-    unsigned int NUM_GATE, const unsigned int batch_size,
-    const unsigned int feature_size, const bool disable_bias,
-    const unsigned int unit, const bool integrate_bias, ActiFunc &acti_func,
-    ActiFunc &recurrent_acti_func, const bool enable_dropout,
-    const float dropout_rate, const unsigned int max_timestep,
-    const bool reverse, const Tensor &input_, const Tensor &weight_ih,
-    const Tensor &weight_hh, const Tensor &bias_h, const Tensor &bias_ih,
-    const Tensor &bias_hh, Tensor &hidden_state_, Tensor &cell_state_,
-    Tensor &ifgo_, const Tensor &mask_);
+    RunLayerContext &context, unsigned int NUM_GATE,
+    const unsigned int batch_size, const unsigned int feature_size,
+    const bool disable_bias, const unsigned int unit, const bool integrate_bias,
+    ActiFunc &acti_func, ActiFunc &recurrent_acti_func,
+    const bool enable_dropout, const float dropout_rate,
+    const unsigned int max_timestep, const bool reverse, const Tensor &input_,
+    const Tensor &weight_ih, const Tensor &weight_hh, const Tensor &bias_h,
+    const Tensor &bias_ih, const Tensor &bias_hh, Tensor &hidden_state_,
+    Tensor &cell_state_, Tensor &ifgo_, const Tensor &mask_);
 
   /**
    * @brief calculate lstm gradient for batch_first input
    *
+   * @param context run layer context for scratch tensors
    * @param NUM_GATE Number of gate which is 4 for lstm
    * @param batch_size batch size
    * @param feature_size feature size
@@ -194,18 +196,18 @@ private:
    * @param mask_ dropout mask
    */
   void calcGradientBatchFirstLSTM(
-    unsigned int NUM_GATE, const unsigned int batch_size,
-    const unsigned int feature_size, const bool disable_bias,
-    const unsigned int unit, const bool integrate_bias, ActiFunc &acti_func,
-    ActiFunc &recurrent_acti_func, const bool return_sequences,
-    const bool bidirectional, const bool enable_dropout,
-    const float dropout_rate, const unsigned int max_timestep,
-    const bool reverse, const Tensor &input_, const Tensor &incoming_derivative,
-    Tensor &d_weight_ih, const Tensor &weight_hh, Tensor &d_weight_hh,
-    Tensor &d_bias_h, Tensor &d_bias_ih, Tensor &d_bias_hh,
-    const Tensor &hidden_state_, Tensor &d_hidden_state_,
-    const Tensor &cell_state_, Tensor &d_cell_state_, const Tensor &ifgo_,
-    Tensor &d_ifgo_, const Tensor &mask_);
+    RunLayerContext &context, unsigned int NUM_GATE,
+    const unsigned int batch_size, const unsigned int feature_size,
+    const bool disable_bias, const unsigned int unit, const bool integrate_bias,
+    ActiFunc &acti_func, ActiFunc &recurrent_acti_func,
+    const bool return_sequences, const bool bidirectional,
+    const bool enable_dropout, const float dropout_rate,
+    const unsigned int max_timestep, const bool reverse, const Tensor &input_,
+    const Tensor &incoming_derivative, Tensor &d_weight_ih,
+    const Tensor &weight_hh, Tensor &d_weight_hh, Tensor &d_bias_h,
+    Tensor &d_bias_ih, Tensor &d_bias_hh, const Tensor &hidden_state_,
+    Tensor &d_hidden_state_, const Tensor &cell_state_, Tensor &d_cell_state_,
+    const Tensor &ifgo_, Tensor &d_ifgo_, const Tensor &mask_);
 };
 } // namespace nntrainer
 
@@ -66,6 +66,18 @@ enum AttentionParams {
   attention_output,
 };
 
+/**
+ * @brief view a (batch, 1, seq, num_heads * head_dim) tensor as
+ * (batch, num_heads, seq, head_dim) without copying
+ */
+static Tensor getHeadsView(const Tensor &tensor, unsigned int batch,
+                           unsigned int seq, unsigned int num_heads,
+                           unsigned int head_dim) {
+  TensorDim dim({batch, seq, num_heads, head_dim}, tensor.getTensorType());
+  return tensor.getSharedDataTensor(dim, 0, true, tensor.getName())
+    .getTransposedView("1:0:2");
+}
+
 void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
   NNTR_THROW_IF(context.getNumInputs() < 3 || context.getNumInputs() > 4,
                 std::invalid_argument)
@@ -424,37 +436,19 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
     projected_value.add_i(value_fc_bias);
   }
 
-  projected_query.reshape(
-    TensorDim({batch_size, query_height, num_heads, projected_query_dim_prop}));
-  projected_key.reshape(
-    TensorDim({batch_size, key_height, num_heads, projected_key_dim_prop}));
-  projected_value.reshape(
-    TensorDim({batch_size, value_height, num_heads, projected_value_dim_prop}));
-
-  projected_query = projected_query.transpose("1:0:2");
-  projected_key = projected_key.transpose("1:0:2");
-  projected_value = projected_value.transpose("1:0:2");
-
-  /** set tensor name to restore origin name cause origin name was remove during
-   * transpose */
-  projected_query.setName("multi_head_attention:projected_query");
-  projected_key.setName("multi_head_attention:projected_key");
-  projected_value.setName("multi_head_attention:projected_value");
-
-  projected_query.reshape(TensorDim(
-    {batch_size * num_heads, 1, query_height, projected_query_dim_prop}));
-  projected_key.reshape(
-    TensorDim({batch_size * num_heads, 1, key_height, projected_key_dim_prop}));
-  projected_value.reshape(TensorDim(
-    {batch_size * num_heads, 1, value_height, projected_value_dim_prop}));
-
-  attention_weight.reshape(
-    TensorDim({batch_size * num_heads, 1, query_height, key_height}));
-  attention_output.reshape(TensorDim(
-    {batch_size * num_heads, 1, query_height, projected_value_dim_prop}));
+  /** split the heads through strided views instead of transposed copies */
+  Tensor query_heads = getHeadsView(projected_query, batch_size, query_height,
+                                    num_heads, projected_query_dim_prop);
+  Tensor key_heads = getHeadsView(projected_key, batch_size, key_height,
+                                  num_heads, projected_key_dim_prop);
+  Tensor value_heads = getHeadsView(projected_value, batch_size, value_height,
+                                    num_heads, projected_value_dim_prop);
+  Tensor output_heads = getHeadsView(attention_output, batch_size,
+                                     query_height, num_heads,
+                                     projected_value_dim_prop);
 
   /** scaled dot product attention */
-  projected_query.dotBatched(projected_key, attention_weight, false, true);
+  query_heads.dotBatched(key_heads, attention_weight, false, true);
   attention_weight.multiply_i(1 / sqrt((float)projected_query_dim_prop));
 
   if (provide_attention_mask) {
@@ -473,11 +467,7 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
     // attention_mask.multiply_i(mask);
     // attention_weight.add_i(attention_mask);
 
-    attention_weight.reshape(
-      TensorDim({batch_size, num_heads, query_height, key_height}));
     attention_weight.add_i(mask);
-    attention_weight.reshape(
-      TensorDim({batch_size * num_heads, 1, query_height, key_height}));
   }
 
   sm.run_fn(attention_weight, attention_weight);
@@ -497,48 +487,19 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
   if (return_attention_weight ==
       props::ReturnAttentionWeightInfo::Enum::after) {
     if (average_attention_weight) {
-      attention_weight.reshape(
-        TensorDim({batch_size, num_heads, query_height, key_height}));
       attention_weight.sum(1, ret_attention_weight, 1, 0);
       ret_attention_weight.divide_i(num_heads);
-      attention_weight.reshape(
-        TensorDim({batch_size * num_heads, 1, query_height, key_height}));
     } else {
       ret_attention_weight.copyData(attention_weight);
     }
   }
 
-  attention_weight.dotBatched(projected_value, attention_output);
-
-  attention_output.reshape(
-    TensorDim({batch_size, num_heads, query_height, projected_value_dim_prop}));
-
-  attention_output = attention_output.transpose("1:0:2");
-
-  /** set tensor name to restore origin name cause origin name was remove during
-   * transpose */
-  attention_output.setName("multi_head_attention:attention_output");
-
-  attention_output.reshape(TensorDim(
-    {batch_size * query_height, 1, 1, num_heads * projected_value_dim_prop}));
+  attention_weight.dotBatched(value_heads, output_heads);
 
   attention_output.dot(fc_weight, output);
   if (!disable_bias) {
     output.add_i(fc_bias);
   }
-
-  /** restore shape */
-  projected_query.reshape(TensorDim(
-    {batch_size, 1, query_height, num_heads * projected_query_dim_prop}));
-  projected_key.reshape(
-    TensorDim({batch_size, 1, key_height, num_heads * projected_key_dim_prop}));
-  projected_value.reshape(TensorDim(
-    {batch_size, 1, value_height, num_heads * projected_value_dim_prop}));
-
-  attention_weight.reshape(
-    TensorDim({batch_size, num_heads, query_height, key_height}));
-  attention_output.reshape(TensorDim(
-    {batch_size, 1, query_height, num_heads * projected_value_dim_prop}));
 }
 
 void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
@@ -613,39 +574,25 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
   /** get tensors */
   Tensor &projected_query =
     context.getTensor(weight_idx[AttentionParams::projected_query]);
-  Tensor &projected_key =
-    context.getTensor(weight_idx[AttentionParams::projected_key]);
-  Tensor &projected_value =
-    context.getTensor(weight_idx[AttentionParams::projected_value]);
   Tensor &cache_key = context.getTensor(weight_idx[AttentionParams::cache_key]);
   Tensor &cache_value =
     context.getTensor(weight_idx[AttentionParams::cache_value]);
 
   TensorDim projected_query_dim = projected_query.getDim();
-  TensorDim projected_key_dim = projected_key.getDim();
-  TensorDim projected_value_dim = projected_value.getDim();
   TensorDim cache_key_dim = cache_key.getDim();
   TensorDim cache_value_dim = cache_value.getDim();
 
   TensorDim projected_query_step_dim = projected_query_dim;
 
-  TensorDim projected_key_step_dim = projected_key_dim;
-  TensorDim projected_value_step_dim = projected_value_dim;
   TensorDim cache_key_step_dim = cache_key_dim;
   TensorDim cache_value_step_dim = cache_value_dim;
   projected_query_step_dim.height(to - from);
 
-  projected_key_step_dim.height(to);
-  projected_value_step_dim.height(to);
   cache_key_step_dim.height(to - from);
   cache_value_step_dim.height(to - from);
 
   Tensor projected_query_step =
     projected_query.getSharedDataTensor(projected_query_step_dim, 0, true);
-  Tensor projected_key_step =
-    projected_key.getSharedDataTensor(projected_key_step_dim, 0, true);
-  Tensor projected_value_step =
-    projected_value.getSharedDataTensor(projected_value_step_dim, 0, true);
 
   Tensor cache_key_step = cache_key.getSharedDataTensor(
     cache_key_step_dim, from * cache_key_dim.width(), true);
@@ -700,31 +647,19 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
     cache_value_step.add_i(value_fc_bias);
   }
 
-  projected_query_step.reshape(
-    TensorDim({batch_size, 1, num_heads, projected_query_dim_prop}));
-  cached_key.reshape(
-    TensorDim({batch_size, to, num_heads, projected_key_dim_prop}));
-  cached_value.reshape(
-    TensorDim({batch_size, to, num_heads, projected_value_dim_prop}));
-
-  projected_query_step.transpose("1:0:2", projected_query_step);
-  cached_key.transpose("1:0:2", projected_key_step);
-  cached_value.transpose("1:0:2", projected_value_step);
-
-  projected_query_step.reshape(
-    TensorDim({batch_size * num_heads, 1, 1, projected_query_dim_prop}));
-  projected_key_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_key_dim_prop}));
-  projected_value_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_value_dim_prop}));
-
-  attention_weight_step.reshape(TensorDim({batch_size * num_heads, 1, 1, to}));
-  attention_output_step.reshape(
-    TensorDim({batch_size * num_heads, 1, 1, projected_value_dim_prop}));
+  Tensor query_heads = getHeadsView(projected_query_step, batch_size,
+                                    to - from, num_heads,
+                                    projected_query_dim_prop);
+  Tensor key_heads = getHeadsView(cached_key, batch_size, to, num_heads,
+                                  projected_key_dim_prop);
+  Tensor value_heads = getHeadsView(cached_value, batch_size, to, num_heads,
+                                    projected_value_dim_prop);
+  Tensor output_heads = getHeadsView(attention_output_step, batch_size,
+                                     to - from, num_heads,
+                                     projected_value_dim_prop);
 
   /** scaled dot product attention */
-  projected_query_step.dotBatched(projected_key_step, attention_weight_step,
-                                  false, true);
+  query_heads.dotBatched(key_heads, attention_weight_step, false, true);
   attention_weight_step.multiply_i(1 / sqrt((float)projected_query_dim_prop));
 
   if (!from) {
@@ -754,15 +689,7 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
 
   sm.run_fn(attention_weight_step, attention_weight_step);
 
-  attention_weight_step.dotBatched(projected_value_step, attention_output_step);
-
-  attention_output_step.reshape(
-    TensorDim({batch_size, num_heads, to - from, projected_value_dim_prop}));
-
-  attention_output_step = attention_output_step.transpose("1:0:2");
-
-  attention_output_step.reshape(TensorDim(
-    {batch_size * (to - from), 1, 1, num_heads * projected_value_dim_prop}));
+  attention_weight_step.dotBatched(value_heads, output_heads);
 
   attention_output_step.dot(fc_weight, output);
   if (!disable_bias) {
@@ -831,39 +758,26 @@ void MultiHeadAttentionLayer::calcCommonDerivative(RunLayerContext &context) {
 
   d_attention_output.dot_deriv_wrt_1(fc_weight, incoming_derivative);
 
-  d_attention_output.reshape(
-    TensorDim({batch_size, query_height, num_heads, projected_value_dim_prop}));
-
-  d_attention_output = d_attention_output.transpose("1:0:2");
-
-  /** set tensor name to restore origin name cause origin name was remove
-   * during transpose */
-  d_attention_output.setName("multi_head_attention:attention_output:grad");
-
-  projected_query.reshape(TensorDim(
-    {batch_size * num_heads, 1, query_height, projected_query_dim_prop}));
-  d_projected_query.reshape(TensorDim(
-    {batch_size * num_heads, 1, query_height, projected_query_dim_prop}));
-  projected_key.reshape(
-    TensorDim({batch_size * num_heads, 1, key_height, projected_key_dim_prop}));
-  d_projected_key.reshape(
-    TensorDim({batch_size * num_heads, 1, key_height, projected_key_dim_prop}));
-  projected_value.reshape(TensorDim(
-    {batch_size * num_heads, 1, value_height, projected_value_dim_prop}));
-  d_projected_value.reshape(TensorDim(
-    {batch_size * num_heads, 1, value_height, projected_value_dim_prop}));
-
-  attention_weight.reshape(
-    TensorDim({batch_size * num_heads, 1, query_height, key_height}));
-  d_attention_weight.reshape(
-    TensorDim({batch_size * num_heads, 1, query_height, key_height}));
-  d_attention_output.reshape(TensorDim(
-    {batch_size * num_heads, 1, query_height, projected_value_dim_prop}));
-
-  d_attention_weight.dot_batched_deriv_wrt_1(projected_value,
-                                             d_attention_output);
-  attention_weight.dot_batched_deriv_wrt_2(d_projected_value,
-                                           d_attention_output);
+  Tensor query_heads = getHeadsView(projected_query, batch_size, query_height,
+                                    num_heads, projected_query_dim_prop);
+  Tensor d_query_heads = getHeadsView(d_projected_query, batch_size,
+                                      query_height, num_heads,
+                                      projected_query_dim_prop);
+  Tensor key_heads = getHeadsView(projected_key, batch_size, key_height,
+                                  num_heads, projected_key_dim_prop);
+  Tensor d_key_heads = getHeadsView(d_projected_key, batch_size, key_height,
+                                    num_heads, projected_key_dim_prop);
+  Tensor value_heads = getHeadsView(projected_value, batch_size, value_height,
+                                    num_heads, projected_value_dim_prop);
+  Tensor d_value_heads = getHeadsView(d_projected_value, batch_size,
+                                      value_height, num_heads,
+                                      projected_value_dim_prop);
+  Tensor d_output_heads = getHeadsView(d_attention_output, batch_size,
+                                       query_height, num_heads,
+                                       projected_value_dim_prop);
+
+  d_attention_weight.dot_batched_deriv_wrt_1(value_heads, d_output_heads);
+  attention_weight.dot_batched_deriv_wrt_2(d_value_heads, d_output_heads);
 
   if (return_attention_weight ==
       props::ReturnAttentionWeightInfo::Enum::after) {
@@ -890,48 +804,10 @@ void MultiHeadAttentionLayer::calcCommonDerivative(RunLayerContext &context) {
   d_attention_weight.multiply_i(
     1 / sqrt((float)projected_query_dim_prop)); /** scale */
 
-  d_projected_query.dot_batched_deriv_wrt_1(projected_key, d_attention_weight,
-                                            false, true);
-  projected_query.dot_batched_deriv_wrt_2(d_projected_key, d_attention_weight,
-                                          false, true);
-
-  d_projected_query.reshape(
-    TensorDim({batch_size, num_heads, query_height, projected_query_dim_prop}));
-  d_projected_key.reshape(
-    TensorDim({batch_size, num_heads, key_height, projected_key_dim_prop}));
-  d_projected_value.reshape(
-    TensorDim({batch_size, num_heads, value_height, projected_value_dim_prop}));
-
-  d_projected_query = d_projected_query.transpose("1:0:2");
-  d_projected_key = d_projected_key.transpose("1:0:2");
-  d_projected_value = d_projected_value.transpose("1:0:2");
-
-  /** set tensor name to restore origin name cause origin name was remove
-   * during transpose */
-  d_projected_query.setName("multi_head_attention:projected_query:grad");
-  d_projected_key.setName("multi_head_attention:projected_key:grad");
-  d_projected_value.setName("multi_head_attention:projected_value:grad");
-
-  /** restore shape */
-  projected_query.reshape(TensorDim(
-    {batch_size, 1, query_height, num_heads * projected_query_dim_prop}));
-  d_projected_query.reshape(TensorDim(
-    {batch_size * query_height, 1, 1, num_heads * projected_query_dim_prop}));
-  projected_key.reshape(
-    TensorDim({batch_size, 1, key_height, num_heads * projected_key_dim_prop}));
-  d_projected_key.reshape(TensorDim(
-    {batch_size * key_height, 1, 1, num_heads * projected_key_dim_prop}));
-  projected_value.reshape(TensorDim(
-    {batch_size, 1, value_height, num_heads * projected_value_dim_prop}));
-  d_projected_value.reshape(TensorDim(
-    {batch_size * value_height, 1, 1, num_heads * projected_value_dim_prop}));
-
-  attention_weight.reshape(
-    TensorDim({batch_size, num_heads, query_height, key_height}));
-  d_attention_weight.reshape(
-    TensorDim({batch_size, num_heads, query_height, key_height}));
-  d_attention_output.reshape(TensorDim(
-    {batch_size, 1, query_height, num_heads * projected_value_dim_prop}));
+  d_query_heads.dot_batched_deriv_wrt_1(key_heads, d_attention_weight, false,
+                                        true);
+  query_heads.dot_batched_deriv_wrt_2(d_key_heads, d_attention_weight, false,
+                                      true);
 }
 
 void MultiHeadAttentionLayer::calcDerivative(RunLayerContext &context) {
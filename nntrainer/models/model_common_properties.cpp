@@ -30,6 +30,14 @@ ContinueTrain::ContinueTrain(bool value) { set(value); }
 
 MemoryOptimization::MemoryOptimization(bool value) { set(value); }
 
+AutoRecompute::AutoRecompute(bool value) { set(value); }
+
+ActivationOffload::ActivationOffload(bool value) { set(value); }
+
+ActivationOffloadMinSize::ActivationOffloadMinSize(const unsigned int &value) {
+  set(value);
+}
+
 Fsu::Fsu(bool value) { set(value); }
 
 FsuPath::FsuPath(const std::string &value) { set(value); }
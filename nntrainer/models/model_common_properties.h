@@ -126,6 +126,60 @@ public:
   MemoryOptimization(bool value = true);
 };
 
+/**
+ * @brief automatic activation recompute property
+ *
+ */
+class AutoRecompute : public Property<bool> {
+public:
+  static constexpr const char *key =
+    "auto_recompute";             /**< unique key to access */
+  using prop_tag = bool_prop_tag; /**< property type */
+
+  /**
+   * @brief Constructor
+   *
+   * @param value value to set, defaults to false
+   */
+  AutoRecompute(bool value = false);
+};
+
+/**
+ * @brief activation offload property
+ *
+ */
+class ActivationOffload : public Property<bool> {
+public:
+  static constexpr const char *key =
+    "activation_offload";         /**< unique key to access */
+  using prop_tag = bool_prop_tag; /**< property type */
+
+  /**
+   * @brief Constructor
+   *
+   * @param value value to set, defaults to false
+   */
+  ActivationOffload(bool value = false);
+};
+
+/**
+ * @brief smallest activation in bytes that is offloaded
+ *
+ */
+class ActivationOffloadMinSize : public Property<unsigned int> {
+public:
+  static constexpr const char *key =
+    "activation_offload_min_size"; /**< unique key to access */
+  using prop_tag = uint_prop_tag;  /**< property type */
+
+  /**
+   * @brief Constructor
+   *
+   * @param value value to set, defaults to 1 MiB
+   */
+  ActivationOffloadMinSize(const unsigned int &value = 1024 * 1024);
+};
+
 /**
  * @brief cache size property
  *
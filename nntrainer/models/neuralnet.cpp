@@ -34,6 +34,7 @@
 #include <activation_realizer.h>
 #include <adamw.h>
 #include <common_properties.h>
+#include <cpu_backend.h>
 #include <databuffer.h>
 #include <flatten_realizer.h>
 #include <ini_interpreter.h>
@@ -53,6 +54,7 @@
 #include <remap_realizer.h>
 #include <slice_realizer.h>
 #include <util_func.h>
+#include <weight_container.h>
 
 #ifdef ENABLE_TFLITE_INTERPRETER
 #include <tflite_interpreter.h>
@@ -74,7 +76,9 @@ NeuralNetwork::NeuralNetwork() :
                    props::SavePath(), props::ContinueTrain(),
                    props::SaveBestPath(), props::MemoryOptimization(),
                    props::Fsu(), props::FsuPath(), props::FsuLookahead(),
-                   props::TensorFormat(), props::ModelTensorDataType()),
+                   props::TensorFormat(), props::ModelTensorDataType(),
+                   props::AutoRecompute(), props::ActivationOffload(),
+                   props::ActivationOffloadMinSize()),
   load_path(std::string()),
   epoch_idx(0),
   iter(0),
@@ -93,7 +97,9 @@ NeuralNetwork::NeuralNetwork(const Engine *ct_engine_) :
                    props::SavePath(), props::ContinueTrain(),
                    props::SaveBestPath(), props::MemoryOptimization(),
                    props::Fsu(), props::FsuPath(), props::FsuLookahead(),
-                   props::TensorFormat(), props::ModelTensorDataType()),
+                   props::TensorFormat(), props::ModelTensorDataType(),
+                   props::AutoRecompute(), props::ActivationOffload(),
+                   props::ActivationOffloadMinSize()),
   load_path(std::string()),
   epoch_idx(0),
   iter(0),
@@ -191,6 +197,11 @@ int NeuralNetwork::compile(ExecutionMode mode) {
 
   model_graph.setMemoryOptimizations(
     std::get<props::MemoryOptimization>(model_flex_props));
+  model_graph.setAutoRecompute(
+    std::get<props::AutoRecompute>(model_flex_props));
+  model_graph.setActivationOffload(
+    std::get<props::ActivationOffload>(model_flex_props),
+    std::get<props::ActivationOffloadMinSize>(model_flex_props), lookahead);
   for (auto &node : graph_representation) {
     if (auto &prop = std::get<props::ClipGradByGlobalNorm>(model_props);
         !prop.empty()) {
@@ -670,6 +681,35 @@ void NeuralNetwork::save(const std::string &file_path,
       "saving with ONNX format is not supported yet.");
     break;
   }
+  case ml::train::ModelFormat::MODEL_FORMAT_WEIGHT_CONTAINER: {
+    std::vector<WeightContainer::Entry> entries;
+    std::vector<Tensor *> weights;
+    for (auto iter = model_graph.cbegin(); iter != model_graph.cend(); iter++) {
+      auto &context = (*iter)->getRunContext();
+      for (unsigned int i = 0; i < context.getNumWeights(); ++i) {
+        /// @note shared weights are saved once at the first access
+        if (!context.isGradientFirstAccess(i))
+          continue;
+        Tensor &weight = context.getWeight(i);
+        entries.push_back({weight.getName(), weight.getDim(),
+                           getNativeWeightLayout(weight.getDataType())});
+        weights.push_back(&weight);
+      }
+    }
+
+    WeightContainer::write(
+      file_path, entries,
+      [&entries, &weights](const WeightContainer::Entry &entry,
+                           std::ostream &file) {
+        Tensor *weight = weights[&entry - entries.data()];
+        if (hasRawWeightPayload(weight->getDataType()))
+          checkedWrite(file, weight->getData<char>(), weight->getMemoryBytes(),
+                       "[NeuralNetwork::save] failed to write weight");
+        else
+          weight->save(file);
+      });
+    break;
+  }
   default:
     throw nntrainer::exception::not_supported(
       "saving with given format is not supported yet");
@@ -682,15 +722,38 @@ void NeuralNetwork::load(const std::string &file_path,
   /// not delegating for now as required logics are manageable for now.
 
   bool fsu_mode = std::get<props::Fsu>(model_flex_props);
+  /// every format writes the weights in place
+  Weight::markUpdated();
 
   const std::regex reg_("\\s*\\;\\s*");
   auto v = split(file_path, reg_);
 
+  /// a weight container is found by its magic, whichever binary format is
+  /// given
+  std::shared_ptr<WeightContainer> container;
+  if (format == ml::train::ModelFormat::MODEL_FORMAT_BIN &&
+      WeightContainer::isContainer((v.size() == 2) ? v[1] : v[0]))
+    format = ml::train::ModelFormat::MODEL_FORMAT_WEIGHT_CONTAINER;
+  if (format == ml::train::ModelFormat::MODEL_FORMAT_WEIGHT_CONTAINER) {
+    NNTR_THROW_IF(!initialized, std::runtime_error)
+      << "Cannot load if not initialized yet, path: " << file_path
+      << " format: " << static_cast<unsigned>(format);
+    container =
+      std::make_shared<WeightContainer>((v.size() == 2) ? v[1] : v[0]);
+  }
+
   size_t start_from = 0;
   std::vector<std::pair<size_t, size_t>> file_offset;
   for (auto iter = model_graph.cbegin(); iter != model_graph.cend(); iter++) {
     auto weights = (*iter)->getRunContext().getWeights();
     for (auto weight : weights) {
+      if (container) {
+        /// offsets come from the index instead of the graph order
+        auto &entry = container->getEntry(weight->getName());
+        weight->getVariableRef().setFileOffset(entry.offset);
+        file_offset.emplace_back(entry.offset, entry.bytes);
+        continue;
+      }
       size_t size = weight->getVariable().getMemoryBytes();
       auto tensor_data_type = weight->getDim().getDataType();
       weight->getVariableRef().setFileOffset(start_from);
@@ -850,6 +913,13 @@ void NeuralNetwork::load(const std::string &file_path,
     break;
   }
 
+  case ml::train::ModelFormat::MODEL_FORMAT_WEIGHT_CONTAINER: {
+    readWeightContainer(container, fsu_mode);
+    ml_logi("read weight container: %s",
+            (v.size() == 2) ? v[1].c_str() : v[0].c_str());
+    break;
+  }
+
   case ml::train::ModelFormat::MODEL_FORMAT_INI_WITH_BIN: {
     int ret = loadFromConfig((v.size() == 2) ? v[1] : v[0]);
     throw_status(ret);
@@ -912,6 +982,116 @@ void NeuralNetwork::load(const std::string &file_path,
   }
 }
 
+void NeuralNetwork::readWeightContainer(
+  const std::shared_ptr<WeightContainer> &container, bool fsu) {
+  const bool inference = exec_mode == ml::train::ExecutionMode::INFERENCE;
+  size_t in_place = 0, copied = 0;
+
+  for (auto iter = model_graph.cbegin(); iter != model_graph.cend(); iter++) {
+    auto &context = (*iter)->getRunContext();
+    const bool trainable = (*iter)->getTrainable() && !inference;
+
+    for (unsigned int i = 0; i < context.getNumWeights(); ++i) {
+      /// @note shared weights are only be read at the first acecss
+      if (!context.isGradientFirstAccess(i))
+        continue;
+
+      Tensor &weight = context.getWeight(i);
+      const auto &entry = container->getEntry(weight.getName());
+      const TensorDim &dim = weight.getDim();
+      NNTR_THROW_IF(entry.dim.batch() != dim.batch() ||
+                      entry.dim.channel() != dim.channel() ||
+                      entry.dim.height() != dim.height() ||
+                      entry.dim.width() != dim.width(),
+                    std::invalid_argument)
+        << "shape of " << weight.getName() << " does not match, container: "
+        << entry.dim << " model: " << dim;
+
+      if (weight.isVirtual()) {
+        /// virtual weights map their payload from the file on activation
+        if (model_file_fd == -1)
+          model_file_fd = open(container->getPath().c_str(), O_RDONLY);
+        NNTR_THROW_IF(model_file_fd == -1, std::invalid_argument)
+          << "Cannot open file : " << container->getPath();
+        auto file = checkedOpenStream<std::ifstream>(
+          container->getPath(), std::ios::in | std::ios::binary);
+        weight.read(file, entry.offset, true, model_file_fd);
+        continue;
+      }
+
+      if (fsu && inference) {
+        /// swapped in from the payload offsets on demand
+        if (weight.getDataType() == TensorDim::DataType::BCQ)
+          weight.readFSU();
+        continue;
+      }
+
+      const auto type = dim.getDataType();
+      const WeightLayout native = getNativeWeightLayout(type);
+      char *payload = container->getPayload(entry);
+
+      if (entry.dim.getDataType() != type) {
+        /// e.g. fp32 payload of a fp16 weight
+        NNTR_THROW_IF(entry.layout != WeightLayout::PLAIN,
+                      std::invalid_argument)
+          << "cannot convert repacked " << weight.getName() << " from "
+          << entry.dim << " to " << dim;
+        Tensor T_read(entry.dim, true);
+        T_read.read(payload, 0, true);
+        weight.copyData(T_read);
+      } else if (entry.layout == native) {
+        if (inference && hasRawWeightPayload(type) &&
+            entry.bytes == weight.getMemoryBytes()) {
+          model_graph.bindWeightMemory(
+            weight.getName(),
+            WeightContainer::getPayloadMemory(container, entry));
+          in_place++;
+          continue;
+        }
+
+        if (hasRawWeightPayload(type)) {
+          NNTR_THROW_IF(entry.bytes != weight.getMemoryBytes(),
+                        std::invalid_argument)
+            << "payload of " << weight.getName() << " has " << entry.bytes
+            << " bytes, expected " << weight.getMemoryBytes();
+          std::memcpy(weight.getData<char>(), payload, entry.bytes);
+        } else {
+          weight.read(payload, 0, true);
+        }
+      } else if (entry.layout == WeightLayout::PLAIN &&
+                 (type == TensorDim::DataType::Q4_0 ||
+                  type == TensorDim::DataType::Q4_K)) {
+        /// repack into the layout of this backend
+        const unsigned int N = dim.width();
+        const unsigned int K = dim.getDataLen() / N;
+        NNTR_THROW_IF(entry.bytes != weight.getMemoryBytes() || N % 8,
+                      std::invalid_argument)
+          << "cannot repack " << entry.bytes << " bytes of "
+          << weight.getName() << " into " << N << " rows";
+        if (type == TensorDim::DataType::Q4_0)
+          repack_q4_0(weight.getData<void>(), payload, entry.bytes, N, K);
+        else
+          repack_q4_K(weight.getData<void>(), payload, entry.bytes, N, K);
+      } else {
+        throw std::invalid_argument(
+          "layout " + std::to_string(static_cast<unsigned>(entry.layout)) +
+          " of " + weight.getName() + " is not supported on this backend");
+      }
+
+      container->dropPayload(entry);
+      copied++;
+
+      if (context.isMixedPrecision(i) && trainable &&
+          !context.getWeightFP32(i).empty()) {
+        context.getWeightFP32(i).copyData(weight);
+      }
+    }
+  }
+
+  ml_logd("weight container: %zu weights in place, %zu copied", in_place,
+          copied);
+}
+
 float NeuralNetwork::getLoss() {
   loss = 0.0f;
 
@@ -1039,6 +1219,18 @@ sharedConstTensors NeuralNetwork::inference(sharedConstTensors X,
   return out;
 }
 
+/**
+ * @brief map a user input buffer as a tensor of the given input dimension
+ * @note the buffer of a UINT32 input (e.g. token ids) holds unsigned int data
+ */
+static Tensor mapInput(float *buf, const TensorDim &dim) {
+  if (dim.getDataType() == TensorDim::DataType::UINT32)
+    return Tensor::Map(reinterpret_cast<uint32_t *>(buf),
+                       dim.getDataLen() * sizeof(uint32_t), dim, 0);
+
+  return Tensor::Map(buf, dim.getDataLen() * sizeof(float), dim, 0);
+}
+
 std::vector<float *>
 NeuralNetwork::inference(unsigned int batch_size,
                          const std::vector<float *> &input,
@@ -1049,8 +1241,8 @@ NeuralNetwork::inference(unsigned int batch_size,
   input_tensors.reserve(input.size());
   for (unsigned int idx = 0; idx < in_dim.size(); idx++) {
     in_dim[idx].batch(batch_size);
-    input_tensors.emplace_back(MAKE_SHARED_TENSOR(Tensor::Map(
-      input[idx], in_dim[idx].getDataLen() * sizeof(float), in_dim[idx], 0)));
+    input_tensors.emplace_back(
+      MAKE_SHARED_TENSOR(mapInput(input[idx], in_dim[idx])));
   }
 
   if (!label.empty()) {
@@ -1116,97 +1308,108 @@ sharedConstTensors NeuralNetwork::incremental_inference(
   return out;
 }
 
-std::vector<float *> NeuralNetwork::incremental_inference(
+sharedConstTensors NeuralNetwork::mapIncrementalInference(
   unsigned int batch_size, const std::vector<float *> &input,
   const std::vector<float *> &label, unsigned int init_seq_len,
-  unsigned int from, unsigned int to, bool output_hidden_state) {
-
-  // auto start_in_neuralnet = std::chrono::high_resolution_clock::now();
-
-  sharedConstTensors input_tensors, output_tensors;
+  unsigned int from, unsigned int to) {
+  sharedConstTensors input_tensors;
   auto in_dim = getInputDimension();
 
   input_tensors.reserve(input.size());
   for (unsigned int idx = 0; idx < in_dim.size(); idx++) {
     in_dim[idx].batch(batch_size);
-    input_tensors.emplace_back(MAKE_SHARED_TENSOR(Tensor::Map(
-      input[idx], in_dim[idx].getDataLen() * sizeof(float), in_dim[idx], 0)));
+    input_tensors.emplace_back(
+      MAKE_SHARED_TENSOR(mapInput(input[idx], in_dim[idx])));
   }
 
-  // auto start_increment = std::chrono::high_resolution_clock::now();
-  if (!label.empty()) {
-    sharedConstTensors label_tensors;
-    auto label_dim = getOutputDimension();
-    label_tensors.reserve(label.size());
-    for (unsigned int idx = 0; idx < label_dim.size(); idx++) {
-      label_dim[idx].batch(batch_size);
-      label_tensors.emplace_back(MAKE_SHARED_TENSOR(
-        Tensor::Map(label[idx], label_dim[idx].getDataLen() * sizeof(float),
-                    label_dim[idx], 0)));
-    }
-    output_tensors = incremental_inference(input_tensors, label_tensors,
-                                           init_seq_len, from, to);
-  } else {
-    output_tensors =
-      incremental_inference(input_tensors, init_seq_len, from, to);
+  if (label.empty())
+    return incremental_inference(input_tensors, init_seq_len, from, to);
+
+  sharedConstTensors label_tensors;
+  auto label_dim = getOutputDimension();
+  label_tensors.reserve(label.size());
+  for (unsigned int idx = 0; idx < label_dim.size(); idx++) {
+    label_dim[idx].batch(batch_size);
+    label_tensors.emplace_back(MAKE_SHARED_TENSOR(
+      Tensor::Map(label[idx], label_dim[idx].getDataLen() * sizeof(float),
+                  label_dim[idx], 0)));
   }
-  // auto end_increment = std::chrono::high_resolution_clock::now();
-  std::vector<float *> output;
+  return incremental_inference(input_tensors, label_tensors, init_seq_len, from,
+                               to);
+}
 
+/**
+ * @brief copy the output rows of the last step of each batch into the buffers
+ */
+static void copyLastStep(const sharedConstTensors &output_tensors,
+                         unsigned int batch_size, unsigned int from,
+                         unsigned int to, const std::vector<float *> &output) {
   unsigned int step = ((to - from) == 0) ? 0 : (to - from) - 1;
 
-  for (auto &out : output_tensors) {
-    auto out_t = *out.get();
-    float *last_out_buf_data;
-
-    if (output_hidden_state) {
-      last_out_buf_data = out_t.getData();
-    } else {
-      last_out_buf_data = new float[batch_size * out_t.width()];
+  for (unsigned int idx = 0; idx < output_tensors.size(); ++idx) {
+    const Tensor &out_t = *output_tensors[idx];
+    float *last_out_buf_data = output[idx];
 
-      for (unsigned int batch = 0; batch < batch_size; ++batch) {
-        if (out->getDataType() == ml::train::TensorDim::DataType::FP16) {
+    for (unsigned int batch = 0; batch < batch_size; ++batch) {
+      if (out_t.getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
-          const _FP16 *out_t_batch_ptr =
-            out_t.getData<_FP16>() + batch * out_t.getDim().getFeatureLen() +
-            step * out_t.width();
-          scopy(out_t.width(), out_t_batch_ptr, 1,
-                last_out_buf_data + batch * out_t.width(), 1);
-
+        const _FP16 *out_t_batch_ptr = out_t.getData<_FP16>() +
+                                       batch * out_t.getDim().getFeatureLen() +
+                                       step * out_t.width();
+        scopy(out_t.width(), out_t_batch_ptr, 1,
+              last_out_buf_data + batch * out_t.width(), 1);
 #else
-          throw std::invalid_argument("Error: enable-fp16 is not set");
+        throw std::invalid_argument("Error: enable-fp16 is not set");
 #endif
-        } else if (out->getDataType() == ml::train::TensorDim::DataType::FP32) {
-          const float *out_t_batch_ptr =
-            out_t.getData() + batch * out_t.getDim().getFeatureLen() +
-            step * out_t.width();
-          // std::memcpy( last_out_buf_data + batch * out_t.width(),
-          // out_t_batch_ptr, out_t.width()*sizeof(float));
-          scopy(out_t.width(), out_t_batch_ptr, 1,
-                last_out_buf_data + batch * out_t.width(), 1);
-        }
+      } else if (out_t.getDataType() == ml::train::TensorDim::DataType::FP32) {
+        const float *out_t_batch_ptr = out_t.getData() +
+                                       batch * out_t.getDim().getFeatureLen() +
+                                       step * out_t.width();
+        scopy(out_t.width(), out_t_batch_ptr, 1,
+              last_out_buf_data + batch * out_t.width(), 1);
       }
     }
+  }
+}
+
+std::vector<float *> NeuralNetwork::incremental_inference(
+  unsigned int batch_size, const std::vector<float *> &input,
+  const std::vector<float *> &label, unsigned int init_seq_len,
+  unsigned int from, unsigned int to, bool output_hidden_state) {
+  sharedConstTensors output_tensors =
+    mapIncrementalInference(batch_size, input, label, init_seq_len, from, to);
 
-    output.push_back(last_out_buf_data);
+  std::vector<float *> output;
+  output.reserve(output_tensors.size());
+  for (auto &out : output_tensors) {
+    if (output_hidden_state)
+      output.push_back(out->getData());
+    else
+      output.push_back(new float[batch_size * out->width()]);
   }
-  // auto end_net_inference = std::chrono::high_resolution_clock::now();
-  // auto prepare =
-  // std::chrono::duration_cast<std::chrono::nanoseconds>(start_increment-start_in_neuralnet);
-  // auto run_inf =
-  // std::chrono::duration_cast<std::chrono::nanoseconds>(end_increment-start_increment);;
-  // auto out_gen =
-  // std::chrono::duration_cast<std::chrono::nanoseconds>(end_net_inference-end_increment);;
-  // auto net_gen =
-  // std::chrono::duration_cast<std::chrono::nanoseconds>(end_net_inference-start_in_neuralnet);
 
-  // std::cout <<"prepare : "<< prepare.count() << " run_inf : "<<
-  // run_inf.count() << " out_gen : "<< out_gen.count()<<std::endl; std::cout <<
-  // "-------- net_inference: "<< net_gen.count() << std::endl;
+  if (!output_hidden_state)
+    copyLastStep(output_tensors, batch_size, from, to, output);
 
   return output;
 }
 
+void NeuralNetwork::incremental_inference(unsigned int batch_size,
+                                          const std::vector<float *> &input,
+                                          const std::vector<float *> &label,
+                                          const std::vector<float *> &output,
+                                          unsigned int init_seq_len,
+                                          unsigned int from, unsigned int to) {
+  sharedConstTensors output_tensors =
+    mapIncrementalInference(batch_size, input, label, init_seq_len, from, to);
+
+  NNTR_THROW_IF(output.size() < output_tensors.size(), std::invalid_argument)
+    << "incremental inference needs a buffer for each of the "
+    << output_tensors.size() << " outputs";
+
+  copyLastStep(output_tensors, batch_size, from, to, output);
+}
+
 void NeuralNetwork::resetInputDimension(std::vector<TensorDim> dims) {
   model_graph.resetInputDimension(dims);
 }
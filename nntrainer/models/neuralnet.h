@@ -66,6 +66,7 @@ using NetType = ml::train::ModelType;
 using ExecutionMode = ml::train::ExecutionMode;
 
 class DataBuffer;
+class WeightContainer;
 using DatasetType = ml::train::DatasetType;
 using DatasetModeType = ml::train::DatasetModeType;
 using RunStats = ml::train::RunStats;
@@ -415,6 +416,25 @@ public:
                         unsigned int to,
                         bool output_hidden_state = false) override;
 
+  /**
+   * @brief     Run the incremental inference of the model into caller buffers
+   * @param[in] batch batch size of current input
+   * @param[in] input inputs as a list of each input data
+   * @param[in] label labels as a list of each label data
+   * @param[out] output a buffer of batch * width floats for each output, which
+   * gets the output of the last step
+   * @param[in] init_seq_len initial sequence length
+   * @param[in] from current working step index
+   * @param[in] to next working step index
+   * @note No memory is allocated for the outputs
+   */
+  void incremental_inference(unsigned int batch,
+                             const std::vector<float *> &input,
+                             const std::vector<float *> &label,
+                             const std::vector<float *> &output,
+                             unsigned int init_seq_len, unsigned int from,
+                             unsigned int to) override;
+
   /**
    * @brief     reset input dimensions of a model
    * @param[in] dims input dimensions
@@ -649,7 +669,8 @@ private:
                props::ContinueTrain, props::SaveBestPath,
                props::MemoryOptimization, props::Fsu, props::FsuPath,
                props::FsuLookahead, props::TensorFormat,
-               props::ModelTensorDataType>;
+               props::ModelTensorDataType, props::AutoRecompute,
+               props::ActivationOffload, props::ActivationOffloadMinSize>;
   using RigidPropTypes =
     std::tuple<props::LossType, std::vector<props::InputConnection>,
                std::vector<props::LabelLayer>, props::ClipGradByGlobalNorm,
@@ -714,6 +735,17 @@ private:
    */
   void saveModelIni(const std::string &file_path);
 
+  /**
+   * @brief read weights from a weight container by their names
+   *
+   * @param container mapped weight container
+   * @param fsu true if weights are swapped in from the file on demand
+   * @note in inference, payloads in the layout of this backend are used in
+   * place from the mapping instead of being copied
+   */
+  void readWeightContainer(const std::shared_ptr<WeightContainer> &container,
+                           bool fsu);
+
   /**
    * @brief print function for neuralnet
    * @param[in] out outstream
@@ -771,6 +803,23 @@ private:
    * @retval true if matches, false is error
    */
   bool validateInput(sharedConstTensors X);
+
+  /**
+   * @brief     Map the raw inputs and labels and run the incremental inference
+   * @param[in] batch_size batch size of current input
+   * @param[in] input inputs as a list of each input data
+   * @param[in] label labels as a list of each label data
+   * @param[in] init_seq_len initial sequence length
+   * @param[in] from current working step index
+   * @param[in] to next working step index
+   * @retval    List of Output Tensors
+   */
+  sharedConstTensors
+  mapIncrementalInference(unsigned int batch_size,
+                          const std::vector<float *> &input,
+                          const std::vector<float *> &label,
+                          unsigned int init_seq_len, unsigned int from,
+                          unsigned int to);
 };
 
 } /* namespace nntrainer */
@@ -0,0 +1,374 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   weight_container.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Self-describing weight file with a tensor index and aligned payloads
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include "utils/mman_windows.h"
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <memory_data.h>
+#include <nntrainer_error.h>
+#include <nntrainer_log.h>
+#include <util_func.h>
+#include <weight_container.h>
+
+namespace nntrainer {
+
+namespace {
+
+constexpr char MAGIC[8] = {'N', 'N', 'T', 'R', 'W', 'G', 'T', '\0'};
+
+/** magic, version, alignment, number of entries, index bytes, data offset */
+constexpr size_t HEADER_BYTES = sizeof(MAGIC) + 2 * sizeof(uint32_t) +
+                                3 * sizeof(uint64_t);
+
+/** name length, data type, layout, format, 4 dims, offset, bytes */
+constexpr size_t ENTRY_FIXED_BYTES =
+  4 * sizeof(uint32_t) + 4 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+template <typename T> void writeValue(std::ostream &file, T value) {
+  checkedWrite(file, reinterpret_cast<const char *>(&value), sizeof(T),
+               "[WeightContainer] failed to write index");
+}
+
+/**
+ * @brief bounds checked reader of the mapped header and index
+ */
+class IndexReader {
+public:
+  IndexReader(const char *begin, const char *end) : cur(begin), end(end) {}
+
+  template <typename T> T read() {
+    T value;
+    std::memcpy(&value, take(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  std::string readString(size_t len) { return std::string(take(len), len); }
+
+  const char *take(size_t len) {
+    NNTR_THROW_IF(static_cast<size_t>(end - cur) < len, std::invalid_argument)
+      << "[WeightContainer] index is truncated";
+    const char *ret = cur;
+    cur += len;
+    return ret;
+  }
+
+private:
+  const char *cur;
+  const char *end;
+};
+
+/**
+ * @brief on-disk code of an enumerator. The codes are part of the file format
+ * and never change, whatever the order of the enumerators.
+ */
+template <typename T> struct DiskCode {
+  T value;
+  uint32_t code;
+};
+
+constexpr DiskCode<TensorDim::DataType> DATA_TYPE_CODES[] = {
+  {TensorDim::DataType::QINT4, 0},
+  {TensorDim::DataType::QINT8, 1},
+  {TensorDim::DataType::QINT16, 2},
+  {TensorDim::DataType::BCQ, 3},
+  {TensorDim::DataType::Q4_K, 4},
+  {TensorDim::DataType::Q6_K, 5},
+  {TensorDim::DataType::Q4_0, 6},
+  {TensorDim::DataType::UINT4, 7},
+  {TensorDim::DataType::UINT8, 8},
+  {TensorDim::DataType::UINT16, 9},
+  {TensorDim::DataType::UINT32, 10},
+  {TensorDim::DataType::FP16, 11},
+  {TensorDim::DataType::FP32, 12},
+};
+
+constexpr DiskCode<TensorDim::Format> FORMAT_CODES[] = {
+  {TensorDim::Format::NCHW, 0},
+  {TensorDim::Format::NHWC, 1},
+};
+
+constexpr DiskCode<WeightLayout> LAYOUT_CODES[] = {
+  {WeightLayout::PLAIN, 0},
+  {WeightLayout::Q4_0x4, 1},
+  {WeightLayout::Q4_0x8, 2},
+  {WeightLayout::Q4_Kx8, 3},
+};
+
+template <typename T, size_t N>
+uint32_t toDiskCode(const DiskCode<T> (&codes)[N], T value) {
+  for (const auto &c : codes)
+    if (c.value == value)
+      return c.code;
+  throw std::invalid_argument(
+    "[WeightContainer] no on-disk code for the enumerator " +
+    std::to_string(static_cast<int>(value)));
+}
+
+/**
+ * @return false if the code is unknown
+ */
+template <typename T, size_t N>
+bool fromDiskCode(const DiskCode<T> (&codes)[N], uint32_t code, T &value) {
+  for (const auto &c : codes) {
+    if (c.code == code) {
+      value = c.value;
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+WeightLayout getNativeWeightLayout(TensorDim::DataType type) {
+  switch (type) {
+  case TensorDim::DataType::Q4_0:
+#if defined(__aarch64__) || defined(__ARM_ARCH_7A__) ||                        \
+  defined(__ANDROID__) || defined(__arm__)
+    return WeightLayout::Q4_0x4;
+#else
+    return WeightLayout::Q4_0x8;
+#endif
+  case TensorDim::DataType::Q4_K:
+    return WeightLayout::Q4_Kx8;
+  default:
+    return WeightLayout::PLAIN;
+  }
+}
+
+bool hasRawWeightPayload(TensorDim::DataType type) {
+  switch (type) {
+  case TensorDim::DataType::FP32:
+  case TensorDim::DataType::FP16:
+  case TensorDim::DataType::Q4_0:
+  case TensorDim::DataType::Q4_K:
+  case TensorDim::DataType::Q6_K:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool WeightContainer::isContainer(const std::string &path) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  char magic[sizeof(MAGIC)] = {};
+  file.read(magic, sizeof(magic));
+  return file.good() && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void WeightContainer::write(const std::string &path,
+                            std::vector<Entry> &entries,
+                            const PayloadWriter &writer, size_t alignment) {
+  NNTR_THROW_IF(alignment < MIN_ALIGNMENT || alignment % MIN_ALIGNMENT,
+                std::invalid_argument)
+    << "[WeightContainer] alignment must be a multiple of " << MIN_ALIGNMENT
+    << ", given: " << alignment;
+
+  size_t index_bytes = 0;
+  for (auto &entry : entries)
+    index_bytes += ENTRY_FIXED_BYTES + entry.name.size();
+  const size_t data_offset = alignUp(HEADER_BYTES + index_bytes, alignment);
+
+  auto file = checkedOpenStream<std::ofstream>(
+    path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+  /// payloads first, the index needs their offsets and sizes
+  std::vector<char> padding(alignment, 0);
+  size_t pos = HEADER_BYTES + index_bytes;
+  file.seekp(pos);
+  for (auto &entry : entries) {
+    const size_t start = alignUp(pos, alignment);
+    checkedWrite(file, padding.data(), start - pos,
+                 "[WeightContainer] failed to write padding");
+
+    writer(entry, file);
+    pos = static_cast<size_t>(file.tellp());
+    entry.offset = start;
+    entry.bytes = pos - start;
+  }
+  if (entries.empty()) {
+    checkedWrite(file, padding.data(), data_offset - pos,
+                 "[WeightContainer] failed to write padding");
+  }
+
+  file.seekp(0);
+  checkedWrite(file, MAGIC, sizeof(MAGIC),
+               "[WeightContainer] failed to write header");
+  writeValue<uint32_t>(file, FORMAT_VERSION);
+  writeValue<uint32_t>(file, static_cast<uint32_t>(alignment));
+  writeValue<uint64_t>(file, entries.size());
+  writeValue<uint64_t>(file, index_bytes);
+  writeValue<uint64_t>(file, data_offset);
+
+  for (auto &entry : entries) {
+    writeValue<uint32_t>(file, static_cast<uint32_t>(entry.name.size()));
+    checkedWrite(file, entry.name.data(), entry.name.size(),
+                 "[WeightContainer] failed to write index");
+    writeValue<uint32_t>(file,
+                         toDiskCode(DATA_TYPE_CODES, entry.dim.getDataType()));
+    writeValue<uint32_t>(file, toDiskCode(LAYOUT_CODES, entry.layout));
+    writeValue<uint32_t>(file, toDiskCode(FORMAT_CODES, entry.dim.getFormat()));
+    for (unsigned int i = 0; i < TensorDim::MAXDIM; ++i)
+      writeValue<uint32_t>(file,
+                           static_cast<uint32_t>(entry.dim.getTensorDim(i)));
+    writeValue<uint64_t>(file, entry.offset);
+    writeValue<uint64_t>(file, entry.bytes);
+  }
+
+  file.close();
+}
+
+WeightContainer::WeightContainer(const std::string &path_) : path(path_) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  NNTR_THROW_IF(fd == -1, std::invalid_argument)
+    << "[WeightContainer] cannot open " << path;
+
+  struct stat st {};
+  if (::fstat(fd, &st) == -1) {
+    ::close(fd);
+    throw std::invalid_argument("[WeightContainer] cannot stat " + path);
+  }
+  file_bytes = static_cast<size_t>(st.st_size);
+  if (file_bytes < HEADER_BYTES) {
+    ::close(fd);
+    throw std::invalid_argument("[WeightContainer] too small to be a "
+                                "container: " +
+                                path);
+  }
+
+  /// private and writable so that the weights used in place may be updated
+  void *ptr =
+    ::mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  NNTR_THROW_IF(ptr == MAP_FAILED, std::runtime_error)
+    << "[WeightContainer] mmap failed: " << path;
+  base = static_cast<char *>(ptr);
+
+  try {
+    IndexReader header(base, base + HEADER_BYTES);
+    NNTR_THROW_IF(std::memcmp(header.take(sizeof(MAGIC)), MAGIC,
+                              sizeof(MAGIC)) != 0,
+                  std::invalid_argument)
+      << "[WeightContainer] not a weight container: " << path;
+
+    const uint32_t version = header.read<uint32_t>();
+    NNTR_THROW_IF(version != FORMAT_VERSION, std::invalid_argument)
+      << "[WeightContainer] unsupported version " << version << ": " << path;
+
+    alignment = header.read<uint32_t>();
+    const uint64_t num_entries = header.read<uint64_t>();
+    const uint64_t index_bytes = header.read<uint64_t>();
+    const uint64_t data_offset = header.read<uint64_t>();
+    NNTR_THROW_IF(alignment < MIN_ALIGNMENT || alignment % MIN_ALIGNMENT,
+                  std::invalid_argument)
+      << "[WeightContainer] invalid alignment " << alignment << ": " << path;
+    NNTR_THROW_IF(index_bytes > file_bytes - HEADER_BYTES ||
+                    data_offset > file_bytes,
+                  std::invalid_argument)
+      << "[WeightContainer] index is out of the file: " << path;
+
+    IndexReader reader(base + HEADER_BYTES,
+                       base + HEADER_BYTES + index_bytes);
+    entries.reserve(num_entries);
+    for (uint64_t i = 0; i < num_entries; ++i) {
+      Entry entry;
+      entry.name = reader.readString(reader.read<uint32_t>());
+
+      TensorDim::DataType type;
+      TensorDim::Format format;
+      const bool known_type =
+        fromDiskCode(DATA_TYPE_CODES, reader.read<uint32_t>(), type);
+      const bool known_layout =
+        fromDiskCode(LAYOUT_CODES, reader.read<uint32_t>(), entry.layout);
+      const bool known_format =
+        fromDiskCode(FORMAT_CODES, reader.read<uint32_t>(), format);
+      NNTR_THROW_IF(!known_type || !known_layout || !known_format,
+                    std::invalid_argument)
+        << "[WeightContainer] invalid type of " << entry.name << ": " << path;
+
+      uint32_t d[TensorDim::MAXDIM];
+      for (auto &v : d)
+        v = reader.read<uint32_t>();
+      entry.dim = TensorDim(d[0], d[1], d[2], d[3], format, type);
+      entry.offset = reader.read<uint64_t>();
+      entry.bytes = reader.read<uint64_t>();
+
+      NNTR_THROW_IF(entry.offset < data_offset ||
+                      entry.offset % alignment != 0 ||
+                      entry.bytes > file_bytes - entry.offset,
+                    std::invalid_argument)
+        << "[WeightContainer] invalid payload of " << entry.name << ": "
+        << path;
+      NNTR_THROW_IF(!index.emplace(entry.name, entries.size()).second,
+                    std::invalid_argument)
+        << "[WeightContainer] duplicated weight " << entry.name << ": "
+        << path;
+      entries.push_back(std::move(entry));
+    }
+  } catch (...) {
+    ::munmap(base, file_bytes);
+    throw;
+  }
+
+#if !defined(_WIN32)
+  /// weights are touched in graph order, not in file order
+  (void)::posix_madvise(base, file_bytes, POSIX_MADV_RANDOM);
+#endif
+}
+
+WeightContainer::~WeightContainer() {
+  if (base != nullptr)
+    ::munmap(base, file_bytes);
+}
+
+const WeightContainer::Entry &
+WeightContainer::getEntry(const std::string &name) const {
+  auto it = index.find(name);
+  NNTR_THROW_IF(it == index.end(), std::invalid_argument)
+    << "[WeightContainer] no weight named " << name << " in " << path;
+  return entries[it->second];
+}
+
+std::shared_ptr<MemoryData> WeightContainer::getPayloadMemory(
+  const std::shared_ptr<WeightContainer> &container, const Entry &entry) {
+  return std::shared_ptr<MemoryData>(
+    new MemoryData(container->getPayload(entry)),
+    [container](MemoryData *mem) { delete mem; });
+}
+
+void WeightContainer::dropPayload(const Entry &entry) const {
+#if !defined(_WIN32)
+  static const size_t page_size = sysconf(_SC_PAGE_SIZE);
+  size_t begin = alignUp(entry.offset, page_size);
+  size_t end = (entry.offset + entry.bytes) / page_size * page_size;
+  /// posix_madvise(POSIX_MADV_DONTNEED) is a no-op on glibc, madvise frees
+  /// the pages, which are read again from the file if ever touched
+  if (begin < end)
+    (void)::madvise(base + begin, end - begin, MADV_DONTNEED);
+#endif
+}
+
+} // namespace nntrainer
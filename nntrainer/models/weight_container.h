@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   weight_container.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Self-describing weight file with a tensor index and aligned payloads
+ *
+ * @note   Layout of the file, all integers are little endian
+ *         header  : magic "NNTRWGT\0", u32 version, u32 alignment,
+ *                   u64 number of entries, u64 index bytes, u64 data offset
+ *         index   : per entry, u32 name length, name, u32 data type,
+ *                   u32 layout, u32 format, u32 b, c, h, w, u64 offset,
+ *                   u64 bytes
+ *         payload : each payload starts at a multiple of the alignment
+ *
+ * Weights are looked up by name, so loading does not depend on the graph
+ * order. A payload laid out for the running backend can be used in place
+ * from the mapping of the file.
+ */
+
+#ifndef __WEIGHT_CONTAINER_H__
+#define __WEIGHT_CONTAINER_H__
+#ifdef __cplusplus
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <tensor_dim.h>
+
+namespace nntrainer {
+
+class MemoryData;
+
+using TensorDim = ml::train::TensorDim;
+
+/**
+ * @brief Memory layout of a weight payload
+ */
+enum class WeightLayout : uint32_t {
+  PLAIN = 0,  /**< layout of the data type as is */
+  Q4_0x4 = 1, /**< q4_0 blocks interleaved by 4 rows, arm repack_q4_0 */
+  Q4_0x8 = 2, /**< q4_0 blocks interleaved by 8 rows, x86 repack_q4_0 */
+  Q4_Kx8 = 3, /**< q4_K blocks interleaved by 8 rows, repack_q4_K */
+};
+
+/**
+ * @brief get the layout weights of the data type have in memory on this
+ * backend
+ */
+WeightLayout getNativeWeightLayout(TensorDim::DataType type);
+
+/**
+ * @brief check if a payload of the data type is the tensor memory as is.
+ * Other data types are written by Tensor::save with their quantization info.
+ */
+bool hasRawWeightPayload(TensorDim::DataType type);
+
+/**
+ * @class   WeightContainer
+ * @brief   Read only mapping of a weight container file
+ */
+class WeightContainer {
+public:
+  static constexpr uint32_t FORMAT_VERSION = 1;
+  static constexpr size_t DEFAULT_ALIGNMENT = 4096;
+  static constexpr size_t MIN_ALIGNMENT = 64;
+
+  /**
+   * @brief Index entry of a weight
+   */
+  struct Entry {
+    std::string name;  /**< name of the weight */
+    TensorDim dim;     /**< dimension with the data type */
+    WeightLayout layout = WeightLayout::PLAIN; /**< layout of the payload */
+    size_t offset = 0; /**< file offset of the payload */
+    size_t bytes = 0;  /**< size of the payload */
+  };
+
+  /**
+   * @brief Callback writing the payload of an entry
+   */
+  using PayloadWriter = std::function<void(const Entry &, std::ostream &)>;
+
+  /**
+   * @brief check if the file starts with the container magic
+   */
+  static bool isContainer(const std::string &path);
+
+  /**
+   * @brief write a container
+   * @param path file to write
+   * @param entries name, dim and layout of the weights. offset and bytes are
+   * filled with where the payloads are written.
+   * @param writer writes the payload of the given entry
+   * @param alignment alignment of the payloads, multiple of MIN_ALIGNMENT
+   */
+  static void write(const std::string &path, std::vector<Entry> &entries,
+                    const PayloadWriter &writer,
+                    size_t alignment = DEFAULT_ALIGNMENT);
+
+  /**
+   * @brief map the container and parse its index
+   * @throw std::invalid_argument if the file is not a valid container
+   */
+  explicit WeightContainer(const std::string &path);
+
+  /**
+   * @brief unmap the container
+   */
+  ~WeightContainer();
+
+  WeightContainer(const WeightContainer &) = delete;
+  WeightContainer &operator=(const WeightContainer &) = delete;
+
+  /**
+   * @brief get the entry of a weight
+   * @throw std::invalid_argument if there is no such weight
+   */
+  const Entry &getEntry(const std::string &name) const;
+
+  /**
+   * @brief check if there is a weight of the name
+   */
+  bool contains(const std::string &name) const {
+    return index.find(name) != index.end();
+  }
+
+  /**
+   * @brief get every entry in the order of the file
+   */
+  const std::vector<Entry> &getEntries() const { return entries; }
+
+  /**
+   * @brief get the payload of an entry in the mapping
+   * @note the mapping is private, writes to it are not written back
+   */
+  char *getPayload(const Entry &entry) const { return base + entry.offset; }
+
+  /**
+   * @brief get the path of the container file
+   */
+  const std::string &getPath() const { return path; }
+
+  /**
+   * @brief get the payload alignment of the container
+   */
+  size_t getAlignment() const { return alignment; }
+
+  /**
+   * @brief create memory data of a payload which keeps the mapping alive
+   * until the memory data is released
+   */
+  static std::shared_ptr<MemoryData>
+  getPayloadMemory(const std::shared_ptr<WeightContainer> &container,
+                   const Entry &entry);
+
+  /**
+   * @brief release the pages of a payload copied out of the mapping
+   */
+  void dropPayload(const Entry &entry) const;
+
+private:
+  std::string path;
+  char *base = nullptr;
+  size_t file_bytes = 0;
+  size_t alignment = DEFAULT_ALIGNMENT;
+  std::vector<Entry> entries;
+  std::unordered_map<std::string, size_t> index;
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __WEIGHT_CONTAINER_H__ */
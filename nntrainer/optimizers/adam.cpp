@@ -15,6 +15,7 @@
 #include <fstream>
 
 #include <adam.h>
+#include <lazy_tensor.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
@@ -98,16 +99,18 @@ void Adam::applyGradient(RunOptimizerContext &context) {
   Tensor &wm = context.getOptimizerVariable(AdamParams::wm);
   Tensor &wv = context.getOptimizerVariable(AdamParams::wv);
 
-  wm.multiply_i(beta1);
-  wm.add_i(x_grad, 1.0f - beta1);
+  /// the moments are updated in place by one fused pass each
+  wm.chain().multiply_i(beta1).add_i(x_grad, 1.0f - beta1).run(wm);
 
-  wv.multiply_i(beta2);
-  wv.add_i(x_grad.multiply(x_grad), 1.0f - beta2);
+  Tensor grad_sq = x_grad.multiply(x_grad);
+  wv.chain().multiply_i(beta2).add_i(grad_sq, 1.0f - beta2).run(wv);
 
   if (torch_ref) {
     Tensor denom = wv.apply<float>(sqrtFloat<float>);
-    denom.divide_i(sqrtFloat(biasCorrection2));
-    denom.add_i(epsilon);
+    denom.chain()
+      .divide_i(sqrtFloat(biasCorrection2))
+      .add_i(epsilon)
+      .run(denom);
     wm.divide(denom, x_grad);
 
     context.applyGradient(context.getLearningRate() / biasCorrection1, x_grad);
@@ -14,6 +14,7 @@
 #include "cache_elem.h"
 
 #include <profiler.h>
+#include <weight.h>
 
 namespace nntrainer {
 
@@ -52,6 +53,8 @@ void CacheElem::swapIn(Options opt) {
   void *buf = device->getBuffer(offset, length, memory_ptr, id - 1, alloc_only);
 
   initial_opt = static_cast<Options>(initial_opt & ~Options::FIRST_ACCESS);
+  if (!alloc_only)
+    Weight::markUpdated(); /// swapped weights may reuse an address
   mem_data->setAddr((void *)buf);
   mem_data->setValid(true);
   active = true;
@@ -450,4 +450,109 @@ void clamp(const float *input, float *output, size_t length, float lower_bound,
            float upper_bound) {
   neon::clamp(input, output, length, lower_bound, upper_bound);
 }
+
+void quantize_qsi8cx(const unsigned int N, const unsigned int K,
+                     const float *W, bool transB, int8_t *qW,
+                     float *scales) {
+  __fallback_quantize_qsi8cx(N, K, W, transB, qW, scales);
+}
+
+void quantize_qsi4cx(const unsigned int N, const unsigned int K,
+                     const float *W, bool transB, uint8_t *qW,
+                     float *scales) {
+  __fallback_quantize_qsi4cx(N, K, W, transB, qW, scales);
+}
+
+void gemm_qai8_qsi8cx(const unsigned int M, const unsigned int N,
+                      const unsigned int K, const float *A,
+                      const unsigned int lda, const int8_t *B,
+                      const float *B_scales, float *C,
+                      const unsigned int ldc) {
+  __fallback_gemm_qai8_qsi8cx(M, N, K, A, lda, B, B_scales, C, ldc);
+}
+
+void gemm_qai8_qsi4cx(const unsigned int M, const unsigned int N,
+                      const unsigned int K, const float *A,
+                      const unsigned int lda, const uint8_t *B,
+                      const float *B_scales, float *C,
+                      const unsigned int ldc) {
+  __fallback_gemm_qai8_qsi4cx(M, N, K, A, lda, B, B_scales, C, ldc);
+}
+
+void quantize_kv_cache(const unsigned int len, const float *in, uint8_t *cache,
+                       uint16_t *scales, const unsigned int bits) {
+  __fallback_quantize_kv_cache(len, in, cache, scales, bits);
+}
+
+void compute_kcaches_quantized(const float *in, const uint8_t *kcache,
+                               const uint16_t *kscales, float *output,
+                               int num_rows, int num_cache_head, int head_dim,
+                               int gqa_size, unsigned int bits,
+                               size_t local_window_size, int head_start,
+                               int head_end) {
+  __fallback_compute_kcaches_quantized(in, kcache, kscales, output, num_rows,
+                                       num_cache_head, head_dim, gqa_size, bits,
+                                       local_window_size, head_start, head_end);
+}
+
+void compute_vcache_quantized_transposed(int row_num, const float *in,
+                                         const uint8_t *vcache,
+                                         const uint16_t *vscales, float *output,
+                                         int num_cache_head, int gqa_size,
+                                         int head_dim, unsigned int bits,
+                                         size_t local_window_size,
+                                         int head_start, int head_end) {
+  __fallback_compute_vcache_quantized_transposed(
+    row_num, in, vcache, vscales, output, num_cache_head, gqa_size, head_dim,
+    bits, local_window_size, head_start, head_end);
+}
+
+void reduce_sum(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y,
+                float alpha, float beta) {
+  nntrainer::neon::reduce_sum(outer, len, inner, X, Y, alpha, beta);
+}
+
+void reduce_max(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y) {
+  nntrainer::neon::reduce_max(outer, len, inner, X, Y);
+}
+
+void reduce_mean_var(const unsigned int outer, const unsigned int len,
+                     const unsigned int inner, const float *X, float *mean,
+                     float *var) {
+  nntrainer::neon::reduce_mean_var(outer, len, inner, X, mean, var);
+}
+
+void reduce_l2norm(const unsigned int outer, const unsigned int len,
+                   const unsigned int inner, const float *X, float *Y) {
+  nntrainer::neon::reduce_l2norm(outer, len, inner, X, Y);
+}
+
+void batch_norm_forward(const unsigned int outer, const unsigned int len,
+                        const unsigned int inner, const float *X,
+                        const float *mean, const float *invstd,
+                        const float *gamma, const float *beta, float *Y,
+                        float *X_hat) {
+  nntrainer::neon::batch_norm_forward(outer, len, inner, X, mean, invstd,
+                                      gamma, beta, Y, X_hat);
+}
+
+void batch_norm_backward_reduce(const unsigned int outer,
+                                const unsigned int len,
+                                const unsigned int inner, const float *dY,
+                                const float *X_hat, float *sum_dy,
+                                float *sum_dy_xhat) {
+  nntrainer::neon::batch_norm_backward_reduce(outer, len, inner, dY, X_hat,
+                                              sum_dy, sum_dy_xhat);
+}
+
+void batch_norm_backward(const unsigned int outer, const unsigned int len,
+                         const unsigned int inner, const float *dY,
+                         const float *X_hat, const float *invstd,
+                         const float *gamma, const float *mean_dy,
+                         const float *mean_dy_xhat, float *dX) {
+  nntrainer::neon::batch_norm_backward(outer, len, inner, dY, X_hat, invstd,
+                                       gamma, mean_dy, mean_dy_xhat, dX);
+}
 } /* namespace nntrainer */
@@ -11,6 +11,7 @@
  *
  */
 
+#include <algorithm>
 #include <climits>
 #include <fp16.h>
 #include <matrix_transpose_neon.h>
@@ -26,8 +27,10 @@
 
 #ifdef ARMV7
 #define VFMAQ_F32(_X, _Y, _Z) vaddq_f32(_X, vmulq_f32(_Y, _Z))
+#define VFMSQ_F32(_X, _Y, _Z) vsubq_f32(_X, vmulq_f32(_Y, _Z))
 #else
 #define VFMAQ_F32(_X, _Y, _Z) vfmaq_f32(_X, _Y, _Z)
+#define VFMSQ_F32(_X, _Y, _Z) vfmsq_f32(_X, _Y, _Z)
 #endif
 
 namespace nntrainer::neon {
@@ -1277,6 +1280,441 @@ void rms_norm_wrt_width_fp32_intrinsic(const float *__restrict X,
   }
 }
 
+static inline float hsum_neon(float32x4_t v) {
+  float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+  return vget_lane_f32(vpadd_f32(s, s), 0);
+}
+
+static inline float hmax_neon(float32x4_t v) {
+  float32x2_t m = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+  return vget_lane_f32(vpmax_f32(m, m), 0);
+}
+
+/**
+ * @brief reduce a (len) vector into one value. Four independent accumulators
+ * hide the latency of the vector op.
+ *
+ * @param op vector reduction step, acc = op(acc, x)
+ * @param merge combines two accumulators
+ * @param hop horizontal reduction of the accumulator
+ * @param sop scalar reduction step for the tail
+ */
+template <typename Op, typename Merge, typename HOp, typename SOp>
+static float reduce_row(const unsigned int len, const float *x,
+                        float32x4_t init, Op op, Merge merge, HOp hop,
+                        SOp sop) {
+  float32x4_t acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+  unsigned int l = 0;
+  for (; l + 16 <= len; l += 16) {
+    acc0 = op(acc0, vld1q_f32(x + l));
+    acc1 = op(acc1, vld1q_f32(x + l + 4));
+    acc2 = op(acc2, vld1q_f32(x + l + 8));
+    acc3 = op(acc3, vld1q_f32(x + l + 12));
+  }
+  for (; l + 4 <= len; l += 4)
+    acc0 = op(acc0, vld1q_f32(x + l));
+  float r = hop(merge(merge(acc0, acc1), merge(acc2, acc3)));
+  for (; l < len; ++l)
+    r = sop(r, x[l]);
+  return r;
+}
+
+/**
+ * @brief reduce a (len, inner) matrix over its rows into inner values. Blocks
+ * of 16 columns are kept in registers while the rows stream through.
+ *
+ * @param op vector reduction step, acc = op(acc, x)
+ * @param sop scalar reduction step for the tail columns
+ * @param store writes 4 reduced columns, store(y, acc)
+ * @param sstore writes one reduced column, sstore(y, acc)
+ */
+template <typename Op, typename SOp, typename Store, typename SStore>
+static void reduce_cols(const unsigned int len, const unsigned int inner,
+                        const float *x, float *y, float init, Op op, SOp sop,
+                        Store store, SStore sstore) {
+  const float32x4_t vinit = vdupq_n_f32(init);
+  unsigned int i = 0;
+  for (; i + 16 <= inner; i += 16) {
+    float32x4_t acc0 = vinit, acc1 = vinit, acc2 = vinit, acc3 = vinit;
+    for (unsigned int l = 0; l < len; ++l) {
+      const float *p = x + (size_t)l * inner + i;
+      acc0 = op(acc0, vld1q_f32(p));
+      acc1 = op(acc1, vld1q_f32(p + 4));
+      acc2 = op(acc2, vld1q_f32(p + 8));
+      acc3 = op(acc3, vld1q_f32(p + 12));
+    }
+    store(y + i, acc0);
+    store(y + i + 4, acc1);
+    store(y + i + 8, acc2);
+    store(y + i + 12, acc3);
+  }
+  for (; i + 4 <= inner; i += 4) {
+    float32x4_t acc = vinit;
+    for (unsigned int l = 0; l < len; ++l)
+      acc = op(acc, vld1q_f32(x + (size_t)l * inner + i));
+    store(y + i, acc);
+  }
+  for (; i < inner; ++i) {
+    float acc = init;
+    for (unsigned int l = 0; l < len; ++l)
+      acc = sop(acc, x[(size_t)l * inner + i]);
+    sstore(y + i, acc);
+  }
+}
+
+void reduce_sum(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y,
+                float alpha, float beta) {
+  auto op = [](float32x4_t a, float32x4_t b) { return vaddq_f32(a, b); };
+  auto sop = [](float a, float b) { return a + b; };
+  const float32x4_t valpha = vdupq_n_f32(alpha);
+  const float32x4_t vbeta = vdupq_n_f32(beta);
+  auto store = [&](float *y, float32x4_t acc) {
+    float32x4_t r = vmulq_f32(acc, valpha);
+    if (beta != 0.0f)
+      r = VFMAQ_F32(r, vld1q_f32(y), vbeta);
+    vst1q_f32(y, r);
+  };
+  auto sstore = [&](float *y, float acc) {
+    *y = alpha * acc + (beta == 0.0f ? 0.0f : beta * *y);
+  };
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *y = Y + (size_t)o * inner;
+    if (inner == 1)
+      sstore(y, reduce_row(len, x, vdupq_n_f32(0.0f), op, op, hsum_neon, sop));
+    else
+      reduce_cols(len, inner, x, y, 0.0f, op, sop, store, sstore);
+  }
+}
+
+void reduce_max(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y) {
+  auto op = [](float32x4_t a, float32x4_t b) { return vmaxq_f32(a, b); };
+  auto sop = [](float a, float b) { return std::max(a, b); };
+  auto store = [](float *y, float32x4_t acc) { vst1q_f32(y, acc); };
+  auto sstore = [](float *y, float acc) { *y = acc; };
+  constexpr float lowest = -std::numeric_limits<float>::infinity();
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *y = Y + (size_t)o * inner;
+    if (inner == 1)
+      *y = reduce_row(len, x, vdupq_n_f32(lowest), op, op, hmax_neon, sop);
+    else
+      reduce_cols(len, inner, x, y, lowest, op, sop, store, sstore);
+  }
+}
+
+void reduce_l2norm(const unsigned int outer, const unsigned int len,
+                   const unsigned int inner, const float *X, float *Y) {
+  auto op = [](float32x4_t a, float32x4_t b) { return VFMAQ_F32(a, b, b); };
+  auto add = [](float32x4_t a, float32x4_t b) { return vaddq_f32(a, b); };
+  auto sop = [](float a, float b) { return a + b * b; };
+  auto store = [](float *y, float32x4_t acc) {
+    vst1q_f32(y, vsqrtq_f32(acc));
+  };
+  auto sstore = [](float *y, float acc) { *y = std::sqrt(acc); };
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *y = Y + (size_t)o * inner;
+    if (inner == 1)
+      *y = std::sqrt(
+        reduce_row(len, x, vdupq_n_f32(0.0f), op, add, hsum_neon, sop));
+    else
+      reduce_cols(len, inner, x, y, 0.0f, op, sop, store, sstore);
+  }
+}
+
+/**
+ * @brief merge the Welford state (n_b, mean_b, m2_b) into (n_a, mean_a, m2_a)
+ */
+static inline void welford_merge(float &n_a, float &mean_a, float &m2_a,
+                                 float n_b, float mean_b, float m2_b) {
+  const float n = n_a + n_b;
+  const float delta = mean_b - mean_a;
+  mean_a += delta * n_b / n;
+  m2_a += m2_b + delta * delta * n_a * n_b / n;
+  n_a = n;
+}
+
+/**
+ * @brief Welford over the rows of B * 4 columns of a (len, inner) matrix
+ */
+template <unsigned int B>
+static void welford_cols(const unsigned int len, const unsigned int inner,
+                         const float *x, float *mean, float *var) {
+  float32x4_t vm[B], vm2[B];
+  for (unsigned int b = 0; b < B; ++b)
+    vm[b] = vm2[b] = vdupq_n_f32(0.0f);
+
+  for (unsigned int l = 0; l < len; ++l) {
+    const float32x4_t inv_n = vdupq_n_f32(1.0f / (l + 1));
+    const float *p = x + (size_t)l * inner;
+    for (unsigned int b = 0; b < B; ++b) {
+      const float32x4_t v = vld1q_f32(p + b * 4);
+      const float32x4_t delta = vsubq_f32(v, vm[b]);
+      vm[b] = VFMAQ_F32(vm[b], delta, inv_n);
+      vm2[b] = VFMAQ_F32(vm2[b], delta, vsubq_f32(v, vm[b]));
+    }
+  }
+
+  const float32x4_t inv_len = vdupq_n_f32(1.0f / len);
+  for (unsigned int b = 0; b < B; ++b) {
+    vst1q_f32(mean + b * 4, vm[b]);
+    vst1q_f32(var + b * 4, vmulq_f32(vm2[b], inv_len));
+  }
+}
+
+void reduce_mean_var(const unsigned int outer, const unsigned int len,
+                     const unsigned int inner, const float *X, float *mean,
+                     float *var) {
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *m = mean + (size_t)o * inner;
+    float *v = var + (size_t)o * inner;
+
+    if (inner == 1) {
+      /// every lane runs Welford over its own strided part of the row, the
+      /// lanes are merged afterwards
+      float32x4_t vm = vdupq_n_f32(0.0f), vm2 = vdupq_n_f32(0.0f);
+      unsigned int l = 0;
+      for (; l + 4 <= len; l += 4) {
+        const float32x4_t inv_n = vdupq_n_f32(1.0f / (l / 4 + 1));
+        const float32x4_t xv = vld1q_f32(x + l);
+        const float32x4_t delta = vsubq_f32(xv, vm);
+        vm = VFMAQ_F32(vm, delta, inv_n);
+        vm2 = VFMAQ_F32(vm2, delta, vsubq_f32(xv, vm));
+      }
+
+      float n = 0.0f, cm = 0.0f, cm2 = 0.0f;
+      if (l > 0) {
+        float lm[4], lm2[4];
+        vst1q_f32(lm, vm);
+        vst1q_f32(lm2, vm2);
+        n = l / 4;
+        cm = lm[0];
+        cm2 = lm2[0];
+        for (unsigned int j = 1; j < 4; ++j)
+          welford_merge(n, cm, cm2, l / 4, lm[j], lm2[j]);
+      }
+      for (; l < len; ++l) {
+        n += 1.0f;
+        const float delta = x[l] - cm;
+        cm += delta / n;
+        cm2 += delta * (x[l] - cm);
+      }
+      *m = cm;
+      *v = cm2 / len;
+      continue;
+    }
+
+    unsigned int i = 0;
+    for (; i + 16 <= inner; i += 16)
+      welford_cols<4>(len, inner, x + i, m + i, v + i);
+    for (; i + 4 <= inner; i += 4)
+      welford_cols<1>(len, inner, x + i, m + i, v + i);
+    for (; i < inner; ++i) {
+      float cm = 0.0f, cm2 = 0.0f;
+      for (unsigned int l = 0; l < len; ++l) {
+        const float val = x[(size_t)l * inner + i];
+        const float delta = val - cm;
+        cm += delta / (l + 1);
+        cm2 += delta * (val - cm);
+      }
+      m[i] = cm;
+      v[i] = cm2 / len;
+    }
+  }
+}
+
+void batch_norm_forward(const unsigned int outer, const unsigned int len,
+                        const unsigned int inner, const float *X,
+                        const float *mean, const float *invstd,
+                        const float *gamma, const float *beta, float *Y,
+                        float *X_hat) {
+  if (inner == 1) {
+    /// channels are contiguous, the statistics are loaded as vectors
+    for (unsigned int o = 0; o < outer; ++o) {
+      const float *x = X + (size_t)o * len;
+      float *y = Y + (size_t)o * len;
+      float *x_hat = X_hat ? X_hat + (size_t)o * len : nullptr;
+      unsigned int l = 0;
+      for (; l + 4 <= len; l += 4) {
+        const float32x4_t vm = vld1q_f32(mean + l);
+        const float32x4_t vis = vld1q_f32(invstd + l);
+        const float32x4_t vg = vld1q_f32(gamma + l);
+        const float32x4_t vb = vld1q_f32(beta + l);
+        const float32x4_t xv = vld1q_f32(x + l);
+        if (x_hat) {
+          const float32x4_t xh = vmulq_f32(vsubq_f32(xv, vm), vis);
+          vst1q_f32(x_hat + l, xh);
+          vst1q_f32(y + l, VFMAQ_F32(vb, xh, vg));
+        } else {
+          const float32x4_t vs = vmulq_f32(vg, vis);
+          const float32x4_t vt = VFMSQ_F32(vb, vm, vs);
+          vst1q_f32(y + l, VFMAQ_F32(vt, xv, vs));
+        }
+      }
+      for (; l < len; ++l) {
+        if (x_hat) {
+          x_hat[l] = (x[l] - mean[l]) * invstd[l];
+          y[l] = x_hat[l] * gamma[l] + beta[l];
+        } else {
+          const float scale = gamma[l] * invstd[l];
+          y[l] = x[l] * scale + (beta[l] - mean[l] * scale);
+        }
+      }
+    }
+    return;
+  }
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int l = 0; l < len; ++l) {
+      const size_t off = ((size_t)o * len + l) * inner;
+      const float *x = X + off;
+      float *y = Y + off;
+      unsigned int i = 0;
+      if (X_hat) {
+        float *x_hat = X_hat + off;
+        const float32x4_t vm = vdupq_n_f32(mean[l]);
+        const float32x4_t vis = vdupq_n_f32(invstd[l]);
+        const float32x4_t vg = vdupq_n_f32(gamma[l]);
+        const float32x4_t vb = vdupq_n_f32(beta[l]);
+        for (; i + 4 <= inner; i += 4) {
+          const float32x4_t xh =
+            vmulq_f32(vsubq_f32(vld1q_f32(x + i), vm), vis);
+          vst1q_f32(x_hat + i, xh);
+          vst1q_f32(y + i, VFMAQ_F32(vb, xh, vg));
+        }
+        for (; i < inner; ++i) {
+          x_hat[i] = (x[i] - mean[l]) * invstd[l];
+          y[i] = x_hat[i] * gamma[l] + beta[l];
+        }
+      } else {
+        const float scale = gamma[l] * invstd[l];
+        const float shift = beta[l] - mean[l] * scale;
+        const float32x4_t vs = vdupq_n_f32(scale);
+        const float32x4_t vt = vdupq_n_f32(shift);
+        for (; i + 4 <= inner; i += 4)
+          vst1q_f32(y + i, VFMAQ_F32(vt, vld1q_f32(x + i), vs));
+        for (; i < inner; ++i)
+          y[i] = x[i] * scale + shift;
+      }
+    }
+  }
+}
+
+void batch_norm_backward_reduce(const unsigned int outer,
+                                const unsigned int len,
+                                const unsigned int inner, const float *dY,
+                                const float *X_hat, float *sum_dy,
+                                float *sum_dy_xhat) {
+  std::fill(sum_dy, sum_dy + len, 0.0f);
+  std::fill(sum_dy_xhat, sum_dy_xhat + len, 0.0f);
+
+  if (inner == 1) {
+    for (unsigned int o = 0; o < outer; ++o) {
+      const float *dy = dY + (size_t)o * len;
+      const float *x_hat = X_hat + (size_t)o * len;
+      unsigned int l = 0;
+      for (; l + 4 <= len; l += 4) {
+        const float32x4_t d = vld1q_f32(dy + l);
+        vst1q_f32(sum_dy + l, vaddq_f32(vld1q_f32(sum_dy + l), d));
+        vst1q_f32(sum_dy_xhat + l, VFMAQ_F32(vld1q_f32(sum_dy_xhat + l), d,
+                                             vld1q_f32(x_hat + l)));
+      }
+      for (; l < len; ++l) {
+        sum_dy[l] += dy[l];
+        sum_dy_xhat[l] += dy[l] * x_hat[l];
+      }
+    }
+    return;
+  }
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int l = 0; l < len; ++l) {
+      const size_t off = ((size_t)o * len + l) * inner;
+      const float *dy = dY + off;
+      const float *x_hat = X_hat + off;
+      float32x4_t s0 = vdupq_n_f32(0.0f), s1 = vdupq_n_f32(0.0f);
+      float32x4_t sx0 = vdupq_n_f32(0.0f), sx1 = vdupq_n_f32(0.0f);
+      unsigned int i = 0;
+      for (; i + 8 <= inner; i += 8) {
+        const float32x4_t d0 = vld1q_f32(dy + i);
+        const float32x4_t d1 = vld1q_f32(dy + i + 4);
+        s0 = vaddq_f32(s0, d0);
+        s1 = vaddq_f32(s1, d1);
+        sx0 = VFMAQ_F32(sx0, d0, vld1q_f32(x_hat + i));
+        sx1 = VFMAQ_F32(sx1, d1, vld1q_f32(x_hat + i + 4));
+      }
+      for (; i + 4 <= inner; i += 4) {
+        const float32x4_t d0 = vld1q_f32(dy + i);
+        s0 = vaddq_f32(s0, d0);
+        sx0 = VFMAQ_F32(sx0, d0, vld1q_f32(x_hat + i));
+      }
+      float s = hsum_neon(vaddq_f32(s0, s1));
+      float sx = hsum_neon(vaddq_f32(sx0, sx1));
+      for (; i < inner; ++i) {
+        s += dy[i];
+        sx += dy[i] * x_hat[i];
+      }
+      sum_dy[l] += s;
+      sum_dy_xhat[l] += sx;
+    }
+  }
+}
+
+void batch_norm_backward(const unsigned int outer, const unsigned int len,
+                         const unsigned int inner, const float *dY,
+                         const float *X_hat, const float *invstd,
+                         const float *gamma, const float *mean_dy,
+                         const float *mean_dy_xhat, float *dX) {
+  /// dX = scale * dY - (scale * mean_dy_xhat) * X_hat - scale * mean_dy
+  if (inner == 1) {
+    for (unsigned int o = 0; o < outer; ++o) {
+      const float *dy = dY + (size_t)o * len;
+      const float *x_hat = X_hat + (size_t)o * len;
+      float *dx = dX + (size_t)o * len;
+      unsigned int l = 0;
+      for (; l + 4 <= len; l += 4) {
+        const float32x4_t vs =
+          vmulq_f32(vld1q_f32(gamma + l), vld1q_f32(invstd + l));
+        const float32x4_t vu = vmulq_f32(vs, vld1q_f32(mean_dy_xhat + l));
+        const float32x4_t vv = vmulq_f32(vs, vld1q_f32(mean_dy + l));
+        const float32x4_t t = vsubq_f32(vmulq_f32(vs, vld1q_f32(dy + l)), vv);
+        vst1q_f32(dx + l, VFMSQ_F32(t, vld1q_f32(x_hat + l), vu));
+      }
+      for (; l < len; ++l)
+        dx[l] = gamma[l] * invstd[l] *
+                (dy[l] - mean_dy[l] - x_hat[l] * mean_dy_xhat[l]);
+    }
+    return;
+  }
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int l = 0; l < len; ++l) {
+      const size_t off = ((size_t)o * len + l) * inner;
+      const float *dy = dY + off;
+      const float *x_hat = X_hat + off;
+      float *dx = dX + off;
+      const float scale = gamma[l] * invstd[l];
+      const float32x4_t vs = vdupq_n_f32(scale);
+      const float32x4_t vu = vdupq_n_f32(scale * mean_dy_xhat[l]);
+      const float32x4_t vv = vdupq_n_f32(scale * mean_dy[l]);
+      unsigned int i = 0;
+      for (; i + 4 <= inner; i += 4) {
+        const float32x4_t t = vsubq_f32(vmulq_f32(vs, vld1q_f32(dy + i)), vv);
+        vst1q_f32(dx + i, VFMSQ_F32(t, vld1q_f32(x_hat + i), vu));
+      }
+      for (; i < inner; ++i)
+        dx[i] = scale * (dy[i] - mean_dy[l] - x_hat[i] * mean_dy_xhat[l]);
+    }
+  }
+}
+
 template <>
 void clamp(const float *input, float *output, size_t length, float lower_bound,
            float upper_bound) {
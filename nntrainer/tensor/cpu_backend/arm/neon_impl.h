@@ -297,12 +297,15 @@ void transpose_matrix(const unsigned int M, const unsigned int N,
  * @param[in] gqa_size size of group
  * @param[in] head_dim head dimension
  * @param[in] local_window_size windows size for local attention
+ * @param[in] head_start first kv head to compute
+ * @param[in] head_end one past the last kv head to compute, -1 for all
  */
 void compute_fp16vcache_fp32_transposed(int row_num, const float *in,
                                         const __fp16 *vcache, float *output,
                                         int num_cache_head, int gqa_size,
                                         int head_dim,
-                                        size_t local_window_size = UINT_MAX);
+                                        size_t local_window_size = UINT_MAX,
+                                        int head_start = 0, int head_end = -1);
 
 /**
  * @brief Compute kcaches
@@ -316,12 +319,15 @@ void compute_fp16vcache_fp32_transposed(int row_num, const float *in,
  * @param[in] gqa_size size of group
  * @param[in] tile_size size of tile
  * @param[in] local_window_size windows size for local attention
+ * @param[in] head_start first kv head to compute
+ * @param[in] head_end one past the last kv head to compute, -1 for all
  */
 template <typename BType>
 void compute_kcaches(const float *in, const BType *kcache, float *output,
                      int num_rows, int num_cache_head, int head_dim,
                      int gqa_size, int tile_size,
-                     size_t local_window_size = UINT_MAX);
+                     size_t local_window_size = UINT_MAX,
+                     int head_start = 0, int head_end = -1);
 
 /**
  * @brief Compute rotary embedding value
@@ -758,6 +764,66 @@ template <typename T = float>
 void rms_norm_wrt_width_fp16_intrinsic(const T *__restrict X, T *__restrict Y,
                                        size_t H, size_t W, float epsilon);
 
+/**
+ * @brief sum over len of a contiguous (outer, len, inner) tensor, see
+ * nntrainer::reduce_sum
+ */
+void reduce_sum(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y,
+                float alpha, float beta);
+
+/**
+ * @brief maximum over len of a contiguous (outer, len, inner) tensor, see
+ * nntrainer::reduce_max
+ */
+void reduce_max(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y);
+
+/**
+ * @brief Welford mean and population variance over len of a contiguous
+ * (outer, len, inner) tensor, see nntrainer::reduce_mean_var
+ */
+void reduce_mean_var(const unsigned int outer, const unsigned int len,
+                     const unsigned int inner, const float *X, float *mean,
+                     float *var);
+
+/**
+ * @brief l2 norm over len of a contiguous (outer, len, inner) tensor, see
+ * nntrainer::reduce_l2norm
+ */
+void reduce_l2norm(const unsigned int outer, const unsigned int len,
+                   const unsigned int inner, const float *X, float *Y);
+
+/**
+ * @brief batch normalization of a contiguous (outer, len, inner) tensor, see
+ * nntrainer::batch_norm_forward
+ */
+void batch_norm_forward(const unsigned int outer, const unsigned int len,
+                        const unsigned int inner, const float *X,
+                        const float *mean, const float *invstd,
+                        const float *gamma, const float *beta, float *Y,
+                        float *X_hat);
+
+/**
+ * @brief per channel sums of the batch normalization backward pass, see
+ * nntrainer::batch_norm_backward_reduce
+ */
+void batch_norm_backward_reduce(const unsigned int outer,
+                                const unsigned int len,
+                                const unsigned int inner, const float *dY,
+                                const float *X_hat, float *sum_dy,
+                                float *sum_dy_xhat);
+
+/**
+ * @brief derivative of batch normalization, see
+ * nntrainer::batch_norm_backward
+ */
+void batch_norm_backward(const unsigned int outer, const unsigned int len,
+                         const unsigned int inner, const float *dY,
+                         const float *X_hat, const float *invstd,
+                         const float *gamma, const float *mean_dy,
+                         const float *mean_dy_xhat, float *dX);
+
 /**
  * @brief fallback for clamping function.
  *
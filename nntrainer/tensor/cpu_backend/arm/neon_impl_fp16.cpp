@@ -1900,11 +1900,13 @@ static inline void load_fp16_4_to_chunk(const __fp16 *src, float *dst,
 void compute_fp16vcache_fp32_transposed(int row_num, const float *in,
                                         const __fp16 *vcache, float *output,
                                         int num_cache_head, int gqa_size,
-                                        int head_dim,
-                                        size_t local_window_size) {
+                                        int head_dim, size_t local_window_size,
+                                        int head_start, int head_end) {
   std::vector<float> tmp_fp32(head_dim);
+  if (head_end < 0)
+    head_end = num_cache_head;
 
-  for (int n = 0; n < num_cache_head; ++n) {
+  for (int n = head_start; n < head_end; ++n) {
     int num_blocks = head_dim / 4;
     int rem = head_dim % 4;
 
@@ -2009,15 +2011,18 @@ void compute_fp16vcache_transposed(int row_num, const __fp16 *in,
 template <>
 void compute_kcaches(const float *in, const __fp16 *kcache, float *output,
                      int num_rows, int num_cache_head, int head_dim,
-                     int gqa_size, int tile_size, size_t local_window_size) {
+                     int gqa_size, int tile_size, size_t local_window_size,
+                     int head_start, int head_end) {
   std::vector<float> tmp_fp32(head_dim);
 
   int start_row =
     num_rows < local_window_size ? 0 : num_rows - local_window_size;
   int row_cnt = num_rows < local_window_size ? num_rows : local_window_size;
   const int tile_count = (row_cnt + tile_size - 1) / tile_size;
+  if (head_end < 0)
+    head_end = num_cache_head;
 
-  for (int n = 0; n < num_cache_head; ++n) {
+  for (int n = head_start; n < head_end; ++n) {
     for (int t = 0; t < tile_count; ++t) {
       int row_tile_start = t * tile_size;
       int tile_rows = std::min(tile_size, row_cnt - row_tile_start);
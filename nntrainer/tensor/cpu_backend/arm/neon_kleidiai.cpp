@@ -41,6 +41,7 @@
 #include <limits>
 #include <neon_kleidiai.h>
 #include <string>
+#include <thread_runtime.h>
 
 #include <chrono>
 #include <iostream>
@@ -51,6 +52,8 @@ using std::chrono::milliseconds; // or microseconds
 using std::chrono::nanoseconds;  // or microseconds
 using std::chrono::seconds;      // or microseconds
 
+using nntrainer::ThreadRuntime;
+
 // Include micro-kernel variants
 #include "kai/matmul_clamp_f32_qai8dxp_qsi4cxp/kai_lhs_quant_pack_qai8dxp_f32.h"
 #include "kai/matmul_clamp_f32_qai8dxp_qsi4cxp/kai_matmul_clamp_f32_qai8dxp1x8_qsi4cxp4x8_1x4x32_neon_dotprod.h"
@@ -441,8 +444,7 @@ void nntr_kai_gemm_qai8dxp_qsi4cxp_olp_n_parallel(
   int n_threads = 4;
   assert(n % n_threads == 0);
   size_t n_ukernel = n / n_threads;
-#pragma omp parallel for num_thread(n_threads)
-  for (int current_thread = 0; current_thread < n_threads; ++current_thread) {
+  ThreadRuntime::Global().parallel_for(0, n_threads, [&](int current_thread) {
     const size_t dst_stride = n * sizeof(float);
     const size_t lhs_offset =
       ukernel_variants[idx_variant].ukernel.get_lhs_packed_offset(0, k);
@@ -468,7 +470,7 @@ void nntr_kai_gemm_qai8dxp_qsi4cxp_olp_n_parallel(
       sizeof(float),           // DST stride (col)
       lower_bound, upper_bound // Min and max for the clamp operation
     );
-  }
+  });
 
   delete[] lhs_packed_mtx_qa8dx;
 }
@@ -1205,11 +1205,14 @@ extern void softmax_row(_FP16 *qk_out, size_t start_row, size_t end_row,
  * @param[in] gqa_size size of group
  * @param[in] head_dim head dimension
  * @param[in] local_window_size windows size for local attention
+ * @param[in] head_start first kv head to compute
+ * @param[in] head_end one past the last kv head to compute, -1 for all
  */
 extern void compute_fp16vcache_fp32_transposed(
   int row_num, const float *in, const uint16_t *vcache, float *output,
   int num_cache_head, int gqa_size, int head_dim,
-  size_t local_window_size = UINT_MAX);
+  size_t local_window_size = UINT_MAX,
+  int head_start = 0, int head_end = -1);
 
 /**
  * @brief Compute kcaches
@@ -1223,12 +1226,15 @@ extern void compute_fp16vcache_fp32_transposed(
  * @param[in] gqa_size size of group
  * @param[in] tile_size size of tile
  * @param[in] local_window_size windows size for local attention
+ * @param[in] head_start first kv head to compute
+ * @param[in] head_end one past the last kv head to compute, -1 for all
  */
 template <typename BType>
 extern void compute_kcaches(const float *in, const BType *kcache, float *output,
                             int num_rows, int num_cache_head, int head_dim,
                             int gqa_size, int tile_size,
-                            size_t local_window_size = UINT_MAX);
+                            size_t local_window_size = UINT_MAX,
+                            int head_start = 0, int head_end = -1);
 
 /**
  * @brief Compute rotary embedding value
@@ -1289,5 +1295,246 @@ template <typename T = float>
 extern void clamp(const T *input, T *output, size_t length,
                   T lower_bound = std::numeric_limits<T>::lowest(),
                   T upper_bound = std::numeric_limits<T>::max());
+/**
+ * @brief quantize a float weight to int8 with one symmetric scale per output
+ * channel, for gemm_qai8_qsi8cx
+ *
+ * @param N number of output channels
+ * @param K number of input channels
+ * @param W float weight, (K, N) or (N, K) when transB
+ * @param transB whether W is stored as (N, K)
+ * @param qW output (N, K) int8 weight
+ * @param scales output N scales
+ */
+extern void quantize_qsi8cx(const unsigned int N, const unsigned int K,
+                            const float *W, bool transB, int8_t *qW,
+                            float *scales);
+
+/**
+ * @brief quantize a float weight to int4 with one symmetric scale per output
+ * channel, for gemm_qai8_qsi4cx. In each block of 32 input channels, byte j
+ * holds channel j in the low nibble and channel j + 16 in the high nibble,
+ * both offset by 8.
+ *
+ * @param N number of output channels
+ * @param K number of input channels, multiple of 32
+ * @param W float weight, (K, N) or (N, K) when transB
+ * @param transB whether W is stored as (N, K)
+ * @param qW output (N, K / 2) packed int4 weight
+ * @param scales output N scales
+ */
+extern void quantize_qsi4cx(const unsigned int N, const unsigned int K,
+                            const float *W, bool transB, uint8_t *qW,
+                            float *scales);
+
+/**
+ * @brief GEMM of per-row dynamically quantized int8 activation and per-channel
+ * int8 weight, C = A * B^T
+ *
+ * @param M number of rows of A and C
+ * @param N number of rows of B, columns of C
+ * @param K shared dimension
+ * @param A float activation (M, K)
+ * @param lda leading dimension of A
+ * @param B int8 weight (N, K) from quantize_qsi8cx
+ * @param B_scales N scales of B
+ * @param C float output (M, N)
+ * @param ldc leading dimension of C
+ */
+extern void gemm_qai8_qsi8cx(const unsigned int M, const unsigned int N,
+                             const unsigned int K, const float *A,
+                             const unsigned int lda, const int8_t *B,
+                             const float *B_scales, float *C,
+                             const unsigned int ldc);
+
+/**
+ * @brief GEMM of per-row dynamically quantized int8 activation and per-channel
+ * int4 weight, C = A * B^T
+ *
+ * @param M number of rows of A and C
+ * @param N number of rows of B, columns of C
+ * @param K shared dimension, multiple of 32
+ * @param A float activation (M, K)
+ * @param lda leading dimension of A
+ * @param B packed int4 weight (N, K / 2) from quantize_qsi4cx
+ * @param B_scales N scales of B
+ * @param C float output (M, N)
+ * @param ldc leading dimension of C
+ */
+extern void gemm_qai8_qsi4cx(const unsigned int M, const unsigned int N,
+                             const unsigned int K, const float *A,
+                             const unsigned int lda, const uint8_t *B,
+                             const float *B_scales, float *C,
+                             const unsigned int ldc);
+/**
+ * @brief quantize rows of a KV cache to int8 or int4 with one fp16 scale per
+ * block of 32 values. int8 values are in [-127, 127]. int4 values follow the
+ * layout of quantize_qsi4cx: in each block byte j holds value j in the low
+ * nibble and value j + 16 in the high nibble, both offset by 8.
+ *
+ * @param len number of values, multiple of 32
+ * @param in float values
+ * @param cache output len * bits / 8 bytes
+ * @param scales output len / 32 fp16 scales
+ * @param bits 8 or 4
+ */
+extern void quantize_kv_cache(const unsigned int len, const float *in,
+                              uint8_t *cache, uint16_t *scales,
+                              const unsigned int bits);
+
+/**
+ * @brief Compute kcaches of a quantized key cache
+ * @param[in] in float* query of a row, (num_cache_head * gqa_size, head_dim)
+ * @param[in] kcache uint8_t* key cache from quantize_kv_cache
+ * @param[in] kscales uint16_t* fp16 scales of the key cache
+ * @param[out] output float* output float vector
+ * @param[in] num_rows number of row
+ * @param[in] num_cache_head number head of cache
+ * @param[in] head_dim head dimension, multiple of 32
+ * @param[in] gqa_size size of group
+ * @param[in] bits 8 or 4
+ * @param[in] local_window_size windows size for local attention
+ * @param[in] head_start first kv head to compute
+ * @param[in] head_end one past the last kv head to compute, -1 for all
+ */
+extern void compute_kcaches_quantized(
+  const float *in, const uint8_t *kcache, const uint16_t *kscales,
+  float *output, int num_rows, int num_cache_head, int head_dim, int gqa_size,
+  unsigned int bits, size_t local_window_size = UINT_MAX,
+  int head_start = 0, int head_end = -1);
+
+/**
+ * @brief Compute vcache for one row transposed of a quantized value cache
+ * @param[in] row_num row number
+ * @param[in] in float* input vector
+ * @param[in] vcache uint8_t* value cache from quantize_kv_cache
+ * @param[in] vscales uint16_t* fp16 scales of the value cache
+ * @param[out] output float* output vector
+ * @param[in] num_cache_head number head of cache
+ * @param[in] gqa_size size of group
+ * @param[in] head_dim head dimension, multiple of 32
+ * @param[in] bits 8 or 4
+ * @param[in] local_window_size windows size for local attention
+ * @param[in] head_start first kv head to compute
+ * @param[in] head_end one past the last kv head to compute, -1 for all
+ */
+extern void compute_vcache_quantized_transposed(
+  int row_num, const float *in, const uint8_t *vcache, const uint16_t *vscales,
+  float *output, int num_cache_head, int gqa_size, int head_dim,
+  unsigned int bits, size_t local_window_size = UINT_MAX,
+  int head_start = 0, int head_end = -1);
+
+/**
+ * @brief sum of a contiguous (outer, len, inner) tensor over len,
+ * Y[o][i] = alpha * sum_l X[o][l][i] + beta * Y[o][i]
+ * @param[in] outer number of independent slices
+ * @param[in] len length of the reduced axis
+ * @param[in] inner number of contiguous values following the reduced axis
+ * @param[in] X float* input of outer * len * inner values
+ * @param[out] Y float* output of outer * inner values
+ * @param[in] alpha scalar multiplier for the sum
+ * @param[in] beta scalar multiplier for the output, Y is not read when 0
+ */
+extern void reduce_sum(const unsigned int outer, const unsigned int len,
+                       const unsigned int inner, const float *X, float *Y,
+                       float alpha = 1.f, float beta = 0.f);
+
+/**
+ * @brief maximum of a contiguous (outer, len, inner) tensor over len
+ * @param[in] outer number of independent slices
+ * @param[in] len length of the reduced axis, larger than 0
+ * @param[in] inner number of contiguous values following the reduced axis
+ * @param[in] X float* input of outer * len * inner values
+ * @param[out] Y float* output of outer * inner values
+ */
+extern void reduce_max(const unsigned int outer, const unsigned int len,
+                       const unsigned int inner, const float *X, float *Y);
+
+/**
+ * @brief mean and population variance of a contiguous (outer, len, inner)
+ * tensor over len in one pass (Welford)
+ * @param[in] outer number of independent slices
+ * @param[in] len length of the reduced axis, larger than 0
+ * @param[in] inner number of contiguous values following the reduced axis
+ * @param[in] X float* input of outer * len * inner values
+ * @param[out] mean float* output of outer * inner values
+ * @param[out] var float* output of outer * inner values
+ */
+extern void reduce_mean_var(const unsigned int outer, const unsigned int len,
+                            const unsigned int inner, const float *X,
+                            float *mean, float *var);
+
+/**
+ * @brief l2 norm of a contiguous (outer, len, inner) tensor over len
+ * @param[in] outer number of independent slices
+ * @param[in] len length of the reduced axis
+ * @param[in] inner number of contiguous values following the reduced axis
+ * @param[in] X float* input of outer * len * inner values
+ * @param[out] Y float* output of outer * inner values
+ */
+extern void reduce_l2norm(const unsigned int outer, const unsigned int len,
+                          const unsigned int inner, const float *X, float *Y);
+
+/**
+ * @brief batch normalization of a contiguous (outer, len, inner) tensor with
+ * per channel statistics of the len axis,
+ * Y = (X - mean) * invstd * gamma + beta
+ * @param[in] outer number of independent slices
+ * @param[in] len number of channels
+ * @param[in] inner number of contiguous values following the channel axis
+ * @param[in] X float* input of outer * len * inner values
+ * @param[in] mean float* len channel means
+ * @param[in] invstd float* len inverse standard deviations
+ * @param[in] gamma float* len channel scales
+ * @param[in] beta float* len channel shifts
+ * @param[out] Y float* output of outer * len * inner values, may alias X
+ * @param[out] X_hat float* normalized input (X - mean) * invstd, when it is
+ * nullptr Y is computed with the folded scale and shift of every channel
+ */
+extern void batch_norm_forward(const unsigned int outer, const unsigned int len,
+                               const unsigned int inner, const float *X,
+                               const float *mean, const float *invstd,
+                               const float *gamma, const float *beta, float *Y,
+                               float *X_hat = nullptr);
+
+/**
+ * @brief per channel sums of a batch normalization backward pass over a
+ * contiguous (outer, len, inner) tensor, reduced over outer and inner
+ * @param[in] outer number of independent slices
+ * @param[in] len number of channels
+ * @param[in] inner number of contiguous values following the channel axis
+ * @param[in] dY float* incoming derivative of outer * len * inner values
+ * @param[in] X_hat float* normalized input of outer * len * inner values
+ * @param[out] sum_dy float* len sums of dY
+ * @param[out] sum_dy_xhat float* len sums of dY * X_hat
+ */
+extern void batch_norm_backward_reduce(const unsigned int outer,
+                                       const unsigned int len,
+                                       const unsigned int inner,
+                                       const float *dY, const float *X_hat,
+                                       float *sum_dy, float *sum_dy_xhat);
+
+/**
+ * @brief derivative of batch normalization over a contiguous
+ * (outer, len, inner) tensor,
+ * dX = gamma * invstd * (dY - mean_dy - X_hat * mean_dy_xhat)
+ * @param[in] outer number of independent slices
+ * @param[in] len number of channels
+ * @param[in] inner number of contiguous values following the channel axis
+ * @param[in] dY float* incoming derivative of outer * len * inner values
+ * @param[in] X_hat float* normalized input of outer * len * inner values
+ * @param[in] invstd float* len inverse standard deviations
+ * @param[in] gamma float* len channel scales
+ * @param[in] mean_dy float* len channel means of dY
+ * @param[in] mean_dy_xhat float* len channel means of dY * X_hat
+ * @param[out] dX float* outgoing derivative, may alias dY
+ */
+extern void batch_norm_backward(const unsigned int outer,
+                                const unsigned int len,
+                                const unsigned int inner, const float *dY,
+                                const float *X_hat, const float *invstd,
+                                const float *gamma, const float *mean_dy,
+                                const float *mean_dy_xhat, float *dX);
+
 #endif
 #endif
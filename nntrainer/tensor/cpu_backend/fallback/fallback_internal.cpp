@@ -17,10 +17,12 @@
 #include <cmath>
 #include <cstdint>
 #include <fallback_internal.h>
+#include <fp16.h>
 #include <limits>
 #include <stdexcept>
 #include <tensor_dim.h>
 #include <util_func.h>
+#include <vector>
 
 #define sgemv_loop(ci, cj, cM, cN)                                             \
   do {                                                                         \
@@ -551,28 +553,98 @@ void __fallback_repack_q4_K_to_q4_K_8(void *W, void *repacked_W,
 }
 
 void __fallback_softmax_row_inplace(float *qk_out, size_t start_row,
-                                    size_t end_row, size_t num_heads) {
-  throw std::runtime_error("NYI : __fallback_softmax_row_inplace");
+                                    size_t end_row, size_t num_heads,
+                                    float *sink) {
+  std::vector<float> max_vals(num_heads);
+  std::vector<float> sum_vals(num_heads);
+
+  for (size_t c = 0; c < num_heads; ++c) {
+    float max_val = (sink == nullptr) ? -INFINITY : sink[c];
+    for (size_t r = start_row; r < end_row; ++r)
+      max_val = std::max(max_val, qk_out[r * num_heads + c]);
+    max_vals[c] = max_val;
+    sum_vals[c] = (sink == nullptr) ? 0.0f : std::exp(sink[c] - max_val);
+  }
+
+  for (size_t r = start_row; r < end_row; ++r) {
+    for (size_t c = 0; c < num_heads; ++c) {
+      float &a = qk_out[r * num_heads + c];
+      a = std::exp(a - max_vals[c]);
+      sum_vals[c] += a;
+    }
+  }
+
+  for (size_t r = start_row; r < end_row; ++r) {
+    for (size_t c = 0; c < num_heads; ++c) {
+      qk_out[r * num_heads + c] /= sum_vals[c];
+    }
+  }
 }
 
 void __fallback_softmax_row(float *qk_out, size_t start_row, size_t end_row,
-                            size_t num_heads) {
-  throw std::runtime_error("NYI : __fallback_softmax_row");
+                            size_t num_heads, float *sink) {
+  __fallback_softmax_row_inplace(qk_out, start_row, end_row, num_heads, sink);
 }
 
 void __fallback_compute_fp16vcache_fp32_transposed(
   int row_num, const float *in, const uint16_t *vcache, float *output,
-  int num_cache_head, int gqa_size, int head_dim, size_t local_window_size) {
-  throw std::runtime_error(
-    "NYI : __fallback_compute_fp16vcache_fp32_transposed");
+  int num_cache_head, int gqa_size, int head_dim, size_t local_window_size,
+  int head_start, int head_end) {
+  const int start =
+    (size_t)row_num < local_window_size ? 0 : row_num + 1 - local_window_size;
+  if (head_end < 0)
+    head_end = num_cache_head;
+  std::vector<float> v_row(head_dim);
+
+  std::fill(output + (size_t)head_start * gqa_size * head_dim,
+            output + (size_t)head_end * gqa_size * head_dim, 0.0f);
+  for (int n = head_start; n < head_end; ++n) {
+    for (int j = start; j <= row_num; ++j) {
+      const uint16_t *vptr = vcache + ((size_t)j * num_cache_head + n) * head_dim;
+      for (int d = 0; d < head_dim; ++d)
+        v_row[d] = compute_fp16_to_fp32(vptr[d]);
+
+      for (int h = 0; h < gqa_size; ++h) {
+        const float a_val =
+          in[(size_t)(j - start) * gqa_size * num_cache_head + n * gqa_size + h];
+        float *out = output + ((size_t)n * gqa_size + h) * head_dim;
+        for (int d = 0; d < head_dim; ++d)
+          out[d] += a_val * v_row[d];
+      }
+    }
+  }
 }
 
 template <>
 void __fallback_compute_kcaches(const float *in, const uint16_t *kcache,
                                 float *output, int num_rows, int num_cache_head,
                                 int head_dim, int gqa_size, int tile_size,
-                                size_t local_window_size) {
-  throw std::runtime_error("NYI : __fallback_compute_kcaches");
+                                size_t local_window_size, int head_start,
+                                int head_end) {
+  const int start_row =
+    (size_t)num_rows < local_window_size ? 0 : num_rows - local_window_size;
+  const float scale = 1.0f / std::sqrt((float)head_dim);
+  if (head_end < 0)
+    head_end = num_cache_head;
+  std::vector<float> k_row(head_dim);
+
+  for (int n = head_start; n < head_end; ++n) {
+    for (int row = start_row; row < num_rows; ++row) {
+      const uint16_t *kptr =
+        kcache + ((size_t)row * num_cache_head + n) * head_dim;
+      for (int d = 0; d < head_dim; ++d)
+        k_row[d] = compute_fp16_to_fp32(kptr[d]);
+
+      for (int g = 0; g < gqa_size; ++g) {
+        const float *in_ptr = in + ((size_t)n * gqa_size + g) * head_dim;
+        float sum = 0.0f;
+        for (int d = 0; d < head_dim; ++d)
+          sum += in_ptr[d] * k_row[d];
+        output[(size_t)(row - start_row) * num_cache_head * gqa_size +
+               n * gqa_size + g] = sum * scale;
+      }
+    }
+  }
 }
 
 void __fallback_compute_rotary_emb_value(unsigned int width, unsigned int dim,
@@ -580,14 +652,51 @@ void __fallback_compute_rotary_emb_value(unsigned int width, unsigned int dim,
                                          void *output, const float *cos_,
                                          const float *sin_,
                                          bool only_convert_to_fp16) {
-  throw std::runtime_error("NYI : __fallback_compute_rotary_emb_value");
+  uint16_t *out_fp16 = static_cast<uint16_t *>(output);
+
+  for (unsigned int w = 0; w < width; w += dim) {
+    for (unsigned int k = 0; k < half_; ++k) {
+      const unsigned int i0 = w + k;
+      const unsigned int i1 = w + k + half_;
+      float a = inout[i0];
+      float b = inout[i1];
+
+      if (!only_convert_to_fp16) {
+        const float c = cos_[k];
+        const float s = sin_[k];
+        const float out0 = a * c - b * s;
+        const float out1 = a * s + b * c;
+        a = out0;
+        b = out1;
+      }
+
+      if (out_fp16 != nullptr) {
+        out_fp16[i0] = compute_fp32_to_fp16(a);
+        out_fp16[i1] = compute_fp32_to_fp16(b);
+      } else if (!only_convert_to_fp16) {
+        inout[i0] = a;
+        inout[i1] = b;
+      }
+    }
+  }
 }
 
 void __fallback_rms_norm_wrt_width_fp32_intrinsic(const float *__restrict X,
                                                   float *__restrict Y, size_t H,
                                                   size_t W, float epsilon) {
-  throw std::runtime_error(
-    "NYI : __fallback_rms_norm_wrt_width_fp32_intrinsic");
+  for (size_t h = 0; h < H; ++h) {
+    const float *rowX = X + h * W;
+    float *rowY = Y + h * W;
+
+    float sumsq = 0.0f;
+    for (size_t i = 0; i < W; ++i)
+      sumsq += rowX[i] * rowX[i];
+
+    const float scale =
+      1.0f / std::sqrt(sumsq / static_cast<float>(W) + epsilon);
+    for (size_t i = 0; i < W; ++i)
+      rowY[i] = rowX[i] * scale;
+  }
 }
 
 template <>
@@ -606,4 +715,365 @@ void __fallback_clamp(const float *input, float *output, size_t length,
   }
 }
 
+void __fallback_quantize_row_qai8(const unsigned int K, const float *x,
+                                  int8_t *q, float *scale) {
+  float amax = 0.0f;
+  for (unsigned int i = 0; i < K; ++i)
+    amax = std::max(amax, std::fabs(x[i]));
+
+  const float id = (amax != 0.0f) ? 127.0f / amax : 0.0f;
+  *scale = amax / 127.0f;
+  for (unsigned int i = 0; i < K; ++i)
+    q[i] = static_cast<int8_t>(std::nearbyint(x[i] * id));
+}
+
+int32_t __fallback_dot_qai8_qsi8(const unsigned int K, const int8_t *a,
+                                 const int8_t *b) {
+  int32_t sum = 0;
+  for (unsigned int i = 0; i < K; ++i)
+    sum += static_cast<int32_t>(a[i]) * b[i];
+  return sum;
+}
+
+int32_t __fallback_dot_qai8_qsi4(const unsigned int K, const int8_t *a,
+                                 const uint8_t *b) {
+  int32_t sum = 0;
+  for (unsigned int i = 0; i < K; i += 32) {
+    const uint8_t *blk = b + i / 2;
+    for (unsigned int j = 0; j < 16; ++j) {
+      sum += static_cast<int32_t>(a[i + j]) * ((blk[j] & 0x0F) - 8);
+      sum += static_cast<int32_t>(a[i + j + 16]) * ((blk[j] >> 4) - 8);
+    }
+  }
+  return sum;
+}
+
+void __fallback_quantize_qsi8cx(const unsigned int N, const unsigned int K,
+                                const float *W, bool transB, int8_t *qW,
+                                float *scales) {
+  std::vector<float> row(K);
+  for (unsigned int n = 0; n < N; ++n) {
+    for (unsigned int k = 0; k < K; ++k)
+      row[k] = transB ? W[n * K + k] : W[k * N + n];
+    __fallback_quantize_row_qai8(K, row.data(), qW + (size_t)n * K, &scales[n]);
+  }
+}
+
+void __fallback_quantize_qsi4cx(const unsigned int N, const unsigned int K,
+                                const float *W, bool transB, uint8_t *qW,
+                                float *scales) {
+  assert(K % 32 == 0);
+  std::vector<float> row(K);
+  for (unsigned int n = 0; n < N; ++n) {
+    float amax = 0.0f;
+    for (unsigned int k = 0; k < K; ++k) {
+      row[k] = transB ? W[n * K + k] : W[k * N + n];
+      amax = std::max(amax, std::fabs(row[k]));
+    }
+    const float id = (amax != 0.0f) ? 7.0f / amax : 0.0f;
+    scales[n] = amax / 7.0f;
+
+    auto q4 = [&](float v) -> uint8_t {
+      const int q = static_cast<int>(std::nearbyint(v * id));
+      return static_cast<uint8_t>(std::min(7, std::max(-8, q)) + 8);
+    };
+
+    uint8_t *dst = qW + (size_t)n * (K / 2);
+    for (unsigned int i = 0; i < K; i += 32) {
+      for (unsigned int j = 0; j < 16; ++j)
+        dst[i / 2 + j] = q4(row[i + j]) | (q4(row[i + j + 16]) << 4);
+    }
+  }
+}
+
+void __fallback_gemm_qai8_qsi8cx(const unsigned int M, const unsigned int N,
+                                 const unsigned int K, const float *A,
+                                 const unsigned int lda, const int8_t *B,
+                                 const float *B_scales, float *C,
+                                 const unsigned int ldc) {
+  std::vector<int8_t> qa(K);
+  for (unsigned int m = 0; m < M; ++m) {
+    float sa;
+    __fallback_quantize_row_qai8(K, A + (size_t)m * lda, qa.data(), &sa);
+    for (unsigned int n = 0; n < N; ++n)
+      C[(size_t)m * ldc + n] =
+        __fallback_dot_qai8_qsi8(K, qa.data(), B + (size_t)n * K) * sa *
+        B_scales[n];
+  }
+}
+
+void __fallback_gemm_qai8_qsi4cx(const unsigned int M, const unsigned int N,
+                                 const unsigned int K, const float *A,
+                                 const unsigned int lda, const uint8_t *B,
+                                 const float *B_scales, float *C,
+                                 const unsigned int ldc) {
+  std::vector<int8_t> qa(K);
+  for (unsigned int m = 0; m < M; ++m) {
+    float sa;
+    __fallback_quantize_row_qai8(K, A + (size_t)m * lda, qa.data(), &sa);
+    for (unsigned int n = 0; n < N; ++n)
+      C[(size_t)m * ldc + n] =
+        __fallback_dot_qai8_qsi4(K, qa.data(), B + (size_t)n * (K / 2)) * sa *
+        B_scales[n];
+  }
+}
+
+/**
+ * @brief dequantize a row quantized by __fallback_quantize_kv_cache
+ */
+static void dequantize_kv_row(const unsigned int len, const uint8_t *cache,
+                              const uint16_t *scales, float *out,
+                              const unsigned int bits) {
+  for (unsigned int b = 0; b < len / 32; ++b) {
+    const float d = compute_fp16_to_fp32(scales[b]);
+    float *o = out + b * 32;
+    if (bits == 8) {
+      const int8_t *q = reinterpret_cast<const int8_t *>(cache) + b * 32;
+      for (unsigned int j = 0; j < 32; ++j)
+        o[j] = q[j] * d;
+    } else {
+      const uint8_t *q = cache + b * 16;
+      for (unsigned int j = 0; j < 16; ++j) {
+        o[j] = ((q[j] & 0x0F) - 8) * d;
+        o[j + 16] = ((q[j] >> 4) - 8) * d;
+      }
+    }
+  }
+}
+
+void __fallback_quantize_kv_cache(const unsigned int len, const float *in,
+                                  uint8_t *cache, uint16_t *scales,
+                                  const unsigned int bits) {
+  assert(len % 32 == 0 && (bits == 8 || bits == 4));
+  const float qmax = bits == 8 ? 127.0f : 7.0f;
+  for (unsigned int b = 0; b < len / 32; ++b) {
+    const float *x = in + b * 32;
+    float amax = 0.0f;
+    for (unsigned int j = 0; j < 32; ++j)
+      amax = std::max(amax, std::fabs(x[j]));
+
+    /// quantize with the scale as stored so that rounding of the fp16 scale
+    /// does not push values out of range
+    scales[b] = compute_fp32_to_fp16(amax / qmax);
+    const float d = compute_fp16_to_fp32(scales[b]);
+    const float id = d != 0.0f ? 1.0f / d : 0.0f;
+
+    if (bits == 8) {
+      int8_t *q = reinterpret_cast<int8_t *>(cache) + b * 32;
+      for (unsigned int j = 0; j < 32; ++j)
+        q[j] = static_cast<int8_t>(
+          std::clamp(std::nearbyint(x[j] * id), -127.0f, 127.0f));
+    } else {
+      uint8_t *q = cache + b * 16;
+      for (unsigned int j = 0; j < 16; ++j) {
+        const int lo =
+          static_cast<int>(std::clamp(std::nearbyint(x[j] * id), -8.0f, 7.0f));
+        const int hi = static_cast<int>(
+          std::clamp(std::nearbyint(x[j + 16] * id), -8.0f, 7.0f));
+        q[j] = static_cast<uint8_t>((lo + 8) | ((hi + 8) << 4));
+      }
+    }
+  }
+}
+
+void __fallback_compute_kcaches_quantized(
+  const float *in, const uint8_t *kcache, const uint16_t *kscales,
+  float *output, int num_rows, int num_cache_head, int head_dim, int gqa_size,
+  unsigned int bits, size_t local_window_size, int head_start, int head_end) {
+  const int start_row =
+    (size_t)num_rows < local_window_size ? 0 : num_rows - local_window_size;
+  const float scale = 1.0f / std::sqrt((float)head_dim);
+  const size_t row_bytes = (size_t)head_dim * bits / 8;
+  const size_t row_scales = head_dim / 32;
+  if (head_end < 0)
+    head_end = num_cache_head;
+  std::vector<float> k_row(head_dim);
+
+  for (int n = head_start; n < head_end; ++n) {
+    for (int row = start_row; row < num_rows; ++row) {
+      const size_t idx = (size_t)row * num_cache_head + n;
+      dequantize_kv_row(head_dim, kcache + idx * row_bytes,
+                        kscales + idx * row_scales, k_row.data(), bits);
+
+      for (int g = 0; g < gqa_size; ++g) {
+        const float *in_ptr = in + ((size_t)n * gqa_size + g) * head_dim;
+        float sum = 0.0f;
+        for (int d = 0; d < head_dim; ++d)
+          sum += in_ptr[d] * k_row[d];
+        output[(size_t)(row - start_row) * num_cache_head * gqa_size +
+               n * gqa_size + g] = sum * scale;
+      }
+    }
+  }
+}
+
+void __fallback_compute_vcache_quantized_transposed(
+  int row_num, const float *in, const uint8_t *vcache, const uint16_t *vscales,
+  float *output, int num_cache_head, int gqa_size, int head_dim,
+  unsigned int bits, size_t local_window_size, int head_start, int head_end) {
+  const int start =
+    (size_t)row_num < local_window_size ? 0 : row_num + 1 - local_window_size;
+  const size_t row_bytes = (size_t)head_dim * bits / 8;
+  const size_t row_scales = head_dim / 32;
+  if (head_end < 0)
+    head_end = num_cache_head;
+  std::vector<float> v_row(head_dim);
+
+  std::fill(output + (size_t)head_start * gqa_size * head_dim,
+            output + (size_t)head_end * gqa_size * head_dim, 0.0f);
+  for (int n = head_start; n < head_end; ++n) {
+    for (int j = start; j <= row_num; ++j) {
+      const size_t idx = (size_t)j * num_cache_head + n;
+      dequantize_kv_row(head_dim, vcache + idx * row_bytes,
+                        vscales + idx * row_scales, v_row.data(), bits);
+
+      for (int h = 0; h < gqa_size; ++h) {
+        const float a_val =
+          in[(size_t)(j - start) * gqa_size * num_cache_head + n * gqa_size +
+             h];
+        float *out = output + ((size_t)n * gqa_size + h) * head_dim;
+        for (int d = 0; d < head_dim; ++d)
+          out[d] += a_val * v_row[d];
+      }
+    }
+  }
+}
+
+void __fallback_reduce_sum(const unsigned int outer, const unsigned int len,
+                           const unsigned int inner, const float *X, float *Y,
+                           float alpha, float beta) {
+  /// y may be read for beta, so the sums go through a block on the stack
+  constexpr unsigned int block = 64;
+  float acc[block];
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int i0 = 0; i0 < inner; i0 += block) {
+      const unsigned int n = std::min(block, inner - i0);
+      const float *x = X + (size_t)o * len * inner + i0;
+      float *y = Y + (size_t)o * inner + i0;
+      std::fill(acc, acc + n, 0.0f);
+      for (unsigned int l = 0; l < len; ++l)
+        for (unsigned int i = 0; i < n; ++i)
+          acc[i] += x[(size_t)l * inner + i];
+      for (unsigned int i = 0; i < n; ++i)
+        y[i] = alpha * acc[i] + (beta == 0.0f ? 0.0f : beta * y[i]);
+    }
+  }
+}
+
+void __fallback_reduce_max(const unsigned int outer, const unsigned int len,
+                           const unsigned int inner, const float *X, float *Y) {
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *y = Y + (size_t)o * inner;
+    std::copy(x, x + inner, y);
+    for (unsigned int l = 1; l < len; ++l)
+      for (unsigned int i = 0; i < inner; ++i)
+        y[i] = std::max(y[i], x[(size_t)l * inner + i]);
+  }
+}
+
+void __fallback_reduce_mean_var(const unsigned int outer,
+                                const unsigned int len,
+                                const unsigned int inner, const float *X,
+                                float *mean, float *var) {
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *m = mean + (size_t)o * inner;
+    float *m2 = var + (size_t)o * inner;
+    std::fill(m, m + inner, 0.0f);
+    std::fill(m2, m2 + inner, 0.0f);
+    for (unsigned int l = 0; l < len; ++l) {
+      const float inv_n = 1.0f / (l + 1);
+      for (unsigned int i = 0; i < inner; ++i) {
+        const float v = x[(size_t)l * inner + i];
+        const float delta = v - m[i];
+        m[i] += delta * inv_n;
+        m2[i] += delta * (v - m[i]);
+      }
+    }
+    for (unsigned int i = 0; i < inner; ++i)
+      m2[i] /= len;
+  }
+}
+
+void __fallback_reduce_l2norm(const unsigned int outer, const unsigned int len,
+                              const unsigned int inner, const float *X,
+                              float *Y) {
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *y = Y + (size_t)o * inner;
+    std::fill(y, y + inner, 0.0f);
+    for (unsigned int l = 0; l < len; ++l)
+      for (unsigned int i = 0; i < inner; ++i)
+        y[i] += x[(size_t)l * inner + i] * x[(size_t)l * inner + i];
+    for (unsigned int i = 0; i < inner; ++i)
+      y[i] = std::sqrt(y[i]);
+  }
+}
+
+void __fallback_batch_norm_forward(const unsigned int outer,
+                                   const unsigned int len,
+                                   const unsigned int inner, const float *X,
+                                   const float *mean, const float *invstd,
+                                   const float *gamma, const float *beta,
+                                   float *Y, float *X_hat) {
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int l = 0; l < len; ++l) {
+      const size_t off = ((size_t)o * len + l) * inner;
+      const float *x = X + off;
+      float *y = Y + off;
+      if (X_hat) {
+        float *x_hat = X_hat + off;
+        for (unsigned int i = 0; i < inner; ++i) {
+          x_hat[i] = (x[i] - mean[l]) * invstd[l];
+          y[i] = x_hat[i] * gamma[l] + beta[l];
+        }
+      } else {
+        const float scale = gamma[l] * invstd[l];
+        const float shift = beta[l] - mean[l] * scale;
+        for (unsigned int i = 0; i < inner; ++i)
+          y[i] = x[i] * scale + shift;
+      }
+    }
+  }
+}
+
+void __fallback_batch_norm_backward_reduce(const unsigned int outer,
+                                           const unsigned int len,
+                                           const unsigned int inner,
+                                           const float *dY, const float *X_hat,
+                                           float *sum_dy, float *sum_dy_xhat) {
+  std::fill(sum_dy, sum_dy + len, 0.0f);
+  std::fill(sum_dy_xhat, sum_dy_xhat + len, 0.0f);
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int l = 0; l < len; ++l) {
+      const size_t off = ((size_t)o * len + l) * inner;
+      float s = 0.0f, sx = 0.0f;
+      for (unsigned int i = 0; i < inner; ++i) {
+        s += dY[off + i];
+        sx += dY[off + i] * X_hat[off + i];
+      }
+      sum_dy[l] += s;
+      sum_dy_xhat[l] += sx;
+    }
+  }
+}
+
+void __fallback_batch_norm_backward(const unsigned int outer,
+                                    const unsigned int len,
+                                    const unsigned int inner, const float *dY,
+                                    const float *X_hat, const float *invstd,
+                                    const float *gamma, const float *mean_dy,
+                                    const float *mean_dy_xhat, float *dX) {
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int l = 0; l < len; ++l) {
+      const size_t off = ((size_t)o * len + l) * inner;
+      const float scale = gamma[l] * invstd[l];
+      for (unsigned int i = 0; i < inner; ++i)
+        dX[off + i] = scale * (dY[off + i] - mean_dy[l] -
+                               X_hat[off + i] * mean_dy_xhat[l]);
+    }
+  }
+}
+
 } // namespace nntrainer
@@ -0,0 +1,264 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   gemm_tuner.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Autotuner of thread count and column blocking for the k-quantized
+ * GEMM kernels
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <gemm_tuner.h>
+#include <nntrainer_log.h>
+#include <thread_runtime.h>
+
+namespace nntrainer {
+
+namespace {
+
+constexpr const char *tune_file_header = "# nntrainer gemm tuning v1";
+
+/** runs of a candidate, the fastest one counts */
+constexpr unsigned int tune_repeat = 3;
+
+unsigned int align_up(uint64_t v, unsigned int a) {
+  return static_cast<unsigned int>((v + a - 1) / a * a);
+}
+
+unsigned int m_bucket(unsigned int M) {
+  unsigned int b = 1;
+  while (b * 2 <= M)
+    b *= 2;
+  return b;
+}
+
+/**
+ * @brief candidate parameters: powers of two thread counts up to the runtime
+ * size, each with a few column tiles
+ */
+std::vector<GemmTuneParam> candidates(unsigned int N) {
+  const unsigned int max_threads = ThreadRuntime::Global().getNumThreads();
+  std::vector<unsigned int> threads;
+  for (unsigned int t = 1; t < max_threads; t *= 2)
+    threads.push_back(t);
+  threads.push_back(max_threads);
+
+  std::vector<GemmTuneParam> result;
+  for (unsigned int t : threads) {
+    result.push_back({t, 0});
+    if (t == 1)
+      continue;
+    for (unsigned int tile : {32u, 128u, 512u})
+      if (tile * t < N)
+        result.push_back({t, tile});
+  }
+  return result;
+}
+
+uint64_t time_ns(const std::function<void(const GemmTuneParam &)> &run,
+                 const GemmTuneParam &param) {
+  uint64_t best = UINT64_MAX;
+  for (unsigned int r = 0; r < tune_repeat; ++r) {
+    const auto begin = std::chrono::steady_clock::now();
+    run(param);
+    const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - begin)
+                          .count();
+    best = std::min(best, ns);
+  }
+  return best;
+}
+
+} // namespace
+
+void gemm_tuned_cols(
+  const GemmTuneParam &param, unsigned int N, unsigned int col_align,
+  const std::function<void(unsigned int, unsigned int)> &fn) {
+  auto &runtime = ThreadRuntime::Global();
+  const unsigned int threads =
+    param.threads ? std::min(param.threads, runtime.getNumThreads())
+                  : runtime.getNumThreads();
+
+  if (param.tile_n == 0) {
+    runtime.parallel_for(
+      0, threads,
+      [&](unsigned int i) {
+        const unsigned int s =
+          std::min(N, align_up((uint64_t)i * N / threads, col_align));
+        const unsigned int e =
+          std::min(N, align_up((uint64_t)(i + 1) * N / threads, col_align));
+        if (s < e)
+          fn(s, e);
+      },
+      1, threads);
+    return;
+  }
+
+  const unsigned int tile = align_up(param.tile_n, col_align);
+  const unsigned int tiles = (N + tile - 1) / tile;
+  runtime.parallel_for(
+    0, tiles,
+    [&](unsigned int i) { fn(i * tile, std::min(N, (i + 1) * tile)); }, 1,
+    threads);
+}
+
+void GemmTuner::initialize() noexcept {
+  const char *tune = std::getenv("NNTR_GEMM_TUNE");
+  online = tune != nullptr && std::string(tune) == "1";
+
+  const char *file = std::getenv("NNTR_GEMM_TUNE_FILE");
+  if (file != nullptr && *file != '\0') {
+    path = file;
+    load(path);
+  }
+}
+
+GemmTuner::Key GemmTuner::makeKey(GemmTuneKernel kernel, unsigned int M,
+                                  unsigned int N, unsigned int K) {
+  return Key(static_cast<unsigned int>(kernel),
+             ThreadRuntime::Global().getNumThreads(), m_bucket(M), N, K);
+}
+
+GemmTuneParam
+GemmTuner::select(GemmTuneKernel kernel, unsigned int M, unsigned int N,
+                  unsigned int K,
+                  const std::function<void(const GemmTuneParam &)> &run) {
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    auto it = cache.find(makeKey(kernel, M, N, K));
+    if (it != cache.end())
+      return it->second.param;
+  }
+
+  /// timings taken inside a parallel region are meaningless since the
+  /// kernel runs inline there
+  if (!online || ThreadRuntime::inParallelRegion())
+    return GemmTuneParam();
+
+  return tune(kernel, M, N, K, run);
+}
+
+GemmTuneParam
+GemmTuner::tune(GemmTuneKernel kernel, unsigned int M, unsigned int N,
+                unsigned int K,
+                const std::function<void(const GemmTuneParam &)> &run) {
+  /// warm up caches and lazily initialized state before timing
+  run(GemmTuneParam());
+
+  Entry best{GemmTuneParam(), time_ns(run, GemmTuneParam())};
+  for (const auto &param : candidates(N)) {
+    const uint64_t ns = time_ns(run, param);
+    if (ns < best.ns)
+      best = {param, ns};
+  }
+
+  ml_logi("gemm tuner: kernel %u M %u N %u K %u -> threads %u tile %u "
+          "(%llu ns)",
+          static_cast<unsigned int>(kernel), M, N, K, best.param.threads,
+          best.param.tile_n, static_cast<unsigned long long>(best.ns));
+
+  std::string file;
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    cache[makeKey(kernel, M, N, K)] = best;
+    file = path;
+  }
+  if (!file.empty())
+    save(file);
+  return best.param;
+}
+
+void GemmTuner::setFile(const std::string &file) {
+  std::lock_guard<std::mutex> lk(mtx);
+  path = file;
+}
+
+bool GemmTuner::load(const std::string &file) {
+  std::ifstream in(file);
+  if (!in) {
+    ml_logi("gemm tuner: no tuning file at %s", file.c_str());
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(in, line) || line != tune_file_header) {
+    ml_logw("gemm tuner: %s is not a tuning file, ignored", file.c_str());
+    return false;
+  }
+
+  std::map<Key, Entry> entries;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream ss(line);
+    unsigned int kernel, threads, m, n, k;
+    Entry e;
+    if (!(ss >> kernel >> threads >> m >> n >> k >> e.param.threads >>
+          e.param.tile_n >> e.ns) ||
+        kernel > static_cast<unsigned int>(GemmTuneKernel::Q6_K_Q8_K)) {
+      ml_logw("gemm tuner: malformed line in %s is ignored: %s", file.c_str(),
+              line.c_str());
+      continue;
+    }
+    entries[Key(kernel, threads, m, n, k)] = e;
+  }
+
+  std::lock_guard<std::mutex> lk(mtx);
+  for (auto &e : entries)
+    cache[e.first] = e.second;
+  return true;
+}
+
+bool GemmTuner::save(const std::string &file) const {
+  std::ostringstream ss;
+  ss << tune_file_header << '\n'
+     << "# kernel runtime_threads M N K threads tile_n ns\n";
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    for (auto &[key, e] : cache) {
+      ss << std::get<0>(key) << ' ' << std::get<1>(key) << ' '
+         << std::get<2>(key) << ' ' << std::get<3>(key) << ' '
+         << std::get<4>(key) << ' ' << e.param.threads << ' ' << e.param.tile_n
+         << ' ' << e.ns << '\n';
+    }
+  }
+
+  /// write aside and rename so that a reader never sees a partial file
+  const std::string tmp = file + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::trunc);
+    if (!out || !(out << ss.str())) {
+      ml_logw("gemm tuner: failed to write %s", tmp.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp.c_str(), file.c_str()) != 0) {
+    ml_logw("gemm tuner: failed to replace %s", file.c_str());
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+void GemmTuner::clear() {
+  std::lock_guard<std::mutex> lk(mtx);
+  cache.clear();
+}
+
+size_t GemmTuner::size() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  return cache.size();
+}
+
+} // namespace nntrainer
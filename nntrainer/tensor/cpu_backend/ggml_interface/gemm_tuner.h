@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   gemm_tuner.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Autotuner of thread count and column blocking for the k-quantized
+ * GEMM kernels
+ *
+ * @note   The tuner is controlled by the environment.
+ *         NNTR_GEMM_TUNE      : 1 to benchmark every shape not in the cache on
+ *                               its first call
+ *         NNTR_GEMM_TUNE_FILE : tuning file loaded at startup and updated
+ *                               whenever a shape is tuned
+ */
+
+#ifndef __GEMM_TUNER_H__
+#define __GEMM_TUNER_H__
+#ifdef __cplusplus
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include <singleton.h>
+
+namespace nntrainer {
+
+/**
+ * @brief kernels the tuner keeps parameters for
+ */
+enum class GemmTuneKernel : unsigned int {
+  Q4_0_Q8_0 = 0,
+  Q4_K_Q8_K = 1,
+  Q6_K_Q8_K = 2,
+};
+
+/**
+ * @brief parameters a tuned GEMM runs with
+ */
+struct GemmTuneParam {
+  unsigned int threads = 0; /**< threads to use, 0 uses every thread */
+  unsigned int tile_n = 0;  /**< columns per work item, 0 gives one
+                               contiguous part to every thread */
+};
+
+/**
+ * @brief run fn(n_begin, n_end) over the columns [0, N) on the thread runtime
+ * as described by param. Both ends are multiples of col_align except the last
+ * end, which is N.
+ */
+void gemm_tuned_cols(const GemmTuneParam &param, unsigned int N,
+                     unsigned int col_align,
+                     const std::function<void(unsigned int, unsigned int)> &fn);
+
+/**
+ * @class GemmTuner
+ * @brief Keeps the fastest GemmTuneParam per (kernel, M, N, K) measured on
+ * this machine. M is bucketed to powers of two so that prefill lengths share
+ * entries. Entries are also keyed by the runtime thread count, so one file
+ * can hold results of several configurations.
+ */
+class GemmTuner : public Singleton<GemmTuner> {
+public:
+  /**
+   * @brief get the parameters for a shape. When the shape is unknown and
+   * online tuning is enabled, run() is benchmarked with every candidate and
+   * the fastest is stored. Otherwise the default parameters are returned.
+   *
+   * @param kernel kernel to tune
+   * @param M M of the GEMM
+   * @param N N of the GEMM
+   * @param K K of the GEMM
+   * @param run computes the full GEMM with the given parameters. It is called
+   * several times while tuning, so it must only write its output.
+   * @return GemmTuneParam parameters to run with
+   */
+  GemmTuneParam select(GemmTuneKernel kernel, unsigned int M, unsigned int N,
+                       unsigned int K,
+                       const std::function<void(const GemmTuneParam &)> &run);
+
+  /**
+   * @brief benchmark run() with every candidate and store the fastest, even
+   * if the shape is already known
+   */
+  GemmTuneParam tune(GemmTuneKernel kernel, unsigned int M, unsigned int N,
+                     unsigned int K,
+                     const std::function<void(const GemmTuneParam &)> &run);
+
+  /**
+   * @brief enable or disable tuning of unknown shapes in select()
+   */
+  void setOnlineTuning(bool enable) { online = enable; }
+
+  /**
+   * @brief check if unknown shapes are tuned in select()
+   */
+  bool getOnlineTuning() const { return online; }
+
+  /**
+   * @brief set the tuning file that is written whenever a shape is tuned.
+   * Empty path disables writing.
+   */
+  void setFile(const std::string &path);
+
+  /**
+   * @brief merge entries of a tuning file into the cache
+   * @return true if the file was read
+   */
+  bool load(const std::string &path);
+
+  /**
+   * @brief write every entry to a tuning file
+   * @return true if the file was written
+   */
+  bool save(const std::string &path) const;
+
+  /**
+   * @brief drop every cached entry
+   */
+  void clear();
+
+  /**
+   * @brief number of cached entries
+   */
+  size_t size() const;
+
+protected:
+  /**
+   * @copydoc Singleton::initialize()
+   */
+  void initialize() noexcept override;
+
+private:
+  /** kernel, runtime threads, M bucket, N, K */
+  using Key = std::tuple<unsigned int, unsigned int, unsigned int,
+                         unsigned int, unsigned int>;
+
+  /**
+   * @brief tuned parameters and the time they achieved
+   */
+  struct Entry {
+    GemmTuneParam param;
+    uint64_t ns;
+  };
+
+  /**
+   * @brief make the cache key of a shape for the current runtime
+   */
+  static Key makeKey(GemmTuneKernel kernel, unsigned int M, unsigned int N,
+                     unsigned int K);
+
+  mutable std::mutex mtx; /**< guards cache and path */
+  std::map<Key, Entry> cache;
+  std::string path;
+  std::atomic<bool> online{false};
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __GEMM_TUNER_H__ */
@@ -13,13 +13,14 @@
  */
 
 #include <algorithm>
-#include <bs_thread_pool_manager.hpp>
 #include <cmath>
+#include <gemm_tuner.h>
 #include <ggml_interface.h>
 #include <nntr_ggml_impl.h>
 #include <nntr_ggml_impl_utils.h>
 #include <string>
 #include <thread>
+#include <thread_runtime.h>
 #include <vector>
 
 namespace nntrainer {
@@ -28,43 +29,26 @@ static inline void __ggml_q4_0_4x8_q8_0_GEMM_GEMV(
   const unsigned int M, const unsigned int N, const unsigned int K,
   const float *A, const unsigned int lda, const void *B, const unsigned int ldb,
   float *C, const unsigned int ldc) {
-  int NB_COLS = 4;
   int blocks_per_row = (K + QK8_0 - 1) / QK8_0;
   int qa_size = sizeof(block_q8_0) * blocks_per_row;
   std::vector<char> QA = std::vector<char>(qa_size);
 
-  auto qa_data = QA.data();
-
-  nntr_quantize_row_q8_0(A, qa_data, K);
+  nntr_quantize_row_q8_0(A, QA.data(), K);
   int B_step = sizeof(block_q4_0) * (K / QK4_0);
 
-  auto &bs_thread_pool = ThreadPoolManager::Global().getThreadPool();
-  int thread_num = bs_thread_pool.get_thread_count();
-  BS::multi_future<void> loop_future =
-    bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-      unsigned int M_step_start = (i * N) / thread_num;
-      unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-      M_step_start = (M_step_start % NB_COLS)
-                       ? M_step_start + NB_COLS - (M_step_start % NB_COLS)
-                       : M_step_start;
-      M_step_end = (M_step_end % NB_COLS)
-                     ? M_step_end + NB_COLS - (M_step_end % NB_COLS)
-                     : M_step_end;
-
-      nntr_gemv_q4_0_4x8_q8_0(K, (float *)(C + M_step_start), N,
-                              (void *)((char *)B + M_step_start * B_step),
-                              QA.data(), M, M_step_end - M_step_start);
+  auto run = [&](const GemmTuneParam &param) {
+    gemm_tuned_cols(param, N, 4, [&](unsigned int n0, unsigned int n1) {
+      nntr_gemv_q4_0_4x8_q8_0(K, C + n0, N, (const char *)B + n0 * B_step,
+                              QA.data(), M, n1 - n0);
     });
-  loop_future.wait();
+  };
+  run(GemmTuner::Global().select(GemmTuneKernel::Q4_0_Q8_0, M, N, K, run));
 }
 
 static inline void __ggml_q4_0_4x8_q8_0_GEMM_GEMM(
   const unsigned int M, const unsigned int N, const unsigned int K,
   const float *A, const unsigned int lda, const void *B, const unsigned int ldb,
   float *C, const unsigned int ldc) {
-  int NB_COLS = 4;
-  auto &bs_thread_pool = ThreadPoolManager::Global().getThreadPool();
   unsigned int blocks_per_4_rows = (K + QK8_0 - 1) / QK8_0;
   unsigned int qa_4_rows_size = sizeof(block_q8_0x4) * blocks_per_4_rows;
   const size_t qa_row_size = (sizeof(block_q8_0) * K) / QK8_0;
@@ -86,47 +70,23 @@ static inline void __ggml_q4_0_4x8_q8_0_GEMM_GEMM(
       (QA.data() + (M4 * qa_4_rows_size) + (i - M4 * 4) * qa_row_size), K);
   }
 
-  ///@todo Dynamic thread-number selection for GEMM problem size
-  int thread_num = bs_thread_pool.get_thread_count();
-  BS::multi_future<void> multi_future =
-    bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-      unsigned int M_step_start = (i * N) / thread_num;
-      unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-      M_step_start = (M_step_start % NB_COLS)
-                       ? M_step_start + NB_COLS - (M_step_start % NB_COLS)
-                       : M_step_start;
-      M_step_end = (M_step_end % NB_COLS)
-                     ? M_step_end + NB_COLS - (M_step_end % NB_COLS)
-                     : M_step_end;
-
-      nntr_gemm_q4_0_4x8_q8_0(K, (C + (M_step_start)), ldc,
-                              ((char *)B + ((M_step_start)*B_step)), QA.data(),
-                              M4 * 4, (M_step_end) - (M_step_start));
-    });
-  multi_future.wait();
-
-  for (unsigned int pb = M4 * 4; pb < M; pb++) {
-    BS::multi_future<void> loop_future =
-      bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-        unsigned int M_step_start = (i * N) / thread_num;
-        unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-        M_step_start = (M_step_start % NB_COLS)
-                         ? M_step_start + NB_COLS - (M_step_start % NB_COLS)
-                         : M_step_start;
-        M_step_end = (M_step_end % NB_COLS)
-                       ? M_step_end + NB_COLS - (M_step_end % NB_COLS)
-                       : M_step_end;
-
+  // Every column part computes the 4-divisible-M rows with GEMM and the
+  // leftover 1 ~ 3 rows with GEMV, so one parallel region covers all of C
+  auto run = [&](const GemmTuneParam &param) {
+    gemm_tuned_cols(param, N, 4, [&](unsigned int n0, unsigned int n1) {
+      const char *B_part = (const char *)B + n0 * B_step;
+      if (M4 > 0)
+        nntr_gemm_q4_0_4x8_q8_0(K, C + n0, ldc, B_part, QA.data(), M4 * 4,
+                                n1 - n0);
+      for (unsigned int pb = M4 * 4; pb < M; pb++) {
         nntr_gemv_q4_0_4x8_q8_0(
-          K, (float *)((C + ((pb - M4 * 4) * N) + (M4 * 4 * N)) + M_step_start),
-          N, (void *)((char *)B + M_step_start * B_step),
+          K, C + pb * ldc + n0, N, B_part,
           QA.data() + (M4 * qa_4_rows_size) + (pb - M4 * 4) * qa_row_size, 1,
-          M_step_end - M_step_start);
-      });
-    loop_future.wait();
-  }
+          n1 - n0);
+      }
+    });
+  };
+  run(GemmTuner::Global().select(GemmTuneKernel::Q4_0_Q8_0, M, N, K, run));
 }
 
 template <>
@@ -150,8 +110,8 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M,
                                std::vector<unsigned int> ldbs,
                                std::vector<float *> Cs,
                                std::vector<unsigned int> ldcs) {
-  auto &bs_thread_pool = ThreadPoolManager::Global().getThreadPool();
-  int thread_num = bs_thread_pool.get_thread_count();
+  auto &runtime = ThreadRuntime::Global();
+  int thread_num = runtime.getNumThreads();
 
   int NB_COLS = 4;
   int B_step = sizeof(block_q4_0) * (K / QK4_0);
@@ -183,31 +143,29 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M,
                                 QA.data(), M, M_step_end - M_step_start);
       }
     } else {
-      BS::multi_future<void> loop_future =
-        bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-          for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
-            unsigned int N = Ns[num_w];
-            float *C = Cs[num_w];
-            void *B = Bs[num_w];
-            unsigned int M_step_start = (i * N) / thread_num;
-            unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-            M_step_start = (M_step_start % NB_COLS)
-                             ? M_step_start + NB_COLS - (M_step_start % NB_COLS)
-                             : M_step_start;
-            M_step_end = (M_step_end % NB_COLS)
-                           ? M_step_end + NB_COLS - (M_step_end % NB_COLS)
-                           : M_step_end;
-
-            nntr_gemv_q4_0_4x8_q8_0(K, (float *)(C + M_step_start), N,
-                                    (void *)((char *)B + M_step_start * B_step),
-                                    QA.data(), M, M_step_end - M_step_start);
-          }
-        });
-      loop_future.wait();
+      runtime.parallel_for(0, thread_num, [=](int i) {
+        for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
+          unsigned int N = Ns[num_w];
+          float *C = Cs[num_w];
+          void *B = Bs[num_w];
+          unsigned int M_step_start = (i * N) / thread_num;
+          unsigned int M_step_end = ((i + 1) * N) / thread_num;
+
+          M_step_start = (M_step_start % NB_COLS)
+                           ? M_step_start + NB_COLS - (M_step_start % NB_COLS)
+                           : M_step_start;
+          M_step_end = (M_step_end % NB_COLS)
+                         ? M_step_end + NB_COLS - (M_step_end % NB_COLS)
+                         : M_step_end;
+
+          nntr_gemv_q4_0_4x8_q8_0(K, (float *)(C + M_step_start), N,
+                                  (void *)((char *)B + M_step_start * B_step),
+                                  QA.data(), M, M_step_end - M_step_start);
+        }
+      });
     }
   } else {
-    int n_threads = std::thread::hardware_concurrency() / 2;
+    int n_threads = ThreadRuntime::Global().getNumThreads();
     unsigned int qa_4_rows_size = sizeof(block_q8_0x4) * blocks_per_4_rows;
     const size_t qa_row_size = (sizeof(block_q8_0) * K) / QK8_0;
 
@@ -227,8 +185,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M,
         (QA.data() + (M4 * qa_4_rows_size) + (i - M4 * 4) * qa_row_size), K);
     }
 
-#pragma omp parallel for schedule(guided) num_threads(n_threads)
-    for (int i = 0; i < n_threads; i++) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int i) {
       for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
         unsigned int N = Ns[num_w];
         unsigned int ldc = ldcs[num_w];
@@ -251,11 +208,10 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M,
                                 (void *)((char *)B + src0_start * B_step),
                                 QA.data(), M4 * 4, src0_end - src0_start);
       }
-    }
+    });
 
     n_threads = 4;
-#pragma omp parallel for schedule(guided) num_threads(n_threads)
-    for (int thread_idx = 0; thread_idx < n_threads; ++thread_idx) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int thread_idx) {
       for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
         unsigned int N = Ns[num_w];
         unsigned int ldc = ldcs[num_w];
@@ -280,7 +236,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M,
             M_step_end - M_step_start);
         }
       }
-    }
+    });
   }
 }
 
@@ -292,35 +248,22 @@ static inline void __ggml_q4_0_8x8_q8_0_GEMM_GEMV(
   int qa_size = sizeof(block_q8_0) * blocks_per_row;
   std::vector<char> QA = std::vector<char>(qa_size);
 
-  auto qa_data = QA.data();
-
-  nntr_quantize_row_q8_0(A, qa_data, K);
+  nntr_quantize_row_q8_0(A, QA.data(), K);
   int B_step = sizeof(block_q4_0) * (K / QK4_0);
 
-  auto &bs_thread_pool = ThreadPoolManager::Global().getThreadPool();
-  int thread_num = bs_thread_pool.get_thread_count();
-  BS::multi_future<void> loop_future =
-    bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-      unsigned int M_step_start = (i * N) / thread_num;
-      unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-      M_step_start = (M_step_start % 8) ? M_step_start + 8 - (M_step_start % 8)
-                                        : M_step_start;
-      M_step_end =
-        (M_step_end % 8) ? M_step_end + 8 - (M_step_end % 8) : M_step_end;
-
-      nntr_gemv_q4_0_8x8_q8_0(K, (float *)(C + M_step_start), N,
-                              (void *)((char *)B + M_step_start * B_step),
-                              QA.data(), M, M_step_end - M_step_start);
+  auto run = [&](const GemmTuneParam &param) {
+    gemm_tuned_cols(param, N, 8, [&](unsigned int n0, unsigned int n1) {
+      nntr_gemv_q4_0_8x8_q8_0(K, C + n0, N, (const char *)B + n0 * B_step,
+                              QA.data(), M, n1 - n0);
     });
-  loop_future.wait();
+  };
+  run(GemmTuner::Global().select(GemmTuneKernel::Q4_0_Q8_0, M, N, K, run));
 }
 
 static inline void __ggml_q4_0_8x8_q8_0_GEMM_GEMM(
   const unsigned int M, const unsigned int N, const unsigned int K,
   const float *A, const unsigned int lda, const void *B, const unsigned int ldb,
   float *C, const unsigned int ldc) {
-  auto &bs_thread_pool = ThreadPoolManager::Global().getThreadPool();
   unsigned int blocks_per_4_rows = (K + QK8_0 - 1) / QK8_0;
   unsigned int qa_4_rows_size = sizeof(block_q8_0x4) * blocks_per_4_rows;
   const size_t qa_row_size = (sizeof(block_q8_0) * K) / QK8_0;
@@ -342,44 +285,23 @@ static inline void __ggml_q4_0_8x8_q8_0_GEMM_GEMM(
       (QA.data() + (M4 * qa_4_rows_size) + (i - M4 * 4) * qa_row_size), K);
   }
 
-  ///@todo Dynamic thread-number selection for GEMM problem size
-  int thread_num = bs_thread_pool.get_thread_count();
-  BS::multi_future<void> multi_future =
-    bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-      unsigned int M_step_start = (i * N) / thread_num;
-      unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-      M_step_start = (M_step_start % 8) ? M_step_start + 8 - (M_step_start % 8)
-                                        : M_step_start;
-      M_step_end =
-        (M_step_end % 8) ? M_step_end + 8 - (M_step_end % 8) : M_step_end;
-
-      nntr_gemm_q4_0_8x8_q8_0(K, (C + (M_step_start)), ldc,
-                              ((char *)B + ((M_step_start)*B_step)), QA.data(),
-                              M4 * 4, (M_step_end) - (M_step_start));
-    });
-  multi_future.wait();
-
-  for (unsigned int pb = M4 * 4; pb < M; pb++) {
-    BS::multi_future<void> loop_future =
-      bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-        unsigned int M_step_start = (i * N) / thread_num;
-        unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-        M_step_start = (M_step_start % 8)
-                         ? M_step_start + 8 - (M_step_start % 8)
-                         : M_step_start;
-        M_step_end =
-          (M_step_end % 8) ? M_step_end + 8 - (M_step_end % 8) : M_step_end;
-
+  // Every column part computes the 4-divisible-M rows with GEMM and the
+  // leftover 1 ~ 3 rows with GEMV, so one parallel region covers all of C
+  auto run = [&](const GemmTuneParam &param) {
+    gemm_tuned_cols(param, N, 8, [&](unsigned int n0, unsigned int n1) {
+      const char *B_part = (const char *)B + n0 * B_step;
+      if (M4 > 0)
+        nntr_gemm_q4_0_8x8_q8_0(K, C + n0, ldc, B_part, QA.data(), M4 * 4,
+                                n1 - n0);
+      for (unsigned int pb = M4 * 4; pb < M; pb++) {
         nntr_gemv_q4_0_8x8_q8_0(
-          K, (float *)((C + ((pb - M4 * 4) * N) + (M4 * 4 * N)) + M_step_start),
-          N, (void *)((char *)B + M_step_start * B_step),
+          K, C + pb * ldc + n0, N, B_part,
           QA.data() + (M4 * qa_4_rows_size) + (pb - M4 * 4) * qa_row_size, 1,
-          M_step_end - M_step_start);
-      });
-    loop_future.wait();
-  }
+          n1 - n0);
+      }
+    });
+  };
+  run(GemmTuner::Global().select(GemmTuneKernel::Q4_0_Q8_0, M, N, K, run));
 }
 
 void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
@@ -402,8 +324,8 @@ void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M,
                                std::vector<unsigned int> ldbs,
                                std::vector<float *> Cs,
                                std::vector<unsigned int> ldcs) {
-  auto &bs_thread_pool = ThreadPoolManager::Global().getThreadPool();
-  int thread_num = bs_thread_pool.get_thread_count();
+  auto &runtime = ThreadRuntime::Global();
+  int thread_num = runtime.getNumThreads();
 
   int B_step = sizeof(block_q4_0) * (K / QK4_0);
   int blocks_per_4_rows = (K + QK8_0 - 1) / QK8_0;
@@ -434,29 +356,27 @@ void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M,
       }
     }
 
-    BS::multi_future<void> loop_future =
-      bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-        for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
-          unsigned int N = Ns[num_w];
-          float *C = Cs[num_w];
-          void *B = Bs[num_w];
-          unsigned int M_step_start = (i * N) / thread_num;
-          unsigned int M_step_end = ((i + 1) * N) / thread_num;
+    runtime.parallel_for(0, thread_num, [=](int i) {
+      for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
+        unsigned int N = Ns[num_w];
+        float *C = Cs[num_w];
+        void *B = Bs[num_w];
+        unsigned int M_step_start = (i * N) / thread_num;
+        unsigned int M_step_end = ((i + 1) * N) / thread_num;
 
-          M_step_start = (M_step_start % 8)
-                           ? M_step_start + 8 - (M_step_start % 8)
-                           : M_step_start;
-          M_step_end =
-            (M_step_end % 8) ? M_step_end + 8 - (M_step_end % 8) : M_step_end;
+        M_step_start = (M_step_start % 8)
+                         ? M_step_start + 8 - (M_step_start % 8)
+                         : M_step_start;
+        M_step_end =
+          (M_step_end % 8) ? M_step_end + 8 - (M_step_end % 8) : M_step_end;
 
-          nntr_gemv_q4_0_8x8_q8_0(K, (float *)(C + M_step_start), N,
-                                  (void *)((char *)B + M_step_start * B_step),
-                                  QA.data(), M, M_step_end - M_step_start);
-        }
-      });
-    loop_future.wait();
+        nntr_gemv_q4_0_8x8_q8_0(K, (float *)(C + M_step_start), N,
+                                (void *)((char *)B + M_step_start * B_step),
+                                QA.data(), M, M_step_end - M_step_start);
+      }
+    });
   } else {
-    int n_threads = std::thread::hardware_concurrency() / 2;
+    int n_threads = ThreadRuntime::Global().getNumThreads();
     unsigned int qa_4_rows_size = sizeof(block_q8_0x4) * blocks_per_4_rows;
     const size_t qa_row_size = (sizeof(block_q8_0) * K) / QK8_0;
 
@@ -476,8 +396,7 @@ void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M,
         (QA.data() + (M4 * qa_4_rows_size) + (i - M4 * 4) * qa_row_size), K);
     }
 
-#pragma omp parallel for schedule(guided) num_threads(n_threads)
-    for (int i = 0; i < n_threads; i++) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int i) {
       for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
         unsigned int N = Ns[num_w];
         unsigned int ldc = ldcs[num_w];
@@ -497,11 +416,10 @@ void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M,
                                 (void *)((char *)B + src0_start * B_step),
                                 QA.data(), M4 * 4, src0_end - src0_start);
       }
-    }
+    });
 
     n_threads = 4;
-#pragma omp parallel for schedule(guided) num_threads(n_threads)
-    for (int thread_idx = 0; thread_idx < n_threads; ++thread_idx) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int thread_idx) {
       for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
         unsigned int N = Ns[num_w];
         unsigned int ldc = ldcs[num_w];
@@ -525,7 +443,7 @@ void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M,
             M_step_end - M_step_start);
         }
       }
-    }
+    });
   }
 }
 
@@ -537,33 +455,21 @@ static inline void __ggml_q4_K_8x8_q8_K_GEMM_GEMV(
   int blocks_per_row = (K + QK_K - 1) / QK_K;
   int qa_size = sizeof(block_q8_K) * blocks_per_row;
   std::vector<char> QA = std::vector<char>(qa_size);
-  auto qa_data = QA.data();
-  nntr_quantize_row_q8_K(A, qa_data, K);
-
-  auto &bs_thread_pool = ThreadPoolManager::Global().getThreadPool();
-  int thread_num = bs_thread_pool.get_thread_count();
-  BS::multi_future<void> loop_future =
-    bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-      unsigned int M_step_start = (i * N) / thread_num;
-      unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-      M_step_start = (M_step_start % 8) ? M_step_start + 8 - (M_step_start % 8)
-                                        : M_step_start;
-      M_step_end =
-        (M_step_end % 8) ? M_step_end + 8 - (M_step_end % 8) : M_step_end;
-
-      nntr_gemv_q4_K_8x8_q8_K(K, (float *)(C + M_step_start), N,
-                              (void *)((char *)B + M_step_start * B_step),
-                              QA.data(), M, M_step_end - M_step_start);
+  nntr_quantize_row_q8_K(A, QA.data(), K);
+
+  auto run = [&](const GemmTuneParam &param) {
+    gemm_tuned_cols(param, N, 8, [&](unsigned int n0, unsigned int n1) {
+      nntr_gemv_q4_K_8x8_q8_K(K, C + n0, N, (const char *)B + n0 * B_step,
+                              QA.data(), M, n1 - n0);
     });
-  loop_future.wait();
+  };
+  run(GemmTuner::Global().select(GemmTuneKernel::Q4_K_Q8_K, M, N, K, run));
 }
 
 static inline void __ggml_q4_K_8x8_q8_K_GEMM_GEMM(
   const unsigned int M, const unsigned int N, const unsigned int K,
   const float *A, const unsigned int lda, const void *B, const unsigned int ldb,
   float *C, const unsigned int ldc) {
-  auto &bs_thread_pool = ThreadPoolManager::Global().getThreadPool();
   unsigned int blocks_per_4_rows = (K + QK_K - 1) / QK_K;
   unsigned int qa_4_rows_size = sizeof(block_q8_Kx4) * blocks_per_4_rows;
   const size_t qa_row_size = (sizeof(block_q8_K) * K) / QK_K;
@@ -585,44 +491,23 @@ static inline void __ggml_q4_K_8x8_q8_K_GEMM_GEMM(
       (QA.data() + (M4 * qa_4_rows_size) + (i - M4 * 4) * qa_row_size), K);
   }
 
-  ///@todo Dynamic thread-number selection for GEMM problem size
-  int thread_num = bs_thread_pool.get_thread_count();
-  BS::multi_future<void> multi_future =
-    bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-      unsigned int M_step_start = (i * N) / thread_num;
-      unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-      M_step_start = (M_step_start % 8) ? M_step_start + 8 - (M_step_start % 8)
-                                        : M_step_start;
-      M_step_end =
-        (M_step_end % 8) ? M_step_end + 8 - (M_step_end % 8) : M_step_end;
-
-      nntr_gemm_q4_K_8x8_q8_K(K, (C + (M_step_start)), ldc,
-                              ((char *)B + ((M_step_start)*B_step)), QA.data(),
-                              M4 * 4, (M_step_end) - (M_step_start));
-    });
-  multi_future.wait();
-
-  for (unsigned int pb = M4 * 4; pb < M; pb++) {
-    BS::multi_future<void> loop_future =
-      bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-        unsigned int M_step_start = (i * N) / thread_num;
-        unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-        M_step_start = (M_step_start % 8)
-                         ? M_step_start + 8 - (M_step_start % 8)
-                         : M_step_start;
-        M_step_end =
-          (M_step_end % 8) ? M_step_end + 8 - (M_step_end % 8) : M_step_end;
-
+  // Every column part computes the 4-divisible-M rows with GEMM and the
+  // leftover 1 ~ 3 rows with GEMV, so one parallel region covers all of C
+  auto run = [&](const GemmTuneParam &param) {
+    gemm_tuned_cols(param, N, 8, [&](unsigned int n0, unsigned int n1) {
+      const char *B_part = (const char *)B + n0 * B_step;
+      if (M4 > 0)
+        nntr_gemm_q4_K_8x8_q8_K(K, C + n0, ldc, B_part, QA.data(), M4 * 4,
+                                n1 - n0);
+      for (unsigned int pb = M4 * 4; pb < M; pb++) {
         nntr_gemv_q4_K_8x8_q8_K(
-          K, (float *)((C + ((pb - M4 * 4) * N) + (M4 * 4 * N)) + M_step_start),
-          N, (void *)((char *)B + M_step_start * B_step),
+          K, C + pb * ldc + n0, N, B_part,
           QA.data() + (M4 * qa_4_rows_size) + (pb - M4 * 4) * qa_row_size, 1,
-          M_step_end - M_step_start);
-      });
-    loop_future.wait();
-  }
+          n1 - n0);
+      }
+    });
+  };
+  run(GemmTuner::Global().select(GemmTuneKernel::Q4_K_Q8_K, M, N, K, run));
 }
 
 void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M, const unsigned int N,
@@ -645,8 +530,8 @@ void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M,
                                std::vector<float *> Cs,
                                std::vector<unsigned int> ldcs) {
 
-  auto &bs_thread_pool = ThreadPoolManager::Global().getThreadPool();
-  int thread_num = bs_thread_pool.get_thread_count();
+  auto &runtime = ThreadRuntime::Global();
+  int thread_num = runtime.getNumThreads();
 
   int B_step = sizeof(block_q4_K) * (K / QK_K);
   int blocks_per_4_rows = (K + QK_K - 1) / QK_K;
@@ -676,31 +561,29 @@ void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M,
                                 QA.data(), M, M_step_end - M_step_start);
       }
     } else {
-      BS::multi_future<void> loop_future =
-        bs_thread_pool.submit_loop(0, thread_num, [=](int i) {
-          for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
-            unsigned int N = Ns[num_w];
-            float *C = Cs[num_w];
-            void *B = Bs[num_w];
-            unsigned int M_step_start = (i * N) / thread_num;
-            unsigned int M_step_end = ((i + 1) * N) / thread_num;
-
-            M_step_start = (M_step_start % 8)
-                             ? M_step_start + 8 - (M_step_start % 8)
-                             : M_step_start;
-            M_step_end =
-              (M_step_end % 8) ? M_step_end + 8 - (M_step_end % 8) : M_step_end;
-
-            nntr_gemv_q4_K_8x8_q8_K(K, (float *)(C + M_step_start), N,
-                                    (void *)((char *)B + M_step_start * B_step),
-                                    QA.data(), M, M_step_end - M_step_start);
-          }
-        });
-      loop_future.wait();
+      runtime.parallel_for(0, thread_num, [=](int i) {
+        for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
+          unsigned int N = Ns[num_w];
+          float *C = Cs[num_w];
+          void *B = Bs[num_w];
+          unsigned int M_step_start = (i * N) / thread_num;
+          unsigned int M_step_end = ((i + 1) * N) / thread_num;
+
+          M_step_start = (M_step_start % 8)
+                           ? M_step_start + 8 - (M_step_start % 8)
+                           : M_step_start;
+          M_step_end =
+            (M_step_end % 8) ? M_step_end + 8 - (M_step_end % 8) : M_step_end;
+
+          nntr_gemv_q4_K_8x8_q8_K(K, (float *)(C + M_step_start), N,
+                                  (void *)((char *)B + M_step_start * B_step),
+                                  QA.data(), M, M_step_end - M_step_start);
+        }
+      });
     }
   } else {
 
-    int n_threads = std::thread::hardware_concurrency() / 2;
+    int n_threads = ThreadRuntime::Global().getNumThreads();
     unsigned int qa_4_rows_size = sizeof(block_q8_Kx4) * blocks_per_4_rows;
     const size_t qa_row_size = (sizeof(block_q8_K) * K) / QK_K;
 
@@ -720,8 +603,7 @@ void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M,
         (QA.data() + (M4 * qa_4_rows_size) + (i - M4 * 4) * qa_row_size), K);
     }
 
-#pragma omp parallel for schedule(guided) num_threads(n_threads)
-    for (int i = 0; i < n_threads; i++) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int i) {
       for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
         unsigned int N = Ns[num_w];
         unsigned int ldc = ldcs[num_w];
@@ -741,11 +623,10 @@ void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M,
                                 (void *)((char *)B + src0_start * B_step),
                                 QA.data(), M4 * 4, src0_end - src0_start);
       }
-    }
+    });
 
     n_threads = 4;
-#pragma omp parallel for schedule(guided) num_threads(n_threads)
-    for (int thread_idx = 0; thread_idx < n_threads; ++thread_idx) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int thread_idx) {
       for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
         unsigned int N = Ns[num_w];
         unsigned int ldc = ldcs[num_w];
@@ -769,7 +650,7 @@ void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M,
             M_step_end - M_step_start);
         }
       }
-    }
+    });
   }
 }
 
@@ -788,36 +669,24 @@ void __ggml_gemm_q6_K(const unsigned int M, const unsigned int N,
   const int32_t A_row_size = sizeof(block_q8_K) * blocks_per_row;
   const int32_t B_row_size = sizeof(block_q6_K) * blocks_per_row;
 
-  auto &tp = ThreadPoolManager::Global().getThreadPool();
-  if (M == 1) {
-    std::vector<char> quantized_A(A_row_size);
-    nntr_quantize_row_q8_K(A, quantized_A.data(), K);
-    const void *quantized_A_data = quantized_A.data();
-
-    auto fut = tp.submit_loop(0, static_cast<int>(N), [&](int i) {
-      const void *bptr = (const char *)B + i * B_row_size;
-      nntr_vec_dot_q6_K_q8_K(K, &C[i], bs, bptr, bx, quantized_A_data, by, nrc);
-    });
-    fut.wait();
-  } else {
-    const int32_t A_total_size = A_row_size * static_cast<int32_t>(M);
-    std::vector<char> quantized_A(A_total_size);
-
-    for (int i = 0; i < static_cast<int>(M); ++i) {
-      void *row_ptr = quantized_A.data() + i * A_row_size;
-      nntr_quantize_row_q8_K(A + i * K, row_ptr, K);
-    }
+  std::vector<char> quantized_A(static_cast<size_t>(A_row_size) * M);
+  for (unsigned int i = 0; i < M; ++i)
+    nntr_quantize_row_q8_K(A + i * K, quantized_A.data() + i * A_row_size,
+                           K);
 
-    auto fut = tp.submit_loop(0, static_cast<int>(M), [&](int i) {
-      const void *a_row = quantized_A.data() + i * A_row_size;
-      float *c_row = C + i * ldc;
-      for (unsigned int j = 0; j < N; ++j) {
+  // Split the columns so that every weight row is read by a single thread
+  // and reused for all rows of A
+  auto run = [&](const GemmTuneParam &param) {
+    gemm_tuned_cols(param, N, 1, [&](unsigned int n0, unsigned int n1) {
+      for (unsigned int j = n0; j < n1; ++j) {
         const void *bptr = (const char *)B + j * B_row_size;
-        nntr_vec_dot_q6_K_q8_K(K, &c_row[j], bs, bptr, bx, a_row, by, nrc);
+        for (unsigned int i = 0; i < M; ++i)
+          nntr_vec_dot_q6_K_q8_K(K, &C[i * ldc + j], bs, bptr, bx,
+                                 quantized_A.data() + i * A_row_size, by, nrc);
       }
     });
-    fut.wait();
-  }
+  };
+  run(GemmTuner::Global().select(GemmTuneKernel::Q6_K_Q8_K, M, N, K, run));
 }
 
 } // namespace nntrainer
@@ -21,6 +21,7 @@
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <thread_runtime.h>
 #include <vector>
 
 namespace nntrainer {
@@ -40,8 +41,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
     std::vector<char> QA = std::vector<char>(qa_size);
     nntr_quantize_row_q8_0(A, QA.data(), K);
 
-#pragma omp parallel for num_threads(n_threads)
-    for (int thread_idx = 0; thread_idx < n_threads; ++thread_idx) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int thread_idx) {
       unsigned int M_step_start = (thread_idx * N) / n_threads;     // = 0
       unsigned int M_step_end = ((thread_idx + 1) * N) / n_threads; // ne01 = N
 
@@ -55,7 +55,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
       nntr_gemv_q4_0_4x8_q8_0(K, (float *)((C) + M_step_start), N,
                               (void *)((char *)B + M_step_start * B_step),
                               QA.data(), M, M_step_end - M_step_start);
-    }
+    });
   } else if (M % 4 != 0) {
     int n_threads = 8;
     unsigned int blocks_per_4_rows = (K + QK8_0 - 1) / QK8_0;
@@ -80,8 +80,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
     }
 
 // Compute 4-divisible-M row portion with multithreaded GEMM
-#pragma omp parallel for num_threads(n_threads)
-    for (int i = 0; i < n_threads; i++) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int i) {
       unsigned int src0_start = (i * N) / n_threads;
       unsigned int src0_end = ((i + 1) * N) / n_threads;
 
@@ -95,13 +94,12 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
       nntr_gemm_q4_0_4x8_q8_0(K, (float *)(C + src0_start), ldc,
                               (void *)((char *)B + src0_start * B_step),
                               QA.data(), M4 * 4, src0_end - src0_start);
-    }
+    });
 
     // Compute leftover 1 ~ 3 rows with multithreaded GEMV
     n_threads = 4;
     for (unsigned int pb = M4 * 4; pb < M; pb++) {
-#pragma omp parallel for num_threads(n_threads)
-      for (int thread_idx = 0; thread_idx < n_threads; ++thread_idx) {
+      ThreadRuntime::Global().parallel_for(0, n_threads, [&](int thread_idx) {
         unsigned int M_step_start = (thread_idx * N) / n_threads; // = 0
         unsigned int M_step_end =
           ((thread_idx + 1) * N) / n_threads; // ne01 = N
@@ -118,7 +116,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
           N, (void *)((char *)B + M_step_start * B_step),
           QA.data() + (M4 * qa_4_rows_size) + (pb - M4 * 4) * qa_row_size, 1,
           M_step_end - M_step_start);
-      }
+      });
     }
   } else { // GEMM
     unsigned int blocks_per_4_rows = (K + QK8_0 - 1) / QK8_0;
@@ -136,11 +134,10 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
       nntr_quantize_mat_q8_0_4x8(A + 4 * i * K, QA.data() + i * qa_4_rows_size,
                                  K);
     }
-    int thread_num = std::thread::hardware_concurrency() / 2;
+    int thread_num = ThreadRuntime::Global().getNumThreads();
     unsigned int B_step = sizeof(block_q4_0) * (K / QK4_0);
 
-#pragma omp parallel for num_threads(thread_num)
-    for (int i = 0; i < thread_num; i++) {
+    ThreadRuntime::Global().parallel_for(0, thread_num, [&](int i) {
       unsigned int src0_start = (i * N) / thread_num;
       unsigned int src0_end = ((i + 1) * N) / thread_num;
 
@@ -154,7 +151,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
       nntr_gemm_q4_0_4x8_q8_0(K, (float *)(C + src0_start), ldc,
                               (void *)((char *)B + src0_start * B_step),
                               QA.data(), M, src0_end - src0_start);
-    }
+    });
   }
 }
 
@@ -198,8 +195,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M,
     } else {
       int n_threads = 1;
       // std::cout << "Parrallel gemv Ns.size(): " << Ns.size() << std::endl;
-#pragma omp parallel for num_threads(n_threads)
-      for (int i = 0; i < n_threads; ++i) {
+      ThreadRuntime::Global().parallel_for(0, n_threads, [&](int i) {
         for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
           unsigned int N = Ns[num_w];
           float *C = Cs[num_w];
@@ -218,7 +214,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M,
                                   (void *)((char *)B + M_step_start * B_step),
                                   QA.data(), M, M_step_end - M_step_start);
         }
-      }
+      });
     }
   } else {
     int n_threads = 4;
@@ -241,8 +237,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M,
         (QA.data() + (M4 * qa_4_rows_size) + (i - M4 * 4) * qa_row_size), K);
     }
 
-#pragma omp parallel for schedule(guided) num_threads(n_threads)
-    for (int i = 0; i < n_threads; i++) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int i) {
       for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
         unsigned int N = Ns[num_w];
         unsigned int ldc = ldcs[num_w];
@@ -265,11 +260,10 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M,
                                 (void *)((char *)B + src0_start * B_step),
                                 QA.data(), M4 * 4, src0_end - src0_start);
       }
-    }
+    });
     if (M4 * 4 != M) {
       n_threads = 4;
-#pragma omp parallel for schedule(guided) num_threads(n_threads)
-      for (int thread_idx = 0; thread_idx < n_threads; ++thread_idx) {
+      ThreadRuntime::Global().parallel_for(0, n_threads, [&](int thread_idx) {
         for (unsigned int num_w = 0; num_w < Ns.size(); ++num_w) {
           unsigned int N = Ns[num_w];
           unsigned int ldc = ldcs[num_w];
@@ -295,7 +289,7 @@ void __ggml_q4_0_4x8_q8_0_GEMM(const unsigned int M,
               1, M_step_end - M_step_start);
           }
         }
-      }
+      });
     }
   }
 }
@@ -313,8 +307,7 @@ void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
     std::vector<char> QA = std::vector<char>(qa_size);
     nntr_quantize_row_q8_0(A, QA.data(), K);
 
-#pragma omp parallel for num_threads(n_threads)
-    for (int thread_idx = 0; thread_idx < n_threads; ++thread_idx) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int thread_idx) {
       unsigned int M_step_start = (thread_idx * N) / n_threads;     // = 0
       unsigned int M_step_end = ((thread_idx + 1) * N) / n_threads; // ne01 = N
 
@@ -326,9 +319,9 @@ void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
       nntr_gemv_q4_0_8x8_q8_0(K, (float *)((C) + M_step_start), N,
                               (void *)((char *)B + M_step_start * B_step),
                               QA.data(), M, M_step_end - M_step_start);
-    }
+    });
   } else { // GEMM
-    int n_threads = std::thread::hardware_concurrency() / 2;
+    int n_threads = ThreadRuntime::Global().getNumThreads();
     unsigned int blocks_per_4_rows = (K + QK8_0 - 1) / QK8_0;
     unsigned int qa_4_rows_size = sizeof(block_q8_0x4) * blocks_per_4_rows;
     const size_t qa_row_size = (sizeof(block_q8_0) * K) / QK8_0;
@@ -351,8 +344,7 @@ void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
     }
 
 // Compute 4-divisible-M row portion with multithreaded GEMM
-#pragma omp parallel for num_threads(n_threads)
-    for (int i = 0; i < n_threads; i++) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int i) {
       unsigned int src0_start = (i * N) / n_threads;
       unsigned int src0_end = ((i + 1) * N) / n_threads;
 
@@ -363,13 +355,12 @@ void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
       nntr_gemm_q4_0_8x8_q8_0(K, (float *)(C + src0_start), ldc,
                               (void *)((char *)B + src0_start * B_step),
                               QA.data(), M4 * 4, src0_end - src0_start);
-    }
+    });
 
     // Compute leftover 1 ~ 3 rows with multithreaded GEMV
     n_threads = 4;
     for (unsigned int pb = M4 * 4; pb < M; pb++) {
-#pragma omp parallel for num_threads(n_threads)
-      for (int thread_idx = 0; thread_idx < n_threads; ++thread_idx) {
+      ThreadRuntime::Global().parallel_for(0, n_threads, [&](int thread_idx) {
         unsigned int M_step_start = (thread_idx * N) / n_threads;
         unsigned int M_step_end = ((thread_idx + 1) * N) / n_threads;
 
@@ -384,7 +375,7 @@ void __ggml_q4_0_8x8_q8_0_GEMM(const unsigned int M, const unsigned int N,
           N, (void *)((char *)B + M_step_start * B_step),
           QA.data() + (M4 * qa_4_rows_size) + (pb - M4 * 4) * qa_row_size, 1,
           M_step_end - M_step_start);
-      }
+      });
     }
   }
 }
@@ -416,8 +407,7 @@ void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M, const unsigned int N,
 
     nntr_quantize_row_q8_K(A, QA.data(), K);
 
-#pragma omp parallel for num_threads(n_threads)
-    for (int thread_idx = 0; thread_idx < n_threads; ++thread_idx) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int thread_idx) {
       unsigned int M_step_start = (thread_idx * N) / n_threads;     // = 0
       unsigned int M_step_end = ((thread_idx + 1) * N) / n_threads; // ne01 = N
 
@@ -429,9 +419,9 @@ void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M, const unsigned int N,
       nntr_gemv_q4_K_8x8_q8_K(K, (float *)((C) + M_step_start), N,
                               (void *)((char *)B + M_step_start * B_step),
                               QA.data(), M, M_step_end - M_step_start);
-    }
+    });
   } else {
-    int n_threads = std::thread::hardware_concurrency() / 2;
+    int n_threads = ThreadRuntime::Global().getNumThreads();
     unsigned int blocks_per_4_rows = (K + QK_K - 1) / QK_K;
     unsigned int qa_4_rows_size = sizeof(block_q8_Kx4) * blocks_per_4_rows;
     const size_t qa_row_size = (sizeof(block_q8_K) * K) / QK_K;
@@ -454,8 +444,7 @@ void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M, const unsigned int N,
     }
 
 // Compute 4-divisible-M row portion with multithreaded GEMM
-#pragma omp parallel for num_threads(n_threads)
-    for (int i = 0; i < n_threads; i++) {
+    ThreadRuntime::Global().parallel_for(0, n_threads, [&](int i) {
       unsigned int src0_start = (i * N) / n_threads;
       unsigned int src0_end = ((i + 1) * N) / n_threads;
 
@@ -466,13 +455,12 @@ void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M, const unsigned int N,
       nntr_gemm_q4_K_8x8_q8_K(K, (float *)(C + src0_start), ldc,
                               (void *)((char *)B + src0_start * B_step),
                               QA.data(), M4 * 4, src0_end - src0_start);
-    }
+    });
 
     // Compute leftover 1 ~ 3 rows with multithreaded GEMV
     n_threads = 4;
     for (unsigned int pb = M4 * 4; pb < M; pb++) {
-#pragma omp parallel for num_threads(n_threads)
-      for (int thread_idx = 0; thread_idx < n_threads; ++thread_idx) {
+      ThreadRuntime::Global().parallel_for(0, n_threads, [&](int thread_idx) {
         unsigned int M_step_start = (thread_idx * N) / n_threads;
         unsigned int M_step_end = ((thread_idx + 1) * N) / n_threads;
 
@@ -487,7 +475,7 @@ void __ggml_q4_K_8x8_q8_K_GEMM(const unsigned int M, const unsigned int N,
           N, (void *)((char *)B + M_step_start * B_step),
           QA.data() + (M4 * qa_4_rows_size) + (pb - M4 * 4) * qa_row_size, 1,
           M_step_end - M_step_start);
-      }
+      });
     }
   }
 }
@@ -509,8 +497,6 @@ void __ggml_gemm_q6_K(const unsigned int M, const unsigned int N,
                       const unsigned int lda, const void *B,
                       const unsigned int ldb, float *C,
                       const unsigned int ldc) {
-  int32_t thread_count = std::thread::hardware_concurrency() / 2;
-
   static constexpr const int32_t bs = 1;  // unused in ggml_vec_dot_q6_K_q8_K
   static constexpr const int32_t bx = 1;  // unused in ggml_vec_dot_q6_K_q8_K
   static constexpr const int32_t by = 1;  // unused in ggml_vec_dot_q6_K_q8_K
@@ -522,36 +508,33 @@ void __ggml_gemm_q6_K(const unsigned int M, const unsigned int N,
 
   // GEMV
   if (M == 1) {
-    thread_count = 4;
+    static constexpr const unsigned int thread_count = 4;
     std::vector<char> quantized_A(A_row_size);
     nntr_quantize_row_q8_K(A, quantized_A.data(), K);
 
     const void *const quantized_A_data = quantized_A.data();
 
-#pragma omp parallel for num_threads(thread_count)
-    for (int32_t thread_job = 0; thread_job < static_cast<int>(N);
-         thread_job++) {
-      const int32_t B_row_data_offset = B_row_size * thread_job;
+    ThreadRuntime::Global().parallel_for(
+      0, N,
+      [&](int32_t thread_job) {
+        const int32_t B_row_data_offset = B_row_size * thread_job;
 
-      const void *const B_data = (void *)((char *)B + B_row_data_offset);
+        const void *const B_data = (void *)((char *)B + B_row_data_offset);
 
-      nntr_vec_dot_q6_K_q8_K(K, &C[thread_job], bs, B_data, bx,
-                             quantized_A_data, by, nrc);
-    }
+        nntr_vec_dot_q6_K_q8_K(K, &C[thread_job], bs, B_data, bx,
+                               quantized_A_data, by, nrc);
+      },
+      0, thread_count);
   } else { // GEMM
     const int32_t A_total_size = A_row_size * M;
     std::vector<char> quantized_A(A_total_size);
 
-#pragma omp parallel for num_threads(thread_count)
-    for (int32_t thread_job = 0; thread_job < static_cast<int>(M);
-         thread_job++) {
+    ThreadRuntime::Global().parallel_for(0, M, [&](int32_t thread_job) {
       const int32_t A_row_data_offset = A_row_size * thread_job;
       void *A_data = (void *)((char *)quantized_A.data() + A_row_data_offset);
       nntr_quantize_row_q8_K(A + thread_job * K, A_data, K);
-    }
-#pragma omp parallel for num_threads(thread_count)
-    for (int32_t thread_job = 0; thread_job < static_cast<int>(M);
-         thread_job++) {
+    });
+    ThreadRuntime::Global().parallel_for(0, M, [&](int32_t thread_job) {
       const int32_t A_row_data_offset = A_row_size * thread_job;
       void *A_data = (void *)((char *)quantized_A.data() + A_row_data_offset);
 
@@ -562,7 +545,7 @@ void __ggml_gemm_q6_K(const unsigned int M, const unsigned int N,
         nntr_vec_dot_q6_K_q8_K(K, &C[thread_job * ldc + j], bs, B_data, bx,
                                A_data, by, nrc);
       }
-    }
+    });
   }
 }
 
@@ -32,8 +32,7 @@
 #include <version>
 #endif
 #include <fallback_internal.h>
-#include <util_func.h>
-#include <vector>
+#include <parallel_range.h>
 
 #if !defined(__has_constexpr_builtin)
 #define __has_constexpr_builtin(x) (0)
@@ -320,6 +319,53 @@ avx2_approx_swiglu_alpha(__m256 x, __m256 s, __m256 alpha) noexcept -> __m256 {
   auto swiglu_nonscaled = _mm256_div_ps(x, inv_sigmoid);
   return _mm256_mul_ps(swiglu_nonscaled, s);
 }
+
+/**
+ * @brief run fn(i) for every i in [0, end) on the thread runtime. fn is
+ * passed through a function pointer so that std::function is not instantiated
+ * in this object.
+ */
+template <typename F> void run_parallel(unsigned int end, F fn) {
+  nntrainer::parallel_range(
+    0, end, [](unsigned int i, void *ctx) { (*static_cast<F *>(ctx))(i); },
+    &fn);
+}
+
+/**
+ * @brief zero initialized heap buffer of floats, used instead of std::vector
+ * whose out of line members would be shared with the baseline objects
+ */
+class FloatBuffer {
+public:
+  /**
+   * @brief allocate n floats set to zero
+   */
+  explicit FloatBuffer(size_t n) : buf(new float[n]) {
+    for (size_t i = 0; i < n; ++i)
+      buf[i] = 0.0f;
+  }
+
+  /**
+   * @brief release the buffer
+   */
+  ~FloatBuffer() { delete[] buf; }
+
+  FloatBuffer(const FloatBuffer &) = delete;
+  FloatBuffer &operator=(const FloatBuffer &) = delete;
+
+  /**
+   * @brief pointer to the first float
+   */
+  float *data() { return buf; }
+
+  /**
+   * @brief i-th float
+   */
+  float &operator[](size_t i) { return buf[i]; }
+
+private:
+  float *buf; /**< owned buffer */
+};
 } // namespace
 
 namespace nntrainer::avx2 {
@@ -438,9 +484,11 @@ void unpack_q4_0x8_transpose16(const void *src, unsigned short *__restrict dT,
   // --------
   const int groups_pairs = groups_N8 / 2;
 
-#pragma omp parallel for collapse(2) schedule(static)
-  for (int c0 = 0; c0 < cols_scales; c0 += CT) {
-    for (int bp = 0; bp < groups_pairs; ++bp) {
+  const int col_tiles = (cols_scales + CT - 1) / CT;
+  run_parallel(
+    col_tiles * groups_pairs, [&](unsigned int t) {
+      const int c0 = (t / groups_pairs) * CT;
+      const int bp = t % groups_pairs;
       const int b0 = 2 * bp;
       const int b1 = b0 + 1;
       const int r0 = b0 * 8; // 16 rows: r0..r0+15
@@ -492,8 +540,7 @@ void unpack_q4_0x8_transpose16(const void *src, unsigned short *__restrict dT,
         store256_u16(base + 6 * S, _mm256_set_m128i(Cb6, Ca6));
         store256_u16(base + 7 * S, _mm256_set_m128i(Cb7, Ca7));
       }
-    }
-  }
+    });
 
   // -------- tail: if odd number of 8-row groups, process the last one (8 rows)
   // --------
@@ -501,8 +548,9 @@ void unpack_q4_0x8_transpose16(const void *src, unsigned short *__restrict dT,
     const int b = groups_N8 - 1;
     const int r0 = b * 8;
 
-#pragma omp parallel for schedule(static)
-    for (int c0 = 0; c0 < cols_scales; c0 += CT) {
+    const int col_tiles = (cols_scales + CT - 1) / CT;
+    run_parallel(col_tiles, [&](unsigned int t) {
+      const int c0 = t * CT;
       const int c1 = std::min(c0 + CT, cols_scales);
       for (int c = c0; c < c1; ++c) {
         const block_q4_0x8 &A = x[b * cols_scales + c];
@@ -535,7 +583,7 @@ void unpack_q4_0x8_transpose16(const void *src, unsigned short *__restrict dT,
         _mm_storeu_si128((__m128i *)(base + 6 * S), C6);
         _mm_storeu_si128((__m128i *)(base + 7 * S), C7);
       }
-    }
+    });
   }
 
 #if defined(USE_NONTEMPORAL_STORES)
@@ -595,92 +643,91 @@ static inline void convert_q4_0x8_noshuffle(const void *src,
   const block_q4_0x8 *x = (const block_q4_0x8 *)src;
   const __m256i bias256 = _mm256_set1_epi8((char)0x88);
 
-#pragma omp parallel for collapse(2) schedule(static)
-  for (int b = 0; b < GROUPS; ++b) {
-    for (int offset = 0; offset < 8; ++offset) {
-
-      // ---- D slice ----
-      {
-        uint16_t *d_ptr = d_out + (size_t)b * D_ELEMS_PER_GROUP +
-                          (size_t)offset * BLOCKS_PER_GROUP;
-        const block_q4_0x8 *xb = x + (size_t)b * BLOCKS_PER_GROUP;
-        for (int i = 0; i < BLOCKS_PER_GROUP; ++i) {
-          d_ptr[i] = xb[i].d[offset];
-        }
+  run_parallel(GROUPS * 8, [&](unsigned int t) {
+    const int b = t / 8;
+    const int offset = t % 8;
+
+    // ---- D slice ----
+    {
+      uint16_t *d_ptr = d_out + (size_t)b * D_ELEMS_PER_GROUP +
+                        (size_t)offset * BLOCKS_PER_GROUP;
+      const block_q4_0x8 *xb = x + (size_t)b * BLOCKS_PER_GROUP;
+      for (int i = 0; i < BLOCKS_PER_GROUP; ++i) {
+        d_ptr[i] = xb[i].d[offset];
       }
+    }
 
-      // ---- QS slice (unroll 8 blocks / 128B per iter) ----
-      {
-        uint8_t *qs_ptr = qs_out + (size_t)b * QS_BYTES_PER_GROUP +
-                          (size_t)offset * QS_BYTES_PER_OFFSET;
-        const int base_q = (b * UNIT * 2) + offset;
-        const int d0 = (base_q & 15), d1 = d0 ^ 8;
-
-        auto do_half = [&](int blk_base) {
-          // Each iter handles 8 consecutive blocks: j..j+7
-          for (int j = 0; j < PAIRS_PER_OFFSET; j += 8) {
-            const uint8_t *q0 = x[blk_base + j + 0].qs;
-            const uint8_t *q1 = x[blk_base + j + 1].qs;
-            const uint8_t *q2 = x[blk_base + j + 2].qs;
-            const uint8_t *q3 = x[blk_base + j + 3].qs;
-            const uint8_t *q4 = x[blk_base + j + 4].qs;
-            const uint8_t *q5 = x[blk_base + j + 5].qs;
-            const uint8_t *q6 = x[blk_base + j + 6].qs;
-            const uint8_t *q7 = x[blk_base + j + 7].qs;
+    // ---- QS slice (unroll 8 blocks / 128B per iter) ----
+    {
+      uint8_t *qs_ptr = qs_out + (size_t)b * QS_BYTES_PER_GROUP +
+                        (size_t)offset * QS_BYTES_PER_OFFSET;
+      const int base_q = (b * UNIT * 2) + offset;
+      const int d0 = (base_q & 15), d1 = d0 ^ 8;
+
+      auto do_half = [&](int blk_base) {
+        // Each iter handles 8 consecutive blocks: j..j+7
+        for (int j = 0; j < PAIRS_PER_OFFSET; j += 8) {
+          const uint8_t *q0 = x[blk_base + j + 0].qs;
+          const uint8_t *q1 = x[blk_base + j + 1].qs;
+          const uint8_t *q2 = x[blk_base + j + 2].qs;
+          const uint8_t *q3 = x[blk_base + j + 3].qs;
+          const uint8_t *q4 = x[blk_base + j + 4].qs;
+          const uint8_t *q5 = x[blk_base + j + 5].qs;
+          const uint8_t *q6 = x[blk_base + j + 6].qs;
+          const uint8_t *q7 = x[blk_base + j + 7].qs;
 
 #if Q4X8_PREFETCH_DIST > 0
-            _mm_prefetch(
-              (const char *)(x[blk_base + j + Q4X8_PREFETCH_DIST].qs),
-              _MM_HINT_NTA);
+          _mm_prefetch(
+            (const char *)(x[blk_base + j + Q4X8_PREFETCH_DIST].qs),
+            _MM_HINT_NTA);
 #endif
-            // Build 8 packets in XMM regs
-            __m128i pkt0 = make_pkt128(q0, d0, d1);
-            __m128i pkt1 = make_pkt128(q1, d0, d1);
-            __m128i pkt2 = make_pkt128(q2, d0, d1);
-            __m128i pkt3 = make_pkt128(q3, d0, d1);
-            __m128i pkt4 = make_pkt128(q4, d0, d1);
-            __m128i pkt5 = make_pkt128(q5, d0, d1);
-            __m128i pkt6 = make_pkt128(q6, d0, d1);
-            __m128i pkt7 = make_pkt128(q7, d0, d1);
-
-            // Four 32B batches: [0|1], [2|3], [4|5], [6|7]
-            __m256i v01 = _mm256_set_m128i(pkt1, pkt0);
-            __m256i v23 = _mm256_set_m128i(pkt3, pkt2);
-            __m256i v45 = _mm256_set_m128i(pkt5, pkt4);
-            __m256i v67 = _mm256_set_m128i(pkt7, pkt6);
-
-            v01 = _mm256_xor_si256(v01, bias256);
-            v23 = _mm256_xor_si256(v23, bias256);
-            v45 = _mm256_xor_si256(v45, bias256);
-            v67 = _mm256_xor_si256(v67, bias256);
-
-            __m256i o01 = butterfly32(v01);
-            __m256i o23 = butterfly32(v23);
-            __m256i o45 = butterfly32(v45);
-            __m256i o67 = butterfly32(v67);
+          // Build 8 packets in XMM regs
+          __m128i pkt0 = make_pkt128(q0, d0, d1);
+          __m128i pkt1 = make_pkt128(q1, d0, d1);
+          __m128i pkt2 = make_pkt128(q2, d0, d1);
+          __m128i pkt3 = make_pkt128(q3, d0, d1);
+          __m128i pkt4 = make_pkt128(q4, d0, d1);
+          __m128i pkt5 = make_pkt128(q5, d0, d1);
+          __m128i pkt6 = make_pkt128(q6, d0, d1);
+          __m128i pkt7 = make_pkt128(q7, d0, d1);
+
+          // Four 32B batches: [0|1], [2|3], [4|5], [6|7]
+          __m256i v01 = _mm256_set_m128i(pkt1, pkt0);
+          __m256i v23 = _mm256_set_m128i(pkt3, pkt2);
+          __m256i v45 = _mm256_set_m128i(pkt5, pkt4);
+          __m256i v67 = _mm256_set_m128i(pkt7, pkt6);
+
+          v01 = _mm256_xor_si256(v01, bias256);
+          v23 = _mm256_xor_si256(v23, bias256);
+          v45 = _mm256_xor_si256(v45, bias256);
+          v67 = _mm256_xor_si256(v67, bias256);
+
+          __m256i o01 = butterfly32(v01);
+          __m256i o23 = butterfly32(v23);
+          __m256i o45 = butterfly32(v45);
+          __m256i o67 = butterfly32(v67);
 
 #if Q4X8_USE_STREAMING_STORES
-            _mm256_stream_si256((__m256i *)(qs_ptr + 0), o01);
-            _mm256_stream_si256((__m256i *)(qs_ptr + 32), o23);
-            _mm256_stream_si256((__m256i *)(qs_ptr + 64), o45);
-            _mm256_stream_si256((__m256i *)(qs_ptr + 96), o67);
+          _mm256_stream_si256((__m256i *)(qs_ptr + 0), o01);
+          _mm256_stream_si256((__m256i *)(qs_ptr + 32), o23);
+          _mm256_stream_si256((__m256i *)(qs_ptr + 64), o45);
+          _mm256_stream_si256((__m256i *)(qs_ptr + 96), o67);
 #else
-            _mm256_storeu_si256((__m256i *)(qs_ptr + 0), o01);
-            _mm256_storeu_si256((__m256i *)(qs_ptr + 32), o23);
-            _mm256_storeu_si256((__m256i *)(qs_ptr + 64), o45);
-            _mm256_storeu_si256((__m256i *)(qs_ptr + 96), o67);
+          _mm256_storeu_si256((__m256i *)(qs_ptr + 0), o01);
+          _mm256_storeu_si256((__m256i *)(qs_ptr + 32), o23);
+          _mm256_storeu_si256((__m256i *)(qs_ptr + 64), o45);
+          _mm256_storeu_si256((__m256i *)(qs_ptr + 96), o67);
 #endif
-            qs_ptr += 128;
-          }
-        };
+          qs_ptr += 128;
+        }
+      };
 
-        // first half
-        do_half(base_q >> 4);
-        // second half (same d0/d1 pattern)
-        do_half((base_q + UNIT) >> 4);
-      }
+      // first half
+      do_half(base_q >> 4);
+      // second half (same d0/d1 pattern)
+      do_half((base_q + UNIT) >> 4);
     }
-  }
+  });
 
 #if Q4X8_USE_STREAMING_STORES
   _mm_sfence();
@@ -810,7 +857,7 @@ bool is_valid(const unsigned int N, const float *input) {
   }
 
   while (idx < N) {
-    if (!isFloatValid(*input)) {
+    if (!std::isfinite(*input)) {
       return false;
     }
     ++input;
@@ -1498,8 +1545,8 @@ static inline void load_fp16_8_to_chunk(const uint16_t *src, float *dst,
 void compute_fp16vcache_fp32_transposed(int row_num, const float *in,
                                         const uint16_t *vcache, float *output,
                                         int num_cache_head, int gqa_size,
-                                        int head_dim,
-                                        size_t local_window_size) {
+                                        int head_dim, size_t local_window_size,
+                                        int head_start, int head_end) {
   // cpu_set_t cpu_set;
   // CPU_ZERO(&cpu_set);
   // std::vector<bool> affinity(8, false);
@@ -1512,11 +1559,13 @@ void compute_fp16vcache_fp32_transposed(int row_num, const float *in,
   // }
   // pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
 
-  std::vector<float> tmp_fp32(head_dim);
+  FloatBuffer tmp_fp32(head_dim);
   int num_blocks = head_dim / 8;
   __m256 *sumVec = new __m256[std::max(1, num_blocks * gqa_size)];
+  if (head_end < 0)
+    head_end = num_cache_head;
 
-  for (int n = 0; n < num_cache_head; ++n) {
+  for (int n = head_start; n < head_end; ++n) {
     int rem = head_dim % 8;
 
     /* Declaration: std::vector<__m256> sumVec(num_blocks * gqa_size,
@@ -1527,7 +1576,7 @@ void compute_fp16vcache_fp32_transposed(int row_num, const float *in,
     for (int i = 0; i < num_blocks * gqa_size; i++) {
       sumVec[i] = _mm256_setzero_ps();
     }
-    std::vector<float> sumRem((size_t)gqa_size * rem, 0.0f);
+    FloatBuffer sumRem((size_t)gqa_size * rem);
 
     for (int j = row_num < local_window_size ? 0
                                              : row_num + 1 - local_window_size;
@@ -1580,15 +1629,18 @@ void compute_fp16vcache_fp32_transposed(int row_num, const float *in,
 template <>
 void compute_kcaches(const float *in, const uint16_t *kcache, float *output,
                      int num_rows, int num_cache_head, int head_dim,
-                     int gqa_size, int tile_size, size_t local_window_size) {
-  std::vector<float> tmp_fp32(head_dim);
+                     int gqa_size, int tile_size, size_t local_window_size,
+                     int head_start, int head_end) {
+  FloatBuffer tmp_fp32(head_dim);
 
   int start_row =
     num_rows < local_window_size ? 0 : num_rows - local_window_size;
   int row_cnt = num_rows < local_window_size ? num_rows : local_window_size;
   const int tile_count = (row_cnt + tile_size - 1) / tile_size;
+  if (head_end < 0)
+    head_end = num_cache_head;
 
-  for (int n = 0; n < num_cache_head; ++n) {
+  for (int n = head_start; n < head_end; ++n) {
     for (int t = 0; t < tile_count; ++t) {
       int row_tile_start = t * tile_size;
       int tile_rows = std::min(tile_size, row_cnt - row_tile_start);
@@ -1734,6 +1786,442 @@ static float hsum_avx(__m256 v) {
   return _mm_cvtss_f32(sums);
 }
 
+static float hmax_avx(__m256 v) {
+  __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_movehdup_ps(m));
+  return _mm_cvtss_f32(m);
+}
+
+/**
+ * @brief reduce a (len) vector into one value. Four independent accumulators
+ * hide the latency of the vector op.
+ *
+ * @param op vector reduction step, acc = op(acc, x)
+ * @param merge combines two accumulators
+ * @param hop horizontal reduction of the accumulator
+ * @param sop scalar reduction step for the tail
+ */
+template <typename Op, typename Merge, typename HOp, typename SOp>
+static float reduce_row(const unsigned int len, const float *x, __m256 init,
+                        Op op, Merge merge, HOp hop, SOp sop) {
+  __m256 acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+  unsigned int l = 0;
+  for (; l + 32 <= len; l += 32) {
+    acc0 = op(acc0, _mm256_loadu_ps(x + l));
+    acc1 = op(acc1, _mm256_loadu_ps(x + l + 8));
+    acc2 = op(acc2, _mm256_loadu_ps(x + l + 16));
+    acc3 = op(acc3, _mm256_loadu_ps(x + l + 24));
+  }
+  for (; l + 8 <= len; l += 8)
+    acc0 = op(acc0, _mm256_loadu_ps(x + l));
+  float r = hop(merge(merge(acc0, acc1), merge(acc2, acc3)));
+  for (; l < len; ++l)
+    r = sop(r, x[l]);
+  return r;
+}
+
+/**
+ * @brief reduce a (len, inner) matrix over its rows into inner values. Blocks
+ * of 32 columns are kept in registers while the rows stream through.
+ *
+ * @param op vector reduction step, acc = op(acc, x)
+ * @param sop scalar reduction step for the tail columns
+ * @param store writes 8 reduced columns, store(y, acc)
+ * @param sstore writes one reduced column, sstore(y, acc)
+ */
+template <typename Op, typename SOp, typename Store, typename SStore>
+static void reduce_cols(const unsigned int len, const unsigned int inner,
+                        const float *x, float *y, float init, Op op, SOp sop,
+                        Store store, SStore sstore) {
+  const __m256 vinit = _mm256_set1_ps(init);
+  unsigned int i = 0;
+  for (; i + 32 <= inner; i += 32) {
+    __m256 acc0 = vinit, acc1 = vinit, acc2 = vinit, acc3 = vinit;
+    for (unsigned int l = 0; l < len; ++l) {
+      const float *p = x + (size_t)l * inner + i;
+      acc0 = op(acc0, _mm256_loadu_ps(p));
+      acc1 = op(acc1, _mm256_loadu_ps(p + 8));
+      acc2 = op(acc2, _mm256_loadu_ps(p + 16));
+      acc3 = op(acc3, _mm256_loadu_ps(p + 24));
+    }
+    store(y + i, acc0);
+    store(y + i + 8, acc1);
+    store(y + i + 16, acc2);
+    store(y + i + 24, acc3);
+  }
+  for (; i + 8 <= inner; i += 8) {
+    __m256 acc = vinit;
+    for (unsigned int l = 0; l < len; ++l)
+      acc = op(acc, _mm256_loadu_ps(x + (size_t)l * inner + i));
+    store(y + i, acc);
+  }
+  for (; i < inner; ++i) {
+    float acc = init;
+    for (unsigned int l = 0; l < len; ++l)
+      acc = sop(acc, x[(size_t)l * inner + i]);
+    sstore(y + i, acc);
+  }
+}
+
+void reduce_sum(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y,
+                float alpha, float beta) {
+  auto op = [](__m256 a, __m256 b) { return _mm256_add_ps(a, b); };
+  auto sop = [](float a, float b) { return a + b; };
+  const __m256 valpha = _mm256_set1_ps(alpha);
+  const __m256 vbeta = _mm256_set1_ps(beta);
+  auto store = [&](float *y, __m256 acc) {
+    __m256 r = _mm256_mul_ps(acc, valpha);
+    if (beta != 0.0f)
+      r = _mm256_fmadd_ps(_mm256_loadu_ps(y), vbeta, r);
+    _mm256_storeu_ps(y, r);
+  };
+  auto sstore = [&](float *y, float acc) {
+    *y = alpha * acc + (beta == 0.0f ? 0.0f : beta * *y);
+  };
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *y = Y + (size_t)o * inner;
+    if (inner == 1)
+      sstore(y, reduce_row(len, x, _mm256_setzero_ps(), op, op, hsum_avx, sop));
+    else
+      reduce_cols(len, inner, x, y, 0.0f, op, sop, store, sstore);
+  }
+}
+
+void reduce_max(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y) {
+  auto op = [](__m256 a, __m256 b) { return _mm256_max_ps(a, b); };
+  auto sop = [](float a, float b) { return std::max(a, b); };
+  auto store = [](float *y, __m256 acc) { _mm256_storeu_ps(y, acc); };
+  auto sstore = [](float *y, float acc) { *y = acc; };
+  constexpr float lowest = -std::numeric_limits<float>::infinity();
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *y = Y + (size_t)o * inner;
+    if (inner == 1)
+      *y = reduce_row(len, x, _mm256_set1_ps(lowest), op, op, hmax_avx, sop);
+    else
+      reduce_cols(len, inner, x, y, lowest, op, sop, store, sstore);
+  }
+}
+
+void reduce_l2norm(const unsigned int outer, const unsigned int len,
+                   const unsigned int inner, const float *X, float *Y) {
+  auto op = [](__m256 a, __m256 b) { return _mm256_fmadd_ps(b, b, a); };
+  auto add = [](__m256 a, __m256 b) { return _mm256_add_ps(a, b); };
+  auto sop = [](float a, float b) { return a + b * b; };
+  auto store = [](float *y, __m256 acc) {
+    _mm256_storeu_ps(y, _mm256_sqrt_ps(acc));
+  };
+  auto sstore = [](float *y, float acc) { *y = std::sqrt(acc); };
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *y = Y + (size_t)o * inner;
+    if (inner == 1)
+      *y = std::sqrt(
+        reduce_row(len, x, _mm256_setzero_ps(), op, add, hsum_avx, sop));
+    else
+      reduce_cols(len, inner, x, y, 0.0f, op, sop, store, sstore);
+  }
+}
+
+/**
+ * @brief merge the Welford state (n_b, mean_b, m2_b) into (n_a, mean_a, m2_a)
+ */
+static inline void welford_merge(float &n_a, float &mean_a, float &m2_a,
+                                 float n_b, float mean_b, float m2_b) {
+  const float n = n_a + n_b;
+  const float delta = mean_b - mean_a;
+  mean_a += delta * n_b / n;
+  m2_a += m2_b + delta * delta * n_a * n_b / n;
+  n_a = n;
+}
+
+/**
+ * @brief Welford over the rows of B * 8 columns of a (len, inner) matrix
+ */
+template <unsigned int B>
+static void welford_cols(const unsigned int len, const unsigned int inner,
+                         const float *x, float *mean, float *var) {
+  __m256 vm[B], vm2[B];
+  for (unsigned int b = 0; b < B; ++b)
+    vm[b] = vm2[b] = _mm256_setzero_ps();
+
+  for (unsigned int l = 0; l < len; ++l) {
+    const __m256 inv_n = _mm256_set1_ps(1.0f / (l + 1));
+    const float *p = x + (size_t)l * inner;
+    for (unsigned int b = 0; b < B; ++b) {
+      const __m256 v = _mm256_loadu_ps(p + b * 8);
+      const __m256 delta = _mm256_sub_ps(v, vm[b]);
+      vm[b] = _mm256_fmadd_ps(delta, inv_n, vm[b]);
+      vm2[b] = _mm256_fmadd_ps(delta, _mm256_sub_ps(v, vm[b]), vm2[b]);
+    }
+  }
+
+  const __m256 inv_len = _mm256_set1_ps(1.0f / len);
+  for (unsigned int b = 0; b < B; ++b) {
+    _mm256_storeu_ps(mean + b * 8, vm[b]);
+    _mm256_storeu_ps(var + b * 8, _mm256_mul_ps(vm2[b], inv_len));
+  }
+}
+
+void reduce_mean_var(const unsigned int outer, const unsigned int len,
+                     const unsigned int inner, const float *X, float *mean,
+                     float *var) {
+  for (unsigned int o = 0; o < outer; ++o) {
+    const float *x = X + (size_t)o * len * inner;
+    float *m = mean + (size_t)o * inner;
+    float *v = var + (size_t)o * inner;
+
+    if (inner == 1) {
+      /// every lane runs Welford over its own strided part of the row, the
+      /// lanes are merged afterwards
+      __m256 vm = _mm256_setzero_ps(), vm2 = _mm256_setzero_ps();
+      unsigned int l = 0;
+      for (; l + 8 <= len; l += 8) {
+        const __m256 inv_n = _mm256_set1_ps(1.0f / (l / 8 + 1));
+        const __m256 xv = _mm256_loadu_ps(x + l);
+        const __m256 delta = _mm256_sub_ps(xv, vm);
+        vm = _mm256_fmadd_ps(delta, inv_n, vm);
+        vm2 = _mm256_fmadd_ps(delta, _mm256_sub_ps(xv, vm), vm2);
+      }
+
+      float n = 0.0f, cm = 0.0f, cm2 = 0.0f;
+      if (l > 0) {
+        alignas(32) float lm[8], lm2[8];
+        _mm256_store_ps(lm, vm);
+        _mm256_store_ps(lm2, vm2);
+        n = l / 8;
+        cm = lm[0];
+        cm2 = lm2[0];
+        for (unsigned int j = 1; j < 8; ++j)
+          welford_merge(n, cm, cm2, l / 8, lm[j], lm2[j]);
+      }
+      for (; l < len; ++l) {
+        n += 1.0f;
+        const float delta = x[l] - cm;
+        cm += delta / n;
+        cm2 += delta * (x[l] - cm);
+      }
+      *m = cm;
+      *v = cm2 / len;
+      continue;
+    }
+
+    unsigned int i = 0;
+    for (; i + 32 <= inner; i += 32)
+      welford_cols<4>(len, inner, x + i, m + i, v + i);
+    for (; i + 8 <= inner; i += 8)
+      welford_cols<1>(len, inner, x + i, m + i, v + i);
+    for (; i < inner; ++i) {
+      float cm = 0.0f, cm2 = 0.0f;
+      for (unsigned int l = 0; l < len; ++l) {
+        const float val = x[(size_t)l * inner + i];
+        const float delta = val - cm;
+        cm += delta / (l + 1);
+        cm2 += delta * (val - cm);
+      }
+      m[i] = cm;
+      v[i] = cm2 / len;
+    }
+  }
+}
+
+void batch_norm_forward(const unsigned int outer, const unsigned int len,
+                        const unsigned int inner, const float *X,
+                        const float *mean, const float *invstd,
+                        const float *gamma, const float *beta, float *Y,
+                        float *X_hat) {
+  if (inner == 1) {
+    /// channels are contiguous, the statistics are loaded as vectors
+    for (unsigned int o = 0; o < outer; ++o) {
+      const float *x = X + (size_t)o * len;
+      float *y = Y + (size_t)o * len;
+      float *x_hat = X_hat ? X_hat + (size_t)o * len : nullptr;
+      unsigned int l = 0;
+      for (; l + 8 <= len; l += 8) {
+        const __m256 vm = _mm256_loadu_ps(mean + l);
+        const __m256 vis = _mm256_loadu_ps(invstd + l);
+        const __m256 vg = _mm256_loadu_ps(gamma + l);
+        const __m256 vb = _mm256_loadu_ps(beta + l);
+        const __m256 xv = _mm256_loadu_ps(x + l);
+        if (x_hat) {
+          const __m256 xh = _mm256_mul_ps(_mm256_sub_ps(xv, vm), vis);
+          _mm256_storeu_ps(x_hat + l, xh);
+          _mm256_storeu_ps(y + l, _mm256_fmadd_ps(xh, vg, vb));
+        } else {
+          const __m256 vs = _mm256_mul_ps(vg, vis);
+          const __m256 vt = _mm256_fnmadd_ps(vm, vs, vb);
+          _mm256_storeu_ps(y + l, _mm256_fmadd_ps(xv, vs, vt));
+        }
+      }
+      for (; l < len; ++l) {
+        if (x_hat) {
+          x_hat[l] = (x[l] - mean[l]) * invstd[l];
+          y[l] = x_hat[l] * gamma[l] + beta[l];
+        } else {
+          const float scale = gamma[l] * invstd[l];
+          y[l] = x[l] * scale + (beta[l] - mean[l] * scale);
+        }
+      }
+    }
+    return;
+  }
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int l = 0; l < len; ++l) {
+      const size_t off = ((size_t)o * len + l) * inner;
+      const float *x = X + off;
+      float *y = Y + off;
+      unsigned int i = 0;
+      if (X_hat) {
+        float *x_hat = X_hat + off;
+        const __m256 vm = _mm256_set1_ps(mean[l]);
+        const __m256 vis = _mm256_set1_ps(invstd[l]);
+        const __m256 vg = _mm256_set1_ps(gamma[l]);
+        const __m256 vb = _mm256_set1_ps(beta[l]);
+        for (; i + 8 <= inner; i += 8) {
+          const __m256 xh =
+            _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), vm), vis);
+          _mm256_storeu_ps(x_hat + i, xh);
+          _mm256_storeu_ps(y + i, _mm256_fmadd_ps(xh, vg, vb));
+        }
+        for (; i < inner; ++i) {
+          x_hat[i] = (x[i] - mean[l]) * invstd[l];
+          y[i] = x_hat[i] * gamma[l] + beta[l];
+        }
+      } else {
+        const float scale = gamma[l] * invstd[l];
+        const float shift = beta[l] - mean[l] * scale;
+        const __m256 vs = _mm256_set1_ps(scale);
+        const __m256 vt = _mm256_set1_ps(shift);
+        for (; i + 8 <= inner; i += 8)
+          _mm256_storeu_ps(y + i,
+                           _mm256_fmadd_ps(_mm256_loadu_ps(x + i), vs, vt));
+        for (; i < inner; ++i)
+          y[i] = x[i] * scale + shift;
+      }
+    }
+  }
+}
+
+void batch_norm_backward_reduce(const unsigned int outer,
+                                const unsigned int len,
+                                const unsigned int inner, const float *dY,
+                                const float *X_hat, float *sum_dy,
+                                float *sum_dy_xhat) {
+  std::fill(sum_dy, sum_dy + len, 0.0f);
+  std::fill(sum_dy_xhat, sum_dy_xhat + len, 0.0f);
+
+  if (inner == 1) {
+    for (unsigned int o = 0; o < outer; ++o) {
+      const float *dy = dY + (size_t)o * len;
+      const float *x_hat = X_hat + (size_t)o * len;
+      unsigned int l = 0;
+      for (; l + 8 <= len; l += 8) {
+        const __m256 d = _mm256_loadu_ps(dy + l);
+        _mm256_storeu_ps(sum_dy + l,
+                         _mm256_add_ps(_mm256_loadu_ps(sum_dy + l), d));
+        _mm256_storeu_ps(sum_dy_xhat + l,
+                         _mm256_fmadd_ps(d, _mm256_loadu_ps(x_hat + l),
+                                         _mm256_loadu_ps(sum_dy_xhat + l)));
+      }
+      for (; l < len; ++l) {
+        sum_dy[l] += dy[l];
+        sum_dy_xhat[l] += dy[l] * x_hat[l];
+      }
+    }
+    return;
+  }
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int l = 0; l < len; ++l) {
+      const size_t off = ((size_t)o * len + l) * inner;
+      const float *dy = dY + off;
+      const float *x_hat = X_hat + off;
+      __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+      __m256 sx0 = _mm256_setzero_ps(), sx1 = _mm256_setzero_ps();
+      unsigned int i = 0;
+      for (; i + 16 <= inner; i += 16) {
+        const __m256 d0 = _mm256_loadu_ps(dy + i);
+        const __m256 d1 = _mm256_loadu_ps(dy + i + 8);
+        s0 = _mm256_add_ps(s0, d0);
+        s1 = _mm256_add_ps(s1, d1);
+        sx0 = _mm256_fmadd_ps(d0, _mm256_loadu_ps(x_hat + i), sx0);
+        sx1 = _mm256_fmadd_ps(d1, _mm256_loadu_ps(x_hat + i + 8), sx1);
+      }
+      for (; i + 8 <= inner; i += 8) {
+        const __m256 d0 = _mm256_loadu_ps(dy + i);
+        s0 = _mm256_add_ps(s0, d0);
+        sx0 = _mm256_fmadd_ps(d0, _mm256_loadu_ps(x_hat + i), sx0);
+      }
+      float s = hsum_avx(_mm256_add_ps(s0, s1));
+      float sx = hsum_avx(_mm256_add_ps(sx0, sx1));
+      for (; i < inner; ++i) {
+        s += dy[i];
+        sx += dy[i] * x_hat[i];
+      }
+      sum_dy[l] += s;
+      sum_dy_xhat[l] += sx;
+    }
+  }
+}
+
+void batch_norm_backward(const unsigned int outer, const unsigned int len,
+                         const unsigned int inner, const float *dY,
+                         const float *X_hat, const float *invstd,
+                         const float *gamma, const float *mean_dy,
+                         const float *mean_dy_xhat, float *dX) {
+  /// dX = scale * dY - (scale * mean_dy_xhat) * X_hat - scale * mean_dy
+  if (inner == 1) {
+    for (unsigned int o = 0; o < outer; ++o) {
+      const float *dy = dY + (size_t)o * len;
+      const float *x_hat = X_hat + (size_t)o * len;
+      float *dx = dX + (size_t)o * len;
+      unsigned int l = 0;
+      for (; l + 8 <= len; l += 8) {
+        const __m256 vs = _mm256_mul_ps(_mm256_loadu_ps(gamma + l),
+                                        _mm256_loadu_ps(invstd + l));
+        const __m256 vu = _mm256_mul_ps(vs, _mm256_loadu_ps(mean_dy_xhat + l));
+        const __m256 vv = _mm256_mul_ps(vs, _mm256_loadu_ps(mean_dy + l));
+        const __m256 t = _mm256_fmsub_ps(vs, _mm256_loadu_ps(dy + l), vv);
+        _mm256_storeu_ps(dx + l,
+                         _mm256_fnmadd_ps(_mm256_loadu_ps(x_hat + l), vu, t));
+      }
+      for (; l < len; ++l)
+        dx[l] = gamma[l] * invstd[l] *
+                (dy[l] - mean_dy[l] - x_hat[l] * mean_dy_xhat[l]);
+    }
+    return;
+  }
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int l = 0; l < len; ++l) {
+      const size_t off = ((size_t)o * len + l) * inner;
+      const float *dy = dY + off;
+      const float *x_hat = X_hat + off;
+      float *dx = dX + off;
+      const float scale = gamma[l] * invstd[l];
+      const __m256 vs = _mm256_set1_ps(scale);
+      const __m256 vu = _mm256_set1_ps(scale * mean_dy_xhat[l]);
+      const __m256 vv = _mm256_set1_ps(scale * mean_dy[l]);
+      unsigned int i = 0;
+      for (; i + 8 <= inner; i += 8) {
+        const __m256 t = _mm256_fmsub_ps(vs, _mm256_loadu_ps(dy + i), vv);
+        _mm256_storeu_ps(dx + i,
+                         _mm256_fnmadd_ps(_mm256_loadu_ps(x_hat + i), vu, t));
+      }
+      for (; i < inner; ++i)
+        dx[i] = scale * (dy[i] - mean_dy[l] - x_hat[i] * mean_dy_xhat[l]);
+    }
+  }
+}
+
 void rms_norm_wrt_width_fp32_intrinsic(const float *__restrict X,
                                        float *__restrict Y, size_t H, size_t W,
                                        float epsilon) {
@@ -1892,4 +2380,260 @@ void copy_f32_f16(unsigned int N, const float *input, uint16_t *output) {
   }
 }
 
+static inline int32_t hsum_epi32_avx(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+}
+
+/**
+ * @brief multiply signed int8 pairs and add adjacent results into int32 lanes.
+ * maddubs takes u8 x s8, so the sign of a is moved onto b. Inputs are limited
+ * to [-127, 127], which keeps the int16 pair sums below saturation.
+ */
+static inline __m256i mul_sum_i8_pairs(const __m256i a, const __m256i b) {
+  const __m256i ax = _mm256_sign_epi8(a, a);
+  const __m256i sy = _mm256_sign_epi8(b, a);
+  const __m256i dot = _mm256_maddubs_epi16(ax, sy);
+  return _mm256_madd_epi16(dot, _mm256_set1_epi16(1));
+}
+
+void quantize_row_qai8(const unsigned int K, const float *x, int8_t *q,
+                       float *scale) {
+  const __m256 sign_bit = _mm256_set1_ps(-0.0f);
+  __m256 vmax = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 8 <= K; i += 8)
+    vmax =
+      _mm256_max_ps(vmax, _mm256_andnot_ps(sign_bit, _mm256_loadu_ps(x + i)));
+
+  __m128 m4 = _mm_max_ps(_mm256_castps256_ps128(vmax),
+                         _mm256_extractf128_ps(vmax, 1));
+  m4 = _mm_max_ps(m4, _mm_movehl_ps(m4, m4));
+  m4 = _mm_max_ss(m4, _mm_movehdup_ps(m4));
+  float amax = _mm_cvtss_f32(m4);
+  for (; i < K; ++i)
+    amax = std::max(amax, std::fabs(x[i]));
+
+  const float d = amax / 127.0f;
+  const float id = (amax != 0.0f) ? 127.0f / amax : 0.0f;
+  *scale = d;
+
+  const __m256 vid = _mm256_set1_ps(id);
+  const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  i = 0;
+  for (; i + 32 <= K; i += 32) {
+    __m256i i0 = _mm256_cvtps_epi32(
+      _mm256_round_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i), vid),
+                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    __m256i i1 = _mm256_cvtps_epi32(
+      _mm256_round_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i + 8), vid),
+                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    __m256i i2 = _mm256_cvtps_epi32(
+      _mm256_round_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i + 16), vid),
+                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    __m256i i3 = _mm256_cvtps_epi32(
+      _mm256_round_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i + 24), vid),
+                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+
+    i0 = _mm256_packs_epi32(i0, i1);
+    i2 = _mm256_packs_epi32(i2, i3);
+    i0 = _mm256_packs_epi16(i0, i2);
+    // packs work within 128-bit lanes, restore the element order
+    i0 = _mm256_permutevar8x32_epi32(i0, perm);
+    _mm256_storeu_si256((__m256i *)(q + i), i0);
+  }
+  for (; i < K; ++i)
+    q[i] = static_cast<int8_t>(std::nearbyint(x[i] * id));
+}
+
+int32_t dot_qai8_qsi8(const unsigned int K, const int8_t *a, const int8_t *b) {
+  __m256i acc = _mm256_setzero_si256();
+  unsigned int i = 0;
+  for (; i + 32 <= K; i += 32) {
+    const __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+    const __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+    acc = _mm256_add_epi32(acc, mul_sum_i8_pairs(va, vb));
+  }
+  int32_t sum = hsum_epi32_avx(acc);
+  for (; i < K; ++i)
+    sum += static_cast<int32_t>(a[i]) * b[i];
+  return sum;
+}
+
+int32_t dot_qai8_qsi4(const unsigned int K, const int8_t *a, const uint8_t *b) {
+  const __m128i low_mask = _mm_set1_epi8(0x0F);
+  const __m256i offset = _mm256_set1_epi8(8);
+  __m256i acc = _mm256_setzero_si256();
+  for (unsigned int i = 0; i < K; i += 32) {
+    const __m128i packed = _mm_loadu_si128((const __m128i *)(b + i / 2));
+    const __m128i lo = _mm_and_si128(packed, low_mask);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), low_mask);
+    const __m256i vb =
+      _mm256_sub_epi8(_mm256_set_m128i(hi, lo), offset);
+    const __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+    acc = _mm256_add_epi32(acc, mul_sum_i8_pairs(va, vb));
+  }
+  return hsum_epi32_avx(acc);
+}
+
+/**
+ * @brief dequantize a row quantized by quantize_kv_cache
+ */
+static inline void dequantize_kv_row(const unsigned int len,
+                                     const uint8_t *cache,
+                                     const uint16_t *scales, float *out,
+                                     const unsigned int bits) {
+  const __m128i low_mask = _mm_set1_epi8(0x0F);
+  const __m128i offset = _mm_set1_epi8(8);
+  for (unsigned int b = 0; b < len / 32; ++b) {
+    const __m256 vd = _mm256_set1_ps(compute_fp16_to_fp32(scales[b]));
+    __m128i q0, q1;
+    if (bits == 8) {
+      q0 = _mm_loadu_si128((const __m128i *)(cache + b * 32));
+      q1 = _mm_loadu_si128((const __m128i *)(cache + b * 32 + 16));
+    } else {
+      const __m128i packed = _mm_loadu_si128((const __m128i *)(cache + b * 16));
+      q0 = _mm_sub_epi8(_mm_and_si128(packed, low_mask), offset);
+      q1 = _mm_sub_epi8(
+        _mm_and_si128(_mm_srli_epi16(packed, 4), low_mask), offset);
+    }
+
+    const __m128i q[4] = {q0, _mm_srli_si128(q0, 8), q1,
+                          _mm_srli_si128(q1, 8)};
+    for (unsigned int k = 0; k < 4; ++k)
+      _mm256_storeu_ps(
+        out + b * 32 + k * 8,
+        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q[k])), vd));
+  }
+}
+
+void quantize_kv_cache(const unsigned int len, const float *in, uint8_t *cache,
+                       uint16_t *scales, const unsigned int bits) {
+  const __m256 sign_bit = _mm256_set1_ps(-0.0f);
+  const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  const int qmax = bits == 8 ? 127 : 7;
+  const __m256i vmin = _mm256_set1_epi32(bits == 8 ? -127 : -8);
+  const __m256i vmax = _mm256_set1_epi32(qmax);
+
+  for (unsigned int b = 0; b < len / 32; ++b) {
+    const float *x = in + b * 32;
+    __m256 v[4];
+    __m256 amax = _mm256_setzero_ps();
+    for (unsigned int k = 0; k < 4; ++k) {
+      v[k] = _mm256_loadu_ps(x + k * 8);
+      amax = _mm256_max_ps(amax, _mm256_andnot_ps(sign_bit, v[k]));
+    }
+    __m128 m4 = _mm_max_ps(_mm256_castps256_ps128(amax),
+                           _mm256_extractf128_ps(amax, 1));
+    m4 = _mm_max_ps(m4, _mm_movehl_ps(m4, m4));
+    m4 = _mm_max_ss(m4, _mm_movehdup_ps(m4));
+
+    scales[b] = compute_fp32_to_fp16(_mm_cvtss_f32(m4) / qmax);
+    const float d = compute_fp16_to_fp32(scales[b]);
+    const __m256 vid = _mm256_set1_ps(d != 0.0f ? 1.0f / d : 0.0f);
+
+    __m256i i[4];
+    for (unsigned int k = 0; k < 4; ++k) {
+      i[k] = _mm256_cvtps_epi32(
+        _mm256_round_ps(_mm256_mul_ps(v[k], vid),
+                        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+      i[k] = _mm256_min_epi32(_mm256_max_epi32(i[k], vmin), vmax);
+    }
+    __m256i q = _mm256_packs_epi16(_mm256_packs_epi32(i[0], i[1]),
+                                   _mm256_packs_epi32(i[2], i[3]));
+    // packs work within 128-bit lanes, restore the element order
+    q = _mm256_permutevar8x32_epi32(q, perm);
+
+    if (bits == 8) {
+      _mm256_storeu_si256((__m256i *)(cache + b * 32), q);
+    } else {
+      q = _mm256_add_epi8(q, _mm256_set1_epi8(8));
+      const __m128i lo = _mm256_castsi256_si128(q);
+      const __m128i hi = _mm256_extracti128_si256(q, 1);
+      _mm_storeu_si128((__m128i *)(cache + b * 16),
+                       _mm_or_si128(lo, _mm_slli_epi16(hi, 4)));
+    }
+  }
+}
+
+void compute_kcaches_quantized(const float *in, const uint8_t *kcache,
+                               const uint16_t *kscales, float *output,
+                               int num_rows, int num_cache_head, int head_dim,
+                               int gqa_size, unsigned int bits,
+                               size_t local_window_size, int head_start,
+                               int head_end) {
+  const int start_row =
+    (size_t)num_rows < local_window_size ? 0 : num_rows - local_window_size;
+  const float scale = 1.0f / std::sqrt((float)head_dim);
+  const size_t row_bytes = (size_t)head_dim * bits / 8;
+  const size_t row_scales = head_dim / 32;
+  if (head_end < 0)
+    head_end = num_cache_head;
+  FloatBuffer k_row(head_dim);
+
+  for (int n = head_start; n < head_end; ++n) {
+    for (int row = start_row; row < num_rows; ++row) {
+      const size_t idx = (size_t)row * num_cache_head + n;
+      if (row + 1 < num_rows)
+        _mm_prefetch(reinterpret_cast<const char *>(
+                       kcache + (idx + num_cache_head) * row_bytes),
+                     _MM_HINT_T0);
+      dequantize_kv_row(head_dim, kcache + idx * row_bytes,
+                        kscales + idx * row_scales, k_row.data(), bits);
+
+      for (int g = 0; g < gqa_size; ++g) {
+        const float *in_ptr = in + ((size_t)n * gqa_size + g) * head_dim;
+        __m256 acc = _mm256_setzero_ps();
+        for (int i = 0; i < head_dim; i += 8)
+          acc = _mm256_fmadd_ps(_mm256_loadu_ps(in_ptr + i),
+                                _mm256_loadu_ps(k_row.data() + i), acc);
+        output[(size_t)(row - start_row) * num_cache_head * gqa_size +
+               n * gqa_size + g] = hsum_avx(acc) * scale;
+      }
+    }
+  }
+}
+
+void compute_vcache_quantized_transposed(int row_num, const float *in,
+                                         const uint8_t *vcache,
+                                         const uint16_t *vscales, float *output,
+                                         int num_cache_head, int gqa_size,
+                                         int head_dim, unsigned int bits,
+                                         size_t local_window_size,
+                                         int head_start, int head_end) {
+  const int start =
+    (size_t)row_num < local_window_size ? 0 : row_num + 1 - local_window_size;
+  const size_t row_bytes = (size_t)head_dim * bits / 8;
+  const size_t row_scales = head_dim / 32;
+  if (head_end < 0)
+    head_end = num_cache_head;
+  FloatBuffer v_row(head_dim);
+
+  std::fill(output + (size_t)head_start * gqa_size * head_dim,
+            output + (size_t)head_end * gqa_size * head_dim, 0.0f);
+  for (int n = head_start; n < head_end; ++n) {
+    for (int j = start; j <= row_num; ++j) {
+      const size_t idx = (size_t)j * num_cache_head + n;
+      dequantize_kv_row(head_dim, vcache + idx * row_bytes,
+                        vscales + idx * row_scales, v_row.data(), bits);
+
+      for (int h = 0; h < gqa_size; ++h) {
+        const __m256 a_val = _mm256_set1_ps(
+          in[(size_t)(j - start) * gqa_size * num_cache_head + n * gqa_size +
+             h]);
+        float *out = output + ((size_t)n * gqa_size + h) * head_dim;
+        for (int d = 0; d < head_dim; d += 8)
+          _mm256_storeu_ps(out + d,
+                           _mm256_fmadd_ps(a_val,
+                                           _mm256_loadu_ps(v_row.data() + d),
+                                           _mm256_loadu_ps(out + d)));
+      }
+    }
+  }
+}
+
 } // namespace nntrainer::avx2
+
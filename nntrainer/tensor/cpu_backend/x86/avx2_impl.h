@@ -187,12 +187,15 @@ void softmax_row(float *qk_out, size_t start_row, size_t end_row,
  * @param[in] gqa_size size of group
  * @param[in] head_dim head dimension
  * @param[in] local_window_size windows size for local attention
+ * @param[in] head_start first kv head to compute
+ * @param[in] head_end one past the last kv head to compute, -1 for all
  */
 void compute_fp16vcache_fp32_transposed(int row_num, const float *in,
                                         const uint16_t *vcache, float *output,
                                         int num_cache_head, int gqa_size,
                                         int head_dim,
-                                        size_t local_window_size = UINT_MAX);
+                                        size_t local_window_size = UINT_MAX,
+                                        int head_start = 0, int head_end = -1);
 
 /**
  * @brief Compute kcaches
@@ -206,12 +209,15 @@ void compute_fp16vcache_fp32_transposed(int row_num, const float *in,
  * @param[in] gqa_size size of group
  * @param[in] tile_size size of tile
  * @param[in] local_window_size windows size for local attention
+ * @param[in] head_start first kv head to compute
+ * @param[in] head_end one past the last kv head to compute, -1 for all
  */
 template <typename BType>
 void compute_kcaches(const float *in, const BType *kcache, float *output,
                      int num_rows, int num_cache_head, int head_dim,
                      int gqa_size, int tile_size,
-                     size_t local_window_size = UINT_MAX);
+                     size_t local_window_size = UINT_MAX,
+                     int head_start = 0, int head_end = -1);
 
 /**
  * @brief Compute rotary embedding value
@@ -277,6 +283,128 @@ void copy_f16_f32(unsigned int N, const uint16_t *input, float *output);
  */
 void copy_f32_f16(unsigned int N, const float *input, uint16_t *output);
 
+/**
+ * @brief Quantize a float row to int8 with one symmetric scale (amax / 127)
+ *
+ * @param K length of the row
+ * @param x input row
+ * @param q output int8 row, values in [-127, 127]
+ * @param scale output scale, x ~= q * scale
+ */
+void quantize_row_qai8(const unsigned int K, const float *x, int8_t *q,
+                       float *scale);
+
+/**
+ * @brief int8 x int8 dot product accumulated in int32 (maddubs based)
+ *
+ * @param K length of the vectors
+ * @param a int8 activation, values in [-127, 127]
+ * @param b int8 weight, values in [-127, 127]
+ * @return int32_t sum(a * b)
+ */
+int32_t dot_qai8_qsi8(const unsigned int K, const int8_t *a, const int8_t *b);
+
+/**
+ * @brief int8 x int4 dot product accumulated in int32 (maddubs based)
+ *
+ * @param K length of the vectors, multiple of 32
+ * @param a int8 activation, values in [-127, 127]
+ * @param b packed int4 weight. In each 32 element block, byte j holds element
+ * j in the low nibble and element j + 16 in the high nibble, offset by 8.
+ * @return int32_t sum(a * b)
+ */
+int32_t dot_qai8_qsi4(const unsigned int K, const int8_t *a, const uint8_t *b);
+
+/**
+ * @brief quantize rows of a KV cache to int8 or int4 with one fp16 scale per
+ * block of 32 values, see nntrainer::quantize_kv_cache
+ */
+void quantize_kv_cache(const unsigned int len, const float *in, uint8_t *cache,
+                       uint16_t *scales, const unsigned int bits);
+
+/**
+ * @brief Compute kcaches of a quantized key cache, see
+ * nntrainer::compute_kcaches_quantized
+ */
+void compute_kcaches_quantized(const float *in, const uint8_t *kcache,
+                               const uint16_t *kscales, float *output,
+                               int num_rows, int num_cache_head, int head_dim,
+                               int gqa_size, unsigned int bits,
+                               size_t local_window_size = UINT_MAX,
+                               int head_start = 0, int head_end = -1);
+
+/**
+ * @brief Compute vcache for one row transposed of a quantized value cache,
+ * see nntrainer::compute_vcache_quantized_transposed
+ */
+void compute_vcache_quantized_transposed(int row_num, const float *in,
+                                         const uint8_t *vcache,
+                                         const uint16_t *vscales, float *output,
+                                         int num_cache_head, int gqa_size,
+                                         int head_dim, unsigned int bits,
+                                         size_t local_window_size = UINT_MAX,
+                                         int head_start = 0, int head_end = -1);
+
+/**
+ * @brief sum over len of a contiguous (outer, len, inner) tensor, see
+ * nntrainer::reduce_sum
+ */
+void reduce_sum(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y,
+                float alpha, float beta);
+
+/**
+ * @brief maximum over len of a contiguous (outer, len, inner) tensor, see
+ * nntrainer::reduce_max
+ */
+void reduce_max(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y);
+
+/**
+ * @brief Welford mean and population variance over len of a contiguous
+ * (outer, len, inner) tensor, see nntrainer::reduce_mean_var
+ */
+void reduce_mean_var(const unsigned int outer, const unsigned int len,
+                     const unsigned int inner, const float *X, float *mean,
+                     float *var);
+
+/**
+ * @brief l2 norm over len of a contiguous (outer, len, inner) tensor, see
+ * nntrainer::reduce_l2norm
+ */
+void reduce_l2norm(const unsigned int outer, const unsigned int len,
+                   const unsigned int inner, const float *X, float *Y);
+
+/**
+ * @brief batch normalization of a contiguous (outer, len, inner) tensor, see
+ * nntrainer::batch_norm_forward
+ */
+void batch_norm_forward(const unsigned int outer, const unsigned int len,
+                        const unsigned int inner, const float *X,
+                        const float *mean, const float *invstd,
+                        const float *gamma, const float *beta, float *Y,
+                        float *X_hat);
+
+/**
+ * @brief per channel sums of the batch normalization backward pass, see
+ * nntrainer::batch_norm_backward_reduce
+ */
+void batch_norm_backward_reduce(const unsigned int outer,
+                                const unsigned int len,
+                                const unsigned int inner, const float *dY,
+                                const float *X_hat, float *sum_dy,
+                                float *sum_dy_xhat);
+
+/**
+ * @brief derivative of batch normalization, see
+ * nntrainer::batch_norm_backward
+ */
+void batch_norm_backward(const unsigned int outer, const unsigned int len,
+                         const unsigned int inner, const float *dY,
+                         const float *X_hat, const float *invstd,
+                         const float *gamma, const float *mean_dy,
+                         const float *mean_dy_xhat, float *dX);
+
 } // namespace nntrainer::avx2
 
 #endif /* __cplusplus */
@@ -17,7 +17,6 @@
 #include <cmath>
 #include <cstdint>
 #include <immintrin.h>
-#include <util_func.h>
 
 namespace nntrainer::avx2 {
 
@@ -174,7 +173,7 @@ bool is_valid(const unsigned int N, const _Float16 *input) {
   }
 
   while (idx < N) {
-    if (!isFloatValid(*input)) {
+    if (!std::isfinite(static_cast<float>(*input))) {
       return false;
     }
     ++input;
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   avx512_impl.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  AVX-512 kernels selected at runtime by the x86 compute backend
+ *
+ */
+
+#include <immintrin.h>
+
+#include <avx512_impl.h>
+#include <fallback_internal.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define NNTR_AVX512_TARGET
+#else
+#define NNTR_AVX512_TARGET                                                     \
+  __attribute__((target("avx512f,avx512bw,avx512vl,avx2,fma,f16c")))
+#endif
+
+namespace nntrainer::avx512 {
+
+NNTR_AVX512_TARGET
+void ele_mul(const unsigned int N, const float *X, const float *Y, float *Z,
+             float alpha, float beta, unsigned int i_stride,
+             unsigned int o_stride) {
+  if (alpha != 1.0f || beta != 0.0f || o_stride != 1) {
+    __fallback_ele_mul(N, X, Y, Z, alpha, beta, i_stride, o_stride);
+    return;
+  }
+
+  unsigned int i = 0;
+  if (i_stride == 0) {
+    const __m512 y = _mm512_set1_ps(Y[0]);
+    for (; i + 16 <= N; i += 16)
+      _mm512_storeu_ps(Z + i, _mm512_mul_ps(_mm512_loadu_ps(X + i), y));
+    if (i < N) {
+      const __mmask16 m = (__mmask16)((1u << (N - i)) - 1);
+      _mm512_mask_storeu_ps(Z + i, m,
+                            _mm512_mul_ps(_mm512_maskz_loadu_ps(m, X + i), y));
+    }
+  } else {
+    for (; i + 16 <= N; i += 16)
+      _mm512_storeu_ps(
+        Z + i, _mm512_mul_ps(_mm512_loadu_ps(X + i), _mm512_loadu_ps(Y + i)));
+    if (i < N) {
+      const __mmask16 m = (__mmask16)((1u << (N - i)) - 1);
+      _mm512_mask_storeu_ps(Z + i, m,
+                            _mm512_mul_ps(_mm512_maskz_loadu_ps(m, X + i),
+                                          _mm512_maskz_loadu_ps(m, Y + i)));
+    }
+  }
+}
+
+NNTR_AVX512_TARGET
+void ele_add(const unsigned int N, const float *X, const float *Y, float *Z,
+             float alpha, float beta, unsigned int i_stride,
+             unsigned int o_stride) {
+  if (alpha != 1.0f || beta != 0.0f || o_stride != 1) {
+    __fallback_ele_add(N, X, Y, Z, alpha, beta, i_stride, o_stride);
+    return;
+  }
+
+  unsigned int i = 0;
+  if (i_stride == 0) {
+    const __m512 y = _mm512_set1_ps(Y[0]);
+    for (; i + 16 <= N; i += 16)
+      _mm512_storeu_ps(Z + i, _mm512_add_ps(_mm512_loadu_ps(X + i), y));
+    if (i < N) {
+      const __mmask16 m = (__mmask16)((1u << (N - i)) - 1);
+      _mm512_mask_storeu_ps(Z + i, m,
+                            _mm512_add_ps(_mm512_maskz_loadu_ps(m, X + i), y));
+    }
+  } else {
+    for (; i + 16 <= N; i += 16)
+      _mm512_storeu_ps(
+        Z + i, _mm512_add_ps(_mm512_loadu_ps(X + i), _mm512_loadu_ps(Y + i)));
+    if (i < N) {
+      const __mmask16 m = (__mmask16)((1u << (N - i)) - 1);
+      _mm512_mask_storeu_ps(Z + i, m,
+                            _mm512_add_ps(_mm512_maskz_loadu_ps(m, X + i),
+                                          _mm512_maskz_loadu_ps(m, Y + i)));
+    }
+  }
+}
+
+NNTR_AVX512_TARGET
+void clamp(const float *input, float *output, size_t length, float lower_bound,
+           float upper_bound) {
+  const __m512 lo = _mm512_set1_ps(lower_bound);
+  const __m512 hi = _mm512_set1_ps(upper_bound);
+
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m512 v = _mm512_loadu_ps(input + i);
+    /// max/min return the second operand for NaN, keep NaN as avx2 does
+    const __m512 r = _mm512_min_ps(_mm512_max_ps(v, lo), hi);
+    const __mmask16 nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+    _mm512_storeu_ps(output + i, _mm512_mask_blend_ps(nan, r, v));
+  }
+  for (; i < length; ++i) {
+    const float v = input[i];
+    output[i] =
+      (v < lower_bound) ? lower_bound : ((v > upper_bound) ? upper_bound : v);
+  }
+}
+
+NNTR_AVX512_TARGET
+void copy_f16_f32(unsigned int N, const uint16_t *input, float *output) {
+  unsigned int i = 0;
+  for (; i + 16 <= N; i += 16) {
+    const __m256i h = _mm256_loadu_si256((const __m256i *)(input + i));
+    _mm512_storeu_ps(output + i, _mm512_cvtph_ps(h));
+  }
+  if (i < N) {
+    const __mmask16 m = (__mmask16)((1u << (N - i)) - 1);
+    const __m256i h = _mm256_maskz_loadu_epi16(m, input + i);
+    _mm512_mask_storeu_ps(output + i, m, _mm512_cvtph_ps(h));
+  }
+}
+
+NNTR_AVX512_TARGET
+void copy_f32_f16(unsigned int N, const float *input, uint16_t *output) {
+  unsigned int i = 0;
+  for (; i + 16 <= N; i += 16) {
+    const __m512 v = _mm512_loadu_ps(input + i);
+    _mm256_storeu_si256((__m256i *)(output + i),
+                        _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+  }
+  if (i < N) {
+    const __mmask16 m = (__mmask16)((1u << (N - i)) - 1);
+    const __m512 v = _mm512_maskz_loadu_ps(m, input + i);
+    _mm256_mask_storeu_epi16(output + i, m,
+                             _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+  }
+}
+
+} // namespace nntrainer::avx512
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   avx512_impl.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  AVX-512 kernels selected at runtime by the x86 compute backend
+ *
+ * @note   Every kernel in this file is compiled for AVX-512 regardless of the
+ * global compiler flags. Callers must check get_x86_cpu_features() before
+ * calling into this namespace.
+ */
+
+#ifndef __AVX512_IMPL_H_
+#define __AVX512_IMPL_H_
+#ifdef __cplusplus
+
+#include <cstdint>
+#include <stddef.h>
+
+namespace nntrainer::avx512 {
+
+/**
+ * @copydoc nntrainer::avx2::ele_mul
+ */
+void ele_mul(const unsigned int N, const float *X, const float *Y, float *Z,
+             float alpha, float beta, unsigned int i_stride,
+             unsigned int o_stride);
+
+/**
+ * @copydoc nntrainer::avx2::ele_add
+ */
+void ele_add(const unsigned int N, const float *X, const float *Y, float *Z,
+             float alpha, float beta, unsigned int i_stride,
+             unsigned int o_stride);
+
+/**
+ * @brief clamp input to [lower_bound, upper_bound], NaN is passed through
+ * @param input input vector
+ * @param output output vector
+ * @param length length of IO
+ * @param lower_bound ditto
+ * @param upper_bound ditto
+ */
+void clamp(const float *input, float *output, size_t length, float lower_bound,
+           float upper_bound);
+
+/**
+ * @brief Copy uint16_t(IEEE half) to float
+ *
+ * @param N length of the vector
+ * @param input input data
+ * @param output output data
+ */
+void copy_f16_f32(unsigned int N, const uint16_t *input, float *output);
+
+/**
+ * @brief Copy float to uint16_t(IEEE half)
+ *
+ * @param N length of the vector
+ * @param input input data
+ * @param output output data
+ */
+void copy_f32_f16(unsigned int N, const float *input, uint16_t *output);
+
+} // namespace nntrainer::avx512
+
+#endif /* __cplusplus */
+#endif /* __AVX512_IMPL_H_ */
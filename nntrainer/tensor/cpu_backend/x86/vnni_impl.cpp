@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   vnni_impl.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  int8 dot product kernels using AVX-VNNI and AVX512-VNNI
+ *
+ */
+
+#include <immintrin.h>
+
+#include <vnni_impl.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define NNTR_AVXVNNI_TARGET
+#define NNTR_AVX512VNNI_TARGET
+#else
+#define NNTR_AVXVNNI_TARGET __attribute__((target("avx2,fma,avxvnni")))
+#define NNTR_AVX512VNNI_TARGET                                                 \
+  __attribute__((target("avx512f,avx512bw,avx512vl,avx512vnni,avx2,fma")))
+#endif
+
+namespace nntrainer::vnni {
+
+namespace {
+
+NNTR_AVXVNNI_TARGET
+inline int32_t hsum_epi32(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+}
+
+/**
+ * @brief dpbusd takes u8 x s8, so |a| is used as the unsigned operand and the
+ * sign of a is moved onto b.
+ */
+NNTR_AVXVNNI_TARGET
+inline __m256i dpbssd_avx(__m256i acc, __m256i a, __m256i b) {
+  return _mm256_dpbusd_avx_epi32(acc, _mm256_sign_epi8(a, a),
+                                 _mm256_sign_epi8(b, a));
+}
+
+/**
+ * @brief AVX-512 has no sign_epi8, negate b where a is negative instead
+ */
+NNTR_AVX512VNNI_TARGET
+inline __m512i dpbssd_512(__m512i acc, __m512i a, __m512i b) {
+  const __mmask64 neg = _mm512_movepi8_mask(a);
+  const __m512i sb = _mm512_mask_sub_epi8(b, neg, _mm512_setzero_si512(), b);
+  return _mm512_dpbusd_epi32(acc, _mm512_abs_epi8(a), sb);
+}
+
+} // namespace
+
+NNTR_AVXVNNI_TARGET
+int32_t dot_qai8_qsi8_avx(const unsigned int K, const int8_t *a,
+                          const int8_t *b) {
+  __m256i acc = _mm256_setzero_si256();
+  unsigned int i = 0;
+  for (; i + 32 <= K; i += 32)
+    acc = dpbssd_avx(acc, _mm256_loadu_si256((const __m256i *)(a + i)),
+                     _mm256_loadu_si256((const __m256i *)(b + i)));
+  int32_t sum = hsum_epi32(acc);
+  for (; i < K; ++i)
+    sum += static_cast<int32_t>(a[i]) * b[i];
+  return sum;
+}
+
+NNTR_AVXVNNI_TARGET
+int32_t dot_qai8_qsi4_avx(const unsigned int K, const int8_t *a,
+                          const uint8_t *b) {
+  const __m128i low_mask = _mm_set1_epi8(0x0F);
+  const __m256i offset = _mm256_set1_epi8(8);
+  __m256i acc = _mm256_setzero_si256();
+  for (unsigned int i = 0; i < K; i += 32) {
+    const __m128i packed = _mm_loadu_si128((const __m128i *)(b + i / 2));
+    const __m128i lo = _mm_and_si128(packed, low_mask);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), low_mask);
+    const __m256i vb = _mm256_sub_epi8(_mm256_set_m128i(hi, lo), offset);
+    acc = dpbssd_avx(acc, _mm256_loadu_si256((const __m256i *)(a + i)), vb);
+  }
+  return hsum_epi32(acc);
+}
+
+NNTR_AVX512VNNI_TARGET
+int32_t dot_qai8_qsi8_avx512(const unsigned int K, const int8_t *a,
+                             const int8_t *b) {
+  __m512i acc = _mm512_setzero_si512();
+  unsigned int i = 0;
+  for (; i + 64 <= K; i += 64)
+    acc = dpbssd_512(acc, _mm512_loadu_si512((const void *)(a + i)),
+                     _mm512_loadu_si512((const void *)(b + i)));
+  if (i < K) {
+    const __mmask64 m = (K - i == 64) ? ~0ULL : ((1ULL << (K - i)) - 1);
+    acc = dpbssd_512(acc, _mm512_maskz_loadu_epi8(m, a + i),
+                     _mm512_maskz_loadu_epi8(m, b + i));
+  }
+  return _mm512_reduce_add_epi32(acc);
+}
+
+NNTR_AVX512VNNI_TARGET
+int32_t dot_qai8_qsi4_avx512(const unsigned int K, const int8_t *a,
+                             const uint8_t *b) {
+  const __m256i low_mask = _mm256_set1_epi8(0x0F);
+  const __m512i offset = _mm512_set1_epi8(8);
+  __m512i acc = _mm512_setzero_si512();
+  unsigned int i = 0;
+  for (; i + 64 <= K; i += 64) {
+    // two 32 element blocks: [lo0 hi0 lo1 hi1] in 16 byte quarters
+    const __m256i packed = _mm256_loadu_si256((const __m256i *)(b + i / 2));
+    const __m256i lo = _mm256_and_si256(packed, low_mask);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(packed, 4), low_mask);
+    const __m256i q0 = _mm256_permute2x128_si256(lo, hi, 0x20);
+    const __m256i q1 = _mm256_permute2x128_si256(lo, hi, 0x31);
+    const __m512i vb = _mm512_sub_epi8(
+      _mm512_inserti64x4(_mm512_castsi256_si512(q0), q1, 1), offset);
+    acc = dpbssd_512(acc, _mm512_loadu_si512((const void *)(a + i)), vb);
+  }
+  if (i < K) {
+    const __m128i packed = _mm_loadu_si128((const __m128i *)(b + i / 2));
+    const __m128i lo = _mm_and_si128(packed, _mm256_castsi256_si128(low_mask));
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4),
+                                     _mm256_castsi256_si128(low_mask));
+    const __m512i vb = _mm512_sub_epi8(
+      _mm512_castsi256_si512(_mm256_set_m128i(hi, lo)), offset);
+    const __m512i va =
+      _mm512_castsi256_si512(_mm256_loadu_si256((const __m256i *)(a + i)));
+    // upper half of va is undefined, mask it out through a
+    acc = dpbssd_512(acc, _mm512_maskz_mov_epi8(0xFFFFFFFFULL, va), vb);
+  }
+  return _mm512_reduce_add_epi32(acc);
+}
+
+} // namespace nntrainer::vnni
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   vnni_impl.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  int8 dot product kernels using AVX-VNNI and AVX512-VNNI
+ *
+ * @note   Kernels in this file are compiled for their target ISA regardless of
+ * the global compiler flags. Callers must check get_x86_cpu_features() before
+ * calling into this namespace.
+ */
+
+#ifndef __VNNI_IMPL_H_
+#define __VNNI_IMPL_H_
+#ifdef __cplusplus
+
+#include <cstdint>
+
+namespace nntrainer::vnni {
+
+/**
+ * @copydoc nntrainer::avx2::dot_qai8_qsi8
+ * @note requires AVX-VNNI
+ */
+int32_t dot_qai8_qsi8_avx(const unsigned int K, const int8_t *a,
+                          const int8_t *b);
+
+/**
+ * @copydoc nntrainer::avx2::dot_qai8_qsi4
+ * @note requires AVX-VNNI
+ */
+int32_t dot_qai8_qsi4_avx(const unsigned int K, const int8_t *a,
+                          const uint8_t *b);
+
+/**
+ * @copydoc nntrainer::avx2::dot_qai8_qsi8
+ * @note requires AVX512-VNNI with AVX512 BW/VL
+ */
+int32_t dot_qai8_qsi8_avx512(const unsigned int K, const int8_t *a,
+                             const int8_t *b);
+
+/**
+ * @copydoc nntrainer::avx2::dot_qai8_qsi4
+ * @note requires AVX512-VNNI with AVX512 BW/VL
+ */
+int32_t dot_qai8_qsi4_avx512(const unsigned int K, const int8_t *a,
+                             const uint8_t *b);
+
+} // namespace nntrainer::vnni
+
+#endif /* __cplusplus */
+#endif /* __VNNI_IMPL_H_ */
@@ -14,20 +14,307 @@
 #include <assert.h>
 
 #include <avx2_impl.h>
+#include <avx512_impl.h>
 #ifdef USE_BLAS
 #include <cblas_interface.h>
 #endif
 #include <fallback_internal.h>
 #include <ggml_interface.h>
 #include <nntrainer_error.h>
+#include <nntrainer_log.h>
+#include <thread_runtime.h>
 #include <x86_compute_backend.h>
+#include <vnni_impl.h>
+#include <x86_cpu_features.h>
+
+#include <vector>
 
 #define ROW_MAJOR 0
 #define COL_MAJOR 1
 
 namespace nntrainer {
 
-void init_backend() { __ggml_init(); }
+namespace {
+
+/**
+ * @brief Kernels which have more than one ISA specific implementation. The
+ * table is filled once from CPUID so that one library binary serves several
+ * CPU generations.
+ */
+struct X86Kernels {
+  X86Isa isa = X86Isa::SCALAR;
+
+  void (*copy_f16_f32)(unsigned int, const uint16_t *,
+                       float *) = __fallback_copy_u16_fp32;
+  void (*copy_f32_f16)(unsigned int, const float *,
+                       uint16_t *) = __fallback_copy_fp32_u16;
+  void (*ele_mul)(unsigned int, const float *, const float *, float *, float,
+                  float, unsigned int, unsigned int) = __fallback_ele_mul;
+  void (*ele_add)(unsigned int, const float *, const float *, float *, float,
+                  float, unsigned int, unsigned int) = __fallback_ele_add;
+  void (*scopy)(unsigned int, const float *, unsigned int, float *,
+                unsigned int) = [](unsigned int N, const float *X,
+                                   unsigned int incX, float *Y,
+                                   unsigned int incY) {
+    __fallback_scopy(N, X, incX, Y, incY);
+  };
+  void (*transpose_matrix)(unsigned int, unsigned int, const float *,
+                           unsigned int, float *, unsigned int) =
+    [](unsigned int M, unsigned int N, const float *src, unsigned int ld_src,
+       float *dst, unsigned int ld_dst) {
+      __fallback_transpose_matrix(M, N, src, ld_src, dst, ld_dst);
+    };
+  bool (*is_valid)(unsigned int, const float *) =
+    [](unsigned int N, const float *X) { return __fallback_isValid(N, X); };
+  void (*unpack_q4_0x8_transpose16)(const void *, uint16_t *, uint16_t *, int,
+                                    int) = [](const void *src, uint16_t *d_out,
+                                              uint16_t *qs_out, int N, int K) {
+    __fallback_unpack_q4_0x8_transpose16(src, d_out, qs_out, N, K);
+  };
+  void (*swiglu)(unsigned int, float *, float *, float *) =
+    [](unsigned int N, float *X, float *Y, float *Z) {
+      __fallback_swiglu(N, X, Y, Z);
+    };
+  void (*swiglu_alpha)(unsigned int, float *, float *, float *, float) =
+    [](unsigned int N, float *X, float *Y, float *Z, float alpha) {
+      __fallback_swiglu(N, X, Y, Z, alpha);
+    };
+  void (*softmax_row_inplace)(float *, size_t, size_t, size_t,
+                              float *) = __fallback_softmax_row_inplace;
+  void (*softmax_row)(float *, size_t, size_t, size_t,
+                      float *) = __fallback_softmax_row;
+  void (*compute_fp16vcache_fp32_transposed)(int, const float *,
+                                             const uint16_t *, float *, int,
+                                             int, int, size_t, int, int) =
+    __fallback_compute_fp16vcache_fp32_transposed;
+  void (*compute_kcaches)(const float *, const uint16_t *, float *, int, int,
+                          int, int, int, size_t, int, int) =
+    __fallback_compute_kcaches<uint16_t>;
+  void (*compute_rotary_emb_value)(unsigned int, unsigned int, unsigned int,
+                                   float *, void *, const float *,
+                                   const float *, bool) =
+    __fallback_compute_rotary_emb_value;
+  void (*rms_norm_wrt_width)(const float *, float *, size_t, size_t, float) =
+    __fallback_rms_norm_wrt_width_fp32_intrinsic;
+  void (*clamp)(const float *, float *, size_t, float,
+                float) = __fallback_clamp<float>;
+  void (*quantize_row_qai8)(unsigned int, const float *, int8_t *,
+                            float *) = __fallback_quantize_row_qai8;
+  int32_t (*dot_qai8_qsi8)(unsigned int, const int8_t *,
+                           const int8_t *) = __fallback_dot_qai8_qsi8;
+  int32_t (*dot_qai8_qsi4)(unsigned int, const int8_t *,
+                           const uint8_t *) = __fallback_dot_qai8_qsi4;
+  void (*quantize_kv_cache)(unsigned int, const float *, uint8_t *, uint16_t *,
+                            unsigned int) = __fallback_quantize_kv_cache;
+  void (*compute_kcaches_quantized)(const float *, const uint8_t *,
+                                    const uint16_t *, float *, int, int, int,
+                                    int, unsigned int, size_t, int, int) =
+    __fallback_compute_kcaches_quantized;
+  void (*compute_vcache_quantized_transposed)(int, const float *,
+                                              const uint8_t *, const uint16_t *,
+                                              float *, int, int, int,
+                                              unsigned int, size_t, int, int) =
+    __fallback_compute_vcache_quantized_transposed;
+  void (*reduce_sum)(unsigned int, unsigned int, unsigned int, const float *,
+                     float *, float, float) = __fallback_reduce_sum;
+  void (*reduce_max)(unsigned int, unsigned int, unsigned int, const float *,
+                     float *) = __fallback_reduce_max;
+  void (*reduce_mean_var)(unsigned int, unsigned int, unsigned int,
+                          const float *, float *,
+                          float *) = __fallback_reduce_mean_var;
+  void (*reduce_l2norm)(unsigned int, unsigned int, unsigned int,
+                        const float *, float *) = __fallback_reduce_l2norm;
+  void (*batch_norm_forward)(unsigned int, unsigned int, unsigned int,
+                             const float *, const float *, const float *,
+                             const float *, const float *, float *,
+                             float *) = __fallback_batch_norm_forward;
+  void (*batch_norm_backward_reduce)(unsigned int, unsigned int, unsigned int,
+                                     const float *, const float *, float *,
+                                     float *) =
+    __fallback_batch_norm_backward_reduce;
+  void (*batch_norm_backward)(unsigned int, unsigned int, unsigned int,
+                              const float *, const float *, const float *,
+                              const float *, const float *, const float *,
+                              float *) = __fallback_batch_norm_backward;
+};
+
+X86Kernels select_kernels(X86Isa isa) {
+  X86Kernels k;
+  k.isa = isa;
+
+  if (isa >= X86Isa::AVX2) {
+    k.copy_f16_f32 = nntrainer::avx2::copy_f16_f32;
+    k.copy_f32_f16 = nntrainer::avx2::copy_f32_f16;
+    k.ele_mul = nntrainer::avx2::ele_mul;
+    k.ele_add = nntrainer::avx2::ele_add;
+    k.scopy = [](unsigned int N, const float *X, unsigned int incX, float *Y,
+                 unsigned int incY) {
+      /// the avx2 kernel only copies contiguous vectors
+      if (incX == 1 && incY == 1)
+        nntrainer::avx2::custom_scopy(N, X, incX, Y, incY);
+      else
+        __fallback_scopy(N, X, incX, Y, incY);
+    };
+    k.transpose_matrix = nntrainer::avx2::transpose_matrix;
+    k.is_valid = [](unsigned int N, const float *X) {
+      return nntrainer::avx2::is_valid(N, X);
+    };
+    k.unpack_q4_0x8_transpose16 = [](const void *src, uint16_t *d_out,
+                                     uint16_t *qs_out, int N, int K) {
+      nntrainer::avx2::unpack_q4_0x8_transpose16(src, d_out, qs_out, N, K);
+    };
+    k.swiglu = [](unsigned int N, float *X, float *Y, float *Z) {
+      nntrainer::avx2::swiglu(N, X, Y, Z);
+    };
+    k.swiglu_alpha = [](unsigned int N, float *X, float *Y, float *Z,
+                        float alpha) {
+      nntrainer::avx2::swiglu(N, X, Y, Z, alpha);
+    };
+    k.softmax_row_inplace = nntrainer::avx2::softmax_row_inplace<float>;
+    k.softmax_row = nntrainer::avx2::softmax_row<float>;
+    k.compute_fp16vcache_fp32_transposed =
+      nntrainer::avx2::compute_fp16vcache_fp32_transposed;
+    k.compute_kcaches = nntrainer::avx2::compute_kcaches<uint16_t>;
+    k.compute_rotary_emb_value = nntrainer::avx2::compute_rotary_emb_value;
+    k.rms_norm_wrt_width = nntrainer::avx2::rms_norm_wrt_width_fp32_intrinsic;
+    k.clamp = nntrainer::avx2::clamp<float>;
+    k.quantize_row_qai8 = nntrainer::avx2::quantize_row_qai8;
+    k.dot_qai8_qsi8 = nntrainer::avx2::dot_qai8_qsi8;
+    k.dot_qai8_qsi4 = nntrainer::avx2::dot_qai8_qsi4;
+    k.quantize_kv_cache = nntrainer::avx2::quantize_kv_cache;
+    k.compute_kcaches_quantized = nntrainer::avx2::compute_kcaches_quantized;
+    k.compute_vcache_quantized_transposed =
+      nntrainer::avx2::compute_vcache_quantized_transposed;
+    k.reduce_sum = nntrainer::avx2::reduce_sum;
+    k.reduce_max = nntrainer::avx2::reduce_max;
+    k.reduce_mean_var = nntrainer::avx2::reduce_mean_var;
+    k.reduce_l2norm = nntrainer::avx2::reduce_l2norm;
+    k.batch_norm_forward = nntrainer::avx2::batch_norm_forward;
+    k.batch_norm_backward_reduce = nntrainer::avx2::batch_norm_backward_reduce;
+    k.batch_norm_backward = nntrainer::avx2::batch_norm_backward;
+
+    if (get_x86_cpu_features().avx_vnni) {
+      k.dot_qai8_qsi8 = nntrainer::vnni::dot_qai8_qsi8_avx;
+      k.dot_qai8_qsi4 = nntrainer::vnni::dot_qai8_qsi4_avx;
+    }
+  }
+
+  if (isa >= X86Isa::AVX512) {
+    k.copy_f16_f32 = nntrainer::avx512::copy_f16_f32;
+    k.copy_f32_f16 = nntrainer::avx512::copy_f32_f16;
+    k.ele_mul = nntrainer::avx512::ele_mul;
+    k.ele_add = nntrainer::avx512::ele_add;
+    k.clamp = nntrainer::avx512::clamp;
+
+    if (get_x86_cpu_features().avx512_vnni) {
+      k.dot_qai8_qsi8 = nntrainer::vnni::dot_qai8_qsi8_avx512;
+      k.dot_qai8_qsi4 = nntrainer::vnni::dot_qai8_qsi4_avx512;
+    }
+  }
+
+  return k;
+}
+
+const X86Kernels &kernels() {
+  static const X86Kernels k = select_kernels(get_x86_cpu_features().bestIsa());
+  return k;
+}
+
+/**
+ * @brief C = A * B^T with A quantized per row on the fly. Rows of A are
+ * quantized once up front, then output channels are split across the thread
+ * pool so that every thread streams a disjoint slice of the weight.
+ *
+ * @param row_bytes bytes of one row of B
+ * @param dot int8 dot product for the weight type of B
+ */
+template <typename BType>
+void gemm_qai8_impl(const unsigned int M, const unsigned int N,
+                    const unsigned int K, const float *A,
+                    const unsigned int lda, const BType *B,
+                    const float *B_scales, float *C, const unsigned int ldc,
+                    const size_t row_bytes,
+                    int32_t (*dot)(unsigned int, const int8_t *,
+                                   const BType *)) {
+  const X86Kernels &k = kernels();
+
+  std::vector<int8_t> qa((size_t)M * K);
+  std::vector<float> sa(M);
+  for (unsigned int m = 0; m < M; ++m)
+    k.quantize_row_qai8(K, A + (size_t)m * lda, qa.data() + (size_t)m * K,
+                        &sa[m]);
+
+  auto compute = [&](unsigned int n_begin, unsigned int n_end) {
+    for (unsigned int m = 0; m < M; ++m) {
+      const int8_t *a = qa.data() + (size_t)m * K;
+      float *c = C + (size_t)m * ldc;
+      for (unsigned int n = n_begin; n < n_end; ++n)
+        c[n] = dot(K, a, B + n * row_bytes) * sa[m] * B_scales[n];
+    }
+  };
+
+  auto &runtime = ThreadRuntime::Global();
+  const unsigned int n_threads =
+    std::min<unsigned int>(runtime.select_k_quant_thread_count(M, N, K), N);
+  if (n_threads <= 1) {
+    compute(0, N);
+    return;
+  }
+
+  const unsigned int chunk = (N + n_threads - 1) / n_threads;
+  runtime.parallel_for(0, n_threads, [&](unsigned int t) {
+    const unsigned int n_begin = t * chunk;
+    const unsigned int n_end = std::min(N, n_begin + chunk);
+    if (n_begin < n_end)
+      compute(n_begin, n_end);
+  });
+}
+
+/**
+ * @brief number of threads to split outer slices of slice_len values over,
+ * every thread gets at least 64K values to amortize the dispatch
+ */
+unsigned int outer_split_count(const unsigned int outer,
+                               const size_t slice_len) {
+  constexpr size_t min_values_per_thread = 1 << 16;
+  const size_t total = (size_t)outer * slice_len;
+  return std::min<size_t>(
+    {(size_t)outer, (size_t)ThreadRuntime::Global().getNumThreads(),
+     total / min_values_per_thread});
+}
+
+/**
+ * @brief run fn(o_begin, o_end) over the outer slices of a reduction. Slices
+ * are split across the thread runtime once every thread gets enough values
+ * to amortize the dispatch.
+ *
+ * @param slice_len number of values of one outer slice
+ */
+template <typename Fn>
+void reduce_outer_parallel(const unsigned int outer, const size_t slice_len,
+                           Fn &&fn) {
+  const unsigned int n_threads = outer_split_count(outer, slice_len);
+  if (n_threads <= 1) {
+    fn(0, outer);
+    return;
+  }
+
+  const unsigned int chunk = (outer + n_threads - 1) / n_threads;
+  ThreadRuntime::Global().parallel_for(0, n_threads, [&](unsigned int t) {
+    const unsigned int o_begin = t * chunk;
+    const unsigned int o_end = std::min(outer, o_begin + chunk);
+    if (o_begin < o_end)
+      fn(o_begin, o_end);
+  });
+}
+
+} // namespace
+
+void init_backend() {
+  __ggml_init();
+  ml_logi("x86 compute backend selected %s kernels",
+          x86_isa_to_string(kernels().isa));
+}
 
 void scopy_int4_to_float32(const unsigned int N, const uint8_t *X,
                            const unsigned int incX, float *Y,
@@ -48,7 +335,7 @@ void copy_s16_fp32(const unsigned int N, const int16_t *X, float *Y) {
 }
 
 void copy_u16_fp32(const unsigned int N, const uint16_t *X, float *Y) {
-  nntrainer::avx2::copy_f16_f32(N, X, Y);
+  kernels().copy_f16_f32(N, X, Y);
 }
 
 void copy_fp32_u32(const unsigned int N, const float *X, uint32_t *Y) {
@@ -56,7 +343,7 @@ void copy_fp32_u32(const unsigned int N, const float *X, uint32_t *Y) {
 }
 
 void copy_fp32_u16(const unsigned int N, const float *X, uint16_t *Y) {
-  nntrainer::avx2::copy_f32_f16(N, X, Y);
+  kernels().copy_f32_f16(N, X, Y);
 }
 
 void copy_fp32_u8(const unsigned int N, const float *X, uint8_t *Y) {
@@ -150,13 +437,13 @@ void inv_sqrt_inplace(const unsigned int N, float *X) {
 void ele_mul(const unsigned int N, const float *X, const float *Y, float *Z,
              float alpha, float beta, unsigned int i_stride,
              unsigned int o_stride) {
-  nntrainer::avx2::ele_mul(N, X, Y, Z, alpha, beta, i_stride, o_stride);
+  kernels().ele_mul(N, X, Y, Z, alpha, beta, i_stride, o_stride);
 }
 
 void ele_add(const unsigned int N, const float *X, const float *Y, float *Z,
              float alpha, float beta, unsigned int i_stride,
              unsigned int o_stride) {
-  nntrainer::avx2::ele_add(N, X, Y, Z, alpha, beta, i_stride, o_stride);
+  kernels().ele_add(N, X, Y, Z, alpha, beta, i_stride, o_stride);
 }
 
 void ele_sub(const unsigned N, const float *X, const float *Y, float *Z,
@@ -217,7 +504,7 @@ void scopy(const unsigned int N, const float *X, const unsigned int incX,
   /// @note cblas_scopy is evoking SIGSEGV for some reason. Use custom
   /// implementation instead.
   // __cblas_scopy(N, X, incX, Y, incY);
-  nntrainer::avx2::custom_scopy(N, X, incX, Y, incY);
+  kernels().scopy(N, X, incX, Y, incY);
 }
 
 void sscal(const unsigned int N, const float alpha, float *X,
@@ -262,16 +549,16 @@ unsigned int isamax(const unsigned int N, const float *X,
 void transpose_matrix(const unsigned int M, const unsigned int N,
                       const float *src, unsigned int ld_src, float *dst,
                       unsigned int ld_dst) {
-  nntrainer::avx2::transpose_matrix(M, N, src, ld_src, dst, ld_dst);
+  kernels().transpose_matrix(M, N, src, ld_src, dst, ld_dst);
 }
 
 bool is_valid(const unsigned int N, const float *input) {
-  return nntrainer::avx2::is_valid(N, input);
+  return kernels().is_valid(N, input);
 }
 
 void unpack_q4_0x8_transpose16(const void *src, uint16_t *d_out,
                                uint16_t *qs_out, int N, int K) {
-  return nntrainer::avx2::unpack_q4_0x8_transpose16(src, d_out, qs_out, N, K);
+  return kernels().unpack_q4_0x8_transpose16(src, d_out, qs_out, N, K);
 }
 
 template <>
@@ -283,11 +570,11 @@ void calc_trigonometric_vals_dup(unsigned int N_half, float *angle, float *cos_,
 }
 
 void swiglu(const unsigned int N, float *X, float *Y, float *Z) {
-  nntrainer::avx2::swiglu(N, X, Y, Z);
+  kernels().swiglu(N, X, Y, Z);
 }
 
 void swiglu(const unsigned int N, float *X, float *Y, float *Z, float alpha) {
-  nntrainer::avx2::swiglu(N, X, Y, Z, alpha);
+  kernels().swiglu_alpha(N, X, Y, Z, alpha);
 }
 
 float max_val(const unsigned int N, float *X) { return __fallback_max(N, X); }
@@ -396,48 +683,47 @@ void repack_q4_K(void *W, void *repacked_W, size_t data_size,
 template <>
 void softmax_row_inplace(float *qk_out, size_t start_row, size_t end_row,
                          size_t num_heads, float *sink) {
-  nntrainer::avx2::softmax_row_inplace<float>(qk_out, start_row, end_row,
-                                              num_heads, sink);
+  kernels().softmax_row_inplace(qk_out, start_row, end_row, num_heads, sink);
 }
 
 template <>
 void softmax_row(float *qk_out, size_t start_row, size_t end_row,
                  size_t num_heads, float *sink) {
-  nntrainer::avx2::softmax_row<float>(qk_out, start_row, end_row, num_heads,
-                                      sink);
+  kernels().softmax_row(qk_out, start_row, end_row, num_heads, sink);
 }
 
 void compute_fp16vcache_fp32_transposed(int row_num, const float *in,
                                         const uint16_t *vcache, float *output,
                                         int num_cache_head, int gqa_size,
-                                        int head_dim,
-                                        size_t local_window_size) {
-  nntrainer::avx2::compute_fp16vcache_fp32_transposed(
+                                        int head_dim, size_t local_window_size,
+                                        int head_start, int head_end) {
+  kernels().compute_fp16vcache_fp32_transposed(
     row_num, in, vcache, output, num_cache_head, gqa_size, head_dim,
-    local_window_size);
+    local_window_size, head_start, head_end);
 }
 
 template <>
 void compute_kcaches(const float *in, const uint16_t *kcache, float *output,
                      int num_rows, int num_cache_head, int head_dim,
-                     int gqa_size, int tile_size, size_t local_window_size) {
-  nntrainer::avx2::compute_kcaches<uint16_t>(in, kcache, output, num_rows,
-                                             num_cache_head, head_dim, gqa_size,
-                                             tile_size, local_window_size);
+                     int gqa_size, int tile_size, size_t local_window_size,
+                     int head_start, int head_end) {
+  kernels().compute_kcaches(in, kcache, output, num_rows, num_cache_head,
+                            head_dim, gqa_size, tile_size, local_window_size,
+                            head_start, head_end);
 }
 
 void compute_rotary_emb_value(unsigned int width, unsigned int dim,
                               unsigned int half_, float *inout, void *output,
                               const float *cos_, const float *sin_,
                               bool only_convert_to_fp16) {
-  nntrainer::avx2::compute_rotary_emb_value(width, dim, half_, inout, output,
-                                            cos_, sin_, only_convert_to_fp16);
+  kernels().compute_rotary_emb_value(width, dim, half_, inout, output, cos_,
+                                     sin_, only_convert_to_fp16);
 }
 
 void rms_norm_wrt_width_fp32_intrinsic(const float *__restrict X,
                                        float *__restrict Y, size_t H, size_t W,
                                        float epsilon) {
-  nntrainer::avx2::rms_norm_wrt_width_fp32_intrinsic(X, Y, H, W, epsilon);
+  kernels().rms_norm_wrt_width(X, Y, H, W, epsilon);
 }
 
 template <>
@@ -450,6 +736,163 @@ void rms_norm_wrt_width_fp16_intrinsic(const float *__restrict X,
 template <>
 void clamp(const float *input, float *output, size_t length, float lower_bound,
            float upper_bound) {
-  nntrainer::avx2::clamp(input, output, length, lower_bound, upper_bound);
+  kernels().clamp(input, output, length, lower_bound, upper_bound);
+}
+
+void quantize_qsi8cx(const unsigned int N, const unsigned int K,
+                     const float *W, bool transB, int8_t *qW,
+                     float *scales) {
+  __fallback_quantize_qsi8cx(N, K, W, transB, qW, scales);
+}
+
+void quantize_qsi4cx(const unsigned int N, const unsigned int K,
+                     const float *W, bool transB, uint8_t *qW,
+                     float *scales) {
+  __fallback_quantize_qsi4cx(N, K, W, transB, qW, scales);
+}
+
+void gemm_qai8_qsi8cx(const unsigned int M, const unsigned int N,
+                      const unsigned int K, const float *A,
+                      const unsigned int lda, const int8_t *B,
+                      const float *B_scales, float *C,
+                      const unsigned int ldc) {
+  gemm_qai8_impl<int8_t>(M, N, K, A, lda, B, B_scales, C, ldc, K,
+                         kernels().dot_qai8_qsi8);
+}
+
+void gemm_qai8_qsi4cx(const unsigned int M, const unsigned int N,
+                      const unsigned int K, const float *A,
+                      const unsigned int lda, const uint8_t *B,
+                      const float *B_scales, float *C,
+                      const unsigned int ldc) {
+  gemm_qai8_impl<uint8_t>(M, N, K, A, lda, B, B_scales, C, ldc, K / 2,
+                          kernels().dot_qai8_qsi4);
+}
+
+void quantize_kv_cache(const unsigned int len, const float *in, uint8_t *cache,
+                       uint16_t *scales, const unsigned int bits) {
+  kernels().quantize_kv_cache(len, in, cache, scales, bits);
+}
+
+void compute_kcaches_quantized(const float *in, const uint8_t *kcache,
+                               const uint16_t *kscales, float *output,
+                               int num_rows, int num_cache_head, int head_dim,
+                               int gqa_size, unsigned int bits,
+                               size_t local_window_size, int head_start,
+                               int head_end) {
+  kernels().compute_kcaches_quantized(in, kcache, kscales, output, num_rows,
+                                      num_cache_head, head_dim, gqa_size, bits,
+                                      local_window_size, head_start, head_end);
+}
+
+void compute_vcache_quantized_transposed(int row_num, const float *in,
+                                         const uint8_t *vcache,
+                                         const uint16_t *vscales, float *output,
+                                         int num_cache_head, int gqa_size,
+                                         int head_dim, unsigned int bits,
+                                         size_t local_window_size,
+                                         int head_start, int head_end) {
+  kernels().compute_vcache_quantized_transposed(
+    row_num, in, vcache, vscales, output, num_cache_head, gqa_size, head_dim,
+    bits, local_window_size, head_start, head_end);
+}
+
+void reduce_sum(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y,
+                float alpha, float beta) {
+  const size_t slice = (size_t)len * inner;
+  reduce_outer_parallel(outer, slice, [&](unsigned int o0, unsigned int o1) {
+    kernels().reduce_sum(o1 - o0, len, inner, X + o0 * slice, Y + o0 * inner,
+                         alpha, beta);
+  });
+}
+
+void reduce_max(const unsigned int outer, const unsigned int len,
+                const unsigned int inner, const float *X, float *Y) {
+  const size_t slice = (size_t)len * inner;
+  reduce_outer_parallel(outer, slice, [&](unsigned int o0, unsigned int o1) {
+    kernels().reduce_max(o1 - o0, len, inner, X + o0 * slice, Y + o0 * inner);
+  });
+}
+
+void reduce_mean_var(const unsigned int outer, const unsigned int len,
+                     const unsigned int inner, const float *X, float *mean,
+                     float *var) {
+  const size_t slice = (size_t)len * inner;
+  reduce_outer_parallel(outer, slice, [&](unsigned int o0, unsigned int o1) {
+    kernels().reduce_mean_var(o1 - o0, len, inner, X + o0 * slice,
+                              mean + o0 * inner, var + o0 * inner);
+  });
+}
+
+void reduce_l2norm(const unsigned int outer, const unsigned int len,
+                   const unsigned int inner, const float *X, float *Y) {
+  const size_t slice = (size_t)len * inner;
+  reduce_outer_parallel(outer, slice, [&](unsigned int o0, unsigned int o1) {
+    kernels().reduce_l2norm(o1 - o0, len, inner, X + o0 * slice,
+                            Y + o0 * inner);
+  });
+}
+
+void batch_norm_forward(const unsigned int outer, const unsigned int len,
+                        const unsigned int inner, const float *X,
+                        const float *mean, const float *invstd,
+                        const float *gamma, const float *beta, float *Y,
+                        float *X_hat) {
+  const size_t slice = (size_t)len * inner;
+  reduce_outer_parallel(outer, slice, [&](unsigned int o0, unsigned int o1) {
+    kernels().batch_norm_forward(o1 - o0, len, inner, X + o0 * slice, mean,
+                                 invstd, gamma, beta, Y + o0 * slice,
+                                 X_hat ? X_hat + o0 * slice : nullptr);
+  });
+}
+
+void batch_norm_backward_reduce(const unsigned int outer,
+                                const unsigned int len,
+                                const unsigned int inner, const float *dY,
+                                const float *X_hat, float *sum_dy,
+                                float *sum_dy_xhat) {
+  const size_t slice = (size_t)len * inner;
+  const unsigned int n_threads = outer_split_count(outer, slice);
+  if (n_threads <= 1) {
+    kernels().batch_norm_backward_reduce(outer, len, inner, dY, X_hat, sum_dy,
+                                         sum_dy_xhat);
+    return;
+  }
+
+  /// every thread sums its own outer slices, the partial sums are added after
+  std::vector<float> partial((size_t)n_threads * 2 * len);
+  const unsigned int chunk = (outer + n_threads - 1) / n_threads;
+  ThreadRuntime::Global().parallel_for(0, n_threads, [&](unsigned int t) {
+    const unsigned int o_begin = std::min(outer, t * chunk);
+    const unsigned int o_end = std::min(outer, o_begin + chunk);
+    float *p = partial.data() + (size_t)t * 2 * len;
+    kernels().batch_norm_backward_reduce(o_end - o_begin, len, inner,
+                                         dY + o_begin * slice,
+                                         X_hat + o_begin * slice, p, p + len);
+  });
+
+  std::fill(sum_dy, sum_dy + len, 0.0f);
+  std::fill(sum_dy_xhat, sum_dy_xhat + len, 0.0f);
+  for (unsigned int t = 0; t < n_threads; ++t) {
+    const float *p = partial.data() + (size_t)t * 2 * len;
+    for (unsigned int l = 0; l < len; ++l) {
+      sum_dy[l] += p[l];
+      sum_dy_xhat[l] += p[len + l];
+    }
+  }
+}
+
+void batch_norm_backward(const unsigned int outer, const unsigned int len,
+                         const unsigned int inner, const float *dY,
+                         const float *X_hat, const float *invstd,
+                         const float *gamma, const float *mean_dy,
+                         const float *mean_dy_xhat, float *dX) {
+  const size_t slice = (size_t)len * inner;
+  reduce_outer_parallel(outer, slice, [&](unsigned int o0, unsigned int o1) {
+    kernels().batch_norm_backward(o1 - o0, len, inner, dY + o0 * slice,
+                                  X_hat + o0 * slice, invstd, gamma, mean_dy,
+                                  mean_dy_xhat, dX + o0 * slice);
+  });
 }
 } /* namespace nntrainer */
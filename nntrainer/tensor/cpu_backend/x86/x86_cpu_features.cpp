@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   x86_cpu_features.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  CPUID based runtime feature detection for x86 compute backend
+ *
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#include <nntrainer_log.h>
+#include <x86_cpu_features.h>
+
+namespace nntrainer {
+
+namespace {
+
+/**
+ * @brief run cpuid for (leaf, subleaf)
+ * @return false if the leaf is not supported
+ */
+bool cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (static_cast<unsigned int>(info[0]) < leaf)
+    return false;
+  __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+  for (int i = 0; i < 4; ++i)
+    regs[i] = static_cast<unsigned int>(info[i]);
+  return true;
+#else
+  return __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2],
+                           &regs[3]) != 0;
+#endif
+}
+
+/**
+ * @brief read XCR0 to know which register states the OS saves on context
+ * switch. Must only be called when OSXSAVE is set.
+ */
+uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  unsigned int eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+constexpr unsigned int bit(unsigned int n) { return 1u << n; }
+
+X86CpuFeatures detect() {
+  X86CpuFeatures f;
+  unsigned int r[4] = {0, 0, 0, 0};
+  if (!cpuid(1, 0, r))
+    return f;
+
+  const unsigned int ecx1 = r[2];
+  f.sse42 = ecx1 & bit(20);
+  f.fma = ecx1 & bit(12);
+  f.f16c = ecx1 & bit(29);
+
+  bool os_ymm = false, os_zmm = false;
+  if ((ecx1 & bit(27)) /* OSXSAVE */) {
+    const uint64_t xcr0 = xgetbv0();
+    os_ymm = (xcr0 & 0x6) == 0x6;   // XMM | YMM
+    os_zmm = (xcr0 & 0xe6) == 0xe6; // XMM | YMM | opmask | ZMM_Hi256 | Hi16
+  }
+  f.avx = os_ymm && (ecx1 & bit(28));
+  f.fma = f.fma && f.avx;
+  f.f16c = f.f16c && f.avx;
+
+  if (cpuid(7, 0, r)) {
+    const unsigned int ebx7 = r[1], ecx7 = r[2];
+    f.avx2 = f.avx && (ebx7 & bit(5));
+    f.avx512f = os_zmm && (ebx7 & bit(16));
+    f.avx512bw = f.avx512f && (ebx7 & bit(30));
+    f.avx512vl = f.avx512f && (ebx7 & bit(31));
+    f.avx512_vnni = f.avx512f && (ecx7 & bit(11));
+  }
+  if (cpuid(7, 1, r)) {
+    f.avx_vnni = f.avx2 && (r[0] & bit(4));
+  }
+
+  return f;
+}
+
+/**
+ * @brief lower the detected features to the cap requested by NNTR_X86_ISA
+ */
+void apply_env_cap(X86CpuFeatures &f) {
+  const char *env = std::getenv("NNTR_X86_ISA");
+  if (env == nullptr)
+    return;
+
+  if (std::strcmp(env, "scalar") == 0) {
+    f = X86CpuFeatures();
+  } else if (std::strcmp(env, "avx2") == 0) {
+    f.avx512f = f.avx512bw = f.avx512vl = f.avx512_vnni = false;
+  } else if (std::strcmp(env, "avx512") != 0) {
+    ml_logw("Unknown NNTR_X86_ISA value %s is ignored", env);
+  }
+}
+
+} // namespace
+
+X86Isa X86CpuFeatures::bestIsa() const {
+  const bool has_avx2 = avx2 && fma && f16c;
+  if (has_avx2 && avx512f && avx512bw && avx512vl)
+    return X86Isa::AVX512;
+  if (has_avx2)
+    return X86Isa::AVX2;
+  return X86Isa::SCALAR;
+}
+
+const X86CpuFeatures &get_x86_cpu_features() {
+  static const X86CpuFeatures features = [] {
+    X86CpuFeatures f = detect();
+    apply_env_cap(f);
+    return f;
+  }();
+  return features;
+}
+
+const char *x86_isa_to_string(X86Isa isa) {
+  switch (isa) {
+  case X86Isa::AVX512:
+    return "avx512";
+  case X86Isa::AVX2:
+    return "avx2";
+  case X86Isa::SCALAR:
+  default:
+    return "scalar";
+  }
+}
+
+} // namespace nntrainer
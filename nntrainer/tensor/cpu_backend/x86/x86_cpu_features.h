@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   x86_cpu_features.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  CPUID based runtime feature detection for x86 compute backend
+ *
+ */
+
+#ifndef __X86_CPU_FEATURES_H__
+#define __X86_CPU_FEATURES_H__
+#ifdef __cplusplus
+
+namespace nntrainer {
+
+/**
+ * @brief Kernel families the x86 backend can dispatch to, ordered from the
+ * most portable to the most capable.
+ */
+enum class X86Isa {
+  SCALAR = 0, /**< plain C++ fallback kernels */
+  AVX2 = 1,   /**< AVX2 + FMA + F16C */
+  AVX512 = 2, /**< AVX-512 F/BW/VL on top of AVX2 */
+};
+
+/**
+ * @brief Instruction set extensions reported by the running CPU and enabled
+ * by the OS (XCR0) for the register state they need.
+ */
+struct X86CpuFeatures {
+  bool sse42 = false;       /**< SSE4.2 */
+  bool avx = false;         /**< AVX with OS support for YMM state */
+  bool avx2 = false;        /**< AVX2 */
+  bool fma = false;         /**< FMA3 */
+  bool f16c = false;        /**< F16C half precision conversion */
+  bool avx_vnni = false;    /**< AVX-VNNI (VEX encoded) */
+  bool avx512f = false;     /**< AVX-512 foundation with OS ZMM support */
+  bool avx512bw = false;    /**< AVX-512 byte/word */
+  bool avx512vl = false;    /**< AVX-512 vector length */
+  bool avx512_vnni = false; /**< AVX-512 VNNI */
+
+  /**
+   * @brief Best kernel family usable on this CPU
+   */
+  X86Isa bestIsa() const;
+};
+
+/**
+ * @brief Get the features of the running CPU. Detection runs once and is
+ * cached for the lifetime of the process.
+ * @note  Environment variable NNTR_X86_ISA ("scalar", "avx2", "avx512") caps
+ * the reported features, which is useful to exercise slower kernels on a
+ * newer machine.
+ */
+const X86CpuFeatures &get_x86_cpu_features();
+
+/**
+ * @brief Get a printable name of the kernel family
+ */
+const char *x86_isa_to_string(X86Isa isa);
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __X86_CPU_FEATURES_H__ */
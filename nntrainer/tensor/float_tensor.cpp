@@ -9,6 +9,7 @@
  * @bug		No known bugs except for NYI items
  */
 
+#include <array>
 #include <iomanip>
 #include <iostream>
 #include <numeric>
@@ -18,6 +19,7 @@
 #include <float_tensor.h>
 #include <int4_tensor.h>
 #include <tensor.h>
+#include <thread_runtime.h>
 #include <util_func.h>
 
 #ifdef ENABLE_OPENCL
@@ -26,6 +28,71 @@
 
 namespace nntrainer {
 
+namespace {
+
+/**
+ * @brief memory order extents of a tensor, the last one is the densest axis
+ */
+std::array<size_t, TensorDim::MAXDIM> memoryExtents(const TensorDim &dim) {
+  if (dim.getFormat() == Tformat::NCHW)
+    return {dim.batch(), dim.channel(), dim.height(), dim.width()};
+  return {dim.batch(), dim.height(), dim.width(), dim.channel()};
+}
+
+/**
+ * @brief distance between the rows of a tensor read as a row major matrix
+ * whose rows are every axis but the last one in memory
+ * @return 0 if the rows are not evenly spaced or a row is not dense
+ */
+size_t matrixRowStride(const TensorDim &dim,
+                       const std::array<size_t, TensorDim::MAXDIM> &strides) {
+  const std::array<size_t, TensorDim::MAXDIM> extents = memoryExtents(dim);
+  const size_t cols = extents[3];
+  if (cols > 1 && strides[3] != 1)
+    return 0;
+
+  size_t row_stride = cols;
+  size_t outer_stride = 0;
+  bool found = false;
+  for (int i = 2; i >= 0; --i) {
+    if (extents[i] == 1)
+      continue;
+    if (!found)
+      row_stride = strides[i];
+    else if (strides[i] != outer_stride)
+      return 0;
+    outer_stride = strides[i] * extents[i];
+    found = true;
+  }
+
+  return row_stride < cols ? 0 : row_stride;
+}
+
+/**
+ * @brief copy between two tensors of the same shape walking their strides
+ */
+void copyStrided(const TensorDim &dim, const float *src,
+                 const std::array<size_t, TensorDim::MAXDIM> &src_strides,
+                 float *dst,
+                 const std::array<size_t, TensorDim::MAXDIM> &dst_strides) {
+  const std::array<size_t, TensorDim::MAXDIM> extents = memoryExtents(dim);
+  for (size_t i = 0; i < extents[0]; ++i) {
+    for (size_t j = 0; j < extents[1]; ++j) {
+      for (size_t k = 0; k < extents[2]; ++k) {
+        scopy(extents[3],
+              src + i * src_strides[0] + j * src_strides[1] +
+                k * src_strides[2],
+              src_strides[3],
+              dst + i * dst_strides[0] + j * dst_strides[1] +
+                k * dst_strides[2],
+              dst_strides[3]);
+      }
+    }
+  }
+}
+
+} // namespace
+
 FloatTensor::FloatTensor(std::string name_, Tformat fm) :
   TensorBase(name_, fm, Tdatatype::FP32) {}
 
@@ -354,10 +421,12 @@ Tensor &FloatTensor::multiply(float const &value, Tensor &out) const {
 
 Tensor &FloatTensor::multiply(Tensor const &m, Tensor &output,
                               const float beta) const {
-  auto f = [&](const BroadcastInfo &e, const float *buf, const float *m_buf,
-               float *out_buf) {
-    ele_mul(e.buffer_size, buf, m_buf, out_buf, 1, beta, e.strides[3],
-            strides[3]);
+  auto f = [beta](unsigned int n, const float *buf, const float *m_buf,
+                  float *out_buf, unsigned int m_stride, unsigned int stride) {
+    ele_mul(n, buf, m_buf, out_buf, 1, beta, m_stride, stride);
+  };
+  auto op = [beta](float x, float y, float z) {
+    return beta == 0.0f ? x * y : x * y + beta * z;
   };
 
   NNTR_THROW_IF(m.getFormat() != this->getFormat(), std::invalid_argument)
@@ -373,7 +442,7 @@ Tensor &FloatTensor::multiply(Tensor const &m, Tensor &output,
                 std::invalid_argument)
     << getName() << " is not contiguous, cannot multiply";
 
-  apply_broadcast(m, f, output);
+  apply_broadcast(m, f, op, output);
   return output;
 }
 
@@ -384,12 +453,13 @@ Tensor &FloatTensor::divide(float const &value, Tensor &output) const {
 }
 
 Tensor &FloatTensor::divide(Tensor const &m, Tensor &output) const {
-  auto f = [&](const BroadcastInfo &e, const float *buf, const float *m_buf,
-               float *out_buf) {
-    ele_div(e.buffer_size, buf, m_buf, out_buf, 1, 0, e.strides[3], strides[3]);
+  auto f = [](unsigned int n, const float *buf, const float *m_buf,
+              float *out_buf, unsigned int m_stride, unsigned int stride) {
+    ele_div(n, buf, m_buf, out_buf, 1, 0, m_stride, stride);
   };
+  auto op = [](float x, float y, float) { return x / y; };
 
-  apply_broadcast(m, f, output);
+  apply_broadcast(m, f, op, output);
   return output;
 }
 
@@ -464,12 +534,12 @@ Tensor &FloatTensor::add(float const &value, Tensor &output) const {
 
 Tensor &FloatTensor::add(Tensor const &m, Tensor &output,
                          float const alpha) const {
-  auto f = [&](const BroadcastInfo &e, const float *buf, const float *m_buf,
-               float *out_buf) {
-    ele_add(e.buffer_size, buf, m_buf, out_buf, alpha, 0, e.strides[3],
-            strides[3]);
+  auto f = [alpha](unsigned int n, const float *buf, const float *m_buf,
+                   float *out_buf, unsigned int m_stride, unsigned int stride) {
+    ele_add(n, buf, m_buf, out_buf, alpha, 0, m_stride, stride);
   };
-  apply_broadcast(m, f, output);
+  auto op = [alpha](float x, float y, float) { return x + alpha * y; };
+  apply_broadcast(m, f, op, output);
   return output;
 }
 
@@ -486,10 +556,7 @@ void FloatTensor::sum_by_batch(Tensor &output) const {
   const float *data = (float *)getData();
   float *out_data = output.getData<float>();
 
-  Tensor ones(1, 1, 1, feat_len, this->getFormat());
-  ones.setValue(1.0);
-  sgemv((unsigned int)dim.getStorageOrder(), false, batch, feat_len, 1, data,
-        feat_len, ones.getData<float>(), 1, 0.0, out_data, 1);
+  reduce_sum(batch, feat_len, 1, data, out_data, 1.0f, 0.0f);
 }
 
 Tensor &FloatTensor::sum(unsigned int axis, Tensor &output, float alpha,
@@ -508,6 +575,34 @@ Tensor &FloatTensor::sum(unsigned int axis, Tensor &output, float alpha,
     return output;
   }
 
+  if (dim.getStorageOrder() == TStorageOrder::ROW_MAJOR) {
+    TensorDim out_dim = dim;
+    out_dim.setTensorDim(axis, 1);
+    CREATE_IF_EMPTY_DIMS(output, out_dim);
+
+    /// view the data as (outer, len, inner) in memory order and reduce len
+    const std::array<unsigned int, 4> order =
+      getFormat() == Tformat::NHWC ? std::array<unsigned int, 4>{0, 2, 3, 1}
+                                   : std::array<unsigned int, 4>{0, 1, 2, 3};
+    size_t outer = 1, inner = 1;
+    bool after_axis = false;
+    for (unsigned int d : order) {
+      if (d == axis)
+        after_axis = true;
+      else if (after_axis)
+        inner *= dim[d];
+      else
+        outer *= dim[d];
+    }
+    reduce_sum(outer, dim[axis], inner, data, output.getData<float>(), alpha,
+               beta);
+    return output;
+  }
+
+  /// column major storage keeps the gemv path, NHWC is row major only
+  NNTR_THROW_IF(getFormat() == Tformat::NHWC, std::invalid_argument)
+    << getName() << " is column major NHWC, cannot sum";
+
   switch (axis) {
   case 0: {
     CREATE_IF_EMPTY_DIMS(output, 1, dim.channel(), dim.height(), dim.width(),
@@ -521,106 +616,42 @@ Tensor &FloatTensor::sum(unsigned int axis, Tensor &output, float alpha,
   } break;
   case 1: {
     CREATE_IF_EMPTY_DIMS(output, dim[0], 1, dim[2], dim[3], getTensorType());
-    if (this->getFormat() == Tformat::NHWC) {
-      unsigned int feat_len = output.getDim().getDataLen();
-      unsigned int t_axis = dim[1];
-      Tensor ones(1, 1, 1, t_axis, getTensorType());
-      ones.setValue(alpha);
-      sgemv((unsigned int)dim.getStorageOrder(), false, feat_len, t_axis, 1,
-            data, t_axis, ones.getData<float>(), 1, beta,
-            output.getData<float>(), 1);
-    } else {
-      unsigned int feat_len = dim[2] * dim[3];
-      unsigned int t_axis = dim[1];
-      Tensor ones(1, 1, 1, t_axis, getTensorType());
-      ones.setValue(alpha);
-      float *rdata = output.getData<float>();
-      for (unsigned int k = 0; k < dim[0]; ++k) {
-        sgemv((unsigned int)dim.getStorageOrder(), true, t_axis, feat_len, 1,
-              &data[k * dim.getFeatureLen()], feat_len, ones.getData<float>(),
-              1, beta, &rdata[k * feat_len], 1);
-      }
+    unsigned int feat_len = dim[2] * dim[3];
+    unsigned int t_axis = dim[1];
+    Tensor ones(1, 1, 1, t_axis, getTensorType());
+    ones.setValue(alpha);
+    float *rdata = output.getData<float>();
+    for (unsigned int k = 0; k < dim[0]; ++k) {
+      sgemv((unsigned int)dim.getStorageOrder(), true, t_axis, feat_len, 1,
+            &data[k * dim.getFeatureLen()], feat_len, ones.getData<float>(), 1,
+            beta, &rdata[k * feat_len], 1);
     }
   } break;
   case 2: {
     CREATE_IF_EMPTY_DIMS(output, dim[0], dim[1], 1, dim[3], getTensorType());
-    if (this->getFormat() == Tformat::NHWC) {
-      unsigned int feat_len = dim[1] * dim[3];
-      unsigned int t_axis = dim[2];
-      Tensor ones(1, 1, 1, t_axis, getTensorType());
-      ones.setValue(alpha);
-      float *rdata = output.getData<float>();
-      for (unsigned int k = 0; k < dim[0]; ++k) {
-        sgemv((unsigned int)dim.getStorageOrder(), true, t_axis, feat_len, 1,
-              &data[k * dim.getFeatureLen()], feat_len, ones.getData<float>(),
-              1, beta, &rdata[k * feat_len], 1);
-      }
-    } else {
-      unsigned int t_3 = dim[3];
-      unsigned int t_axis = dim[2];
-      Tensor ones(1, 1, 1, t_axis, getTensorType());
-      ones.setValue(alpha);
-
-      if (dim.getStorageOrder() == TStorageOrder::ROW_MAJOR) {
-        float *rdata = output.getData<float>();
-        for (unsigned int k = 0; k < dim[0]; ++k) {
-          for (unsigned int c = 0; c < dim[1]; ++c) {
-            unsigned int idx = k * dim.getFeatureLen() + c * dim[3] * dim[2];
-            unsigned int ridx =
-              k * output.getDim().getFeatureLen() + c * dim[3];
-
-            sgemv((unsigned int)dim.getStorageOrder(), true, t_axis, t_3, 1,
-                  &data[idx], t_3, ones.getData<float>(), 1, beta, &rdata[ridx],
-                  1);
-          }
-        }
-      } else {
-        sgemv((unsigned int)dim.getStorageOrder(), true, t_axis,
-              output.getDim().getDataLen(), 1, data, t_axis,
-              ones.getData<float>(), 1, beta, output.getData<float>(), 1);
-      }
-    }
+    unsigned int t_axis = dim[2];
+    Tensor ones(1, 1, 1, t_axis, getTensorType());
+    ones.setValue(alpha);
+    sgemv((unsigned int)dim.getStorageOrder(), true, t_axis,
+          output.getDim().getDataLen(), 1, data, t_axis, ones.getData<float>(),
+          1, beta, output.getData<float>(), 1);
   } break;
   case 3: {
     CREATE_IF_EMPTY_DIMS(output, dim[0], dim[1], dim[2], 1,
                          this->getTensorType());
-    if (this->getFormat() == Tformat::NHWC) {
-      unsigned int t_3 = dim[1];
-      unsigned int t_axis = dim[3];
-      Tensor ones(1, 1, 1, t_axis, getTensorType());
-      ones.setValue(alpha);
-      float *rdata = output.getData<float>();
-      for (unsigned int k = 0; k < dim[0]; ++k) {
-        for (unsigned int c = 0; c < dim[2]; ++c) {
-          unsigned int idx = k * dim.getFeatureLen() + c * dim[3] * dim[1];
-          unsigned int ridx = k * output.getDim().getFeatureLen() + c * dim[1];
-          sgemv((unsigned int)dim.getStorageOrder(), true, t_axis, t_3, 1,
-                &data[idx], t_3, ones.getData<float>(), 1, beta, &rdata[ridx],
-                1);
-        }
-      }
-    } else {
-      unsigned int m = output.getDim().getDataLen();
-      unsigned int n = dim[3];
-      Tensor ones(1, 1, 1, n, getTensorType());
-      ones.setValue(alpha);
-
-      if (dim.getStorageOrder() == TStorageOrder::ROW_MAJOR) {
-        sgemv((unsigned int)dim.getStorageOrder(), false, m, n, 1, data, n,
-              ones.getData<float>(), 1, beta, output.getData<float>(), 1);
-      } else {
-        float *rdata = output.getData<float>();
+    unsigned int n = dim[3];
+    Tensor ones(1, 1, 1, n, getTensorType());
+    ones.setValue(alpha);
+    float *rdata = output.getData<float>();
 
-        for (unsigned int k = 0; k < dim[0]; ++k) {
-          for (unsigned int c = 0; c < dim[1]; ++c) {
-            unsigned int idx = k * dim.getFeatureLen() + c * dim[3] * dim[2];
-            unsigned int ridx = k * dim[1] * dim[2] + c * dim[2];
+    for (unsigned int k = 0; k < dim[0]; ++k) {
+      for (unsigned int c = 0; c < dim[1]; ++c) {
+        unsigned int idx = k * dim.getFeatureLen() + c * dim[3] * dim[2];
+        unsigned int ridx = k * dim[1] * dim[2] + c * dim[2];
 
-            sgemv((unsigned int)dim.getStorageOrder(), false, dim[2], n, 1,
-                  &data[idx], dim[2], ones.getData<float>(), 1, beta,
-                  &rdata[ridx], 1);
-          }
-        }
+        sgemv((unsigned int)dim.getStorageOrder(), false, dim[2], n, 1,
+              &data[idx], dim[2], ones.getData<float>(), 1, beta, &rdata[ridx],
+              1);
       }
     }
   } break;
@@ -692,6 +723,10 @@ Tensor &FloatTensor::dot(Tensor const &input, Tensor &output, bool trans,
    * @note FP32.dot(input);
    * according to the input type, invoked kernels can be varied.
    */
+  NNTR_THROW_IF(!contiguous && input.getDataType() != Tdatatype::FP32,
+                std::invalid_argument)
+    << getName() << " is not contiguous. Cannot dot product.";
+
   switch (input.getDataType()) {
   /** applying sgemm/sgemv after type casting to FP32 */
   case Tdatatype::FP32:
@@ -811,6 +846,20 @@ Tensor &FloatTensor::dotFloat(Tensor const &input, Tensor &output, bool trans,
   float *rdata = output.getData<float>();
   const float alpha = 1.0f;
 
+  /// strided views are read in place through the leading dimensions
+  if (!contiguous || !input.getContiguous() || !output.getContiguous()) {
+    lda = matrixRowStride(dim, strides);
+    ldb = matrixRowStride(input.getDim(), input.getStrides());
+    ldc = matrixRowStride(output.getDim(), output.getStrides());
+    NNTR_THROW_IF(lda == 0 || ldb == 0 || ldc == 0, std::invalid_argument)
+      << getName() << ": the rows of a strided dot operand must be dense and "
+      << "evenly spaced";
+
+    sgemm((unsigned int)dim.getStorageOrder(), trans, trans_in, M, N, K, alpha,
+          data, lda, mdata, ldb, beta, rdata, ldc);
+    return output;
+  }
+
   /// shortcut handling in case of vector
   /// for vector, (1 * K) == (K * 1) in current memory layout...
   /// and please note that N, K, M is a fixed place holder after considering
@@ -1003,12 +1052,21 @@ void FloatTensor::copy(const Tensor &from) {
 }
 
 void FloatTensor::copyData(const Tensor &from) {
-  NNTR_THROW_IF(!contiguous, std::invalid_argument)
-    << getName() << " is not contiguous, cannot copy.";
-
   NNTR_THROW_IF(size() != from.size(), std::invalid_argument)
     << "Size of tensor to copy must match";
 
+  if (from.getDataType() == Tdatatype::FP32 &&
+      (!contiguous || !from.getContiguous())) {
+    NNTR_THROW_IF(from.getDim() != dim, std::invalid_argument)
+      << getName() << ": strided copy needs tensors of the same shape";
+    copyStrided(dim, from.getData<float>(), from.getStrides(),
+                (float *)getData(), strides);
+    return;
+  }
+
+  NNTR_THROW_IF(!contiguous, std::invalid_argument)
+    << getName() << " is not contiguous, cannot copy.";
+
   switch (from.getDataType()) {
   case ml::train::TensorDim::DataType::FP32:
     copy(from.getData<float>());
@@ -1043,6 +1101,12 @@ void FloatTensor::copyData(const Tensor &from) {
 }
 
 void FloatTensor::copy_with_stride(const Tensor &input, Tensor &output) {
+  if (input.getFormat() == output.getFormat()) {
+    copyStrided(output.getDim(), input.getData<float>(), input.getStrides(),
+                output.getData<float>(), output.getStrides());
+    return;
+  }
+
   for (unsigned int b = 0; b < output.batch(); ++b) {
     for (unsigned int c = 0; c < output.channel(); ++c) {
       for (unsigned int h = 0; h < output.height(); ++h) {
@@ -1108,49 +1172,48 @@ void FloatTensor::topK(unsigned int k, void *output_data,
   output_dim.width(k);
   const auto output_strides = output_dim.computeStrides();
 
-#pragma omp parallel for collapse(3)
-  for (int b = 0; b < static_cast<int>(batch); ++b) {
-    for (int c = 0; c < static_cast<int>(channel); ++c) {
-      for (int h = 0; h < static_cast<int>(height); ++h) {
+  ThreadRuntime::Global().parallel_for(
+    0, batch * channel * height, [&](unsigned int t) {
+      const unsigned int b = t / (channel * height);
+      const unsigned int c = (t / height) % channel;
+      const unsigned int h = t % height;
+
+      size_t offset;
+      if (format == Tformat::NCHW) {
+        // NCHW: [b][c][h][i]
+        offset =
+          b * input_strides[0] + c * input_strides[1] + h * input_strides[2];
+      } else {
+        // NHWC: [b][h][i][c]
+        offset = b * input_strides[0] + h * input_strides[1] + c;
+      }
 
-        size_t offset;
+      const unsigned int width_stride =
+        format == Tformat::NHWC ? input_strides[2] : 1;
+      const float *B = static_cast<const float *>(getData()) + offset;
+      std::vector<size_t> idx(width);
+      std::iota(idx.begin(), idx.end(), 0);
+      std::partial_sort(idx.begin(), idx.begin() + k, idx.end(),
+                        [&B, width_stride](size_t i1, size_t i2) {
+                          return B[i1 * width_stride] > B[i2 * width_stride];
+                        });
+
+      // write top-k values and their indices to output
+      for (unsigned int i = 0; i < k; ++i) {
+        size_t output_idx;
         if (format == Tformat::NCHW) {
           // NCHW: [b][c][h][i]
-          offset =
-            b * input_strides[0] + c * input_strides[1] + h * input_strides[2];
+          output_idx = b * output_strides[0] + c * output_strides[1] +
+                       h * output_strides[2] + i;
         } else {
           // NHWC: [b][h][i][c]
-          offset = b * input_strides[0] + h * input_strides[1] + c;
-        }
-
-        const unsigned int width_stride =
-          format == Tformat::NHWC ? input_strides[2] : 1;
-        const float *B = static_cast<const float *>(getData()) + offset;
-        std::vector<size_t> idx(width);
-        std::iota(idx.begin(), idx.end(), 0);
-        std::partial_sort(idx.begin(), idx.begin() + k, idx.end(),
-                          [&B, width_stride](size_t i1, size_t i2) {
-                            return B[i1 * width_stride] > B[i2 * width_stride];
-                          });
-
-        // write top-k values and their indices to output
-        for (unsigned int i = 0; i < k; ++i) {
-          size_t output_idx;
-          if (format == Tformat::NCHW) {
-            // NCHW: [b][c][h][i]
-            output_idx = b * output_strides[0] + c * output_strides[1] +
-                         h * output_strides[2] + i;
-          } else {
-            // NHWC: [b][h][i][c]
-            output_idx = b * output_strides[0] + h * output_strides[1] +
-                         i * output_strides[2] + c;
-          }
-          output_buffer[output_idx] = B[idx[i]];
-          indices_data[output_idx] = static_cast<uint32_t>(idx[i]);
+          output_idx = b * output_strides[0] + h * output_strides[1] +
+                       i * output_strides[2] + c;
         }
+        output_buffer[output_idx] = B[idx[i]];
+        indices_data[output_idx] = static_cast<uint32_t>(idx[i]);
       }
-    }
-  }
+    });
 }
 
 float FloatTensor::max_abs() const {
@@ -1161,7 +1224,9 @@ float FloatTensor::max_abs() const {
 
 float FloatTensor::maxValue() const {
   const float *data = (float *)getData();
-  return *std::max_element(data, data + size());
+  float max_value;
+  reduce_max(1, size(), 1, data, &max_value);
+  return max_value;
 }
 
 float FloatTensor::minValue() const {
@@ -1504,44 +1569,9 @@ void FloatTensor::copy(const void *buf) {
   scopy(size(), (float *)buf, 1, (float *)getData(), 1);
 }
 
-void FloatTensor::apply_broadcast_util(
-  Tensor const &m,
-  std::function<void(const BroadcastInfo &e, const float *, const float *,
-                     float *)>
-    v_func,
-  Tensor &output, const BroadcastInfo &e, int cur_axis, size_t offset,
-  size_t m_offset) const {
-
-  const float *buf = (float *)this->getData();
-  const float *m_buf = m.getData<float>();
-  float *out_buf = output.getData<float>();
-
-  if (e.buffer_axis == cur_axis) {
-    v_func(e, buf + offset, m_buf + m_offset, out_buf + offset);
-    return;
-  }
-
-  cur_axis++;
-  unsigned int continuity[4] = {0, 1, 2, 3};
-  if (getFormat() == Tformat::NHWC) {
-    continuity[1] = 2;
-    continuity[2] = 3;
-    continuity[3] = 1;
-  }
-  for (unsigned int i = 0; i < dim.getTensorDim(continuity[cur_axis]); ++i) {
-    size_t next_offset = offset + i * strides[cur_axis];
-    size_t next_m_offset = m_offset + i * e.strides[cur_axis];
-    apply_broadcast_util(m, v_func, output, e, cur_axis, next_offset,
-                         next_m_offset);
-  }
-}
-
-void FloatTensor::apply_broadcast(
-  Tensor const &m,
-  std::function<void(const BroadcastInfo &e, const float *, const float *,
-                     float *)>
-    v_func,
-  Tensor &output) const {
+template <typename Kernel, typename Op>
+void FloatTensor::apply_broadcast(Tensor const &m, Kernel &&kernel, Op &&op,
+                                  Tensor &output) const {
   CREATE_IF_EMPTY_DIMS(output, dim);
 
   NNTR_THROW_IF(getData() == nullptr, std::invalid_argument)
@@ -1551,19 +1581,8 @@ void FloatTensor::apply_broadcast(
   NNTR_THROW_IF(output.getData<float>() == nullptr, std::invalid_argument)
     << output.getName() << " is not allocated";
 
-  /// shortcut to cover when dimension matches
-  /// note that buffer_size, the last stride is only used in v_func but it
-  /// might be changed
-  if (dim == m.getDim()) {
-    BroadcastInfo e;
-    e.buffer_size = size();
-    e.strides[3] = 1;
-    e.tensor_type = getTensorType();
-    v_func(e, (float *)getData(), m.getData<float>(), output.getData<float>());
-    return;
-  }
-
-  return apply_broadcast_util(m, v_func, output, this->computeBroadcastInfo(m));
+  runBroadcastLoop(computeBroadcastLoop(m), (const float *)getData(),
+                   m.getData<float>(), output.getData<float>(), kernel, op);
 }
 
 bool FloatTensor::isValid() const {
@@ -345,10 +345,12 @@ Tensor &HalfTensor::multiply(float const &value, Tensor &out) const {
 
 Tensor &HalfTensor::multiply(Tensor const &m, Tensor &output,
                              const float beta) const {
-  auto f = [&](const BroadcastInfo &e, const _FP16 *buf, const _FP16 *m_buf,
-               _FP16 *out_buf) {
-    ele_mul(e.buffer_size, buf, m_buf, out_buf, 1, beta, e.strides[3],
-            strides[3]);
+  auto f = [beta](unsigned int n, const _FP16 *buf, const _FP16 *m_buf,
+                  _FP16 *out_buf, unsigned int m_stride, unsigned int stride) {
+    ele_mul(n, buf, m_buf, out_buf, 1, beta, m_stride, stride);
+  };
+  auto op = [beta](_FP16 x, _FP16 y, _FP16 z) -> _FP16 {
+    return beta == 0.0f ? x * y : x * y + static_cast<_FP16>(beta) * z;
   };
 
   NNTR_THROW_IF(m.getFormat() != this->getFormat(), std::invalid_argument)
@@ -360,7 +362,7 @@ Tensor &HalfTensor::multiply(Tensor const &m, Tensor &output,
                 std::invalid_argument)
     << getName() << " is not contiguous, cannot multiply";
 
-  apply_broadcast(m, f, output);
+  apply_broadcast(m, f, op, output);
   return output;
 }
 
@@ -440,12 +442,14 @@ Tensor &HalfTensor::add(float const &value, Tensor &output) const {
 
 Tensor &HalfTensor::add(Tensor const &m, Tensor &output,
                         float const alpha) const {
-  auto f = [&](const BroadcastInfo &e, const _FP16 *buf, const _FP16 *m_buf,
-               _FP16 *out_buf) {
-    ele_add(e.buffer_size, buf, m_buf, out_buf, alpha, 0, e.strides[3],
-            strides[3]);
+  auto f = [alpha](unsigned int n, const _FP16 *buf, const _FP16 *m_buf,
+                   _FP16 *out_buf, unsigned int m_stride, unsigned int stride) {
+    ele_add(n, buf, m_buf, out_buf, alpha, 0, m_stride, stride);
+  };
+  auto op = [alpha](_FP16 x, _FP16 y, _FP16) -> _FP16 {
+    return x + static_cast<_FP16>(alpha) * y;
   };
-  apply_broadcast(m, f, output);
+  apply_broadcast(m, f, op, output);
   return output;
 }
 
@@ -993,12 +997,13 @@ Tensor &HalfTensor::divide(float const &value, Tensor &output) const {
 }
 
 Tensor &HalfTensor::divide(Tensor const &m, Tensor &output) const {
-  auto f = [&](const BroadcastInfo &e, const _FP16 *buf, const _FP16 *m_buf,
-               _FP16 *out_buf) {
-    ele_div(e.buffer_size, buf, m_buf, out_buf, 1, 0, e.strides[3], strides[3]);
+  auto f = [](unsigned int n, const _FP16 *buf, const _FP16 *m_buf,
+              _FP16 *out_buf, unsigned int m_stride, unsigned int stride) {
+    ele_div(n, buf, m_buf, out_buf, 1, 0, m_stride, stride);
   };
+  auto op = [](_FP16 x, _FP16 y, _FP16) -> _FP16 { return x / y; };
 
-  apply_broadcast(m, f, output);
+  apply_broadcast(m, f, op, output);
   return output;
 }
 
@@ -1177,12 +1182,9 @@ void HalfTensor::copy(const void *buf) {
   scopy(size(), (_FP16 *)buf, 1, (_FP16 *)getData(), 1);
 }
 
-void HalfTensor::apply_broadcast(
-  Tensor const &m,
-  std::function<void(const BroadcastInfo &e, const _FP16 *, const _FP16 *,
-                     _FP16 *)>
-    v_func,
-  Tensor &output) const {
+template <typename Kernel, typename Op>
+void HalfTensor::apply_broadcast(Tensor const &m, Kernel &&kernel, Op &&op,
+                                 Tensor &output) const {
   CREATE_IF_EMPTY_DIMS(output, dim, nullptr);
 
   NNTR_THROW_IF(getData() == nullptr, std::invalid_argument)
@@ -1192,44 +1194,8 @@ void HalfTensor::apply_broadcast(
   NNTR_THROW_IF(output.getData<_FP16>() == nullptr, std::invalid_argument)
     << output.getName() << " is not allocated";
 
-  /// shortcut to cover when dimension matches
-  /// note that buffer_size, the last stride is only used in v_func but it
-  /// might be changed
-  if (dim == m.getDim()) {
-    BroadcastInfo e;
-    e.buffer_size = size();
-    e.strides[3] = 1;
-    v_func(e, (_FP16 *)getData(), m.getData<_FP16>(), output.getData<_FP16>());
-    return;
-  }
-
-  return apply_broadcast_util(m, v_func, output, this->computeBroadcastInfo(m));
-}
-
-void HalfTensor::apply_broadcast_util(
-  Tensor const &m,
-  std::function<void(const BroadcastInfo &e, const _FP16 *, const _FP16 *,
-                     _FP16 *)>
-    v_func,
-  Tensor &output, const BroadcastInfo &e, int cur_axis, size_t offset,
-  size_t m_offset) const {
-
-  const _FP16 *buf = (_FP16 *)this->getData();
-  const _FP16 *m_buf = m.getData<_FP16>();
-  _FP16 *out_buf = output.getData<_FP16>();
-
-  if (e.buffer_axis == cur_axis) {
-    v_func(e, buf + offset, m_buf + m_offset, out_buf + offset);
-    return;
-  }
-
-  cur_axis++;
-  for (unsigned int i = 0; i < dim.getTensorDim(cur_axis); ++i) {
-    size_t next_offset = offset + i * strides[cur_axis];
-    size_t next_m_offset = m_offset + i * e.strides[cur_axis];
-    apply_broadcast_util(m, v_func, output, e, cur_axis, next_offset,
-                         next_m_offset);
-  }
+  runBroadcastLoop(computeBroadcastLoop(m), (const _FP16 *)getData(),
+                   m.getData<_FP16>(), output.getData<_FP16>(), kernel, op);
 }
 
 bool HalfTensor::isValid() const {
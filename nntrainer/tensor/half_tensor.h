@@ -476,37 +476,17 @@ private:
   void copy(const void *buf);
 
   /**
-   * @brief Applies the given operator to the tensor with the passed argument
-   * @param[in] m Tensor
-   * @param[in] v_func vectorized function to apply
-   * @param e broadcast info.
-   * @param cur_axis current axis. pass default when calling outside.
-   * @param offset offset for this.  pass default when calling outside.
-   * @param m_offset offset for m.  pass default when calling outside.
-   * @retval #ML_ERROR_NONE Successful
-   * @retval #ML_ERROR_INVALID_PARAMETER Invalid Parameter
-   */
-  void
-  apply_broadcast_util(Tensor const &m,
-                       std::function<void(const BroadcastInfo &e, const _FP16 *,
-                                          const _FP16 *, _FP16 *)>
-                         v_func,
-                       Tensor &output, const BroadcastInfo &e,
-                       int cur_axis = -1, size_t offset = 0,
-                       size_t m_offset = 0) const;
-
-  /**
-   * @brief Applies the given operator to the tensor with the passed argument
+   * @brief Applies the given kernel to the tensor broadcasting m
    *
    * @param[in] m Tensor
-   * @param[in] v_func vectorized function to apply
-   * @retval #ML_ERROR_NONE Successful
-   * @retval #ML_ERROR_INVALID_PARAMETER Invalid Parameter
-   */
-  void apply_broadcast(Tensor const &m,
-                       std::function<void(const BroadcastInfo &e, const _FP16 *,
-                                          const _FP16 *, _FP16 *)>
-                         v_func,
+   * @param[in] kernel vectorized function of a run,
+   * void(n, x, y, z, y_stride, stride)
+   * @param[in] op element function of a run too short for the kernel,
+   * z = op(x, y, z)
+   * @param[out] output output tensor
+   */
+  template <typename Kernel, typename Op>
+  void apply_broadcast(Tensor const &m, Kernel &&kernel, Op &&op,
                        Tensor &output) const;
 
   /**
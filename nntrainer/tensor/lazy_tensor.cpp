@@ -11,19 +11,43 @@
  *
  */
 
+#include <algorithm>
+
+#include <cpu_backend.h>
 #include <lazy_tensor.h>
 #include <nntrainer_error.h>
+#include <thread_runtime.h>
 
 namespace nntrainer {
 
+namespace {
+
+/** elements processed by all fused operations while they stay in cache */
+constexpr unsigned int FUSED_BLOCK = 2048;
+
+/** elements below which a fused group runs on the calling thread */
+constexpr size_t FUSED_PARALLEL_THRESHOLD = 1 << 16;
+
+} // namespace
+
+LazyTensor &LazyTensor::push(ElementwiseOp op) {
+  if (call_chain.empty() || call_chain.back().call)
+    call_chain.emplace_back();
+  call_chain.back().ops.push_back(op);
+  return *this;
+}
+
+LazyTensor &LazyTensor::push(std::function<int(Tensor &)> call) {
+  call_chain.push_back({{}, std::move(call)});
+  return *this;
+}
+
 /**
  * @brief Wrapper method of add_i (immediate version of add)
  * @retval this
  */
 LazyTensor &LazyTensor::add_i(float const &value) {
-  call_chain.push_back(
-    [value](Tensor &t) mutable -> int { return t.add_i(value); });
-  return *this;
+  return push({ElementwiseOp::Kind::ADD, nullptr, value, 1.0f});
 }
 /**
  * @brief     Wrapper method of add_i. see tensor.h for more detail
@@ -31,9 +55,7 @@ LazyTensor &LazyTensor::add_i(float const &value) {
  * @retval    LazyTensor *this
  */
 LazyTensor &LazyTensor::add_i(Tensor const &m, float const alpha) {
-  auto f = [&m, alpha](Tensor &t) mutable -> int { return t.add_i(m, alpha); };
-  call_chain.push_back(f);
-  return *this;
+  return push({ElementwiseOp::Kind::ADD, &m, 0.0f, alpha});
 }
 
 /**
@@ -42,9 +64,7 @@ LazyTensor &LazyTensor::add_i(Tensor const &m, float const alpha) {
  * @retval    LazyTensor *this
  */
 LazyTensor &LazyTensor::subtract_i(Tensor const &m) {
-  auto f = [&m](Tensor &t) mutable -> int { return t.subtract_i(m); };
-  call_chain.push_back(f);
-  return *this;
+  return push({ElementwiseOp::Kind::ADD, &m, 0.0f, -1.0f});
 }
 
 /**
@@ -53,9 +73,7 @@ LazyTensor &LazyTensor::subtract_i(Tensor const &m) {
  * @retval    LazyTensor *this
  */
 LazyTensor &LazyTensor::subtract_i(float const &value) {
-  auto f = [value](Tensor &t) mutable -> int { return t.subtract_i(value); };
-  call_chain.push_back(f);
-  return *this;
+  return push({ElementwiseOp::Kind::ADD, nullptr, -value, 1.0f});
 }
 
 /**
@@ -64,9 +82,7 @@ LazyTensor &LazyTensor::subtract_i(float const &value) {
  * @retval LazyTensor *this
  */
 LazyTensor &LazyTensor::multiply_i(float const &value) {
-  auto f = [value](Tensor &t) mutable -> int { return t.multiply_i(value); };
-  call_chain.push_back(f);
-  return *this;
+  return push({ElementwiseOp::Kind::MULTIPLY, nullptr, value, 1.0f});
 }
 
 /**
@@ -75,9 +91,7 @@ LazyTensor &LazyTensor::multiply_i(float const &value) {
  * @retval    LazyTensor *this
  */
 LazyTensor &LazyTensor::multiply_i(Tensor const &m) {
-  auto f = [&m](Tensor &t) mutable -> int { return t.multiply_i(m); };
-  call_chain.push_back(f);
-  return *this;
+  return push({ElementwiseOp::Kind::MULTIPLY, &m, 0.0f, 1.0f});
 }
 
 /**
@@ -86,9 +100,7 @@ LazyTensor &LazyTensor::multiply_i(Tensor const &m) {
  * @retval    LazyTensor *this
  */
 LazyTensor &LazyTensor::divide_i(float const &value) {
-  auto f = [value](Tensor &t) mutable -> int { return t.divide_i(value); };
-  call_chain.push_back(f);
-  return *this;
+  return push({ElementwiseOp::Kind::DIVIDE, nullptr, value, 1.0f});
 }
 
 /**
@@ -97,9 +109,7 @@ LazyTensor &LazyTensor::divide_i(float const &value) {
  * @retval    LazyTensor *this
  */
 LazyTensor &LazyTensor::divide_i(Tensor const &m) {
-  auto f = [&m](Tensor &t) mutable -> int { return t.divide_i(m); };
-  call_chain.push_back(f);
-  return *this;
+  return push({ElementwiseOp::Kind::DIVIDE, &m, 0.0f, 1.0f});
 }
 
 /**
@@ -118,8 +128,7 @@ LazyTensor &LazyTensor::dot(Tensor const &m) {
     }
   };
 
-  call_chain.push_back(f);
-  return *this;
+  return push(f);
 }
 
 /**
@@ -138,8 +147,7 @@ LazyTensor &LazyTensor::transpose(std::string direction) {
     }
   };
 
-  call_chain.push_back(f);
-  return *this;
+  return push(f);
 }
 
 /**
@@ -158,8 +166,7 @@ LazyTensor &LazyTensor::sum_by_batch() {
     }
   };
 
-  call_chain.push_back(f);
-  return *this;
+  return push(f);
 }
 
 /**
@@ -178,8 +185,7 @@ LazyTensor &LazyTensor::sum(int axis) {
     }
   };
 
-  call_chain.push_back(f);
-  return *this;
+  return push(f);
 }
 
 /**
@@ -197,8 +203,7 @@ LazyTensor &LazyTensor::average(int axis) {
     }
   };
 
-  call_chain.push_back(f);
-  return *this;
+  return push(f);
 }
 
 /**
@@ -216,23 +221,205 @@ LazyTensor &LazyTensor::average() {
     }
   };
 
-  call_chain.push_back(f);
-  return *this;
+  return push(f);
+}
+
+bool LazyTensor::runFused(const Tensor &in, Tensor &out,
+                          const std::vector<ElementwiseOp> &ops) {
+  auto fusible = [](const Tensor &t) {
+    return t.getDataType() == TensorDim::DataType::FP32 &&
+           t.getFormat() == TensorDim::Format::NCHW && t.getContiguous() &&
+           t.getData<float>() != nullptr;
+  };
+  if (!fusible(in) || !fusible(out) || in.getDim() != out.getDim())
+    return false;
+
+  /// strides of the output (same as the input) and of every tensor operand,
+  /// broadcast axes of the operands have the stride 0
+  const TensorDim &dim = in.getDim();
+  std::vector<std::array<size_t, TensorDim::MAXDIM>> strides = {
+    dim.computeStrides()};
+  std::vector<const float *> operands;
+  for (auto &op : ops) {
+    if (op.operand == nullptr) {
+      if (op.kind == ElementwiseOp::Kind::DIVIDE && op.value == 0.0f)
+        return false;
+      continue;
+    }
+
+    const Tensor &m = *op.operand;
+    if (!fusible(m))
+      return false;
+    const TensorDim &m_dim = m.getDim();
+    auto m_strides = m_dim.computeStrides();
+    for (unsigned int a = 0; a < TensorDim::MAXDIM; ++a) {
+      if (m_dim.getTensorDim(a) == dim.getTensorDim(a))
+        continue;
+      if (m_dim.getTensorDim(a) != 1)
+        return false;
+      m_strides[a] = 0;
+    }
+    strides.push_back(m_strides);
+    operands.push_back(m.getData<float>());
+  }
+
+  /// merge neighbouring axes every tensor walks contiguously
+  const size_t num_tensors = strides.size();
+  std::vector<size_t> sizes;
+  std::vector<std::vector<size_t>> axis_strides(num_tensors);
+  for (unsigned int a = 0; a < TensorDim::MAXDIM; ++a) {
+    const size_t size = dim.getTensorDim(a);
+    if (size == 1)
+      continue;
+
+    bool merge = !sizes.empty();
+    for (size_t t = 0; merge && t < num_tensors; ++t)
+      merge = axis_strides[t].back() == strides[t][a] * size;
+    if (merge) {
+      sizes.back() *= size;
+      for (size_t t = 0; t < num_tensors; ++t)
+        axis_strides[t].back() = strides[t][a];
+      continue;
+    }
+
+    sizes.push_back(size);
+    for (size_t t = 0; t < num_tensors; ++t)
+      axis_strides[t].push_back(strides[t][a]);
+  }
+  if (sizes.empty()) {
+    sizes.push_back(1);
+    for (size_t t = 0; t < num_tensors; ++t)
+      axis_strides[t].push_back(0);
+  }
+
+  const size_t len = sizes.back();
+  const size_t blocks = (len + FUSED_BLOCK - 1) / FUSED_BLOCK;
+  size_t rows = 1;
+  for (size_t a = 0; a + 1 < sizes.size(); ++a)
+    rows *= sizes[a];
+
+  const float *in_data = in.getData<float>();
+  float *out_data = out.getData<float>();
+
+  /// every operation runs on a block of a row while it is in cache
+  auto run_block = [&](size_t item) {
+    const size_t j = (item % blocks) * FUSED_BLOCK;
+    const unsigned int n = std::min<size_t>(FUSED_BLOCK, len - j);
+
+    std::vector<size_t> offsets(num_tensors, 0);
+    size_t row = item / blocks;
+    for (size_t a = sizes.size() - 1; a-- > 0;) {
+      const size_t idx = row % sizes[a];
+      row /= sizes[a];
+      for (size_t t = 0; t < num_tensors; ++t)
+        offsets[t] += idx * axis_strides[t][a];
+    }
+
+    const float *x = in_data + offsets[0] + j;
+    float *z = out_data + offsets[0] + j;
+    size_t t = 1;
+    for (auto &op : ops) {
+      const float *y = &op.value;
+      unsigned int y_stride = 0;
+      if (op.operand != nullptr) {
+        y_stride = axis_strides[t].back();
+        y = operands[t - 1] + offsets[t] + j * y_stride;
+        ++t;
+      }
+
+      switch (op.kind) {
+      case ElementwiseOp::Kind::ADD:
+        ele_add(n, x, y, z, op.alpha, 0.0f, y_stride, 1);
+        break;
+      case ElementwiseOp::Kind::MULTIPLY:
+        ele_mul(n, x, y, z, 1.0f, 0.0f, y_stride, 1);
+        break;
+      case ElementwiseOp::Kind::DIVIDE:
+        ele_div(n, x, y, z, 1.0f, 0.0f, y_stride, 1);
+        break;
+      }
+      x = z;
+    }
+  };
+
+  const size_t items = rows * blocks;
+  if (dim.getDataLen() < FUSED_PARALLEL_THRESHOLD) {
+    for (size_t item = 0; item < items; ++item)
+      run_block(item);
+  } else {
+    ThreadRuntime::Global().parallel_for(
+      0, static_cast<unsigned int>(items),
+      [&run_block](unsigned int item) { run_block(item); });
+  }
+
+  return true;
+}
+
+int LazyTensor::ElementwiseOp::apply(Tensor &t) const {
+  switch (kind) {
+  case Kind::ADD:
+    return operand ? t.add_i(*operand, alpha) : t.add_i(value);
+  case Kind::MULTIPLY:
+    return operand ? t.multiply_i(*operand) : t.multiply_i(value);
+  case Kind::DIVIDE:
+    return operand ? t.divide_i(*operand) : t.divide_i(value);
+  }
+  return ML_ERROR_INVALID_PARAMETER;
+}
+
+Tensor LazyTensor::evaluate(Tensor *output) {
+  Tensor current = source;
+  bool owned = false;
+
+  for (size_t i = 0; i < call_chain.size(); ++i) {
+    const Stage &stage = call_chain[i];
+    if (stage.call) {
+      if (stage.call(current) != ML_ERROR_NONE)
+        throw std::runtime_error("Error: evaluation failed");
+      owned = true;
+      continue;
+    }
+
+    /// the last group writes to output, earlier ones to a tensor of their own
+    Tensor dst;
+    if (output != nullptr && i + 1 == call_chain.size() &&
+        !output->empty() && output->getDim() == current.getDim())
+      dst = *output;
+    else if (owned)
+      dst = current;
+    else
+      dst = Tensor(current.getDim());
+
+    if (!runFused(current, dst, stage.ops)) {
+      if (dst.getData<char>() != current.getData<char>())
+        dst.copyData(current);
+      for (auto &op : stage.ops) {
+        if (op.apply(dst) != ML_ERROR_NONE)
+          throw std::runtime_error("Error: evaluation failed");
+      }
+    }
+
+    current = dst;
+    owned = true;
+  }
+
+  /// run() must not return the chained tensor itself
+  return owned || output != nullptr ? current : current.clone();
 }
 
 /**
  * @brief execute the call_chain to evaluate
  * @retval calculated tensor
  */
-Tensor LazyTensor::run() {
-  int status;
-  for (auto &item : call_chain) {
-    status = item(target);
-    if (status != ML_ERROR_NONE) {
-      throw std::runtime_error("Error: evaluation failed");
-    }
-  }
-  return target;
+Tensor LazyTensor::run() { return evaluate(nullptr); }
+
+Tensor &LazyTensor::run(Tensor &output) {
+  Tensor result = evaluate(&output);
+  if (output.empty())
+    output = result;
+  else if (output.getData<char>() != result.getData<char>())
+    output.copyData(result);
+  return output;
 }
 
 } /* namespace nntrainer */
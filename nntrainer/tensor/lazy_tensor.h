@@ -15,6 +15,7 @@
 #define __LAZY_TENSOR_H__
 #ifdef __cplusplus
 
+#include <functional>
 #include <tensor.h>
 #include <vector>
 
@@ -24,14 +25,19 @@ namespace nntrainer {
  * @class   LazyTensor a wrapper class for lazy calculation of tensor
  * @brief   calculation is delayed until Tensor LazyTensor::run() is
  *          called, can be contructed by Tensor::chain() method
+ * @details consecutive add_i, subtract_i, multiply_i and divide_i are fused.
+ *          They run as one blocked loop that reads and writes every element
+ *          once, scalar and broadcast operands included. Other operations end
+ *          the fused group. Groups that cannot be fused, e.g. of a non FP32
+ *          or non contiguous tensor, run one operation after another.
  */
 class LazyTensor {
 public:
   /**
-   * @brief Constructor of Lazy Tensor, Tensor is copied to gaurantee
-   * immutability
+   * @brief Constructor of Lazy Tensor, the tensor is not modified and its
+   * data is not copied until run()
    */
-  LazyTensor(const Tensor &from) { target.copy(from); };
+  LazyTensor(const Tensor &from) : source(from){};
 
   /**
    * @brief     Wrapper method of add_i. see tensor.h for more detail
@@ -141,10 +147,72 @@ public:
    */
   Tensor run();
 
+  /**
+   * @brief execute the call_chain writing the result to output
+   * @param[out] output allocated tensor of the result dimension. It may be
+   * the chained tensor itself, which is then updated in place, but not one
+   * of the operands.
+   * @retval output
+   */
+  Tensor &run(Tensor &output);
+
 private:
-  /**< handle the data as a std::vector type */
-  std::vector<std::function<int(Tensor &)>> call_chain;
-  Tensor target;
+  /**
+   * @brief elementwise operation fused with its neighbours
+   */
+  struct ElementwiseOp {
+    /**
+     * @brief kind of the operation, subtraction is an addition
+     */
+    enum class Kind { ADD, MULTIPLY, DIVIDE };
+
+    Kind kind;             /**< kind of the operation */
+    const Tensor *operand; /**< tensor operand, nullptr for a scalar */
+    float value;           /**< scalar operand */
+    float alpha;           /**< multiplier of the tensor operand of ADD */
+
+    /**
+     * @brief apply the operation to t with the Tensor methods
+     * @retval status of the Tensor method
+     */
+    int apply(Tensor &t) const;
+  };
+
+  /**
+   * @brief group of fused elementwise operations or one other operation
+   */
+  struct Stage {
+    std::vector<ElementwiseOp> ops;    /**< fused operations */
+    std::function<int(Tensor &)> call; /**< other operation */
+  };
+
+  /**
+   * @brief run fused operations as one loop, out = ops(in)
+   * @param in FP32 tensor
+   * @param out allocated tensor of the dimension of in, may be in itself
+   * @retval false if the tensors cannot be fused, nothing is written then
+   */
+  static bool runFused(const Tensor &in, Tensor &out,
+                       const std::vector<ElementwiseOp> &ops);
+
+  /**
+   * @brief append an elementwise operation to the last fused group
+   */
+  LazyTensor &push(ElementwiseOp op);
+
+  /**
+   * @brief append an operation which is not fused
+   */
+  LazyTensor &push(std::function<int(Tensor &)> call);
+
+  /**
+   * @brief evaluate the stages
+   * @param output tensor to write the result to, nullptr to allocate one
+   */
+  Tensor evaluate(Tensor *output);
+
+  std::vector<Stage> call_chain; /**< stages to evaluate */
+  Tensor source;                 /**< chained tensor, shares its data */
 };
 
 } /* namespace nntrainer */
@@ -41,10 +41,12 @@
 #include <layer_normalization_layer.h>
 #include <loss/cross_entropy_sigmoid_loss_layer.h>
 #include <loss/cross_entropy_softmax_loss_layer.h>
+#include <loss/linear_cross_entropy_loss_layer.h>
 #include <loss/mse_loss_layer.h>
 #include <manager.h>
 #include <multiout_layer.h>
 #include <nntrainer_log.h>
+#include <optimal_fit_planner.h>
 #include <optimized_v1_planner.h>
 #include <optimized_v2_planner.h>
 #include <optimized_v3_planner.h>
@@ -155,6 +157,7 @@ void Manager::allocateWeights(unsigned int max_exec_order_, bool init) {
   if (!weight_pool.isAllocated()) {
     finalizeTensorPool(weight_pool, 0, max_exec_order_);
     weight_pool.allocate(init);
+    Weight::markUpdated();
   }
 }
 
@@ -624,6 +627,13 @@ Manager::requestInputs(const GraphNode &node,
     grad_common_spec.ls = TensorLifespan::CALC_GRAD_DERIV_LIFESPAN;
   }
 
+  /// the logits are recomputed from the input in both backward calls and the
+  /// input derivative is written by calcGradient when it runs
+  if (node.getType() == LinearCrossEntropyLossLayer::type) {
+    var_common_spec.ls = TensorLifespan::ITERATION_LIFESPAN;
+    grad_common_spec.ls = TensorLifespan::CALC_GRAD_DERIV_LIFESPAN;
+  }
+
   std::vector<Var_Grad *> ret;
   size_t current_size = inputs_v2.size();
 
@@ -912,6 +922,10 @@ void Manager::finalizeTensorPool(TensorPool &pool, unsigned int start,
     if (exec_mode == ExecutionMode::INFERENCE && enable_fsu) {
       //@todo change V3 and validate
       pool.finalize(OptimizedV1Planner(), start, end);
+    } else if (exec_mode == ExecutionMode::TRAIN && &pool == &tensor_pool &&
+               !enable_fsu) {
+      /** peak activation memory bounds the trainable batch size */
+      pool.finalize(OptimalFitPlanner(), start, end);
     } else {
       pool.finalize(OptimizedV1Planner(), start, end);
     }
@@ -146,7 +146,9 @@ public:
     fsu_lookahead(lookahead),
     tensor_format(tensor_format_),
     tensor_dtype(split(tensor_dtype_, getRegex("\\-"))),
-    exec_mode(exec_mode_) {}
+    exec_mode(exec_mode_) {
+    tensor_pool.setOffloadDevice(fsu_path, "activation_offload");
+  }
 
   /**
    * @brief Move Construct a new Manager object
@@ -303,6 +305,60 @@ public:
   bool isSecondLastAccess(const std::string &name, unsigned current_execution,
                           bool is_weight = false);
 
+  /**
+   * @brief make the tensor valid at the given order to be recomputed there
+   *
+   * @param name tensor name
+   * @param order execution order the tensor is recomputed at
+   * @param split drop the tensor between its forward uses and order
+   * @return true if the tensor is split
+   */
+  bool requestRecompute(const std::string &name, unsigned int order,
+                        bool split) {
+    return tensor_pool.requestRecompute(name, order, split);
+  }
+
+  /**
+   * @brief bind the tensors recomputed at the given order to their recompute
+   * memory
+   *
+   * @param order execution order given to requestRecompute()
+   */
+  void bindRecomputeMemory(unsigned int order) {
+    tensor_pool.bindRecomputeMemory(order);
+  }
+
+  /**
+   * @brief bind every recomputed or offloaded tensor back to its forward
+   * memory
+   */
+  void bindForwardMemory() { tensor_pool.bindForwardMemory(); }
+
+  /**
+   * @brief offload the tensor to the swap device till the given order
+   *
+   * @param name tensor name
+   * @param order execution order the tensor is read back at
+   * @return true if the tensor is offloaded
+   */
+  bool requestOffload(const std::string &name, unsigned int order) {
+    return tensor_pool.requestOffload(name, order);
+  }
+
+  /**
+   * @brief prepare the offloaded tensors before running the execution order
+   *
+   * @param order execution order to run
+   */
+  void offloadBefore(unsigned int order) { tensor_pool.offloadBefore(order); }
+
+  /**
+   * @brief write out the offloaded tensors after running the execution order
+   *
+   * @param order execution order just run
+   */
+  void offloadAfter(unsigned int order) { tensor_pool.offloadAfter(order); }
+
   /**
    * @brief   Check if the manager has allocated tensors
    *
@@ -390,6 +446,17 @@ public:
     tensor_pool.fillPlaceholder(name, t);
   }
 
+  /**
+   * @brief Bind a weight and its views to an external buffer
+   *
+   * @param name Name of the weight
+   * @param mem Buffer holding the weight
+   */
+  void bindWeightMemory(const std::string &name,
+                        std::shared_ptr<MemoryData> mem) {
+    weight_pool.bindMemory(name, mem);
+  }
+
   /**
    * @brief Get the tensor of the given name
    *
@@ -523,6 +590,11 @@ public:
     exec_mode = mode;
   };
 
+  /**
+   * @brief     return if the fsu is enabled
+   */
+  bool isFsuEnabled() const { return enable_fsu; }
+
   /**
    * @brief     return if it is mixed precsion
    */
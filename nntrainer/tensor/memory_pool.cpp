@@ -10,8 +10,11 @@
  * @brief  This is Memory Pool Class
  */
 
+#include <atomic>
 #include <cstdlib>
+#include <fstream>
 #include <limits>
+#include <sstream>
 
 #include <numeric>
 #include <vector>
@@ -50,6 +53,24 @@
 
 namespace nntrainer {
 
+namespace {
+
+constexpr const char *requests_file_header = "# nntrainer memory requests v1";
+
+/**
+ * @brief directory planLayout() writes every request set to, set by
+ * NNTR_MEMORY_REQUEST_DUMP. Empty if requests are not recorded.
+ */
+const std::string &requestDumpDir() {
+  static const std::string dir = [] {
+    const char *env = std::getenv("NNTR_MEMORY_REQUEST_DUMP");
+    return std::string(env != nullptr ? env : "");
+  }();
+  return dir;
+}
+
+} // namespace
+
 /**
  * @brief Request Memory from memory pool
  * @note start_time is inclusive, but end_time is exclusive
@@ -105,6 +126,13 @@ double MemoryPool::planLayout(const MemoryPlanner &planner) {
   if (min_pool_size == 0)
     min_pool_size = calcMinMemoryRequirement();
 
+  if (!requestDumpDir().empty()) {
+    static std::atomic<unsigned int> dump_count{0};
+    std::stringstream path;
+    path << requestDumpDir() << "/memory_requests_" << dump_count++ << ".txt";
+    saveRequests(path.str());
+  }
+
   pool_size = planner.planLayout(memory_size, memory_validity, memory_offset,
                                  memory_is_wgrad, n_wgrad);
   if (pool_size < min_pool_size || !validateLayout())
@@ -113,6 +141,55 @@ double MemoryPool::planLayout(const MemoryPlanner &planner) {
   return double(min_pool_size) / double(pool_size);
 }
 
+/**
+ * @brief Write the memory requests to a file
+ */
+void MemoryPool::saveRequests(const std::string &path) const {
+  std::ofstream file(path, std::ios::trunc);
+  NNTR_THROW_IF(!file.good(), std::invalid_argument)
+    << func_tag << "cannot open " << path << " to save memory requests";
+
+  file << requests_file_header << '\n'
+       << "# bytes start end is_wgrad\n";
+  for (unsigned int idx = 0; idx < memory_size.size(); idx++)
+    file << memory_size[idx] << ' ' << memory_validity[idx].first << ' '
+         << memory_validity[idx].second << ' ' << memory_is_wgrad[idx]
+         << '\n';
+
+  NNTR_THROW_IF(!file.good(), std::runtime_error)
+    << func_tag << "failed to write memory requests to " << path;
+}
+
+/**
+ * @brief Replace the memory requests with the ones from a file
+ */
+void MemoryPool::loadRequests(const std::string &path) {
+  std::ifstream file(path);
+  NNTR_THROW_IF(!file.good(), std::invalid_argument)
+    << func_tag << "cannot open " << path << " to load memory requests";
+
+  std::string line;
+  NNTR_THROW_IF(!std::getline(file, line) || line != requests_file_header,
+                std::invalid_argument)
+    << func_tag << path << " is not a memory request file";
+
+  clear();
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    std::istringstream ss(line);
+    size_t bytes;
+    unsigned int start, end;
+    bool is_wgrad;
+    NNTR_THROW_IF(!(ss >> bytes >> start >> end >> is_wgrad),
+                  std::invalid_argument)
+      << func_tag << "malformed memory request in " << path << ": " << line;
+    requestMemory(bytes, start, end, {}, TensorLifespan::MAX_LIFESPAN,
+                  is_wgrad);
+  }
+}
+
 /**
  * @brief Do the allocation of memory
  *
@@ -148,6 +148,25 @@ public:
    */
   double planLayout(const MemoryPlanner &planner);
 
+  /**
+   * @brief Write the memory requests to a file so that they can be replayed
+   * through other planners
+   *
+   * @param path file to write
+   *
+   * @details Only what planners see is written: size, validity and whether
+   * the request is a weight gradient.
+   */
+  void saveRequests(const std::string &path) const;
+
+  /**
+   * @brief Replace the memory requests with the ones written by
+   * saveRequests()
+   *
+   * @param path file to read
+   */
+  void loadRequests(const std::string &path);
+
   /**
    * @brief Do the allocation of memory
    *
@@ -0,0 +1,350 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   optimal_fit_planner.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  This is Optimal Fit Memory Planner
+ *
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <nntrainer_log.h>
+#include <optimal_fit_planner.h>
+#include <optimized_v1_planner.h>
+#include <optimized_v3_planner.h>
+
+namespace nntrainer {
+
+namespace {
+
+using Validity = std::vector<std::pair<unsigned int, unsigned int>>;
+
+/** upper bound of placement work spent on local search, in request pairs */
+constexpr uint64_t search_budget = 200'000'000;
+
+/** upper bound of local search steps */
+constexpr unsigned int max_search_steps = 64;
+
+/** cached layouts kept before the cache is flushed */
+constexpr size_t max_cached_layouts = 32;
+
+/**
+ * @brief cached result of a request set
+ */
+struct CachedLayout {
+  std::vector<size_t> size;
+  Validity validity;
+  std::vector<size_t> offset;
+  size_t pool_size;
+};
+
+std::mutex cache_mutex;
+std::unordered_multimap<uint64_t, CachedLayout> layout_cache;
+
+/**
+ * @brief FNV-1a hash of the request set
+ */
+uint64_t hashRequests(const std::vector<size_t> &memory_size,
+                      const Validity &memory_validity) {
+  uint64_t h = 1469598103934665603ULL;
+  auto mix = [&h](uint64_t v) {
+    for (unsigned int b = 0; b < 8; ++b) {
+      h ^= (v >> (b * 8)) & 0xff;
+      h *= 1099511628211ULL;
+    }
+  };
+
+  mix(memory_size.size());
+  for (size_t idx = 0; idx < memory_size.size(); ++idx) {
+    mix(memory_size[idx]);
+    mix(memory_validity[idx].first);
+    mix(memory_validity[idx].second);
+  }
+  return h;
+}
+
+/**
+ * @brief largest sum of sizes valid at the same time
+ */
+size_t lowerBound(const std::vector<size_t> &memory_size,
+                  const Validity &memory_validity) {
+  std::vector<std::pair<unsigned int, int64_t>> events;
+  events.reserve(memory_size.size() * 2);
+  for (size_t idx = 0; idx < memory_size.size(); ++idx) {
+    events.emplace_back(memory_validity[idx].first, memory_size[idx]);
+    events.emplace_back(memory_validity[idx].second,
+                        -static_cast<int64_t>(memory_size[idx]));
+  }
+  /** releases at a time come before the allocations at the same time */
+  std::sort(events.begin(), events.end());
+
+  int64_t live = 0, peak = 0;
+  for (auto const &e : events) {
+    live += e.second;
+    peak = std::max(peak, live);
+  }
+  return static_cast<size_t>(peak);
+}
+
+/**
+ * @brief check that no two requests valid at the same time overlap
+ */
+bool isValidLayout(const std::vector<size_t> &memory_size,
+                   const Validity &memory_validity,
+                   const std::vector<size_t> &memory_offset) {
+  if (memory_offset.size() != memory_size.size())
+    return false;
+
+  std::vector<unsigned int> order(memory_size.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+    return memory_offset[a] < memory_offset[b];
+  });
+
+  for (size_t i = 0; i < order.size(); ++i) {
+    const unsigned int a = order[i];
+    const size_t a_end = memory_offset[a] + memory_size[a];
+    for (size_t j = i + 1;
+         j < order.size() && memory_offset[order[j]] < a_end; ++j) {
+      const unsigned int b = order[j];
+      if (memory_validity[a].first < memory_validity[b].second &&
+          memory_validity[b].first < memory_validity[a].second)
+        return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief place requests in the given order, each at the smallest gap left by
+ * the already placed requests it overlaps in time
+ *
+ * @return size of the pool
+ */
+size_t placeBestFit(const std::vector<size_t> &memory_size,
+                    const Validity &memory_validity,
+                    const std::vector<unsigned int> &order,
+                    std::vector<size_t> &memory_offset) {
+  /** placed requests sorted by their offset */
+  std::vector<unsigned int> placed;
+  placed.reserve(order.size());
+  memory_offset.assign(memory_size.size(), 0);
+  size_t pool_size = 0;
+
+  for (unsigned int idx : order) {
+    const auto &valid = memory_validity[idx];
+    const size_t size = memory_size[idx];
+
+    size_t best_offset = 0, best_gap = std::numeric_limits<size_t>::max();
+    size_t bottom = 0;
+    for (unsigned int p : placed) {
+      const auto &p_valid = memory_validity[p];
+      if (p_valid.first >= valid.second || valid.first >= p_valid.second)
+        continue;
+
+      const size_t p_offset = memory_offset[p];
+      if (p_offset > bottom) {
+        const size_t gap = p_offset - bottom;
+        if (gap >= size && gap < best_gap) {
+          best_gap = gap;
+          best_offset = bottom;
+        }
+      }
+      bottom = std::max(bottom, p_offset + memory_size[p]);
+    }
+    if (best_gap == std::numeric_limits<size_t>::max())
+      best_offset = bottom;
+
+    memory_offset[idx] = best_offset;
+    pool_size = std::max(pool_size, best_offset + size);
+
+    auto pos = std::upper_bound(placed.begin(), placed.end(), best_offset,
+                                [&memory_offset](size_t off, unsigned int p) {
+                                  return off < memory_offset[p];
+                                });
+    placed.insert(pos, idx);
+  }
+
+  return pool_size;
+}
+
+/**
+ * @brief candidate orderings of the requests for the best fit placement
+ */
+std::vector<std::vector<unsigned int>>
+candidateOrders(const std::vector<size_t> &memory_size,
+                const Validity &memory_validity) {
+  std::vector<unsigned int> base(memory_size.size());
+  std::iota(base.begin(), base.end(), 0);
+
+  auto lifetime = [&memory_validity](unsigned int i) -> uint64_t {
+    return memory_validity[i].second - memory_validity[i].first;
+  };
+
+  std::vector<std::function<bool(unsigned int, unsigned int)>> comparators = {
+    /** largest first */
+    [&](unsigned int a, unsigned int b) {
+      return memory_size[a] > memory_size[b];
+    },
+    /** largest area in time and memory first */
+    [&](unsigned int a, unsigned int b) {
+      return lifetime(a) * memory_size[a] > lifetime(b) * memory_size[b];
+    },
+    /** longest living first */
+    [&](unsigned int a, unsigned int b) {
+      if (lifetime(a) == lifetime(b))
+        return memory_size[a] > memory_size[b];
+      return lifetime(a) > lifetime(b);
+    },
+    /** earliest first, longer living first among them */
+    [&](unsigned int a, unsigned int b) {
+      if (memory_validity[a].first == memory_validity[b].first)
+        return memory_validity[a].second > memory_validity[b].second;
+      return memory_validity[a].first < memory_validity[b].first;
+    },
+    /** latest ending first */
+    [&](unsigned int a, unsigned int b) {
+      if (memory_validity[a].second == memory_validity[b].second)
+        return memory_validity[a].first < memory_validity[b].first;
+      return memory_validity[a].second > memory_validity[b].second;
+    },
+  };
+
+  std::vector<std::vector<unsigned int>> orders;
+  for (auto &cmp : comparators) {
+    orders.push_back(base);
+    std::stable_sort(orders.back().begin(), orders.back().end(), cmp);
+  }
+  return orders;
+}
+
+} // namespace
+
+/**
+ * @copydoc MemoryPlanner::planLayout(
+ * const std::vector<size_t> &memory_size,
+ * const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+ * std::vector<size_t> &memory_offset,
+ * std::vector<bool> &memory_is_wgrad);
+ *
+ * @details The optimal fit memory planner places the requests with best fit
+ * for several orderings, refines the best ordering by swapping requests and
+ * keeps the smallest valid layout including the ones of the optimized v1 and
+ * v3 planners.
+ */
+size_t OptimalFitPlanner::planLayout(
+  const std::vector<size_t> &memory_size,
+  const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+  std::vector<size_t> &memory_offset, std::vector<bool> &memory_is_wgrad,
+  size_t n_wgrad) const {
+  if (memory_size.empty()) {
+    memory_offset.clear();
+    return 0;
+  }
+
+  const uint64_t hash = hashRequests(memory_size, memory_validity);
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto range = layout_cache.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second.size == memory_size &&
+          it->second.validity == memory_validity) {
+        memory_offset = it->second.offset;
+        return it->second.pool_size;
+      }
+    }
+  }
+
+  const size_t lower_bound = lowerBound(memory_size, memory_validity);
+  std::vector<size_t> best_offset;
+  size_t best_size = std::numeric_limits<size_t>::max();
+  auto consider = [&](size_t pool_size, std::vector<size_t> &offset) {
+    if (pool_size < best_size &&
+        isValidLayout(memory_size, memory_validity, offset)) {
+      best_size = pool_size;
+      best_offset.swap(offset);
+    }
+  };
+
+  std::vector<size_t> offset;
+  size_t pool_size = OptimizedV1Planner().planLayout(
+    memory_size, memory_validity, offset, memory_is_wgrad, n_wgrad);
+  consider(pool_size, offset);
+  pool_size = OptimizedV3Planner().planLayout(
+    memory_size, memory_validity, offset, memory_is_wgrad, n_wgrad);
+  consider(pool_size, offset);
+
+  /** best fit placement of every candidate ordering */
+  std::vector<unsigned int> best_order;
+  size_t best_order_size = std::numeric_limits<size_t>::max();
+  for (auto &order : candidateOrders(memory_size, memory_validity)) {
+    if (best_size == lower_bound)
+      break;
+    pool_size = placeBestFit(memory_size, memory_validity, order, offset);
+    if (pool_size < best_order_size) {
+      best_order_size = pool_size;
+      best_order = std::move(order);
+    }
+    consider(pool_size, offset);
+  }
+
+  /**
+   * local search: swap a request with a nearby one in the best ordering and
+   * keep the swap if the layout does not grow
+   */
+  const uint64_t n = memory_size.size();
+  const uint64_t steps =
+    (n < 2 || best_order.empty())
+      ? 0
+      : std::min<uint64_t>(max_search_steps, search_budget / (n * n));
+  std::mt19937 rng(static_cast<unsigned int>(hash));
+  for (uint64_t step = 0; step < steps && best_size > lower_bound; ++step) {
+    std::uniform_int_distribution<unsigned int> pick(0, n - 2);
+    const unsigned int i = pick(rng);
+    std::uniform_int_distribution<unsigned int> near(
+      i + 1, std::min<unsigned int>(n - 1, i + 8));
+    const unsigned int j = near(rng);
+
+    std::swap(best_order[i], best_order[j]);
+    pool_size = placeBestFit(memory_size, memory_validity, best_order, offset);
+    if (pool_size <= best_order_size) {
+      best_order_size = pool_size;
+      consider(pool_size, offset);
+    } else {
+      std::swap(best_order[i], best_order[j]);
+    }
+  }
+
+  ml_logd("optimal fit planner: %zu requests, pool %zu, lower bound %zu",
+          memory_size.size(), best_size, lower_bound);
+
+  memory_offset = best_offset;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (layout_cache.size() >= max_cached_layouts)
+      layout_cache.clear();
+    layout_cache.emplace(
+      hash, CachedLayout{memory_size, memory_validity, best_offset, best_size});
+  }
+  return best_size;
+}
+
+void OptimalFitPlanner::clearCache() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  layout_cache.clear();
+}
+
+} // namespace nntrainer
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   optimal_fit_planner.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  This is Optimal Fit Memory Planner
+ *
+ */
+
+#ifndef __OPTIMAL_FIT_PLANNER_H_
+#define __OPTIMAL_FIT_PLANNER_H_
+
+#include <vector>
+
+#include <memory_planner.h>
+
+namespace nntrainer {
+
+/**
+ * @class   OptimalFitPlanner
+ * @brief   Optimal Fit Memory Planner searches for the smallest layout among
+ * several placement orders
+ * @details Every request is placed at the best fitting gap left by the
+ * requests it overlaps in time. The placement is repeated for several
+ * orderings of the requests and refined by a bounded local search swapping
+ * requests in the best ordering. The layouts of the optimized v1 and v3
+ * planners compete as well, so the result is never larger than theirs. The
+ * search stops early when the theoretical lower bound is reached. Results are
+ * cached by a hash of the requests, so planning the same graph again is free.
+ */
+class OptimalFitPlanner : public MemoryPlanner {
+public:
+  /**
+   * @brief OptimalFitPlanner constructor
+   *
+   */
+  OptimalFitPlanner() = default;
+
+  /**
+   * @copydoc MemoryPlanner::planLayout(
+   * const std::vector<size_t> &memory_size,
+   * const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+   * std::vector<size_t> &memory_offset,
+   * std::vector<bool> &memory_is_wgrad);
+   *
+   */
+  size_t planLayout(
+    const std::vector<size_t> &memory_size,
+    const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+    std::vector<size_t> &memory_offset, std::vector<bool> &memory_is_wgrad,
+    size_t n_wgrad = 0) const;
+
+  /**
+   * @copydoc MemoryPlanner::getType() const
+   *
+   */
+  const std::string getType() const { return type; }
+
+  /**
+   * @brief drop every cached layout
+   */
+  static void clearCache();
+
+  static constexpr const char *type = "optimal_fit_planner";
+};
+
+} // namespace nntrainer
+
+#endif /** __OPTIMAL_FIT_PLANNER_H_ */
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   scratch_arena.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Per thread bump allocator for transient tensors of a layer call
+ */
+
+#include <algorithm>
+#include <cstdint>
+
+#include <nntrainer_error.h>
+#include <scratch_arena.h>
+
+namespace nntrainer {
+
+namespace {
+
+size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+ScratchArena::Scope::Scope(ScratchArena &arena_) :
+  arena(arena_),
+  marker{arena_.cur_block, arena_.cur_offset, arena_.stats.used_bytes} {
+  ++arena.depth;
+}
+
+ScratchArena::Scope::~Scope() {
+  arena.cur_block = marker.block;
+  arena.cur_offset = marker.offset;
+  arena.stats.used_bytes = marker.used;
+
+  if (--arena.depth == 0 && arena.blocks.size() > 1) {
+    /// one block of the peak size serves the next calls without growing
+    arena.blocks.clear();
+    arena.stats.reserved_bytes = 0;
+    arena.addBlock(arena.stats.peak_bytes);
+    arena.cur_block = 0;
+    arena.cur_offset = 0;
+  }
+}
+
+ScratchArena &ScratchArena::threadLocal() {
+  thread_local ScratchArena arena;
+  return arena;
+}
+
+void *ScratchArena::allocate(size_t bytes) {
+  NNTR_THROW_IF(depth == 0, std::runtime_error)
+    << "[ScratchArena] allocation outside of a scope";
+
+  bytes = alignUp(std::max<size_t>(bytes, 1), ALIGNMENT);
+  if (blocks.empty() || cur_offset + bytes > blocks[cur_block].bytes) {
+    size_t next = blocks.empty() ? 0 : cur_block + 1;
+    while (next < blocks.size() && blocks[next].bytes < bytes)
+      ++next;
+    if (next == blocks.size())
+      addBlock(std::max(bytes, stats.reserved_bytes));
+    cur_block = next;
+    cur_offset = 0;
+  }
+
+  void *ptr = blocks[cur_block].data + cur_offset;
+  cur_offset += bytes;
+  stats.used_bytes += bytes;
+  stats.peak_bytes = std::max(stats.peak_bytes, stats.used_bytes);
+  ++stats.num_allocations;
+  return ptr;
+}
+
+Tensor ScratchArena::getTensor(const TensorDim &dim) {
+  if (depth == 0) {
+    ++stats.num_unscoped;
+    return Tensor(dim, true);
+  }
+
+  const size_t bytes = dim.getDataLen() * dim.getDataTypeSize();
+  return Tensor::Map<char>(static_cast<char *>(allocate(bytes)), bytes, dim);
+}
+
+void ScratchArena::resetStats() {
+  stats.peak_bytes = stats.used_bytes;
+  stats.num_allocations = 0;
+  stats.num_blocks = 0;
+  stats.num_unscoped = 0;
+}
+
+void ScratchArena::addBlock(size_t bytes) {
+  bytes = alignUp(std::max(bytes, MIN_BLOCK_BYTES), ALIGNMENT);
+
+  Block block;
+  block.mem = std::unique_ptr<char[]>(new char[bytes + ALIGNMENT]);
+  block.data = reinterpret_cast<char *>(
+    alignUp(reinterpret_cast<uintptr_t>(block.mem.get()), ALIGNMENT));
+  block.bytes = bytes;
+  blocks.push_back(std::move(block));
+
+  stats.reserved_bytes += bytes;
+  ++stats.num_blocks;
+}
+
+} // namespace nntrainer
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   scratch_arena.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Per thread bump allocator for transient tensors of a layer call
+ */
+
+#ifndef __SCRATCH_ARENA_H__
+#define __SCRATCH_ARENA_H__
+#ifdef __cplusplus
+
+#include <memory>
+#include <vector>
+
+#include <tensor.h>
+#include <tensor_dim.h>
+
+namespace nntrainer {
+
+/**
+ * @brief ScratchArena hands out short lived memory by bumping an offset.
+ * @details Every allocation made while a Scope is alive is released at once
+ * when the Scope ends, scopes nest like a stack. Blocks are never moved, so
+ * scratch memory stays valid until its scope ends. When the outermost scope
+ * ends after the arena had to add a block, the blocks are replaced by one
+ * block of the peak size so that later calls do not reach the system
+ * allocator at all. The arena is not thread safe, every thread uses its own
+ * through threadLocal().
+ */
+class ScratchArena {
+public:
+  static constexpr size_t ALIGNMENT = 64; /**< alignment of allocations */
+  static constexpr size_t MIN_BLOCK_BYTES = 64 * 1024; /**< smallest block */
+
+  /**
+   * @brief usage statistics of an arena
+   */
+  struct Stats {
+    size_t used_bytes = 0;      /**< bytes handed out and not released */
+    size_t peak_bytes = 0;      /**< largest used_bytes seen */
+    size_t reserved_bytes = 0;  /**< bytes held by the blocks */
+    size_t num_allocations = 0; /**< allocations served from the blocks */
+    size_t num_blocks = 0;      /**< blocks taken from the system allocator */
+    size_t num_unscoped = 0; /**< tensors allocated normally, outside a scope */
+  };
+
+  /**
+   * @brief position of the arena a scope rewinds to
+   */
+  struct Marker {
+    size_t block;  /**< index of the current block */
+    size_t offset; /**< offset in the current block */
+    size_t used;   /**< used bytes */
+  };
+
+  /**
+   * @brief releases every allocation made during its lifetime
+   */
+  class Scope {
+  public:
+    /**
+     * @brief open a scope on the arena of the calling thread
+     */
+    explicit Scope(ScratchArena &arena_ = ScratchArena::threadLocal());
+
+    /**
+     * @brief rewind the arena to where the scope was opened
+     */
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    ScratchArena &arena;
+    Marker marker;
+  };
+
+  /**
+   * @brief Construct an empty arena, memory is reserved on first use
+   */
+  ScratchArena() = default;
+
+  ScratchArena(const ScratchArena &) = delete;
+  ScratchArena &operator=(const ScratchArena &) = delete;
+
+  /**
+   * @brief get the arena of the calling thread
+   */
+  static ScratchArena &threadLocal();
+
+  /**
+   * @brief allocate ALIGNMENT aligned memory valid until the current scope
+   * ends
+   *
+   * @param bytes number of bytes
+   * @return void* aligned memory
+   * @throws std::runtime_error if no scope is open
+   */
+  void *allocate(size_t bytes);
+
+  /**
+   * @brief get an uninitialized tensor valid until the current scope ends.
+   * Outside of a scope an ordinary tensor is allocated instead.
+   *
+   * @param dim dimension of the tensor
+   * @return Tensor tensor on the arena memory
+   */
+  Tensor getTensor(const TensorDim &dim);
+
+  /**
+   * @brief check if a scope is open on the arena
+   */
+  bool inScope() const { return depth > 0; }
+
+  /**
+   * @brief get usage statistics
+   */
+  const Stats &getStats() const { return stats; }
+
+  /**
+   * @brief restart the peak and the counters from the current usage
+   */
+  void resetStats();
+
+private:
+  /**
+   * @brief a block of memory from the system allocator
+   */
+  struct Block {
+    std::unique_ptr<char[]> mem; /**< owned memory */
+    char *data;                  /**< aligned start of the block */
+    size_t bytes;                /**< usable bytes from data */
+  };
+
+  std::vector<Block> blocks; /**< blocks, the ones after cur_block are free */
+  size_t cur_block = 0;      /**< block allocations are served from */
+  size_t cur_offset = 0;     /**< offset of the next allocation */
+  unsigned int depth = 0;    /**< number of open scopes */
+  Stats stats;               /**< usage statistics */
+
+  /**
+   * @brief append a block of at least bytes
+   */
+  void addBlock(size_t bytes);
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __SCRATCH_ARENA_H__ */
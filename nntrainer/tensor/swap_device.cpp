@@ -229,6 +229,44 @@ void SwapDevice::putBuffer(void *ptr, bool dealloc_only) {
 #endif
 }
 
+void SwapDevice::writeBuffer(off_t offset, const void *data, size_t size) {
+  NNTR_THROW_IF(fd <= 0, std::runtime_error)
+    << "SwapDevice: Device is not started";
+
+  std::lock_guard<std::mutex> lock(mutex);
+  off_t off = lseek(fd, offset, SEEK_SET);
+  NNTR_THROW_IF(off < 0, std::runtime_error)
+    << "SwapDevice: seek file: " << dev_path;
+
+  const char *ptr = static_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t len = write(fd, ptr, size);
+    NNTR_THROW_IF(len <= 0, std::runtime_error)
+      << "SwapDevice: write file: " << dev_path;
+    ptr += len;
+    size -= len;
+  }
+}
+
+void SwapDevice::readBuffer(off_t offset, void *data, size_t size) {
+  NNTR_THROW_IF(fd <= 0, std::runtime_error)
+    << "SwapDevice: Device is not started";
+
+  std::lock_guard<std::mutex> lock(mutex);
+  off_t off = lseek(fd, offset, SEEK_SET);
+  NNTR_THROW_IF(off < 0, std::runtime_error)
+    << "SwapDevice: seek file: " << dev_path;
+
+  char *ptr = static_cast<char *>(data);
+  while (size > 0) {
+    ssize_t len = read(fd, ptr, size);
+    NNTR_THROW_IF(len <= 0, std::runtime_error)
+      << "SwapDevice: read file: " << dev_path;
+    ptr += len;
+    size -= len;
+  }
+}
+
 /**
  * @brief Close device
  *
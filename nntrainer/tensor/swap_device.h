@@ -105,6 +105,24 @@ public:
    */
   void putBuffer(void *ptr, bool dealloc_only = false);
 
+  /**
+   * @brief Write data to the device
+   *
+   * @param offset offset of swap device file to write at
+   * @param data data to write
+   * @param size size of the data
+   */
+  void writeBuffer(off_t offset, const void *data, size_t size);
+
+  /**
+   * @brief Read data from the device
+   *
+   * @param offset offset of swap device file to read from
+   * @param data memory to read into
+   * @param size size of the data
+   */
+  void readBuffer(off_t offset, void *data, size_t size);
+
   /**
    * @brief Close device
    *
@@ -39,6 +39,8 @@ using TaskCallback = std::function<void(void *)>;
 /**
  * @class TaskExecutor Class
  * @brief This is load / unload Task Executor with thread pool
+ * @note The tasks block on file I/O, so they run on threads owned by the
+ * executor instead of the ThreadRuntime compute workers.
  *
  */
 class TaskExecutor {
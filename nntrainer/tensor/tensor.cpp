@@ -20,8 +20,10 @@
 #include <q6_k_tensor.h>
 #include <short_tensor.h>
 #include <tensor.h>
+#include <thread_runtime.h>
 #include <uint4_tensor.h>
 #include <uint_tensor.h>
+#include <util_func.h>
 
 #ifdef ENABLE_FP16
 #include <half_tensor.h>
@@ -726,8 +728,8 @@ Tensor Tensor::sum(unsigned int axis, float alpha) const {
 
 Tensor &Tensor::sum(unsigned int axis, Tensor &output, float alpha,
                     float beta) const {
-  NNTR_THROW_IF(!getContiguous(), std::invalid_argument)
-    << getName() << " is not contiguous, cannot sum";
+  if (!getContiguous())
+    return clone().sum(axis, output, alpha, beta);
 
   itensor_->sum(axis, output, alpha, beta);
   return output;
@@ -967,12 +969,8 @@ void Tensor::standardization_i() {
 
   /// @todo remove conditional statement
   if (getDataType() == ml::train::TensorDim::DataType::FP32) {
-    float *std_dev = std_dev_by_batch.getData<float>();
-
-    for (unsigned int k = 0; k < batch(); ++k) {
-      Tensor sub_this = this->getBatchSlice(k, 1);
-      std_dev[k] = sub_this.l2norm();
-    }
+    reduce_l2norm(batch(), getDim().getFeatureLen(), 1, getData<float>(),
+                  std_dev_by_batch.getData<float>());
   } else if (getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
     _FP16 *std_dev = std_dev_by_batch.getData<_FP16>();
@@ -1013,7 +1011,9 @@ Tensor Tensor::dot(Tensor const &input, bool trans, bool trans_in) const {
  */
 Tensor &Tensor::dot(Tensor const &input, Tensor &output, bool trans,
                     bool trans_in, float beta) const {
-  NNTR_THROW_IF(!getContiguous(), std::invalid_argument)
+  /// FP32 reads strided views through the leading dimensions of gemm
+  NNTR_THROW_IF(!getContiguous() && getDataType() != Tdatatype::FP32,
+                std::invalid_argument)
     << getName() << " is not contiguous. Cannot dot product.";
 
   itensor_->dot(input, output, trans, trans_in, beta);
@@ -1065,13 +1065,65 @@ Tensor &Tensor::dotBatched(Tensor const &m, Tensor &result, bool trans,
     << "The batch size of the given twon tensors must be the same"
        "or the bigger one should be a multiple of the smaller one";
 
+  const bool per_channel = (channel() > 1 && m.channel() > 1) ||
+                           !getContiguous() || !m.getContiguous() ||
+                           !result.getContiguous();
+  if (!per_channel) {
+    for (unsigned int b = 0; b < lcm; b++) {
+      /** @todo try using transpose to speedup the operation */
+      const Tensor this_b = this->getBatchSlice(b / group_size, 1);
+      Tensor m_b = m.getBatchSlice(b / m_group_size, 1);
+      Tensor result_b = result.getBatchSlice(b, 1);
+
+      this_b.dot(m_b, result_b, trans, trans_m, beta);
+    }
+    return result;
+  }
+
+  /// a strided channel can not be flattened into the rows of a matrix, so
+  /// every (batch, channel) matrix is multiplied on its own
+  NNTR_THROW_IF(getFormat() != Tformat::NCHW ||
+                  (m.channel() != 1 && m.channel() != channel()) ||
+                  result.channel() != channel(),
+                std::invalid_argument)
+    << "dotBatched over channels needs NCHW tensors of the same channel";
+
+  auto matrix = [](const Tensor &t, unsigned int b, unsigned int c) {
+    TensorDim dim_ = t.getDim();
+    dim_.batch(1);
+    dim_.channel(1);
+    const std::array<size_t, TensorDim::MAXDIM> strides = t.getStrides();
+    return t.getStridedView(dim_, b * strides[0] + c * strides[1], strides);
+  };
+
+  /// only FP32 reads strided matrices in place, other types use dense copies
+  const bool in_place = getDataType() == Tdatatype::FP32 &&
+                        m.getDataType() == Tdatatype::FP32 &&
+                        result.getDataType() == Tdatatype::FP32;
+  auto dense = [](const Tensor &t) {
+    if (t.getContiguous())
+      return t;
+    Tensor d(t.getDim(), true);
+    d.copy_with_stride(t);
+    return d;
+  };
+
   for (unsigned int b = 0; b < lcm; b++) {
-    /** @todo try using transpose to speedup the operation */
-    const Tensor this_b = this->getBatchSlice(b / group_size, 1);
-    Tensor m_b = m.getBatchSlice(b / m_group_size, 1);
-    Tensor result_b = result.getBatchSlice(b, 1);
+    for (unsigned int c = 0; c < channel(); c++) {
+      const Tensor this_b = matrix(*this, b / group_size, c);
+      const Tensor m_b = matrix(m, b / m_group_size, m.channel() > 1 ? c : 0);
+      Tensor result_b = matrix(result, b, c);
+
+      if (in_place) {
+        this_b.dot(m_b, result_b, trans, trans_m, beta);
+        continue;
+      }
 
-    this_b.dot(m_b, result_b, trans, trans_m, beta);
+      Tensor result_dense = dense(result_b);
+      dense(this_b).dot(dense(m_b), result_dense, trans, trans_m, beta);
+      if (!result_b.getContiguous())
+        result_b.copy_with_stride(result_dense);
+    }
   }
 
   return result;
@@ -1245,9 +1297,19 @@ const std::shared_ptr<MemoryData> Tensor::getMemoryData() const {
 size_t Tensor::getOffset() const { return itensor_->getOffset(); }
 
 void Tensor::copy(const Tensor &from) {
-  /// @todo enable copy to non-contiguous tensor
   if (!itensor_->getContiguous() || !from.getContiguous()) {
-    throw std::runtime_error("Cannot copy non-contiguous tensor");
+    /// FP32 views are copied along their strides
+    NNTR_THROW_IF(getDataType() != Tdatatype::FP32 ||
+                    from.getDataType() != Tdatatype::FP32 ||
+                    (!itensor_->getContiguous() && getDim() != from.getDim()),
+                  std::runtime_error)
+      << "Cannot copy non-contiguous tensor";
+
+    if (itensor_->getContiguous() && from.size() != 0 &&
+        size() == from.size())
+      reshape(from.getDim());
+    copy_with_stride(from);
+    return;
   }
 
   if (from.size() != 0 && size() == from.size() &&
@@ -1280,6 +1342,9 @@ Tensor Tensor::getBatchSlice(size_t offset, unsigned int size) const {
   TensorDim dim_ = getDim();
   dim_.batch(size);
 
+  if (!getContiguous())
+    return getStridedView(dim_, offset * getStrides()[0], getStrides());
+
   return getSharedDataTensor(dim_, offset * this->getDim().getFeatureLen(),
                              true, "");
 }
@@ -1323,25 +1388,24 @@ Tensor Tensor::getBatchSlice(const std::vector<unsigned int> &indices) const {
   unsigned char *dst_data =
     static_cast<unsigned char *>(output.getData<void>());
 
-// Parallel copy using OpenMP
-#pragma omp parallel for schedule(static)
-  for (int i = 0; i < static_cast<int>(indices.size()); ++i) {
-    const unsigned batch_idx = indices[i];
+  ThreadRuntime::Global().parallel_for(
+    0, static_cast<unsigned int>(indices.size()), [&](unsigned int i) {
+      const unsigned batch_idx = indices[i];
 
-    // Calculate memory offsets
-    const size_t src_offset =
-      static_cast<size_t>(batch_idx) * single_batch_bytes;
-    const size_t dst_offset = static_cast<size_t>(i) * single_batch_bytes;
+      // Calculate memory offsets
+      const size_t src_offset =
+        static_cast<size_t>(batch_idx) * single_batch_bytes;
+      const size_t dst_offset = static_cast<size_t>(i) * single_batch_bytes;
 
-    // Bounds check for destination buffer
-    NNTR_THROW_IF(dst_offset + single_batch_bytes > output_bytes,
-                  std::runtime_error)
-      << "Destination buffer overflow detected";
+      // Bounds check for destination buffer
+      NNTR_THROW_IF(dst_offset + single_batch_bytes > output_bytes,
+                    std::runtime_error)
+        << "Destination buffer overflow detected";
 
-    // Perform memory copy
-    std::memcpy(dst_data + dst_offset, src_data + src_offset,
-                single_batch_bytes);
-  }
+      // Perform memory copy
+      std::memcpy(dst_data + dst_offset, src_data + src_offset,
+                  single_batch_bytes);
+    });
 
   return output;
 }
@@ -1606,6 +1670,44 @@ Tensor Tensor::getSharedDataTensor(const TensorDim dim_, size_t offset,
   return ret;
 }
 
+Tensor Tensor::getStridedView(
+  const TensorDim &dim_, size_t offset,
+  const std::array<size_t, TensorDim::MAXDIM> &strides_,
+  const std::string &name_) const {
+  Tensor ret = *this;
+  itensor_->getStridedView(dim_, offset, strides_, name_, ret.itensor_.get());
+  return ret;
+}
+
+Tensor Tensor::getTransposedView(const std::string &direction) const {
+  int dirs[TensorDim::MAXDIM - 1];
+  int status = getValues(TensorDim::MAXDIM - 1, direction, dirs);
+  unsigned int seen = 0;
+  for (int d : dirs)
+    seen |= (status == ML_ERROR_NONE && d >= 0 && d < 3) ? 1u << d : 0u;
+  NNTR_THROW_IF(seen != 0b111, std::invalid_argument)
+    << "[Tensor::getTransposedView] invalid direction " << direction;
+
+  /// strides are kept in memory order, permute them per logical axis
+  const std::array<size_t, TensorDim::MAXDIM> memory_axes =
+    getFormat() == Tformat::NCHW
+      ? std::array<size_t, TensorDim::MAXDIM>{0, 1, 2, 3}
+      : std::array<size_t, TensorDim::MAXDIM>{0, 2, 3, 1};
+  const std::array<size_t, TensorDim::MAXDIM> axes = {
+    0, (size_t)dirs[0] + 1, (size_t)dirs[1] + 1, (size_t)dirs[2] + 1};
+  const std::array<size_t, TensorDim::MAXDIM> strides = getStrides();
+
+  std::array<size_t, TensorDim::MAXDIM> axis_strides;
+  for (unsigned int i = 0; i < TensorDim::MAXDIM; ++i)
+    axis_strides[memory_axes[i]] = strides[i];
+
+  std::array<size_t, TensorDim::MAXDIM> view_strides;
+  for (unsigned int i = 0; i < TensorDim::MAXDIM; ++i)
+    view_strides[i] = axis_strides[axes[memory_axes[i]]];
+
+  return getStridedView(getDim().transpose(axes), 0, view_strides);
+}
+
 void Tensor::activate() {
 
   NNTR_THROW_IF(!is_virtual, std::invalid_argument)
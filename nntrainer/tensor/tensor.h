@@ -1402,7 +1402,9 @@ public:
               bool trans_in, float beta) const
    * @details performs dot operation over a batch of inputs. If the batch sizes
    of the given two tensors are different, the bigger one should be a multiple
-   of the smaller one.
+   of the smaller one. If both tensors have more than one channel or any of
+   the tensors is a strided view, the channel is a batch axis as well and
+   every (batch, channel) matrix is multiplied on its own.
    */
   Tensor &dotBatched(Tensor const &input, Tensor &result, bool trans = false,
                      bool trans_in = false, float beta = 0.0f) const;
@@ -1955,6 +1957,30 @@ public:
                              bool reset_stride = true,
                              const std::string &name_ = "") const;
 
+  /**
+   * @brief Get new tensor which views the memory of current tensor through
+   * the given strides
+   *
+   * @param dim_ dimension of the view
+   * @param offset offset to be used from the start of the data in elements
+   * @param strides_ strides of the view in the memory order of its format
+   * @param name_ name of the view
+   * @note The view is not contiguous unless the strides are the ones of a
+   * dense tensor of dim_. Slicing and permuting through views does not copy.
+   */
+  Tensor getStridedView(const TensorDim &dim_, size_t offset,
+                        const std::array<size_t, TensorDim::MAXDIM> &strides_,
+                        const std::string &name_ = "") const;
+
+  /**
+   * @brief Get view of the transposed tensor
+   *
+   * @param direction to transpose ex) 0:2:1
+   * @note This is the zero-copy counterpart of transpose(), the view walks
+   * the memory of current tensor with permuted strides.
+   */
+  Tensor getTransposedView(const std::string &direction) const;
+
   /**
    * @brief    Swaps Tensor lhs and rhs
    * @param[in] lhs Tensor to be swapped
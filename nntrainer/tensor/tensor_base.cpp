@@ -235,15 +235,58 @@ void TensorBase::getSharedDataTensor(const TensorDim dim_, size_t offset,
   createSharedDataTensor(this, ret, offset);
 }
 
-TensorBase::BroadcastInfo
-TensorBase::computeBroadcastInfo(const Tensor &m) const {
+void TensorBase::getStridedView(
+  const TensorDim dim_, size_t offset,
+  const std::array<size_t, TensorDim::MAXDIM> &strides_,
+  const std::string &name_, TensorBase *ret) {
+  NNTR_THROW_IF(dim_.getFormat() != ret->dim.getFormat(),
+                std::invalid_argument)
+    << "Tensor format does not match";
+
+  const std::array<size_t, TensorDim::MAXDIM> memory_axes =
+    dim_.getFormat() == Tformat::NCHW
+      ? std::array<size_t, TensorDim::MAXDIM>{0, 1, 2, 3}
+      : std::array<size_t, TensorDim::MAXDIM>{0, 2, 3, 1};
+
+  /// the last element each tensor reaches through its strides
+  auto last_index = [&memory_axes](
+                      const TensorDim &d,
+                      const std::array<size_t, TensorDim::MAXDIM> &s) {
+    size_t index = 0;
+    for (unsigned int i = 0; i < TensorDim::MAXDIM; ++i)
+      index += (d.getTensorDim(memory_axes[i]) - 1) * s[i];
+    return index;
+  };
+
+  NNTR_THROW_IF(dim_.getDataLen() == 0 ||
+                  offset + last_index(dim_, strides_) >
+                    last_index(dim, strides),
+                std::invalid_argument)
+    << "Creating strided view beyond the tensor memory.";
+
+  ret->dim = dim_;
+  ret->strides = strides_;
+  /// the stride of an axis of size one is never used
+  const std::array<size_t, TensorDim::MAXDIM> dense = dim_.computeStrides();
+  ret->contiguous = true;
+  for (unsigned int i = 0; i < TensorDim::MAXDIM; ++i)
+    if (dim_.getTensorDim(memory_axes[i]) > 1 && strides_[i] != dense[i])
+      ret->contiguous = false;
+  if (ret->contiguous)
+    ret->strides = dense;
+  if (!name_.empty())
+    ret->name = name_;
+
+  createSharedDataTensor(this, ret, offset);
+}
+
+TensorBase::BroadcastLoop
+TensorBase::computeBroadcastLoop(const Tensor &m) const {
   if (m.size() > this->size())
     throw exception::not_supported("broadcasting *this is not supported");
 
   const TensorDim m_dim = m.getDim();
-
-  BroadcastInfo e;
-  e.tensor_type = getTensorType();
+  const std::array<size_t, TensorDim::MAXDIM> m_strides = m.getStrides();
 
   unsigned int continuity[4] = {0, 1, 2, 3};
   if (getFormat() == Tformat::NHWC) {
@@ -252,65 +295,61 @@ TensorBase::computeBroadcastInfo(const Tensor &m) const {
     continuity[3] = 1;
   }
 
-  /// checking if given Tensor's can be broadcasted
+  BroadcastLoop loop;
   for (unsigned int i = 0; i < TensorDim::MAXDIM; ++i) {
-    if (dim.getTensorDim(continuity[i]) == m_dim.getTensorDim(continuity[i])) {
-      e.strides[i] = m.getStrides()[i];
-      continue;
+    const size_t size = dim.getTensorDim(continuity[i]);
+    size_t m_stride = m_strides[i];
+
+    /// If given dimension is 1, it could be reused, the stride being 0
+    if (m_dim.getTensorDim(continuity[i]) != size) {
+      if (m_dim.getTensorDim(continuity[i]) != 1) {
+        std::stringstream ss;
+        ss << "[computeBroadcastLoop] broadcasting only allowed for "
+              "dimension value of 1 \n"
+           << "this: " << dim << "target: " << m_dim;
+        throw std::invalid_argument(ss.str().c_str());
+      }
+      m_stride = 0;
     }
 
-    /// If given dimension is 1, it could be reused, the stride remaining 0
-    /// Need to check if dim[i] == 1 && m_dim[i] == 1 first though
-    /// If so, strides should not change
-    if (m_dim.getTensorDim(continuity[i]) == 1) {
+    if (size == 1)
       continue;
-    }
-
-    std::stringstream ss;
-    ss << "[computeBroadcastInfo] broadcasting only allowed for "
-          "dimension value of 1 \n"
-       << "this: " << dim << "target: " << m_dim;
-    throw std::invalid_argument(ss.str().c_str());
-  }
 
-  /// calculate inner loop size
-  e.buffer_size = 1;
-  e.buffer_axis = -1;
-  e.strides[3] = m.getStrides()[3];
-
-  /// initiate buffer info with matching dimension strategy
-  for (int axis = 3; axis >= 0; --axis) {
-    if (dim.getTensorDim(continuity[axis]) !=
-        m_dim.getTensorDim(continuity[axis])) {
-      e.buffer_axis = axis;
-      break;
+    /// merge the axis into the outer one if both tensors walk them in a row
+    if (loop.rank > 0) {
+      const unsigned int last = loop.rank - 1;
+      if (loop.strides[last] == size * strides[i] &&
+          loop.m_strides[last] == size * m_stride) {
+        loop.sizes[last] *= size;
+        loop.strides[last] = strides[i];
+        loop.m_strides[last] = m_stride;
+        continue;
+      }
     }
 
-    e.buffer_size *= dim.getTensorDim(continuity[axis]);
+    loop.sizes[loop.rank] = size;
+    loop.strides[loop.rank] = strides[i];
+    loop.m_strides[loop.rank] = m_stride;
+    ++loop.rank;
   }
 
-  /// check strategy that uses consecutive ones
-  if (m_dim.getTensorDim(continuity[3]) == 1) {
-    unsigned int inner_loop_size = 1;
-    int axis;
-    for (axis = 3; axis >= 0; --axis) {
-      if (m_dim.getTensorDim(continuity[axis]) != 1) {
-        break;
-      }
-
-      inner_loop_size *= dim.getTensorDim(continuity[axis]);
-    }
-
-    /// if consecutive-one strategy has bigger chunk size, replace the
-    /// information
-    if (inner_loop_size > e.buffer_size) {
-      e.buffer_axis = axis;
-      e.buffer_size = inner_loop_size;
-      e.strides[3] = 0;
-    }
+  if (loop.rank == 0) {
+    loop.rank = 1;
+    loop.sizes[0] = 1;
+    loop.strides[0] = 1;
   }
 
-  return e;
+  const unsigned int inner = loop.rank - 1;
+  if (loop.rank == 1)
+    loop.kind = BroadcastLoop::Kind::FLAT;
+  else if (loop.rank == 2 && loop.m_strides[0] == 0)
+    loop.kind = BroadcastLoop::Kind::ROW;
+  else if (loop.rank == 2 && loop.m_strides[inner] == 0)
+    loop.kind = BroadcastLoop::Kind::COLUMN;
+  else
+    loop.kind = BroadcastLoop::Kind::GENERAL;
+
+  return loop;
 }
 
 void TensorBase::calculateFlattenDot(
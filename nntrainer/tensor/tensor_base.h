@@ -13,6 +13,7 @@
 #define __TENSOR_BASE_H__
 #ifdef __cplusplus
 
+#include <array>
 #include <memory>
 #include <stdexcept>
 
@@ -847,6 +848,22 @@ public:
                            bool reset_stride, const std::string &name_,
                            TensorBase *ret);
 
+  /**
+   * @brief Get new tensor which views the memory of current tensor through
+   * the given strides
+   *
+   * @param[in] dim_ dimension of the view
+   * @param[in] offset offset to be used from the start of the data in elements
+   * @param[in] strides_ strides of the view in the memory order of its format
+   * @param[in] name_ name of the Tensor
+   * @param[out] ret output TensorBase pointer
+   * @note Every element the view reaches must lie in the memory of current
+   * tensor.
+   */
+  void getStridedView(const TensorDim dim_, size_t offset,
+                      const std::array<size_t, TensorDim::MAXDIM> &strides_,
+                      const std::string &name_, TensorBase *ret);
+
   /**
    * @copydoc Tensor::isValid()
    */
@@ -873,38 +890,109 @@ protected:
   std::shared_ptr<SrcSharedTensorBase> src_tensor;
 
   /**
-   * @struct External Loop Info for broadcasted info
-   * @brief External Loop Info for broadcasted iteration. Please refer to
-   * DISABLED_private_external_loop_n in unittest_nntrainer_tensor.
-   * @note This should better be implemented in iterator fashion before used
-   * extensively.
+   * @struct BroadcastLoop
+   * @brief Loop of a broadcast operation over this tensor and an operand.
+   * Neighbouring axes which both tensors walk contiguously are merged, so the
+   * innermost axis is the longest run a kernel can process at once.
    */
-  struct BroadcastInfo {
-
+  struct BroadcastLoop {
     /**
-     * @brief Construct a new External Loop Info object
+     * @brief shape of the loop which selects how it is run
      */
-    BroadcastInfo() :
-      buffer_size(0),
-      buffer_axis(-1),
-      strides{0, 0, 0, 0},
-      tensor_type({Tformat::NCHW, Tdatatype::FP32}) {}
-
-    unsigned int buffer_size; /**< virtual size of the buffer */
-    int buffer_axis;          /**< the smallest axis that should be looped.
-                                   -1 means no loop needed*/
-    std::array<unsigned int, TensorDim::MAXDIM>
-      strides; /**< modified strides for the loop */
-    nntrainer::TensorDim::TensorType tensor_type;
+    enum class Kind {
+      FLAT,    /**< one run, the operand is a scalar or of the same shape */
+      ROW,     /**< the operand is a row repeated along the outer axis */
+      COLUMN,  /**< the operand is constant along every run */
+      GENERAL, /**< any other broadcast */
+    };
+
+    Kind kind = Kind::FLAT; /**< shape of the loop */
+    unsigned int rank = 0;  /**< number of merged axes */
+    std::array<size_t, TensorDim::MAXDIM>
+      sizes{}; /**< size of the merged axes, the innermost is the last */
+    std::array<size_t, TensorDim::MAXDIM>
+      strides{}; /**< strides of this tensor and the output */
+    std::array<size_t, TensorDim::MAXDIM>
+      m_strides{}; /**< strides of the operand, 0 where it is broadcast */
   };
 
   /**
-   * @brief compute Loop info for broadcasting and vectorization
+   * @brief runs shorter than this are computed in place of a kernel call
+   */
+  static constexpr size_t BROADCAST_MIN_KERNEL_RUN = 16;
+
+  /**
+   * @brief compute the loop broadcasting m against this tensor
    *
    * @param m target tensor to be calculated against.
-   * @return BroadcastInfo Loopinfo needed to run external loop
+   * @return BroadcastLoop merged axes and strides of the loop
+   * @throw std::invalid_argument if m cannot be broadcast
    */
-  BroadcastInfo computeBroadcastInfo(const Tensor &m) const;
+  BroadcastLoop computeBroadcastLoop(const Tensor &m) const;
+
+  /**
+   * @brief run a broadcast loop without recursion
+   *
+   * @param loop loop computed by computeBroadcastLoop()
+   * @param x data of this tensor
+   * @param y data of the operand
+   * @param z data of the output
+   * @param kernel vectorized function of a run,
+   * void(n, x, y, z, y_stride, stride)
+   * @param op element function of a short run, z = op(x, y, z)
+   */
+  template <typename T, typename Kernel, typename Op>
+  static void runBroadcastLoop(const BroadcastLoop &loop, const T *x,
+                               const T *y, T *z, Kernel &&kernel, Op &&op) {
+    const unsigned int inner = loop.rank - 1;
+    const unsigned int n = loop.sizes[inner];
+    const unsigned int stride = loop.strides[inner];
+    const unsigned int y_stride = loop.m_strides[inner];
+
+    auto run = [&](size_t offset, size_t m_offset) {
+      const T *xr = x + offset;
+      const T *yr = y + m_offset;
+      T *zr = z + offset;
+      if (n >= BROADCAST_MIN_KERNEL_RUN) {
+        kernel(n, xr, yr, zr, y_stride, stride);
+        return;
+      }
+      for (unsigned int i = 0; i < n; ++i)
+        zr[i * stride] = op(xr[i * stride], yr[i * y_stride], zr[i * stride]);
+    };
+
+    switch (loop.kind) {
+    case BroadcastLoop::Kind::FLAT:
+      kernel(n, x, y, z, y_stride, stride);
+      return;
+    case BroadcastLoop::Kind::ROW:
+    case BroadcastLoop::Kind::COLUMN:
+      for (size_t r = 0; r < loop.sizes[0]; ++r)
+        run(r * loop.strides[0], r * loop.m_strides[0]);
+      return;
+    case BroadcastLoop::Kind::GENERAL:
+      break;
+    }
+
+    size_t runs = 1;
+    for (unsigned int a = 0; a < inner; ++a)
+      runs *= loop.sizes[a];
+
+    std::array<size_t, TensorDim::MAXDIM> idx{};
+    size_t offset = 0, m_offset = 0;
+    for (size_t r = 0; r < runs; ++r) {
+      run(offset, m_offset);
+      for (unsigned int a = inner; a-- > 0;) {
+        offset += loop.strides[a];
+        m_offset += loop.m_strides[a];
+        if (++idx[a] < loop.sizes[a])
+          break;
+        offset -= loop.sizes[a] * loop.strides[a];
+        m_offset -= loop.sizes[a] * loop.m_strides[a];
+        idx[a] = 0;
+      }
+    }
+  }
 
   /**
    * @brief Calcuates variables needed to perform tensor flatten dot product
@@ -118,6 +118,7 @@ Tensor *TensorPool::view(const std::string &name, const std::string &reference,
 void TensorPool::finalize(const MemoryPlanner &planner,
                           unsigned int start_order, unsigned int end_order) {
   mem_pool->clear();
+  offloaded.clear();
   unsigned int bytes_requested = 0;
   /** if execution order is PERSIST_END_ORDER, then we think it has another
    * execution order for gradient clipping
@@ -133,6 +134,51 @@ void TensorPool::finalize(const MemoryPlanner &planner,
       continue;
     }
     details->token = 0;
+    details->split_token = 0;
+
+    /**
+     * a tensor recomputed or offloaded in backwarding is used before its split
+     * order and again from there on, so it takes two requests and its memory
+     * can be reused in between. An offloaded tensor keeps its forward memory
+     * one more order to be written out.
+     */
+    const unsigned int split_order = details->recompute_order
+                                       ? details->recompute_order
+                                       : details->offload_order;
+    if (split_order != 0 && !isTensorLongTerm(details->lifespan)) {
+      unsigned int forward_start = split_order;
+      unsigned int forward_end = start_order;
+      unsigned int first_use = std::numeric_limits<unsigned int>::max();
+      unsigned int split_end = split_order;
+      for (auto order : details->exec_order) {
+        if (order < split_order) {
+          forward_start = std::min(forward_start, order);
+          forward_end = std::max(forward_end, order);
+        } else if (order <= end_order) {
+          first_use = std::min(first_use, order);
+          split_end = std::max(split_end, order);
+        }
+      }
+      const unsigned int forward_valid_end =
+        details->recompute_order ? forward_end + 1 : forward_end + 2;
+
+      if (forward_start >= start_order && forward_start < split_order &&
+          forward_valid_end <= split_order && split_order <= end_order) {
+        details->token = mem_pool->requestMemory(
+          spec.tensor->getMemoryBytes(), forward_start, forward_valid_end,
+          details->exec_order, details->lifespan, spec.is_weight_grad);
+        details->split_token = mem_pool->requestMemory(
+          spec.tensor->getMemoryBytes(), split_order, split_end + 1,
+          details->exec_order, details->lifespan, spec.is_weight_grad);
+        bytes_requested += 2 * spec.tensor->getMemoryBytes();
+
+        if (details->offload_order != 0)
+          offloaded.push_back({static_cast<unsigned int>(&spec - pool.data()),
+                               forward_end, std::min(first_use, split_end),
+                               0, -1, false, nullptr});
+        continue;
+      }
+    }
 
     /**
      * 1. create the validity ranges for the all the requested tensors.
@@ -238,6 +284,23 @@ void TensorPool::allocate(bool init) {
   if (cache_loader) {
     cache_loader->init();
   }
+
+  if (!offloaded.empty() && !offload_device) {
+    size_t offload_bytes = 0;
+    for (auto &offload : offloaded) {
+      offload.offset = offload_bytes;
+      offload_bytes += pool[offload.spec_idx].tensor->getMemoryBytes();
+    }
+
+    offload_device = offload_path.empty()
+                       ? std::make_unique<SwapDevice>(offload_name)
+                       : std::make_unique<SwapDevice>(offload_path,
+                                                      offload_name);
+    offload_device->start(offload_bytes);
+    offload_executor = std::make_unique<TaskExecutor>("OffloadPool", 2);
+    ml_logi("%zu tensors of %zu bytes are offloaded to %s", offloaded.size(),
+            offload_bytes, offload_device->getDevicePath().c_str());
+  }
 }
 
 /**
@@ -247,6 +310,14 @@ void TensorPool::deallocate() {
   if (cache_loader)
     cache_loader->finish();
 
+  if (offload_device) {
+    for (auto &offload : offloaded)
+      waitOffload(offload);
+    offload_executor.reset();
+    offload_device->finish();
+    offload_device.reset();
+  }
+
   mem_pool->deallocate();
 
   /** nullify the data pointers for the tensors */
@@ -260,6 +331,146 @@ TensorPool::getExecutionOrder(const std::string &name) {
   return std::get<SourceDetails>(getSourceSpec(name).details).exec_order;
 }
 
+bool TensorPool::requestRecompute(const std::string &name, unsigned int order,
+                                  bool split) {
+  auto &spec = getSourceSpec(name);
+  auto &details = std::get<SourceDetails>(spec.details);
+  if (details.lifespan == TensorLifespan::UNMANAGED)
+    return false;
+
+  NNTR_THROW_IF(details.recompute_order != 0 &&
+                  details.recompute_order != order,
+                std::invalid_argument)
+    << "tensor is already recomputed at " << details.recompute_order
+    << ", name: " << spec.tensor->getName();
+
+  details.exec_order.push_back(order);
+  if (!split || isTensorLongTerm(details.lifespan))
+    return false;
+
+  details.recompute_order = order;
+  return true;
+}
+
+void TensorPool::bindRecomputeMemory(unsigned int order) {
+  for (auto &spec : pool) {
+    auto details = std::get_if<SourceDetails>(&spec.details);
+    if (!details || details->split_token == 0 ||
+        details->recompute_order != order)
+      continue;
+
+    spec.tensor->setData(mem_pool->getMemory(details->split_token), 0, false);
+    syncDependents(spec);
+  }
+}
+
+void TensorPool::bindForwardMemory() {
+  for (auto &offload : offloaded) {
+    waitOffload(offload);
+    offload.loaded = false;
+  }
+
+  for (auto &spec : pool) {
+    auto details = std::get_if<SourceDetails>(&spec.details);
+    if (!details || details->split_token == 0)
+      continue;
+
+    spec.tensor->setData(mem_pool->getMemory(details->token), 0, false);
+    syncDependents(spec);
+  }
+}
+
+bool TensorPool::requestOffload(const std::string &name, unsigned int order) {
+  auto &spec = getSourceSpec(name);
+  auto &details = std::get<SourceDetails>(spec.details);
+  if (details.lifespan == TensorLifespan::UNMANAGED ||
+      isTensorLongTerm(details.lifespan) || details.recompute_order != 0)
+    return false;
+
+  NNTR_THROW_IF(details.offload_order != 0 && details.offload_order != order,
+                std::invalid_argument)
+    << "tensor is already offloaded till " << details.offload_order
+    << ", name: " << spec.tensor->getName();
+
+  details.offload_order = order;
+  return true;
+}
+
+void TensorPool::waitOffload(OffloadDetails &offload) {
+  if (offload.task_id < 0)
+    return;
+
+  offload_executor->wait(offload.task_id);
+  offload_executor->releaseTask(offload.task_id);
+  offload.task_id = -1;
+
+  if (offload.error) {
+    std::exception_ptr error = nullptr;
+    std::swap(error, offload.error);
+    std::rethrow_exception(error);
+  }
+}
+
+void TensorPool::offloadBefore(unsigned int order) {
+  if (!offload_device)
+    return;
+
+  for (auto &offload : offloaded) {
+    auto &spec = pool[offload.spec_idx];
+    auto &details = std::get<SourceDetails>(spec.details);
+
+    /** the forward memory is reused from the order after the write */
+    if (!offload.loaded && order >= offload.last_write + 2)
+      waitOffload(offload);
+
+    if (!offload.loaded && order >= details.offload_order) {
+      waitOffload(offload);
+      spec.tensor->setData(mem_pool->getMemory(details.split_token), 0, false);
+      syncDependents(spec);
+      offload.loaded = true;
+
+      void *data = mem_pool->getMemory(details.split_token)->getAddr<char>();
+      const size_t bytes = spec.tensor->getMemoryBytes();
+      offload.task_id = offload_executor->submit(
+        [this, &offload, data, bytes](void *) {
+          try {
+            offload_device->readBuffer(offload.offset, data, bytes);
+          } catch (...) {
+            offload.error = std::current_exception();
+          }
+        });
+    }
+
+    if (offload.loaded && order >= offload.first_use)
+      waitOffload(offload);
+  }
+}
+
+void TensorPool::offloadAfter(unsigned int order) {
+  if (!offload_device)
+    return;
+
+  for (auto &offload : offloaded) {
+    if (offload.loaded || offload.last_write != order)
+      continue;
+
+    auto &spec = pool[offload.spec_idx];
+    auto &details = std::get<SourceDetails>(spec.details);
+    waitOffload(offload);
+
+    const void *data = mem_pool->getMemory(details.token)->getAddr<char>();
+    const size_t bytes = spec.tensor->getMemoryBytes();
+    offload.task_id = offload_executor->submit(
+      [this, &offload, data, bytes](void *) {
+        try {
+          offload_device->writeBuffer(offload.offset, data, bytes);
+        } catch (...) {
+          offload.error = std::current_exception();
+        }
+      });
+  }
+}
+
 /**
  * @brief     Expand the lifespan of the tensor with the given name
  *
@@ -349,6 +560,21 @@ void TensorPool::fillPlaceholder(const std::string &name, const Tensor &t) {
   syncDependents(spec);
 }
 
+void TensorPool::bindMemory(const std::string &name,
+                            std::shared_ptr<MemoryData> mem) {
+  auto &spec = getSourceSpec(name);
+  auto &details = std::get<SourceDetails>(spec.details);
+  NNTR_THROW_IF(details.lifespan == TensorLifespan::UNMANAGED ||
+                  details.lifespan == TensorLifespan::VIRTUAL,
+                std::invalid_argument)
+    << "Cannot bind external memory to unmanaged or virtual tensor " << name;
+  NNTR_THROW_IF(!isAllocated(), std::invalid_argument)
+    << "Cannot bind external memory before allocation, tensor: " << name;
+
+  spec.tensor->setData(mem, 0);
+  syncDependents(spec);
+}
+
 Tensor *TensorPool::extend(const std::string &name, const TensorDim &dim,
                            const std::vector<unsigned int> &exec_order,
                            TensorLifespan lifespan) {
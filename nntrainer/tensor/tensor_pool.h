@@ -16,9 +16,11 @@
 #define __TENSOR_POOL_H__
 #ifdef __cplusplus
 
+#include <exception>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -26,6 +28,8 @@
 #include <cache_loader.h>
 #include <cache_pool.h>
 #include <common.h>
+#include <swap_device.h>
+#include <task_executor.h>
 #include <tensor.h>
 #include <tensor_wrap_specs.h>
 
@@ -110,6 +114,83 @@ public:
    */
   const std::vector<unsigned int> &getExecutionOrder(const std::string &name);
 
+  /**
+   * @brief     Make the tensor valid at the given order to be recomputed there
+   *
+   * @param name name of the tensor
+   * @param order execution order the tensor is recomputed at
+   * @param split if true, the tensor is dropped between its last use before
+   * order and order, and gets memory of its own from order on. The memory is
+   * bound with bindRecomputeMemory().
+   * @return true if the tensor is split, false if it only stays valid till
+   * order. Long term and unmanaged tensors are never split.
+   */
+  bool requestRecompute(const std::string &name, unsigned int order,
+                        bool split);
+
+  /**
+   * @brief     Bind the tensors split at the order to their recompute memory
+   *
+   * @param order execution order given to requestRecompute()
+   */
+  void bindRecomputeMemory(unsigned int order);
+
+  /**
+   * @brief     Bind every split tensor back to its forward memory
+   * @note      pending transfers of offloaded tensors are waited for first
+   */
+  void bindForwardMemory();
+
+  /**
+   * @brief     Offload the tensor to the swap device between its last use
+   * before the given order and the order
+   *
+   * @param name name of the tensor
+   * @param order execution order the tensor is read back from the swap device
+   * at
+   * @return true if the tensor is offloaded. Long term, unmanaged and
+   * recomputed tensors are never offloaded.
+   * @note the tensor keeps its forward memory one order after its last use
+   * before order, so that it is written out while the next order runs, and
+   * gets memory of its own from order on. Call offloadBefore() and
+   * offloadAfter() around every execution order.
+   */
+  bool requestOffload(const std::string &name, unsigned int order);
+
+  /**
+   * @brief     Set the swap device the offloaded tensors are written to
+   *
+   * @param path directory of the swap device
+   * @param name file name of the swap device
+   */
+  void setOffloadDevice(const std::string &path, const std::string &name) {
+    offload_path = path;
+    offload_name = name;
+  }
+
+  /**
+   * @brief     Prepare the offloaded tensors for the execution order. Writes
+   * of the tensors whose forward memory is reused at the order are waited for,
+   * reads of the tensors read back from the order are started and the reads
+   * of the tensors used at the order are waited for.
+   *
+   * @param order execution order to run next
+   */
+  void offloadBefore(unsigned int order);
+
+  /**
+   * @brief     Start writing out the offloaded tensors last used before their
+   * read back at the order
+   *
+   * @param order execution order just run
+   */
+  void offloadAfter(unsigned int order);
+
+  /**
+   * @brief     Get the number of offloaded tensors
+   */
+  size_t getNumOffloaded() const { return offloaded.size(); }
+
   /**
    * @brief Get the maximum real memory requirement
    *
@@ -151,6 +232,16 @@ public:
    */
   void fillPlaceholder(const std::string &name, const Tensor &t);
 
+  /**
+   * @brief Bind an allocated tensor and its views to an external buffer
+   *
+   * @param name Name of the tensor
+   * @param mem Buffer holding at least the bytes of the tensor
+   *
+   * @note The binding holds until the pool is allocated again
+   */
+  void bindMemory(const std::string &name, std::shared_ptr<MemoryData> mem);
+
   /**
    * @brief request placeholder which will be not managed by this tensor pool
    * but will be managed externally
@@ -355,6 +446,26 @@ private:
     std::vector<unsigned int> exec_order; /**< exec order */
     std::vector<unsigned int>
       dependents; /**< list of dependents to the source */
+    unsigned int recompute_order = 0; /**< order the tensor is recomputed at,
+                                         0 if it is not recomputed */
+    unsigned int offload_order = 0;   /**< order the tensor is read back at, 0
+                                         if it is not offloaded */
+    unsigned int split_token = 0; /**< memory token from recompute_order or
+                                     offload_order */
+  };
+
+  /**
+   * @brief state of an offloaded tensor
+   *
+   */
+  struct OffloadDetails {
+    unsigned int spec_idx;   /**< index of the source spec */
+    unsigned int last_write; /**< last use before the read back */
+    unsigned int first_use;  /**< first use after the read back */
+    size_t offset;           /**< offset in the swap device */
+    int task_id;             /**< pending transfer, -1 if none */
+    bool loaded;             /**< bound to the memory from offload_order */
+    std::exception_ptr error; /**< failure of the last transfer */
   };
 
   /**
@@ -443,6 +554,19 @@ private:
   std::shared_ptr<MemoryPool> mem_pool; /**< memory pool for the tensors */
   std::unique_ptr<CacheLoader> cache_loader; /**< memory pool for the tensors */
 
+  std::vector<OffloadDetails> offloaded; /**< offloaded tensors */
+  std::string offload_path;              /**< directory of the swap device */
+  std::string offload_name = "activation_offload"; /**< swap device name */
+  std::unique_ptr<SwapDevice> offload_device; /**< device of offloaded data */
+  std::unique_ptr<TaskExecutor> offload_executor; /**< runs the transfers */
+
+  /**
+   * @brief     Wait for the pending transfer of an offloaded tensor
+   *
+   * @param offload offloaded tensor
+   */
+  void waitOffload(OffloadDetails &offload);
+
   /**
    * @brief     Check if the lifespan leads to long term valitidy
    *
@@ -11,6 +11,8 @@
  *
  */
 
+#include <atomic>
+
 #include <util_func.h>
 #include <weight.h>
 
@@ -129,6 +131,18 @@ Weight::Weight(Tensor *v, Tensor *g, Tensor *v32, const WeightRegularizer reg,
     var32 = std::make_shared<Tensor>();
 }
 
+namespace {
+std::atomic<uint64_t> update_epoch(0);
+} // namespace
+
+void Weight::markUpdated() {
+  update_epoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t Weight::getUpdateEpoch() {
+  return update_epoch.load(std::memory_order_relaxed);
+}
+
 void Weight::applyGradient(double lr, Tensor &updated_grad) {
   if (isMixedPrecision() &&
       updated_grad.getDataType() == ml::train::TensorDim::DataType::FP32 &&
@@ -145,6 +159,8 @@ void Weight::quantizeWeight() {
   if (!isMixedPrecision())
     return;
 
+  markUpdated();
+
   Tensor &var = getVariableRef();
   ml::train::TensorDim::DataType type = var.getDataType();
   switch (type) {
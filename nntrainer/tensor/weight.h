@@ -288,7 +288,10 @@ public:
   /**
    * @brief     Apply the gradient to the weight
    */
-  void applyGradient(double lr) { var->add_i(*grad.get(), -lr); }
+  void applyGradient(double lr) {
+    var->add_i(*grad.get(), -lr);
+    markUpdated();
+  }
 
   /**
    * @brief     Apply the gradient to the weight with updated gradient
@@ -363,6 +366,18 @@ public:
    */
   const float getLossScale() { return loss_scale; };
 
+  /**
+   * @brief mark that the data of some weight is written in place
+   * @note caches derived from the weight data, e.g. a quantized copy, compare
+   * getUpdateEpoch() with the epoch they were built at
+   */
+  static void markUpdated();
+
+  /**
+   * @brief get the number of in place weight writes so far
+   */
+  static uint64_t getUpdateEpoch();
+
 private:
   static constexpr float epsilon = 1e-6f; /**< epsilon for zero comparison */
   static constexpr float epsilon_decay =
@@ -664,10 +664,10 @@ struct TensorDataTypeInfo {
   static constexpr std::initializer_list<Enum> EnumList = {
     Enum::BCQ,    Enum::QINT4, Enum::QINT8, Enum::QINT16,
     Enum::FP16,   Enum::FP32,  Enum::UINT4, Enum::UINT8,
-    Enum::UINT16, Enum::Q4_K,  Enum::Q6_K,  Enum::Q4_0};
+    Enum::UINT16, Enum::Q4_K,  Enum::Q6_K,  Enum::Q4_0, Enum::UINT32};
   static constexpr const char *EnumStr[] = {
     "BCQ",   "QINT4", "QINT8",  "QINT16", "FP16", "FP32",
-    "UINT4", "UINT8", "UINT16", "Q4_K",   "Q6_K", "Q4_0"};
+    "UINT4", "UINT8", "UINT16", "Q4_K",   "Q6_K", "Q4_0", "UINT32"};
 };
 
 /**
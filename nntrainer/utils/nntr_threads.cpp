@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <nntr_threads.h>
+#include <thread_runtime.h>
 
 #ifdef NNTR_NUM_THREADS
 static const unsigned int nntr_num_threads = NNTR_NUM_THREADS;
@@ -47,16 +48,19 @@ void ParallelBatch::run() {
 
   unsigned int chunk = (end - start + (num_workers - 1)) / num_workers;
 
-  for (unsigned int i = 0; i < num_workers; ++i) {
-    unsigned int s = start + i * chunk;
-    unsigned int e = s + chunk;
-    if (e > end)
-      e = end;
-    workers.push_back(std::thread(cb, s, e, i, user_data_prop->get()));
-  }
-
-  std::for_each(workers.begin(), workers.end(),
-                std::mem_fn(&std::thread::join));
+  /// chunks run on the shared runtime instead of freshly spawned threads, pid
+  /// stays the chunk index so per-worker buffers of the callers keep working
+  ThreadRuntime::Global().parallel_for(
+    0, num_workers,
+    [&](unsigned int i) {
+      unsigned int s = start + i * chunk;
+      unsigned int e = s + chunk;
+      if (e > end)
+        e = end;
+      if (s < e)
+        cb(s, e, i, user_data_prop->get());
+    },
+    1);
 }
 
 void ParallelBatch::setCallback(threaded_cb threaded_cb_, void *user_data_) {
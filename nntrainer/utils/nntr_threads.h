@@ -80,7 +80,6 @@ private:
   threaded_cb cb;
   unsigned int batch;
   unsigned int num_workers;
-  std::vector<std::thread> workers;
   std::unique_ptr<props::PropsUserData> user_data_prop;
 };
 
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   parallel_range.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Plain function entry of ThreadRuntime::parallel_for for objects
+ * compiled with ISA specific flags. Such objects must not instantiate inline
+ * or template code that is shared with the baseline objects, which
+ * thread_runtime.h would do through std::function and the singleton.
+ */
+
+#ifndef __PARALLEL_RANGE_H__
+#define __PARALLEL_RANGE_H__
+#ifdef __cplusplus
+
+namespace nntrainer {
+
+/**
+ * @brief call fn(i, ctx) for every i in [begin, end) on
+ * ThreadRuntime::Global() and wait for completion
+ *
+ * @param begin first index
+ * @param end one past the last index
+ * @param fn function taking the index and ctx
+ * @param ctx opaque pointer passed to fn
+ */
+void parallel_range(unsigned int begin, unsigned int end,
+                    void (*fn)(unsigned int, void *), void *ctx);
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __PARALLEL_RANGE_H__ */
@@ -0,0 +1,570 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   thread_runtime.cpp
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Process wide worker runtime shared by every parallel region of
+ * nntrainer
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sched.h>
+#endif
+
+#include <nntrainer_log.h>
+#include <parallel_range.h>
+#include <thread_runtime.h>
+
+namespace nntrainer {
+
+namespace {
+
+/** true on runtime workers and on a caller while it runs its parallel_for */
+thread_local bool tls_in_region = false;
+
+/**
+ * @brief mark the current thread as running inside a parallel region
+ */
+class RegionGuard {
+public:
+  RegionGuard() : prev(tls_in_region) { tls_in_region = true; }
+  ~RegionGuard() { tls_in_region = prev; }
+
+private:
+  bool prev;
+};
+
+/**
+ * @brief parse a linux cpulist such as "0-3,8,10-11"
+ */
+std::vector<int> parse_cpulist(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty() || item == "\n")
+      continue;
+    int first = 0, last = 0;
+    const size_t dash = item.find('-');
+    try {
+      first = std::stoi(item.substr(0, dash));
+      last = (dash == std::string::npos) ? first
+                                          : std::stoi(item.substr(dash + 1));
+    } catch (...) {
+      continue;
+    }
+    for (int c = first; c <= last; ++c)
+      cpus.push_back(c);
+  }
+  return cpus;
+}
+
+/**
+ * @brief cores the process is allowed to run on
+ */
+std::vector<int> allowed_cpus() {
+  std::vector<int> cpus;
+#if defined(__linux__) || defined(__ANDROID__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int c = 0; c < CPU_SETSIZE; ++c)
+      if (CPU_ISSET(c, &set))
+        cpus.push_back(c);
+  }
+#endif
+  if (cpus.empty()) {
+    const unsigned int hw = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int c = 0; c < hw; ++c)
+      cpus.push_back(static_cast<int>(c));
+  }
+  return cpus;
+}
+
+/**
+ * @brief cores of each NUMA node intersected with the allowed cores. Returns
+ * an empty vector when the topology is not available.
+ */
+std::vector<std::vector<int>> numa_nodes(const std::vector<int> &allowed) {
+  std::vector<std::vector<int>> result;
+#if defined(__linux__) || defined(__ANDROID__)
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string list;
+  if (!online || !std::getline(online, list))
+    return result;
+
+  for (int node : parse_cpulist(list)) {
+    std::ifstream f("/sys/devices/system/node/node" + std::to_string(node) +
+                    "/cpulist");
+    std::string cpulist;
+    if (!f || !std::getline(f, cpulist))
+      continue;
+    std::vector<int> cpus;
+    for (int c : parse_cpulist(cpulist))
+      if (std::find(allowed.begin(), allowed.end(), c) != allowed.end())
+        cpus.push_back(c);
+    if (!cpus.empty())
+      result.push_back(std::move(cpus));
+  }
+#endif
+  return result;
+}
+
+/**
+ * @brief read unsigned integer environment variable
+ */
+bool env_uint(const char *name, unsigned int &value) {
+  const char *env = std::getenv(name);
+  if (env == nullptr || *env == '\0')
+    return false;
+  char *end = nullptr;
+  const unsigned long v = std::strtoul(env, &end, 10);
+  if (end == env || *end != '\0') {
+    ml_logw("Invalid %s=%s is ignored", name, env);
+    return false;
+  }
+  value = static_cast<unsigned int>(v);
+  return true;
+}
+
+void pin_current_thread(int cpu) {
+#if defined(__linux__) || defined(__ANDROID__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    ml_logw("Failed to pin a runtime worker to cpu %d", cpu);
+#else
+  (void)cpu;
+#endif
+}
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now() - since)
+    .count();
+}
+
+} // namespace
+
+/**
+ * @brief a running parallel_for. Lives on the stack of its caller.
+ */
+struct ThreadRuntime::Job {
+  /**
+   * @brief indices of one node, padded to avoid false sharing
+   */
+  struct alignas(64) Range {
+    std::atomic<size_t> next;
+    size_t end;
+  };
+
+  const std::function<void(unsigned int)> *fn;
+  std::unique_ptr<Range[]> ranges;
+  unsigned int num_ranges;
+  unsigned int grain;
+  std::atomic<size_t> remaining;
+  unsigned int refs = 0; /**< attached workers, guarded by ThreadRuntime::mtx */
+  unsigned int slots = 0; /**< workers that may still attach, ditto */
+  std::mutex error_mtx;
+  std::exception_ptr error;
+};
+
+/**
+ * @brief a worker thread and its utilization counters
+ */
+struct alignas(64) ThreadRuntime::Worker {
+  std::thread thread;
+  unsigned int node = 0;
+  int cpu = -1;
+  uint64_t seen_epoch = 0;
+  std::atomic<uint64_t> busy_ns{0};
+  std::atomic<uint64_t> items{0};
+  std::atomic<uint64_t> stolen{0};
+};
+
+ThreadRuntime::ThreadRuntime() :
+  num_workers(0),
+  job(nullptr),
+  job_epoch(0),
+  pending_tasks(0),
+  shutdown(false),
+  stats_since(std::chrono::steady_clock::now()) {}
+
+ThreadRuntime::~ThreadRuntime() { stop(); }
+
+void ThreadRuntime::initialize() noexcept {
+  ThreadRuntimeConfig cfg;
+  unsigned int value = 0;
+  if (env_uint("NNTR_RUNTIME_NUM_THREADS", value))
+    cfg.num_threads = value;
+  if (env_uint("NNTR_RUNTIME_PIN_THREADS", value))
+    cfg.pin_threads = value != 0;
+  if (env_uint("NNTR_RUNTIME_NUMA", value))
+    cfg.numa_aware = value != 0;
+
+  config = cfg;
+  try {
+    start();
+  } catch (std::exception &e) {
+    ml_loge("Failed to start thread runtime workers: %s", e.what());
+    stop();
+  }
+}
+
+void ThreadRuntime::configure(const ThreadRuntimeConfig &cfg) {
+  initializeOnce();
+  std::lock_guard<std::mutex> serial(job_mutex);
+  stop();
+  config = cfg;
+  start();
+}
+
+void ThreadRuntime::start() {
+  const std::vector<int> allowed = allowed_cpus();
+
+  nodes.clear();
+  cpu_to_node.clear();
+  std::vector<std::vector<int>> topology;
+  if (config.numa_aware)
+    topology = numa_nodes(allowed);
+  if (topology.empty())
+    topology.push_back(allowed);
+
+  for (auto &cpus : topology) {
+    Node n;
+    n.cpus = std::move(cpus);
+    for (int c : n.cpus) {
+      if (static_cast<size_t>(c) >= cpu_to_node.size())
+        cpu_to_node.resize(c + 1, 0);
+      cpu_to_node[c] = static_cast<unsigned int>(nodes.size());
+    }
+    nodes.push_back(std::move(n));
+  }
+
+  const unsigned int total_cpus = static_cast<unsigned int>(allowed.size());
+  const unsigned int num_threads =
+    config.num_threads ? config.num_threads : total_cpus;
+  config.num_threads = num_threads;
+
+  /// share the threads among nodes in proportion to their cores. The calling
+  /// thread takes the first slot of its node.
+  std::vector<unsigned int> slots(nodes.size(), 0);
+  unsigned int assigned = 0;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    slots[i] = static_cast<unsigned int>(
+      (static_cast<uint64_t>(num_threads) * nodes[i].cpus.size()) / total_cpus);
+    assigned += slots[i];
+  }
+  for (size_t i = 0; assigned < num_threads; i = (i + 1) % nodes.size()) {
+    slots[i]++;
+    assigned++;
+  }
+
+  const unsigned int caller_node = currentNode();
+  shutdown = false;
+  num_workers = 0;
+  workers.clear();
+  for (size_t n = 0; n < nodes.size(); ++n) {
+    const unsigned int first = (n == caller_node) ? 1 : 0;
+    for (unsigned int s = first; s < slots[n]; ++s) {
+      auto w = std::make_unique<Worker>();
+      w->node = static_cast<unsigned int>(n);
+      if (config.pin_threads)
+        w->cpu = nodes[n].cpus[s % nodes[n].cpus.size()];
+      workers.push_back(std::move(w));
+    }
+    nodes[n].num_workers = slots[n] - std::min(first, slots[n]);
+  }
+  num_workers = static_cast<unsigned int>(workers.size());
+
+  for (auto &w : workers) {
+    Worker *worker = w.get();
+    worker->thread = std::thread([this, worker] { workerLoop(worker); });
+  }
+
+  resetWorkerStats();
+  ml_logi("thread runtime: %u threads on %zu node(s), pinning %s",
+          num_threads, nodes.size(), config.pin_threads ? "on" : "off");
+}
+
+void ThreadRuntime::stop() {
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    shutdown = true;
+  }
+  cv.notify_all();
+  for (auto &w : workers)
+    if (w->thread.joinable())
+      w->thread.join();
+  workers.clear();
+  num_workers = 0;
+
+  /// run what is left so that no future is abandoned
+  for (auto &n : nodes) {
+    while (!n.tasks.empty()) {
+      auto task = std::move(n.tasks.front());
+      n.tasks.pop_front();
+      task();
+    }
+  }
+  pending_tasks = 0;
+}
+
+unsigned int ThreadRuntime::currentNode() const {
+  if (nodes.size() <= 1)
+    return 0;
+#if defined(__linux__) || defined(__ANDROID__)
+  const int cpu = sched_getcpu();
+  if (cpu >= 0 && static_cast<size_t>(cpu) < cpu_to_node.size())
+    return cpu_to_node[cpu];
+#endif
+  return 0;
+}
+
+bool ThreadRuntime::inParallelRegion() { return tls_in_region; }
+
+void ThreadRuntime::runJob(Job &j, unsigned int node, Worker *w) {
+  const auto begin = std::chrono::steady_clock::now();
+  uint64_t done = 0, stolen = 0;
+
+  for (unsigned int k = 0; k < j.num_ranges; ++k) {
+    const unsigned int r_idx = (node + k) % j.num_ranges;
+    Job::Range &r = j.ranges[r_idx];
+    while (true) {
+      const size_t s = r.next.fetch_add(j.grain, std::memory_order_relaxed);
+      if (s >= r.end)
+        break;
+      const size_t e = std::min(s + j.grain, r.end);
+      for (size_t i = s; i < e; ++i) {
+        try {
+          (*j.fn)(static_cast<unsigned int>(i));
+        } catch (...) {
+          std::lock_guard<std::mutex> lk(j.error_mtx);
+          if (!j.error)
+            j.error = std::current_exception();
+        }
+      }
+      done += e - s;
+      if (k != 0)
+        stolen += e - s;
+      j.remaining.fetch_sub(e - s, std::memory_order_acq_rel);
+    }
+  }
+
+  if (w != nullptr && done != 0) {
+    w->busy_ns.fetch_add(elapsed_ns(begin), std::memory_order_relaxed);
+    w->items.fetch_add(done, std::memory_order_relaxed);
+    w->stolen.fetch_add(stolen, std::memory_order_relaxed);
+  }
+}
+
+bool ThreadRuntime::popTask(unsigned int node,
+                            std::packaged_task<void()> &task) {
+  for (size_t k = 0; k < nodes.size(); ++k) {
+    Node &n = nodes[(node + k) % nodes.size()];
+    if (!n.tasks.empty()) {
+      task = std::move(n.tasks.front());
+      n.tasks.pop_front();
+      pending_tasks--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadRuntime::workerLoop(Worker *w) {
+  tls_in_region = true;
+  if (w->cpu >= 0)
+    pin_current_thread(w->cpu);
+
+  std::unique_lock<std::mutex> lk(mtx);
+  while (true) {
+    cv.wait(lk, [&] {
+      return shutdown || (job != nullptr && job_epoch != w->seen_epoch) ||
+             pending_tasks > 0;
+    });
+
+    if (job != nullptr && job_epoch != w->seen_epoch) {
+      w->seen_epoch = job_epoch;
+      Job *j = job;
+      if (j->slots == 0)
+        continue;
+      j->slots--;
+      j->refs++;
+      lk.unlock();
+      runJob(*j, w->node, w);
+      lk.lock();
+      j->refs--;
+      if (j->refs == 0 && j->remaining.load() == 0)
+        cv_done.notify_all();
+      continue;
+    }
+
+    std::packaged_task<void()> task;
+    if (popTask(w->node, task)) {
+      lk.unlock();
+      const auto begin = std::chrono::steady_clock::now();
+      task();
+      w->busy_ns.fetch_add(elapsed_ns(begin), std::memory_order_relaxed);
+      w->items.fetch_add(1, std::memory_order_relaxed);
+      lk.lock();
+      continue;
+    }
+
+    if (shutdown)
+      return;
+  }
+}
+
+void ThreadRuntime::parallel_for(unsigned int begin, unsigned int end,
+                                 const std::function<void(unsigned int)> &fn,
+                                 unsigned int grain, unsigned int max_threads) {
+  if (begin >= end)
+    return;
+
+  if (num_workers == 0 || end - begin == 1 || max_threads == 1 ||
+      tls_in_region) {
+    for (unsigned int i = begin; i < end; ++i)
+      fn(i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> serial(job_mutex);
+
+  const unsigned int caller_node = currentNode();
+  const size_t count = end - begin;
+
+  Job j;
+  j.fn = &fn;
+  j.slots = (max_threads == 0) ? num_workers
+                               : std::min(num_workers, max_threads - 1);
+  j.grain = grain ? grain
+                  : static_cast<unsigned int>(std::max<size_t>(
+                      1, count / (static_cast<size_t>(j.slots + 1) * 8)));
+  j.num_ranges = static_cast<unsigned int>(nodes.size());
+  j.ranges = std::make_unique<Job::Range[]>(j.num_ranges);
+  j.remaining.store(count);
+
+  /// split the indices in proportion to the threads of every node
+  const size_t threads = num_workers + 1;
+  size_t offset = begin, acc = 0;
+  for (unsigned int n = 0; n < j.num_ranges; ++n) {
+    acc += nodes[n].num_workers + (n == caller_node ? 1 : 0);
+    const size_t next = (n + 1 == j.num_ranges)
+                          ? static_cast<size_t>(end)
+                          : begin + count * acc / threads;
+    j.ranges[n].next.store(offset);
+    j.ranges[n].end = next;
+    offset = next;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    job = &j;
+    job_epoch++;
+  }
+  cv.notify_all();
+
+  {
+    RegionGuard guard;
+    runJob(j, caller_node, nullptr);
+  }
+
+  {
+    std::unique_lock<std::mutex> lk(mtx);
+    cv_done.wait(lk, [&] { return j.remaining.load() == 0 && j.refs == 0; });
+    job = nullptr;
+  }
+
+  if (j.error)
+    std::rethrow_exception(j.error);
+}
+
+std::future<void> ThreadRuntime::submit(std::function<void()> fn) {
+  std::packaged_task<void()> task(std::move(fn));
+  std::future<void> fut = task.get_future();
+
+  /// a worker waiting on a queued task could hold the last free worker
+  if (num_workers == 0 || inParallelRegion()) {
+    RegionGuard guard;
+    task();
+    return fut;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(mtx);
+    nodes[currentNode()].tasks.push_back(std::move(task));
+    pending_tasks++;
+  }
+  cv.notify_all();
+  return fut;
+}
+
+std::size_t ThreadRuntime::select_k_quant_thread_count(unsigned int M,
+                                                       unsigned int N,
+                                                       unsigned int K) {
+  const std::size_t max_threads = getNumThreads();
+
+  const std::size_t work_size = static_cast<std::size_t>(M) * N * K;
+  std::size_t est_threads;
+
+  //  Use log-scale thresholds to reduce threads on smaller work sizes
+  if (work_size < 1536 * 1536)
+    est_threads = 1;
+  else if (work_size < 1536 * 2048)
+    est_threads = 2;
+  else if (work_size < 2048 * 2048)
+    est_threads = 4;
+  else {
+    est_threads =
+      static_cast<std::size_t>(std::log2(work_size / (1536 * 1536))) + 4;
+  }
+  return std::min(est_threads, max_threads);
+}
+
+std::vector<ThreadRuntimeWorkerStats> ThreadRuntime::getWorkerStats() const {
+  const double wall = static_cast<double>(elapsed_ns(stats_since));
+  std::vector<ThreadRuntimeWorkerStats> stats;
+  stats.reserve(workers.size());
+  for (auto &w : workers) {
+    ThreadRuntimeWorkerStats s;
+    s.cpu = w->cpu;
+    s.node = w->node;
+    s.busy_ns = w->busy_ns.load(std::memory_order_relaxed);
+    s.items = w->items.load(std::memory_order_relaxed);
+    s.stolen = w->stolen.load(std::memory_order_relaxed);
+    s.utilization = wall > 0 ? static_cast<double>(s.busy_ns) / wall : 0.0;
+    stats.push_back(s);
+  }
+  return stats;
+}
+
+void ThreadRuntime::resetWorkerStats() {
+  for (auto &w : workers) {
+    w->busy_ns.store(0, std::memory_order_relaxed);
+    w->items.store(0, std::memory_order_relaxed);
+    w->stolen.store(0, std::memory_order_relaxed);
+  }
+  stats_since = std::chrono::steady_clock::now();
+}
+
+void parallel_range(unsigned int begin, unsigned int end,
+                    void (*fn)(unsigned int, void *), void *ctx) {
+  ThreadRuntime::Global().parallel_for(
+    begin, end, [fn, ctx](unsigned int i) { fn(i, ctx); });
+}
+
+} // namespace nntrainer
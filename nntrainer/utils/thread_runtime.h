@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file   thread_runtime.h
+ * @date   19 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug    No known bugs except for NYI items
+ * @brief  Process wide worker runtime shared by every parallel region of
+ * nntrainer. It provides parallel_for and task submission on one set of
+ * workers, optionally pinned to cores and grouped by NUMA node.
+ *
+ * @note   Runtime configuration is read once from the environment and can be
+ * changed later with ThreadRuntime::configure().
+ *         NNTR_RUNTIME_NUM_THREADS : number of threads including the caller
+ *         NNTR_RUNTIME_PIN_THREADS : 1 to pin each worker to one core
+ *         NNTR_RUNTIME_NUMA        : 0 to use a single work queue
+ */
+
+#ifndef __THREAD_RUNTIME_H__
+#define __THREAD_RUNTIME_H__
+#ifdef __cplusplus
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <singleton.h>
+
+namespace nntrainer {
+
+/**
+ * @brief Configuration of ThreadRuntime
+ */
+struct ThreadRuntimeConfig {
+  unsigned int num_threads = 0; /**< threads including the calling thread,
+                                   0 uses every core the process may run on */
+  bool pin_threads = false;     /**< pin each worker to a single core */
+  bool numa_aware = true;       /**< keep one work queue per NUMA node */
+};
+
+/**
+ * @brief Utilization counters of a worker since the last reset
+ */
+struct ThreadRuntimeWorkerStats {
+  int cpu;            /**< pinned core, -1 if not pinned */
+  unsigned int node;  /**< NUMA node the worker serves */
+  uint64_t busy_ns;   /**< time spent running work */
+  uint64_t items;     /**< parallel_for indices and tasks executed */
+  uint64_t stolen;    /**< indices taken from another node */
+  double utilization; /**< busy_ns over wall time since reset */
+};
+
+/**
+ * @brief ThreadRuntime is the single worker pool of the process.
+ * @details parallel_for splits the index range into one contiguous part per
+ * NUMA node. Workers drain the part of their own node first and steal from
+ * other nodes afterwards, so that data first touched by a node keeps being
+ * processed there. The calling thread always takes part in the loop, which
+ * makes nested parallel_for calls safe: a call issued from inside a parallel
+ * region runs inline on the calling thread instead of oversubscribing cores.
+ */
+class ThreadRuntime : public Singleton<ThreadRuntime> {
+public:
+  /**
+   * @brief Construct a new Thread Runtime object
+   */
+  ThreadRuntime();
+
+  /**
+   * @brief Destroy the Thread Runtime object, joins every worker
+   */
+  ~ThreadRuntime();
+
+  /**
+   * @brief restart workers with a new configuration. Must not be called from
+   * inside a parallel region.
+   */
+  void configure(const ThreadRuntimeConfig &config);
+
+  /**
+   * @brief get current configuration, num_threads is resolved
+   */
+  const ThreadRuntimeConfig &getConfig() const { return config; }
+
+  /**
+   * @brief number of threads that run a parallel_for, including the caller
+   */
+  unsigned int getNumThreads() const { return num_workers + 1; }
+
+  /**
+   * @brief number of NUMA nodes work queues are kept for
+   */
+  unsigned int getNumNodes() const {
+    return static_cast<unsigned int>(nodes.size());
+  }
+
+  /**
+   * @brief call fn(i) for every i in [begin, end) and wait for completion.
+   * The first exception thrown by fn is rethrown on the caller.
+   *
+   * @param begin first index
+   * @param end one past the last index
+   * @param fn callable taking the index
+   * @param grain number of consecutive indices taken at once, 0 picks one
+   * that gives every thread several chunks
+   * @param max_threads upper bound of threads running the loop including the
+   * caller, 0 uses every thread
+   */
+  void parallel_for(unsigned int begin, unsigned int end,
+                    const std::function<void(unsigned int)> &fn,
+                    unsigned int grain = 0, unsigned int max_threads = 0);
+
+  /**
+   * @brief run fn asynchronously on a worker of the caller's node. Runs fn
+   * inline when there is no worker or when called inside a parallel region,
+   * so that waiting on the future from a worker cannot deadlock the pool.
+   *
+   * @return std::future<void> becomes ready when fn returns
+   */
+  std::future<void> submit(std::function<void()> fn);
+
+  /**
+   * @brief check if the current thread is inside a parallel region or a task
+   */
+  static bool inParallelRegion();
+
+  /**
+   * @brief Select number of threads to use in K-quantized GEMM and GEMV
+   *
+   * @param M M for GEMM (M != 1) or GEMV (M = 1)
+   * @param N N for GEMM or GEMV
+   * @param K K for GEMM or GEMV
+   * @return std::size_t number of thread to use
+   */
+  std::size_t select_k_quant_thread_count(unsigned int M, unsigned int N,
+                                          unsigned int K);
+
+  /**
+   * @brief get utilization of every worker since the last reset
+   */
+  std::vector<ThreadRuntimeWorkerStats> getWorkerStats() const;
+
+  /**
+   * @brief reset utilization counters
+   */
+  void resetWorkerStats();
+
+protected:
+  /**
+   * @copydoc Singleton::initialize()
+   */
+  void initialize() noexcept override;
+
+private:
+  struct Job;
+  struct Worker;
+
+  /**
+   * @brief CPUs of one NUMA node and the workers serving it
+   */
+  struct Node {
+    std::vector<int> cpus;                       /**< usable cores */
+    std::list<std::packaged_task<void()>> tasks; /**< submitted tasks */
+    unsigned int num_workers = 0;                /**< workers of this node */
+  };
+
+  /**
+   * @brief discover topology and spawn workers for the current config
+   */
+  void start();
+
+  /**
+   * @brief join workers after running every queued task
+   */
+  void stop();
+
+  /**
+   * @brief main loop of a worker thread
+   */
+  void workerLoop(Worker *w);
+
+  /**
+   * @brief take indices of job, own node first, until none is left
+   * @param w worker to account the work to, nullptr for the caller
+   */
+  void runJob(Job &job, unsigned int node, Worker *w);
+
+  /**
+   * @brief pop a task, own node first. mtx must be held.
+   */
+  bool popTask(unsigned int node, std::packaged_task<void()> &task);
+
+  /**
+   * @brief NUMA node of the core the calling thread runs on
+   */
+  unsigned int currentNode() const;
+
+  ThreadRuntimeConfig config;
+  std::vector<Node> nodes;
+  std::vector<int> cpu_to_node;
+  unsigned int num_workers;
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  std::mutex mtx;                  /**< guards job, tasks and shutdown */
+  std::condition_variable cv;      /**< wakes workers */
+  std::condition_variable cv_done; /**< wakes the parallel_for caller */
+  Job *job;              /**< active parallel_for, nullptr if none */
+  uint64_t job_epoch;    /**< incremented on every parallel_for */
+  size_t pending_tasks;  /**< number of queued tasks */
+  bool shutdown;         /**< workers exit once tasks are drained */
+
+  std::mutex job_mutex; /**< serializes parallel_for of different callers */
+  std::chrono::steady_clock::time_point stats_since;
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __THREAD_RUNTIME_H__ */
@@ -25,6 +25,7 @@
 
 #ifdef __cplusplus
 
+#include <cstdint>
 #include <cstring>
 #include <regex>
 #include <sstream>
@@ -450,6 +451,22 @@ void floatToFixedPointAndExponent(float input, int &fixedpoint, int &exponent);
  */
 float fixedPointAndExponentToFloat(int fixedpoint, int exponent);
 
+/**
+ * @brief get the i-th word index of the FP32 or UINT32 input data of an
+ * embedding
+ *
+ * @param[in] in_data input data of the embedding
+ * @param[in] uint_input true if the input data is UINT32
+ * @param[in] i index of the word
+ * @return word index
+ */
+inline unsigned int wordIndex(const void *in_data, bool uint_input,
+                              unsigned int i) {
+  if (uint_input)
+    return static_cast<const uint32_t *>(in_data)[i];
+  return static_cast<unsigned int>(static_cast<const float *>(in_data)[i]);
+}
+
 } /* namespace nntrainer */
 
 #endif /* __cplusplus */
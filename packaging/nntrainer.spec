@@ -603,11 +603,11 @@ cp -r result %{buildroot}%{_datadir}/nntrainer/unittest/
 %{_includedir}/nntrainer/cblas_interface.h
 %endif
 %{_includedir}/nntrainer/ggml_interface.h
+%{_includedir}/nntrainer/gemm_tuner.h
 %{_includedir}/nntrainer/nntr_ggml_impl.h
 %{_includedir}/nntrainer/nntr_ggml_impl_common.h
 %{_includedir}/nntrainer/nntr_ggml_impl_utils.h
-%{_includedir}/nntrainer/bs_thread_pool.h
-%{_includedir}/nntrainer/bs_thread_pool_manager.hpp
+%{_includedir}/nntrainer/thread_runtime.h
 %ifarch %{ix86} x86_64
 %{_includedir}/nntrainer/x86_compute_backend.h
 %{_includedir}/nntrainer/avx2_impl.h
@@ -697,6 +697,7 @@ cp -r result %{buildroot}%{_datadir}/nntrainer/unittest/
 %{_includedir}/nntrainer/layer_node.h
 %{_includedir}/nntrainer/graph_node.h
 %{_includedir}/nntrainer/model_common_properties.h
+%{_includedir}/nntrainer/weight_container.h
 %{_includedir}/nntrainer/network_graph.h
 %{_includedir}/nntrainer/graph_core.h
 %{_includedir}/nntrainer/manager.h
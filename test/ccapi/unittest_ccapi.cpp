@@ -11,6 +11,8 @@
  */
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <fstream>
 #include <iostream>
 
 #include <dataset.h>
@@ -660,6 +662,425 @@ TEST(nntrainer_ccapi, model_copy_02_p) {
   delete[] b_one;
 }
 
+/**
+ * @brief incremental inference into caller buffers with the last step only
+ */
+TEST(nntrainer_ccapi, incremental_inference_output_buffer_p) {
+  const unsigned int batch = 2, seq = 4, width = 8, unit = 16;
+
+  std::vector<float> weight(width * unit), bias(unit);
+  for (unsigned int i = 0; i < weight.size(); ++i)
+    weight[i] = ((i * 7) % 13) / 13.0f - 0.5f;
+  for (unsigned int i = 0; i < bias.size(); ++i)
+    bias[i] = i / 16.0f;
+
+  auto build = [&](const std::string &last_step_only) {
+    auto model = ml::train::createModel(ml::train::ModelType::NEURAL_NET);
+    model->addLayer(ml::train::layer::Input(
+      {"name=input0", "input_shape=1:1:" + std::to_string(seq) + ":" +
+                        std::to_string(width)}));
+    model->addLayer(ml::train::layer::FullyConnected(
+      {"name=fc", "unit=" + std::to_string(unit), "input_layers=input0",
+       "last_step_only=" + last_step_only}));
+    model->setProperty({"batch_size=" + std::to_string(batch)});
+    EXPECT_EQ(model->compile(ml::train::ExecutionMode::INFERENCE),
+              ML_ERROR_NONE);
+    EXPECT_EQ(model->initialize(ml::train::ExecutionMode::INFERENCE),
+              ML_ERROR_NONE);
+    model->allocate(ml::train::ExecutionMode::INFERENCE);
+
+    std::shared_ptr<ml::train::Layer> fc;
+    model->getLayer("fc", &fc);
+    fc->setWeights({weight.data(), bias.data()});
+    return model;
+  };
+
+  std::vector<float> input_data(batch * seq * width);
+  for (unsigned int i = 0; i < input_data.size(); ++i)
+    input_data[i] = ((i * 5) % 11) / 11.0f;
+  std::vector<float *> input = {input_data.data()};
+  std::vector<float *> label;
+
+  auto full = build("false");
+  std::vector<float *> expected =
+    full->incremental_inference(batch, input, label, seq, 0, seq);
+
+  auto last = build("true");
+  std::vector<float> out_data(batch * unit, -1.0f);
+  std::vector<float *> output = {out_data.data()};
+  EXPECT_NO_THROW(
+    last->incremental_inference(batch, input, label, output, seq, 0, seq));
+
+  /// the last step is computed apart from the other rows, in another order
+  for (unsigned int i = 0; i < batch * unit; ++i)
+    EXPECT_NEAR(out_data[i], expected[0][i], 1e-5f);
+
+  delete[] expected[0];
+}
+
+/**
+ * @brief dynamically quantized fully connected layers follow the FP32 output,
+ * also after the weights are overwritten
+ */
+TEST(nntrainer_ccapi, fully_connected_dynamic_quantization_p) {
+  const unsigned int batch = 2, seq = 4, width = 64, unit = 48;
+
+  auto build = [&](const std::string &dynamic_quantization) {
+    auto model = ml::train::createModel(ml::train::ModelType::NEURAL_NET);
+    model->addLayer(ml::train::layer::Input(
+      {"name=input0", "input_shape=1:" + std::to_string(seq) + ":" +
+                        std::to_string(width)}));
+    model->addLayer(ml::train::layer::FullyConnected(
+      {"name=fc", "unit=" + std::to_string(unit), "input_layers=input0",
+       "dynamic_quantization=" + dynamic_quantization}));
+    model->setProperty({"batch_size=" + std::to_string(batch)});
+    EXPECT_EQ(model->compile(ml::train::ExecutionMode::INFERENCE),
+              ML_ERROR_NONE);
+    EXPECT_EQ(model->initialize(ml::train::ExecutionMode::INFERENCE),
+              ML_ERROR_NONE);
+    model->allocate(ml::train::ExecutionMode::INFERENCE);
+    return model;
+  };
+
+  auto set_weights = [&](ml::train::Model &model, float phase) {
+    std::vector<float> weight(width * unit), bias(unit);
+    for (unsigned int i = 0; i < weight.size(); ++i)
+      weight[i] = std::sin(0.37f * i + phase);
+    for (unsigned int i = 0; i < bias.size(); ++i)
+      bias[i] = std::cos(0.11f * i + phase);
+    std::shared_ptr<ml::train::Layer> fc;
+    model.getLayer("fc", &fc);
+    fc->setWeights({weight.data(), bias.data()});
+  };
+
+  std::vector<float> input_data(batch * seq * width);
+  for (unsigned int i = 0; i < input_data.size(); ++i)
+    input_data[i] = std::sin(0.23f * i);
+  std::vector<float *> input = {input_data.data()};
+
+  /// L2 norm of the difference relative to the FP32 output
+  auto error = [&](ml::train::Model &model, ml::train::Model &fp32) {
+    const float *out = model.inference(batch, input)[0];
+    const float *expected = fp32.inference(batch, input)[0];
+    float diff = 0.0f, norm = 0.0f;
+    for (unsigned int i = 0; i < batch * seq * unit; ++i) {
+      diff += (out[i] - expected[i]) * (out[i] - expected[i]);
+      norm += expected[i] * expected[i];
+    }
+    return std::sqrt(diff / norm);
+  };
+
+  auto fp32 = build("none");
+  for (const auto &[dynamic_quantization, max_error] :
+       {std::make_pair("int8", 0.02f), std::make_pair("int4", 0.25f)}) {
+    auto model = build(dynamic_quantization);
+    set_weights(*fp32, 0.0f);
+    set_weights(*model, 0.0f);
+    EXPECT_LT(error(*model, *fp32), max_error) << dynamic_quantization;
+
+    /// the quantized copy of the first weights is not used anymore
+    set_weights(*fp32, 1.0f);
+    set_weights(*model, 1.0f);
+    EXPECT_LT(error(*model, *fp32), max_error) << dynamic_quantization;
+  }
+}
+
+/**
+ * @brief token ids fed as UINT32 give the same embeddings as FP32 ids
+ */
+TEST(nntrainer_ccapi, uint32_token_input_p) {
+  const unsigned int batch = 2, seq = 5, in_dim = 32, out_dim = 8;
+
+  std::vector<float> weight(in_dim * out_dim);
+  for (unsigned int i = 0; i < weight.size(); ++i)
+    weight[i] = ((i * 7) % 13) / 13.0f - 0.5f;
+
+  auto build = [&](const std::string &dtype) {
+    auto model = ml::train::createModel(ml::train::ModelType::NEURAL_NET);
+    model->addLayer(ml::train::layer::Input(
+      {"name=input0", "input_shape=1:1:" + std::to_string(seq),
+       "tensor_dtype=" + dtype}));
+    model->addLayer(ml::train::layer::Embedding(
+      {"name=embedding", "in_dim=" + std::to_string(in_dim),
+       "out_dim=" + std::to_string(out_dim), "input_layers=input0"}));
+    model->setProperty({"batch_size=" + std::to_string(batch)});
+    EXPECT_EQ(model->compile(ml::train::ExecutionMode::INFERENCE),
+              ML_ERROR_NONE);
+    EXPECT_EQ(model->initialize(ml::train::ExecutionMode::INFERENCE),
+              ML_ERROR_NONE);
+    model->allocate(ml::train::ExecutionMode::INFERENCE);
+
+    std::shared_ptr<ml::train::Layer> embedding;
+    model->getLayer("embedding", &embedding);
+    embedding->setWeights({weight.data()});
+    return model;
+  };
+
+  std::vector<unsigned int> ids(batch * seq);
+  std::vector<float> float_ids(batch * seq);
+  for (unsigned int i = 0; i < ids.size(); ++i) {
+    ids[i] = (i * 11) % in_dim;
+    float_ids[i] = static_cast<float>(ids[i]);
+  }
+  std::vector<float *> label;
+
+  auto fp32 = build("fp32");
+  std::vector<float *> fp32_input = {float_ids.data()};
+  std::vector<float *> expected =
+    fp32->incremental_inference(batch, fp32_input, label, seq, 0, seq, true);
+
+  auto uint32 = build("uint32");
+  std::vector<float *> uint32_input = {reinterpret_cast<float *>(ids.data())};
+  std::vector<float *> out = uint32->incremental_inference(
+    batch, uint32_input, label, seq, 0, seq, true);
+
+  for (unsigned int i = 0; i < batch * seq * out_dim; ++i)
+    EXPECT_FLOAT_EQ(out[0][i], expected[0][i]);
+}
+
+/**
+ * @brief build a two fc model for the weight container tests
+ */
+static std::unique_ptr<ml::train::Model>
+buildContainerModel(const std::vector<std::string> &fc_names,
+                    ml::train::ExecutionMode mode) {
+  auto model = ml::train::createModel(ml::train::ModelType::NEURAL_NET);
+  model->addLayer(
+    ml::train::layer::Input({"name=input0", "input_shape=1:1:16"}));
+  for (auto &name : fc_names)
+    model->addLayer(ml::train::layer::FullyConnected(
+      {"name=" + name, "unit=16", "disable_bias=false"}));
+  if (mode == ml::train::ExecutionMode::TRAIN) {
+    model->addLayer(ml::train::loss::MSE({"name=loss"}));
+    model->setOptimizer(ml::train::optimizer::SGD({"learning_rate=0.1"}));
+  }
+  model->setProperty({"batch_size=2"});
+  EXPECT_EQ(model->compile(mode), ML_ERROR_NONE);
+  EXPECT_EQ(model->initialize(mode), ML_ERROR_NONE);
+  return model;
+}
+
+/**
+ * @brief Weight container round trip, loaded in place and copied
+ */
+TEST(nntrainer_ccapi, weight_container_save_load_p) {
+  const std::string container_path = "weight_container_p.bin";
+  const std::string bin_path = "weight_container_p_plain.bin";
+  std::vector<float> input(2 * 16);
+  for (unsigned int i = 0; i < input.size(); ++i)
+    input[i] = ((i * 5) % 11) / 11.0f - 0.5f;
+  std::vector<float *> in = {input.data()};
+
+  auto src =
+    buildContainerModel({"fc0", "fc1"}, ml::train::ExecutionMode::INFERENCE);
+  src->allocate(ml::train::ExecutionMode::INFERENCE);
+  for (const std::string name : {"fc0", "fc1"}) {
+    std::vector<float> weight(16 * 16), bias(16);
+    for (unsigned int i = 0; i < weight.size(); ++i)
+      weight[i] = ((i * 7 + name[2]) % 13) / 13.0f - 0.5f;
+    for (unsigned int i = 0; i < bias.size(); ++i)
+      bias[i] = i / 16.0f;
+    std::shared_ptr<ml::train::Layer> fc;
+    src->getLayer(name.c_str(), &fc);
+    fc->setWeights({weight.data(), bias.data()});
+  }
+  float *out = src->inference(2, in)[0];
+  std::vector<float> expected(out, out + 2 * 16);
+
+  EXPECT_NO_THROW(src->save(
+    container_path, ml::train::ModelFormat::MODEL_FORMAT_WEIGHT_CONTAINER));
+  EXPECT_NO_THROW(
+    src->save(bin_path, ml::train::ModelFormat::MODEL_FORMAT_BIN));
+
+  /// found by its magic when loaded as a binary
+  auto in_place =
+    buildContainerModel({"fc0", "fc1"}, ml::train::ExecutionMode::INFERENCE);
+  EXPECT_NO_THROW(
+    in_place->load(container_path, ml::train::ModelFormat::MODEL_FORMAT_BIN));
+  out = in_place->inference(2, in)[0];
+  for (unsigned int i = 0; i < expected.size(); ++i)
+    EXPECT_FLOAT_EQ(out[i], expected[i]);
+
+  auto copied =
+    buildContainerModel({"fc0", "fc1"}, ml::train::ExecutionMode::TRAIN);
+  EXPECT_NO_THROW(copied->load(
+    container_path, ml::train::ModelFormat::MODEL_FORMAT_WEIGHT_CONTAINER));
+  out = copied->inference(2, in)[0];
+  for (unsigned int i = 0; i < expected.size(); ++i)
+    EXPECT_FLOAT_EQ(out[i], expected[i]);
+
+  /// the plain binary is still read in graph order
+  auto plain =
+    buildContainerModel({"fc0", "fc1"}, ml::train::ExecutionMode::INFERENCE);
+  EXPECT_NO_THROW(
+    plain->load(bin_path, ml::train::ModelFormat::MODEL_FORMAT_BIN));
+  out = plain->inference(2, in)[0];
+  for (unsigned int i = 0; i < expected.size(); ++i)
+    EXPECT_FLOAT_EQ(out[i], expected[i]);
+
+  std::remove(container_path.c_str());
+  std::remove(bin_path.c_str());
+}
+
+/**
+ * @brief Weight container without a weight of the model
+ */
+TEST(nntrainer_ccapi, weight_container_missing_weight_n) {
+  const std::string container_path = "weight_container_n.bin";
+
+  auto src = buildContainerModel({"fc0"}, ml::train::ExecutionMode::INFERENCE);
+  src->allocate(ml::train::ExecutionMode::INFERENCE);
+  EXPECT_NO_THROW(src->save(
+    container_path, ml::train::ModelFormat::MODEL_FORMAT_WEIGHT_CONTAINER));
+
+  auto dst =
+    buildContainerModel({"fc0", "fc1"}, ml::train::ExecutionMode::INFERENCE);
+  EXPECT_THROW(
+    dst->load(container_path, ml::train::ModelFormat::MODEL_FORMAT_BIN),
+    std::invalid_argument);
+
+  std::remove(container_path.c_str());
+}
+
+/**
+ * @brief Weight container with a data type code unknown to the reader
+ */
+TEST(nntrainer_ccapi, weight_container_unknown_type_n) {
+  const std::string container_path = "weight_container_type_n.bin";
+
+  auto src = buildContainerModel({"fc0"}, ml::train::ExecutionMode::INFERENCE);
+  src->allocate(ml::train::ExecutionMode::INFERENCE);
+  EXPECT_NO_THROW(src->save(
+    container_path, ml::train::ModelFormat::MODEL_FORMAT_WEIGHT_CONTAINER));
+
+  /// the index starts after the 40 bytes header with the name of the first
+  /// entry, followed by its data type code
+  std::fstream file(container_path,
+                    std::ios::in | std::ios::out | std::ios::binary);
+  uint32_t name_len = 0;
+  file.seekg(40);
+  file.read(reinterpret_cast<char *>(&name_len), sizeof(name_len));
+  const uint32_t unknown_type = 0xff;
+  file.seekp(44 + name_len);
+  file.write(reinterpret_cast<const char *>(&unknown_type),
+             sizeof(unknown_type));
+  file.close();
+
+  auto dst = buildContainerModel({"fc0"}, ml::train::ExecutionMode::INFERENCE);
+  EXPECT_THROW(
+    dst->load(container_path, ml::train::ModelFormat::MODEL_FORMAT_BIN),
+    std::invalid_argument);
+
+  std::remove(container_path.c_str());
+}
+
+/**
+ * @brief token samples of the linear cross entropy tests
+ */
+struct TokenData {
+  static constexpr unsigned int seq = 4, hidden = 8, classes = 24;
+  static constexpr unsigned int num_samples = 8;
+  unsigned int count = 0;
+};
+
+/**
+ * @brief generator of hidden states and the class index of every token, the
+ * last token of every other sample is dropped from the loss
+ */
+static int getTokenSample(float **outVec, float **outLabel, bool *last,
+                          void *user_data) {
+  auto data = reinterpret_cast<TokenData *>(user_data);
+  const unsigned int n = data->count;
+  for (unsigned int i = 0; i < TokenData::seq * TokenData::hidden; ++i)
+    outVec[0][i] = (((n * 13 + i * 7) % 17) / 17.0f) - 0.5f;
+  for (unsigned int t = 0; t < TokenData::seq; ++t)
+    outLabel[0][t] = (n * 5 + t * 3) % TokenData::classes;
+  if (n % 2)
+    outLabel[0][TokenData::seq - 1] = -1.0f;
+
+  *last = ++data->count == TokenData::num_samples;
+  if (*last)
+    data->count = 0;
+  return ML_ERROR_NONE;
+}
+
+/**
+ * @brief train a model ending in a linear cross entropy loss, and check which
+ * weights the training changed
+ */
+static void trainLinearCrossEntropy(bool trainable) {
+  auto model = ml::train::createModel(ml::train::ModelType::NEURAL_NET);
+  model->addLayer(ml::train::layer::Input(
+    {"name=input0", "input_shape=1:1:" + std::to_string(TokenData::seq) + ":" +
+                      std::to_string(TokenData::hidden)}));
+  model->addLayer(ml::train::layer::FullyConnected(
+    {"name=fc", "unit=" + std::to_string(TokenData::hidden)}));
+  model->addLayer(ml::train::createLayer(
+    "linear_cross_entropy",
+    {"name=lce", "unit=" + std::to_string(TokenData::classes), "vocab_chunk=8",
+     std::string("trainable=") + (trainable ? "true" : "false")}));
+  model->setOptimizer(ml::train::optimizer::SGD({"learning_rate=0.5"}));
+  model->setProperty({"batch_size=2", "epochs=3"});
+
+  TokenData data;
+  std::shared_ptr<ml::train::Dataset> dataset = ml::train::createDataset(
+    ml::train::DatasetType::GENERATOR, getTokenSample, &data);
+  EXPECT_EQ(model->setDataset(ml::train::DatasetModeType::MODE_TRAIN, dataset),
+            ML_ERROR_NONE);
+
+  EXPECT_EQ(model->compile(), ML_ERROR_NONE);
+  EXPECT_EQ(model->initialize(), ML_ERROR_NONE);
+  model->allocate(ml::train::ExecutionMode::TRAIN);
+
+  auto snapshot = [&model](const std::string &name) {
+    std::shared_ptr<ml::train::Layer> layer;
+    model->getLayer(name.c_str(), &layer);
+    std::vector<float *> weights;
+    std::vector<ml::train::TensorDim> dims;
+    layer->getWeights(weights, dims);
+    std::vector<float> values;
+    for (unsigned int i = 0; i < weights.size(); ++i)
+      values.insert(values.end(), weights[i],
+                    weights[i] + dims[i].getDataLen());
+    return values;
+  };
+  const std::vector<float> fc_before = snapshot("fc");
+  const std::vector<float> lce_before = snapshot("lce");
+
+  EXPECT_NO_THROW(model->train());
+  EXPECT_TRUE(std::isfinite(model->getTrainingLoss()));
+  EXPECT_GT(model->getTrainingLoss(), 0.0f);
+
+  /// the derivative reaches fc whether or not the loss layer is trained
+  EXPECT_NE(snapshot("fc"), fc_before);
+  if (trainable)
+    EXPECT_NE(snapshot("lce"), lce_before);
+  else
+    EXPECT_EQ(snapshot("lce"), lce_before);
+
+  /// without a label the loss layer outputs zeros, not the logits
+  std::vector<float> input(2 * TokenData::seq * TokenData::hidden, 0.25f);
+  std::vector<float *> in = {input.data()};
+  float *out = model->inference(2, in)[0];
+  for (unsigned int i = 0; i < 2 * TokenData::seq; ++i)
+    EXPECT_EQ(out[i], 0.0f);
+}
+
+/**
+ * @brief linear cross entropy trains its weights and the layers before it
+ */
+TEST(nntrainer_ccapi, train_linear_cross_entropy_p) {
+  trainLinearCrossEntropy(true);
+}
+
+/**
+ * @brief non-trainable linear cross entropy keeps its weights and still
+ * passes the derivative back
+ */
+TEST(nntrainer_ccapi, train_linear_cross_entropy_not_trainable_p) {
+  trainLinearCrossEntropy(false);
+}
+
 /**
  * @brief Main gtest
  */
@@ -0,0 +1,32 @@
+#!/usr/bin/env bash
+#
+# Check that a library built with ISA specific flags (e.g. -mavx2) shares no
+# code with the baseline objects.
+#
+# Inline functions and template instantiations are emitted as weak symbols in
+# every object that uses them and the linker keeps only one of the copies. If
+# the copy of an AVX2 object is kept, baseline code runs AVX2 instructions on
+# CPUs without AVX2. Static initializers of such objects run at load time,
+# before any CPUID check. Both must be absent.
+#
+# usage: check_isa_objects.sh <nm> <library>
+
+nm_prog="$1"
+lib="$2"
+status=0
+
+weak=$("$nm_prog" -C --defined-only "$lib" | grep -E ' [Ww] ')
+if [ -n "$weak" ]; then
+  echo "$lib defines weak symbols:"
+  echo "$weak"
+  status=1
+fi
+
+init=$("$nm_prog" -C --defined-only "$lib" | grep '_GLOBAL__sub_I_')
+if [ -n "$init" ]; then
+  echo "$lib has static initializers:"
+  echo "$init"
+  status=1
+fi
+
+exit $status
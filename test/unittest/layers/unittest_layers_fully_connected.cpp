@@ -22,8 +22,21 @@ auto semantic_fc = LayerSemanticsParamType(
   nntrainer::FullyConnectedLayer::type, {"unit=1"},
   LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 1);
 
+auto semantic_fc_dynamic_quantization = LayerSemanticsParamType(
+  nntrainer::createLayer<nntrainer::FullyConnectedLayer>,
+  nntrainer::FullyConnectedLayer::type,
+  {"unit=1", "dynamic_quantization=int8"},
+  LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 1);
+
+auto semantic_fc_last_step_only = LayerSemanticsParamType(
+  nntrainer::createLayer<nntrainer::FullyConnectedLayer>,
+  nntrainer::FullyConnectedLayer::type, {"unit=1", "last_step_only=true"},
+  LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 1);
+
 GTEST_PARAMETER_TEST(FullyConnected, LayerSemantics,
-                     ::testing::Values(semantic_fc));
+                     ::testing::Values(semantic_fc,
+                                       semantic_fc_dynamic_quantization,
+                                       semantic_fc_last_step_only));
 
 auto fc_basic_plain = LayerGoldenTestParamType(
   nntrainer::createLayer<nntrainer::FullyConnectedLayer>, {"unit=5"},
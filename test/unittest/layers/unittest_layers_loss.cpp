@@ -9,6 +9,7 @@
  * @author Parichay Kapoor <pk.kapoor@samsung.com>
  * @bug No known bugs except for NYI items
  */
+#include <cmath>
 #include <tuple>
 
 #include <gtest/gtest.h>
@@ -18,8 +19,12 @@
 #include <cross_entropy_sigmoid_loss_layer.h>
 #include <cross_entropy_softmax_loss_layer.h>
 #include <kld_loss_layer.h>
+#include <layer_context.h>
 #include <layers_common_tests.h>
+#include <linear_cross_entropy_loss_layer.h>
 #include <mse_loss_layer.h>
+#include <var_grad.h>
+#include <weight.h>
 
 auto semantic_loss_cross_sigmoid = LayerSemanticsParamType(
   nntrainer::createLayer<nntrainer::CrossEntropySigmoidLossLayer>,
@@ -45,6 +50,11 @@ auto semantic_loss_constant_derivative = LayerSemanticsParamType(
   nntrainer::ConstantDerivativeLossLayer::type, {},
   LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 1);
 
+auto semantic_loss_linear_cross_entropy = LayerSemanticsParamType(
+  nntrainer::createLayer<nntrainer::LinearCrossEntropyLossLayer>,
+  nntrainer::LinearCrossEntropyLossLayer::type, {"unit=1"},
+  LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 1);
+
 auto semantic_loss_cross = LayerSemanticsParamType(
   nntrainer::createLayer<nntrainer::CrossEntropyLossLayer>,
   nntrainer::CrossEntropyLossLayer::type, {}, 0, true, 1);
@@ -54,4 +64,108 @@ GTEST_PARAMETER_TEST(LossCross, LayerSemantics,
                                        semantic_loss_cross_softmax,
                                        semantic_loss_cross_sigmoid,
                                        semantic_loss_constant_derivative,
-                                       semantic_loss_kld));
+                                       semantic_loss_kld,
+                                       semantic_loss_linear_cross_entropy));
+
+/**
+ * @brief fused linear cross entropy matches a fully connected layer followed
+ * by softmax cross entropy, with a vocabulary not divisible by the chunk and
+ * a token dropped from the loss
+ */
+TEST(LinearCrossEntropyLoss, matches_unfused_p) {
+  const unsigned int B = 2, T = 3, H = 8, V = 37;
+  const float labels[B * T] = {3, 36, -1, 0, 17, 8};
+
+  auto layer = nntrainer::createLayer<nntrainer::LinearCrossEntropyLossLayer>(
+    {"unit=37", "vocab_chunk=8"});
+  nntrainer::InitLayerContext ic({nntrainer::TensorDim(B, 1, T, H)}, {true},
+                                 false, "lce");
+  layer->finalize(ic);
+  EXPECT_EQ(ic.getOutSpecs()[0].variable_spec.dim,
+            nntrainer::TensorDim(B, 1, T, 1));
+
+  std::vector<nntrainer::Weight> weights;
+  std::vector<nntrainer::Var_Grad> ins, outs, tensors;
+  weights.reserve(ic.getWeightsSpec().size());
+  for (auto &spec : ic.getWeightsSpec())
+    weights.emplace_back(spec, true);
+  ins.emplace_back(ic.getInputDimensions()[0], nntrainer::Initializer::NONE,
+                   true, true, "in");
+  outs.emplace_back(ic.getOutSpecs()[0].variable_spec.dim,
+                    nntrainer::Initializer::NONE, true, true, "out");
+  tensors.reserve(ic.getTensorsSpec().size());
+  for (auto &spec : ic.getTensorsSpec())
+    tensors.emplace_back(spec, true);
+
+  nntrainer::Tensor &x = ins[0].getVariableRef();
+  nntrainer::Tensor &w = weights[0].getVariableRef();
+  nntrainer::Tensor &b = weights[1].getVariableRef();
+  for (unsigned int i = 0; i < x.size(); ++i)
+    x.getData<float>()[i] = std::sin(0.3f * i);
+  for (unsigned int i = 0; i < w.size(); ++i)
+    w.getData<float>()[i] = 0.5f * std::cos(0.7f * i);
+  for (unsigned int i = 0; i < b.size(); ++i)
+    b.getData<float>()[i] = 0.1f * std::sin(1.3f * i);
+  std::copy(labels, labels + B * T, outs[0].getGradientRef().getData<float>());
+
+  nntrainer::RunLayerContext rc(
+    "lce", true, 0.0f, false, 1.0f, nullptr, false,
+    {&weights[0], &weights[1]}, {&ins[0]}, {&outs[0]}, {&tensors[0]});
+
+  /** reference: full logits, softmax and its derivative */
+  nntrainer::Tensor logits = x.dot(w);
+  logits.add_i(b);
+  nntrainer::Tensor d_logits(logits.getDim());
+  float ref_loss = 0.0f;
+  for (unsigned int r = 0; r < B * T; ++r) {
+    const float *z = logits.getData<float>() + r * V;
+    float *dz = d_logits.getData<float>() + r * V;
+    float max = *std::max_element(z, z + V), sum = 0.0f;
+    for (unsigned int j = 0; j < V; ++j)
+      sum += std::exp(z[j] - max);
+    for (unsigned int j = 0; j < V; ++j)
+      dz[j] = labels[r] < 0 ? 0.0f : std::exp(z[j] - max) / sum / B;
+    if (labels[r] >= 0) {
+      dz[(int)labels[r]] -= 1.0f / B;
+      ref_loss += max + std::log(sum) - z[(int)labels[r]];
+    }
+  }
+  ref_loss /= B;
+  nntrainer::Tensor ref_dx = d_logits.dot(w, false, true);
+  nntrainer::Tensor ref_dw = x.dot(d_logits, true, false);
+  nntrainer::Tensor ref_db = d_logits.sum({0, 1, 2});
+
+  layer->forwarding(rc, true);
+  EXPECT_NEAR(rc.getLoss(), ref_loss, 1e-5f);
+  EXPECT_FLOAT_EQ(rc.getOutput(0).getValue<float>(0, 0, 2, 0), 0.0f);
+
+  layer->calcGradient(rc);
+  layer->calcDerivative(rc);
+  auto expect_near = [](const nntrainer::Tensor &a,
+                        const nntrainer::Tensor &ref) {
+    ASSERT_EQ(a.size(), ref.size());
+    for (unsigned int i = 0; i < a.size(); ++i)
+      EXPECT_NEAR(a.getData<float>()[i], ref.getData<float>()[i], 1e-5f);
+  };
+  expect_near(rc.getOutgoingDerivative(0), ref_dx);
+  expect_near(rc.getWeightGrad(0), ref_dw);
+  expect_near(rc.getWeightGrad(1), ref_db);
+
+  /** derivative only, as with a frozen head */
+  rc.getOutgoingDerivative(0).setZero();
+  layer->forwarding(rc, true);
+  layer->calcDerivative(rc);
+  expect_near(rc.getOutgoingDerivative(0), ref_dx);
+}
+
+/**
+ * @brief only FP32 activations are supported
+ */
+TEST(LinearCrossEntropyLoss, fp16_activation_n) {
+  auto layer = nntrainer::createLayer<nntrainer::LinearCrossEntropyLossLayer>(
+    {"unit=4"});
+  nntrainer::InitLayerContext ic({nntrainer::TensorDim(1, 1, 2, 4)}, {true},
+                                 false, "lce", "", 0.0f,
+                                 {"NCHW", "FP32", "FP16"});
+  EXPECT_THROW(layer->finalize(ic), std::invalid_argument);
+}
@@ -13,8 +13,10 @@
 
 #include <gtest/gtest.h>
 
+#include <layer_context.h>
 #include <layers_common_tests.h>
 #include <multiout_layer.h>
+#include <var_grad.h>
 
 auto semantic_output = LayerSemanticsParamType(
   nntrainer::createLayer<nntrainer::MultiOutLayer>,
@@ -23,3 +25,37 @@ auto semantic_output = LayerSemanticsParamType(
 
 GTEST_PARAMETER_TEST(Output, LayerSemantics,
                      ::testing::Values(semantic_output));
+
+/**
+ * @brief a multi token step that starts at from > 0 copies its to - from rows
+ * into every output and leaves the other rows alone
+ */
+TEST(MultiOutLayer, incremental_forwarding_multi_row_p) {
+  nntrainer::MultiOutLayer layer;
+  nntrainer::InitLayerContext ic({nntrainer::TensorDim(1, 1, 8, 4)},
+                                 {true, true}, false, "multiout");
+  layer.finalize(ic);
+
+  nntrainer::Var_Grad in(ic.getInputDimensions()[0],
+                         nntrainer::Initializer::NONE, false, true, "in");
+  std::vector<nntrainer::Var_Grad> outs;
+  for (auto &spec : ic.getOutSpecs())
+    outs.emplace_back(spec.variable_spec.dim, nntrainer::Initializer::ZEROS,
+                      false, true, "out");
+  nntrainer::RunLayerContext rc("multiout", false, 0.0f, false, 1.0f, nullptr,
+                                false, {}, {&in}, {&outs[0], &outs[1]}, {});
+
+  nntrainer::Tensor &input = rc.getInput(0);
+  for (unsigned int i = 0; i < input.size(); ++i)
+    input.getData<float>()[i] = i + 1.0f;
+
+  layer.incremental_forwarding(rc, 5, 8, false);
+
+  for (unsigned int o = 0; o < 2; ++o) {
+    const float *out = rc.getOutput(o).getData<float>();
+    for (unsigned int i = 0; i < 3 * 4; ++i)
+      EXPECT_FLOAT_EQ(out[i], i + 1.0f);
+    for (unsigned int i = 3 * 4; i < 8 * 4; ++i)
+      EXPECT_FLOAT_EQ(out[i], 0.0f);
+  }
+}
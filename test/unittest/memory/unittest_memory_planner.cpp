@@ -19,7 +19,9 @@
 #include <memory_pool.h>
 #include <nntrainer_test_util.h>
 #include <numeric>
+#include <optimal_fit_planner.h>
 #include <optimized_v1_planner.h>
+#include <optimized_v3_planner.h>
 
 constexpr unsigned int MEM_BYTES = 128;
 constexpr unsigned int MEM_QUANT = 100;
@@ -329,8 +331,10 @@ TEST_P(MemoryPlannerValidate, validate_memory_no_overlap) {
     EXPECT_NO_THROW(ptrs[idx] = pool.getMemory(tokens[idx]));
   }
 
-  // TODO need to investigate what's wrong with OptimizedV1Planner
-  if (planner->getType() != nntrainer::OptimizedV1Planner::type) {
+  /** memories of other planners are reused once their validity ends, so
+   * writing all of them before reading them back only holds for the basic
+   * planner */
+  if (planner->getType() == nntrainer::BasicPlanner::type) {
     /** write data to memory */
     for (unsigned int idx = 0; idx < MEM_QUANT; idx++) {
       std::memset(ptrs[idx]->getAddr(), idx, memory_size[idx]);
@@ -384,8 +388,10 @@ TEST_P(MemoryPlannerValidate, validate_memory_partial_overlap) {
   for (unsigned int idx = 0; idx < MEM_QUANT; idx++)
     EXPECT_NO_THROW(ptrs[idx] = pool.getMemory(tokens[idx]));
 
-  // TODO need to investigate what's wrong with OptimizedV1Planner
-  if (planner->getType() != nntrainer::OptimizedV1Planner::type) {
+  /** memories of other planners are reused once their validity ends, so
+   * writing all of them before reading them back only holds for the basic
+   * planner */
+  if (planner->getType() == nntrainer::BasicPlanner::type) {
     /** write data to memory */
     for (unsigned int idx = 0; idx < MEM_QUANT; idx++)
       memset(ptrs[idx]->getAddr(), idx, memory_size[idx]);
@@ -401,7 +407,48 @@ TEST_P(MemoryPlannerValidate, validate_memory_partial_overlap) {
   pool.deallocate();
 }
 
+/**
+ * @brief optimal fit layout is not larger than the optimized ones and is
+ * reused for the same requests
+ */
+TEST(OptimalFitPlanner, smaller_than_optimized_p) {
+  std::mt19937 rng;
+  std::uniform_int_distribution<size_t> dist(1, MEM_BYTES);
+  std::uniform_int_distribution<unsigned int> dist_interval(1, INTERVAL_SIZE);
+  std::uniform_int_distribution<unsigned int> dist_interval_start(1, 100);
+
+  std::vector<size_t> memory_size(MEM_QUANT);
+  std::vector<std::pair<unsigned int, unsigned int>> memory_validity(MEM_QUANT);
+  for (unsigned int idx = 0; idx < MEM_QUANT; idx++) {
+    memory_size[idx] = dist(rng);
+    unsigned int start = dist_interval_start(rng);
+    memory_validity[idx] = {start, start + dist_interval(rng)};
+  }
+
+  std::vector<size_t> offset, cached_offset;
+  std::vector<bool> memory_is_wgrad;
+  nntrainer::OptimalFitPlanner::clearCache();
+  size_t pool_size = nntrainer::OptimalFitPlanner().planLayout(
+    memory_size, memory_validity, offset, memory_is_wgrad, 0);
+  EXPECT_TRUE(validateOverflow(memory_size, offset, pool_size));
+  EXPECT_TRUE(validateIntervalOverlap(memory_validity, memory_size, offset));
+
+  std::vector<size_t> v1_offset, v3_offset;
+  EXPECT_LE(pool_size,
+            nntrainer::OptimizedV1Planner().planLayout(
+              memory_size, memory_validity, v1_offset, memory_is_wgrad, 0));
+  EXPECT_LE(pool_size,
+            nntrainer::OptimizedV3Planner().planLayout(
+              memory_size, memory_validity, v3_offset, memory_is_wgrad, 0));
+
+  EXPECT_EQ(pool_size,
+            nntrainer::OptimalFitPlanner().planLayout(
+              memory_size, memory_validity, cached_offset, memory_is_wgrad, 0));
+  EXPECT_EQ(offset, cached_offset);
+}
+
 GTEST_PARAMETER_TEST(
   MemoryPlanner, MemoryPlannerValidate,
   ::testing::Values(std::make_shared<nntrainer::BasicPlanner>(),
-                    std::make_shared<nntrainer::OptimizedV1Planner>()));
+                    std::make_shared<nntrainer::OptimizedV1Planner>(),
+                    std::make_shared<nntrainer::OptimalFitPlanner>()));
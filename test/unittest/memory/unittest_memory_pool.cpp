@@ -11,7 +11,9 @@
  * @bug No known bugs except for NYI items
  */
 
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <memory>
 #include <random>
 #include <vector>
@@ -436,6 +438,41 @@ TEST_P(MemoryPoolTest, get_memory_04_p) {
   EXPECT_NO_THROW(pool.deallocate());
 }
 
+/**
+ * @brief save and load memory requests
+ */
+TEST(MemoryPool, save_load_requests_p) {
+  const std::string path = "memory_pool_requests.txt";
+  nntrainer::MemoryPool pool, replayed;
+
+  pool.requestMemory(10, 1, 4);
+  pool.requestMemory(20, 2, 5, {}, nntrainer::TensorLifespan::MAX_LIFESPAN,
+                     true);
+  pool.requestMemory(30, 4, 6);
+  EXPECT_NO_THROW(pool.saveRequests(path));
+  EXPECT_NO_THROW(replayed.loadRequests(path));
+  std::remove(path.c_str());
+
+  EXPECT_EQ(pool.minMemoryRequirement(), replayed.minMemoryRequirement());
+  EXPECT_NO_THROW(pool.planLayout(nntrainer::BasicPlanner()));
+  EXPECT_NO_THROW(replayed.planLayout(nntrainer::BasicPlanner()));
+  EXPECT_EQ(pool.size(), replayed.size());
+}
+
+/**
+ * @brief load memory requests from a file which is not a request file
+ */
+TEST(MemoryPool, load_requests_n) {
+  const std::string path = "memory_pool_requests_n.txt";
+  std::ofstream(path) << "10 1 4 0\n";
+  nntrainer::MemoryPool pool;
+
+  EXPECT_THROW(pool.loadRequests(path), std::invalid_argument);
+  EXPECT_THROW(pool.loadRequests("not_existing_requests.txt"),
+               std::invalid_argument);
+  std::remove(path.c_str());
+}
+
 GTEST_PARAMETER_TEST(
   MemoryPool, MemoryPoolTest,
   ::testing::Values(std::make_shared<nntrainer::MemoryPool>(),
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Copyright (C) 2026 Samsung Electronics Co., Ltd. All Rights Reserved.
+ *
+ * @file unittest_scratch_arena.cpp
+ * @date 19 October 2026
+ * @brief Scratch Arena Test
+ * @see	https://github.com/nnstreamer/nntrainer
+ * @author Samsung Electronics Co., Ltd.
+ * @bug No known bugs except for NYI items
+ */
+
+#include <cstdint>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <scratch_arena.h>
+#include <tensor.h>
+
+using nntrainer::ScratchArena;
+
+/**
+ * @brief allocations are aligned and released when the scope ends
+ */
+TEST(ScratchArena, scope_rewind_p) {
+  ScratchArena arena;
+  void *first = nullptr;
+  {
+    ScratchArena::Scope scope(arena);
+    EXPECT_TRUE(arena.inScope());
+    first = arena.allocate(10);
+    void *second = arena.allocate(100);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % ScratchArena::ALIGNMENT,
+              0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % ScratchArena::ALIGNMENT,
+              0u);
+    EXPECT_EQ(static_cast<char *>(second) - static_cast<char *>(first),
+              static_cast<std::ptrdiff_t>(ScratchArena::ALIGNMENT));
+    EXPECT_EQ(arena.getStats().used_bytes, 64u + 128u);
+  }
+  EXPECT_FALSE(arena.inScope());
+  EXPECT_EQ(arena.getStats().used_bytes, 0u);
+  EXPECT_EQ(arena.getStats().peak_bytes, 192u);
+
+  ScratchArena::Scope scope(arena);
+  EXPECT_EQ(arena.allocate(1), first);
+  EXPECT_EQ(arena.getStats().num_blocks, 1u);
+}
+
+/**
+ * @brief an inner scope releases only its own allocations
+ */
+TEST(ScratchArena, nested_scope_p) {
+  ScratchArena arena;
+  ScratchArena::Scope outer(arena);
+  char *kept = static_cast<char *>(arena.allocate(64));
+  kept[0] = 7;
+  void *inner_ptr = nullptr;
+  {
+    ScratchArena::Scope inner(arena);
+    inner_ptr = arena.allocate(256);
+    EXPECT_EQ(arena.getStats().used_bytes, 320u);
+  }
+  EXPECT_EQ(arena.getStats().used_bytes, 64u);
+  EXPECT_EQ(arena.allocate(256), inner_ptr);
+  EXPECT_EQ(kept[0], 7);
+}
+
+/**
+ * @brief blocks added during a call are merged into one block of the peak
+ */
+TEST(ScratchArena, coalesce_blocks_p) {
+  ScratchArena arena;
+  const size_t big = 3 * ScratchArena::MIN_BLOCK_BYTES;
+  {
+    ScratchArena::Scope scope(arena);
+    arena.allocate(ScratchArena::MIN_BLOCK_BYTES);
+    arena.allocate(big);
+    EXPECT_EQ(arena.getStats().num_blocks, 2u);
+  }
+  const size_t peak = arena.getStats().peak_bytes;
+  EXPECT_EQ(peak, ScratchArena::MIN_BLOCK_BYTES + big);
+  EXPECT_EQ(arena.getStats().reserved_bytes, peak);
+
+  arena.resetStats();
+  {
+    ScratchArena::Scope scope(arena);
+    arena.allocate(ScratchArena::MIN_BLOCK_BYTES);
+    arena.allocate(big);
+  }
+  EXPECT_EQ(arena.getStats().num_blocks, 0u);
+  EXPECT_EQ(arena.getStats().num_allocations, 2u);
+}
+
+/**
+ * @brief allocating without a scope is an error
+ */
+TEST(ScratchArena, allocate_without_scope_n) {
+  ScratchArena arena;
+  EXPECT_THROW(arena.allocate(16), std::runtime_error);
+}
+
+/**
+ * @brief tensors from a scope live on the arena, others are allocated
+ */
+TEST(ScratchArena, get_tensor_p) {
+  ScratchArena arena;
+  nntrainer::TensorDim dim(1, 2, 3, 5);
+
+  nntrainer::Tensor unscoped = arena.getTensor(dim);
+  EXPECT_TRUE(unscoped.isAllocated());
+  EXPECT_EQ(unscoped.getDim(), dim);
+  EXPECT_EQ(arena.getStats().num_unscoped, 1u);
+
+  ScratchArena::Scope scope(arena);
+  nntrainer::Tensor t = arena.getTensor(dim);
+  EXPECT_EQ(t.getDim(), dim);
+  t.setValue(2.0f);
+  EXPECT_FLOAT_EQ(t.getValue<float>(0, 1, 2, 4), 2.0f);
+  EXPECT_EQ(arena.getStats().used_bytes, 128u);
+  EXPECT_EQ(arena.getStats().num_unscoped, 1u);
+}
+
+/**
+ * @brief every thread gets its own arena
+ */
+TEST(ScratchArena, thread_local_p) {
+  ScratchArena *main_arena = &ScratchArena::threadLocal();
+  ScratchArena *other_arena = nullptr;
+  std::thread worker([&]() { other_arena = &ScratchArena::threadLocal(); });
+  worker.join();
+
+  EXPECT_EQ(main_arena, &ScratchArena::threadLocal());
+  EXPECT_NE(main_arena, other_arena);
+}
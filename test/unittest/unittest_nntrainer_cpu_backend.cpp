@@ -12,11 +12,17 @@
 #include <cpu_backend.h>
 #include <fallback_internal.h>
 #include <fp16.h>
+#include <gemm_tuner.h>
 #include <gtest/gtest.h>
 #include <numeric>
 #include <random>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i586__) || defined(_M_X64) ||             \
+  defined(_M_IX86)
+#include <x86_cpu_features.h>
+#endif
+
 #include <chrono>
 #include <iostream>
 using std::chrono::duration_cast;
@@ -507,6 +513,57 @@ TEST(nntrainer_cpu_backend_standalone, quant_GEMV_1x512x512) {
   ASSERT_LE(q6_k_mse, q4_k_mse);
 }
 
+TEST(nntrainer_cpu_backend_standalone, gemm_tuner_tuned_matches_default) {
+  const unsigned int M = 7;
+  const unsigned int K = 512;
+  const unsigned int N = 1024;
+  nntrainer::init_backend();
+  auto &tuner = nntrainer::GemmTuner::Global();
+  const bool online = tuner.getOnlineTuning();
+
+  std::vector<float> activation = generate_random_vector<float>(M * K);
+  std::vector<float> weight = generate_random_vector<float>(N * K);
+  size_t q4_0_data_size = sizeof(block_q4_0_testonly) * N / 32 * K;
+  std::vector<char> q4_0_weight(q4_0_data_size);
+  std::vector<char> q4_0_repacked(q4_0_data_size);
+  nntrainer::quantize_q4_0(weight.data(), q4_0_weight.data(), N, K, nullptr);
+  nntrainer::repack_q4_0(q4_0_repacked.data(), q4_0_weight.data(),
+                         q4_0_data_size, N, K);
+  std::vector<char> q6_k_weight(sizeof(block_q6_K_testonly) * N / 256 * K);
+  nntrainer::quantize_q6_K(weight.data(), q6_k_weight.data(), N, K, nullptr);
+
+  tuner.clear();
+  tuner.setOnlineTuning(false);
+  std::vector<float> q4_0_ref(M * N), q6_k_ref(M * N);
+  nntrainer::gemm_q4_0(M, N, K, activation.data(), K, q4_0_repacked.data(), N,
+                       q4_0_ref.data(), N);
+  nntrainer::gemm_q6_K(M, N, K, activation.data(), K, q6_k_weight.data(), N,
+                       q6_k_ref.data(), N);
+  EXPECT_EQ(tuner.size(), 0u);
+
+  tuner.setOnlineTuning(true);
+  std::vector<float> q4_0_dst(M * N), q6_k_dst(M * N);
+  nntrainer::gemm_q4_0(M, N, K, activation.data(), K, q4_0_repacked.data(), N,
+                       q4_0_dst.data(), N);
+  nntrainer::gemm_q6_K(M, N, K, activation.data(), K, q6_k_weight.data(), N,
+                       q6_k_dst.data(), N);
+  tuner.setOnlineTuning(online);
+  const size_t tuned = tuner.size();
+
+  for (unsigned int i = 0; i < M * N; ++i) {
+    EXPECT_FLOAT_EQ(q4_0_ref[i], q4_0_dst[i]);
+    EXPECT_FLOAT_EQ(q6_k_ref[i], q6_k_dst[i]);
+  }
+
+  const std::string file = "gemm_tuner_unittest.txt";
+  EXPECT_TRUE(tuner.save(file));
+  tuner.clear();
+  EXPECT_TRUE(tuner.load(file));
+  EXPECT_EQ(tuner.size(), tuned);
+  std::remove(file.c_str());
+  tuner.clear();
+}
+
 static void run_vec_dot_test(const uint32_t K, bool print = false) {
   const int TEST_CNT = 20;
   nanoseconds ref_time = (nanoseconds)0;
@@ -1177,6 +1234,387 @@ TEST(nntrainer_cpu_backend_standalone, clamp_3072_0_1) {
   run_clamp_test(N, lower_bound, upper_bound, false);
 }
 
+static void run_gemm_qai8_test(const unsigned int M, const unsigned int N,
+                               const unsigned int K, bool int4) {
+  std::vector<float> A = generate_random_vector<float>(M * K);
+  std::vector<float> W = generate_random_vector<float>(K * N);
+  std::vector<float> C(M * N), ref(M * N), fp32(M * N, 0.F);
+  std::vector<float> scales(N);
+
+  for (unsigned int m = 0; m < M; ++m)
+    for (unsigned int k = 0; k < K; ++k)
+      for (unsigned int n = 0; n < N; ++n)
+        fp32[m * N + n] += A[m * K + k] * W[k * N + n];
+
+  if (int4) {
+    std::vector<uint8_t> qW(N * K / 2);
+    nntrainer::quantize_qsi4cx(N, K, W.data(), false, qW.data(),
+                               scales.data());
+    nntrainer::gemm_qai8_qsi4cx(M, N, K, A.data(), K, qW.data(),
+                                scales.data(), C.data(), N);
+    nntrainer::__fallback_gemm_qai8_qsi4cx(M, N, K, A.data(), K, qW.data(),
+                                           scales.data(), ref.data(), N);
+  } else {
+    std::vector<int8_t> qW(N * K);
+    nntrainer::quantize_qsi8cx(N, K, W.data(), false, qW.data(),
+                               scales.data());
+    nntrainer::gemm_qai8_qsi8cx(M, N, K, A.data(), K, qW.data(),
+                                scales.data(), C.data(), N);
+    nntrainer::__fallback_gemm_qai8_qsi8cx(M, N, K, A.data(), K, qW.data(),
+                                           scales.data(), ref.data(), N);
+  }
+
+  /// integer accumulation is exact, so every ISA gives the same result
+  for (size_t i = 0; i < C.size(); i++) {
+    EXPECT_NEAR(ref[i], C[i], 1e-5f);
+  }
+
+  auto cos_sim = cosine_similarity(fp32.data(), C.data(), C.size());
+  EXPECT_GE(cos_sim, int4 ? 0.98 : 0.999);
+}
+
+TEST(nntrainer_cpu_backend_standalone, gemm_qai8_qsi8cx_1x96x100) {
+  run_gemm_qai8_test(1, 96, 100, false);
+}
+
+TEST(nntrainer_cpu_backend_standalone, gemm_qai8_qsi8cx_7x256x512) {
+  run_gemm_qai8_test(7, 256, 512, false);
+}
+
+TEST(nntrainer_cpu_backend_standalone, gemm_qai8_qsi4cx_1x96x96) {
+  run_gemm_qai8_test(1, 96, 96, true);
+}
+
+TEST(nntrainer_cpu_backend_standalone, gemm_qai8_qsi4cx_7x256x512) {
+  run_gemm_qai8_test(7, 256, 512, true);
+}
+
+static void run_kv_cache_quantized_test(const unsigned int bits,
+                                        size_t local_window_size) {
+  const int num_rows = 19, num_cache_head = 2, gqa_size = 3, head_dim = 64;
+  const unsigned int row_len = num_cache_head * head_dim;
+  const size_t num_q = (size_t)num_cache_head * gqa_size;
+  std::vector<float> K = generate_random_vector<float>(num_rows * row_len);
+  std::vector<float> V = generate_random_vector<float>(num_rows * row_len);
+  std::vector<float> Q = generate_random_vector<float>(num_q * head_dim);
+  std::vector<float> P =
+    generate_random_vector<float>(num_rows * num_q, 0.F, 1.F);
+
+  std::vector<uint8_t> kq(num_rows * row_len * bits / 8), vq(kq.size());
+  std::vector<uint8_t> kq_ref(kq.size());
+  std::vector<uint16_t> ks(num_rows * row_len / 32), vs(ks.size());
+  std::vector<uint16_t> ks_ref(ks.size());
+  std::vector<uint16_t> k16(K.size()), v16(V.size());
+  for (int r = 0; r < num_rows; ++r) {
+    nntrainer::quantize_kv_cache(row_len, &K[r * row_len],
+                                 &kq[r * row_len * bits / 8],
+                                 &ks[r * row_len / 32], bits);
+    nntrainer::quantize_kv_cache(row_len, &V[r * row_len],
+                                 &vq[r * row_len * bits / 8],
+                                 &vs[r * row_len / 32], bits);
+    nntrainer::__fallback_quantize_kv_cache(row_len, &K[r * row_len],
+                                            &kq_ref[r * row_len * bits / 8],
+                                            &ks_ref[r * row_len / 32], bits);
+  }
+  for (size_t i = 0; i < K.size(); ++i) {
+    k16[i] = nntrainer::compute_fp32_to_fp16(K[i]);
+    v16[i] = nntrainer::compute_fp32_to_fp16(V[i]);
+  }
+  EXPECT_EQ(kq, kq_ref);
+  EXPECT_EQ(ks, ks_ref);
+
+  /// attention scores against the quantized and the fp16 key cache
+  const int row_cnt = std::min<size_t>(num_rows, local_window_size);
+  std::vector<float> qk(row_cnt * num_q), qk_ref(qk.size()), qk16(qk.size());
+  nntrainer::compute_kcaches_quantized(Q.data(), kq.data(), ks.data(),
+                                       qk.data(), num_rows, num_cache_head,
+                                       head_dim, gqa_size, bits,
+                                       local_window_size);
+  nntrainer::__fallback_compute_kcaches_quantized(
+    Q.data(), kq.data(), ks.data(), qk_ref.data(), num_rows, num_cache_head,
+    head_dim, gqa_size, bits, local_window_size);
+  nntrainer::compute_kcaches<uint16_t>(Q.data(), k16.data(), qk16.data(),
+                                       num_rows, num_cache_head, head_dim,
+                                       gqa_size, 8, local_window_size);
+  for (size_t i = 0; i < qk.size(); i++) {
+    EXPECT_NEAR(qk_ref[i], qk[i], 1e-4f);
+  }
+  EXPECT_GE(cosine_similarity(qk16.data(), qk.data(), qk.size()),
+            bits == 8 ? 0.999 : 0.98);
+
+  /// weighted sum of the quantized and the fp16 value cache
+  std::vector<float> out(num_q * head_dim), out_ref(out.size()),
+    out16(out.size());
+  nntrainer::compute_vcache_quantized_transposed(
+    num_rows - 1, P.data(), vq.data(), vs.data(), out.data(), num_cache_head,
+    gqa_size, head_dim, bits, local_window_size);
+  nntrainer::__fallback_compute_vcache_quantized_transposed(
+    num_rows - 1, P.data(), vq.data(), vs.data(), out_ref.data(),
+    num_cache_head, gqa_size, head_dim, bits, local_window_size);
+  nntrainer::compute_fp16vcache_fp32_transposed(
+    num_rows - 1, P.data(), v16.data(), out16.data(), num_cache_head, gqa_size,
+    head_dim, local_window_size);
+  for (size_t i = 0; i < out.size(); i++) {
+    EXPECT_NEAR(out_ref[i], out[i], 1e-4f);
+  }
+  EXPECT_GE(cosine_similarity(out16.data(), out.data(), out.size()),
+            bits == 8 ? 0.999 : 0.98);
+}
+
+TEST(nntrainer_cpu_backend_standalone, kv_cache_int8) {
+  run_kv_cache_quantized_test(8, UINT_MAX);
+}
+
+TEST(nntrainer_cpu_backend_standalone, kv_cache_int4) {
+  run_kv_cache_quantized_test(4, UINT_MAX);
+}
+
+TEST(nntrainer_cpu_backend_standalone, kv_cache_int8_sliding_window) {
+  run_kv_cache_quantized_test(8, 7);
+}
+
+TEST(nntrainer_cpu_backend_standalone, kv_cache_head_range) {
+  const int num_rows = 13, num_cache_head = 4, gqa_size = 2, head_dim = 64;
+  const unsigned int bits = 8;
+  const unsigned int row_len = num_cache_head * head_dim;
+  const size_t num_q = (size_t)num_cache_head * gqa_size;
+  std::vector<float> K = generate_random_vector<float>(num_rows * row_len);
+  std::vector<float> V = generate_random_vector<float>(num_rows * row_len);
+  std::vector<float> Q = generate_random_vector<float>(num_q * head_dim);
+  std::vector<float> P =
+    generate_random_vector<float>(num_rows * num_q, 0.F, 1.F);
+
+  std::vector<uint8_t> kq(num_rows * row_len * bits / 8), vq(kq.size());
+  std::vector<uint16_t> ks(num_rows * row_len / 32), vs(ks.size());
+  std::vector<uint16_t> k16(K.size()), v16(V.size());
+  for (int r = 0; r < num_rows; ++r) {
+    nntrainer::quantize_kv_cache(row_len, &K[r * row_len],
+                                 &kq[r * row_len * bits / 8],
+                                 &ks[r * row_len / 32], bits);
+    nntrainer::quantize_kv_cache(row_len, &V[r * row_len],
+                                 &vq[r * row_len * bits / 8],
+                                 &vs[r * row_len / 32], bits);
+  }
+  for (size_t i = 0; i < K.size(); ++i) {
+    k16[i] = nntrainer::compute_fp32_to_fp16(K[i]);
+    v16[i] = nntrainer::compute_fp32_to_fp16(V[i]);
+  }
+
+  /// every kv head computed on its own gives the result of one full call
+  std::vector<float> qk(num_rows * num_q), qk_tiled(qk.size(), 7.0F);
+  std::vector<float> qkq(qk.size()), qkq_tiled(qk.size(), 7.0F);
+  std::vector<float> out(num_q * head_dim), out_tiled(out.size(), 7.0F);
+  std::vector<float> outq(out.size()), outq_tiled(out.size(), 7.0F);
+  nntrainer::compute_kcaches<uint16_t>(Q.data(), k16.data(), qk.data(),
+                                       num_rows, num_cache_head, head_dim,
+                                       gqa_size, 8);
+  nntrainer::compute_kcaches_quantized(Q.data(), kq.data(), ks.data(),
+                                       qkq.data(), num_rows, num_cache_head,
+                                       head_dim, gqa_size, bits);
+  nntrainer::compute_fp16vcache_fp32_transposed(num_rows - 1, P.data(),
+                                                v16.data(), out.data(),
+                                                num_cache_head, gqa_size,
+                                                head_dim);
+  nntrainer::compute_vcache_quantized_transposed(
+    num_rows - 1, P.data(), vq.data(), vs.data(), outq.data(), num_cache_head,
+    gqa_size, head_dim, bits);
+  for (int n = 0; n < num_cache_head; ++n) {
+    nntrainer::compute_kcaches<uint16_t>(Q.data(), k16.data(), qk_tiled.data(),
+                                         num_rows, num_cache_head, head_dim,
+                                         gqa_size, 8, UINT_MAX, n, n + 1);
+    nntrainer::compute_kcaches_quantized(
+      Q.data(), kq.data(), ks.data(), qkq_tiled.data(), num_rows,
+      num_cache_head, head_dim, gqa_size, bits, UINT_MAX, n, n + 1);
+    nntrainer::compute_fp16vcache_fp32_transposed(
+      num_rows - 1, P.data(), v16.data(), out_tiled.data(), num_cache_head,
+      gqa_size, head_dim, UINT_MAX, n, n + 1);
+    nntrainer::compute_vcache_quantized_transposed(
+      num_rows - 1, P.data(), vq.data(), vs.data(), outq_tiled.data(),
+      num_cache_head, gqa_size, head_dim, bits, UINT_MAX, n, n + 1);
+  }
+  EXPECT_EQ(qk, qk_tiled);
+  EXPECT_EQ(qkq, qkq_tiled);
+  EXPECT_EQ(out, out_tiled);
+  EXPECT_EQ(outq, outq_tiled);
+}
+
+#if defined(__x86_64__) || defined(__i586__) || defined(_M_X64) ||             \
+  defined(_M_IX86)
+TEST(nntrainer_cpu_backend_standalone, x86_cpu_features_consistent) {
+  const nntrainer::X86CpuFeatures &f = nntrainer::get_x86_cpu_features();
+  const nntrainer::X86Isa isa = f.bestIsa();
+
+  if (isa >= nntrainer::X86Isa::AVX2) {
+    EXPECT_TRUE(f.avx && f.avx2 && f.fma && f.f16c);
+  }
+  if (isa == nntrainer::X86Isa::AVX512) {
+    EXPECT_TRUE(f.avx512f && f.avx512bw && f.avx512vl);
+  }
+  if (f.avx512_vnni) {
+    EXPECT_TRUE(f.avx512f);
+  }
+  EXPECT_EQ(&f, &nntrainer::get_x86_cpu_features());
+}
+
+TEST(nntrainer_cpu_backend_standalone, softmax_row_with_sink_matches_fallback) {
+  const size_t num_heads = 11;
+  const size_t end_row = 5;
+  std::vector<float> qk = generate_random_vector<float>(num_heads * end_row);
+  std::vector<float> sink = generate_random_vector<float>(num_heads);
+  std::vector<float> ref = qk;
+
+  nntrainer::softmax_row_inplace(qk.data(), 1, end_row, num_heads,
+                                 sink.data());
+  nntrainer::__fallback_softmax_row_inplace(ref.data(), 1, end_row, num_heads,
+                                            sink.data());
+
+  for (size_t i = 0; i < qk.size(); i++) {
+    EXPECT_NEAR(ref[i], qk[i], 1e-5f);
+  }
+}
+
+TEST(nntrainer_cpu_backend_standalone, rms_norm_matches_fallback) {
+  const size_t H = 3, W = 37;
+  std::vector<float> X = generate_random_vector<float>(H * W);
+  std::vector<float> Y(H * W), ref(H * W);
+
+  nntrainer::rms_norm_wrt_width_fp32_intrinsic(X.data(), Y.data(), H, W, 1e-5f);
+  nntrainer::__fallback_rms_norm_wrt_width_fp32_intrinsic(X.data(), ref.data(),
+                                                          H, W, 1e-5f);
+
+  for (size_t i = 0; i < Y.size(); i++) {
+    EXPECT_NEAR(ref[i], Y[i], 1e-5f);
+  }
+}
+#endif
+
+static void run_reduce_test(const unsigned int outer, const unsigned int len,
+                            const unsigned int inner) {
+  /// an offset makes a naive one pass variance lose its precision
+  std::vector<float> X =
+    generate_random_vector<float>((size_t)outer * len * inner, 99.F, 101.F);
+  std::vector<float> Y = generate_random_vector<float>((size_t)outer * inner);
+  std::vector<float> Y_prev = Y;
+  std::vector<float> max_v(Y.size()), mean(Y.size()), var(Y.size()),
+    norm(Y.size());
+
+  const float alpha = 0.5F, beta = 2.F;
+  nntrainer::reduce_sum(outer, len, inner, X.data(), Y.data(), alpha, beta);
+  nntrainer::reduce_max(outer, len, inner, X.data(), max_v.data());
+  nntrainer::reduce_mean_var(outer, len, inner, X.data(), mean.data(),
+                             var.data());
+  nntrainer::reduce_l2norm(outer, len, inner, X.data(), norm.data());
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int i = 0; i < inner; ++i) {
+      double sum = 0.0, sq = 0.0, mx = -1e30;
+      for (unsigned int l = 0; l < len; ++l) {
+        const double v = X[((size_t)o * len + l) * inner + i];
+        sum += v;
+        sq += v * v;
+        mx = std::max(mx, v);
+      }
+      const double m = sum / len;
+      double dev = 0.0;
+      for (unsigned int l = 0; l < len; ++l) {
+        const double d = X[((size_t)o * len + l) * inner + i] - m;
+        dev += d * d;
+      }
+
+      const size_t idx = (size_t)o * inner + i;
+      EXPECT_NEAR(Y[idx], alpha * sum + beta * Y_prev[idx], 1e-5 * sum);
+      EXPECT_FLOAT_EQ(max_v[idx], (float)mx);
+      EXPECT_NEAR(mean[idx], m, 1e-5 * std::abs(m));
+      EXPECT_NEAR(var[idx], dev / len, 1e-3);
+      EXPECT_NEAR(norm[idx], std::sqrt(sq), 1e-5 * std::sqrt(sq));
+    }
+  }
+}
+
+TEST(nntrainer_cpu_backend_standalone, reduce_rows) {
+  run_reduce_test(3, 1003, 1);
+}
+
+TEST(nntrainer_cpu_backend_standalone, reduce_short_rows) {
+  run_reduce_test(5, 7, 1);
+}
+
+TEST(nntrainer_cpu_backend_standalone, reduce_columns) {
+  run_reduce_test(2, 17, 45);
+}
+
+TEST(nntrainer_cpu_backend_standalone, reduce_threaded) {
+  run_reduce_test(64, 2048, 1);
+  run_reduce_test(8, 64, 300);
+}
+
+static void run_batch_norm_test(const unsigned int outer,
+                                const unsigned int len,
+                                const unsigned int inner) {
+  const size_t size = (size_t)outer * len * inner;
+  std::vector<float> X = generate_random_vector<float>(size, -2.F, 2.F);
+  std::vector<float> dY = generate_random_vector<float>(size, -1.F, 1.F);
+  std::vector<float> mean = generate_random_vector<float>(len, -1.F, 1.F);
+  std::vector<float> invstd = generate_random_vector<float>(len, 0.5F, 2.F);
+  std::vector<float> gamma = generate_random_vector<float>(len, 0.5F, 1.5F);
+  std::vector<float> beta = generate_random_vector<float>(len, -1.F, 1.F);
+  std::vector<float> mean_dy = generate_random_vector<float>(len, -1.F, 1.F);
+  std::vector<float> mean_dy_xhat =
+    generate_random_vector<float>(len, -1.F, 1.F);
+
+  std::vector<float> Y(size), Y_folded = X, X_hat(size), dX = dY;
+  std::vector<float> sum_dy(len), sum_dy_xhat(len);
+  nntrainer::batch_norm_forward(outer, len, inner, X.data(), mean.data(),
+                                invstd.data(), gamma.data(), beta.data(),
+                                Y.data(), X_hat.data());
+  /// in-place with the folded scale and shift
+  nntrainer::batch_norm_forward(outer, len, inner, Y_folded.data(),
+                                mean.data(), invstd.data(), gamma.data(),
+                                beta.data(), Y_folded.data());
+  nntrainer::batch_norm_backward_reduce(outer, len, inner, dY.data(),
+                                        X_hat.data(), sum_dy.data(),
+                                        sum_dy_xhat.data());
+  nntrainer::batch_norm_backward(outer, len, inner, dX.data(), X_hat.data(),
+                                 invstd.data(), gamma.data(), mean_dy.data(),
+                                 mean_dy_xhat.data(), dX.data());
+
+  std::vector<double> ref_sum(len, 0.0), ref_sum_x(len, 0.0);
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int l = 0; l < len; ++l) {
+      for (unsigned int i = 0; i < inner; ++i) {
+        const size_t idx = ((size_t)o * len + l) * inner + i;
+        const double x_hat = ((double)X[idx] - mean[l]) * invstd[l];
+        const double y = x_hat * gamma[l] + beta[l];
+        const double dx = (double)gamma[l] * invstd[l] *
+                          (dY[idx] - mean_dy[l] - x_hat * mean_dy_xhat[l]);
+        EXPECT_NEAR(X_hat[idx], x_hat, 1e-5);
+        EXPECT_NEAR(Y[idx], y, 1e-5);
+        EXPECT_NEAR(Y_folded[idx], y, 1e-5);
+        EXPECT_NEAR(dX[idx], dx, 1e-5);
+        ref_sum[l] += dY[idx];
+        ref_sum_x[l] += dY[idx] * x_hat;
+      }
+    }
+  }
+  for (unsigned int l = 0; l < len; ++l) {
+    EXPECT_NEAR(sum_dy[l], ref_sum[l], 1e-4 * outer * inner);
+    EXPECT_NEAR(sum_dy_xhat[l], ref_sum_x[l], 1e-4 * outer * inner);
+  }
+}
+
+TEST(nntrainer_cpu_backend_standalone, batch_norm_channels_first) {
+  run_batch_norm_test(3, 5, 37);
+}
+
+TEST(nntrainer_cpu_backend_standalone, batch_norm_channels_last) {
+  run_batch_norm_test(13, 21, 1);
+}
+
+TEST(nntrainer_cpu_backend_standalone, batch_norm_threaded) {
+  run_batch_norm_test(4096, 40, 1);
+  run_batch_norm_test(16, 8, 1024);
+}
+
 int main(int argc, char **argv) {
   int result = -1;
 
@@ -398,6 +398,78 @@ TEST(nntrainerGraphUnitTest, NoLossLayerWhenInferenceMode) {
   ans.clear();
 }
 
+/**
+ * @brief train two steps of a stack of fully connected layers and return the
+ * updated weights
+ */
+static std::vector<float>
+trainFcStack(const std::string &recompute,
+             const std::vector<std::string> &model_props = {}) {
+  nntrainer::NeuralNetwork nn;
+  nn.setProperty({"loss=mse", "batch_size=2"});
+  nn.setProperty(model_props);
+  nn.addLayer(createLayer("input", {"name=in", "input_shape=1:1:8"}));
+  for (int i = 0; i < 5; ++i) {
+    nn.addLayer(createLayer(
+      "fully_connected",
+      {nntrainer::withKey("name", "fc" + std::to_string(i)), "unit=8",
+       "weight_initializer=ones", "bias_initializer=zeros",
+       "recompute=" + (i < 4 ? recompute : std::string("false"))}));
+  }
+  nn.setOptimizer(ml::train::createOptimizer("sgd", {"learning_rate=0.01"}));
+
+  EXPECT_EQ(nn.compile(), ML_ERROR_NONE);
+  EXPECT_EQ(nn.initialize(), ML_ERROR_NONE);
+  EXPECT_EQ(nn.allocate(), ML_ERROR_NONE);
+
+  const int batch = 2, channel = 1, height = 1, width = 8;
+  nntrainer::Tensor input(batch, channel, height, width);
+  nntrainer::Tensor label(batch, channel, height, width);
+  GEN_TEST_INPUT(input, (i * 8 + l) * 0.01f);
+  GEN_TEST_INPUT(label, 0.5f - (i * 8 + l) * 0.02f);
+
+  for (int iteration = 0; iteration < 2; ++iteration) {
+    nn.forwarding({MAKE_SHARED_TENSOR(input)}, {MAKE_SHARED_TENSOR(label)});
+    nn.backwarding(iteration);
+  }
+
+  std::vector<float> weights;
+  for (int i = 0; i < 5; ++i) {
+    std::shared_ptr<ml::train::Layer> layer;
+    EXPECT_EQ(nn.getLayer(("fc" + std::to_string(i)).c_str(), &layer),
+              ML_ERROR_NONE);
+    std::vector<float *> data;
+    std::vector<ml::train::TensorDim> dims;
+    layer->getWeights(data, dims);
+    for (unsigned int w = 0; w < data.size(); ++w)
+      weights.insert(weights.end(), data[w], data[w] + dims[w].getDataLen());
+  }
+  return weights;
+}
+
+TEST(nntrainerGraphUnitTest, recompute_matches_stored_activations_p) {
+  auto expected = trainFcStack("false");
+  auto recomputed = trainFcStack("true");
+  auto auto_recomputed = trainFcStack("false", {"auto_recompute=true"});
+
+  ASSERT_EQ(expected.size(), recomputed.size());
+  ASSERT_EQ(expected.size(), auto_recomputed.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_FLOAT_EQ(expected[i], recomputed[i]);
+    EXPECT_FLOAT_EQ(expected[i], auto_recomputed[i]);
+  }
+}
+
+TEST(nntrainerGraphUnitTest, offload_matches_stored_activations_p) {
+  auto expected = trainFcStack("false");
+  auto offloaded = trainFcStack(
+    "false", {"activation_offload=true", "activation_offload_min_size=0"});
+
+  ASSERT_EQ(expected.size(), offloaded.size());
+  for (size_t i = 0; i < expected.size(); ++i)
+    EXPECT_FLOAT_EQ(expected[i], offloaded[i]);
+}
+
 int main(int argc, char **argv) {
   int result = -1;
 
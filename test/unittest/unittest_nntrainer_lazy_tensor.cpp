@@ -161,6 +161,86 @@ TEST_F(nntrainer_LazyTensorOpsTest, LazyTensorOps_08_p) {
   EXPECT_TRUE(target.chain().sum(3).run() == expected);
 }
 
+// fused elementwise chain with scalar and broadcast operands
+TEST_F(nntrainer_LazyTensorOpsTest, LazyTensorOps_09_p) {
+  nntrainer::Tensor bias(1, 1, 1, 10);
+  nntrainer::Tensor scale(3, 1, 1, 1);
+  nntrainer::Tensor divisor(3, 1, 2, 1);
+  bias.setRandNormal(0.0f, 1.0f);
+  scale.setRandNormal(0.0f, 1.0f);
+  divisor.setRandUniform(1.0f, 2.0f);
+
+  expected = original.clone();
+  expected.add_i(bias);
+  expected.multiply_i(scale);
+  expected.subtract_i(1.5f);
+  expected.divide_i(divisor);
+  expected.add_i(bias, 0.5f);
+  expected.divide_i(4.0f);
+
+  nntrainer::Tensor result = target.chain()
+                               .add_i(bias)
+                               .multiply_i(scale)
+                               .subtract_i(1.5f)
+                               .divide_i(divisor)
+                               .add_i(bias, 0.5f)
+                               .divide_i(4.0f)
+                               .run();
+  EXPECT_EQ(result, expected);
+  EXPECT_EQ(target, original);
+}
+
+// fused groups around an operation which is not fused
+TEST_F(nntrainer_LazyTensorOpsTest, LazyTensorOps_10_p) {
+  expected = original.add(1.0f).sum(3).multiply(2.0f);
+  EXPECT_EQ(target.chain().add_i(1.0f).sum(3).multiply_i(2.0f).run(),
+            expected);
+  EXPECT_EQ(target, original);
+}
+
+// run into the chained tensor itself
+TEST_F(nntrainer_LazyTensorOpsTest, LazyTensorOps_11_p) {
+  nntrainer::Tensor grad(3, 1, 2, 10);
+  grad.setRandNormal(0.0f, 1.0f);
+
+  expected = original.multiply(0.9f);
+  expected.add_i(grad, 0.1f);
+
+  nntrainer::Tensor &result =
+    target.chain().multiply_i(0.9f).add_i(grad, 0.1f).run(target);
+  EXPECT_EQ(result.getData(), target.getData());
+  EXPECT_EQ(target, expected);
+}
+
+// fused chain large enough to run in parallel
+TEST(nntrainer_LazyTensor, LazyTensor_02_p) {
+  nntrainer::Tensor target(4, 8, 64, 64);
+  nntrainer::Tensor channel_scale(1, 8, 1, 1);
+  nntrainer::Tensor row_bias(4, 1, 64, 1);
+  target.setRandNormal(0.0f, 1.0f);
+  channel_scale.setRandNormal(0.0f, 1.0f);
+  row_bias.setRandNormal(0.0f, 1.0f);
+
+  nntrainer::Tensor expected = target.multiply(channel_scale);
+  expected.add_i(row_bias, -2.0f);
+  expected.multiply_i(3.0f);
+
+  nntrainer::Tensor output(4, 8, 64, 64);
+  target.chain()
+    .multiply_i(channel_scale)
+    .add_i(row_bias, -2.0f)
+    .multiply_i(3.0f)
+    .run(output);
+  EXPECT_EQ(output, expected);
+}
+
+// division by zero in a fused chain
+TEST_F(nntrainer_LazyTensorOpsTest, LazyTensorOps_08_n) {
+  EXPECT_THROW(target.chain().add_i(1.0f).divide_i(0.0f).run(),
+               std::runtime_error);
+  EXPECT_EQ(target, original);
+}
+
 /**
  * @brief Main gtest
  */
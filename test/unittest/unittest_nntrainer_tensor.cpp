@@ -1274,7 +1274,7 @@ TEST(nntrainer_Tensor, getBatchSlice_duplicate_indices_p) {
   EXPECT_FLOAT_EQ(sliced.getValue(4, 0, 0, 1), 21.0f);
 }
 
-TEST(nntrainer_Tensor, copy_01_n) {
+TEST(nntrainer_Tensor, copy_01_p) {
   int batch = 3;
   int channel = 1;
   int height = 3;
@@ -1286,8 +1286,11 @@ TEST(nntrainer_Tensor, copy_01_n) {
   nntrainer::Tensor output(batch, channel, height, width);
 
   // use copy() to copy non-contiguous tensor
-  EXPECT_THROW(output.copy(input.getSharedDataTensor({3, 1, 3, 5}, 0, false)),
-               std::runtime_error);
+  nntrainer::Tensor view = input.getSharedDataTensor({3, 1, 3, 5}, 0, false);
+  output.copy(view);
+  EXPECT_EQ(output.getDim(), nntrainer::TensorDim(3, 1, 3, 5));
+  EXPECT_TRUE(output.getContiguous());
+  EXPECT_FLOAT_EQ(output.getValue(2, 0, 1, 4), view.getValue(2, 0, 1, 4));
 }
 
 TEST(nntrainer_Tensor, copy_02_n) {
@@ -2958,6 +2961,95 @@ TEST(nntrainer_Tensor, add_i_broadcast_01_p) {
   }
 }
 
+TEST(nntrainer_Tensor, add_i_broadcast_02_p) {
+  /// runs long enough for the kernels, short runs and loops of 3 axes
+  const std::vector<nntrainer::TensorDim> m_dims = {
+    {1, 1, 1, 1},  {1, 3, 1, 1}, {2, 1, 4, 1}, {1, 3, 1, 40},
+    {2, 3, 1, 40}, {2, 1, 1, 1}, {1, 1, 4, 40}, {2, 3, 4, 1}};
+
+  for (auto &m_dim : m_dims) {
+    nntrainer::Tensor t = ranged(2, 3, 4, 40);
+    nntrainer::Tensor m(m_dim);
+    m.setRandUniform(1.0f, 2.0f);
+
+    nntrainer::Tensor answer(t.getDim());
+    for (unsigned int b = 0; b < 2; ++b)
+      for (unsigned int c = 0; c < 3; ++c)
+        for (unsigned int h = 0; h < 4; ++h)
+          for (unsigned int w = 0; w < 40; ++w)
+            answer.setValue(b, c, h, w,
+                            t.getValue(b, c, h, w) +
+                              2.0f * m.getValue(b % m_dim.batch(),
+                                                c % m_dim.channel(),
+                                                h % m_dim.height(),
+                                                w % m_dim.width()));
+
+    EXPECT_EQ(t.add_i(m, 2.0f), ML_ERROR_NONE);
+    EXPECT_EQ(t, answer) << "broadcasting " << m_dim;
+  }
+}
+
+TEST(nntrainer_Tensor, multiply_broadcast_beta_01_p) {
+  const std::vector<nntrainer::TensorDim> m_dims = {
+    {1, 1, 1, 1},  {1, 3, 1, 1}, {2, 1, 4, 1}, {1, 3, 1, 40},
+    {2, 3, 1, 40}, {2, 1, 1, 1}, {1, 1, 4, 40}, {2, 3, 4, 1}};
+
+  for (auto &m_dim : m_dims) {
+    nntrainer::Tensor t = ranged(2, 3, 4, 40);
+    nntrainer::Tensor m(m_dim);
+    m.setRandUniform(1.0f, 2.0f);
+    nntrainer::Tensor out = ranged(2, 3, 4, 40);
+
+    nntrainer::Tensor answer(t.getDim());
+    for (unsigned int b = 0; b < 2; ++b)
+      for (unsigned int c = 0; c < 3; ++c)
+        for (unsigned int h = 0; h < 4; ++h)
+          for (unsigned int w = 0; w < 40; ++w)
+            answer.setValue(b, c, h, w,
+                            t.getValue(b, c, h, w) *
+                                m.getValue(b % m_dim.batch(),
+                                           c % m_dim.channel(),
+                                           h % m_dim.height(),
+                                           w % m_dim.width()) +
+                              0.5f * out.getValue(b, c, h, w));
+
+    t.multiply(m, out, 0.5f);
+    for (unsigned int i = 0; i < answer.size(); ++i)
+      EXPECT_FLOAT_EQ(out.getData()[i], answer.getData()[i])
+        << "broadcasting " << m_dim << " at " << i;
+  }
+}
+
+TEST(nntrainer_Tensor, divide_broadcast_01_p) {
+  const std::vector<nntrainer::TensorDim> m_dims = {
+    {1, 1, 1, 1},  {1, 3, 1, 1}, {2, 1, 4, 1}, {1, 3, 1, 40},
+    {2, 3, 1, 40}, {2, 1, 1, 1}, {1, 1, 4, 40}, {2, 3, 4, 1}};
+
+  for (auto &m_dim : m_dims) {
+    nntrainer::Tensor t = ranged(2, 3, 4, 40);
+    nntrainer::Tensor m(m_dim);
+    m.setRandUniform(1.0f, 2.0f);
+    nntrainer::Tensor out(t.getDim());
+
+    nntrainer::Tensor answer(t.getDim());
+    for (unsigned int b = 0; b < 2; ++b)
+      for (unsigned int c = 0; c < 3; ++c)
+        for (unsigned int h = 0; h < 4; ++h)
+          for (unsigned int w = 0; w < 40; ++w)
+            answer.setValue(b, c, h, w,
+                            t.getValue(b, c, h, w) /
+                              m.getValue(b % m_dim.batch(),
+                                         c % m_dim.channel(),
+                                         h % m_dim.height(),
+                                         w % m_dim.width()));
+
+    t.divide(m, out);
+    for (unsigned int i = 0; i < answer.size(); ++i)
+      EXPECT_FLOAT_EQ(out.getData()[i], answer.getData()[i])
+        << "broadcasting " << m_dim << " at " << i;
+  }
+}
+
 TEST(nntrainer_Tensor, add_i_broadcast_not_supported_01_n) {
   nntrainer::Tensor target(3, 1, 3, 1);
   nntrainer::Tensor target2(3, 1, 3, 3);
@@ -4702,6 +4794,122 @@ TEST(nntrainer_Tensor, transpose_p) {
   }
 }
 
+TEST(nntrainer_Tensor, transposed_view_p) {
+  nntrainer::Tensor t = ranged(3, 2, 4, 5);
+
+  for (const std::string direction :
+       {"0:1:2", "0:2:1", "1:0:2", "1:2:0", "2:0:1", "2:1:0"}) {
+    nntrainer::Tensor view = t.getTransposedView(direction);
+    EXPECT_EQ(view.getData(), t.getData());
+    EXPECT_EQ(view.getContiguous(), direction == "0:1:2");
+    EXPECT_EQ(t.transpose(direction), view.clone());
+  }
+
+  /// the view writes through to the source
+  nntrainer::Tensor view = t.getTransposedView("1:0:2");
+  view.setValue(2, 3, 1, 4, -1.0f);
+  EXPECT_FLOAT_EQ(t.getValue(2, 1, 3, 4), -1.0f);
+}
+
+TEST(nntrainer_Tensor, transposed_view_n) {
+  nntrainer::Tensor t = ranged(3, 2, 4, 5);
+
+  EXPECT_THROW(t.getTransposedView("0:0:2"), std::invalid_argument);
+  EXPECT_THROW(t.getTransposedView("0:1:3"), std::invalid_argument);
+}
+
+TEST(nntrainer_Tensor, strided_view_p) {
+  nntrainer::Tensor t = ranged(2, 1, 4, 6);
+
+  /// columns 2 to 4 of every row
+  nntrainer::Tensor view =
+    t.getStridedView({2, 1, 4, 3}, 2, t.getStrides(), "columns");
+  EXPECT_FALSE(view.getContiguous());
+  EXPECT_EQ(view.getName(), "columns");
+  EXPECT_FLOAT_EQ(view.getValue(1, 0, 3, 2), t.getValue(1, 0, 3, 4));
+
+  nntrainer::Tensor copied(2, 1, 4, 3);
+  copied.copyData(view);
+  EXPECT_FLOAT_EQ(copied.getValue(1, 0, 2, 0), t.getValue(1, 0, 2, 2));
+
+  nntrainer::Tensor batch = view.getBatchSlice(1, 1);
+  EXPECT_FALSE(batch.getContiguous());
+  EXPECT_FLOAT_EQ(batch.getValue(0, 0, 1, 1), t.getValue(1, 0, 1, 3));
+
+  /// a single row of the columns is dense again
+  nntrainer::Tensor row = t.getStridedView({1, 1, 1, 3}, 8, t.getStrides());
+  EXPECT_TRUE(row.getContiguous());
+
+  /// sum materializes the view
+  EXPECT_EQ(view.sum(3), copied.sum(3));
+}
+
+TEST(nntrainer_Tensor, strided_view_n) {
+  nntrainer::Tensor t = ranged(2, 1, 4, 6);
+
+  EXPECT_THROW(t.getStridedView({2, 1, 4, 3}, 4, t.getStrides()),
+               std::invalid_argument);
+  EXPECT_THROW(t.getStridedView({1, 1, 4, 6}, 0, {24, 24, 16, 1}),
+               std::invalid_argument);
+}
+
+TEST(nntrainer_Tensor, strided_view_dot_p) {
+  nntrainer::Tensor a = ranged(1, 1, 5, 8);
+  nntrainer::Tensor b = ranged(1, 1, 3, 8);
+  nntrainer::Tensor out(1, 1, 5, 6);
+  a.multiply_i(0.1f);
+  b.multiply_i(0.1f);
+
+  /// the second half of every row of a and b, and first three columns of out
+  nntrainer::Tensor a_view = a.getStridedView({1, 1, 5, 4}, 4, a.getStrides());
+  nntrainer::Tensor b_view = b.getStridedView({1, 1, 3, 4}, 4, b.getStrides());
+  nntrainer::Tensor out_view =
+    out.getStridedView({1, 1, 5, 3}, 0, {30, 30, 6, 1});
+  out.setZero();
+  a_view.dot(b_view, out_view, false, true);
+
+  nntrainer::Tensor answer = a_view.clone().dot(b_view.clone(), false, true);
+  EXPECT_EQ(answer, out_view.clone());
+  EXPECT_FLOAT_EQ(out.getValue(0, 0, 4, 5), 0.0f);
+}
+
+TEST(nntrainer_Tensor, strided_view_dot_batched_p) {
+  const unsigned int batch = 2, seq = 5, heads = 3, head_dim = 4;
+  nntrainer::Tensor q = ranged(batch, 1, seq, heads * head_dim);
+  nntrainer::Tensor k = ranged(batch, 1, seq, heads * head_dim);
+  q.multiply_i(0.01f);
+  k.multiply_i(0.02f);
+  nntrainer::Tensor out(batch, 1, seq, heads * head_dim);
+
+  auto heads_view = [&](nntrainer::Tensor &t) {
+    return t.getSharedDataTensor({batch, seq, heads, head_dim}, 0)
+      .getTransposedView("1:0:2");
+  };
+  nntrainer::Tensor q_heads = heads_view(q);
+  nntrainer::Tensor k_heads = heads_view(k);
+  nntrainer::Tensor out_heads = heads_view(out);
+
+  nntrainer::Tensor weight(batch, heads, seq, seq);
+  q_heads.dotBatched(k_heads, weight, false, true);
+  weight.dotBatched(k_heads, out_heads);
+
+  /// reference on transposed copies with the heads folded into the batch
+  nntrainer::Tensor q_ref = q_heads.clone();
+  nntrainer::Tensor k_ref = k_heads.clone();
+  q_ref.reshape({batch * heads, 1, seq, head_dim});
+  k_ref.reshape({batch * heads, 1, seq, head_dim});
+  nntrainer::Tensor weight_ref(batch * heads, 1, seq, seq);
+  nntrainer::Tensor out_ref(batch * heads, 1, seq, head_dim);
+  q_ref.dotBatched(k_ref, weight_ref, false, true);
+  weight_ref.dotBatched(k_ref, out_ref);
+  out_ref.reshape({batch, heads, seq, head_dim});
+
+  weight.reshape({batch * heads, 1, seq, seq});
+  EXPECT_EQ(weight, weight_ref);
+  EXPECT_EQ(out_ref.transpose("1:0:2"), out.getSharedDataTensor(
+                                           {batch, seq, heads, head_dim}, 0));
+}
+
 TEST(nntrainer_Tensor, tranpose_dimension_not_match_n) {
   nntrainer::Tensor a(3, 2, 4, 5);
   nntrainer::Tensor b(3, 1, 2, 3);
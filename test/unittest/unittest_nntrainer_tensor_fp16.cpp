@@ -2871,6 +2871,48 @@ TEST(nntrainer_Tensor, add_i_broadcast_01_p) {
   }
 }
 
+TEST(nntrainer_Tensor, add_i_broadcast_02_p) {
+  const std::vector<std::array<unsigned int, 4>> m_shapes = {
+    {1, 1, 1, 1}, {1, 3, 1, 1}, {2, 1, 4, 1}, {1, 3, 1, 8},
+    {2, 3, 1, 8}, {2, 1, 1, 1}, {1, 1, 4, 8}, {2, 3, 4, 1}};
+
+  for (auto fm : {nntrainer::Tformat::NCHW, nntrainer::Tformat::NHWC}) {
+    for (auto &s : m_shapes) {
+      nntrainer::Tensor t = ranged(2, 3, 4, 8, fm, nntrainer::Tdatatype::FP16);
+      nntrainer::Tensor m(s[0], s[1], s[2], s[3], fm,
+                          nntrainer::Tdatatype::FP16);
+      /// multiples of 0.25 keep every sum and product exact in half
+      for (unsigned int i = 0; i < m.size(); ++i)
+        m.getData<_FP16>()[i] = static_cast<_FP16>(1.0f + (i % 4) * 0.25f);
+      nntrainer::Tensor prod =
+        ranged(2, 3, 4, 8, fm, nntrainer::Tdatatype::FP16);
+      nntrainer::Tensor quot(t.getDim());
+
+      nntrainer::Tensor x = t.clone();
+      nntrainer::Tensor z = prod.clone();
+      t.multiply(m, prod, 0.5f);
+      t.divide(m, quot);
+      EXPECT_EQ(t.add_i(m), ML_ERROR_NONE);
+
+      for (unsigned int b = 0; b < 2; ++b)
+        for (unsigned int c = 0; c < 3; ++c)
+          for (unsigned int h = 0; h < 4; ++h)
+            for (unsigned int w = 0; w < 8; ++w) {
+              float x_v = static_cast<float>(x.getValue<_FP16>(b, c, h, w));
+              float y_v = static_cast<float>(
+                m.getValue<_FP16>(b % s[0], c % s[1], h % s[2], w % s[3]));
+              float z_v = static_cast<float>(z.getValue<_FP16>(b, c, h, w));
+              EXPECT_EQ(static_cast<float>(t.getValue<_FP16>(b, c, h, w)),
+                        x_v + y_v);
+              EXPECT_EQ(static_cast<float>(prod.getValue<_FP16>(b, c, h, w)),
+                        x_v * y_v + 0.5f * z_v);
+              EXPECT_NEAR(static_cast<float>(quot.getValue<_FP16>(b, c, h, w)),
+                          x_v / y_v, 1e-3f * x_v / y_v);
+            }
+    }
+  }
+}
+
 TEST(nntrainer_Tensor, add_i_broadcast_not_supported_01_n) {
   nntrainer::Tensor target(3, 1, 3, 1, nntrainer::Tformat::NCHW,
                            nntrainer::Tdatatype::FP16);
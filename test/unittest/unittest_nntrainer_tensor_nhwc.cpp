@@ -1401,6 +1401,52 @@ TEST(nntrainer_Tensor, add_i_broadcast_01_nhwc_p) {
   }
 }
 
+TEST(nntrainer_Tensor, add_i_broadcast_02_nhwc_p) {
+  /// channel is the innermost axis, so {1, 40, 1, 1} is the contiguous run
+  const std::vector<nntrainer::TensorDim> m_dims = {
+    {1, 1, 1, 1, NHWC_, FP32_},  {1, 40, 1, 1, NHWC_, FP32_},
+    {2, 1, 4, 1, NHWC_, FP32_},  {1, 40, 1, 3, NHWC_, FP32_},
+    {2, 40, 1, 3, NHWC_, FP32_}, {2, 1, 1, 1, NHWC_, FP32_},
+    {1, 1, 4, 3, NHWC_, FP32_},  {2, 40, 4, 1, NHWC_, FP32_}};
+
+  for (auto &m_dim : m_dims) {
+    nntrainer::Tensor t = ranged(2, 40, 4, 3, NHWC_, FP32_);
+    nntrainer::Tensor m(m_dim);
+    m.setRandUniform(1.0f, 2.0f);
+    nntrainer::Tensor prod = ranged(2, 40, 4, 3, NHWC_, FP32_);
+    nntrainer::Tensor quot(t.getDim());
+
+    nntrainer::Tensor sum_answer(t.getDim());
+    nntrainer::Tensor prod_answer(t.getDim());
+    nntrainer::Tensor quot_answer(t.getDim());
+    for (unsigned int b = 0; b < 2; ++b)
+      for (unsigned int c = 0; c < 40; ++c)
+        for (unsigned int h = 0; h < 4; ++h)
+          for (unsigned int w = 0; w < 3; ++w) {
+            float x = t.getValue(b, c, h, w);
+            float y =
+              m.getValue(b % m_dim.batch(), c % m_dim.channel(),
+                         h % m_dim.height(), w % m_dim.width());
+            sum_answer.setValue(b, c, h, w, x + y);
+            prod_answer.setValue(b, c, h, w,
+                                 x * y + 0.5f * prod.getValue(b, c, h, w));
+            quot_answer.setValue(b, c, h, w, x / y);
+          }
+
+    t.multiply(m, prod, 0.5f);
+    t.divide(m, quot);
+    EXPECT_EQ(t.add_i(m), ML_ERROR_NONE);
+    for (unsigned int i = 0; i < t.size(); ++i) {
+      EXPECT_FLOAT_EQ(t.getData()[i], sum_answer.getData()[i])
+        << "broadcasting " << m_dim << " at " << i;
+      EXPECT_FLOAT_EQ(prod.getData()[i], prod_answer.getData()[i])
+        << "broadcasting " << m_dim << " at " << i;
+      EXPECT_FLOAT_EQ(quot.getData()[i], quot_answer.getData()[i])
+        << "broadcasting " << m_dim << " at " << i;
+    }
+  }
+}
+
 TEST(nntrainer_Tensor, add_i_broadcast_not_supported_01_nhwc_n) {
   nntrainer::Tensor target(3, 1, 3, 1, NHWC_, FP32_);
   nntrainer::Tensor target2(3, 1, 3, 3, NHWC_, FP32_);
@@ -876,6 +876,134 @@ TEST(TensorPool, createOrExtend_unmanaged_n) {
     pool.requestOrExtend("t", {10}, {0}, nntrainer::TensorLifespan::UNMANAGED));
 }
 
+/**
+ * @brief split recompute drops the tensor before the recompute order and
+ * binds its view to the recompute memory there
+ */
+TEST(TensorPool, recompute_split_p) {
+  nntrainer::TensorPool pool;
+  auto t0 = pool.request("t0", {10}, {0, 6},
+                         nntrainer::TensorLifespan::FORWARD_DERIV_LIFESPAN);
+  auto t1 = pool.view("t1", "t0", {10}, {6},
+                      nntrainer::TensorLifespan::CALC_DERIV_LIFESPAN);
+  auto t2 = pool.request("t2", {10}, {1, 3},
+                         nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+  auto t3 = pool.request("t3", {10}, {2, 4},
+                         nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+
+  EXPECT_TRUE(pool.requestRecompute("t1", 5, true));
+  EXPECT_NO_THROW(pool.finalize(nntrainer::OptimizedV1Planner(), 0, 6));
+  /** t0 is dropped between 0 and 5, so t2 and t3 reuse its memory */
+  EXPECT_EQ(pool.size(), t0->bytes() * 2);
+  EXPECT_NO_THROW(pool.allocate());
+
+  const float *forward = t0->getData();
+  EXPECT_NE(t2->getData(), t3->getData());
+
+  pool.bindRecomputeMemory(5);
+  EXPECT_EQ(t1->getData(), t0->getData());
+
+  pool.bindForwardMemory();
+  EXPECT_EQ(t0->getData(), forward);
+  EXPECT_EQ(t1->getData(), forward);
+
+  EXPECT_NO_THROW(pool.deallocate());
+}
+
+/**
+ * @brief recompute without split keeps the tensor valid till the order
+ */
+TEST(TensorPool, recompute_not_split_p) {
+  nntrainer::TensorPool pool;
+  auto t0 = pool.request("t0", {10}, {0, 6},
+                         nntrainer::TensorLifespan::FORWARD_DERIV_LIFESPAN);
+  pool.request("t2", {10}, {1, 3},
+               nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+  pool.request("t3", {10}, {2, 4},
+               nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+
+  EXPECT_FALSE(pool.requestRecompute("t0", 5, false));
+  EXPECT_NO_THROW(pool.finalize(nntrainer::OptimizedV1Planner(), 0, 6));
+  EXPECT_EQ(pool.size(), t0->bytes() * 3);
+}
+
+/**
+ * @brief long term tensors and unknown names cannot be recomputed
+ */
+TEST(TensorPool, recompute_long_term_n) {
+  nntrainer::TensorPool pool;
+  pool.request("t0", {10}, {0, 6}, max_ls);
+
+  EXPECT_FALSE(pool.requestRecompute("t0", 5, true));
+  EXPECT_THROW(pool.requestRecompute("t1", 5, true), std::out_of_range);
+}
+
+/**
+ * @brief offloaded tensor is written out after its last forward use, its
+ * memory is reused in between and the data is read back by the order
+ */
+TEST(TensorPool, offload_p) {
+  nntrainer::TensorPool pool;
+  auto t0 = pool.request("t0", {10}, {0, 6},
+                         nntrainer::TensorLifespan::FORWARD_DERIV_LIFESPAN);
+  auto t1 = pool.view("t1", "t0", {10}, {6},
+                      nntrainer::TensorLifespan::CALC_DERIV_LIFESPAN);
+  auto t2 = pool.request("t2", {10}, {2, 3},
+                         nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+  auto t3 = pool.request("t3", {10}, {3, 4},
+                         nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN);
+
+  EXPECT_TRUE(pool.requestOffload("t0", 5));
+  EXPECT_NO_THROW(pool.finalize(nntrainer::OptimizedV1Planner(), 0, 6));
+  /** t0 is kept till 1 to be written out, then t2 and t3 reuse its memory */
+  EXPECT_EQ(pool.size(), t0->bytes() * 2);
+  EXPECT_EQ(pool.getNumOffloaded(), 1u);
+  EXPECT_NO_THROW(pool.allocate());
+
+  for (unsigned int order = 0; order <= 6; ++order) {
+    EXPECT_NO_THROW(pool.offloadBefore(order));
+    if (order == 0) {
+      for (unsigned int i = 0; i < 10; ++i)
+        t0->setValue(0, 0, 0, i, i + 0.5f);
+    } else if (order == 2) {
+      t2->setValue(7.0f);
+    } else if (order == 3) {
+      t3->setValue(8.0f);
+    } else if (order == 6) {
+      for (unsigned int i = 0; i < 10; ++i) {
+        EXPECT_FLOAT_EQ(t0->getValue(0, 0, 0, i), i + 0.5f);
+        EXPECT_FLOAT_EQ(t1->getValue(0, 0, 0, i), i + 0.5f);
+      }
+    }
+    EXPECT_NO_THROW(pool.offloadAfter(order));
+  }
+
+  EXPECT_NO_THROW(pool.bindForwardMemory());
+  EXPECT_NO_THROW(pool.deallocate());
+}
+
+/**
+ * @brief long term, recomputed and too short lived tensors are not offloaded
+ */
+TEST(TensorPool, offload_not_split_n) {
+  nntrainer::TensorPool pool;
+  pool.request("t0", {10}, {0, 6}, max_ls);
+  pool.request("t1", {10}, {0, 6},
+               nntrainer::TensorLifespan::FORWARD_DERIV_LIFESPAN);
+  auto t2 = pool.request("t2", {10}, {0, 2},
+                         nntrainer::TensorLifespan::FORWARD_DERIV_LIFESPAN);
+
+  EXPECT_FALSE(pool.requestOffload("t0", 5));
+  EXPECT_TRUE(pool.requestRecompute("t1", 5, true));
+  EXPECT_FALSE(pool.requestOffload("t1", 5));
+  /** t2 is used at 0 and needs one more order to be written out */
+  EXPECT_TRUE(pool.requestOffload("t2", 1));
+  EXPECT_THROW(pool.requestOffload("t2", 2), std::invalid_argument);
+
+  EXPECT_NO_THROW(pool.finalize(nntrainer::OptimizedV1Planner(), 0, 6));
+  EXPECT_EQ(pool.getNumOffloaded(), 0u);
+}
+
 /**
  * @brief Main gtest
  */
@@ -26,8 +26,12 @@
 #include <nntrainer_log.h>
 #include <nntrainer_logger.h>
 #include <nntrainer_test_util.h>
+#include <thread_runtime.h>
 #include <util_func.h>
 
+#include <atomic>
+#include <vector>
+
 TEST(nntrainer_util_func, sqrtFloat_01_p) {
   float x = 9871.0;
   float sx = nntrainer::sqrtFloat(x);
@@ -138,6 +142,107 @@ TEST(nntrainer_util_func, throw_status_default_n) {
   EXPECT_THROW(nntrainer::throw_status(-12345), std::runtime_error);
 }
 
+TEST(nntrainer_thread_runtime, parallel_for_01_p) {
+  auto &runtime = nntrainer::ThreadRuntime::Global();
+  nntrainer::ThreadRuntimeConfig cfg;
+  cfg.num_threads = 4;
+  runtime.configure(cfg);
+  EXPECT_EQ(runtime.getNumThreads(), 4u);
+
+  std::vector<std::atomic<int>> hits(1000);
+  runtime.parallel_for(0, 1000, [&](unsigned int i) { hits[i]++; });
+  for (auto &h : hits)
+    EXPECT_EQ(h.load(), 1);
+
+  runtime.configure(nntrainer::ThreadRuntimeConfig());
+}
+
+TEST(nntrainer_thread_runtime, parallel_for_nested_02_p) {
+  auto &runtime = nntrainer::ThreadRuntime::Global();
+  nntrainer::ThreadRuntimeConfig cfg;
+  cfg.num_threads = 3;
+  runtime.configure(cfg);
+
+  std::atomic<unsigned int> sum(0);
+  runtime.parallel_for(0, 16, [&](unsigned int i) {
+    EXPECT_TRUE(nntrainer::ThreadRuntime::inParallelRegion());
+    runtime.parallel_for(0, 8, [&](unsigned int j) { sum += i * 8 + j; });
+  });
+  EXPECT_EQ(sum.load(), 127u * 128u / 2);
+  EXPECT_FALSE(nntrainer::ThreadRuntime::inParallelRegion());
+
+  runtime.configure(nntrainer::ThreadRuntimeConfig());
+}
+
+TEST(nntrainer_thread_runtime, submit_01_p) {
+  auto &runtime = nntrainer::ThreadRuntime::Global();
+  nntrainer::ThreadRuntimeConfig cfg;
+  cfg.num_threads = 2;
+  runtime.configure(cfg);
+
+  std::atomic<int> count(0);
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 32; ++i)
+    futures.push_back(runtime.submit([&count]() { count++; }));
+  for (auto &f : futures)
+    f.get();
+  EXPECT_EQ(count.load(), 32);
+
+  runtime.configure(nntrainer::ThreadRuntimeConfig());
+}
+
+TEST(nntrainer_thread_runtime, submit_nested_02_p) {
+  auto &runtime = nntrainer::ThreadRuntime::Global();
+  nntrainer::ThreadRuntimeConfig cfg;
+  cfg.num_threads = 2;
+  runtime.configure(cfg);
+
+  /// every worker waits on a task it submitted
+  std::atomic<int> count(0);
+  runtime.parallel_for(0, 8, [&](unsigned int) {
+    runtime.submit([&count]() { count++; }).get();
+  });
+  EXPECT_EQ(count.load(), 8);
+
+  runtime.configure(nntrainer::ThreadRuntimeConfig());
+}
+
+TEST(nntrainer_thread_runtime, select_k_quant_thread_count_p) {
+  auto &runtime = nntrainer::ThreadRuntime::Global();
+  nntrainer::ThreadRuntimeConfig cfg;
+  cfg.num_threads = 8;
+  runtime.configure(cfg);
+
+  EXPECT_EQ(runtime.select_k_quant_thread_count(1, 1024, 1024), 1u);
+  EXPECT_EQ(runtime.select_k_quant_thread_count(1, 1536, 1792), 2u);
+  EXPECT_EQ(runtime.select_k_quant_thread_count(1, 2048, 1920), 4u);
+  /// prefill shapes past the range of unsigned int
+  EXPECT_EQ(runtime.select_k_quant_thread_count(1024, 4096, 4096), 8u);
+
+  runtime.configure(nntrainer::ThreadRuntimeConfig());
+}
+
+TEST(nntrainer_thread_runtime, parallel_for_exception_n) {
+  auto &runtime = nntrainer::ThreadRuntime::Global();
+  nntrainer::ThreadRuntimeConfig cfg;
+  cfg.num_threads = 4;
+  runtime.configure(cfg);
+
+  EXPECT_THROW(runtime.parallel_for(0, 64,
+                                    [](unsigned int i) {
+                                      if (i == 17)
+                                        throw std::invalid_argument("17");
+                                    }),
+               std::invalid_argument);
+
+  /// the runtime must stay usable after an exception
+  std::atomic<int> count(0);
+  runtime.parallel_for(0, 64, [&](unsigned int) { count++; });
+  EXPECT_EQ(count.load(), 64);
+
+  runtime.configure(nntrainer::ThreadRuntimeConfig());
+}
+
 /**
  * @brief Main gtest
  */